@@ -0,0 +1,264 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+CC3AnimationUpdatePolicy::CC3AnimationUpdatePolicy()
+{
+	m_pNode = NULL;
+}
+
+CC3AnimationUpdatePolicy::~CC3AnimationUpdatePolicy()
+{
+
+}
+
+CC3Node* CC3AnimationUpdatePolicy::getNode()
+{
+	return m_pNode;
+}
+
+GLfloat CC3AnimationUpdatePolicy::getFullRateScreenSize()
+{
+	return m_fullRateScreenSize;
+}
+
+void CC3AnimationUpdatePolicy::setFullRateScreenSize( GLfloat screenSize )
+{
+	m_fullRateScreenSize = screenSize;
+}
+
+GLfloat CC3AnimationUpdatePolicy::getReducedUpdateInterval()
+{
+	return m_reducedUpdateInterval;
+}
+
+void CC3AnimationUpdatePolicy::setReducedUpdateInterval( GLfloat interval )
+{
+	m_reducedUpdateInterval = interval;
+}
+
+CC3AnimationOffscreenMode CC3AnimationUpdatePolicy::getOffscreenMode()
+{
+	return m_offscreenMode;
+}
+
+void CC3AnimationUpdatePolicy::setOffscreenMode( CC3AnimationOffscreenMode mode )
+{
+	m_offscreenMode = mode;
+}
+
+GLfloat CC3AnimationUpdatePolicy::getOffscreenUpdateInterval()
+{
+	return m_offscreenUpdateInterval;
+}
+
+void CC3AnimationUpdatePolicy::setOffscreenUpdateInterval( GLfloat interval )
+{
+	m_offscreenUpdateInterval = interval;
+}
+
+bool CC3AnimationUpdatePolicy::shouldCatchUpWhenVisible()
+{
+	return m_shouldCatchUpWhenVisible;
+}
+
+void CC3AnimationUpdatePolicy::setShouldCatchUpWhenVisible( bool shouldCatchUp )
+{
+	m_shouldCatchUpWhenVisible = shouldCatchUp;
+}
+
+GLfloat CC3AnimationUpdatePolicy::getCullingPadding()
+{
+	return m_cullingPadding;
+}
+
+void CC3AnimationUpdatePolicy::setCullingPadding( GLfloat padding )
+{
+	m_cullingPadding = padding;
+}
+
+CC3AnimationUpdateLevel CC3AnimationUpdatePolicy::getLastUpdateLevel()
+{
+	return m_lastUpdateLevel;
+}
+
+bool CC3AnimationUpdatePolicy::wasVisible()
+{
+	return m_wasVisible;
+}
+
+/** Only the most recent time established on each track needs to be held. */
+bool CC3AnimationUpdatePolicy::deferAnimationFrameAt( float t, GLuint trackID )
+{
+	if ( m_isApplyingFrames )
+		return false;
+
+	for (size_t tIdx = 0; tIdx < m_deferredTrackIDs.size(); tIdx++)
+	{
+		if ( m_deferredTrackIDs[tIdx] == trackID )
+		{
+			m_deferredTimes[tIdx] = t;
+			return true;
+		}
+	}
+
+	m_deferredTrackIDs.push_back( trackID );
+	m_deferredTimes.push_back( t );
+	return true;
+}
+
+void CC3AnimationUpdatePolicy::applyDeferredFrames()
+{
+	m_isApplyingFrames = true;
+	for (size_t tIdx = 0; tIdx < m_deferredTrackIDs.size(); tIdx++)
+		m_pNode->establishAnimationFrameAt( m_deferredTimes[tIdx], m_deferredTrackIDs[tIdx] );
+	m_isApplyingFrames = false;
+
+	m_deferredTrackIDs.clear();
+	m_deferredTimes.clear();
+}
+
+/**
+ * Accumulates whether any visible mesh node within the specified node intersects the frustum of
+ * the camera, using a padded bounding sphere, and the largest projected screen size of those mesh
+ * nodes. Invisible nodes, and their descendants, are not drawn, and so are ignored.
+ */
+void CC3AnimationUpdatePolicy::measureNode( CC3Node* aNode, CC3Camera* camera, bool& isVisible, bool& hasMeshes, GLfloat& screenSize )
+{
+	if ( !aNode->isVisible() )
+		return;
+
+	if ( aNode->isMeshNode() )
+	{
+		CC3MeshNode* meshNode = (CC3MeshNode*)aNode;
+		CC3Mesh* mesh = meshNode->getMesh();
+		if ( mesh )
+		{
+			hasMeshes = true;
+
+			CC3Vector gScale = meshNode->getGlobalScale();
+			GLfloat maxScale = MAX(MAX(fabsf(gScale.x), fabsf(gScale.y)), fabsf(gScale.z));
+			GLfloat radius = mesh->getRadius() * maxScale * (1.0f + m_cullingPadding);
+			CC3Sphere paddedSphere = CC3SphereMake( meshNode->getGlobalCenterOfGeometry(), radius );
+			if ( camera->getFrustum()->doesIntersectSphere( paddedSphere ) )
+			{
+				isVisible = true;
+				screenSize = MAX(screenSize, meshNode->getProjectedScreenSize( camera ));
+			}
+		}
+	}
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( aNode->getChildren(), pObj )
+	{
+		measureNode( (CC3Node*)pObj, camera, isVisible, hasMeshes, screenSize );
+	}
+}
+
+CC3AnimationUpdateLevel CC3AnimationUpdatePolicy::selectUpdateLevel( CC3NodeUpdatingVisitor* visitor )
+{
+	CC3Camera* camera = visitor->getCamera();
+	if ( !camera )
+	{
+		m_wasVisible = true;
+		return kCC3AnimationUpdateFull;
+	}
+
+	bool isVisible = false;
+	bool hasMeshes = false;
+	GLfloat screenSize = 0.0f;
+	measureNode( m_pNode, camera, isVisible, hasMeshes, screenSize );
+	if ( !hasMeshes )
+	{
+		m_wasVisible = true;
+		return kCC3AnimationUpdateFull;
+	}
+
+	bool isComingIntoView = isVisible && !m_wasVisible;
+	m_wasVisible = isVisible;
+
+	if ( !isVisible )
+	{
+		switch ( m_offscreenMode )
+		{
+			case kCC3AnimationOffscreenUpdate:
+				return kCC3AnimationUpdateFull;
+			case kCC3AnimationOffscreenThrottle:
+				return (m_timeSinceEvaluation >= m_offscreenUpdateInterval) ? kCC3AnimationUpdateReduced : kCC3AnimationUpdateSkipped;
+			default:
+				return kCC3AnimationUpdateSkipped;
+		}
+	}
+
+	if ( screenSize >= m_fullRateScreenSize || (isComingIntoView && m_shouldCatchUpWhenVisible) )
+		return kCC3AnimationUpdateFull;
+
+	return (m_timeSinceEvaluation >= m_reducedUpdateInterval) ? kCC3AnimationUpdateReduced : kCC3AnimationUpdateSkipped;
+}
+
+void CC3AnimationUpdatePolicy::updateWithVisitor( CC3NodeUpdatingVisitor* visitor )
+{
+	m_timeSinceEvaluation += visitor->getDeltaTime();
+	if ( m_deferredTrackIDs.empty() )
+		return;
+
+	m_lastUpdateLevel = selectUpdateLevel( visitor );
+	if ( m_lastUpdateLevel != kCC3AnimationUpdateSkipped )
+	{
+		applyDeferredFrames();
+		m_timeSinceEvaluation = 0.0f;
+	}
+
+	visitor->addAnimationUpdate( m_lastUpdateLevel );
+}
+
+void CC3AnimationUpdatePolicy::initForNode( CC3Node* aNode )
+{
+	m_pNode = aNode;							// weak reference
+	m_fullRateScreenSize = kCC3DefaultAnimationFullRateScreenSize;
+	m_reducedUpdateInterval = kCC3DefaultAnimationReducedUpdateInterval;
+	m_offscreenMode = kCC3AnimationOffscreenFreeze;
+	m_offscreenUpdateInterval = kCC3DefaultAnimationOffscreenUpdateInterval;
+	m_cullingPadding = kCC3DefaultAnimationCullingPadding;
+	m_shouldCatchUpWhenVisible = true;
+	m_timeSinceEvaluation = 0.0f;
+	m_lastUpdateLevel = kCC3AnimationUpdateFull;
+	m_wasVisible = true;
+	m_isApplyingFrames = false;
+}
+
+CC3AnimationUpdatePolicy* CC3AnimationUpdatePolicy::policyForNode( CC3Node* aNode )
+{
+	CC3AnimationUpdatePolicy* pPolicy = new CC3AnimationUpdatePolicy;
+	pPolicy->initForNode( aNode );
+	pPolicy->autorelease();
+
+	return pPolicy;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,203 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_ANIMATION_UPDATE_POLICY_H_
+#define _CC3_ANIMATION_UPDATE_POLICY_H_
+
+NS_COCOS3D_BEGIN
+
+/** Enumeration of the ways in which the animation of a node outside the camera frustum is evaluated. */
+typedef enum
+{
+	kCC3AnimationOffscreenUpdate = 0,	/**< Evaluate animation at the full rate, as if the node was visible. */
+	kCC3AnimationOffscreenThrottle,		/**< Evaluate animation at the offscreen update interval. */
+	kCC3AnimationOffscreenFreeze,		/**< Do not evaluate animation until the node becomes visible again. */
+} CC3AnimationOffscreenMode;
+
+/** The default value of the fullRateScreenSize property of CC3AnimationUpdatePolicy. */
+#define kCC3DefaultAnimationFullRateScreenSize		0.2f
+
+/** The default value of the reducedUpdateInterval property of CC3AnimationUpdatePolicy, in seconds. */
+#define kCC3DefaultAnimationReducedUpdateInterval	(1.0f / 15.0f)
+
+/** The default value of the offscreenUpdateInterval property of CC3AnimationUpdatePolicy, in seconds. */
+#define kCC3DefaultAnimationOffscreenUpdateInterval	0.5f
+
+/** The default value of the cullingPadding property of CC3AnimationUpdatePolicy. */
+#define kCC3DefaultAnimationCullingPadding			0.25f
+
+/**
+ * CC3AnimationUpdatePolicy reduces the cost of animating characters that are small on screen,
+ * or outside the frustum of the camera, by reducing how often their animation is evaluated.
+ *
+ * A policy is attached to the root node of an animated character, using the animationUpdatePolicy
+ * property of that node. Animation frames established on the root node, normally by
+ * CC3ActionAnimate actions, are then held by the policy instead of being applied immediately.
+ * When the root node is updated, the policy decides whether the animation is evaluated on this
+ * update, and if it is, applies the most recent frame held for each animation track. When the
+ * animation is not evaluated, the animation states, bone transforms, and skin deformations of
+ * the character are all left untouched, and the character holds its previous pose.
+ *
+ * The decision is based on the mesh nodes within the character:
+ *   - If none of the mesh nodes is within the camera frustum, the animation is handled as
+ *     determined by the offscreenMode property.
+ *   - Otherwise, if the largest projected screen size of the mesh nodes is at least the value of
+ *     the fullRateScreenSize property, the animation is evaluated on every update.
+ *   - Otherwise, the animation is evaluated once per reducedUpdateInterval.
+ *
+ * Since the bones of an animated character can move the skin well outside the rest-pose bounds
+ * of a mesh, the frustum test uses the bounding sphere of each mesh node, enlarged by the
+ * cullingPadding property, so that a character whose pose has been held is evaluated again
+ * before any part of it can move into view.
+ *
+ * If the character has no mesh nodes, or there is no camera, the animation is evaluated on every
+ * update. The outcome of each decision is added to the fullAnimationUpdates, reducedAnimationUpdates
+ * and skippedAnimationUpdates properties of the performance statistics of the scene.
+ *
+ * The policy holds a weak reference to its node.
+ */
+class CC3AnimationUpdatePolicy : public CCObject
+{
+public:
+	CC3AnimationUpdatePolicy();
+	virtual ~CC3AnimationUpdatePolicy();
+
+	/** The root node of the character whose animation is controlled by this policy. */
+	CC3Node*					getNode();
+
+	/**
+	 * The projected screen size, as a fraction of the height of the viewport, at or above which the
+	 * animation is evaluated on every update. See the getProjectedScreenSize method of CC3MeshNode.
+	 *
+	 * The initial value of this property is kCC3DefaultAnimationFullRateScreenSize.
+	 */
+	GLfloat						getFullRateScreenSize();
+	void						setFullRateScreenSize( GLfloat screenSize );
+
+	/**
+	 * The interval, in seconds, between evaluations of the animation of a visible character whose
+	 * projected screen size is less than the value of the fullRateScreenSize property.
+	 *
+	 * The initial value of this property is kCC3DefaultAnimationReducedUpdateInterval.
+	 */
+	GLfloat						getReducedUpdateInterval();
+	void						setReducedUpdateInterval( GLfloat interval );
+
+	/**
+	 * Determines how the animation is evaluated while the character is outside the camera frustum.
+	 *
+	 * The initial value of this property is kCC3AnimationOffscreenFreeze.
+	 */
+	CC3AnimationOffscreenMode	getOffscreenMode();
+	void						setOffscreenMode( CC3AnimationOffscreenMode mode );
+
+	/**
+	 * The interval, in seconds, between evaluations of the animation of a character that is
+	 * outside the camera frustum, when the offscreenMode property is kCC3AnimationOffscreenThrottle.
+	 *
+	 * The initial value of this property is kCC3DefaultAnimationOffscreenUpdateInterval.
+	 */
+	GLfloat						getOffscreenUpdateInterval();
+	void						setOffscreenUpdateInterval( GLfloat interval );
+
+	/**
+	 * Indicates whether the animation should be evaluated immediately when the character comes
+	 * back into the camera frustum, so that the character is never drawn in a stale pose. If this
+	 * property is set to NO, a character that comes back into view is evaluated at its normal rate,
+	 * and may be drawn in its held pose for up to one reducedUpdateInterval.
+	 *
+	 * Because each animation frame is established for an absolute animation time, evaluating the
+	 * animation always brings the character to its current pose, regardless of how long it was held.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldCatchUpWhenVisible();
+	void						setShouldCatchUpWhenVisible( bool shouldCatchUp );
+
+	/**
+	 * The fraction by which the bounding sphere of each mesh node is enlarged when testing whether
+	 * the character is within the camera frustum, to allow for the movement of the skin by bones.
+	 *
+	 * The initial value of this property is kCC3DefaultAnimationCullingPadding.
+	 */
+	GLfloat						getCullingPadding();
+	void						setCullingPadding( GLfloat padding );
+
+	/** Returns how the animation was handled during the most recent update. */
+	CC3AnimationUpdateLevel		getLastUpdateLevel();
+
+	/** Returns whether the character was within the camera frustum during the most recent update. */
+	bool						wasVisible();
+
+	/**
+	 * If the animation of the node is not currently being applied by this policy, records the
+	 * specified animation time for the specified track, to be applied the next time the animation
+	 * is evaluated, and returns YES. Otherwise, returns NO, indicating that the animation frame
+	 * should be established immediately.
+	 *
+	 * This method is invoked automatically from the establishAnimationFrameAt:onTrack: method of the node.
+	 */
+	bool						deferAnimationFrameAt( float t, GLuint trackID );
+
+	/**
+	 * Decides whether the animation of the node is to be evaluated during the current update,
+	 * applies any held animation frames if it is, and records the decision in the performance
+	 * statistics of the visitor. Does nothing if no animation frames are being held.
+	 *
+	 * This method is invoked automatically when the node is updated, before the node is updated
+	 * from its animation state.
+	 */
+	void						updateWithVisitor( CC3NodeUpdatingVisitor* visitor );
+
+	/** Initializes this instance to control the animation of the specified node. */
+	void						initForNode( CC3Node* aNode );
+
+	/** Allocates and initializes an autoreleased instance to control the animation of the specified node. */
+	static CC3AnimationUpdatePolicy*	policyForNode( CC3Node* aNode );
+
+protected:
+	void						measureNode( CC3Node* aNode, CC3Camera* camera, bool& isVisible, bool& hasMeshes, GLfloat& screenSize );
+	CC3AnimationUpdateLevel		selectUpdateLevel( CC3NodeUpdatingVisitor* visitor );
+	void						applyDeferredFrames();
+
+protected:
+	CC3Node*					m_pNode;
+	std::vector<GLuint>			m_deferredTrackIDs;
+	std::vector<float>			m_deferredTimes;
+	GLfloat						m_fullRateScreenSize;
+	GLfloat						m_reducedUpdateInterval;
+	GLfloat						m_offscreenUpdateInterval;
+	GLfloat						m_cullingPadding;
+	GLfloat						m_timeSinceEvaluation;
+	CC3AnimationOffscreenMode	m_offscreenMode;
+	CC3AnimationUpdateLevel		m_lastUpdateLevel;
+	bool						m_shouldCatchUpWhenVisible : 1;
+	bool						m_wasVisible : 1;
+	bool						m_isApplyingFrames : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
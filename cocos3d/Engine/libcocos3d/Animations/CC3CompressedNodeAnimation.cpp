@@ -0,0 +1,664 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+/** The range of each of the three smallest components of a normalized quaternion, (1 / sqrt(2)). */
+#define kCC3SmallestThreeRange		0.70710678f
+
+/** The largest value of a quaternion component quantized to 15 bits. */
+#define kCC3QuaternionQuantumMax	32767.0f
+
+/** The largest value of a vector component quantized to 16 bits. */
+#define kCC3VectorQuantumMax		65535.0f
+
+/** 
+ * Samples the content of the specified animation at the specified time, interpolating
+ * between frames in the same way the animation itself would.
+ */
+static void sampleAnimationAt( CC3NodeAnimation* animation, float t, CC3Vector& location, CC3Quaternion& quaternion, CC3Vector& scale )
+{
+	GLuint frameCount = animation->getFrameCount();
+	GLuint frameIndex = MIN(animation->getFrameIndexAt( t ), frameCount - 1);
+	GLfloat frameInterpolation = 0.0f;
+	if ( animation->shouldInterpolate() && (frameIndex < frameCount - 1) )
+	{
+		float frameTime = animation->timeAtFrame( frameIndex );
+		float frameDur = animation->timeAtFrame( frameIndex + 1 ) - frameTime;
+		if ( frameDur != 0.0f )
+			frameInterpolation = CLAMP((t - frameTime) / frameDur, 0.0f, 1.0f);
+	}
+
+	location = animation->getLocationAtFrame( frameIndex ).lerp( animation->getLocationAtFrame( frameIndex + 1 ), frameInterpolation );
+	quaternion = animation->getQuaternionAtFrame( frameIndex ).slerp( animation->getQuaternionAtFrame( frameIndex + 1 ), frameInterpolation ).normalize();
+	scale = animation->getScaleAtFrame( frameIndex ).lerp( animation->getScaleAtFrame( frameIndex + 1 ), frameInterpolation );
+}
+
+/** 
+ * Returns whether all samples between the start and end samples lie within the specified
+ * distance of the line between the start and end samples.
+ */
+static bool vectorSpanFits( const std::vector<CC3Vector>& samples, GLuint startIdx, GLuint endIdx, GLfloat maxError )
+{
+	CC3Vector startVal = samples[startIdx];
+	CC3Vector endVal = samples[endIdx];
+	GLfloat spanLen = (GLfloat)(endIdx - startIdx);
+	GLfloat maxErrSq = maxError * maxError;
+	for ( GLuint sIdx = startIdx + 1; sIdx < endIdx; sIdx++ )
+	{
+		CC3Vector fitVal = startVal.lerp( endVal, (GLfloat)(sIdx - startIdx) / spanLen );
+		if ( fitVal.distanceSquared( samples[sIdx] ) > maxErrSq )
+			return false;
+	}
+	return true;
+}
+
+/** 
+ * Returns whether all samples between the start and end samples lie within the specified
+ * angle (expressed as the cosine of half the angle) of the arc between the start and end samples.
+ */
+static bool quaternionSpanFits( const std::vector<CC3Quaternion>& samples, GLuint startIdx, GLuint endIdx, GLfloat minCosHalfAngle )
+{
+	CC3Quaternion startVal = samples[startIdx];
+	CC3Quaternion endVal = samples[endIdx];
+	GLfloat spanLen = (GLfloat)(endIdx - startIdx);
+	for ( GLuint sIdx = startIdx + 1; sIdx < endIdx; sIdx++ )
+	{
+		CC3Quaternion fitVal = startVal.slerp( endVal, (GLfloat)(sIdx - startIdx) / spanLen );
+		if ( fabsf( fitVal.dot( samples[sIdx] ) ) < minCosHalfAngle )
+			return false;
+	}
+	return true;
+}
+
+/** Quantizes the specified value, within the specified range, to 16 bits. */
+static GLushort quantizeComponent( GLfloat value, GLfloat minimum, GLfloat quantum )
+{
+	if ( quantum <= 0.0f )
+		return 0;
+	return (GLushort)CLAMP((value - minimum) / quantum + 0.5f, 0.0f, kCC3VectorQuantumMax);
+}
+
+CC3AnimationClip::CC3AnimationClip()
+{
+	m_sampleCount = 0;
+	m_uncompressedByteCount = 0;
+	m_locationTolerance = kCC3AnimationClipDefaultVectorTolerance;
+	m_rotationTolerance = kCC3AnimationClipDefaultRotationTolerance;
+	m_scaleTolerance = kCC3AnimationClipDefaultVectorTolerance;
+}
+
+CC3AnimationClip::~CC3AnimationClip()
+{
+
+}
+
+GLuint CC3AnimationClip::getSampleCount()
+{
+	return m_sampleCount;
+}
+
+void CC3AnimationClip::setSampleCount( GLuint sampleCount )
+{
+	CCAssert(m_tracks.empty(), "CC3AnimationClip sampleCount cannot be changed once the clip contains tracks");
+	m_sampleCount = MIN(sampleCount, kCC3AnimationClipMaxSampleCount);
+}
+
+GLfloat CC3AnimationClip::getLocationTolerance()
+{
+	return m_locationTolerance;
+}
+
+void CC3AnimationClip::setLocationTolerance( GLfloat tolerance )
+{
+	m_locationTolerance = tolerance;
+}
+
+GLfloat CC3AnimationClip::getRotationTolerance()
+{
+	return m_rotationTolerance;
+}
+
+void CC3AnimationClip::setRotationTolerance( GLfloat tolerance )
+{
+	m_rotationTolerance = tolerance;
+}
+
+GLfloat CC3AnimationClip::getScaleTolerance()
+{
+	return m_scaleTolerance;
+}
+
+void CC3AnimationClip::setScaleTolerance( GLfloat tolerance )
+{
+	m_scaleTolerance = tolerance;
+}
+
+GLuint CC3AnimationClip::getTrackCount()
+{
+	return (GLuint)m_tracks.size();
+}
+
+GLuint CC3AnimationClip::getKeyCount()
+{
+	return (GLuint)m_keyFrames.size();
+}
+
+GLuint CC3AnimationClip::getByteCount()
+{
+	return (GLuint)(m_tracks.size() * sizeof(CC3AnimationClipTrack) +
+					m_keyFrames.size() * sizeof(GLushort) +
+					m_keyValues.size() * sizeof(GLushort));
+}
+
+GLuint CC3AnimationClip::getUncompressedByteCount()
+{
+	return m_uncompressedByteCount;
+}
+
+/** Appends a track with keys at the specified samples, and returns the new track. Key values are appended by the caller. */
+GLuint CC3AnimationClip::addTrack( const std::vector<GLuint>& keySamples )
+{
+	CC3AnimationClipTrack track;
+	track.firstKey = (GLuint)m_keyFrames.size();
+	track.keyCount = (GLuint)keySamples.size();
+	track.minimum = CC3Vector::kCC3VectorZero;
+	track.quantum = CC3Vector::kCC3VectorZero;
+
+	for ( GLuint kIdx = 0; kIdx < track.keyCount; kIdx++ )
+		m_keyFrames.push_back( (GLushort)keySamples[kIdx] );
+
+	m_tracks.push_back( track );
+	return (GLuint)(m_tracks.size() - 1);
+}
+
+GLuint CC3AnimationClip::addVectorTrack( const std::vector<CC3Vector>& samples, GLfloat tolerance )
+{
+	GLuint sampleCount = (GLuint)samples.size();
+
+	CC3Vector minimum = samples[0];
+	CC3Vector maximum = samples[0];
+	for ( GLuint sIdx = 1; sIdx < sampleCount; sIdx++ )
+	{
+		minimum = minimum.minimize( samples[sIdx] );
+		maximum = maximum.maxmize( samples[sIdx] );
+	}
+	CC3Vector range = maximum.difference( minimum );
+	GLfloat maxError = MAX(range.x, MAX(range.y, range.z)) * tolerance;
+
+	// A constant track needs only one key. Otherwise, keep only the keys
+	// that cannot be reproduced by interpolating between their neighbours.
+	std::vector<GLuint> keySamples;
+	keySamples.push_back( 0 );
+	bool isConstant = true;
+	for ( GLuint sIdx = 1; sIdx < sampleCount && isConstant; sIdx++ )
+		isConstant = (samples[0].distance( samples[sIdx] ) <= maxError);
+
+	if ( !isConstant )
+	{
+		GLuint startIdx = 0;
+		for ( GLuint endIdx = 2; endIdx < sampleCount; endIdx++ )
+		{
+			if ( !vectorSpanFits( samples, startIdx, endIdx, maxError ) )
+			{
+				startIdx = endIdx - 1;
+				keySamples.push_back( startIdx );
+			}
+		}
+		keySamples.push_back( sampleCount - 1 );
+	}
+
+	GLuint trackIdx = addTrack( keySamples );
+	CC3AnimationClipTrack& track = m_tracks[trackIdx];
+	track.minimum = minimum;
+	track.quantum = range.scaleUniform( 1.0f / kCC3VectorQuantumMax );
+
+	for ( GLuint kIdx = 0; kIdx < track.keyCount; kIdx++ )
+	{
+		const CC3Vector& val = samples[keySamples[kIdx]];
+		m_keyValues.push_back( quantizeComponent( val.x, minimum.x, track.quantum.x ) );
+		m_keyValues.push_back( quantizeComponent( val.y, minimum.y, track.quantum.y ) );
+		m_keyValues.push_back( quantizeComponent( val.z, minimum.z, track.quantum.z ) );
+	}
+
+	return trackIdx;
+}
+
+GLuint CC3AnimationClip::addQuaternionTrack( const std::vector<CC3Quaternion>& samples, GLfloat tolerance )
+{
+	GLuint sampleCount = (GLuint)samples.size();
+	GLfloat minCosHalfAngle = cosf(tolerance * 0.5f);
+
+	std::vector<GLuint> keySamples;
+	keySamples.push_back( 0 );
+	bool isConstant = true;
+	for ( GLuint sIdx = 1; sIdx < sampleCount && isConstant; sIdx++ )
+		isConstant = (fabsf( samples[0].dot( samples[sIdx] ) ) >= minCosHalfAngle);
+
+	if ( !isConstant )
+	{
+		GLuint startIdx = 0;
+		for ( GLuint endIdx = 2; endIdx < sampleCount; endIdx++ )
+		{
+			if ( !quaternionSpanFits( samples, startIdx, endIdx, minCosHalfAngle ) )
+			{
+				startIdx = endIdx - 1;
+				keySamples.push_back( startIdx );
+			}
+		}
+		keySamples.push_back( sampleCount - 1 );
+	}
+
+	GLuint trackIdx = addTrack( keySamples );
+	GLuint keyCount = (GLuint)keySamples.size();
+
+	// Store the three smallest components, using the sign of the largest to choose between
+	// q and -q, which represent the same rotation, so the largest can be rebuilt as positive.
+	for ( GLuint kIdx = 0; kIdx < keyCount; kIdx++ )
+	{
+		const CC3Quaternion& q = samples[keySamples[kIdx]];
+		GLfloat comps[4] = { q.x, q.y, q.z, q.w };
+		GLuint largestIdx = 0;
+		for ( GLuint cIdx = 1; cIdx < 4; cIdx++ )
+			if ( fabsf(comps[cIdx]) > fabsf(comps[largestIdx]) )
+				largestIdx = cIdx;
+		GLfloat sign = (comps[largestIdx] < 0.0f) ? -1.0f : 1.0f;
+
+		GLushort packed[3];
+		GLuint pIdx = 0;
+		for ( GLuint cIdx = 0; cIdx < 4; cIdx++ )
+		{
+			if ( cIdx == largestIdx )
+				continue;
+			GLfloat unitVal = (comps[cIdx] * sign + kCC3SmallestThreeRange) / (2.0f * kCC3SmallestThreeRange);
+			packed[pIdx++] = (GLushort)CLAMP(unitVal * kCC3QuaternionQuantumMax + 0.5f, 0.0f, kCC3QuaternionQuantumMax);
+		}
+		packed[0] |= (GLushort)((largestIdx & 2) << 14);
+		packed[1] |= (GLushort)((largestIdx & 1) << 15);
+
+		m_keyValues.push_back( packed[0] );
+		m_keyValues.push_back( packed[1] );
+		m_keyValues.push_back( packed[2] );
+	}
+
+	return trackIdx;
+}
+
+/**
+ * Returns the index, within the track, of the last key at or before the specified sample
+ * position. If a cursor is supplied, the key at the cursor, and the key after it, are checked
+ * first, and the cursor is updated to the key found. A binary search is performed only if there
+ * is no cursor, or if playback has jumped.
+ */
+GLuint CC3AnimationClip::findKey( const CC3AnimationClipTrack& track, GLfloat samplePosition, GLuint* pCursor )
+{
+	const GLushort* keyFrames = &m_keyFrames[track.firstKey];
+	GLuint lastKey = track.keyCount - 1;
+
+	if ( pCursor )
+	{
+		GLuint kIdx = MIN(*pCursor, lastKey);
+		if ( keyFrames[kIdx] <= samplePosition )
+		{
+			if ( kIdx == lastKey || samplePosition < keyFrames[kIdx + 1] )
+				return kIdx;
+
+			kIdx++;
+			if ( kIdx == lastKey || samplePosition < keyFrames[kIdx + 1] )
+			{
+				*pCursor = kIdx;
+				return kIdx;
+			}
+		}
+	}
+
+	GLuint loIdx = 0;
+	GLuint hiIdx = lastKey;
+	while ( loIdx < hiIdx )
+	{
+		GLuint midIdx = (loIdx + hiIdx + 1) / 2;
+		if ( keyFrames[midIdx] <= samplePosition )
+			loIdx = midIdx;
+		else
+			hiIdx = midIdx - 1;
+	}
+
+	if ( pCursor )
+		*pCursor = loIdx;
+	return loIdx;
+}
+
+CC3Vector CC3AnimationClip::getVectorKey( const CC3AnimationClipTrack& track, GLuint keyIndex )
+{
+	const GLushort* vals = &m_keyValues[(track.firstKey + keyIndex) * 3];
+	return cc3v(track.minimum.x + (GLfloat)vals[0] * track.quantum.x,
+				track.minimum.y + (GLfloat)vals[1] * track.quantum.y,
+				track.minimum.z + (GLfloat)vals[2] * track.quantum.z);
+}
+
+CC3Quaternion CC3AnimationClip::getQuaternionKey( GLuint keyIndex )
+{
+	const GLushort* vals = &m_keyValues[keyIndex * 3];
+	GLuint largestIdx = ((vals[0] >> 15) << 1) | (vals[1] >> 15);
+
+	GLfloat comps[4];
+	GLfloat sumSq = 0.0f;
+	GLuint pIdx = 0;
+	for ( GLuint cIdx = 0; cIdx < 4; cIdx++ )
+	{
+		if ( cIdx == largestIdx )
+			continue;
+		GLfloat unitVal = (GLfloat)(vals[pIdx++] & 0x7FFF) / kCC3QuaternionQuantumMax;
+		comps[cIdx] = (unitVal * 2.0f - 1.0f) * kCC3SmallestThreeRange;
+		sumSq += comps[cIdx] * comps[cIdx];
+	}
+	comps[largestIdx] = sqrtf( MAX(1.0f - sumSq, 0.0f) );
+
+	return CC3Quaternion( comps[0], comps[1], comps[2], comps[3] );
+}
+
+CC3Vector CC3AnimationClip::getVectorInTrackAt( GLuint trackIndex, GLfloat samplePosition )
+{
+	return getVectorInTrackAt( trackIndex, samplePosition, NULL );
+}
+
+CC3Vector CC3AnimationClip::getVectorInTrackAt( GLuint trackIndex, GLfloat samplePosition, GLuint* pCursor )
+{
+	const CC3AnimationClipTrack& track = m_tracks[trackIndex];
+	GLuint kIdx = findKey( track, samplePosition, pCursor );
+	CC3Vector val = getVectorKey( track, kIdx );
+	if ( kIdx + 1 >= track.keyCount )
+		return val;
+
+	GLfloat keyFrame = m_keyFrames[track.firstKey + kIdx];
+	GLfloat nextKeyFrame = m_keyFrames[track.firstKey + kIdx + 1];
+	GLfloat keyInterpolation = (samplePosition - keyFrame) / (nextKeyFrame - keyFrame);
+	if ( keyInterpolation <= 0.0f )
+		return val;
+
+	return val.lerp( getVectorKey( track, kIdx + 1 ), keyInterpolation );
+}
+
+CC3Quaternion CC3AnimationClip::getQuaternionInTrackAt( GLuint trackIndex, GLfloat samplePosition )
+{
+	return getQuaternionInTrackAt( trackIndex, samplePosition, NULL );
+}
+
+CC3Quaternion CC3AnimationClip::getQuaternionInTrackAt( GLuint trackIndex, GLfloat samplePosition, GLuint* pCursor )
+{
+	const CC3AnimationClipTrack& track = m_tracks[trackIndex];
+	GLuint kIdx = findKey( track, samplePosition, pCursor );
+	CC3Quaternion val = getQuaternionKey( track.firstKey + kIdx );
+	if ( kIdx + 1 >= track.keyCount )
+		return val;
+
+	GLfloat keyFrame = m_keyFrames[track.firstKey + kIdx];
+	GLfloat nextKeyFrame = m_keyFrames[track.firstKey + kIdx + 1];
+	GLfloat keyInterpolation = (samplePosition - keyFrame) / (nextKeyFrame - keyFrame);
+	if ( keyInterpolation <= 0.0f )
+		return val;
+
+	return val.slerp( getQuaternionKey( track.firstKey + kIdx + 1 ), keyInterpolation );
+}
+
+CC3CompressedNodeAnimation* CC3AnimationClip::compressAnimation( CC3NodeAnimation* animation )
+{
+	GLuint frameCount = animation->getFrameCount();
+	CCAssert(frameCount > 0, "CC3AnimationClip cannot compress an animation without frames");
+
+	if ( m_sampleCount == 0 )
+		setSampleCount( MAX(frameCount, 1) );
+
+	bool animLoc = animation->isAnimatingLocation();
+	bool animQuat = animation->isAnimatingQuaternion();
+	bool animScale = animation->isAnimatingScale();
+
+	std::vector<CC3Vector> locations( m_sampleCount );
+	std::vector<CC3Quaternion> quaternions( m_sampleCount );
+	std::vector<CC3Vector> scales( m_sampleCount );
+	GLfloat lastSampleIdx = (GLfloat)MAX(m_sampleCount - 1, 1);
+	for ( GLuint sIdx = 0; sIdx < m_sampleCount; sIdx++ )
+		sampleAnimationAt( animation, CLAMP((GLfloat)sIdx / lastSampleIdx, 0.0f, 1.0f), locations[sIdx], quaternions[sIdx], scales[sIdx] );
+
+	CC3CompressedNodeAnimation* compressed = CC3CompressedNodeAnimation::animationOnClip( this );
+	compressed->setShouldInterpolate( animation->shouldInterpolate() );
+	if ( animLoc )
+		compressed->setLocationTrack( addVectorTrack( locations, m_locationTolerance ) );
+	if ( animQuat )
+		compressed->setQuaternionTrack( addQuaternionTrack( quaternions, m_rotationTolerance ) );
+	if ( animScale )
+		compressed->setScaleTrack( addVectorTrack( scales, m_scaleTolerance ) );
+
+	GLuint bytesPerFrame = (animation->hasVariableFrameTiming() ? sizeof(GLfloat) : 0) +
+							(animLoc ? sizeof(CC3Vector) : 0) +
+							(animQuat ? sizeof(CC3Quaternion) : 0) +
+							(animScale ? sizeof(CC3Vector) : 0);
+	m_uncompressedByteCount += frameCount * bytesPerFrame;
+
+	return compressed;
+}
+
+/** Collects the nodes in the specified assembly whose animation on the specified track can be compressed. */
+void CC3AnimationClip::collectAnimationsInNode( CC3Node* aNode, GLuint trackID, CCArray* nodes )
+{
+	CC3NodeAnimation* animation = aNode->getAnimationOnTrack( trackID );
+	if ( animation && animation->getFrameCount() > 0 && animation->isAnimating() &&
+		!dynamic_cast<CC3CompressedNodeAnimation*>( animation ) )
+		nodes->addObject( aNode );
+
+	CCArray* children = aNode->getChildren();
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( children, pObj )
+		collectAnimationsInNode( (CC3Node*)pObj, trackID, nodes );
+}
+
+void CC3AnimationClip::compressAnimationInNode( CC3Node* aNode, GLuint trackID )
+{
+	CCArray* nodes = CCArray::create();
+	collectAnimationsInNode( aNode, trackID, nodes );
+
+	CCObject* pObj = NULL;
+	if ( m_sampleCount == 0 )
+	{
+		GLuint maxFrameCount = 0;
+		CCARRAY_FOREACH( nodes, pObj )
+			maxFrameCount = MAX(maxFrameCount, ((CC3Node*)pObj)->getAnimationOnTrack( trackID )->getFrameCount());
+		setSampleCount( maxFrameCount );
+	}
+
+	CCARRAY_FOREACH( nodes, pObj )
+	{
+		CC3Node* node = (CC3Node*)pObj;
+		CC3NodeAnimationState* oldState = node->getAnimationStateOnTrack( trackID );
+		oldState->retain();		// Keep alive while replaced, to copy its settings
+
+		node->addAnimation( compressAnimation( oldState->getAnimation() ), trackID );
+
+		CC3NodeAnimationState* newState = node->getAnimationStateOnTrack( trackID );
+		newState->setBlendingWeight( oldState->getBlendingWeight() );
+		newState->setIsEnabled( oldState->isEnabled() );
+		newState->setIsLocationAnimationEnabled( oldState->isLocationAnimationEnabled() );
+		newState->setIsQuaternionAnimationEnabled( oldState->isQuaternionAnimationEnabled() );
+		newState->setIsScaleAnimationEnabled( oldState->isScaleAnimationEnabled() );
+		newState->establishFrameAt( oldState->getAnimationTime() );
+
+		oldState->release();
+	}
+
+	CC3_TRACE( "CC3AnimationClip compressed %u nodes into %u tracks with %u keys, from %u to %u bytes",
+		nodes->count(), getTrackCount(), getKeyCount(), getUncompressedByteCount(), getByteCount() );
+}
+
+void CC3AnimationClip::init()
+{
+}
+
+CC3AnimationClip* CC3AnimationClip::clip()
+{
+	CC3AnimationClip* pClip = new CC3AnimationClip;
+	pClip->init();
+	pClip->autorelease();
+
+	return pClip;
+}
+
+CC3AnimationClip* CC3AnimationClip::clipFromNode( CC3Node* aNode, GLuint trackID )
+{
+	CC3AnimationClip* pClip = clip();
+	pClip->compressAnimationInNode( aNode, trackID );
+
+	return pClip;
+}
+
+
+CC3CompressedNodeAnimation::CC3CompressedNodeAnimation()
+{
+	m_clip = NULL;
+	m_locationTrack = kCC3AnimationClipNoTrack;
+	m_quaternionTrack = kCC3AnimationClipNoTrack;
+	m_scaleTrack = kCC3AnimationClipNoTrack;
+}
+
+CC3CompressedNodeAnimation::~CC3CompressedNodeAnimation()
+{
+	CC_SAFE_RELEASE( m_clip );
+}
+
+CC3AnimationClip* CC3CompressedNodeAnimation::getClip()
+{
+	return m_clip;
+}
+
+GLuint CC3CompressedNodeAnimation::getLocationTrack()
+{
+	return m_locationTrack;
+}
+
+void CC3CompressedNodeAnimation::setLocationTrack( GLuint trackIndex )
+{
+	m_locationTrack = trackIndex;
+}
+
+GLuint CC3CompressedNodeAnimation::getQuaternionTrack()
+{
+	return m_quaternionTrack;
+}
+
+void CC3CompressedNodeAnimation::setQuaternionTrack( GLuint trackIndex )
+{
+	m_quaternionTrack = trackIndex;
+}
+
+GLuint CC3CompressedNodeAnimation::getScaleTrack()
+{
+	return m_scaleTrack;
+}
+
+void CC3CompressedNodeAnimation::setScaleTrack( GLuint trackIndex )
+{
+	m_scaleTrack = trackIndex;
+}
+
+bool CC3CompressedNodeAnimation::isAnimatingLocation()
+{
+	return m_locationTrack != kCC3AnimationClipNoTrack;
+}
+
+bool CC3CompressedNodeAnimation::isAnimatingQuaternion()
+{
+	return m_quaternionTrack != kCC3AnimationClipNoTrack;
+}
+
+bool CC3CompressedNodeAnimation::isAnimatingScale()
+{
+	return m_scaleTrack != kCC3AnimationClipNoTrack;
+}
+
+GLfloat CC3CompressedNodeAnimation::getSamplePositionAt( float t )
+{
+	GLfloat samplePosition = t * (GLfloat)(MAX(m_frameCount, 1) - 1);
+	return m_shouldInterpolate ? samplePosition : floorf( samplePosition );
+}
+
+/** Overridden to read each track of the clip directly at the sample position corresponding to the specified time. */
+void CC3CompressedNodeAnimation::establishFrameAt( float t, CC3NodeAnimationState* animState )
+{
+	CCAssert(t >= 0.0 && t <= 1.0, "CC3CompressedNodeAnimation animation frame time %f must be between 0.0 and 1.0"/*, t*/);
+
+	GLfloat samplePosition = getSamplePositionAt( t );
+	GLuint* keyCursors = animState->getKeyCursors();
+	if ( animState->isAnimatingLocation() )
+		animState->setLocation( m_clip->getVectorInTrackAt( m_locationTrack, samplePosition, &keyCursors[0] ) );
+
+	if ( animState->isAnimatingQuaternion() )
+		animState->setQuaternion( m_clip->getQuaternionInTrackAt( m_quaternionTrack, samplePosition, &keyCursors[1] ) );
+
+	if ( animState->isAnimatingScale() )
+		animState->setScale( m_clip->getVectorInTrackAt( m_scaleTrack, samplePosition, &keyCursors[2] ) );
+}
+
+CC3Vector CC3CompressedNodeAnimation::getLocationAtFrame( GLuint frameIndex )
+{
+	if ( !isAnimatingLocation() )
+		return super::getLocationAtFrame( frameIndex );
+
+	return m_clip->getVectorInTrackAt( m_locationTrack, (GLfloat)MIN(frameIndex, m_frameCount - 1) );
+}
+
+CC3Quaternion CC3CompressedNodeAnimation::getQuaternionAtFrame( GLuint frameIndex )
+{
+	if ( !isAnimatingQuaternion() )
+		return super::getQuaternionAtFrame( frameIndex );
+
+	return m_clip->getQuaternionInTrackAt( m_quaternionTrack, (GLfloat)MIN(frameIndex, m_frameCount - 1) );
+}
+
+CC3Vector CC3CompressedNodeAnimation::getScaleAtFrame( GLuint frameIndex )
+{
+	if ( !isAnimatingScale() )
+		return super::getScaleAtFrame( frameIndex );
+
+	return m_clip->getVectorInTrackAt( m_scaleTrack, (GLfloat)MIN(frameIndex, m_frameCount - 1) );
+}
+
+void CC3CompressedNodeAnimation::initOnClip( CC3AnimationClip* clip )
+{
+	super::initWithFrameCount( clip->getSampleCount() );
+	m_clip = clip;
+	CC_SAFE_RETAIN( clip );
+}
+
+CC3CompressedNodeAnimation* CC3CompressedNodeAnimation::animationOnClip( CC3AnimationClip* clip )
+{
+	CC3CompressedNodeAnimation* animation = new CC3CompressedNodeAnimation;
+	animation->initOnClip( clip );
+	animation->autorelease();
+
+	return animation;
+}
+
+NS_COCOS3D_END
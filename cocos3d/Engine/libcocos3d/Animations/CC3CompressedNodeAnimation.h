@@ -0,0 +1,285 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CCL_CC3COMPRESSEDNODEANIMATION_H_
+#define _CCL_CC3COMPRESSEDNODEANIMATION_H_
+
+NS_COCOS3D_BEGIN
+
+/** Indicates that a CC3CompressedNodeAnimation does not animate a particular component. */
+#define kCC3AnimationClipNoTrack				((GLuint)-1)
+
+/** The maximum number of samples in a CC3AnimationClip, limited by the 16-bit key frame indices. */
+#define kCC3AnimationClipMaxSampleCount			65536
+
+/** The default location and scale tolerance, as a fraction of the range of values covered by each track. */
+#define kCC3AnimationClipDefaultVectorTolerance	0.0005f
+
+/** The default rotation tolerance, in radians. */
+#define kCC3AnimationClipDefaultRotationTolerance	0.0005f
+
+/** 
+ * Describes one track of keys within a CC3AnimationClip. 
+ *
+ * The keys of the track occupy keyCount consecutive entries, starting at firstKey, in the key
+ * frame and key value arrays of the clip. Each vector key holds three 16-bit components,
+ * quantized across the range from minimum to (minimum + (65535 * quantum)). Each quaternion
+ * key holds the three smallest components, quantized to 15 bits, with the index of the
+ * largest component packed into the high bits.
+ */
+typedef struct
+{
+	GLuint			firstKey;			/**< The index of the first key of this track in the clip. */
+	GLuint			keyCount;			/**< The number of keys in this track. */
+	CC3Vector		minimum;			/**< The minimum value of a vector track. */
+	CC3Vector		quantum;			/**< The value of one quantization step of a vector track. */
+} CC3AnimationClipTrack;
+
+class CC3CompressedNodeAnimation;
+
+/**
+ * CC3AnimationClip holds the compressed animation content of all of the nodes of an animated
+ * node assembly, such as the bones of a skeleton, for a single animation track.
+ *
+ * Each animated component (location, rotation or scale) of each node forms one track of the
+ * clip. Each track is resampled onto the sampleCount equally-spaced samples of the clip, and
+ * then reduced to only those keys that are needed to reproduce the samples, by linear
+ * interpolation between keys, within the tolerance for that component. The values of the
+ * remaining keys are quantized to 16 bits per component, or to 48 bits per quaternion.
+ *
+ * The keys of all tracks are held in two contiguous arrays, so the content of all nodes is
+ * compact. The clip is read-only during playback. Each caller may supply a cursor that remembers
+ * the key it most recently found in a track, so sequential playback does not search through the
+ * key frames. CC3CompressedNodeAnimation keeps these cursors in the CC3NodeAnimationState of each
+ * node, so nodes sharing a clip never share a cursor.
+ *
+ * Each node retains its own CC3CompressedNodeAnimation, which references the tracks of this
+ * clip that animate the node. The easiest way to compress the animation of a node assembly
+ * is to use the clipFromNode method, which replaces the animation of each node in the
+ * assembly with a compressed animation on a single, shared clip. Once compressed, the
+ * original animation content is released.
+ */
+class CC3AnimationClip : public CCObject 
+{
+public:
+	CC3AnimationClip();
+	~CC3AnimationClip();
+
+	/**
+	 * The number of equally-spaced samples onto which each track of this clip is resampled.
+	 *
+	 * If this property is zero when the first animation is compressed into this clip, it is set
+	 * automatically from the largest frame count of the animations being compressed. This property
+	 * cannot be changed once the clip contains tracks.
+	 *
+	 * Animations with variable frame timing are resampled at equally-spaced times, so you may
+	 * wish to increase the value of this property for such animations.
+	 *
+	 * The initial value of this property is zero.
+	 */
+	GLuint						getSampleCount();
+	void						setSampleCount( GLuint sampleCount );
+
+	/**
+	 * The maximum location error permitted when removing location keys, as a fraction of the
+	 * range of locations covered by each track.
+	 *
+	 * The initial value of this property is kCC3AnimationClipDefaultVectorTolerance.
+	 */
+	GLfloat						getLocationTolerance();
+	void						setLocationTolerance( GLfloat tolerance );
+
+	/**
+	 * The maximum rotation error permitted when removing rotation keys, in radians.
+	 *
+	 * The initial value of this property is kCC3AnimationClipDefaultRotationTolerance.
+	 */
+	GLfloat						getRotationTolerance();
+	void						setRotationTolerance( GLfloat tolerance );
+
+	/**
+	 * The maximum scale error permitted when removing scale keys, as a fraction of the range
+	 * of scales covered by each track.
+	 *
+	 * The initial value of this property is kCC3AnimationClipDefaultVectorTolerance.
+	 */
+	GLfloat						getScaleTolerance();
+	void						setScaleTolerance( GLfloat tolerance );
+
+	/** Returns the number of tracks in this clip. */
+	GLuint						getTrackCount();
+
+	/** Returns the total number of keys in all tracks of this clip. */
+	GLuint						getKeyCount();
+
+	/** Returns the number of bytes of memory used by the tracks and keys of this clip. */
+	GLuint						getByteCount();
+
+	/**
+	 * Returns the number of bytes of memory used by the animation content that was compressed
+	 * into this clip, assuming content stored as CC3ArrayNodeAnimation arrays.
+	 */
+	GLuint						getUncompressedByteCount();
+
+	/**
+	 * Compresses the content of the specified animation into new tracks in this clip, and returns
+	 * an autoreleased CC3CompressedNodeAnimation that plays those tracks.
+	 *
+	 * The specified animation is not changed, and is not referenced by the returned animation.
+	 */
+	CC3CompressedNodeAnimation*	compressAnimation( CC3NodeAnimation* animation );
+
+	/**
+	 * Compresses the animation on the specified track of the specified node, and of all of its
+	 * descendants, into this clip, and replaces the animation of each of those nodes on that
+	 * track with a CC3CompressedNodeAnimation on this clip.
+	 *
+	 * The blending weight, enablement, and current animation time of each animation track
+	 * are preserved.
+	 */
+	void						compressAnimationInNode( CC3Node* aNode, GLuint trackID );
+
+	/**
+	 * Returns the value of the specified vector track at the specified sample position, which
+	 * lies between zero and (sampleCount - 1), interpolating linearly between keys.
+	 */
+	CC3Vector					getVectorInTrackAt( GLuint trackIndex, GLfloat samplePosition );
+
+	/**
+	 * Returns the value of the specified vector track at the specified sample position, starting
+	 * the search for the key at the specified cursor, and updating the cursor to the key found.
+	 * The cursor must initially be zero, and must only be used with the specified track.
+	 */
+	CC3Vector					getVectorInTrackAt( GLuint trackIndex, GLfloat samplePosition, GLuint* pCursor );
+
+	/**
+	 * Returns the value of the specified quaternion track at the specified sample position,
+	 * which lies between zero and (sampleCount - 1), interpolating spherically between keys.
+	 */
+	CC3Quaternion				getQuaternionInTrackAt( GLuint trackIndex, GLfloat samplePosition );
+
+	/**
+	 * Returns the value of the specified quaternion track at the specified sample position, starting
+	 * the search for the key at the specified cursor, and updating the cursor to the key found.
+	 * The cursor must initially be zero, and must only be used with the specified track.
+	 */
+	CC3Quaternion				getQuaternionInTrackAt( GLuint trackIndex, GLfloat samplePosition, GLuint* pCursor );
+
+	void						init();
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3AnimationClip*	clip();
+
+	/**
+	 * Allocates and initializes an autoreleased instance, and compresses into it the animation
+	 * on the specified track of the specified node and all of its descendants, replacing the
+	 * animation of those nodes on that track, as described for compressAnimationInNode.
+	 */
+	static CC3AnimationClip*	clipFromNode( CC3Node* aNode, GLuint trackID );
+
+protected:
+	void						collectAnimationsInNode( CC3Node* aNode, GLuint trackID, CCArray* nodes );
+	GLuint						addVectorTrack( const std::vector<CC3Vector>& samples, GLfloat tolerance );
+	GLuint						addQuaternionTrack( const std::vector<CC3Quaternion>& samples, GLfloat tolerance );
+	GLuint						addTrack( const std::vector<GLuint>& keySamples );
+	GLuint						findKey( const CC3AnimationClipTrack& track, GLfloat samplePosition, GLuint* pCursor );
+	CC3Vector					getVectorKey( const CC3AnimationClipTrack& track, GLuint keyIndex );
+	CC3Quaternion				getQuaternionKey( GLuint keyIndex );
+
+protected:
+	std::vector<CC3AnimationClipTrack>	m_tracks;
+	std::vector<GLushort>		m_keyFrames;
+	std::vector<GLushort>		m_keyValues;
+	GLuint						m_sampleCount;
+	GLuint						m_uncompressedByteCount;
+	GLfloat						m_locationTolerance;
+	GLfloat						m_rotationTolerance;
+	GLfloat						m_scaleTolerance;
+};
+
+/**
+ * A concrete CC3NodeAnimation that plays the location, rotation and scale tracks of a shared
+ * CC3AnimationClip.
+ *
+ * Instances are normally created by the compressAnimation or compressAnimationInNode methods
+ * of CC3AnimationClip.
+ *
+ * The frameCount property returns the sampleCount of the clip, and frames are equally spaced.
+ * Evaluating the animation at a time reads the two keys on either side of that time directly
+ * from each track, so the interpolationEpsilon property is not used.
+ */
+class CC3CompressedNodeAnimation : public CC3NodeAnimation 
+{
+	DECLARE_SUPER( CC3NodeAnimation );
+public:
+	CC3CompressedNodeAnimation();
+	~CC3CompressedNodeAnimation();
+
+	/** Returns the clip holding the content of this animation. */
+	CC3AnimationClip*			getClip();
+
+	/** The index of the location track in the clip, or kCC3AnimationClipNoTrack if location is not animated. */
+	GLuint						getLocationTrack();
+	void						setLocationTrack( GLuint trackIndex );
+
+	/** The index of the rotation track in the clip, or kCC3AnimationClipNoTrack if rotation is not animated. */
+	GLuint						getQuaternionTrack();
+	void						setQuaternionTrack( GLuint trackIndex );
+
+	/** The index of the scale track in the clip, or kCC3AnimationClipNoTrack if scale is not animated. */
+	GLuint						getScaleTrack();
+	void						setScaleTrack( GLuint trackIndex );
+
+	/**
+	 * Returns the sample position within the tracks of the clip that corresponds to the specified
+	 * animation time, which lies between zero and one. The sample position lies between zero and
+	 * (sampleCount - 1), and is rounded down to a whole sample if shouldInterpolate is NO.
+	 */
+	GLfloat						getSamplePositionAt( float t );
+
+	/** Initializes this instance to play tracks from the specified clip. */
+	void						initOnClip( CC3AnimationClip* clip );
+
+	/** Allocates and initializes an autoreleased instance to play tracks from the specified clip. */
+	static CC3CompressedNodeAnimation*	animationOnClip( CC3AnimationClip* clip );
+
+	virtual bool				isAnimatingLocation();
+	virtual bool				isAnimatingQuaternion();
+	virtual bool				isAnimatingScale();
+	virtual void				establishFrameAt( float t, CC3NodeAnimationState* animState );
+	virtual CC3Vector			getLocationAtFrame( GLuint frameIndex );
+	virtual CC3Quaternion		getQuaternionAtFrame( GLuint frameIndex );
+	virtual CC3Vector			getScaleAtFrame( GLuint frameIndex );
+
+protected:
+	CC3AnimationClip*			m_clip;
+	GLuint						m_locationTrack;
+	GLuint						m_quaternionTrack;
+	GLuint						m_scaleTrack;
+};
+
+NS_COCOS3D_END
+
+#endif
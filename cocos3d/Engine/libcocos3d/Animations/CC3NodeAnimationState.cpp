@@ -35,6 +35,8 @@ CC3NodeAnimationState::CC3NodeAnimationState()
 {
 	m_pNode = NULL;
 	m_pAnimation = NULL;
+	for (GLuint i = 0; i < kCC3NodeAnimationStateKeyCursorCount; i++)
+		m_keyCursors[i] = 0;
 }
 
 CC3NodeAnimationState::~CC3NodeAnimationState()
@@ -144,6 +146,11 @@ bool CC3NodeAnimationState::hasVariableFrameTiming()
 	return m_pAnimation->hasVariableFrameTiming(); 
 }
 
+GLuint* CC3NodeAnimationState::getKeyCursors()
+{
+	return m_keyCursors;
+}
+
 void CC3NodeAnimationState::establishFrameAt( float t )
 {
 	m_fAnimationTime = t;
@@ -151,6 +158,13 @@ void CC3NodeAnimationState::establishFrameAt( float t )
 		m_pAnimation->establishFrameAt( t, this );
 }
 
+void CC3NodeAnimationState::deferFrameAt( float t )
+{
+	m_fAnimationTime = t;
+	if (isEnabled())
+		markDirty();
+}
+
 void CC3NodeAnimationState::initWithAnimation( CC3NodeAnimation* animation, GLuint trackID, CC3Node* node )
 {
 	CCAssert(animation, "CC3NodeAnimationState must be created with a valid animation.");
@@ -168,6 +182,8 @@ void CC3NodeAnimationState::initWithAnimation( CC3NodeAnimation* animation, GLui
 	m_isLocationAnimationEnabled = true;
 	m_isQuaternionAnimationEnabled = true;
 	m_isScaleAnimationEnabled = true;
+	for (GLuint i = 0; i < kCC3NodeAnimationStateKeyCursorCount; i++)
+		m_keyCursors[i] = 0;
 	establishFrameAt( 0.0f );		// Start on the initial frame
 }
 
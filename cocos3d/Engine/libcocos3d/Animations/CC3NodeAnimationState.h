@@ -33,6 +33,9 @@
 
 NS_COCOS3D_BEGIN
 
+/** The number of key cursors held by each CC3NodeAnimationState. */
+#define kCC3NodeAnimationStateKeyCursorCount	3
+
 /**
  * CC3NodeAnimationState holds the state associated with the animation of a single node on a single track.
  *
@@ -201,6 +204,14 @@ public:
 	 */
 	bool						hasVariableFrameTiming();
 
+	/**
+	 * Returns an array of kCC3NodeAnimationStateKeyCursorCount key indices, in which the animation
+	 * can remember the keys it most recently found while establishing frames for this instance.
+	 * Because an animation may be shared between nodes, the animation keeps such per-playback
+	 * state here, rather than in its own content.
+	 */
+	GLuint*						getKeyCursors();
+
 	/**
 	 * Updates the currentFrame, location, quaternion, and scale of this instance based on the
 	 * animation content found in the contained animation at the specified time, which should
@@ -209,6 +220,16 @@ public:
 	 */
 	void						establishFrameAt( float time );
 
+	/**
+	 * Sets the animationTime property to the specified time, and marks the node as requiring an
+	 * animation update, without evaluating the animation. The location, quaternion and scale of
+	 * this instance are updated later, when the animation is evaluated at that time.
+	 *
+	 * This method is used for nodes animated by a CC3PoseEngine, which evaluates the animation
+	 * of all of its bones together, during the update of the root node.
+	 */
+	void						deferFrameAt( float time );
+
 	/**
 	 * Initializes this instance tracking the animation state for the specified animation running on
 	 * the specified track for the specified node.
@@ -265,6 +286,7 @@ protected:
 	CC3Vector					m_scale;
 	GLuint						m_trackID;
 	GLfloat						m_fBlendingWeight;
+	GLuint						m_keyCursors[kCC3NodeAnimationStateKeyCursorCount];
 	bool						m_isEnabled : 1;
 	bool						m_isLocationAnimationEnabled : 1;
 	bool						m_isQuaternionAnimationEnabled : 1;
@@ -0,0 +1,633 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+/** Guards the normalizing divisions against zero weights and zero-length quaternions. */
+#define kCC3PoseEngineMinDivisor		(1.0e-12f)
+
+/** Accumulates the specified array, scaled by the specified weights, into the accumulator array. */
+static inline void f4AccumulateWeighted( GLfloat* acc, const GLfloat* src, CC3Float4 w )
+{
+	f4Store( acc, f4MulAdd( f4Load( acc ), f4Load( src ), w ) );
+}
+
+/**
+ * Blends the sampled pose of a normal layer into the accumulated pose. Locations and scales
+ * are accumulated as weighted sums. Each sampled quaternion is first flipped into the same
+ * hemisphere as the accumulated quaternion, so that the weighted sum follows the shortest arc.
+ */
+static void blendPoseSample( CC3PoseBuffer& pose, CC3PoseBuffer& sample, GLuint count )
+{
+	for (GLuint i = 0; i < count; i += 4)
+	{
+		CC3Float4 wL = f4Load( &sample.weightL[i] );
+		f4AccumulateWeighted( &pose.locX[i], &sample.locX[i], wL );
+		f4AccumulateWeighted( &pose.locY[i], &sample.locY[i], wL );
+		f4AccumulateWeighted( &pose.locZ[i], &sample.locZ[i], wL );
+		f4Store( &pose.weightL[i], f4Add( f4Load( &pose.weightL[i] ), wL ) );
+
+		CC3Float4 sx = f4Load( &sample.quatX[i] );
+		CC3Float4 sy = f4Load( &sample.quatY[i] );
+		CC3Float4 sz = f4Load( &sample.quatZ[i] );
+		CC3Float4 sw = f4Load( &sample.quatW[i] );
+		CC3Float4 px = f4Load( &pose.quatX[i] );
+		CC3Float4 py = f4Load( &pose.quatY[i] );
+		CC3Float4 pz = f4Load( &pose.quatZ[i] );
+		CC3Float4 pw = f4Load( &pose.quatW[i] );
+		CC3Float4 dot = f4Add( f4Add( f4Mul( px, sx ), f4Mul( py, sy ) ), f4Add( f4Mul( pz, sz ), f4Mul( pw, sw ) ) );
+		CC3Float4 wQ = f4Load( &sample.weightQ[i] );
+		CC3Float4 wQAligned = f4NegateWhereNegative( wQ, dot );
+		f4Store( &pose.quatX[i], f4Add( px, f4Mul( sx, wQAligned ) ) );
+		f4Store( &pose.quatY[i], f4Add( py, f4Mul( sy, wQAligned ) ) );
+		f4Store( &pose.quatZ[i], f4Add( pz, f4Mul( sz, wQAligned ) ) );
+		f4Store( &pose.quatW[i], f4Add( pw, f4Mul( sw, wQAligned ) ) );
+		f4Store( &pose.weightQ[i], f4Add( f4Load( &pose.weightQ[i] ), wQ ) );
+
+		CC3Float4 wS = f4Load( &sample.weightS[i] );
+		f4AccumulateWeighted( &pose.scaleX[i], &sample.scaleX[i], wS );
+		f4AccumulateWeighted( &pose.scaleY[i], &sample.scaleY[i], wS );
+		f4AccumulateWeighted( &pose.scaleZ[i], &sample.scaleZ[i], wS );
+		f4Store( &pose.weightS[i], f4Add( f4Load( &pose.weightS[i] ), wS ) );
+	}
+}
+
+/** Multiplies the component weights of the sampled pose by the per-bone mask weights. */
+static void maskPoseSample( CC3PoseBuffer& sample, const GLfloat* mask, GLuint count )
+{
+	for (GLuint i = 0; i < count; i += 4)
+	{
+		CC3Float4 m = f4Load( &mask[i] );
+		f4Store( &sample.weightL[i], f4Mul( f4Load( &sample.weightL[i] ), m ) );
+		f4Store( &sample.weightQ[i], f4Mul( f4Load( &sample.weightQ[i] ), m ) );
+		f4Store( &sample.weightS[i], f4Mul( f4Load( &sample.weightS[i] ), m ) );
+	}
+}
+
+/**
+ * Divides the accumulated locations and scales by their accumulated weights, and normalizes
+ * the accumulated quaternions. Components with zero weight are left at zero.
+ */
+static void normalizePose( CC3PoseBuffer& pose, GLuint count )
+{
+	CC3Float4 minDiv = f4Splat( kCC3PoseEngineMinDivisor );
+	for (GLuint i = 0; i < count; i += 4)
+	{
+		CC3Float4 invL = f4Recip( f4Max( f4Load( &pose.weightL[i] ), minDiv ) );
+		f4Store( &pose.locX[i], f4Mul( f4Load( &pose.locX[i] ), invL ) );
+		f4Store( &pose.locY[i], f4Mul( f4Load( &pose.locY[i] ), invL ) );
+		f4Store( &pose.locZ[i], f4Mul( f4Load( &pose.locZ[i] ), invL ) );
+
+		CC3Float4 qx = f4Load( &pose.quatX[i] );
+		CC3Float4 qy = f4Load( &pose.quatY[i] );
+		CC3Float4 qz = f4Load( &pose.quatZ[i] );
+		CC3Float4 qw = f4Load( &pose.quatW[i] );
+		CC3Float4 lenSq = f4Add( f4Add( f4Mul( qx, qx ), f4Mul( qy, qy ) ), f4Add( f4Mul( qz, qz ), f4Mul( qw, qw ) ) );
+		CC3Float4 invLen = f4RecipSqrt( f4Max( lenSq, minDiv ) );
+		f4Store( &pose.quatX[i], f4Mul( qx, invLen ) );
+		f4Store( &pose.quatY[i], f4Mul( qy, invLen ) );
+		f4Store( &pose.quatZ[i], f4Mul( qz, invLen ) );
+		f4Store( &pose.quatW[i], f4Mul( qw, invLen ) );
+
+		CC3Float4 invS = f4Recip( f4Max( f4Load( &pose.weightS[i] ), minDiv ) );
+		f4Store( &pose.scaleX[i], f4Mul( f4Load( &pose.scaleX[i] ), invS ) );
+		f4Store( &pose.scaleY[i], f4Mul( f4Load( &pose.scaleY[i] ), invS ) );
+		f4Store( &pose.scaleZ[i], f4Mul( f4Load( &pose.scaleZ[i] ), invS ) );
+	}
+}
+
+/**
+ * Applies the sampled difference pose of an additive layer to the blended pose. Each location
+ * is offset by the weighted location difference. Each rotation is pre-multiplied by the
+ * difference rotation, interpolated from identity by the weight. Each scale is multiplied
+ * by the scale ratio, interpolated from one by the weight.
+ */
+static void addPoseSample( CC3PoseBuffer& pose, CC3PoseBuffer& delta, GLuint count )
+{
+	CC3Float4 one = f4Splat( 1.0f );
+	CC3Float4 minDiv = f4Splat( kCC3PoseEngineMinDivisor );
+	for (GLuint i = 0; i < count; i += 4)
+	{
+		CC3Float4 wL = f4Load( &delta.weightL[i] );
+		f4AccumulateWeighted( &pose.locX[i], &delta.locX[i], wL );
+		f4AccumulateWeighted( &pose.locY[i], &delta.locY[i], wL );
+		f4AccumulateWeighted( &pose.locZ[i], &delta.locZ[i], wL );
+		f4Store( &pose.weightL[i], f4Add( f4Load( &pose.weightL[i] ), wL ) );
+
+		// Weighted difference rotation, normalized
+		CC3Float4 wQ = f4Load( &delta.weightQ[i] );
+		CC3Float4 ax = f4Mul( f4Load( &delta.quatX[i] ), wQ );
+		CC3Float4 ay = f4Mul( f4Load( &delta.quatY[i] ), wQ );
+		CC3Float4 az = f4Mul( f4Load( &delta.quatZ[i] ), wQ );
+		CC3Float4 aw = f4Add( f4Sub( one, wQ ), f4Mul( f4Load( &delta.quatW[i] ), wQ ) );
+		CC3Float4 lenSq = f4Add( f4Add( f4Mul( ax, ax ), f4Mul( ay, ay ) ), f4Add( f4Mul( az, az ), f4Mul( aw, aw ) ) );
+		CC3Float4 invLen = f4RecipSqrt( f4Max( lenSq, minDiv ) );
+		ax = f4Mul( ax, invLen );
+		ay = f4Mul( ay, invLen );
+		az = f4Mul( az, invLen );
+		aw = f4Mul( aw, invLen );
+
+		// Pre-multiply the blended rotation by the difference rotation
+		CC3Float4 bx = f4Load( &pose.quatX[i] );
+		CC3Float4 by = f4Load( &pose.quatY[i] );
+		CC3Float4 bz = f4Load( &pose.quatZ[i] );
+		CC3Float4 bw = f4Load( &pose.quatW[i] );
+		f4Store( &pose.quatX[i], f4Add( f4Add( f4Mul( aw, bx ), f4Mul( ax, bw ) ), f4Sub( f4Mul( ay, bz ), f4Mul( az, by ) ) ) );
+		f4Store( &pose.quatY[i], f4Add( f4Sub( f4Mul( aw, by ), f4Mul( ax, bz ) ), f4Add( f4Mul( ay, bw ), f4Mul( az, bx ) ) ) );
+		f4Store( &pose.quatZ[i], f4Add( f4Add( f4Mul( aw, bz ), f4Mul( ax, by ) ), f4Sub( f4Mul( az, bw ), f4Mul( ay, bx ) ) ) );
+		f4Store( &pose.quatW[i], f4Sub( f4Sub( f4Mul( aw, bw ), f4Mul( ax, bx ) ), f4Add( f4Mul( ay, by ), f4Mul( az, bz ) ) ) );
+		f4Store( &pose.weightQ[i], f4Add( f4Load( &pose.weightQ[i] ), wQ ) );
+
+		CC3Float4 wS = f4Load( &delta.weightS[i] );
+		f4Store( &pose.scaleX[i], f4Mul( f4Load( &pose.scaleX[i] ), f4Add( one, f4Mul( wS, f4Sub( f4Load( &delta.scaleX[i] ), one ) ) ) ) );
+		f4Store( &pose.scaleY[i], f4Mul( f4Load( &pose.scaleY[i] ), f4Add( one, f4Mul( wS, f4Sub( f4Load( &delta.scaleY[i] ), one ) ) ) ) );
+		f4Store( &pose.scaleZ[i], f4Mul( f4Load( &pose.scaleZ[i] ), f4Add( one, f4Mul( wS, f4Sub( f4Load( &delta.scaleZ[i] ), one ) ) ) ) );
+		f4Store( &pose.weightS[i], f4Add( f4Load( &pose.weightS[i] ), wS ) );
+	}
+}
+
+/** Returns the Hamilton product of the quaternions, matching the rotation kernel of addPoseSample. */
+static inline CC3Quaternion multiplyQuaternions( const CC3Quaternion& a, const CC3Quaternion& b )
+{
+	return CC3Quaternion( (a.w * b.x) + (a.x * b.w) + (a.y * b.z) - (a.z * b.y),
+						  (a.w * b.y) - (a.x * b.z) + (a.y * b.w) + (a.z * b.x),
+						  (a.w * b.z) + (a.x * b.y) - (a.y * b.x) + (a.z * b.w),
+						  (a.w * b.w) - (a.x * b.x) - (a.y * b.y) - (a.z * b.z) );
+}
+
+/** Returns the ratio of the specified scale components, or one if the reference component is zero. */
+static inline GLfloat scaleRatio( GLfloat scale, GLfloat refScale )
+{
+	return refScale ? (scale / refScale) : 1.0f;
+}
+
+void CC3PoseBuffer::reset( GLuint boneCount )
+{
+	GLuint paddedCount = (boneCount + 3) & ~3U;
+	std::vector<GLfloat>* arrays[] = { &locX, &locY, &locZ, &quatX, &quatY, &quatZ, &quatW,
+									   &scaleX, &scaleY, &scaleZ, &weightL, &weightQ, &weightS };
+	for (size_t aIdx = 0; aIdx < sizeof(arrays) / sizeof(arrays[0]); aIdx++)
+		arrays[aIdx]->assign( paddedCount, 0.0f );
+}
+
+GLuint CC3PoseBuffer::getPaddedCount()
+{
+	return (GLuint)weightL.size();
+}
+
+CC3PoseEngine::CC3PoseEngine()
+{
+	m_pNode = NULL;
+}
+
+CC3PoseEngine::~CC3PoseEngine()
+{
+
+}
+
+CC3Node* CC3PoseEngine::getNode()
+{
+	return m_pNode;
+}
+
+GLuint CC3PoseEngine::getBoneCount()
+{
+	return (GLuint)m_bones.size();
+}
+
+GLuint CC3PoseEngine::getLayerCount()
+{
+	return (GLuint)m_layers.size();
+}
+
+void CC3PoseEngine::populateBones()
+{
+	m_bones.clear();
+	collectBones( m_pNode );
+	collectLayers();
+
+	m_pose.reset( getBoneCount() );
+	for (size_t lIdx = 0; lIdx < m_layers.size(); lIdx++)
+	{
+		CC3PoseLayer& layer = m_layers[lIdx];
+		layer.sample.reset( getBoneCount() );
+		resolveMask( layer );
+		captureReferencePose( layer );
+	}
+}
+
+/** Adds the specified node and its animated descendants, skipping subtrees animated by their own engine. */
+void CC3PoseEngine::collectBones( CC3Node* aNode )
+{
+	if ( !aNode )
+		return;
+
+	CCArray* animStates = aNode->getAnimationStates();
+	if ( animStates && animStates->count() > 0 )
+		m_bones.push_back( aNode );
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( aNode->getChildren(), pObj )
+	{
+		CC3Node* child = (CC3Node*)pObj;
+		if ( !child->getPoseEngine() )
+			collectBones( child );
+	}
+}
+
+/** Adds a layer for each animation track found on any bone. Existing layers are retained. */
+void CC3PoseEngine::collectLayers()
+{
+	for (size_t bIdx = 0; bIdx < m_bones.size(); bIdx++)
+	{
+		CCObject* pObj = NULL;
+		CCARRAY_FOREACH( m_bones[bIdx]->getAnimationStates(), pObj )
+		{
+			CC3NodeAnimationState* animState = (CC3NodeAnimationState*)pObj;
+			getLayer( animState->getTrackID() );
+		}
+	}
+}
+
+/** Returns the layer for the specified track, creating it if necessary. */
+CC3PoseLayer* CC3PoseEngine::getLayer( GLuint trackID )
+{
+	for (size_t lIdx = 0; lIdx < m_layers.size(); lIdx++)
+	{
+		if ( m_layers[lIdx].trackID == trackID )
+			return &m_layers[lIdx];
+	}
+
+	CC3PoseLayer layer;
+	layer.trackID = trackID;
+	layer.isAdditive = false;
+	layer.sample.reset( getBoneCount() );
+	m_layers.push_back( layer );
+	return &m_layers.back();
+}
+
+bool CC3PoseEngine::isAdditiveTrack( GLuint trackID )
+{
+	return getLayer( trackID )->isAdditive;
+}
+
+void CC3PoseEngine::setIsAdditiveTrack( GLuint trackID, bool isAdditive )
+{
+	CC3PoseLayer* layer = getLayer( trackID );
+	layer->isAdditive = isAdditive;
+	captureReferencePose( *layer );
+	m_pNode->markAnimationDirty();
+}
+
+void CC3PoseEngine::setMaskWeight( GLfloat weight, GLuint trackID, CC3Node* aNode )
+{
+	CC3PoseLayer* layer = getLayer( trackID );
+
+	size_t mIdx = 0;
+	while ( mIdx < layer->maskNodes.size() && layer->maskNodes[mIdx] != aNode )
+		mIdx++;
+
+	if ( mIdx < layer->maskNodes.size() )
+	{
+		layer->maskNodeWeights[mIdx] = weight;
+	}
+	else
+	{
+		layer->maskNodes.push_back( aNode );
+		layer->maskNodeWeights.push_back( weight );
+	}
+
+	resolveMask( *layer );
+	m_pNode->markAnimationDirty();
+}
+
+GLfloat CC3PoseEngine::getMaskWeight( GLuint trackID, CC3Node* aNode )
+{
+	return resolveMaskWeight( *getLayer( trackID ), aNode );
+}
+
+void CC3PoseEngine::removeMask( GLuint trackID )
+{
+	CC3PoseLayer* layer = getLayer( trackID );
+	layer->maskNodes.clear();
+	layer->maskNodeWeights.clear();
+	layer->maskWeights.clear();
+	m_pNode->markAnimationDirty();
+}
+
+/** Returns the mask weight assigned to the specified node, or to its nearest assigned ancestor. */
+GLfloat CC3PoseEngine::resolveMaskWeight( CC3PoseLayer& layer, CC3Node* aNode )
+{
+	for (CC3Node* pNode = aNode; pNode; pNode = pNode->getParent())
+	{
+		for (size_t mIdx = 0; mIdx < layer.maskNodes.size(); mIdx++)
+		{
+			if ( layer.maskNodes[mIdx] == pNode )
+				return layer.maskNodeWeights[mIdx];
+		}
+
+		if ( pNode == m_pNode )
+			break;
+	}
+	return 1.0f;
+}
+
+/** Resolves the mask weight of each bone into the padded mask array of the layer. */
+void CC3PoseEngine::resolveMask( CC3PoseLayer& layer )
+{
+	if ( layer.maskNodes.empty() )
+	{
+		layer.maskWeights.clear();
+		return;
+	}
+
+	layer.maskWeights.assign( m_pose.getPaddedCount(), 0.0f );
+	for (size_t bIdx = 0; bIdx < m_bones.size(); bIdx++)
+		layer.maskWeights[bIdx] = resolveMaskWeight( layer, m_bones[bIdx] );
+}
+
+/** Captures the first frame of the animation on each bone as the reference pose of an additive layer. */
+void CC3PoseEngine::captureReferencePose( CC3PoseLayer& layer )
+{
+	if ( !layer.isAdditive )
+	{
+		layer.referencePose.reset( 0 );
+		return;
+	}
+
+	CC3PoseBuffer& ref = layer.referencePose;
+	ref.reset( getBoneCount() );
+	for (size_t bIdx = 0; bIdx < m_bones.size(); bIdx++)
+	{
+		CC3Vector loc = CC3Vector::kCC3VectorZero;
+		CC3Quaternion quat = CC3Quaternion::kCC3QuaternionIdentity;
+		CC3Vector scale = CC3Vector::kCC3VectorUnitCube;
+
+		CC3NodeAnimationState* animState = m_bones[bIdx]->getAnimationStateOnTrack( layer.trackID );
+		CC3NodeAnimation* anim = animState ? animState->getAnimation() : NULL;
+		if ( anim )
+		{
+			if ( anim->isAnimatingLocation() )
+				loc = anim->getLocationAtFrame( 0 );
+			if ( anim->isAnimatingQuaternion() )
+				quat = anim->getQuaternionAtFrame( 0 );
+			if ( anim->isAnimatingScale() )
+				scale = anim->getScaleAtFrame( 0 );
+		}
+
+		ref.locX[bIdx] = loc.x;
+		ref.locY[bIdx] = loc.y;
+		ref.locZ[bIdx] = loc.z;
+		ref.quatX[bIdx] = quat.x;
+		ref.quatY[bIdx] = quat.y;
+		ref.quatZ[bIdx] = quat.z;
+		ref.quatW[bIdx] = quat.w;
+		ref.scaleX[bIdx] = scale.x;
+		ref.scaleY[bIdx] = scale.y;
+		ref.scaleZ[bIdx] = scale.z;
+	}
+}
+
+/**
+ * Evaluates the animation state at its current animation time. Compressed animations are read
+ * directly from the tracks of their clip, using the key cursors of the animation state. Other
+ * animations are evaluated by the animation itself. Components that are not animated are left
+ * at their current values. The results are written back to the animation state, so that it
+ * remains consistent with the pose.
+ */
+static void evaluateAnimationState( CC3NodeAnimationState* animState, CC3Vector& loc, CC3Quaternion& quat, CC3Vector& scale )
+{
+	CC3CompressedNodeAnimation* compressed = dynamic_cast<CC3CompressedNodeAnimation*>( animState->getAnimation() );
+	if ( !compressed )
+	{
+		animState->establishFrameAt( animState->getAnimationTime() );
+		loc = animState->getLocation();
+		quat = animState->getQuaternion();
+		scale = animState->getScale();
+		return;
+	}
+
+	CC3AnimationClip* clip = compressed->getClip();
+	GLfloat samplePosition = compressed->getSamplePositionAt( animState->getAnimationTime() );
+	GLuint* keyCursors = animState->getKeyCursors();
+
+	loc = animState->getLocation();
+	if ( animState->isAnimatingLocation() )
+	{
+		loc = clip->getVectorInTrackAt( compressed->getLocationTrack(), samplePosition, &keyCursors[0] );
+		animState->setLocation( loc );
+	}
+
+	quat = animState->getQuaternion();
+	if ( animState->isAnimatingQuaternion() )
+	{
+		quat = clip->getQuaternionInTrackAt( compressed->getQuaternionTrack(), samplePosition, &keyCursors[1] );
+		animState->setQuaternion( quat );
+	}
+
+	scale = animState->getScale();
+	if ( animState->isAnimatingScale() )
+	{
+		scale = clip->getVectorInTrackAt( compressed->getScaleTrack(), samplePosition, &keyCursors[2] );
+		animState->setScale( scale );
+	}
+}
+
+/**
+ * Evaluates the animation of each bone on the track of the specified layer at its current
+ * animation time, into the sample buffer of the layer. Bones without an enabled animation state
+ * on the track are given zero weight. For additive layers, the sample holds the difference from
+ * the reference pose.
+ */
+void CC3PoseEngine::sampleLayer( CC3PoseLayer& layer )
+{
+	CC3PoseBuffer& sample = layer.sample;
+	CC3PoseBuffer& ref = layer.referencePose;
+	GLuint boneCount = getBoneCount();
+	for (GLuint bIdx = 0; bIdx < boneCount; bIdx++)
+	{
+		CC3NodeAnimationState* animState = m_bones[bIdx]->getAnimationStateOnTrack( layer.trackID );
+		GLfloat weight = (animState && animState->isEnabled()) ? animState->getBlendingWeight() : 0.0f;
+		if ( !weight )
+		{
+			sample.weightL[bIdx] = 0.0f;
+			sample.weightQ[bIdx] = 0.0f;
+			sample.weightS[bIdx] = 0.0f;
+			continue;
+		}
+
+		CC3Vector loc;
+		CC3Quaternion quat;
+		CC3Vector scale;
+		evaluateAnimationState( animState, loc, quat, scale );
+
+		if ( layer.isAdditive )
+		{
+			loc = loc.difference( cc3v( ref.locX[bIdx], ref.locY[bIdx], ref.locZ[bIdx] ) );
+
+			CC3Quaternion refQuat = CC3Quaternion( ref.quatX[bIdx], ref.quatY[bIdx], ref.quatZ[bIdx], ref.quatW[bIdx] );
+			quat = multiplyQuaternions( quat, refQuat.conjugate() );
+			if ( quat.w < 0.0f )
+				quat = quat.negate();
+
+			scale = cc3v( scaleRatio( scale.x, ref.scaleX[bIdx] ),
+						  scaleRatio( scale.y, ref.scaleY[bIdx] ),
+						  scaleRatio( scale.z, ref.scaleZ[bIdx] ) );
+		}
+
+		sample.locX[bIdx] = loc.x;
+		sample.locY[bIdx] = loc.y;
+		sample.locZ[bIdx] = loc.z;
+		sample.quatX[bIdx] = quat.x;
+		sample.quatY[bIdx] = quat.y;
+		sample.quatZ[bIdx] = quat.z;
+		sample.quatW[bIdx] = quat.w;
+		sample.scaleX[bIdx] = scale.x;
+		sample.scaleY[bIdx] = scale.y;
+		sample.scaleZ[bIdx] = scale.z;
+		sample.weightL[bIdx] = animState->isAnimatingLocation() ? weight : 0.0f;
+		sample.weightQ[bIdx] = animState->isAnimatingQuaternion() ? weight : 0.0f;
+		sample.weightS[bIdx] = animState->isAnimatingScale() ? weight : 0.0f;
+	}
+
+	if ( !layer.maskWeights.empty() )
+		maskPoseSample( sample, &layer.maskWeights[0], sample.getPaddedCount() );
+}
+
+/**
+ * Before additive layers are applied, components that were not animated by any normal layer
+ * take their current values from the bones, so that additive layers are applied to them.
+ */
+void CC3PoseEngine::fillUnanimatedComponents()
+{
+	GLuint boneCount = getBoneCount();
+	for (GLuint bIdx = 0; bIdx < boneCount; bIdx++)
+	{
+		CC3Node* bone = m_bones[bIdx];
+		if ( !m_pose.weightL[bIdx] )
+		{
+			CC3Vector loc = bone->getLocation();
+			m_pose.locX[bIdx] = loc.x;
+			m_pose.locY[bIdx] = loc.y;
+			m_pose.locZ[bIdx] = loc.z;
+		}
+		if ( !m_pose.weightQ[bIdx] )
+		{
+			CC3Quaternion quat = bone->getQuaternion();
+			m_pose.quatX[bIdx] = quat.x;
+			m_pose.quatY[bIdx] = quat.y;
+			m_pose.quatZ[bIdx] = quat.z;
+			m_pose.quatW[bIdx] = quat.w;
+		}
+		if ( !m_pose.weightS[bIdx] )
+		{
+			CC3Vector scale = bone->getScale();
+			m_pose.scaleX[bIdx] = scale.x;
+			m_pose.scaleY[bIdx] = scale.y;
+			m_pose.scaleZ[bIdx] = scale.z;
+		}
+	}
+}
+
+/** Writes the components of the pose that received any weight back to the bones, in one pass. */
+void CC3PoseEngine::writePose()
+{
+	GLuint boneCount = getBoneCount();
+	for (GLuint bIdx = 0; bIdx < boneCount; bIdx++)
+	{
+		CC3Node* bone = m_bones[bIdx];
+		if ( m_pose.weightL[bIdx] )
+			bone->setLocation( cc3v( m_pose.locX[bIdx], m_pose.locY[bIdx], m_pose.locZ[bIdx] ) );
+		if ( m_pose.weightQ[bIdx] )
+			bone->setQuaternion( CC3Quaternion( m_pose.quatX[bIdx], m_pose.quatY[bIdx], m_pose.quatZ[bIdx], m_pose.quatW[bIdx] ) );
+		if ( m_pose.weightS[bIdx] )
+			bone->setScale( cc3v( m_pose.scaleX[bIdx], m_pose.scaleY[bIdx], m_pose.scaleZ[bIdx] ) );
+		bone->markAnimationClean();
+	}
+}
+
+void CC3PoseEngine::applyPose()
+{
+	GLuint boneCount = getBoneCount();
+	bool isDirty = false;
+	for (GLuint bIdx = 0; bIdx < boneCount && !isDirty; bIdx++)
+		isDirty = m_bones[bIdx]->isAnimationDirty();
+
+	if ( !isDirty )
+		return;
+
+	CC3_PROFILE_ZONE( "CC3PoseEngine::applyPose" );
+
+	m_pose.reset( boneCount );
+	GLuint count = m_pose.getPaddedCount();
+
+	bool hasAdditiveLayers = false;
+	for (size_t lIdx = 0; lIdx < m_layers.size(); lIdx++)
+	{
+		CC3PoseLayer& layer = m_layers[lIdx];
+		if ( layer.isAdditive )
+		{
+			hasAdditiveLayers = true;
+			continue;
+		}
+		sampleLayer( layer );
+		blendPoseSample( m_pose, layer.sample, count );
+	}
+	normalizePose( m_pose, count );
+
+	if ( hasAdditiveLayers )
+	{
+		fillUnanimatedComponents();
+		for (size_t lIdx = 0; lIdx < m_layers.size(); lIdx++)
+		{
+			CC3PoseLayer& layer = m_layers[lIdx];
+			if ( !layer.isAdditive )
+				continue;
+			sampleLayer( layer );
+			addPoseSample( m_pose, layer.sample, count );
+		}
+	}
+
+	writePose();
+}
+
+void CC3PoseEngine::initForNode( CC3Node* aNode )
+{
+	m_pNode = aNode;							// weak reference
+	populateBones();
+}
+
+CC3PoseEngine* CC3PoseEngine::poseEngineForNode( CC3Node* aNode )
+{
+	CC3PoseEngine* pEngine = new CC3PoseEngine;
+	pEngine->initForNode( aNode );
+	pEngine->autorelease();
+
+	return pEngine;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,191 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_POSE_ENGINE_H_
+#define _CC3_POSE_ENGINE_H_
+
+NS_COCOS3D_BEGIN
+
+/**
+ * CC3PoseBuffer holds the location, quaternion and scale of every bone of a skeleton, along
+ * with the weight accumulated for each of those components, as a structure of arrays. Each
+ * array holds one element per bone, padded with zero-weight elements to a multiple of four,
+ * so that the blending kernels can process four bones at a time without a scalar tail.
+ */
+class CC3PoseBuffer
+{
+public:
+	/** Resizes all arrays to hold the specified number of bones, and clears them to zero. */
+	void						reset( GLuint boneCount );
+
+	/** Returns the padded number of elements in each array. */
+	GLuint						getPaddedCount();
+
+	std::vector<GLfloat>		locX, locY, locZ;
+	std::vector<GLfloat>		quatX, quatY, quatZ, quatW;
+	std::vector<GLfloat>		scaleX, scaleY, scaleZ;
+	std::vector<GLfloat>		weightL, weightQ, weightS;
+};
+
+/** The settings and working storage for one animation track evaluated by a CC3PoseEngine. */
+class CC3PoseLayer
+{
+public:
+	GLuint						trackID;
+	bool						isAdditive;
+	std::vector<CC3Node*>		maskNodes;		// Nodes that have been assigned a mask weight
+	std::vector<GLfloat>		maskNodeWeights;	// The mask weight assigned to each of those nodes
+	std::vector<GLfloat>		maskWeights;	// The resolved mask weight of each bone. Empty if not masked.
+	CC3PoseBuffer				referencePose;	// Populated for additive layers only.
+	CC3PoseBuffer				sample;
+};
+
+/**
+ * CC3PoseEngine evaluates the animation of an entire skeleton in one batched pass, as a
+ * replacement for the per-node blending performed by each node during updating.
+ *
+ * A pose engine is attached to the root node of an animated character, using the poseEngine
+ * property of that node. The bones of the character are the root node and every descendant
+ * node that contains animation. Each animation track found on those bones becomes a layer
+ * of the engine. When the root node is updated, the engine:
+ *   - evaluates the animation of every bone on every layer at its current animation time,
+ *     into flat pose buffers, reading the tracks of compressed animations directly,
+ *   - applies the bone mask of each layer to the weights of the sampled bones,
+ *   - blends the normal layers together by their blending weights,
+ *   - applies the additive layers on top of the blended pose,
+ *   - writes the resulting location, quaternion and scale back to each bone, and marks
+ *     each bone as no longer requiring its own animation update.
+ *
+ * The blending, masking and additive kernels operate on four bones at a time, using SSE or
+ * NEON instructions when enabled by the CC3_SIMD_SSE or CC3_SIMD_NEON build setting.
+ *
+ * Quaternions are blended using a normalized weighted sum, with each sample first flipped
+ * into the hemisphere of the accumulated result. This differs slightly from the incremental
+ * slerp performed by CC3Node when blending more than one track, but is identical for a
+ * single track, and is much cheaper to vectorize.
+ *
+ * An additive layer contributes the difference between its current pose and its reference
+ * pose, which is the first frame of the animation on that track. Locations are offset by the
+ * weighted difference, rotations are pre-multiplied by the weighted difference rotation, and
+ * scales are multiplied by the weighted ratio of scales.
+ *
+ * The engine performs its work on the thread that updates the root node. To distribute many
+ * characters across a pool of worker threads, place each character as a separate child of
+ * the scene, and set the shouldUpdateInParallel property of the scene updating visitor.
+ *
+ * While a node is animated by a pose engine, the establishAnimationFrameAt:onTrack: method of
+ * that node only records the animation time, and the frame is evaluated by the engine. See the
+ * isPosedByPoseEngine method of CC3Node.
+ *
+ * The bones are collected when the engine is created. If nodes or animation tracks are
+ * subsequently added to, or removed from, the character, invoke the populateBones method.
+ * The engine holds weak references to the root node and bones.
+ */
+class CC3PoseEngine : public CCObject
+{
+public:
+	CC3PoseEngine();
+	virtual ~CC3PoseEngine();
+
+	/** The root node of the skeleton animated by this engine. */
+	CC3Node*					getNode();
+
+	/** Returns the number of bones animated by this engine. */
+	GLuint						getBoneCount();
+
+	/** Returns the number of animation tracks, or layers, evaluated by this engine. */
+	GLuint						getLayerCount();
+
+	/**
+	 * Collects the bones and animation tracks from the root node and its descendants, and
+	 * captures the reference pose of each additive layer. The settings of existing layers
+	 * are retained. Invoked automatically when the engine is created.
+	 */
+	void						populateBones();
+
+	/**
+	 * Indicates whether the animation on the specified track is applied additively, on top
+	 * of the blend of the normal tracks, instead of being blended with them.
+	 *
+	 * The initial value of this property is NO for all tracks.
+	 */
+	bool						isAdditiveTrack( GLuint trackID );
+	void						setIsAdditiveTrack( GLuint trackID, bool isAdditive );
+
+	/**
+	 * Sets the mask weight of the specified node, and all of its descendant bones, on the
+	 * specified track. The blending weight of the animation state of each of those bones is
+	 * multiplied by the mask weight. A mask weight of zero removes those bones from the track,
+	 * allowing, for example, an upper-body animation to be layered over a walk cycle.
+	 *
+	 * A descendant that has been assigned its own mask weight uses that weight instead, so
+	 * a mask can be built by assigning a weight to a limb, and then a different weight to
+	 * one of the joints within that limb. Bones that are not covered by any assigned mask
+	 * weight have a mask weight of one.
+	 */
+	void						setMaskWeight( GLfloat weight, GLuint trackID, CC3Node* aNode );
+
+	/** Returns the mask weight of the specified node on the specified track. */
+	GLfloat						getMaskWeight( GLuint trackID, CC3Node* aNode );
+
+	/** Removes the mask from the specified track, restoring a mask weight of one for all bones. */
+	void						removeMask( GLuint trackID );
+
+	/**
+	 * Evaluates the animation of all bones on all tracks, and writes the resulting pose back
+	 * to the bones. Does nothing if none of the bones has changed animation state since the
+	 * last evaluation.
+	 *
+	 * This method is invoked automatically when the root node is updated.
+	 */
+	void						applyPose();
+
+	/** Initializes this instance to animate the specified node and its descendants. */
+	void						initForNode( CC3Node* aNode );
+
+	/** Allocates and initializes an autoreleased instance to animate the specified node and its descendants. */
+	static CC3PoseEngine*		poseEngineForNode( CC3Node* aNode );
+
+protected:
+	void						collectBones( CC3Node* aNode );
+	void						collectLayers();
+	CC3PoseLayer*				getLayer( GLuint trackID );
+	GLfloat						resolveMaskWeight( CC3PoseLayer& layer, CC3Node* aNode );
+	void						resolveMask( CC3PoseLayer& layer );
+	void						captureReferencePose( CC3PoseLayer& layer );
+	void						sampleLayer( CC3PoseLayer& layer );
+	void						fillUnanimatedComponents();
+	void						writePose();
+
+protected:
+	CC3Node*					m_pNode;
+	std::vector<CC3Node*>		m_bones;
+	std::vector<CC3PoseLayer>	m_layers;
+	CC3PoseBuffer				m_pose;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -243,6 +243,55 @@ static inline CC3Box CC3BoxScaleUniform( const CC3Box& bb, GLfloat scale )
     return bbScaled;
 }
 
+/**
+ * Returns whether the line of the specified ray passes through the specified bounding box, and
+ * returns the range of that line that lies within the box in the nearDist and farDist parameters,
+ * in multiples of the ray direction vector, as with CC3RayIntersectionWithPlane. Either value may
+ * be negative, if the box lies partly or completely behind the startLocation of the ray.
+ *
+ * The invDirection parameter must contain the reciprocal of each component of the direction of
+ * the ray. It is passed separately so that it can be calculated once, when testing a single ray
+ * against many boxes, such as when traversing a bounding volume hierarchy.
+ *
+ * This function uses the slab method, and is considerably faster than CC3RayIntersectionWithBox,
+ * but does not calculate the location of the intersection.
+ */
+static inline bool CC3DoesRayLineIntersectBox( const CC3Ray& aRay, const CC3Vector& invDirection, const CC3Box& bb, float& nearDist, float& farDist )
+{
+    const float* rs = &aRay.startLocation.x;
+    const float* rd = &aRay.direction.x;
+    const float* rdInv = &invDirection.x;
+    const float* bbMin = &bb.minimum.x;
+    const float* bbMax = &bb.maximum.x;
+
+    nearDist = -kCC3MaxGLfloat;
+    farDist = kCC3MaxGLfloat;
+    for (int i = 0; i < 3; i++)
+    {
+        // A ray parallel to this pair of sides passes through the box only if it starts between them
+        if (rd[i] == 0.0f)
+        {
+            if (rs[i] < bbMin[i] || rs[i] > bbMax[i])
+                return false;
+            continue;
+        }
+
+        float t1 = (bbMin[i] - rs[i]) * rdInv[i];
+        float t2 = (bbMax[i] - rs[i]) * rdInv[i];
+        if (t1 > t2)
+        {
+            float tmp = t1;
+            t1 = t2;
+            t2 = tmp;
+        }
+        if (t1 > nearDist) nearDist = t1;
+        if (t2 < farDist) farDist = t2;
+        if (nearDist > farDist)
+            return false;
+    }
+    return true;
+}
+
 /**
  * Returns the location that the specified ray intersects the specified bounding box,
  * on the side of the bounding box that has the specified normal, but only if the
@@ -26,6 +26,7 @@
 #include "cocos3d.h"
 
 #include <time.h>
+#include <pthread.h>
 #ifdef _WIN32
 #include <windows.h>
 #include <iostream>
@@ -35,6 +36,12 @@
 #else
 #include <unistd.h>
 #include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+#include <mach/mach_time.h>
+#elif defined(__linux__) || defined(ANDROID)
+#include <sys/syscall.h>
 #endif
 
 NS_COCOS3D_BEGIN
@@ -85,4 +92,72 @@ unsigned long CC3Platform::getCurrentMilliseconds()
 #endif
 }
 
+void CC3Platform::getAbsoluteTimeAfter( unsigned long milliseconds, struct timespec* absTime )
+{
+#ifdef _WIN32
+	timevalue ptv;
+	gettimeofday( &ptv );
+#else
+	struct timeval ptv;
+	gettimeofday( &ptv, NULL );
+#endif
+	long long nanos = (long long)ptv.tv_usec * 1000 + (long long)(milliseconds % 1000) * 1000000;
+	absTime->tv_sec = ptv.tv_sec + (long)(milliseconds / 1000) + (long)(nanos / 1000000000);
+	absTime->tv_nsec = (long)(nanos % 1000000000);
+}
+
+unsigned long long CC3Platform::getCurrentNanoseconds()
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = { 0 };
+	if ( frequency.QuadPart == 0 )
+		QueryPerformanceFrequency( &frequency );
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter( &counter );
+	unsigned long long secs = (unsigned long long)(counter.QuadPart / frequency.QuadPart);
+	unsigned long long rem = (unsigned long long)(counter.QuadPart % frequency.QuadPart);
+	return secs * 1000000000ULL + rem * 1000000000ULL / (unsigned long long)frequency.QuadPart;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+	static mach_timebase_info_data_t timebase = { 0, 0 };
+	if ( timebase.denom == 0 )
+		mach_timebase_info( &timebase );
+
+	return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+unsigned long CC3Platform::getCurrentThreadID()
+{
+#if defined(_WIN32)
+	return (unsigned long)GetCurrentThreadId();
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+	return (unsigned long)pthread_mach_thread_np( pthread_self() );
+#elif defined(__linux__) || defined(ANDROID)
+	return (unsigned long)syscall( SYS_gettid );
+#else
+	return (unsigned long)pthread_self();
+#endif
+}
+
+unsigned long CC3Platform::getPeakResidentKilobytes()
+{
+#if defined(_WIN32)
+	return 0;
+#else
+	struct rusage usage;
+	if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+		return 0;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+	return (unsigned long)(usage.ru_maxrss / 1024);		// Reported in bytes
+#else
+	return (unsigned long)usage.ru_maxrss;				// Reported in kilobytes
+#endif
+#endif
+}
+
 NS_COCOS3D_END
@@ -26,12 +26,35 @@
 #ifndef _CC3_PLATFORM_H_
 #define _CC3_PLATFORM_H_
 
+struct timespec;
+
 NS_COCOS3D_BEGIN
 
 class CC3Platform
 {
 public:
 	static unsigned long	getCurrentMilliseconds();
+
+	/**
+	 * Populates the specified timespec with the absolute wall-clock time that lies the specified
+	 * number of milliseconds from now, suitable for use as a pthread_cond_timedwait deadline.
+	 */
+	static void				getAbsoluteTimeAfter( unsigned long milliseconds, struct timespec* absTime );
+
+	/**
+	 * Returns the current value of a high-resolution monotonic clock, in nanoseconds.
+	 * The value is only meaningful when compared with other values returned by this method.
+	 */
+	static unsigned long long	getCurrentNanoseconds();
+
+	/** Returns an identifier for the calling thread, suitable for labelling profiling and log output. */
+	static unsigned long	getCurrentThreadID();
+
+	/**
+	 * Returns the largest amount of physical memory that this process has held since it started,
+	 * in kilobytes, or zero if that is not available on this platform.
+	 */
+	static unsigned long	getPeakResidentKilobytes();
 };
 
 NS_COCOS3D_END
@@ -860,7 +860,11 @@ void CC3Material::drawWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
 	visitor->resetTextureUnits();
 
-	if (visitor->shouldDecorateNode())
+	if (visitor->isCurrentMaterialBound())
+	{
+		visitor->setCurrentColor( getEffectiveEmissionColor() );
+		skipTexturesWithVisitor( visitor );
+	} else if (visitor->shouldDecorateNode())
 	{
 		applyAlphaTestWithVisitor( visitor );
 		applyBlendWithVisitor( visitor );
@@ -955,6 +959,28 @@ void CC3Material::drawTexturesWithVisitor( CC3NodeDrawingVisitor* visitor )
 	visitor->bindEnvironmentalTextures();
 }
 
+/**
+ * Advances the texture units of the visitor past the textures of this material, which are
+ * already bound to the GL engine, then binds the environmental textures of the current node.
+ */
+void CC3Material::skipTexturesWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	if ( m_pTexture )
+		m_pTexture->incrementTextureUnitInVisitor( visitor );
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( m_textureOverlays, pObj )
+	{
+		CC3Texture* pTex = (CC3Texture*)pObj;
+		if ( pTex )
+		{
+			pTex->incrementTextureUnitInVisitor( visitor );
+		}
+	}
+
+	visitor->bindEnvironmentalTextures();
+}
+
 void CC3Material::unbindWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
 	CC3OpenGL* gl = visitor->getGL();
@@ -948,6 +948,10 @@ public:
 	 * If the texture property is nil, and there are no overlays, all texture units
 	 * in the GL engine will be disabled.
 	 *
+	 * If the isCurrentMaterialBound property of the visitor is YES, this material is already
+	 * bound to the GL engine by the previous draw command, and only the texture units and the
+	 * current color of the visitor are updated.
+	 *
 	 * This method is invoked automatically during node drawing. Usually, the application
 	 * never needs to invoke this method directly.
 	 */
@@ -972,6 +976,7 @@ public:
 	void						updateDisplayedOpacity( CCOpacity opacity );
 
 	void						drawTexturesWithVisitor( CC3NodeDrawingVisitor* visitor );
+	void						skipTexturesWithVisitor( CC3NodeDrawingVisitor* visitor );
 	bool						isCascadeOpacityEnabled();
 	void						texturesHaveChanged();
 	void						applyColorsWithVisitor( CC3NodeDrawingVisitor* visitor );
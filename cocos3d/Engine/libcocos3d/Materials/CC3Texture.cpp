@@ -150,6 +150,11 @@ bool CC3Texture::isUpsideDown()
 	return m_isUpsideDown;
 }
 
+bool CC3Texture::isLoading()
+{
+	return m_isLoading;
+}
+
 void CC3Texture::setIsUpsideDown( bool bUpsideDown )
 {
 	m_isUpsideDown = bUpsideDown;
@@ -261,7 +266,11 @@ bool CC3Texture::shouldFlipHorizontallyOnLoad()
 
 void CC3Texture::bindTextureContent( CC3CCTexture* texContent, GLenum target )
 {
-	checkTextureOrientation( texContent );
+	CC3_PROFILE_ZONE( "CC3Texture::uploadContent" );
+
+	// Content loaded in the background has already been oriented on the loading thread
+	if ( !m_isLoading )
+		checkTextureOrientation( texContent );
 
 	m_size = CC3IntSizeMake((GLint)texContent->getPixelsWide(), (GLint)texContent->getPixelsHigh());
 	m_coverage = CCSizeMake(texContent->getMaxS(), texContent->getMaxT());
@@ -567,6 +576,8 @@ bool CC3Texture::loadTarget( GLenum target, const std::string& filePath )
 
 bool CC3Texture::loadFromFile( const std::string& filePath )
 {
+	CC3_PROFILE_ZONE( "CC3Texture::loadFromFile" );
+
 	bool wasLoaded = loadTarget( getTextureTarget(), filePath );
 	if (wasLoaded && shouldGenerateMipmaps()) 
 		generateMipmap();
@@ -578,8 +589,13 @@ bool CC3Texture::loadFromFile( const std::string& filePath )
 
 void CC3Texture::checkTextureOrientation( CC3CCTexture* texContent )
 {
-	bool flipHorz = shouldFlipHorizontallyOnLoad();
-	bool flipVert = !XOR(texContent->isUpsideDown(), shouldFlipVerticallyOnLoad());
+	orientContent( texContent, shouldFlipHorizontallyOnLoad(), shouldFlipVerticallyOnLoad() );
+}
+
+void CC3Texture::orientContent( CC3CCTexture* texContent, bool shouldFlipHorizontally, bool shouldFlipVertically )
+{
+	bool flipHorz = shouldFlipHorizontally;
+	bool flipVert = !XOR(texContent->isUpsideDown(), shouldFlipVertically);
 
 	if (flipHorz && flipVert)
 		texContent->rotateHalfCircle();		// Do both in one pass
@@ -609,9 +625,14 @@ void CC3Texture::replacePixels( const CC3Viewport& rect, GLenum target, ccColor4
 */
 void CC3Texture::convertContent( ccColor4B* colorArray, GLuint pixCount )
 {
-	switch (m_pixelType) {
+	convertPixels( colorArray, pixCount, m_pixelFormat, m_pixelType );
+}
+
+void CC3Texture::convertPixels( ccColor4B* colorArray, GLuint pixCount, GLenum pixelFormat, GLenum pixelType )
+{
+	switch (pixelType) {
 	case GL_UNSIGNED_BYTE:
-		switch (m_pixelFormat) {
+		switch (pixelFormat) {
 		case GL_RGB: {
 			ccColor3B* rgbArray = (ccColor3B*)colorArray;
 			for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++)
@@ -753,6 +774,7 @@ void CC3Texture::initWithTag( GLuint aTag, const std::string& aName )
 	m_hasAlpha = false;
 	m_hasPremultipliedAlpha = false;
 	m_isUpsideDown = false;
+	m_isLoading = false;
 	m_shouldFlipVerticallyOnLoad = defaultShouldFlipVerticallyOnLoad();
 	m_shouldFlipHorizontallyOnLoad = defaultShouldFlipHorizontallyOnLoad();
 	setTextureParameters( defaultTextureParameters() );	// Marks params dirty
@@ -848,6 +870,78 @@ CC3Texture* CC3Texture::textureFromFile( const char* filePath )
 	return tex;
 }
 
+CC3Texture* CC3Texture::textureFromFileAsync( const char* filePath )
+{
+	return textureFromFileAsync( filePath, GL_ZERO, GL_ZERO );
+}
+
+CC3Texture* CC3Texture::textureFromFileAsync( const char* filePath, GLenum pixelFormat, GLenum pixelType )
+{
+	// A texture that is already loaded, or already loading, is shared by all requests
+	CC3Texture* tex = getTextureNamed( textureNameFromFilePath( filePath ) );
+	if ( tex )
+		return tex;
+
+	tex = new CC3Texture2D;
+	if ( !tex->initAsPlaceholderForFile( filePath ) )
+	{
+		CC_SAFE_DELETE( tex );
+		return NULL;
+	}
+
+	tex->autorelease();
+	addTexture( tex );
+
+	CC3TextureLoader::sharedTextureLoader()->loadTexture( tex, filePath, pixelFormat, pixelType );
+
+	return tex;
+}
+
+static ccColor4B _placeholderColor = { 255, 255, 255, 255 };
+
+ccColor4B CC3Texture::placeholderColor()
+{
+	return _placeholderColor;
+}
+
+void CC3Texture::setPlaceholderColor( const ccColor4B& color )
+{
+	_placeholderColor = color;
+}
+
+bool CC3Texture::initAsPlaceholderForFile( const std::string& filePath )
+{
+	if ( !init() )
+		return false;
+
+	setName( textureNameFromFilePath( filePath ).c_str() );
+
+	bindTextureOfColor( placeholderColor(), CC3IntSizeMake(1, 1), getTextureTarget() );
+	checkGLDebugLabel();
+
+	// File content is loaded upside-down, and flipped only if requested
+	m_isUpsideDown = !shouldFlipVerticallyOnLoad();
+	m_isLoading = true;
+
+	return true;
+}
+
+void CC3Texture::completeLoadWithContent( CC3CCTexture* texContent )
+{
+	if ( texContent )
+	{
+		bindTextureContent( texContent, getTextureTarget() );
+		if ( shouldGenerateMipmaps() ) 
+			generateMipmap();
+	}
+	else
+	{
+		CC3_TRACE( "CC3Texture could not load texture %s in the background", getName().c_str() );
+	}
+
+	m_isLoading = false;
+}
+
 std::string CC3Texture::textureNameFromFilePath( const std::string& filePath )
 { 
 	return filePath;
@@ -1072,6 +1166,23 @@ void CC3Texture2DContent::updatePixelFormat()
 	m_ePixelFormat = CCTexturePixelFormatFromGLFormatAndType(m_pixelGLFormat, m_pixelGLType);
 }
 
+bool CC3Texture2DContent::convertToPixelFormat( GLenum format, GLenum type )
+{
+	if ( !m_imageData || m_pixelGLFormat != GL_RGBA || m_pixelGLType != GL_UNSIGNED_BYTE )
+		return false;
+
+	if ( format == m_pixelGLFormat && type == m_pixelGLType )
+		return false;
+
+	CC3Texture::convertPixels( (ccColor4B*)m_imageData, (GLuint)(m_uPixelsWide * m_uPixelsHigh), format, type );
+
+	m_pixelGLFormat = format;
+	m_pixelGLType = type;
+	updatePixelFormat();
+
+	return true;
+}
+
 GLenum CC3Texture2DContent::getPixelGLFormat()
 {
 	return m_pixelGLFormat;
@@ -1099,9 +1210,13 @@ bool CC3Texture2DContent::initFromSTBIFile( const std::string& filePath )
 {
 	if( super::init() ) 
 	{
-		CC3STBImage* stbImage = CC3STBImage::imageFromFile( filePath.c_str() );
-		if (!stbImage) 
+		// Not autoreleased, so that content can be loaded on a background thread
+		CC3STBImage* stbImage = new CC3STBImage;
+		if ( !stbImage->initFromFile( filePath.c_str() ) )
+		{
+			stbImage->release();
 			return false;
+		}
 
 		m_imageData = stbImage->extractImageData();
 
@@ -1119,6 +1234,8 @@ bool CC3Texture2DContent::initFromSTBIFile( const std::string& filePath )
 		m_pixelGLType = stbImage->getPixelType();
 		updatePixelFormat();
 
+		stbImage->release();
+
 		return true;
 	}
 
@@ -1151,8 +1268,13 @@ bool CC3Texture2DContent::initFromOSFile( const std::string& filePath )
 		eImageFormat = CCImage::kFmtWebp;
 	}
 
+	// An absolute path can be loaded without touching the shared path cache,
+	// allowing content to be loaded on a background thread
 	CCImage* pImage = new CCImage;
-	if ( !pImage->initWithImageFile( filePath.c_str(), eImageFormat ) )
+	bool wasLoaded = CCFileUtils::sharedFileUtils()->isAbsolutePath( filePath )
+						? pImage->initWithImageFileThreadSafe( filePath.c_str(), eImageFormat )
+						: pImage->initWithImageFile( filePath.c_str(), eImageFormat );
+	if ( !wasLoaded )
 	{
 		pImage->release();
 		return false;
@@ -209,6 +209,18 @@ public:
 	virtual bool			isUpsideDown();
 	virtual void			setIsUpsideDown( bool isUpsideDown );
 
+	/**
+	 * Indicates whether the content of this texture is still being loaded in the background.
+	 *
+	 * A texture returned by the textureFromFileAsync method holds a small placeholder until
+	 * its file has been decoded on a background thread and uploaded to the GL engine by the
+	 * CC3TextureLoader. While the value of this property is YES, the texture can be applied to
+	 * materials and drawn normally, and will display the placeholder color.
+	 *
+	 * The value of this property is NO for textures loaded synchronously.
+	 */
+	virtual bool			isLoading();
+
 	/**
 	 * Returns the GL target of this texture.
 	 *
@@ -716,6 +728,68 @@ public:
 	 */
 	static CC3Texture*		textureFromFile( const char* filePath );
 
+	/**
+	 * Returns a texture for the specified file, whose content is loaded in the background.
+	 *
+	 * If a texture with the name derived from the file path is already in the cache, whether
+	 * it is fully loaded or still loading, it is returned, so that concurrent requests for the
+	 * same file share a single texture and a single decode. Otherwise, a 2D texture holding a
+	 * single pixel of the placeholderColor is returned immediately, is added to the cache, and
+	 * the file is queued on the sharedTextureLoader.
+	 *
+	 * The file is decoded, flipped according to the shouldFlipVerticallyOnLoad and 
+	 * shouldFlipHorizontallyOnLoad properties, and converted to any requested pixel format
+	 * on a background thread. The decoded content is then uploaded to the GL engine on the
+	 * rendering thread, within the per-frame upload budget of the CC3TextureLoader, at which
+	 * point the isLoading property of the texture changes to NO.
+	 *
+	 * The isUpsideDown property of the placeholder is set to the orientation the content will
+	 * have once loaded, so meshes that align their texture coordinates to this texture when it
+	 * is assigned do not need to be realigned when the content arrives.
+	 *
+	 * This method must be invoked from the rendering thread.
+	 */
+	static CC3Texture*		textureFromFileAsync( const char* filePath );
+
+	/**
+	 * Returns a texture for the specified file, whose content is loaded in the background, and
+	 * converted to the specified pixel format and type on the background thread.
+	 *
+	 * Conversion is performed only if the file is decoded as 32-bit RGBA content. See the notes
+	 * for the pixelFormat and pixelType properties for the range of values permitted for the
+	 * format and type parameters here. 
+	 *
+	 * See the notes for the textureFromFileAsync method for more information.
+	 */
+	static CC3Texture*		textureFromFileAsync( const char* filePath, GLenum pixelFormat, GLenum pixelType );
+
+	/**
+	 * Returns the color of the single-pixel placeholder content held by textures that are
+	 * being loaded in the background.
+	 *
+	 * The initial value of this property is opaque white, so that materials are displayed
+	 * using their own color until the texture content arrives.
+	 */
+	static ccColor4B		placeholderColor();
+	static void				setPlaceholderColor( const ccColor4B& color );
+
+	/**
+	 * Initializes this instance with placeholder content, as a texture whose content will be
+	 * loaded from the specified file in the background, and sets the isLoading property to YES.
+	 *
+	 * The name of this instance is set from the specified file path.
+	 */
+	virtual bool			initAsPlaceholderForFile( const std::string& filePath );
+
+	/**
+	 * Invoked by the CC3TextureLoader on the rendering thread to complete a background load,
+	 * binding the specified content, which has already been oriented, to the GL engine.
+	 *
+	 * If the specified content is NULL, the file could not be loaded, and this texture retains
+	 * its placeholder content. In either case, the isLoading property is set to NO.
+	 */
+	virtual void			completeLoadWithContent( CC3CCTexture* texContent );
+
 	/**
 	 * Initializes this instance from the specified texture properties, without providing content.
 	 *
@@ -1288,6 +1362,22 @@ public:
 	 */
 	virtual void			convertContent( ccColor4B* colorArray, GLuint pixCount );
 
+	/**
+	 * Converts the pixels in the specified array to the specified format and type, in place.
+	 *
+	 * This function does not reference any texture state, and may be invoked from any thread.
+	 */
+	static void				convertPixels( ccColor4B* colorArray, GLuint pixCount, GLenum pixelFormat, GLenum pixelType );
+
+	/**
+	 * Flips the specified content horizontally and vertically, as indicated, in a single pass
+	 * where both are required. Vertical flipping is performed if the upside-down orientation of
+	 * the content does not match the orientation requested by the shouldFlipVertically flag.
+	 *
+	 * This function does not reference any texture state, and may be invoked from any thread.
+	 */
+	static void				orientContent( CC3CCTexture* texContent, bool shouldFlipHorizontally, bool shouldFlipVertically );
+
 	/**
 	 * If the class-side shouldCacheAssociatedCCTextures propery is set to YES, and a CCTexture
 	 * with the same name as this texture does not already exist in the CCTextureCache, adds the
@@ -1319,6 +1409,7 @@ protected:
 	bool					m_shouldFlipHorizontallyOnLoad : 1;
 	bool					m_hasAlpha : 1;
 	bool					m_hasPremultipliedAlpha : 1;
+	bool					m_isLoading : 1;
 };
 
 /**
@@ -1988,6 +2079,15 @@ public:
 
 	void					updatePixelFormat();
 
+	/**
+	 * Converts the image data of this texture, in place, to the specified pixel format and type.
+	 *
+	 * Conversion is only possible from 32-bit RGBA content. Returns whether the content was
+	 * converted. Returns NO if this texture has no image data, if the content is not 32-bit
+	 * RGBA, or if the content is already in the specified format and type.
+	 */
+	bool					convertToPixelFormat( GLenum format, GLenum type );
+
 	GLenum					getPixelGLFormat();
 	GLenum					getPixelGLType();
 	bool					isUpsideDown();
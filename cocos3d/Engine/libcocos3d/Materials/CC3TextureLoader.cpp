@@ -0,0 +1,288 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+CC3TextureLoadRequest::CC3TextureLoadRequest()
+{
+	m_texture = NULL;
+	m_loader = NULL;
+	m_content = NULL;
+	m_pixelFormat = GL_ZERO;
+	m_pixelType = GL_ZERO;
+	m_shouldFlipVertically = false;
+	m_shouldFlipHorizontally = false;
+	m_wasDecoded = false;
+	m_isAwaited = true;
+}
+
+CC3TextureLoadRequest::~CC3TextureLoadRequest()
+{
+	CC_SAFE_RELEASE( m_content );
+	CC_SAFE_RELEASE( m_texture );
+	CC_SAFE_RELEASE( m_loader );
+}
+
+void CC3TextureLoadRequest::initForTexture( CC3Texture* texture, const std::string& filePath, GLenum pixelFormat, 
+										    GLenum pixelType, CC3TextureLoader* loader )
+{
+	m_texture = texture;
+	CC_SAFE_RETAIN( texture );
+
+	m_loader = loader;
+	CC_SAFE_RETAIN( loader );
+
+	// Resolve the path here, because the shared path cache cannot be used from a background thread
+	m_filePath = CCFileUtils::sharedFileUtils()->fullPathForFilename( filePath.c_str() );
+	m_pixelFormat = pixelFormat;
+	m_pixelType = pixelType;
+	m_shouldFlipVertically = texture->shouldFlipVerticallyOnLoad();
+	m_shouldFlipHorizontally = texture->shouldFlipHorizontallyOnLoad();
+}
+
+CC3Texture* CC3TextureLoadRequest::getTexture()
+{
+	return m_texture;
+}
+
+CC3TextureLoader* CC3TextureLoadRequest::getLoader()
+{
+	return m_loader;
+}
+
+const std::string& CC3TextureLoadRequest::getFilePath()
+{
+	return m_filePath;
+}
+
+CC3Texture2DContent* CC3TextureLoadRequest::getContent()
+{
+	return m_wasDecoded ? m_content : NULL;
+}
+
+GLuint CC3TextureLoadRequest::getContentByteCount()
+{
+	if ( !m_wasDecoded )
+		return 0;
+
+	return m_content->getPixelsWide() * m_content->getPixelsHigh() * m_content->getBytesPerPixel();
+}
+
+bool CC3TextureLoadRequest::isAwaited()
+{
+	return m_isAwaited;
+}
+
+void CC3TextureLoadRequest::setIsAwaited( bool isAwaited )
+{
+	m_isAwaited = isAwaited;
+}
+
+void CC3TextureLoadRequest::decodeContent()
+{
+	CC3_PROFILE_ZONE( "CC3TextureLoader::decode" );
+
+	// The content is released on the rendering thread, along with this request, even if it failed to load
+	m_content = new CC3Texture2DContent;
+	if ( !m_content->initFromFile( m_filePath ) || !m_content->getImageData() )
+		return;
+
+	CC3Texture::orientContent( m_content, m_shouldFlipHorizontally, m_shouldFlipVertically );
+
+	if ( m_pixelFormat != GL_ZERO && m_pixelType != GL_ZERO )
+		m_content->convertToPixelFormat( m_pixelFormat, m_pixelType );
+
+	m_wasDecoded = true;
+}
+
+
+CC3TextureLoader::CC3TextureLoader()
+{
+	m_uploadBytesPerFrame = kCC3TextureLoaderDefaultUploadBytesPerFrame;
+	m_frameUploadByteCount = 0;
+	m_uploadFrame = 0;
+	m_isUploadScheduled = false;
+}
+
+CC3TextureLoader::~CC3TextureLoader()
+{
+	// Each request retains this loader, so no requests remain by the time it is deallocated
+	if ( m_isUploadScheduled )
+		CCDirector::sharedDirector()->getScheduler()->unscheduleSelector( schedule_selector(CC3TextureLoader::uploadDecodedTextures), this );
+}
+
+GLuint CC3TextureLoader::getUploadBytesPerFrame()
+{
+	return m_uploadBytesPerFrame;
+}
+
+void CC3TextureLoader::setUploadBytesPerFrame( GLuint byteCount )
+{
+	m_uploadBytesPerFrame = byteCount;
+}
+
+unsigned int CC3TextureLoader::getPendingLoadCount()
+{
+	return (unsigned int)m_activeRequests.size();
+}
+
+void CC3TextureLoader::loadTexture( CC3Texture* texture, const std::string& filePath, GLenum pixelFormat, GLenum pixelType )
+{
+	if ( !texture )
+		return;
+
+	CC3TextureLoadRequest* request = new CC3TextureLoadRequest;		// released once uploaded or discarded
+	request->initForTexture( texture, filePath, pixelFormat, pixelType, this );
+	m_activeRequests.push_back( request );
+
+	CC3Backgrounder::sharedBackgrounder()->runBlockWithCompletion( decodeRequest, uploadDecodedRequest, request );
+}
+
+void CC3TextureLoader::cancelLoad( CC3Texture* texture )
+{
+	for ( unsigned int i = 0; i < m_activeRequests.size(); i++ )
+	{
+		if ( m_activeRequests[i]->getTexture() == texture )
+			m_activeRequests[i]->setIsAwaited( false );
+	}
+}
+
+/** The background task. Decodes the request, which is passed back to the rendering thread by the completion. */
+void CC3TextureLoader::decodeRequest( void* request )
+{
+	((CC3TextureLoadRequest*)request)->decodeContent();
+}
+
+/** The completion of the background task, run on the rendering thread. */
+void CC3TextureLoader::uploadDecodedRequest( void* request )
+{
+	CC3TextureLoadRequest* loadRequest = (CC3TextureLoadRequest*)request;
+	loadRequest->getLoader()->queueUpload( loadRequest );
+}
+
+/** Queues the decoded request for upload, and uploads as much as the budget of the current frame allows. */
+void CC3TextureLoader::queueUpload( CC3TextureLoadRequest* request )
+{
+	// Content that nothing is waiting for is discarded without consuming the upload budget
+	if ( !request->isAwaited() )
+	{
+		finishRequest( request );
+		return;
+	}
+
+	m_uploadQueue.push_back( request );
+	drainUploadQueue();
+}
+
+/**
+ * Uploads queued requests, in FIFO order, until the upload budget of the current frame is spent,
+ * always uploading at least one texture per frame. Whatever does not fit is uploaded from the
+ * CCScheduler during subsequent frames.
+ */
+void CC3TextureLoader::drainUploadQueue()
+{
+	unsigned int frame = CCDirector::sharedDirector()->getTotalFrames();
+	if ( frame != m_uploadFrame )
+	{
+		m_uploadFrame = frame;
+		m_frameUploadByteCount = 0;
+	}
+
+	CC3_PROFILE_ZONE( "CC3TextureLoader::upload" );
+
+	unsigned int takeCount = 0;
+	unsigned int readyCount = (unsigned int)m_uploadQueue.size();
+	while ( takeCount < readyCount )
+	{
+		CC3TextureLoadRequest* request = m_uploadQueue[takeCount];
+		GLuint reqBytes = request->getContentByteCount();
+		if ( m_frameUploadByteCount > 0 && m_frameUploadByteCount + reqBytes > m_uploadBytesPerFrame )
+			break;
+
+		// A load cancelled while its content was waiting for the budget is discarded
+		if ( request->isAwaited() )
+		{
+			request->getTexture()->completeLoadWithContent( request->getContent() );
+			m_frameUploadByteCount += MAX(reqBytes, 1);
+		}
+		finishRequest( request );
+		takeCount++;
+	}
+	m_uploadQueue.erase( m_uploadQueue.begin(), m_uploadQueue.begin() + takeCount );
+
+	bool shouldSchedule = !m_uploadQueue.empty();
+	if ( shouldSchedule == m_isUploadScheduled )
+		return;
+
+	m_isUploadScheduled = shouldSchedule;
+	if ( shouldSchedule )
+		CCDirector::sharedDirector()->getScheduler()->scheduleSelector( schedule_selector(CC3TextureLoader::uploadDecodedTextures), this, 0, false );
+	else
+		CCDirector::sharedDirector()->getScheduler()->unscheduleSelector( schedule_selector(CC3TextureLoader::uploadDecodedTextures), this );
+}
+
+/** Removes the specified request from the active requests, and releases it. */
+void CC3TextureLoader::finishRequest( CC3TextureLoadRequest* request )
+{
+	// A discarded texture keeps its placeholder content, but is no longer loading
+	if ( !request->isAwaited() )
+		request->getTexture()->completeLoadWithContent( NULL );
+
+	std::vector<CC3TextureLoadRequest*>::iterator iter = std::find( m_activeRequests.begin(), m_activeRequests.end(), request );
+	if ( iter != m_activeRequests.end() )
+		m_activeRequests.erase( iter );
+
+	request->release();
+}
+
+void CC3TextureLoader::uploadDecodedTextures( float dt )
+{
+	CC_UNUSED_PARAM(dt);
+	drainUploadQueue();
+}
+
+void CC3TextureLoader::init()
+{
+	// The backgrounder must first be accessed from the rendering thread, so that it can run completions there
+	CC3Backgrounder::sharedBackgrounder();
+}
+
+static CC3TextureLoader* _sharedTextureLoader = NULL;
+
+CC3TextureLoader* CC3TextureLoader::sharedTextureLoader()
+{
+	if ( !_sharedTextureLoader ) 
+	{
+		_sharedTextureLoader = new CC3TextureLoader;		// retained
+		_sharedTextureLoader->init();
+	}
+
+	return _sharedTextureLoader;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,200 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_TEXTURE_LOADER_H_
+#define _CC3_TEXTURE_LOADER_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3TextureLoader;
+
+/** The default number of bytes of texture content uploaded to the GL engine during each frame. */
+#define kCC3TextureLoaderDefaultUploadBytesPerFrame		(4 * 1024 * 1024)
+
+/**
+ * A single texture file queued on a CC3TextureLoader.
+ *
+ * The content is decoded, oriented and converted by a CC3Backgrounder task, and then handed
+ * back to the rendering thread to be uploaded to the GL engine. The request retains the texture,
+ * and its loader, until the upload is complete. All retain and release activity occurs on the
+ * rendering thread.
+ */
+class CC3TextureLoadRequest : public CCObject
+{
+public:
+	CC3TextureLoadRequest();
+	~CC3TextureLoadRequest();
+
+	/** 
+	 * Initializes this instance to load the specified file into the specified texture, on behalf
+	 * of the specified loader, converting it to the specified pixel format and type, unless they
+	 * are GL_ZERO.
+	 *
+	 * The orientation flags of the texture are captured at the time of this request.
+	 */
+	void					initForTexture( CC3Texture* texture, const std::string& filePath, GLenum pixelFormat, 
+											GLenum pixelType, CC3TextureLoader* loader );
+
+	/** Returns the texture whose content is being loaded. */
+	CC3Texture*				getTexture();
+
+	/** Returns the loader that is servicing this request. */
+	CC3TextureLoader*		getLoader();
+
+	/** Returns the absolute path of the file being loaded. */
+	const std::string&		getFilePath();
+
+	/** Returns the decoded content, or NULL if it has not been decoded, or could not be loaded. */
+	CC3Texture2DContent*	getContent();
+
+	/** Returns the number of bytes of decoded content that will be uploaded to the GL engine. */
+	GLuint					getContentByteCount();
+
+	/**
+	 * Indicates whether the texture is still waiting for its content.
+	 *
+	 * The initial value of this property is YES. It is cleared by the cancelLoad: method of
+	 * the CC3TextureLoader, in which case the decoded content is discarded instead of being
+	 * uploaded to the GL engine. This property must only be accessed from the rendering thread.
+	 */
+	bool					isAwaited();
+	void					setIsAwaited( bool isAwaited );
+
+	/** 
+	 * Loads the file, and orients and converts the content. 
+	 *
+	 * Invoked on a background thread. This method must not retain, release or autorelease any
+	 * object that is visible to the rendering thread.
+	 */
+	void					decodeContent();
+
+protected:
+	CC3Texture*				m_texture;
+	CC3TextureLoader*		m_loader;
+	CC3Texture2DContent*	m_content;
+	std::string				m_filePath;
+	GLenum					m_pixelFormat;
+	GLenum					m_pixelType;
+	bool					m_shouldFlipVertically : 1;
+	bool					m_shouldFlipHorizontally : 1;
+	bool					m_wasDecoded : 1;
+	bool					m_isAwaited : 1;
+};
+
+/**
+ * CC3TextureLoader loads texture files in the background, so that decoding large images does
+ * not stall the rendering thread.
+ *
+ * Each request is submitted to the sharedBackgrounder as a CC3Backgrounder task, which decodes
+ * the file, flips it into the required orientation, and converts it to any requested pixel format.
+ * The number of files decoded concurrently is therefore governed by the maxConcurrentTasks property
+ * of the CC3Backgrounder. The completion block of each task, which runs on the rendering thread,
+ * queues the decoded content and uploads it to the GL engine, limited by the uploadBytesPerFrame
+ * property, so that a burst of completed decodes does not cause a single long frame. Content that
+ * does not fit within the budget of the current frame is uploaded from the CCScheduler during
+ * subsequent frames.
+ *
+ * Textures are normally loaded in the background through the CC3Texture textureFromFileAsync
+ * method, which returns a placeholder texture immediately, and deduplicates requests for the
+ * same file through the texture cache.
+ *
+ * If the load of a texture has been cancelled with the cancelLoad: method by the time its
+ * content is ready, the upload is skipped, and the content is discarded.
+ *
+ * The sharedTextureLoader singleton must first be accessed from the rendering thread.
+ */
+class CC3TextureLoader : public CCObject 
+{
+public:
+	CC3TextureLoader();
+	~CC3TextureLoader();
+
+	void					init();
+
+	/**
+	 * Specifies the maximum number of bytes of texture content that will be uploaded to the
+	 * GL engine during each frame.
+	 *
+	 * At least one texture is uploaded during each frame in which decoded content is waiting,
+	 * even if its content exceeds this budget, so that large textures are not held back forever.
+	 *
+	 * The initial value of this property is kCC3TextureLoaderDefaultUploadBytesPerFrame.
+	 */
+	GLuint					getUploadBytesPerFrame();
+	void					setUploadBytesPerFrame( GLuint byteCount );
+
+	/** Returns the number of texture files that have been queued, and not yet uploaded to the GL engine. */
+	unsigned int			getPendingLoadCount();
+
+	/**
+	 * Queues the specified file to be loaded into the specified texture, which should hold
+	 * placeholder content, and have its isLoading property set to YES.
+	 *
+	 * If the pixel format and type are not GL_ZERO, the decoded content is converted to that
+	 * format and type on the background thread.
+	 *
+	 * This method must be invoked from the rendering thread.
+	 */
+	void					loadTexture( CC3Texture* texture, const std::string& filePath, GLenum pixelFormat, GLenum pixelType );
+
+	/**
+	 * Indicates that nothing is waiting any longer for the content of the specified texture,
+	 * which is being loaded by this loader. Once decoded, the content is discarded instead of
+	 * being uploaded to the GL engine, and the texture keeps its placeholder content.
+	 *
+	 * This method must be invoked from the rendering thread.
+	 */
+	void					cancelLoad( CC3Texture* texture );
+
+	/** 
+	 * Invoked by the CCScheduler on the rendering thread to upload decoded texture content that
+	 * did not fit within the upload budget of an earlier frame.
+	 */
+	void					uploadDecodedTextures( float dt );
+
+	/** Returns the singleton texture loader instance. */
+	static CC3TextureLoader* sharedTextureLoader();
+
+protected:
+	void					queueUpload( CC3TextureLoadRequest* request );
+	void					drainUploadQueue();
+	void					finishRequest( CC3TextureLoadRequest* request );
+
+	static void				decodeRequest( void* request );
+	static void				uploadDecodedRequest( void* request );
+
+protected:
+	std::vector<CC3TextureLoadRequest*>	m_activeRequests;
+	std::vector<CC3TextureLoadRequest*>	m_uploadQueue;
+	GLuint								m_uploadBytesPerFrame;
+	GLuint								m_frameUploadByteCount;
+	unsigned int						m_uploadFrame;
+	bool								m_isUploadScheduled : 1;
+};
+
+
+NS_COCOS3D_END
+
+#endif
@@ -33,7 +33,7 @@ NS_COCOS3D_BEGIN
 
 CC3AffineMatrix::CC3AffineMatrix()
 {
-
+	m_pContents = &m_contents;
 }
 
 CC3AffineMatrix* CC3AffineMatrix::matrix()
@@ -45,145 +45,160 @@ CC3AffineMatrix* CC3AffineMatrix::matrix()
 	return pMat;
 }
 
+CC3Matrix4x3* CC3AffineMatrix::getContents()
+{
+	return m_pContents;
+}
+
+void CC3AffineMatrix::setExternalContents( CC3Matrix4x3* contents )
+{
+	CC3Matrix4x3* newContents = contents ? contents : &m_contents;
+	if ( newContents == m_pContents )
+		return;
+
+	CC3Matrix4x3PopulateFrom4x3( newContents, m_pContents );
+	m_pContents = newContents;
+}
+
 void CC3AffineMatrix::implPopulateZero()
 { 
-	CC3Matrix4x3PopulateZero( &m_contents ); 
+	CC3Matrix4x3PopulateZero( m_pContents ); 
 }
 
 void CC3AffineMatrix::implPopulateIdentity()
 {
-	CC3Matrix4x3PopulateIdentity( &m_contents ); 
+	CC3Matrix4x3PopulateIdentity( m_pContents ); 
 }
 
 // Double-dispatch to the other matrix
 void CC3AffineMatrix::implPopulateFrom( CC3Matrix* aMatrix )
 { 
-	aMatrix->populateCC3Matrix4x3( &m_contents ); 
+	aMatrix->populateCC3Matrix4x3( m_pContents ); 
 }
 
 void CC3AffineMatrix::implPopulateFromCC3Matrix3x3( CC3Matrix3x3* mtx )
 { 
-	CC3Matrix4x3PopulateFrom3x3( &m_contents, mtx );
+	CC3Matrix4x3PopulateFrom3x3( m_pContents, mtx );
 }
 
 void CC3AffineMatrix::populateCC3Matrix3x3( CC3Matrix3x3* mtx )
 { 
-	CC3Matrix3x3PopulateFrom4x3( mtx, &m_contents ); 
+	CC3Matrix3x3PopulateFrom4x3( mtx, m_pContents ); 
 }
 
 void CC3AffineMatrix::implPopulateFromCC3Matrix4x3( CC3Matrix4x3* mtx )
 { 
-	CC3Matrix4x3PopulateFrom4x3( &m_contents, mtx ); 
+	CC3Matrix4x3PopulateFrom4x3( m_pContents, mtx ); 
 }
 
 void CC3AffineMatrix::populateCC3Matrix4x3( CC3Matrix4x3* mtx )
 { 
-	CC3Matrix4x3PopulateFrom4x3( mtx, &m_contents ); 
+	CC3Matrix4x3PopulateFrom4x3( mtx, m_pContents ); 
 }
 
 void CC3AffineMatrix::implPopulateFromCC3Matrix4x4( CC3Matrix4x4* mtx )
 { 
-	CC3Matrix4x3PopulateFrom4x4( &m_contents, mtx ); 
+	CC3Matrix4x3PopulateFrom4x4( m_pContents, mtx ); 
 }
 
 void CC3AffineMatrix::populateCC3Matrix4x4( CC3Matrix4x4* mtx )
 {
-	CC3Matrix4x4PopulateFrom4x3( mtx, &m_contents ); 
+	CC3Matrix4x4PopulateFrom4x3( mtx, m_pContents ); 
 }
 
 void CC3AffineMatrix::implPopulateFromRotation( const CC3Vector& aRotation )
 {
-	CC3Matrix4x3PopulateFromRotationYXZ( &m_contents, aRotation );
+	CC3Matrix4x3PopulateFromRotationYXZ( m_pContents, aRotation );
 }
 
 void CC3AffineMatrix::implPopulateFromQuaternion( const CC3Quaternion& aQuaternion )
 {
-	CC3Matrix4x3PopulateFromQuaternion( &m_contents, aQuaternion );
+	CC3Matrix4x3PopulateFromQuaternion( m_pContents, aQuaternion );
 }
 
 void CC3AffineMatrix::implPopulateFromScale( const CC3Vector& aScale )
 {
-	CC3Matrix4x3PopulateFromScale( &m_contents, aScale );
+	CC3Matrix4x3PopulateFromScale( m_pContents, aScale );
 }
 
 void CC3AffineMatrix::implPopulateFromTranslation( const CC3Vector& aTranslation )
 {
-	CC3Matrix4x3PopulateFromTranslation( &m_contents, aTranslation );
+	CC3Matrix4x3PopulateFromTranslation( m_pContents, aTranslation );
 }
 
 void CC3AffineMatrix::implPopulateToPointTowards( const CC3Vector& fwdDirection, const CC3Vector& upDirection )
 {
-	CC3Matrix4x3PopulateToPointTowards( &m_contents, fwdDirection, upDirection );
+	CC3Matrix4x3PopulateToPointTowards( m_pContents, fwdDirection, upDirection );
 }
 
 void CC3AffineMatrix::implPopulateOrthoFromFrustumLeft( GLfloat left, GLfloat right, GLfloat top, GLfloat bottom, GLfloat nearval, GLfloat farval )
 {
-	CC3Matrix4x3PopulateOrthoFrustum( &m_contents, left, right, top, bottom, nearval, farval );
+	CC3Matrix4x3PopulateOrthoFrustum( m_pContents, left, right, top, bottom, nearval, farval );
 }
 
 void CC3AffineMatrix::implPopulateOrthoFromFrustumLeft( GLfloat left, GLfloat right, GLfloat top, GLfloat bottom, GLfloat nearval ) 
 {
-	CC3Matrix4x3PopulateInfiniteOrthoFrustum( &m_contents, left, right, top, bottom, nearval);
+	CC3Matrix4x3PopulateInfiniteOrthoFrustum( m_pContents, left, right, top, bottom, nearval);
 }
 
 CC3Vector CC3AffineMatrix::extractRotation()
 { 
-	return CC3Matrix4x3ExtractRotationYXZ( &m_contents ); 
+	return CC3Matrix4x3ExtractRotationYXZ( m_pContents ); 
 }
 
 CC3Quaternion CC3AffineMatrix::extractQuaternion()
 { 
-	return CC3Matrix4x3ExtractQuaternion( &m_contents ); 
+	return CC3Matrix4x3ExtractQuaternion( m_pContents ); 
 }
 
 CC3Vector CC3AffineMatrix::extractForwardDirection() 
 { 
-	return CC3Matrix4x3ExtractForwardDirection( &m_contents ); 
+	return CC3Matrix4x3ExtractForwardDirection( m_pContents ); 
 }
 
 CC3Vector CC3AffineMatrix::extractUpDirection() 
 { 
-	return CC3Matrix4x3ExtractUpDirection( &m_contents ); 
+	return CC3Matrix4x3ExtractUpDirection( m_pContents ); 
 }
 
 CC3Vector CC3AffineMatrix::extractRightDirection()
 { 
-	return CC3Matrix4x3ExtractRightDirection( &m_contents ); 
+	return CC3Matrix4x3ExtractRightDirection( m_pContents ); 
 }
 
 CC3Vector CC3AffineMatrix::extractTranslation()
 {
-	return CC3Matrix4x3ExtractTranslation( &m_contents ); 
+	return CC3Matrix4x3ExtractTranslation( m_pContents ); 
 }
 
 void CC3AffineMatrix::implRotateBy( const CC3Vector& aRotation )
 { 
-	CC3Matrix4x3RotateYXZBy( &m_contents, aRotation ); 
+	CC3Matrix4x3RotateYXZBy( m_pContents, aRotation ); 
 }
 
 void CC3AffineMatrix::implRotateByQuaternion( const CC3Quaternion& aQuaternion )
 {
-	CC3Matrix4x3RotateByQuaternion( &m_contents, aQuaternion );
+	CC3Matrix4x3RotateByQuaternion( m_pContents, aQuaternion );
 }
 
 void CC3AffineMatrix::orthonormalizeRotationStartingWith( unsigned int startColNum )
 {
-	CC3Matrix4x3Orthonormalize( &m_contents, startColNum );
+	CC3Matrix4x3Orthonormalize( m_pContents, startColNum );
 }
 
 void CC3AffineMatrix::implScaleBy( const CC3Vector& aScale )
 { 
-	CC3Matrix4x3ScaleBy( &m_contents, aScale ); 
+	CC3Matrix4x3ScaleBy( m_pContents, aScale ); 
 }
 
 void CC3AffineMatrix::implTranslateBy( const CC3Vector& aTranslation )
 { 
-	CC3Matrix4x3TranslateBy( &m_contents, aTranslation ); 
+	CC3Matrix4x3TranslateBy( m_pContents, aTranslation ); 
 }
 
 void CC3AffineMatrix::implMultiplyBy( CC3Matrix* aMatrix )
 {
-	aMatrix->multiplyIntoCC3Matrix4x3( &m_contents );
+	aMatrix->multiplyIntoCC3Matrix4x3( m_pContents );
 }
 
 void CC3AffineMatrix::multiplyIntoCC3Matrix3x3( CC3Matrix3x3* mtx )
@@ -192,7 +207,7 @@ void CC3AffineMatrix::multiplyIntoCC3Matrix3x3( CC3Matrix3x3* mtx )
 		return;
 	CC3Matrix4x3 mRslt, mtx4;
 	CC3Matrix4x3PopulateFrom3x3(&mtx4, mtx);
-	CC3Matrix4x3Multiply(&mRslt, &mtx4, &m_contents);
+	CC3Matrix4x3Multiply(&mRslt, &mtx4, m_pContents);
 	CC3Matrix3x3PopulateFrom4x3(mtx, &mRslt);
 }
 
@@ -200,14 +215,14 @@ void CC3AffineMatrix::multiplyByCC3Matrix3x3( CC3Matrix3x3* mtx )
 {
 	if (m_isIdentity) 
 	{
-		CC3Matrix4x3PopulateFrom3x3(&m_contents, mtx);
+		CC3Matrix4x3PopulateFrom3x3(m_pContents, mtx);
 	} 
 	else
 	{
 		CC3Matrix4x3 mRslt, mtx4;
 		CC3Matrix4x3PopulateFrom3x3(&mtx4, mtx);
-		CC3Matrix4x3Multiply(&mRslt, &m_contents, &mtx4);
-		CC3Matrix4x3PopulateFrom4x3(&m_contents, &mRslt);
+		CC3Matrix4x3Multiply(&mRslt, m_pContents, &mtx4);
+		CC3Matrix4x3PopulateFrom4x3(m_pContents, &mRslt);
 	}
 }
 
@@ -216,7 +231,7 @@ void CC3AffineMatrix::multiplyIntoCC3Matrix4x3( CC3Matrix4x3* mtx )
 	if (m_isIdentity) 
 		return;
 	CC3Matrix4x3 mRslt;
-	CC3Matrix4x3Multiply(&mRslt, mtx, &m_contents);
+	CC3Matrix4x3Multiply(&mRslt, mtx, m_pContents);
 	CC3Matrix4x3PopulateFrom4x3(mtx, &mRslt);
 }
 
@@ -224,13 +239,13 @@ void CC3AffineMatrix::multiplyByCC3Matrix4x3( CC3Matrix4x3* mtx )
 {
 	if (m_isIdentity)
 	{
-		CC3Matrix4x3PopulateFrom4x3(&m_contents, mtx);
+		CC3Matrix4x3PopulateFrom4x3(m_pContents, mtx);
 	} 
 	else 
 	{
 		CC3Matrix4x3 mRslt;
-		CC3Matrix4x3Multiply(&mRslt, &m_contents, mtx);
-		CC3Matrix4x3PopulateFrom4x3(&m_contents, &mRslt);
+		CC3Matrix4x3Multiply(&mRslt, m_pContents, mtx);
+		CC3Matrix4x3PopulateFrom4x3(m_pContents, &mRslt);
 	}
 }
 
@@ -239,7 +254,7 @@ void CC3AffineMatrix::multiplyIntoCC3Matrix4x4( CC3Matrix4x4* mtx )
 	if (m_isIdentity) 
 		return;
 	CC3Matrix4x4 mRslt, mMine;
-	CC3Matrix4x4PopulateFrom4x3(&mMine, &m_contents);
+	CC3Matrix4x4PopulateFrom4x3(&mMine, m_pContents);
 	CC3Matrix4x4Multiply(&mRslt, mtx, &mMine);
 	CC3Matrix4x4PopulateFrom4x4(mtx, &mRslt);
 }
@@ -248,20 +263,20 @@ void CC3AffineMatrix::multiplyByCC3Matrix4x4( CC3Matrix4x4* mtx )
 {
 	if (m_isIdentity) 
 	{
-		CC3Matrix4x3PopulateFrom4x4(&m_contents, mtx);
+		CC3Matrix4x3PopulateFrom4x4(m_pContents, mtx);
 	} 
 	else 
 	{
 		CC3Matrix4x4 mRslt, mMine;
-		CC3Matrix4x4PopulateFrom4x3(&mMine, &m_contents);
+		CC3Matrix4x4PopulateFrom4x3(&mMine, m_pContents);
 		CC3Matrix4x4Multiply(&mRslt, &mMine, mtx);
-		CC3Matrix4x3PopulateFrom4x4(&m_contents, &mRslt);
+		CC3Matrix4x3PopulateFrom4x4(m_pContents, &mRslt);
 	}
 }
 
 void CC3AffineMatrix::implLeftMultiplyBy( CC3Matrix* aMatrix )
 {
-	aMatrix->leftMultiplyIntoCC3Matrix4x3( &m_contents );
+	aMatrix->leftMultiplyIntoCC3Matrix4x3( m_pContents );
 }
 
 void CC3AffineMatrix::leftMultiplyIntoCC3Matrix3x3( CC3Matrix3x3* mtx )
@@ -271,7 +286,7 @@ void CC3AffineMatrix::leftMultiplyIntoCC3Matrix3x3( CC3Matrix3x3* mtx )
 
 	CC3Matrix4x3 mRslt, mtx4;
 	CC3Matrix4x3PopulateFrom3x3(&mtx4, mtx);
-	CC3Matrix4x3Multiply(&mRslt, &m_contents, &mtx4);
+	CC3Matrix4x3Multiply(&mRslt, m_pContents, &mtx4);
 	CC3Matrix3x3PopulateFrom4x3(mtx, &mRslt);
 }
 
@@ -279,14 +294,14 @@ void CC3AffineMatrix::leftMultiplyByCC3Matrix3x3( CC3Matrix3x3* mtx )
 {
 	if (m_isIdentity) 
 	{
-		CC3Matrix4x3PopulateFrom3x3(&m_contents, mtx);
+		CC3Matrix4x3PopulateFrom3x3(m_pContents, mtx);
 	} 
 	else 
 	{
 		CC3Matrix4x3 mRslt, mtx4;
 		CC3Matrix4x3PopulateFrom3x3(&mtx4, mtx);
-		CC3Matrix4x3Multiply(&mRslt, &mtx4, &m_contents);
-		CC3Matrix4x3PopulateFrom4x3(&m_contents, &mRslt);
+		CC3Matrix4x3Multiply(&mRslt, &mtx4, m_pContents);
+		CC3Matrix4x3PopulateFrom4x3(m_pContents, &mRslt);
 	}
 }
 
@@ -295,7 +310,7 @@ void CC3AffineMatrix::leftMultiplyIntoCC3Matrix4x3( CC3Matrix4x3* mtx )
 	if (m_isIdentity) 
 		return;
 	CC3Matrix4x3 mRslt;
-	CC3Matrix4x3Multiply(&mRslt, &m_contents, mtx);
+	CC3Matrix4x3Multiply(&mRslt, m_pContents, mtx);
 	CC3Matrix4x3PopulateFrom4x3(mtx, &mRslt);
 }
 
@@ -303,13 +318,13 @@ void CC3AffineMatrix::leftMultiplyByCC3Matrix4x3( CC3Matrix4x3* mtx )
 {
 	if (m_isIdentity) 
 	{
-		CC3Matrix4x3PopulateFrom4x3(&m_contents, mtx);
+		CC3Matrix4x3PopulateFrom4x3(m_pContents, mtx);
 	}
 	else
 	{
 		CC3Matrix4x3 mRslt;
-		CC3Matrix4x3Multiply(&mRslt, mtx, &m_contents);
-		CC3Matrix4x3PopulateFrom4x3(&m_contents, &mRslt);
+		CC3Matrix4x3Multiply(&mRslt, mtx, m_pContents);
+		CC3Matrix4x3PopulateFrom4x3(m_pContents, &mRslt);
 	}
 }
 
@@ -318,7 +333,7 @@ void CC3AffineMatrix::leftMultiplyIntoCC3Matrix4x4( CC3Matrix4x4* mtx )
 	if (m_isIdentity) 
 		return;
 	CC3Matrix4x4 mRslt, mMine;
-	CC3Matrix4x4PopulateFrom4x3(&mMine, &m_contents);
+	CC3Matrix4x4PopulateFrom4x3(&mMine, m_pContents);
 	CC3Matrix4x4Multiply(&mRslt, &mMine, mtx);
 	CC3Matrix4x4PopulateFrom4x4(mtx, &mRslt);
 }
@@ -327,14 +342,14 @@ void CC3AffineMatrix::leftMultiplyByCC3Matrix4x4( CC3Matrix4x4* mtx )
 {
 	if (m_isIdentity) 
 	{
-		CC3Matrix4x3PopulateFrom4x4(&m_contents, mtx);
+		CC3Matrix4x3PopulateFrom4x4(m_pContents, mtx);
 	} 
 	else 
 	{
 		CC3Matrix4x4 mRslt, mMine;
-		CC3Matrix4x4PopulateFrom4x3(&mMine, &m_contents);
+		CC3Matrix4x4PopulateFrom4x3(&mMine, m_pContents);
 		CC3Matrix4x4Multiply(&mRslt, mtx, &mMine);
-		CC3Matrix4x3PopulateFrom4x4(&m_contents, &mRslt);
+		CC3Matrix4x3PopulateFrom4x4(m_pContents, &mRslt);
 	}
 }
 
@@ -344,7 +359,7 @@ CC3Vector CC3AffineMatrix::transformLocation( const CC3Vector& v )
 	if (m_isIdentity) 
 		return v;
 
-	return CC3Matrix4x3TransformLocation(&m_contents, v);
+	return CC3Matrix4x3TransformLocation(m_pContents, v);
 }
 
 // Short-circuit if this is an identity matrix
@@ -353,7 +368,7 @@ CC3Vector CC3AffineMatrix::transformDirection( const CC3Vector& v )
 	if (m_isIdentity) 
 		return v;
 
-	return CC3Matrix4x3TransformDirection(&m_contents, v);
+	return CC3Matrix4x3TransformDirection(m_pContents, v);
 }
 
 // Short-circuit if this is an identity matrix
@@ -362,14 +377,14 @@ CC3Vector4 CC3AffineMatrix::transformHomogeneousVector( const CC3Vector4& aVecto
 	if (m_isIdentity) 
 		return aVector;
 
-	return CC3Matrix4x3TransformCC3Vector4(&m_contents, aVector);
+	return CC3Matrix4x3TransformCC3Vector4(m_pContents, aVector);
 }
 
 // Short-circuit if this is an identity matrix
 void CC3AffineMatrix::transpose() 
 { 
 	if ( !m_isIdentity ) 
-		CC3Matrix4x3Transpose(&m_contents); 
+		CC3Matrix4x3Transpose(m_pContents); 
 }
 
 // Short-circuit if this is an identity matrix
@@ -378,14 +393,14 @@ bool CC3AffineMatrix::invertAdjoint()
 	if (m_isIdentity) 
 		return true;
 
-	return CC3Matrix4x3InvertAdjoint(&m_contents);
+	return CC3Matrix4x3InvertAdjoint(m_pContents);
 }
 
 // Short-circuit if this is an identity matrix
 void CC3AffineMatrix::invertRigid() 
 { 
 	if ( !m_isIdentity ) 
-		CC3Matrix4x3InvertRigid(&m_contents); 
+		CC3Matrix4x3InvertRigid(m_pContents); 
 }
 
 NS_COCOS3D_END
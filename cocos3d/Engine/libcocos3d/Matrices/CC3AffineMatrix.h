@@ -56,6 +56,22 @@ public:
 
 	static CC3AffineMatrix*	matrix();
 
+	/**
+	 * Returns the storage that holds the contents of this matrix. This is internal to this
+	 * matrix, unless it has been redirected by the setExternalContents method.
+	 */
+	CC3Matrix4x3*			getContents();
+
+	/**
+	 * Redirects the contents of this matrix to the specified external storage, after copying the
+	 * current contents into it. Setting this to NULL copies the contents back into storage that is
+	 * internal to this matrix, and reverts to using it.
+	 *
+	 * This allows the contents of many matrices to be held contiguously in a single array. The
+	 * external storage must remain valid until this method is invoked again to release it.
+	 */
+	void					setExternalContents( CC3Matrix4x3* contents );
+
 	virtual void			transpose();
 	virtual CC3Vector		extractRotation();
 	virtual CC3Quaternion	extractQuaternion();
@@ -114,6 +130,7 @@ protected:
 
 protected:
 	CC3Matrix4x3			m_contents;
+	CC3Matrix4x3*			m_pContents;
 };
 
 NS_COCOS3D_END
@@ -102,9 +102,8 @@ void CC3Matrix4x3PopulateInfiniteOrthoFrustum(CC3Matrix4x3* mtx,
 }
 
 
-void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR) 
+void CC3Matrix4x3MultiplyScalar(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR) 
 {
-	
 	mOut->c1r1 = (mL->c1r1 * mR->c1r1) + (mL->c2r1 * mR->c1r2) + (mL->c3r1 * mR->c1r3);
 	mOut->c1r2 = (mL->c1r2 * mR->c1r1) + (mL->c2r2 * mR->c1r2) + (mL->c3r2 * mR->c1r3);
 	mOut->c1r3 = (mL->c1r3 * mR->c1r1) + (mL->c2r3 * mR->c1r2) + (mL->c3r3 * mR->c1r3);
@@ -122,6 +121,75 @@ void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3M
 	mOut->c4r3 = (mL->c1r3 * mR->c4r1) + (mL->c2r3 * mR->c4r2) + (mL->c3r3 * mR->c4r3) + mL->c4r3;
 }
 
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+/**
+ * Multiplies the matrix whose columns are held in l1-l4 by the matrix whose elements are held
+ * in rElems, and stores the result in rslt, which must have room for one extra element.
+ *
+ * The columns of a 4x3 matrix are three floats wide, so each four-lane column register carries
+ * one garbage lane from the next column. The results are written with overlapping stores, so each
+ * store overwrites the garbage lane of the previous column.
+ */
+static inline void CC3Matrix4x3MultiplyColumns(GLfloat* rslt, const GLfloat* rElems,
+											   CC3Float4 l1, CC3Float4 l2, CC3Float4 l3, CC3Float4 l4)
+{
+	for (int col = 0; col < 4; col++)
+	{
+		const GLfloat* rc = rElems + (col * 3);
+		CC3Float4 sum = f4Mul(l1, f4Splat(rc[0]));
+		sum = f4MulAdd(sum, l2, f4Splat(rc[1]));
+		sum = f4MulAdd(sum, l3, f4Splat(rc[2]));
+		if (col == 3) sum = f4Add(sum, l4);		// Translation column has an implied W of one
+		f4Store(rslt + (col * 3), sum);
+	}
+}
+#endif
+
+void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR) 
+{
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+	// The results are written into a padded temporary, and then copied to mOut.
+	// Everything is read first, so mOut may alias.
+	const GLfloat* l = mL->elements;
+	GLfloat rElems[kCC3Matrix4x3ElementCount];
+	GLfloat rslt[kCC3Matrix4x3ElementCount + 1];
+	memcpy(rElems, mR->elements, sizeof(rElems));
+
+	CC3Float4 l1 = f4Load(l);
+	CC3Float4 l2 = f4Load(l + 3);
+	CC3Float4 l3 = f4Load(l + 6);
+	CC3Float4 l4 = f4Set(l[9], l[10], l[11], 0.0f);		// Avoid reading past the end of mL
+
+	CC3Matrix4x3MultiplyColumns(rslt, rElems, l1, l2, l3, l4);
+	memcpy(mOut->elements, rslt, sizeof(CC3Matrix4x3));
+#else
+	CC3Matrix4x3MultiplyScalar(mOut, mL, mR);
+#endif
+}
+
+void CC3Matrix4x3MultiplyBatchLeft(CC3Matrix4x3* mOuts, const CC3Matrix4x3* mL, const CC3Matrix4x3* mRs, GLuint count)
+{
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+	// The columns of mL are loaded once, and applied to each matrix in mRs in turn.
+	const GLfloat* l = mL->elements;
+	CC3Float4 l1 = f4Load(l);
+	CC3Float4 l2 = f4Load(l + 3);
+	CC3Float4 l3 = f4Load(l + 6);
+	CC3Float4 l4 = f4Set(l[9], l[10], l[11], 0.0f);
+
+	GLfloat rElems[kCC3Matrix4x3ElementCount];
+	GLfloat rslt[kCC3Matrix4x3ElementCount + 1];
+	for (GLuint i = 0; i < count; i++)
+	{
+		memcpy(rElems, mRs[i].elements, sizeof(rElems));
+		CC3Matrix4x3MultiplyColumns(rslt, rElems, l1, l2, l3, l4);
+		memcpy(mOuts[i].elements, rslt, sizeof(CC3Matrix4x3));
+	}
+#else
+	for (GLuint i = 0; i < count; i++)
+		CC3Matrix4x3MultiplyScalar(&mOuts[i], mL, &mRs[i]);
+#endif
+}
 
 CC3Vector4 CC3Matrix4x3TransformCC3Vector4(const CC3Matrix4x3* mtx, CC3Vector4 v)
 {
@@ -151,4 +219,70 @@ CC3Vector CC3Matrix4x3TransformDirection(const CC3Matrix4x3* mtx, CC3Vector v)
 	return vOut;
 }
 
+void CC3Matrix4x3TransformLocations(const CC3Matrix4x3* mtx, const CC3Vector* vIn, CC3Vector* vOut, GLuint count)
+{
+	// Copy the matrix elements to locals, so the compiler need not reload them if vOut aliases.
+	GLfloat c1r1 = mtx->c1r1, c2r1 = mtx->c2r1, c3r1 = mtx->c3r1, c4r1 = mtx->c4r1;
+	GLfloat c1r2 = mtx->c1r2, c2r2 = mtx->c2r2, c3r2 = mtx->c3r2, c4r2 = mtx->c4r2;
+	GLfloat c1r3 = mtx->c1r3, c2r3 = mtx->c2r3, c3r3 = mtx->c3r3, c4r3 = mtx->c4r3;
+	GLuint i = 0;
+
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+	// Four locations at a time, each loaded as one register per component, with each matrix
+	// element splatted across a register. The four locations are loaded before they are
+	// stored, so vOut may be the same as vIn. Any remainder is transformed below.
+	CC3Float4 s1r1 = f4Splat(c1r1), s2r1 = f4Splat(c2r1), s3r1 = f4Splat(c3r1), s4r1 = f4Splat(c4r1);
+	CC3Float4 s1r2 = f4Splat(c1r2), s2r2 = f4Splat(c2r2), s3r2 = f4Splat(c3r2), s4r2 = f4Splat(c4r2);
+	CC3Float4 s1r3 = f4Splat(c1r3), s2r3 = f4Splat(c2r3), s3r3 = f4Splat(c3r3), s4r3 = f4Splat(c4r3);
+	for ( ; i + 4 <= count; i += 4)
+	{
+		CC3Float4 x, y, z;
+		f4LoadVector3x4(&vIn[i].x, x, y, z);
+		CC3Float4 xOut = f4Add(f4MulAdd(f4MulAdd(f4Mul(s1r1, x), s2r1, y), s3r1, z), s4r1);
+		CC3Float4 yOut = f4Add(f4MulAdd(f4MulAdd(f4Mul(s1r2, x), s2r2, y), s3r2, z), s4r2);
+		CC3Float4 zOut = f4Add(f4MulAdd(f4MulAdd(f4Mul(s1r3, x), s2r3, y), s3r3, z), s4r3);
+		f4StoreVector3x4(&vOut[i].x, xOut, yOut, zOut);
+	}
+#endif
+
+	for ( ; i < count; i++)
+	{
+		GLfloat x = vIn[i].x, y = vIn[i].y, z = vIn[i].z;
+		vOut[i].x = (c1r1 * x) + (c2r1 * y) + (c3r1 * z) + c4r1;
+		vOut[i].y = (c1r2 * x) + (c2r2 * y) + (c3r2 * z) + c4r2;
+		vOut[i].z = (c1r3 * x) + (c2r3 * y) + (c3r3 * z) + c4r3;
+	}
+}
+
+void CC3Matrix4x3TransformDirections(const CC3Matrix4x3* mtx, const CC3Vector* vIn, CC3Vector* vOut, GLuint count)
+{
+	GLfloat c1r1 = mtx->c1r1, c2r1 = mtx->c2r1, c3r1 = mtx->c3r1;
+	GLfloat c1r2 = mtx->c1r2, c2r2 = mtx->c2r2, c3r2 = mtx->c3r2;
+	GLfloat c1r3 = mtx->c1r3, c2r3 = mtx->c2r3, c3r3 = mtx->c3r3;
+	GLuint i = 0;
+
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+	CC3Float4 s1r1 = f4Splat(c1r1), s2r1 = f4Splat(c2r1), s3r1 = f4Splat(c3r1);
+	CC3Float4 s1r2 = f4Splat(c1r2), s2r2 = f4Splat(c2r2), s3r2 = f4Splat(c3r2);
+	CC3Float4 s1r3 = f4Splat(c1r3), s2r3 = f4Splat(c2r3), s3r3 = f4Splat(c3r3);
+	for ( ; i + 4 <= count; i += 4)
+	{
+		CC3Float4 x, y, z;
+		f4LoadVector3x4(&vIn[i].x, x, y, z);
+		CC3Float4 xOut = f4MulAdd(f4MulAdd(f4Mul(s1r1, x), s2r1, y), s3r1, z);
+		CC3Float4 yOut = f4MulAdd(f4MulAdd(f4Mul(s1r2, x), s2r2, y), s3r2, z);
+		CC3Float4 zOut = f4MulAdd(f4MulAdd(f4Mul(s1r3, x), s2r3, y), s3r3, z);
+		f4StoreVector3x4(&vOut[i].x, xOut, yOut, zOut);
+	}
+#endif
+
+	for ( ; i < count; i++)
+	{
+		GLfloat x = vIn[i].x, y = vIn[i].y, z = vIn[i].z;
+		vOut[i].x = (c1r1 * x) + (c2r1 * y) + (c3r1 * z);
+		vOut[i].y = (c1r2 * x) + (c2r2 * y) + (c3r2 * z);
+		vOut[i].z = (c1r3 * x) + (c2r3 * y) + (c3r3 * z);
+	}
+}
+
 NS_COCOS3D_END
@@ -266,7 +266,7 @@ void CC3Matrix4x3PopulateInfiniteOrthoFrustum(CC3Matrix4x3* mtx,
 static inline CC3Vector CC3VectorFromCC3Matrix4x3Col(const CC3Matrix4x3* mtx, unsigned int colIdx) 
 {
 	CC3Vector* baseAddr = (CC3Vector*)&mtx->c1r1;
-	CC3Vector* finalAddr = baseAddr + (--colIdx) * sizeof( CC3Vector ); // Convert to zero-based.
+	CC3Vector* finalAddr = baseAddr + (--colIdx); // Convert to zero-based.
 	return *finalAddr;
 }
 
@@ -295,7 +295,7 @@ static inline CC3Vector4 CC3Vector4FromCC3Matrix4x3Col(const CC3Matrix4x3* mtx,
 {
 	GLfloat w = (colIdx == kCC3Matrix4x3ColumnCount) ? 1.0f : 0.0f;
 	CC3Vector* baseAddr = (CC3Vector*)&mtx->c1r1;
-	CC3Vector* finalAddr = baseAddr + (--colIdx) * sizeof( CC3Vector ); // Convert to zero-based.
+	CC3Vector* finalAddr = baseAddr + (--colIdx); // Convert to zero-based.
 	return CC3Vector4().fromCC3Vector(*finalAddr, w);	// Convert to zero-based.
 }
 
@@ -383,9 +383,33 @@ static inline CC3Vector CC3Matrix4x3ExtractTranslation(const CC3Matrix4x3* mtx)
 }
 
 
-/** Multiplies mL on the left by mR on the right, and stores the result in mOut. */
+/**
+ * Multiplies mL on the left by mR on the right, and stores the result in mOut.
+ *
+ * Depending on the CC3_SIMD_SSE and CC3_SIMD_NEON build settings, this function uses SSE2 or NEON
+ * vector instructions. Because all content is read before the result is written, mOut may be the
+ * same matrix as mL or mR when vector instructions are in use.
+ */
 void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR);
 
+/**
+ * Scalar implementation of CC3Matrix4x3Multiply, which is used when vector instructions are not
+ * available. It remains available when they are, to verify the results of the vector implementation.
+ * The mOut matrix must not be the same matrix as either mL or mR.
+ */
+void CC3Matrix4x3MultiplyScalar(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR);
+
+/**
+ * Multiplies the single matrix mL on the left by each matrix in the mRs array on the right, and
+ * stores each result in the corresponding element of the mOuts array. This is typically used to
+ * apply a common parent transform to many child transforms at once. Both arrays must contain
+ * at least count matrices. The mOuts array may be the same as the mRs array, but must not hold mL.
+ *
+ * When vector instructions are in use, the columns of mL are loaded into vector registers once,
+ * and reused for every matrix in the batch.
+ */
+void CC3Matrix4x3MultiplyBatchLeft(CC3Matrix4x3* mOuts, const CC3Matrix4x3* mL, const CC3Matrix4x3* mRs, GLuint count);
+
 /**
  * Rotates the specified matrix by the specified Euler angles in degrees. Rotation is performed
  * in YXZ order, which is the OpenGL default.
@@ -491,6 +515,24 @@ CC3Vector CC3Matrix4x3TransformLocation(const CC3Matrix4x3* mtx, CC3Vector v);
  */
 CC3Vector CC3Matrix4x3TransformDirection(const CC3Matrix4x3* mtx, CC3Vector v);
 
+/**
+ * Transforms each of the count 3D locations in the vIn array by the specified matrix, as if each
+ * was a 4D vector with a W value of 1, and stores the transformed locations in the vOut array.
+ * The vOut array may be the same as the vIn array.
+ *
+ * When vector instructions are in use, the locations are transformed four at a time.
+ */
+void CC3Matrix4x3TransformLocations(const CC3Matrix4x3* mtx, const CC3Vector* vIn, CC3Vector* vOut, GLuint count);
+
+/**
+ * Transforms each of the count 3D directions in the vIn array by the specified matrix, as if each
+ * was a 4D vector with a W value of 0, and stores the transformed directions in the vOut array.
+ * The vOut array may be the same as the vIn array.
+ *
+ * When vector instructions are in use, the directions are transformed four at a time.
+ */
+void CC3Matrix4x3TransformDirections(const CC3Matrix4x3* mtx, const CC3Vector* vIn, CC3Vector* vOut, GLuint count);
+
 /**
  * Orthonormalizes the rotation component of the specified matrix, using a Gram-Schmidt process,
  * and using the column indicated by the specified column number as the starting point of the
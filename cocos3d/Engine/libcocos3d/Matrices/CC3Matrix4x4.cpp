@@ -291,7 +291,7 @@ void CC3Matrix4x4PopulateInfiniteOrthoFrustum(CC3Matrix4x4* mtx,
 	mtx->c4r4 = 1.0f;
 }
 
-void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR) 
+void CC3Matrix4x4MultiplyScalar(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR) 
 {
 	mOut->c1r1 = (mL->c1r1 * mR->c1r1) + (mL->c2r1 * mR->c1r2) + (mL->c3r1 * mR->c1r3) + (mL->c4r1 * mR->c1r4);
 	mOut->c1r2 = (mL->c1r2 * mR->c1r1) + (mL->c2r2 * mR->c1r2) + (mL->c3r2 * mR->c1r3) + (mL->c4r2 * mR->c1r4);
@@ -314,6 +314,34 @@ void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3M
 	mOut->c4r4 = (mL->c1r4 * mR->c4r1) + (mL->c2r4 * mR->c4r2) + (mL->c3r4 * mR->c4r3) + (mL->c4r4 * mR->c4r4);
 }
 
+void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR) 
+{
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+	// Each result column is the sum of the columns of mL, weighted by the elements of the
+	// corresponding column of mR. mL and mR are read before storing, so mOut may alias.
+	const GLfloat* l = mL->elements;
+	GLfloat rElems[kCC3Matrix4x4ElementCount];
+	memcpy(rElems, mR->elements, sizeof(rElems));
+
+	CC3Float4 l1 = f4Load(l);
+	CC3Float4 l2 = f4Load(l + 4);
+	CC3Float4 l3 = f4Load(l + 8);
+	CC3Float4 l4 = f4Load(l + 12);
+
+	for (int col = 0; col < 4; col++)
+	{
+		const GLfloat* rc = rElems + (col * 4);
+		CC3Float4 sum = f4Mul(l1, f4Splat(rc[0]));
+		sum = f4MulAdd(sum, l2, f4Splat(rc[1]));
+		sum = f4MulAdd(sum, l3, f4Splat(rc[2]));
+		sum = f4MulAdd(sum, l4, f4Splat(rc[3]));
+		f4Store(mOut->elements + (col * 4), sum);
+	}
+#else
+	CC3Matrix4x4MultiplyScalar(mOut, mL, mR);
+#endif
+}
+
 
 CC3Vector4 CC3Matrix4x4TransformCC3Vector4(const CC3Matrix4x4* mtx, CC3Vector4 v) 
 {
@@ -408,7 +436,7 @@ bool CC3Matrix4x4InvertAdjoint(CC3Matrix4x4* m)
 	return true;
 }
 
-void CC3Matrix4x4InvertRigid(CC3Matrix4x4* mtx) 
+void CC3Matrix4x4InvertRigidScalar(CC3Matrix4x4* mtx) 
 {
 	// Extract and transpose the 3x3 linear matrix 
 	CC3Matrix3x3 linMtx;
@@ -426,4 +454,31 @@ void CC3Matrix4x4InvertRigid(CC3Matrix4x4* mtx)
 	mtx->c4r3 = t.z;
 }
 
+void CC3Matrix4x4InvertRigid(CC3Matrix4x4* mtx) 
+{
+#if CC3_SIMD_SSE || CC3_SIMD_NEON
+	// Transpose the linear 3x3 portion, then transform the negated translation by it.
+	GLfloat* e = mtx->elements;
+	CC3Float4 c1 = f4Load(e);
+	CC3Float4 c2 = f4Load(e + 4);
+	CC3Float4 c3 = f4Load(e + 8);
+	CC3Float4 c4 = f4Zero();
+	GLfloat tx = e[12], ty = e[13], tz = e[14];
+	f4Transpose(c1, c2, c3, c4);		// c1-c3 now hold the transposed rows, with zero in W
+
+	CC3Float4 tInv = f4Mul(c1, f4Splat(tx));
+	tInv = f4MulAdd(tInv, c2, f4Splat(ty));
+	tInv = f4MulAdd(tInv, c3, f4Splat(tz));
+	tInv = f4Negate(tInv);
+
+	f4Store(e, c1);
+	f4Store(e + 4, c2);
+	f4Store(e + 8, c3);
+	f4Store(e + 12, tInv);
+	mtx->c4r4 = 1.0f;
+#else
+	CC3Matrix4x4InvertRigidScalar(mtx);
+#endif
+}
+
 NS_COCOS3D_END
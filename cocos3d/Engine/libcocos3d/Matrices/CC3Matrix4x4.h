@@ -315,7 +315,7 @@ void CC3Matrix4x4PopulateInfiniteOrthoFrustum(CC3Matrix4x4* mtx,
 static inline CC3Vector CC3VectorFromCC3Matrix4x4Col(const CC3Matrix4x4* mtx, unsigned int colIdx) 
 {
 	CC3Vector4* baseAddr = (CC3Vector4*)&mtx->c1r1;
-	CC3Vector4* finalAddr = baseAddr + (--colIdx) * sizeof( CC3Vector4 ); // Convert to zero-based.
+	CC3Vector4* finalAddr = baseAddr + (--colIdx); // Convert to zero-based.
 	return finalAddr->cc3Vector();
 }
 
@@ -341,7 +341,7 @@ static inline CC3Vector CC3VectorFromCC3Matrix4x4Row(const CC3Matrix4x4* mtx, un
 static inline CC3Vector4 CC3Vector4FromCC3Matrix4x4Col(const CC3Matrix4x4* mtx, unsigned int colIdx) 
 {
 	CC3Vector4* baseAddr = (CC3Vector4*)&mtx->c1r1;
-	CC3Vector4* finalAddr = baseAddr + (--colIdx) * sizeof( CC3Vector4 ); // Convert to zero-based.
+	CC3Vector4* finalAddr = baseAddr + (--colIdx); // Convert to zero-based.
 	return *finalAddr;
 }
 
@@ -435,9 +435,22 @@ static inline CC3Vector CC3Matrix4x4ExtractTranslation(const CC3Matrix4x4* mtx)
 }
 
 
-/** Multiplies mL on the left by mR on the right, and stores the result in mOut. */
+/**
+ * Multiplies mL on the left by mR on the right, and stores the result in mOut.
+ *
+ * Depending on the CC3_SIMD_SSE and CC3_SIMD_NEON build settings, this function uses SSE2 or NEON
+ * vector instructions. Because all content is read before the result is written, mOut may be the
+ * same matrix as mL or mR when vector instructions are in use.
+ */
 void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR);
 
+/**
+ * Scalar implementation of CC3Matrix4x4Multiply, which is used when vector instructions are not
+ * available. It remains available when they are, to verify the results of the vector implementation.
+ * The mOut matrix must not be the same matrix as either mL or mR.
+ */
+void CC3Matrix4x4MultiplyScalar(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR);
+
 /**
  * Rotates the specified matrix by the specified Euler angles in degrees. Rotation is performed
  * in YXZ order, which is the OpenGL default.
@@ -602,6 +615,12 @@ bool CC3Matrix4x4InvertAdjoint(CC3Matrix4x4* m);
  */
 void CC3Matrix4x4InvertRigid(CC3Matrix4x4* mtx);
 
+/**
+ * Scalar implementation of CC3Matrix4x4InvertRigid, which is used when vector instructions are
+ * not available. It remains available when they are, to verify the results of the vector implementation.
+ */
+void CC3Matrix4x4InvertRigidScalar(CC3Matrix4x4* mtx);
+
 NS_COCOS3D_END
 
 #endif
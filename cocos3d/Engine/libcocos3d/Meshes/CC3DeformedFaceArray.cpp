@@ -185,50 +185,10 @@ void CC3DeformedFaceArray::populateDeformedVertexLocations()
 	if ( !m_deformedVertexLocations )
 		allocateDeformedVertexLocations();
 	
-	// Mark all the location vectors in the cached array as unset, so we can keep
-	// track of which vertices have been set, as we iterate through the mesh vertices.
-	GLuint vtxCount = getVertexCount();
-	for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++)
-		m_deformedVertexLocations[vtxIdx] = CC3Vector::kCC3VectorNull;
-
-	// Determine whether the mesh is indexed.
-	// If it is, we iterate through the indexes.
-	// If it isn't, we iterate through the vertices.
-	GLuint vtxIdxCount = m_pMesh->getVertexIndexCount();
-	bool meshIsIndexed = (vtxIdxCount > 0);
-	if (!meshIsIndexed) 
-		vtxIdxCount = vtxCount;
-
-	// The skin sections are assigned to contiguous ranges of vertex indices.
-	// We can avoid looking up the skin section for each vertex by assuming that they
-	// will appear in groups, check the current skin section for each vertex index,
-	// and only change when needed.
-	
-	// Get the skin section of the first vertex
-	CC3SkinSection* ss = m_pNode->getSkinSectionForVertexIndexAt(0);
-	for (GLuint vtxIdxPos = 0; vtxIdxPos < vtxIdxCount; vtxIdxPos++) 
-	{
-		// Make sure the current skin section deforms this vertex, otherwise get the correct one
-		if ( !ss->containsVertexIndex(vtxIdxPos) )
-		{
-			ss = m_pNode->getSkinSectionForVertexIndexAt( vtxIdxPos );
-			//LogTrace(@"Selecting %@ for vertex at %i", ss, vtxIdxPos);
-		}
-		
-		// Get the actual vertex index. If the mesh is indexed, we look it up, from the vertex
-		// index position. If the mesh is not indexed, then it IS the vertex index position.
-		GLuint vtxIdx = meshIsIndexed ? m_pMesh->getVertexIndexAt(vtxIdxPos) : vtxIdxPos;
-		
-		// If the cached vertex location has not yet been set, use the skin section to
-		// deform the vertex location at the current index, and set it into the cache array.
-		if ( m_deformedVertexLocations[vtxIdx].isNull() )
-		{
-			m_deformedVertexLocations[vtxIdx] = ss->getDeformedVertexLocationAt( vtxIdx );
-			
-// 			LogTrace(@"Setting deformed vertex %i to %@", vtxIdx,
-// 						  NSStringFromCC3Vector(_deformedVertexLocations[vtxIdx]));
-		}
-	}
+	// Deform all of the mesh vertices in a single batched pass. Each vertex is deformed by the
+	// first skin section that references it, and vertices that are not referenced by any skin
+	// section are left in their rest pose.
+	m_pNode->getSoftwareSkinner()->deformVertices( m_deformedVertexLocations, NULL );
 	m_deformedVertexLocationsAreDirty = false;
 }
 
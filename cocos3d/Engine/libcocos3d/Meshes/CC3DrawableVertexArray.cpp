@@ -126,7 +126,7 @@ void CC3DrawableVertexArray::drawFrom( GLuint vertexIndex, GLuint vtxCount, CC3N
 	//CCLOG("CC3DrawableVertexArray drawing %u vertices", vtxCount);
 	CC3PerformanceStatistics* pStatistics = visitor->getPerformanceStatistics();
 	if ( pStatistics )
-		pStatistics->addSingleCallFacesPresented( getFaceCountFromVertexIndexCount( vtxCount ) );
+		pStatistics->addSingleCallFacesPresented( getFaceCountFromVertexIndexCount( vtxCount ) * visitor->getInstanceCount() );
 }
 
 void CC3DrawableVertexArray::allocateStripLengths( GLuint sCount )
@@ -98,6 +98,7 @@ CC3Mesh::CC3Mesh()
 	m_vertexPointSizes = NULL;
 	m_vertexIndices = NULL;
 	m_faces = NULL;
+	m_faceHierarchy = NULL;
 }
 
 CC3Mesh::~CC3Mesh()
@@ -114,6 +115,7 @@ CC3Mesh::~CC3Mesh()
 	CC_SAFE_RELEASE( m_vertexPointSizes );
 	CC_SAFE_RELEASE( m_vertexIndices );
 	CC_SAFE_RELEASE( m_faces );
+	CC_SAFE_RELEASE( m_faceHierarchy );
 }
 
 void CC3Mesh::setName( const std::string& name )
@@ -170,6 +172,9 @@ void CC3Mesh::setVertexLocations( CC3VertexLocations* vtxLocs )
 
 	if ( m_vertexLocations )
 		m_vertexLocations->deriveNameFrom( this );
+
+	if ( m_faceHierarchy )
+		m_faceHierarchy->markDirty();
 }
 
 bool CC3Mesh::hasVertexLocations()
@@ -367,6 +372,9 @@ void CC3Mesh::setVertexIndices( CC3VertexIndices* vtxInd )
 
 	if ( m_vertexIndices )
 		m_vertexIndices->deriveNameFrom( this );
+
+	if ( m_faceHierarchy )
+		m_faceHierarchy->markDirty();
 }
 
 bool CC3Mesh::hasVertexIndices()
@@ -1042,6 +1050,9 @@ CC3Vector CC3Mesh::getVertexLocationAt( GLuint index )
 void CC3Mesh::setVertexLocation( const CC3Vector& aLocation, GLuint index )
 {
 	m_vertexLocations->setLocation( aLocation, index );
+
+	if ( m_faceHierarchy )
+		m_faceHierarchy->markDirty();
 }
 
 CC3Vector4 CC3Mesh::getVertexHomogeneousLocationAt( GLuint index )
@@ -1329,6 +1340,9 @@ CC3FaceNeighbours CC3Mesh::getFaceNeighboursAt( GLuint faceIndex )
 GLuint CC3Mesh::findFirst( GLuint maxHitCount, CC3MeshIntersection* intersections, 
 	const CC3Ray& aRay, bool acceptBackFaces, bool acceptBehind )
 {	
+	if ( m_faceHierarchy )
+		return m_faceHierarchy->findFirst( maxHitCount, intersections, aRay, acceptBackFaces, acceptBehind );
+
 	GLuint hitIdx = 0;
 	GLuint faceCount = getFaceCount();
 	for (GLuint faceIdx = 0; faceIdx < faceCount && hitIdx < maxHitCount; faceIdx++) 
@@ -1359,6 +1373,193 @@ GLuint CC3Mesh::findFirst( GLuint maxHitCount, CC3MeshIntersection* intersection
 	return hitIdx;
 }
 
+bool CC3Mesh::shouldUseFaceHierarchy()
+{
+	return m_faceHierarchy != NULL;
+}
+
+void CC3Mesh::setShouldUseFaceHierarchy( bool shouldUse )
+{
+	if ( shouldUse == shouldUseFaceHierarchy() )
+		return;
+
+	CC_SAFE_RELEASE( m_faceHierarchy );
+
+	if ( shouldUse )
+	{
+		m_faceHierarchy = CC3MeshFaceHierarchy::hierarchyWithMesh( this );
+		m_faceHierarchy->retain();
+	}
+}
+
+CC3MeshFaceHierarchy* CC3Mesh::getFaceHierarchy()
+{
+	return m_faceHierarchy;
+}
+
+void CC3Mesh::markFacesDirty()
+{
+	if ( m_faces )
+	{
+		m_faces->markIndicesDirty();
+		m_faces->markCentersDirty();
+		m_faces->markNormalsDirty();
+		m_faces->markPlanesDirty();
+		m_faces->markNeighboursDirty();
+	}
+
+	if ( m_faceHierarchy )
+		m_faceHierarchy->markDirty();
+}
+
+bool CC3Mesh::shouldQuantizeVertexContent()
+{
+	return m_shouldQuantizeVertexContent;
+}
+
+void CC3Mesh::setShouldQuantizeVertexContent( bool shouldQuantize )
+{
+	m_shouldQuantizeVertexContent = shouldQuantize;
+}
+
+/** Collects the vertex arrays of the mesh, other than the vertex indices, in interleaving order. */
+static void getQuantizableVertexArrays( CC3Mesh* mesh, std::vector<CC3VertexArray*>& vtxArrays )
+{
+	CC3VertexArray* arrays[] = { mesh->getVertexLocations(), mesh->getVertexNormals(), mesh->getVertexTangents(),
+								 mesh->getVertexBitangents(), mesh->getVertexColors() };
+	for ( GLuint i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++ )
+	{
+		if ( arrays[i] )
+			vtxArrays.push_back( arrays[i] );
+	}
+
+	GLuint tcCount = mesh->getTextureCoordinatesArrayCount();
+	for ( GLuint i = 0; i < tcCount; i++ )
+		vtxArrays.push_back( mesh->getTextureCoordinatesForTextureUnit( i ) );
+
+	CC3VertexArray* skinArrays[] = { mesh->getVertexBoneWeights(), mesh->getVertexBoneIndices(), mesh->getVertexPointSizes() };
+	for ( GLuint i = 0; i < sizeof(skinArrays) / sizeof(skinArrays[0]); i++ )
+	{
+		if ( skinArrays[i] )
+			vtxArrays.push_back( skinArrays[i] );
+	}
+}
+
+/**
+ * Each vertex array is packed into a temporary copy of the new layout before any vertex memory
+ * is released, because interleaved vertex arrays all reference the memory of the locations array.
+ * Each array then adopts its quantized format, and its memory is replaced with the packed copy.
+ */
+GLuint CC3Mesh::quantizeVertexContent()
+{
+	if ( !m_vertexLocations || isUsingGLBuffers() || m_vertexLocations->getBufferUsage() != GL_STATIC_DRAW )
+		return 0;
+
+	std::vector<CC3VertexArray*> vtxArrays;
+	getQuantizableVertexArrays( this, vtxArrays );
+
+	GLuint vtxCount = m_vertexLocations->getVertexCount();
+	bool canQuantize = false;
+	for ( size_t i = 0; i < vtxArrays.size(); i++ )
+	{
+		if ( !vtxArrays[i]->getVertices() || vtxArrays[i]->getVertexCount() < vtxCount )
+			return 0;
+
+		// Interleaved arrays must all reference the content of the locations array
+		if ( m_shouldInterleaveVertices && vtxArrays[i]->getVertices() != m_vertexLocations->getVertices() )
+			return 0;
+		canQuantize |= vtxArrays[i]->canQuantizeContent();
+	}
+	if ( !canQuantize || vtxCount == 0 )
+		return 0;
+
+	GLuint oldByteCount = 0;
+	GLuint newByteCount = 0;
+
+	if ( m_shouldInterleaveVertices )
+	{
+		std::vector<GLuint> elemOffsets( vtxArrays.size() );
+		GLuint newStride = 0;
+		for ( size_t i = 0; i < vtxArrays.size(); i++ )
+		{
+			elemOffsets[i] = newStride;
+			newStride += (vtxArrays[i]->getQuantizedElementLength() + 3) & ~3;
+		}
+
+		GLubyte* packedVertices = (GLubyte*)calloc( vtxCount, newStride );
+		if ( !packedVertices )
+			return 0;
+
+		oldByteCount = m_vertexLocations->getVertexStride() * vtxCount;
+		newByteCount = newStride * vtxCount;
+
+		for ( size_t i = 0; i < vtxArrays.size(); i++ )
+			vtxArrays[i]->packContentInto( packedVertices + elemOffsets[i], newStride );
+
+		for ( size_t i = 0; i < vtxArrays.size(); i++ )
+		{
+			CC3VertexArray* vtxArray = vtxArrays[i];
+			vtxArray->adoptQuantizedFormat();
+			vtxArray->setAllocatedVertexCapacity( 0 );		// Releases the original content
+			vtxArray->setElementOffset( elemOffsets[i] );
+			vtxArray->setVertexStride( newStride );
+		}
+
+		m_vertexLocations->setAllocatedVertexCapacity( vtxCount );
+		memcpy( m_vertexLocations->getVertices(), packedVertices, newByteCount );
+		free( packedVertices );
+
+		for ( size_t i = 1; i < vtxArrays.size(); i++ )
+			vtxArrays[i]->interleaveWith( m_vertexLocations );
+	}
+	else
+	{
+		for ( size_t i = 0; i < vtxArrays.size(); i++ )
+		{
+			CC3VertexArray* vtxArray = vtxArrays[i];
+			if ( !vtxArray->canQuantizeContent() )
+				continue;
+
+			GLuint newStride = (vtxArray->getQuantizedElementLength() + 3) & ~3;
+			GLubyte* packedVertices = (GLubyte*)calloc( vtxCount, newStride );
+			if ( !packedVertices )
+				continue;
+
+			oldByteCount += vtxArray->getVertexStride() * vtxCount;
+			newByteCount += newStride * vtxCount;
+
+			vtxArray->packContentInto( packedVertices, newStride );
+			vtxArray->adoptQuantizedFormat();
+			vtxArray->setAllocatedVertexCapacity( 0 );		// Releases the original content
+			vtxArray->setElementOffset( 0 );
+			vtxArray->setVertexStride( newStride );
+			vtxArray->setAllocatedVertexCapacity( vtxCount );
+			memcpy( vtxArray->getVertices(), packedVertices, newStride * vtxCount );
+			free( packedVertices );
+		}
+	}
+
+	m_vertexLocations->markBoundaryDirty();
+
+	CC3_TRACE( "CC3Mesh %s quantized vertex content from %u to %u bytes (%.1f to %.1f bytes per vertex)",
+		getName().c_str(), oldByteCount, newByteCount,
+		(GLfloat)oldByteCount / (GLfloat)vtxCount, (GLfloat)newByteCount / (GLfloat)vtxCount );
+
+	return oldByteCount - newByteCount;
+}
+
+bool CC3Mesh::isVertexContentQuantized()
+{
+	std::vector<CC3VertexArray*> vtxArrays;
+	getQuantizableVertexArrays( this, vtxArrays );
+	for ( size_t i = 0; i < vtxArrays.size(); i++ )
+	{
+		if ( vtxArrays[i]->isQuantized() )
+			return true;
+	}
+	return false;
+}
+
 /**
  * If the interleavesVertices property is set to NO, creates GL vertex buffer objects for all
  * vertex arrays used by this mesh by invoking createGLBuffer on each contained vertex array.
@@ -1370,6 +1571,9 @@ GLuint CC3Mesh::findFirst( GLuint maxHitCount, CC3MeshIntersection* intersection
  */
 void CC3Mesh::createGLBuffers()
 {
+	if ( m_shouldQuantizeVertexContent )
+		quantizeVertexContent();
+
 	if ( m_vertexLocations )
 		m_vertexLocations->createGLBuffer();
 	
@@ -2030,7 +2234,8 @@ void CC3Mesh::drawFrom( GLuint vertexIndex, GLuint vertexCount, CC3NodeDrawingVi
 
 void CC3Mesh::bindWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
-	visitor->getGL()->bindMesh( this, visitor );
+	if ( !visitor->isCurrentMeshBound() )
+		visitor->getGL()->bindMesh( this, visitor );
 }
 
 /**
@@ -2090,7 +2295,9 @@ void CC3Mesh::initWithTag( GLuint aTag, const std::string& aName )
 	m_overlayTextureCoordinates = NULL;
 	m_vertexIndices = NULL;
 	m_faces = NULL;
+	m_faceHierarchy = NULL;
 	m_shouldInterleaveVertices = true;
+	m_shouldQuantizeVertexContent = false;
 	m_capacityExpansionFactor = 1.25f;
 }
 
@@ -2104,6 +2311,7 @@ void CC3Mesh::populateFrom( CC3Mesh* another )
 	super::populateFrom( another );
 	
 	m_shouldInterleaveVertices = another->shouldInterleaveVertices();
+	m_shouldQuantizeVertexContent = another->shouldQuantizeVertexContent();
 	m_capacityExpansionFactor = another->getCapacityExpansionFactor();
 	
 	// Share vertex arrays between copies
@@ -2131,6 +2339,7 @@ void CC3Mesh::populateFrom( CC3Mesh* another )
 	setVertexIndices( (CC3VertexIndices*)another->getVertexIndices()->copy()->autorelease() );
 	
 	setFaces( (CC3FaceArray*)another->getFaces()->copy()->autorelease() );
+	setShouldUseFaceHierarchy( another->shouldUseFaceHierarchy() );
 }
 
 CCObject* CC3Mesh::copyWithZone( CCZone* zone )
@@ -116,6 +116,7 @@ class CC3VertexBoneIndices;
 class CC3VertexPointSizes;
 class CC3VertexIndices;
 class CC3FaceArray;
+class CC3MeshFaceHierarchy;
 
 class CC3Mesh : public CC3Identifiable
 {
@@ -1437,6 +1438,70 @@ public:
 	GLuint						findFirst( GLuint maxHitCount, CC3MeshIntersection* intersections, 
 		const CC3Ray& aRay, bool acceptBackFaces, bool acceptBehind );
 
+	/**
+	 * Indicates whether the faces of this mesh should be held in a CC3MeshFaceHierarchy, so that
+	 * the findFirst:... method tests only the faces that lie in the path of the ray, instead of
+	 * every face in the mesh.
+	 *
+	 * The hierarchy is built lazily on the first ray test, and holds a copy of each face, which
+	 * increases the amount of memory required by the mesh. Setting this property to YES is useful
+	 * for large meshes that are frequently tested against rays, such as terrain or level geometry.
+	 *
+	 * The hierarchy is rebuilt automatically when the vertexLocations or vertexIndices properties
+	 * are changed. If the content of the vertex locations is changed in place, the application
+	 * must invoke the markDirty method on the faceHierarchy.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUseFaceHierarchy();
+	void						setShouldUseFaceHierarchy( bool shouldUse );
+
+	/** The hierarchy holding the faces of this mesh, or NULL if the shouldUseFaceHierarchy property is NO. */
+	CC3MeshFaceHierarchy*		getFaceHierarchy();
+
+	/**
+	 * Marks the cached face content of this mesh, and the face hierarchy, as dirty, so that they
+	 * are rebuilt from the vertex content when next needed. Invoke this method after changing the
+	 * content of the vertex indices, or reordering the vertices, in place.
+	 */
+	void						markFacesDirty();
+
+	/**
+	 * Indicates whether the vertex content of this mesh should be quantized automatically, by
+	 * invoking the quantizeVertexContent method, when the createGLBuffers method is invoked.
+	 *
+	 * When the GL buffers are created by a CC3MeshNode, this property is set to NO if the shader
+	 * program of that node cannot decode quantized vertex content, as determined by the
+	 * canDrawQuantizedVertexContent method of the node.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldQuantizeVertexContent();
+	void						setShouldQuantizeVertexContent( bool shouldQuantize );
+
+	/**
+	 * Packs the floating point vertex content of this mesh into the compact formats indicated by
+	 * the preferredQuantization property of each vertex array, reducing the memory and GL bus
+	 * bandwidth consumed by the vertex content. By default, locations and texture coordinates are
+	 * packed into normalized 16-bit unsigned integers spanning their bounds, and normals and
+	 * tangents are packed into normalized 8-bit signed integers.
+	 *
+	 * Quantized vertex content must be decoded by the vertex shader, using the dequantization
+	 * scale and offset semantics for vertex locations and texture coordinates. The vertex position
+	 * and texture shader libraries supplied with Cocos3D perform this decoding. Vertex content
+	 * remains accessible through the vertex array accessor methods, which decode it as needed.
+	 *
+	 * Quantization is intended for static meshes. It is not performed if the vertex content has
+	 * already been buffered to the GL engine, has been released from application memory, or is
+	 * not marked for GL_STATIC_DRAW usage.
+	 *
+	 * Returns the number of bytes of vertex content saved, or zero if no content was quantized.
+	 */
+	GLuint						quantizeVertexContent();
+
+	/** Returns whether the content of any of the vertex arrays in this mesh has been quantized. */
+	bool						isVertexContentQuantized();
+
 	/**
 	 * Convenience method to create GL buffers for all vertex arrays used by this mesh.
 	 *
@@ -2762,8 +2827,10 @@ protected:
 	CC3VertexPointSizes*		m_vertexPointSizes;
 	CC3VertexIndices*			m_vertexIndices;
 	CC3FaceArray*				m_faces;
+	CC3MeshFaceHierarchy*		m_faceHierarchy;
 	GLfloat						m_capacityExpansionFactor;
 	bool						m_shouldInterleaveVertices : 1;
+	bool						m_shouldQuantizeVertexContent : 1;
 };
 
 	/**
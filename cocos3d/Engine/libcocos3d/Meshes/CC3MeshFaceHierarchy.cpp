@@ -0,0 +1,372 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+/** Orders face indices by the centers of their faces along a single axis. */
+struct CC3MeshFaceHierarchyFaceOrder
+{
+	const std::vector<CC3Vector>* centers;
+	int axis;
+	CC3MeshFaceHierarchyFaceOrder( const std::vector<CC3Vector>* faceCenters, int anAxis ) : centers(faceCenters), axis(anAxis) {}
+
+	bool operator()( GLuint f1, GLuint f2 ) const
+	{
+		const CC3Vector& c1 = (*centers)[f1];
+		const CC3Vector& c2 = (*centers)[f2];
+		switch ( axis )
+		{
+			case 0: return c1.x < c2.x;
+			case 1: return c1.y < c2.y;
+			default: return c1.z < c2.z;
+		}
+	}
+};
+
+/**
+ * Returns whether the ray passes through the box, and returns the distance at which the ray
+ * enters the box. Unless the ray may be extended behind its start location, the box must lie
+ * at least partly in front of the start location.
+ */
+static inline bool doesRayPierceBox( const CC3Ray& aRay, const CC3Vector& invDirection, const CC3Box& box,
+									 bool acceptBehind, GLfloat& entryDist )
+{
+	GLfloat nearDist, farDist;
+	if ( !CC3DoesRayLineIntersectBox( aRay, invDirection, box, nearDist, farDist ) )
+		return false;
+
+	if ( acceptBehind )
+	{
+		entryDist = nearDist;
+		return true;
+	}
+
+	if ( farDist < 0.0f )
+		return false;
+
+	entryDist = MAX(nearDist, 0.0f);
+	return true;
+}
+
+static inline CC3Vector invertedRayDirection( const CC3Ray& aRay )
+{
+	CC3Vector rd = aRay.direction;
+	return cc3v(rd.x ? 1.0f / rd.x : 0.0f, rd.y ? 1.0f / rd.y : 0.0f, rd.z ? 1.0f / rd.z : 0.0f);
+}
+
+CC3MeshFaceHierarchy::CC3MeshFaceHierarchy()
+{
+	m_pMesh = NULL;
+	m_maxFacesPerBucket = 4;
+	m_isDirty = true;
+}
+
+CC3MeshFaceHierarchy::~CC3MeshFaceHierarchy()
+{
+	m_pMesh = NULL;			// weak reference
+}
+
+void CC3MeshFaceHierarchy::initWithMesh( CC3Mesh* mesh )
+{
+	m_pMesh = mesh;			// not retained
+	m_isDirty = true;
+}
+
+CC3MeshFaceHierarchy* CC3MeshFaceHierarchy::hierarchyWithMesh( CC3Mesh* mesh )
+{
+	CC3MeshFaceHierarchy* pHierarchy = new CC3MeshFaceHierarchy;
+	pHierarchy->initWithMesh( mesh );
+	pHierarchy->autorelease();
+
+	return pHierarchy;
+}
+
+CC3Mesh* CC3MeshFaceHierarchy::getMesh()
+{
+	return m_pMesh;
+}
+
+GLuint CC3MeshFaceHierarchy::getMaxFacesPerBucket()
+{
+	return m_maxFacesPerBucket;
+}
+
+void CC3MeshFaceHierarchy::setMaxFacesPerBucket( GLuint maxFaces )
+{
+	m_maxFacesPerBucket = MAX(maxFaces, 1);
+	markDirty();
+}
+
+void CC3MeshFaceHierarchy::markDirty()
+{
+	m_isDirty = true;
+}
+
+bool CC3MeshFaceHierarchy::isDirty()
+{
+	return m_isDirty;
+}
+
+GLuint CC3MeshFaceHierarchy::getFaceCount()
+{
+	updateIfNeeded();
+	return (GLuint)m_faces.size();
+}
+
+GLuint CC3MeshFaceHierarchy::getTreeNodeCount()
+{
+	updateIfNeeded();
+	return (GLuint)m_treeNodes.size();
+}
+
+void CC3MeshFaceHierarchy::updateIfNeeded()
+{
+	if ( m_isDirty )
+		rebuild();
+}
+
+void CC3MeshFaceHierarchy::rebuild()
+{
+	m_treeNodes.clear();
+	m_faceIndices.clear();
+	m_faces.clear();
+	m_isDirty = false;
+
+	GLuint faceCount = (m_pMesh && m_pMesh->getVertexLocations()) ? m_pMesh->getFaceCount() : 0;
+	if ( faceCount == 0 )
+		return;
+
+	std::vector<CC3Vector> centers( faceCount );
+	m_faces.resize( faceCount );
+	m_faceIndices.resize( faceCount );
+	for (GLuint faceIdx = 0; faceIdx < faceCount; faceIdx++)
+	{
+		m_faces[faceIdx] = m_pMesh->getFaceAt( faceIdx );
+		centers[faceIdx] = m_faces[faceIdx].getCenter();
+		m_faceIndices[faceIdx] = faceIdx;
+	}
+
+	m_treeNodes.reserve( 2 * (faceCount / m_maxFacesPerBucket + 1) );
+	buildTreeNode( 0, faceCount, centers );
+
+	// Reorder the faces to match the face indices, so each bucket holds contiguous faces
+	std::vector<CC3Face> orderedFaces( faceCount );
+	for (GLuint facePos = 0; facePos < faceCount; facePos++)
+		orderedFaces[facePos] = m_faces[m_faceIndices[facePos]];
+	m_faces.swap( orderedFaces );
+
+	CC3_TRACE( "CC3MeshFaceHierarchy built with %d faces in %d tree nodes", faceCount, (int)m_treeNodes.size() );
+}
+
+/**
+ * Builds the tree node enclosing the specified range of ordered faces, and returns its index.
+ * Ranges larger than a bucket are split at the median of the face centers, along the longest
+ * axis of the box enclosing those centers.
+ */
+GLint CC3MeshFaceHierarchy::buildTreeNode( GLuint faceStart, GLuint faceCount, std::vector<CC3Vector>& centers )
+{
+	GLint nodeIdx = (GLint)m_treeNodes.size();
+	CC3MeshFaceHierarchyNode treeNode;
+	treeNode.left = -1;
+	treeNode.right = -1;
+	treeNode.faceStart = faceStart;
+	treeNode.faceCount = faceCount;
+	treeNode.box = CC3Box::kCC3BoxNull;
+
+	CC3Box centerBox = CC3Box::kCC3BoxNull;
+	GLuint faceEnd = faceStart + faceCount;
+	for (GLuint facePos = faceStart; facePos < faceEnd; facePos++)
+	{
+		GLuint faceIdx = m_faceIndices[facePos];
+		const CC3Face& face = m_faces[faceIdx];
+		treeNode.box = treeNode.box.boxEngulfLocation( face.vertices[0] );
+		treeNode.box = treeNode.box.boxEngulfLocation( face.vertices[1] );
+		treeNode.box = treeNode.box.boxEngulfLocation( face.vertices[2] );
+		centerBox = centerBox.boxEngulfLocation( centers[faceIdx] );
+	}
+	m_treeNodes.push_back( treeNode );
+
+	if ( faceCount <= m_maxFacesPerBucket )
+		return nodeIdx;
+
+	CC3Vector extent = centerBox.getSize();
+	int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+	GLuint halfCount = faceCount / 2;
+	std::nth_element( m_faceIndices.begin() + faceStart, m_faceIndices.begin() + faceStart + halfCount,
+					  m_faceIndices.begin() + faceEnd, CC3MeshFaceHierarchyFaceOrder( &centers, axis ) );
+
+	GLint left = buildTreeNode( faceStart, halfCount, centers );
+	GLint right = buildTreeNode( faceStart + halfCount, faceCount - halfCount, centers );
+	m_treeNodes[nodeIdx].left = left;
+	m_treeNodes[nodeIdx].right = right;
+	return nodeIdx;
+}
+
+/**
+ * Tests the ray against the face at the specified position within the ordered faces, in the
+ * same manner as the findFirst:... method of CC3Mesh, populating the specified intersection,
+ * and returns whether the face was intersected.
+ */
+bool CC3MeshFaceHierarchy::intersectFaceAt( GLuint facePos, const CC3Ray& aRay, bool acceptBackFaces,
+											bool acceptBehind, CC3MeshIntersection* hit )
+{
+	hit->faceIndex = m_faceIndices[facePos];
+	hit->face = m_faces[facePos];
+	hit->facePlane = CC3Plane::planeFromFace( hit->face );
+
+	// Check if the ray is not parallel to the face, is approaching from the front,
+	// or is approaching from the back and that is okay.
+	GLfloat dirDotNorm = aRay.direction.dot( hit->facePlane.getNormal() );
+	hit->wasBackFace = dirDotNorm > 0.0f;
+	if ( !(dirDotNorm < 0.0f || (hit->wasBackFace && acceptBackFaces)) )
+		return false;
+
+	// Find the point of intersection of the ray with the plane
+	// and check that it is not behind the start of the ray.
+	CC3Vector4 loc4 = CC3RayIntersectionWithPlane( aRay, hit->facePlane );
+	if ( !(acceptBehind || loc4.w >= 0.0f) )
+		return false;
+
+	hit->location = loc4.cc3Vector();
+	hit->distance = loc4.w;
+	hit->barycentricLocation = CC3FaceBarycentricWeights( hit->face, hit->location );
+	return CC3BarycentricWeightsAreInsideTriangle( hit->barycentricLocation );
+}
+
+GLuint CC3MeshFaceHierarchy::findFirst( GLuint maxHitCount, CC3MeshIntersection* intersections,
+										const CC3Ray& aRay, bool acceptBackFaces, bool acceptBehind )
+{
+	updateIfNeeded();
+	if ( m_treeNodes.empty() )
+		return 0;
+
+	CC3Vector invDir = invertedRayDirection( aRay );
+	GLfloat entryDist;
+	GLuint hitIdx = 0;
+
+	m_queryStack.clear();
+	m_queryStack.push_back( 0 );
+	while ( !m_queryStack.empty() && hitIdx < maxHitCount )
+	{
+		GLint nodeIdx = m_queryStack.back();
+		m_queryStack.pop_back();
+
+		const CC3MeshFaceHierarchyNode& treeNode = m_treeNodes[nodeIdx];
+		if ( !doesRayPierceBox( aRay, invDir, treeNode.box, acceptBehind, entryDist ) )
+			continue;
+
+		if ( treeNode.left >= 0 )
+		{
+			m_queryStack.push_back( treeNode.right );
+			m_queryStack.push_back( treeNode.left );
+			continue;
+		}
+
+		GLuint faceEnd = treeNode.faceStart + treeNode.faceCount;
+		for (GLuint facePos = treeNode.faceStart; facePos < faceEnd && hitIdx < maxHitCount; facePos++)
+		{
+			if ( intersectFaceAt( facePos, aRay, acceptBackFaces, acceptBehind, &intersections[hitIdx] ) )
+				hitIdx++;
+		}
+	}
+	return hitIdx;
+}
+
+bool CC3MeshFaceHierarchy::findNearest( CC3MeshIntersection* intersection, const CC3Ray& aRay, bool acceptBackFaces )
+{
+	updateIfNeeded();
+	if ( m_treeNodes.empty() )
+		return false;
+
+	CC3Vector invDir = invertedRayDirection( aRay );
+	GLfloat entryDist;
+	if ( !doesRayPierceBox( aRay, invDir, m_treeNodes[0].box, false, entryDist ) )
+		return false;
+
+	bool wasFound = false;
+	GLfloat nearestDist = kCC3MaxGLfloat;
+	CC3MeshIntersection hit;
+
+	// Parallel stacks of tree node indices and the distances at which the ray enters their boxes
+	m_queryStack.clear();
+	m_queryDistances.clear();
+	m_queryStack.push_back( 0 );
+	m_queryDistances.push_back( entryDist );
+	while ( !m_queryStack.empty() )
+	{
+		GLint nodeIdx = m_queryStack.back();
+		GLfloat nodeDist = m_queryDistances.back();
+		m_queryStack.pop_back();
+		m_queryDistances.pop_back();
+
+		if ( nodeDist > nearestDist )
+			continue;
+
+		const CC3MeshFaceHierarchyNode& treeNode = m_treeNodes[nodeIdx];
+		if ( treeNode.left >= 0 )
+		{
+			// Push the farther child first, so that the nearer child is visited first
+			GLfloat leftDist, rightDist;
+			bool isLeftHit = doesRayPierceBox( aRay, invDir, m_treeNodes[treeNode.left].box, false, leftDist );
+			bool isRightHit = doesRayPierceBox( aRay, invDir, m_treeNodes[treeNode.right].box, false, rightDist );
+			if ( isLeftHit && isRightHit && leftDist > rightDist )
+			{
+				m_queryStack.push_back( treeNode.left );
+				m_queryDistances.push_back( leftDist );
+				m_queryStack.push_back( treeNode.right );
+				m_queryDistances.push_back( rightDist );
+				continue;
+			}
+			if ( isRightHit )
+			{
+				m_queryStack.push_back( treeNode.right );
+				m_queryDistances.push_back( rightDist );
+			}
+			if ( isLeftHit )
+			{
+				m_queryStack.push_back( treeNode.left );
+				m_queryDistances.push_back( leftDist );
+			}
+			continue;
+		}
+
+		GLuint faceEnd = treeNode.faceStart + treeNode.faceCount;
+		for (GLuint facePos = treeNode.faceStart; facePos < faceEnd; facePos++)
+		{
+			if ( intersectFaceAt( facePos, aRay, acceptBackFaces, false, &hit ) && hit.distance < nearestDist )
+			{
+				*intersection = hit;
+				nearestDist = hit.distance;
+				wasFound = true;
+			}
+		}
+	}
+	return wasFound;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,139 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_MESH_FACE_HIERARCHY_H_
+#define _CC3_MESH_FACE_HIERARCHY_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3Mesh;
+
+/** A node in the tree of a CC3MeshFaceHierarchy. */
+typedef struct
+{
+	CC3Box				box;			/**< The local box enclosing all faces below this tree node. */
+	GLint				left;			/**< The index of the first child tree node, or -1 if this is a bucket of faces. */
+	GLint				right;			/**< The index of the second child tree node, or -1 if this is a bucket of faces. */
+	GLuint				faceStart;		/**< The position of the first face below this tree node, within the ordered faces. */
+	GLuint				faceCount;		/**< The number of faces below this tree node. */
+} CC3MeshFaceHierarchyNode;
+
+/**
+ * CC3MeshFaceHierarchy holds the faces of a mesh in a tree of axially-aligned boxes, in the
+ * local coordinate system of the mesh, so that the faces that are intersected by a ray can be
+ * found without testing every face in the mesh.
+ *
+ * The hierarchy is built lazily from the vertex locations of the mesh, the first time it is
+ * queried, and holds a copy of each face, ordered so that the faces below each tree node are
+ * contiguous. If the vertex locations of the mesh are changed in place, the application must
+ * invoke the markDirty method, so that the hierarchy is rebuilt on the next query.
+ *
+ * Normally, the hierarchy is created by a CC3Mesh when the shouldUseFaceHierarchy property
+ * of the mesh is set to YES, and is used automatically by the findFirst:... method of the mesh.
+ */
+class CC3MeshFaceHierarchy : public CCObject
+{
+public:
+	CC3MeshFaceHierarchy();
+	virtual ~CC3MeshFaceHierarchy();
+
+	/** The mesh whose faces are held in this hierarchy. The mesh is not retained. */
+	CC3Mesh*					getMesh();
+
+	/**
+	 * Specifies the maximum number of faces that are held in a single bucket at the bottom of
+	 * the tree. Smaller buckets produce a deeper tree, with tighter boxes, but more tree nodes.
+	 *
+	 * The initial value of this property is four.
+	 */
+	GLuint						getMaxFacesPerBucket();
+	void						setMaxFacesPerBucket( GLuint maxFaces );
+
+	/** Marks this hierarchy as dirty, so that it is rebuilt from the mesh before the next query. */
+	void						markDirty();
+
+	/** Returns whether this hierarchy will be rebuilt from the mesh before the next query. */
+	bool						isDirty();
+
+	/** Rebuilds this hierarchy from the mesh, if it is dirty. */
+	void						updateIfNeeded();
+
+	/** The number of faces held in this hierarchy. */
+	GLuint						getFaceCount();
+
+	/** The number of tree nodes in this hierarchy, including the buckets of faces. */
+	GLuint						getTreeNodeCount();
+
+	/**
+	 * Populates the specified array with information about the intersections of the specified ray
+	 * and the mesh, up to the specified maximum number of intersections, and returns the number of
+	 * intersections found.
+	 *
+	 * This method has the same behaviour as the findFirst:... method of CC3Mesh, except that only
+	 * the faces below tree nodes whose boxes are intersected by the ray are tested. As with that
+	 * method, the ray is specified in the local coordinate system of the mesh, and the intersections
+	 * array is not sorted. Use the findNearest:... method to find the closest intersection.
+	 */
+	GLuint						findFirst( GLuint maxHitCount, CC3MeshIntersection* intersections,
+										   const CC3Ray& aRay, bool acceptBackFaces, bool acceptBehind );
+
+	/**
+	 * Finds the intersection of the specified ray and the mesh that is closest to the startLocation
+	 * of the ray, in the direction of the ray, and populates the specified intersection with it.
+	 * Returns whether an intersection was found. If not, the contents of the specified intersection
+	 * are undefined.
+	 *
+	 * The tree is descended front to back, and tree nodes whose boxes lie beyond the closest
+	 * intersection found so far are skipped. The ray is specified in the local coordinate system
+	 * of the mesh. The acceptBackFaces parameter has the same meaning as in the findFirst:... method.
+	 */
+	bool						findNearest( CC3MeshIntersection* intersection, const CC3Ray& aRay, bool acceptBackFaces );
+
+	/** Initializes this instance to hold the faces of the specified mesh. */
+	void						initWithMesh( CC3Mesh* mesh );
+
+	/** Allocates and initializes an autoreleased instance to hold the faces of the specified mesh. */
+	static CC3MeshFaceHierarchy* hierarchyWithMesh( CC3Mesh* mesh );
+
+protected:
+	void						rebuild();
+	GLint						buildTreeNode( GLuint faceStart, GLuint faceCount, std::vector<CC3Vector>& centers );
+	bool						intersectFaceAt( GLuint facePos, const CC3Ray& aRay, bool acceptBackFaces,
+												 bool acceptBehind, CC3MeshIntersection* hit );
+
+protected:
+	CC3Mesh*								m_pMesh;
+	std::vector<CC3MeshFaceHierarchyNode>	m_treeNodes;
+	std::vector<GLuint>						m_faceIndices;
+	std::vector<CC3Face>					m_faces;
+	std::vector<GLint>						m_queryStack;
+	std::vector<GLfloat>					m_queryDistances;
+	GLuint									m_maxFacesPerBucket;
+	bool									m_isDirty : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -0,0 +1,727 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+/** The size of the LRU cache modelled when scoring vertices for vertex cache optimization. */
+#define kCC3ForsythCacheSize		32
+
+CC3MeshOptimizer::CC3MeshOptimizer()
+{
+
+}
+
+CC3MeshOptimizer::~CC3MeshOptimizer()
+{
+
+}
+
+bool CC3MeshOptimizer::shouldDeduplicateVertices()
+{
+	return m_shouldDeduplicateVertices;
+}
+
+void CC3MeshOptimizer::setShouldDeduplicateVertices( bool shouldDeduplicate )
+{
+	m_shouldDeduplicateVertices = shouldDeduplicate;
+}
+
+bool CC3MeshOptimizer::shouldOptimizeVertexCache()
+{
+	return m_shouldOptimizeVertexCache;
+}
+
+void CC3MeshOptimizer::setShouldOptimizeVertexCache( bool shouldOptimize )
+{
+	m_shouldOptimizeVertexCache = shouldOptimize;
+}
+
+bool CC3MeshOptimizer::shouldOptimizeOverdraw()
+{
+	return m_shouldOptimizeOverdraw;
+}
+
+void CC3MeshOptimizer::setShouldOptimizeOverdraw( bool shouldOptimize )
+{
+	m_shouldOptimizeOverdraw = shouldOptimize;
+}
+
+bool CC3MeshOptimizer::shouldOptimizeVertexFetch()
+{
+	return m_shouldOptimizeVertexFetch;
+}
+
+void CC3MeshOptimizer::setShouldOptimizeVertexFetch( bool shouldOptimize )
+{
+	m_shouldOptimizeVertexFetch = shouldOptimize;
+}
+
+GLuint CC3MeshOptimizer::getVertexCacheSize()
+{
+	return m_vertexCacheSize;
+}
+
+void CC3MeshOptimizer::setVertexCacheSize( GLuint cacheSize )
+{
+	m_vertexCacheSize = MAX(cacheSize, 3);
+}
+
+GLfloat CC3MeshOptimizer::getOverdrawThreshold()
+{
+	return m_overdrawThreshold;
+}
+
+void CC3MeshOptimizer::setOverdrawThreshold( GLfloat threshold )
+{
+	m_overdrawThreshold = MAX(threshold, 1.0f);
+}
+
+GLuint CC3MeshOptimizer::getMeshCount()
+{
+	return m_meshCount;
+}
+
+GLuint CC3MeshOptimizer::getTriangleCount()
+{
+	return m_triangleCount;
+}
+
+GLfloat CC3MeshOptimizer::getACMRBefore()
+{
+	return m_triangleCount ? (GLfloat)m_cacheMissesBefore / (GLfloat)m_triangleCount : 0.0f;
+}
+
+GLfloat CC3MeshOptimizer::getACMRAfter()
+{
+	return m_triangleCount ? (GLfloat)m_cacheMissesAfter / (GLfloat)m_triangleCount : 0.0f;
+}
+
+GLuint CC3MeshOptimizer::getVertexCountBefore()
+{
+	return m_vertexCountBefore;
+}
+
+GLuint CC3MeshOptimizer::getVertexCountAfter()
+{
+	return m_vertexCountAfter;
+}
+
+void CC3MeshOptimizer::resetStatistics()
+{
+	m_meshCount = 0;
+	m_triangleCount = 0;
+	m_cacheMissesBefore = 0;
+	m_cacheMissesAfter = 0;
+	m_vertexCountBefore = 0;
+	m_vertexCountAfter = 0;
+}
+
+/**
+ * Returns the number of vertices transformed when drawing the triangles in the specified
+ * range of indices through a FIFO cache of the specified size, starting with an empty cache.
+ *
+ * A vertex is in the cache if fewer than cacheSize vertices have been transformed since it was.
+ */
+static GLuint countCacheMisses( const std::vector<GLuint>& indices, GLuint start, GLuint end,
+								std::vector<GLuint>& timestamps, GLuint& time, GLuint cacheSize )
+{
+	time += cacheSize + 1;		// Empties the cache
+	GLuint misses = 0;
+	for ( GLuint i = start; i < end; i++ )
+	{
+		GLuint vIdx = indices[i];
+		if ( time - timestamps[vIdx] > cacheSize )
+		{
+			timestamps[vIdx] = time++;
+			misses++;
+		}
+	}
+	return misses;
+}
+
+static GLuint countCacheMisses( const std::vector<GLuint>& indices, GLuint vertexCount, GLuint cacheSize )
+{
+	std::vector<GLuint> timestamps( vertexCount, 0 );
+	GLuint time = 0;
+	return countCacheMisses( indices, 0, (GLuint)indices.size(), timestamps, time, cacheSize );
+}
+
+/** Returns whether the specified mesh is an indexed triangle mesh whose content is in memory. */
+static bool isOptimizable( CC3Mesh* mesh )
+{
+	CC3VertexIndices* vtxIndices = mesh ? mesh->getVertexIndices() : NULL;
+	if ( !vtxIndices || !vtxIndices->getVertices() || !mesh->getVertexLocations() || !mesh->getVertexLocations()->getVertices() )
+		return false;
+
+	GLenum idxType = vtxIndices->getElementType();
+	return vtxIndices->getDrawingMode() == GL_TRIANGLES && vtxIndices->getStripCount() == 0 &&
+		   (idxType == GL_UNSIGNED_SHORT || idxType == GL_UNSIGNED_BYTE) && vtxIndices->getVertexCount() >= 3;
+}
+
+static void readIndices( CC3VertexIndices* vtxIndices, std::vector<GLuint>& indices )
+{
+	GLuint idxCount = vtxIndices->getVertexCount() - (vtxIndices->getVertexCount() % 3);
+	indices.resize( idxCount );
+	for ( GLuint i = 0; i < idxCount; i++ )
+		indices[i] = vtxIndices->getIndexAt( i );
+}
+
+static void writeIndices( CC3VertexIndices* vtxIndices, const std::vector<GLuint>& indices )
+{
+	GLuint idxCount = (GLuint)indices.size();
+	for ( GLuint i = 0; i < idxCount; i++ )
+		vtxIndices->setIndex( indices[i], i );
+}
+
+/** Collects all vertex arrays of the mesh, other than the vertex indices. */
+static void getVertexArrays( CC3Mesh* mesh, std::vector<CC3VertexArray*>& vtxArrays )
+{
+	CC3VertexArray* arrays[] = { mesh->getVertexLocations(), mesh->getVertexNormals(), mesh->getVertexTangents(),
+								 mesh->getVertexBitangents(), mesh->getVertexColors(), mesh->getVertexBoneIndices(),
+								 mesh->getVertexBoneWeights(), mesh->getVertexPointSizes() };
+	for ( GLuint i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++ )
+	{
+		if ( arrays[i] )
+			vtxArrays.push_back( arrays[i] );
+	}
+
+	GLuint tcCount = mesh->getTextureCoordinatesArrayCount();
+	for ( GLuint i = 0; i < tcCount; i++ )
+		vtxArrays.push_back( mesh->getTextureCoordinatesForTextureUnit( i ) );
+}
+
+/**
+ * Moves the content of each vertex to the position given by the remap table, in every vertex
+ * array. Vertices that map to a negative position are dropped. Vertices that map to the same
+ * position must have identical content.
+ */
+static void remapVertices( const std::vector<CC3VertexArray*>& vtxArrays, const std::vector<GLint>& remap )
+{
+	GLuint vtxCount = (GLuint)remap.size();
+	std::vector<GLubyte> elements;
+	for ( size_t aIdx = 0; aIdx < vtxArrays.size(); aIdx++ )
+	{
+		// Interleaved arrays share memory, but each moves only its own elements
+		CC3VertexArray* vtxArray = vtxArrays[aIdx];
+		GLuint elemLen = vtxArray->getElementLength();
+		elements.resize( vtxCount * elemLen );
+		for ( GLuint v = 0; v < vtxCount; v++ )
+			memcpy( &elements[v * elemLen], vtxArray->getAddressOfElement( v ), elemLen );
+
+		for ( GLuint v = 0; v < vtxCount; v++ )
+		{
+			if ( remap[v] >= 0 )
+				memcpy( vtxArray->getAddressOfElement( remap[v] ), &elements[v * elemLen], elemLen );
+		}
+	}
+}
+
+/**
+ * Builds a remap table that merges vertices whose content is identical in all vertex arrays,
+ * numbering the unique vertices in order of first occurrence. Returns the number of unique vertices.
+ */
+static GLuint buildDeduplicationRemap( const std::vector<CC3VertexArray*>& vtxArrays, GLuint vtxCount, std::vector<GLint>& remap )
+{
+	GLuint keyLen = 0;
+	for ( size_t aIdx = 0; aIdx < vtxArrays.size(); aIdx++ )
+		keyLen += vtxArrays[aIdx]->getElementLength();
+
+	// Gather the content of each vertex into a contiguous key
+	std::vector<GLubyte> keys( vtxCount * keyLen );
+	for ( GLuint v = 0; v < vtxCount; v++ )
+	{
+		GLubyte* pKey = &keys[v * keyLen];
+		for ( size_t aIdx = 0; aIdx < vtxArrays.size(); aIdx++ )
+		{
+			GLuint elemLen = vtxArrays[aIdx]->getElementLength();
+			memcpy( pKey, vtxArrays[aIdx]->getAddressOfElement( v ), elemLen );
+			pKey += elemLen;
+		}
+	}
+
+	// Open-addressed hash table of the first vertex with each key
+	GLuint tableSize = 1;
+	while ( tableSize < vtxCount * 2 )
+		tableSize <<= 1;
+	std::vector<GLint> table( tableSize, -1 );
+
+	remap.assign( vtxCount, -1 );
+	GLuint uniqueCount = 0;
+	for ( GLuint v = 0; v < vtxCount; v++ )
+	{
+		const GLubyte* pKey = &keys[v * keyLen];
+		GLuint hash = 2166136261u;
+		for ( GLuint b = 0; b < keyLen; b++ )
+			hash = (hash ^ pKey[b]) * 16777619u;
+
+		GLuint slot = hash & (tableSize - 1);
+		while ( table[slot] >= 0 && memcmp( &keys[table[slot] * keyLen], pKey, keyLen ) != 0 )
+			slot = (slot + 1) & (tableSize - 1);
+
+		if ( table[slot] < 0 )
+		{
+			table[slot] = (GLint)v;
+			remap[v] = (GLint)uniqueCount++;
+		}
+		else
+		{
+			remap[v] = remap[table[slot]];
+		}
+	}
+	return uniqueCount;
+}
+
+/** Builds a remap table that numbers the vertices in order of first use by the indices. Returns the number of used vertices. */
+static GLuint buildVertexFetchRemap( const std::vector<GLuint>& indices, GLuint vtxCount, std::vector<GLint>& remap )
+{
+	remap.assign( vtxCount, -1 );
+	GLuint usedCount = 0;
+	for ( size_t i = 0; i < indices.size(); i++ )
+	{
+		GLuint vIdx = indices[i];
+		if ( remap[vIdx] < 0 )
+			remap[vIdx] = (GLint)usedCount++;
+	}
+	return usedCount;
+}
+
+/** The score of a vertex, from its position in the modelled LRU cache, and the number of triangles still using it. */
+static GLfloat forsythVertexScore( GLint cachePos, GLuint remainingValence )
+{
+	if ( remainingValence == 0 )
+		return -1.0f;
+
+	GLfloat score = 0.0f;
+	if ( cachePos >= 0 )
+	{
+		// The three most recent vertices are those of the last triangle, so are not favoured over the rest
+		if ( cachePos < 3 )
+			score = 0.75f;
+		else
+			score = powf( 1.0f - (GLfloat)(cachePos - 3) / (GLfloat)(kCC3ForsythCacheSize - 3), 1.5f );
+	}
+
+	// Favour vertices with few remaining triangles, to finish them off
+	return score + 2.0f * powf( (GLfloat)remainingValence, -0.5f );
+}
+
+/** Reorders the triangles using the linear-speed vertex cache optimization of Tom Forsyth. */
+static void optimizeVertexCache( std::vector<GLuint>& indices, GLuint vtxCount )
+{
+	GLuint triCount = (GLuint)indices.size() / 3;
+
+	// Build the lists of triangles that use each vertex. The first remaining[v] entries are not yet drawn.
+	std::vector<GLuint> remaining( vtxCount, 0 );
+	for ( size_t i = 0; i < indices.size(); i++ )
+		remaining[indices[i]]++;
+
+	std::vector<GLuint> adjOffsets( vtxCount + 1, 0 );
+	for ( GLuint v = 0; v < vtxCount; v++ )
+		adjOffsets[v + 1] = adjOffsets[v] + remaining[v];
+
+	std::vector<GLuint> adjTris( indices.size() );
+	std::vector<GLuint> adjFill( adjOffsets.begin(), adjOffsets.end() - 1 );
+	for ( size_t i = 0; i < indices.size(); i++ )
+		adjTris[adjFill[indices[i]]++] = (GLuint)(i / 3);
+
+	std::vector<GLint> cachePos( vtxCount, -1 );
+	std::vector<GLfloat> vtxScores( vtxCount );
+	for ( GLuint v = 0; v < vtxCount; v++ )
+		vtxScores[v] = forsythVertexScore( -1, remaining[v] );
+
+	std::vector<GLfloat> triScores( triCount );
+	std::vector<bool> isEmitted( triCount, false );
+	GLint bestTri = -1;
+	GLfloat bestScore = -1.0f;
+	for ( GLuint t = 0; t < triCount; t++ )
+	{
+		const GLuint* tri = &indices[t * 3];
+		triScores[t] = vtxScores[tri[0]] + vtxScores[tri[1]] + vtxScores[tri[2]];
+		if ( triScores[t] > bestScore )
+		{
+			bestScore = triScores[t];
+			bestTri = (GLint)t;
+		}
+	}
+
+	std::vector<GLuint> output;
+	output.reserve( indices.size() );
+	std::vector<GLuint> cache, touched;
+	cache.reserve( kCC3ForsythCacheSize + 3 );
+	touched.reserve( kCC3ForsythCacheSize + 3 );
+	GLuint nextInputTri = 0;
+
+	for ( GLuint emitCount = 0; emitCount < triCount; emitCount++ )
+	{
+		// If no cached vertex has triangles left, continue with the next undrawn triangle
+		if ( bestTri < 0 )
+		{
+			while ( isEmitted[nextInputTri] )
+				nextInputTri++;
+			bestTri = (GLint)nextInputTri;
+		}
+
+		const GLuint* tri = &indices[bestTri * 3];
+		isEmitted[bestTri] = true;
+		output.insert( output.end(), tri, tri + 3 );
+
+		// Remove the triangle from the lists of its vertices, and move its vertices to the front of the cache
+		touched.clear();
+		for ( GLuint k = 0; k < 3; k++ )
+		{
+			GLuint vIdx = tri[k];
+			GLuint* adj = &adjTris[adjOffsets[vIdx]];
+			GLuint adjCount = remaining[vIdx];
+			for ( GLuint j = 0; j < adjCount; j++ )
+			{
+				if ( adj[j] == (GLuint)bestTri )
+				{
+					adj[j] = adj[adjCount - 1];
+					break;
+				}
+			}
+			remaining[vIdx]--;
+
+			if ( std::find( touched.begin(), touched.end(), vIdx ) == touched.end() )
+				touched.push_back( vIdx );
+		}
+
+		size_t triVtxCount = touched.size();
+		for ( size_t c = 0; c < cache.size(); c++ )
+		{
+			if ( std::find( touched.begin(), touched.begin() + triVtxCount, cache[c] ) == touched.begin() + triVtxCount )
+				touched.push_back( cache[c] );
+		}
+
+		// Rescore the vertices whose cache positions changed, including those that fell out of the cache
+		for ( size_t c = 0; c < touched.size(); c++ )
+		{
+			GLuint vIdx = touched[c];
+			cachePos[vIdx] = (c < kCC3ForsythCacheSize) ? (GLint)c : -1;
+			vtxScores[vIdx] = forsythVertexScore( cachePos[vIdx], remaining[vIdx] );
+		}
+
+		// Rescore the undrawn triangles of those vertices, and pick the best of them
+		bestTri = -1;
+		bestScore = -1.0f;
+		for ( size_t c = 0; c < touched.size(); c++ )
+		{
+			GLuint vIdx = touched[c];
+			const GLuint* adj = &adjTris[adjOffsets[vIdx]];
+			for ( GLuint j = 0; j < remaining[vIdx]; j++ )
+			{
+				GLuint t = adj[j];
+				const GLuint* aTri = &indices[t * 3];
+				triScores[t] = vtxScores[aTri[0]] + vtxScores[aTri[1]] + vtxScores[aTri[2]];
+				if ( triScores[t] > bestScore )
+				{
+					bestScore = triScores[t];
+					bestTri = (GLint)t;
+				}
+			}
+		}
+
+		cache.assign( touched.begin(), touched.begin() + MIN(touched.size(), (size_t)kCC3ForsythCacheSize) );
+	}
+
+	indices.swap( output );
+}
+
+/** A contiguous run of triangles, and the key used to sort the runs from the outside of the mesh inwards. */
+typedef struct {
+	GLuint		start;
+	GLuint		end;
+	GLfloat		sortKey;
+} CC3TriangleCluster;
+
+static bool compareClusters( const CC3TriangleCluster& c1, const CC3TriangleCluster& c2 )
+{
+	return c1.sortKey > c2.sortKey;
+}
+
+/**
+ * Splits the triangles, which are in vertex cache order, into clusters, and reorders the clusters
+ * so that those that face outwards from the center of the mesh are drawn first.
+ *
+ * Hard boundaries are placed where the cache is effectively empty, because every vertex of a
+ * triangle misses it. Each hard cluster is then split further at the first point at which the
+ * ACMR of the split-off part, drawn from an empty cache, is within the threshold of the ACMR
+ * of the whole hard cluster.
+ */
+static void optimizeOverdraw( std::vector<GLuint>& indices, CC3Mesh* mesh, GLuint cacheSize, GLfloat threshold )
+{
+	GLuint triCount = (GLuint)indices.size() / 3;
+	if ( triCount < 2 )
+		return;
+
+	GLuint vtxCount = mesh->getVertexCount();
+	std::vector<GLuint> timestamps( vtxCount, 0 );
+	GLuint time = 0;
+
+	std::vector<GLuint> hardStarts;
+	time += cacheSize + 1;
+	for ( GLuint t = 0; t < triCount; t++ )
+	{
+		GLuint misses = 0;
+		for ( GLuint k = 0; k < 3; k++ )
+		{
+			GLuint vIdx = indices[t * 3 + k];
+			if ( time - timestamps[vIdx] > cacheSize )
+			{
+				timestamps[vIdx] = time++;
+				misses++;
+			}
+		}
+		if ( t == 0 || misses == 3 )
+			hardStarts.push_back( t );
+	}
+	hardStarts.push_back( triCount );
+
+	std::vector<CC3TriangleCluster> clusters;
+	for ( size_t h = 0; h + 1 < hardStarts.size(); h++ )
+	{
+		GLuint hardStart = hardStarts[h];
+		GLuint hardEnd = hardStarts[h + 1];
+		GLuint hardMisses = countCacheMisses( indices, hardStart * 3, hardEnd * 3, timestamps, time, cacheSize );
+		GLfloat clusterThreshold = threshold * (GLfloat)hardMisses / (GLfloat)(hardEnd - hardStart);
+
+		GLuint start = hardStart;
+		while ( start < hardEnd )
+		{
+			GLuint end = hardEnd;
+			GLuint misses = 0;
+			time += cacheSize + 1;
+			for ( GLuint t = start; t < hardEnd; t++ )
+			{
+				for ( GLuint k = 0; k < 3; k++ )
+				{
+					GLuint vIdx = indices[t * 3 + k];
+					if ( time - timestamps[vIdx] > cacheSize )
+					{
+						timestamps[vIdx] = time++;
+						misses++;
+					}
+				}
+				if ( (GLfloat)misses <= clusterThreshold * (GLfloat)(t - start + 1) )
+				{
+					end = t + 1;
+					break;
+				}
+			}
+
+			CC3TriangleCluster cluster;
+			cluster.start = start;
+			cluster.end = end;
+			cluster.sortKey = 0.0f;
+			clusters.push_back( cluster );
+			start = end;
+		}
+	}
+
+	if ( clusters.size() < 2 )
+		return;
+
+	// Area-weighted centroids and normals of each cluster, and of the whole mesh
+	std::vector<CC3Vector> centroids( clusters.size(), CC3Vector::kCC3VectorZero );
+	std::vector<CC3Vector> normals( clusters.size(), CC3Vector::kCC3VectorZero );
+	CC3Vector meshCentroid = CC3Vector::kCC3VectorZero;
+	GLfloat meshArea = 0.0f;
+	for ( size_t c = 0; c < clusters.size(); c++ )
+	{
+		GLfloat clusterArea = 0.0f;
+		for ( GLuint t = clusters[c].start; t < clusters[c].end; t++ )
+		{
+			CC3Vector p0 = mesh->getVertexLocationAt( indices[t * 3] );
+			CC3Vector p1 = mesh->getVertexLocationAt( indices[t * 3 + 1] );
+			CC3Vector p2 = mesh->getVertexLocationAt( indices[t * 3 + 2] );
+			CC3Vector triNormal = p1.difference( p0 ).cross( p2.difference( p0 ) );
+			GLfloat triArea = triNormal.length() * 0.5f;
+			CC3Vector triCenter = p0.add( p1 ).add( p2 ).scaleUniform( 1.0f / 3.0f );
+
+			normals[c] = normals[c].add( triNormal );
+			centroids[c] = centroids[c].add( triCenter.scaleUniform( triArea ) );
+			clusterArea += triArea;
+		}
+
+		meshCentroid = meshCentroid.add( centroids[c] );
+		meshArea += clusterArea;
+		if ( clusterArea > 0.0f )
+			centroids[c] = centroids[c].scaleUniform( 1.0f / clusterArea );
+	}
+
+	if ( meshArea > 0.0f )
+		meshCentroid = meshCentroid.scaleUniform( 1.0f / meshArea );
+
+	for ( size_t c = 0; c < clusters.size(); c++ )
+	{
+		GLfloat normalLength = normals[c].length();
+		if ( normalLength > 0.0f )
+			clusters[c].sortKey = centroids[c].difference( meshCentroid ).dot( normals[c] ) / normalLength;
+	}
+
+	std::stable_sort( clusters.begin(), clusters.end(), compareClusters );
+
+	std::vector<GLuint> output;
+	output.reserve( indices.size() );
+	for ( size_t c = 0; c < clusters.size(); c++ )
+		output.insert( output.end(), indices.begin() + clusters[c].start * 3, indices.begin() + clusters[c].end * 3 );
+
+	indices.swap( output );
+}
+
+bool CC3MeshOptimizer::optimizeMesh( CC3Mesh* mesh )
+{
+	CC3_PROFILE_ZONE( "CC3MeshOptimizer::optimizeMesh" );
+
+	if ( !isOptimizable( mesh ) )
+	{
+		CC3_TRACE( "CC3MeshOptimizer skipping %s, which is not an indexed triangle mesh with its content in memory",
+			mesh ? mesh->getName().c_str() : "NULL mesh" );
+		return false;
+	}
+
+	std::vector<CC3VertexArray*> vtxArrays;
+	getVertexArrays( mesh, vtxArrays );
+	for ( size_t aIdx = 0; aIdx < vtxArrays.size(); aIdx++ )
+	{
+		if ( !vtxArrays[aIdx]->getVertices() )
+			return false;
+	}
+
+	CC3VertexIndices* vtxIndices = mesh->getVertexIndices();
+	std::vector<GLuint> indices;
+	readIndices( vtxIndices, indices );
+
+	GLuint vtxCount = mesh->getVertexCount();
+	for ( size_t i = 0; i < indices.size(); i++ )
+	{
+		if ( indices[i] >= vtxCount )
+			return false;
+	}
+
+	GLuint triCount = (GLuint)indices.size() / 3;
+	GLuint missesBefore = countCacheMisses( indices, vtxCount, m_vertexCacheSize );
+	GLuint vtxCountBefore = vtxCount;
+	std::vector<GLint> remap;
+
+	if ( m_shouldDeduplicateVertices )
+	{
+		GLuint uniqueCount = buildDeduplicationRemap( vtxArrays, vtxCount, remap );
+		if ( uniqueCount < vtxCount )
+		{
+			remapVertices( vtxArrays, remap );
+			for ( size_t i = 0; i < indices.size(); i++ )
+				indices[i] = remap[indices[i]];
+			vtxCount = uniqueCount;
+		}
+	}
+
+	// The triangles of each skin section must remain contiguous
+	bool canReorderTriangles = !mesh->hasVertexBoneIndices() && !mesh->hasVertexBoneWeights();
+
+	if ( m_shouldOptimizeVertexCache && canReorderTriangles )
+		optimizeVertexCache( indices, vtxCount );
+
+	if ( m_shouldOptimizeOverdraw && canReorderTriangles )
+		optimizeOverdraw( indices, mesh, m_vertexCacheSize, m_overdrawThreshold );
+
+	if ( m_shouldOptimizeVertexFetch )
+	{
+		GLuint usedCount = buildVertexFetchRemap( indices, vtxCount, remap );
+		remapVertices( vtxArrays, remap );
+		for ( size_t i = 0; i < indices.size(); i++ )
+			indices[i] = remap[indices[i]];
+		vtxCount = usedCount;
+	}
+
+	writeIndices( vtxIndices, indices );
+	if ( vtxCount != vtxCountBefore )
+	{
+		mesh->setVertexCount( vtxCount );
+		mesh->getVertexLocations()->markBoundaryDirty();
+	}
+	mesh->markFacesDirty();
+
+	if ( mesh->isUsingGLBuffers() )
+	{
+		mesh->updateGLBuffers();
+		mesh->updateVertexIndicesGLBuffer();
+	}
+
+	GLuint missesAfter = countCacheMisses( indices, vtxCount, m_vertexCacheSize );
+	m_meshCount++;
+	m_triangleCount += triCount;
+	m_cacheMissesBefore += missesBefore;
+	m_cacheMissesAfter += missesAfter;
+	m_vertexCountBefore += vtxCountBefore;
+	m_vertexCountAfter += vtxCount;
+
+	CC3_TRACE( "CC3MeshOptimizer optimized %s: %u triangles, %u vertices before and %u after, ACMR %.3f before and %.3f after",
+		mesh->getName().c_str(), triCount, vtxCountBefore, vtxCount,
+		(GLfloat)missesBefore / (GLfloat)triCount, (GLfloat)missesAfter / (GLfloat)triCount );
+	return true;
+}
+
+GLfloat CC3MeshOptimizer::getACMR( CC3Mesh* mesh, GLuint cacheSize )
+{
+	if ( !isOptimizable( mesh ) )
+		return 0.0f;
+
+	std::vector<GLuint> indices;
+	readIndices( mesh->getVertexIndices(), indices );
+
+	GLuint vtxCount = 0;
+	for ( size_t i = 0; i < indices.size(); i++ )
+		vtxCount = MAX(vtxCount, indices[i] + 1);
+
+	return (GLfloat)countCacheMisses( indices, vtxCount, MAX(cacheSize, 3) ) / (GLfloat)(indices.size() / 3);
+}
+
+bool CC3MeshOptimizer::init()
+{
+	m_vertexCacheSize = 16;
+	m_overdrawThreshold = 1.05f;
+	m_shouldDeduplicateVertices = true;
+	m_shouldOptimizeVertexCache = true;
+	m_shouldOptimizeOverdraw = true;
+	m_shouldOptimizeVertexFetch = true;
+	resetStatistics();
+
+	return true;
+}
+
+CC3MeshOptimizer* CC3MeshOptimizer::optimizer()
+{
+	CC3MeshOptimizer* pOptimizer = new CC3MeshOptimizer;
+	pOptimizer->init();
+	pOptimizer->autorelease();
+
+	return pOptimizer;
+}
+
+NS_COCOS3D_END
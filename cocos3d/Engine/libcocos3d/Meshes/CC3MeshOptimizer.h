@@ -0,0 +1,180 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_MESH_OPTIMIZER_H_
+#define _CC3_MESH_OPTIMIZER_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3Mesh;
+
+/**
+ * CC3MeshOptimizer reorders the vertex and index content of indexed triangle meshes, so that
+ * they are drawn more efficiently by the GPU, without changing what is drawn.
+ *
+ * The optimizeMesh: method applies the following steps, each of which can be turned off:
+ *   - Vertex deduplication merges vertices whose content is identical in all vertex arrays.
+ *   - Vertex cache optimization reorders the triangles so that vertices that were recently
+ *     transformed are reused by the post-transform vertex cache of the GPU, using the
+ *     linear-speed algorithm of Tom Forsyth.
+ *   - Overdraw optimization splits the triangles into clusters, at points where doing so costs
+ *     little vertex cache efficiency, and sorts the clusters so that outward-facing clusters are
+ *     drawn first, and are therefore more likely to occlude the triangles drawn after them.
+ *   - Vertex fetch optimization reorders the vertices into the order in which they are first used
+ *     by the triangles, so that vertex content is fetched from memory sequentially, and drops any
+ *     vertices that are not used by any triangle.
+ *
+ * Optimization can be performed when a mesh is loaded, for example by setting the meshOptimizer
+ * property of a CC3PODResource, or offline, before saving the mesh to a scene cache file using
+ * the CC3SceneCacheResource class.
+ *
+ * To allow the gains to be verified, each optimization measures the average cache miss ratio
+ * (ACMR), which is the average number of vertices transformed per triangle, of a FIFO vertex
+ * cache of the size indicated by the vertexCacheSize property, before and after optimization.
+ * These measurements are accumulated across all meshes optimized by this instance, until the
+ * resetStatistics method is invoked. The ACMR of a triangle list is between 0.5, for an ideally
+ * ordered regular grid, and 3.0, where no vertices are reused.
+ *
+ * Only meshes drawn as triangles, using vertex indices, are optimized. Meshes that contain
+ * triangle strips, or whose vertex content has been released, are left unchanged. The triangles
+ * of a mesh that contains bone weights and indices are not reordered, because the triangles of
+ * each skin section of a skinned mesh must remain contiguous, but vertex deduplication and vertex
+ * fetch optimization are still applied to such a mesh.
+ *
+ * If the mesh content has already been copied to GL buffers, those buffers are updated.
+ */
+class CC3MeshOptimizer : public CCObject
+{
+public:
+	CC3MeshOptimizer();
+	virtual ~CC3MeshOptimizer();
+
+	/**
+	 * Indicates whether vertices with identical content should be merged.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldDeduplicateVertices();
+	void						setShouldDeduplicateVertices( bool shouldDeduplicate );
+
+	/**
+	 * Indicates whether triangles should be reordered for the post-transform vertex cache.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldOptimizeVertexCache();
+	void						setShouldOptimizeVertexCache( bool shouldOptimize );
+
+	/**
+	 * Indicates whether clusters of triangles should be reordered to reduce overdraw.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldOptimizeOverdraw();
+	void						setShouldOptimizeOverdraw( bool shouldOptimize );
+
+	/**
+	 * Indicates whether vertices should be reordered into the order in which they are used.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldOptimizeVertexFetch();
+	void						setShouldOptimizeVertexFetch( bool shouldOptimize );
+
+	/**
+	 * The number of entries in the FIFO vertex cache used to measure the ACMR of a mesh,
+	 * and to find the points at which triangles can be split into clusters.
+	 *
+	 * The initial value of this property is 16.
+	 */
+	GLuint						getVertexCacheSize();
+	void						setVertexCacheSize( GLuint cacheSize );
+
+	/**
+	 * The factor by which overdraw optimization may increase the ACMR of each cluster of triangles,
+	 * relative to the ACMR of the triangles in vertex cache order. Higher values produce more, smaller
+	 * clusters, which can be sorted more effectively, at the cost of vertex cache efficiency.
+	 *
+	 * The initial value of this property is 1.05.
+	 */
+	GLfloat						getOverdrawThreshold();
+	void						setOverdrawThreshold( GLfloat threshold );
+
+	/**
+	 * Optimizes the vertex and index content of the specified mesh, and returns whether the
+	 * mesh was optimized. See the notes for this class for the meshes that can be optimized.
+	 */
+	bool						optimizeMesh( CC3Mesh* mesh );
+
+	/** The number of meshes optimized since the statistics were last reset. */
+	GLuint						getMeshCount();
+
+	/** The number of triangles in the meshes optimized since the statistics were last reset. */
+	GLuint						getTriangleCount();
+
+	/** The ACMR of the meshes optimized since the statistics were last reset, before they were optimized. */
+	GLfloat						getACMRBefore();
+
+	/** The ACMR of the meshes optimized since the statistics were last reset, after they were optimized. */
+	GLfloat						getACMRAfter();
+
+	/** The number of vertices in the meshes optimized since the statistics were last reset, before they were optimized. */
+	GLuint						getVertexCountBefore();
+
+	/** The number of vertices in the meshes optimized since the statistics were last reset, after they were optimized. */
+	GLuint						getVertexCountAfter();
+
+	/** Resets the statistics accumulated from the meshes optimized by this instance. */
+	void						resetStatistics();
+
+	/**
+	 * Returns the ACMR of the triangles of the specified mesh, as drawn by a FIFO vertex cache
+	 * with the specified number of entries, or zero if the mesh is not an indexed triangle mesh.
+	 */
+	static GLfloat				getACMR( CC3Mesh* mesh, GLuint cacheSize );
+
+	virtual bool				init();
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3MeshOptimizer*	optimizer();
+
+protected:
+	GLuint						m_vertexCacheSize;
+	GLfloat						m_overdrawThreshold;
+	GLuint						m_meshCount;
+	GLuint						m_triangleCount;
+	GLuint						m_cacheMissesBefore;
+	GLuint						m_cacheMissesAfter;
+	GLuint						m_vertexCountBefore;
+	GLuint						m_vertexCountAfter;
+	bool						m_shouldDeduplicateVertices : 1;
+	bool						m_shouldOptimizeVertexCache : 1;
+	bool						m_shouldOptimizeOverdraw : 1;
+	bool						m_shouldOptimizeVertexFetch : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
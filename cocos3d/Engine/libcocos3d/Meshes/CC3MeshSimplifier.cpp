@@ -0,0 +1,545 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+#include <iterator>
+#include <queue>
+
+NS_COCOS3D_BEGIN
+
+/**
+ * A symmetric 4x4 error quadric, holding the upper triangle of the matrix in the order
+ * xx, xy, xz, xw, yy, yz, yw, zz, zw, ww. Doubles are used, because the terms of the
+ * quadric are squares of vertex coordinates, and accumulate across many triangles.
+ */
+typedef struct
+{
+	double		q[10];
+} CC3ErrorQuadric;
+
+static void addPlaneToQuadric( CC3ErrorQuadric& quadric, double a, double b, double c, double d, double weight )
+{
+	quadric.q[0] += weight * a * a;
+	quadric.q[1] += weight * a * b;
+	quadric.q[2] += weight * a * c;
+	quadric.q[3] += weight * a * d;
+	quadric.q[4] += weight * b * b;
+	quadric.q[5] += weight * b * c;
+	quadric.q[6] += weight * b * d;
+	quadric.q[7] += weight * c * c;
+	quadric.q[8] += weight * c * d;
+	quadric.q[9] += weight * d * d;
+}
+
+static void addQuadric( CC3ErrorQuadric& quadric, const CC3ErrorQuadric& other )
+{
+	for ( int i = 0; i < 10; i++ )
+		quadric.q[i] += other.q[i];
+}
+
+/** Returns the error of moving a vertex with the sum of the two quadrics to the specified location. */
+static double getQuadricError( const CC3ErrorQuadric& q1, const CC3ErrorQuadric& q2, const CC3Vector& loc )
+{
+	double q[10];
+	for ( int i = 0; i < 10; i++ )
+		q[i] = q1.q[i] + q2.q[i];
+
+	double x = loc.x, y = loc.y, z = loc.z;
+	double err = q[0]*x*x + 2.0*q[1]*x*y + 2.0*q[2]*x*z + 2.0*q[3]*x
+				+ q[4]*y*y + 2.0*q[5]*y*z + 2.0*q[6]*y
+				+ q[7]*z*z + 2.0*q[8]*z
+				+ q[9];
+	return MAX(err, 0.0);
+}
+
+/**
+ * A candidate collapse of the vertex at fromIndex onto the vertex at toIndex. The versions of the
+ * two vertices when the candidate was queued allow stale candidates to be discarded when popped.
+ */
+typedef struct
+{
+	double		cost;
+	GLuint		fromIndex;
+	GLuint		toIndex;
+	GLuint		fromVersion;
+	GLuint		toVersion;
+} CC3EdgeCollapse;
+
+/** Orders the priority queue so that the lowest cost collapse is at the top. */
+struct CC3EdgeCollapseCompare
+{
+	bool operator()( const CC3EdgeCollapse& c1, const CC3EdgeCollapse& c2 ) const
+	{
+		return c1.cost > c2.cost;
+	}
+};
+
+typedef std::priority_queue<CC3EdgeCollapse, std::vector<CC3EdgeCollapse>, CC3EdgeCollapseCompare> CC3EdgeCollapseQueue;
+
+/** The working state of a single simplification pass. */
+typedef struct
+{
+	std::vector<CC3Vector>				locations;
+	std::vector<GLuint>					indices;
+	std::vector<CC3ErrorQuadric>		quadrics;
+	std::vector<std::vector<GLuint> >	vertexTriangles;
+	std::vector<GLuint>					versions;
+	std::vector<bool>					isLocked;
+	std::vector<bool>					isRemoved;
+	std::vector<bool>					isTriangleRemoved;
+} CC3SimplificationState;
+
+CC3MeshSimplifier::CC3MeshSimplifier()
+{
+
+}
+
+CC3MeshSimplifier::~CC3MeshSimplifier()
+{
+
+}
+
+GLfloat CC3MeshSimplifier::getMinimumNormalAlignment()
+{
+	return m_minimumNormalAlignment;
+}
+
+void CC3MeshSimplifier::setMinimumNormalAlignment( GLfloat alignment )
+{
+	m_minimumNormalAlignment = alignment;
+}
+
+GLuint CC3MeshSimplifier::getMeshCount()
+{
+	return m_meshCount;
+}
+
+GLuint CC3MeshSimplifier::getTriangleCountBefore()
+{
+	return m_triangleCountBefore;
+}
+
+GLuint CC3MeshSimplifier::getTriangleCountAfter()
+{
+	return m_triangleCountAfter;
+}
+
+void CC3MeshSimplifier::resetStatistics()
+{
+	m_meshCount = 0;
+	m_triangleCountBefore = 0;
+	m_triangleCountAfter = 0;
+}
+
+/** Returns whether the specified mesh is an unskinned indexed triangle mesh whose content is in memory. */
+static bool isSimplifiable( CC3Mesh* mesh )
+{
+	CC3VertexIndices* vtxIndices = mesh ? mesh->getVertexIndices() : NULL;
+	CC3VertexLocations* vtxLocs = mesh ? mesh->getVertexLocations() : NULL;
+	if ( !vtxIndices || !vtxIndices->getVertices() || !vtxLocs || !vtxLocs->getVertices() )
+		return false;
+
+	if ( mesh->hasVertexBoneIndices() || mesh->hasVertexBoneWeights() )
+		return false;
+
+	GLenum idxType = vtxIndices->getElementType();
+	return vtxIndices->getDrawingMode() == GL_TRIANGLES && vtxIndices->getStripCount() == 0 &&
+		   (idxType == GL_UNSIGNED_SHORT || idxType == GL_UNSIGNED_BYTE) && vtxIndices->getVertexCount() >= 3;
+}
+
+static bool compareLocationsOfIndices( const std::pair<CC3Vector, GLuint>& v1, const std::pair<CC3Vector, GLuint>& v2 )
+{
+	const CC3Vector& l1 = v1.first;
+	const CC3Vector& l2 = v2.first;
+	if ( l1.x != l2.x ) return l1.x < l2.x;
+	if ( l1.y != l2.y ) return l1.y < l2.y;
+	return l1.z < l2.z;
+}
+
+/**
+ * Locks the vertices that must not be moved: vertices that share their location with another
+ * vertex, and vertices on an edge that is not shared by exactly two triangles.
+ */
+static void lockVertices( CC3SimplificationState& state )
+{
+	GLuint vtxCount = (GLuint)state.locations.size();
+	state.isLocked.assign( vtxCount, false );
+
+	std::vector< std::pair<CC3Vector, GLuint> > sortedLocs( vtxCount );
+	for ( GLuint v = 0; v < vtxCount; v++ )
+		sortedLocs[v] = std::make_pair( state.locations[v], v );
+	std::sort( sortedLocs.begin(), sortedLocs.end(), compareLocationsOfIndices );
+
+	for ( GLuint i = 1; i < vtxCount; i++ )
+	{
+		if ( sortedLocs[i].first.equals( sortedLocs[i - 1].first ) )
+		{
+			state.isLocked[sortedLocs[i].second] = true;
+			state.isLocked[sortedLocs[i - 1].second] = true;
+		}
+	}
+
+	std::vector< std::pair<GLuint, GLuint> > edges;
+	edges.reserve( state.indices.size() );
+	for ( size_t t = 0; t < state.indices.size(); t += 3 )
+	{
+		for ( int e = 0; e < 3; e++ )
+		{
+			GLuint v1 = state.indices[t + e];
+			GLuint v2 = state.indices[t + ((e + 1) % 3)];
+			edges.push_back( std::make_pair( MIN(v1, v2), MAX(v1, v2) ) );
+		}
+	}
+	std::sort( edges.begin(), edges.end() );
+
+	size_t edgeCount = edges.size();
+	size_t start = 0;
+	while ( start < edgeCount )
+	{
+		size_t end = start + 1;
+		while ( end < edgeCount && edges[end] == edges[start] )
+			end++;
+
+		if ( end - start != 2 )
+		{
+			state.isLocked[edges[start].first] = true;
+			state.isLocked[edges[start].second] = true;
+		}
+		start = end;
+	}
+}
+
+/** Accumulates the area-weighted plane of each triangle into the quadrics of its vertices. */
+static void buildQuadrics( CC3SimplificationState& state )
+{
+	CC3ErrorQuadric zeroQuadric;
+	memset( &zeroQuadric, 0, sizeof(zeroQuadric) );
+	state.quadrics.assign( state.locations.size(), zeroQuadric );
+
+	for ( size_t t = 0; t < state.indices.size(); t += 3 )
+	{
+		const CC3Vector& p0 = state.locations[state.indices[t]];
+		const CC3Vector& p1 = state.locations[state.indices[t + 1]];
+		const CC3Vector& p2 = state.locations[state.indices[t + 2]];
+
+		CC3Vector normal = p1.difference( p0 ).cross( p2.difference( p0 ) );
+		GLfloat doubleArea = normal.length();
+		if ( doubleArea <= 0.0f )
+			continue;
+
+		normal = normal.scaleUniform( 1.0f / doubleArea );
+		double d = -normal.dot( p0 );
+		for ( int i = 0; i < 3; i++ )
+			addPlaneToQuadric( state.quadrics[state.indices[t + i]], normal.x, normal.y, normal.z, d, doubleArea * 0.5 );
+	}
+}
+
+static void queueCollapse( CC3SimplificationState& state, CC3EdgeCollapseQueue& queue, GLuint fromIdx, GLuint toIdx )
+{
+	if ( state.isLocked[fromIdx] || state.isRemoved[fromIdx] || state.isRemoved[toIdx] )
+		return;
+
+	CC3EdgeCollapse collapse;
+	collapse.cost = getQuadricError( state.quadrics[fromIdx], state.quadrics[toIdx], state.locations[toIdx] );
+	collapse.fromIndex = fromIdx;
+	collapse.toIndex = toIdx;
+	collapse.fromVersion = state.versions[fromIdx];
+	collapse.toVersion = state.versions[toIdx];
+	queue.push( collapse );
+}
+
+/** Populates the sorted list of vertices that share a remaining triangle with the specified vertex. */
+static void getNeighbours( CC3SimplificationState& state, GLuint vtxIdx, std::vector<GLuint>& neighbours )
+{
+	neighbours.clear();
+	const std::vector<GLuint>& tris = state.vertexTriangles[vtxIdx];
+	for ( size_t i = 0; i < tris.size(); i++ )
+	{
+		GLuint t = tris[i];
+		if ( state.isTriangleRemoved[t] )
+			continue;
+
+		for ( int j = 0; j < 3; j++ )
+		{
+			GLuint v = state.indices[t * 3 + j];
+			if ( v != vtxIdx )
+				neighbours.push_back( v );
+		}
+	}
+	std::sort( neighbours.begin(), neighbours.end() );
+	neighbours.erase( std::unique( neighbours.begin(), neighbours.end() ), neighbours.end() );
+}
+
+/**
+ * Returns whether the vertex at fromIdx can be collapsed onto the vertex at toIdx, without joining
+ * separate sides of the mesh together, or rotating any remaining triangle too far.
+ */
+static bool canCollapse( CC3SimplificationState& state, GLuint fromIdx, GLuint toIdx, GLfloat minAlignment,
+						 std::vector<GLuint>& fromNeighbours, std::vector<GLuint>& toNeighbours )
+{
+	// An interior edge is shared by exactly two triangles, whose third vertices are the only
+	// vertices adjacent to both ends of the edge. Any more, and the collapse would pinch the mesh.
+	getNeighbours( state, fromIdx, fromNeighbours );
+	getNeighbours( state, toIdx, toNeighbours );
+	std::vector<GLuint> common;
+	std::set_intersection( fromNeighbours.begin(), fromNeighbours.end(),
+						   toNeighbours.begin(), toNeighbours.end(), std::back_inserter( common ) );
+	if ( common.size() != 2 )
+		return false;
+
+	const CC3Vector& toLoc = state.locations[toIdx];
+	const std::vector<GLuint>& tris = state.vertexTriangles[fromIdx];
+	for ( size_t i = 0; i < tris.size(); i++ )
+	{
+		GLuint t = tris[i];
+		if ( state.isTriangleRemoved[t] )
+			continue;
+
+		GLuint* tri = &state.indices[t * 3];
+		if ( tri[0] == toIdx || tri[1] == toIdx || tri[2] == toIdx )
+			continue;		// Will be removed by the collapse
+
+		CC3Vector before[3], after[3];
+		for ( int j = 0; j < 3; j++ )
+		{
+			before[j] = state.locations[tri[j]];
+			after[j] = (tri[j] == fromIdx) ? toLoc : before[j];
+		}
+
+		CC3Vector nBefore = before[1].difference( before[0] ).cross( before[2].difference( before[0] ) );
+		CC3Vector nAfter = after[1].difference( after[0] ).cross( after[2].difference( after[0] ) );
+		GLfloat lenProduct = nBefore.length() * nAfter.length();
+		if ( lenProduct <= 0.0f || nBefore.dot( nAfter ) < minAlignment * lenProduct )
+			return false;
+	}
+
+	return true;
+}
+
+/** Moves the vertex at fromIdx onto the vertex at toIdx, removing the triangles that shared the edge. */
+static GLuint collapseEdge( CC3SimplificationState& state, GLuint fromIdx, GLuint toIdx )
+{
+	GLuint removedCount = 0;
+	std::vector<GLuint>& fromTris = state.vertexTriangles[fromIdx];
+	std::vector<GLuint>& toTris = state.vertexTriangles[toIdx];
+	for ( size_t i = 0; i < fromTris.size(); i++ )
+	{
+		GLuint t = fromTris[i];
+		if ( state.isTriangleRemoved[t] )
+			continue;
+
+		GLuint* tri = &state.indices[t * 3];
+		if ( tri[0] == toIdx || tri[1] == toIdx || tri[2] == toIdx )
+		{
+			state.isTriangleRemoved[t] = true;
+			removedCount++;
+			continue;
+		}
+
+		for ( int j = 0; j < 3; j++ )
+		{
+			if ( tri[j] == fromIdx )
+				tri[j] = toIdx;
+		}
+		toTris.push_back( t );
+	}
+
+	fromTris.clear();
+	state.isRemoved[fromIdx] = true;
+	addQuadric( state.quadrics[toIdx], state.quadrics[fromIdx] );
+	state.versions[toIdx]++;
+
+	// Drop references to removed triangles from the surviving vertex
+	size_t liveCount = 0;
+	for ( size_t i = 0; i < toTris.size(); i++ )
+	{
+		if ( !state.isTriangleRemoved[toTris[i]] )
+			toTris[liveCount++] = toTris[i];
+	}
+	toTris.resize( liveCount );
+
+	return removedCount;
+}
+
+CC3Mesh* CC3MeshSimplifier::simplifyMesh( CC3Mesh* mesh, GLfloat triangleRatio )
+{
+	CC3_PROFILE_ZONE( "CC3MeshSimplifier::simplifyMesh" );
+
+	if ( !isSimplifiable( mesh ) )
+	{
+		CC3_TRACE( "CC3MeshSimplifier skipping %s, which is not an unskinned indexed triangle mesh with its content in memory",
+			mesh ? mesh->getName().c_str() : "NULL mesh" );
+		return NULL;
+	}
+
+	CC3VertexIndices* vtxIndices = mesh->getVertexIndices();
+	CC3VertexLocations* vtxLocs = mesh->getVertexLocations();
+	GLuint vtxCount = vtxLocs->getVertexCount();
+	GLuint idxCount = vtxIndices->getVertexCount() - (vtxIndices->getVertexCount() % 3);
+	GLuint triCount = idxCount / 3;
+
+	CC3SimplificationState state;
+	state.locations.resize( vtxCount );
+	for ( GLuint v = 0; v < vtxCount; v++ )
+		state.locations[v] = vtxLocs->getLocationAt( v );
+
+	state.indices.resize( idxCount );
+	for ( GLuint i = 0; i < idxCount; i++ )
+	{
+		state.indices[i] = vtxIndices->getIndexAt( i );
+		if ( state.indices[i] >= vtxCount )
+			return NULL;
+	}
+
+	lockVertices( state );
+	buildQuadrics( state );
+
+	state.vertexTriangles.resize( vtxCount );
+	for ( GLuint t = 0; t < triCount; t++ )
+	{
+		for ( int j = 0; j < 3; j++ )
+			state.vertexTriangles[state.indices[t * 3 + j]].push_back( t );
+	}
+	state.versions.assign( vtxCount, 0 );
+	state.isRemoved.assign( vtxCount, false );
+	state.isTriangleRemoved.assign( triCount, false );
+
+	// Degenerate triangles are dropped up front
+	GLuint liveTriCount = triCount;
+	for ( GLuint t = 0; t < triCount; t++ )
+	{
+		GLuint* tri = &state.indices[t * 3];
+		if ( tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0] )
+		{
+			state.isTriangleRemoved[t] = true;
+			liveTriCount--;
+		}
+	}
+
+	CC3EdgeCollapseQueue queue;
+	for ( GLuint t = 0; t < triCount; t++ )
+	{
+		if ( state.isTriangleRemoved[t] )
+			continue;
+
+		for ( int e = 0; e < 3; e++ )
+		{
+			GLuint v1 = state.indices[t * 3 + e];
+			GLuint v2 = state.indices[t * 3 + ((e + 1) % 3)];
+			queueCollapse( state, queue, v1, v2 );
+			queueCollapse( state, queue, v2, v1 );
+		}
+	}
+
+	GLfloat ratio = CLAMP(triangleRatio, 0.0f, 1.0f);
+	GLuint targetTriCount = MAX((GLuint)(triCount * ratio), 1);
+	std::vector<GLuint> fromNeighbours, toNeighbours;
+	while ( liveTriCount > targetTriCount && !queue.empty() )
+	{
+		CC3EdgeCollapse collapse = queue.top();
+		queue.pop();
+
+		GLuint fromIdx = collapse.fromIndex;
+		GLuint toIdx = collapse.toIndex;
+		if ( state.isRemoved[fromIdx] || state.isRemoved[toIdx] ||
+			 collapse.fromVersion != state.versions[fromIdx] || collapse.toVersion != state.versions[toIdx] )
+			continue;		// Stale candidate
+
+		if ( !canCollapse( state, fromIdx, toIdx, m_minimumNormalAlignment, fromNeighbours, toNeighbours ) )
+			continue;
+
+		liveTriCount -= collapseEdge( state, fromIdx, toIdx );
+
+		// The quadric of the surviving vertex has changed, so requeue the edges around it
+		getNeighbours( state, toIdx, toNeighbours );
+		for ( size_t i = 0; i < toNeighbours.size(); i++ )
+		{
+			queueCollapse( state, queue, toNeighbours[i], toIdx );
+			queueCollapse( state, queue, toIdx, toNeighbours[i] );
+		}
+	}
+
+	if ( liveTriCount >= triCount )
+	{
+		CC3_TRACE( "CC3MeshSimplifier could not remove any of the %u triangles of %s", triCount, mesh->getName().c_str() );
+		return NULL;
+	}
+
+	CC3VertexIndices* lodIndices = CC3VertexIndices::vertexArray();
+	lodIndices->setDrawingMode( GL_TRIANGLES );
+	lodIndices->setElementType( vtxIndices->getElementType() );
+	lodIndices->setAllocatedVertexCapacity( liveTriCount * 3 );
+	GLuint lodIdx = 0;
+	for ( GLuint t = 0; t < triCount; t++ )
+	{
+		if ( state.isTriangleRemoved[t] )
+			continue;
+
+		for ( int j = 0; j < 3; j++ )
+			lodIndices->setIndex( state.indices[t * 3 + j], lodIdx++ );
+	}
+
+	// The simplified mesh shares all vertex arrays with the original
+	CC3Mesh* lodMesh = CC3Mesh::mesh();
+	lodMesh->setShouldInterleaveVertices( mesh->shouldInterleaveVertices() );
+	lodMesh->setVertexLocations( vtxLocs );
+	lodMesh->setVertexNormals( mesh->getVertexNormals() );
+	lodMesh->setVertexTangents( mesh->getVertexTangents() );
+	lodMesh->setVertexBitangents( mesh->getVertexBitangents() );
+	lodMesh->setVertexColors( mesh->getVertexColors() );
+	lodMesh->setVertexPointSizes( mesh->getVertexPointSizes() );
+	GLuint tcCount = mesh->getTextureCoordinatesArrayCount();
+	for ( GLuint texUnit = 0; texUnit < tcCount; texUnit++ )
+		lodMesh->addTextureCoordinates( mesh->getTextureCoordinatesForTextureUnit( texUnit ) );
+	lodMesh->setVertexIndices( lodIndices );
+
+	m_meshCount++;
+	m_triangleCountBefore += triCount;
+	m_triangleCountAfter += liveTriCount;
+
+	CC3_TRACE( "CC3MeshSimplifier simplified %s from %u triangles to %u, with a target of %u",
+		mesh->getName().c_str(), triCount, liveTriCount, targetTriCount );
+	return lodMesh;
+}
+
+bool CC3MeshSimplifier::init()
+{
+	m_minimumNormalAlignment = 0.2f;
+	resetStatistics();
+
+	return true;
+}
+
+CC3MeshSimplifier* CC3MeshSimplifier::simplifier()
+{
+	CC3MeshSimplifier* pSimplifier = new CC3MeshSimplifier;
+	pSimplifier->init();
+	pSimplifier->autorelease();
+
+	return pSimplifier;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,111 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_MESH_SIMPLIFIER_H_
+#define _CC3_MESH_SIMPLIFIER_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3Mesh;
+
+/**
+ * CC3MeshSimplifier creates reduced level-of-detail (LOD) versions of indexed triangle meshes,
+ * using quadric error metric edge collapse, as described by Garland and Heckbert.
+ *
+ * Each vertex accumulates the planes of the triangles around it into an error quadric. Edges are
+ * collapsed in order of increasing error, by moving one end of the edge onto the other, until the
+ * requested number of triangles remain. Because each collapse moves a vertex onto an existing
+ * vertex, no new vertices are created, and the simplified mesh shares all of its vertex arrays
+ * with the original mesh. Only the vertex indices of the simplified mesh are new, which keeps the
+ * memory cost of each level of detail small.
+ *
+ * To avoid opening cracks in the mesh, vertices on the border of the mesh, and vertices that share
+ * their location with other vertices, such as along texture or normal seams, are never moved. As a
+ * result, meshes that are made of many separate pieces, or that have no shared vertices at all,
+ * such as flat-shaded meshes, cannot be reduced much. Collapses that would flip the facing of a
+ * triangle, or join two sides of the mesh together, are also rejected.
+ *
+ * Only meshes drawn as triangles, using vertex indices, and whose vertex content is in memory, can
+ * be simplified. Meshes that contain triangle strips, or bone weights and indices, are not simplified,
+ * because the triangles of each skin section of a skinned mesh must remain contiguous.
+ *
+ * Simplification can be performed when a model is loaded, for example by invoking the
+ * generateLODMeshes:withTriangleRatio: method on the nodes of a CC3PODResource, or offline.
+ */
+class CC3MeshSimplifier : public CCObject
+{
+public:
+	CC3MeshSimplifier();
+	virtual ~CC3MeshSimplifier();
+
+	/**
+	 * The minimum dot product between the normal of each triangle before and after an edge collapse.
+	 * Collapses that rotate any triangle further than this are rejected. A value of zero rejects only
+	 * collapses that flip triangles over, while values closer to one better preserve surface detail,
+	 * at the cost of less reduction.
+	 *
+	 * The initial value of this property is 0.2.
+	 */
+	GLfloat						getMinimumNormalAlignment();
+	void						setMinimumNormalAlignment( GLfloat alignment );
+
+	/**
+	 * Returns a new mesh that shares the vertex arrays of the specified mesh, and whose vertex
+	 * indices describe a simplified version of the triangles of the specified mesh, containing
+	 * approximately the specified fraction of its triangles. The triangle ratio is clamped to
+	 * the range between zero and one.
+	 *
+	 * Returns NULL if the specified mesh cannot be simplified, as described in the notes for this
+	 * class, or if none of its triangles could be removed. The returned mesh is autoreleased.
+	 */
+	CC3Mesh*					simplifyMesh( CC3Mesh* mesh, GLfloat triangleRatio );
+
+	/** The number of meshes simplified since the statistics were last reset. */
+	GLuint						getMeshCount();
+
+	/** The number of triangles in the meshes simplified since the statistics were last reset, before they were simplified. */
+	GLuint						getTriangleCountBefore();
+
+	/** The number of triangles in the meshes created since the statistics were last reset. */
+	GLuint						getTriangleCountAfter();
+
+	/** Resets the statistics accumulated from the meshes simplified by this instance. */
+	void						resetStatistics();
+
+	virtual bool				init();
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3MeshSimplifier*	simplifier();
+
+protected:
+	GLfloat						m_minimumNormalAlignment;
+	GLuint						m_meshCount;
+	GLuint						m_triangleCountBefore;
+	GLuint						m_triangleCountAfter;
+};
+
+NS_COCOS3D_END
+
+#endif
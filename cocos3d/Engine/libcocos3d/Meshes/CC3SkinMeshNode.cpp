@@ -37,6 +37,7 @@ CC3SkinMeshNode::CC3SkinMeshNode()
 	m_pSkeletalTransformMatrix = NULL;
 	m_pSkeletalTransformMatrixInverted = NULL;
 	m_deformedFaces = NULL;
+	m_pSoftwareSkinner = NULL;
 }
 
 CC3SkinMeshNode::~CC3SkinMeshNode()
@@ -45,6 +46,7 @@ CC3SkinMeshNode::~CC3SkinMeshNode()
 	CC_SAFE_RELEASE( m_pSkeletalTransformMatrix );
 	CC_SAFE_RELEASE( m_pSkeletalTransformMatrixInverted );
 	CC_SAFE_RELEASE( m_deformedFaces );
+	CC_SAFE_RELEASE( m_pSoftwareSkinner );
 }
 
 CCArray* CC3SkinMeshNode::getSkinSections()
@@ -122,6 +124,23 @@ void CC3SkinMeshNode::setDeformedFaces( CC3DeformedFaceArray* aFaceArray )
 	m_deformedFaces->setNode( this );
 }
 
+CC3SoftwareSkinner* CC3SkinMeshNode::getSoftwareSkinner()
+{
+	if ( !m_pSoftwareSkinner )
+		setSoftwareSkinner( CC3SoftwareSkinner::skinnerForNode( this ) );
+	return m_pSoftwareSkinner;
+}
+
+void CC3SkinMeshNode::setSoftwareSkinner( CC3SoftwareSkinner* aSkinner )
+{
+	if (aSkinner == m_pSoftwareSkinner) 
+		return;
+
+	CC_SAFE_RELEASE( m_pSoftwareSkinner );
+	m_pSoftwareSkinner = aSkinner;
+	CC_SAFE_RETAIN( m_pSoftwareSkinner );
+}
+
 CC3Face CC3SkinMeshNode::getDeformedFaceAt( GLuint faceIndex )
 {
 	return getDeformedFaces()->getFaceAt( faceIndex ); 
@@ -158,6 +177,7 @@ void CC3SkinMeshNode::initWithTag( GLuint aTag, const std::string& aName )
 		m_pSkeletalTransformMatrixInverted = CC3AffineMatrix::matrix();// retained
 		m_pSkeletalTransformMatrixInverted->retain();
 		m_deformedFaces = NULL;
+		m_pSoftwareSkinner = NULL;
 	}
 }
 
@@ -165,8 +185,8 @@ void CC3SkinMeshNode::populateFrom( CC3SkinMeshNode* another )
 {
 	super::populateFrom( another );
 
-	// The deformedFaces instance is not copied, since the deformed faces
-	// are different for each mesh node and is created lazily if needed.
+	// The deformedFaces and softwareSkinner instances are not copied, since the deformed
+	// vertices are different for each mesh node and are created lazily if needed.
 	// The skeletal transform matrices are not copied
 
 	m_skinSections->removeAllObjects();
@@ -214,6 +234,8 @@ void CC3SkinMeshNode::markTransformDirty()
 
 	if ( m_deformedFaces )
 		m_deformedFaces->clearDeformableCaches();
+	if ( m_pSoftwareSkinner )
+		m_pSoftwareSkinner->markDeformationDirty();
 }
 
 CC3Matrix* CC3SkinMeshNode::getSkeletalTransformMatrix()
@@ -242,6 +264,8 @@ void CC3SkinMeshNode::boneWasTransformed( CC3Bone* aBone )
 {
 	if ( m_deformedFaces )
 		m_deformedFaces->clearDeformableCaches(); 
+	if ( m_pSoftwareSkinner )
+		m_pSoftwareSkinner->markDeformationDirty();
 }
 
 /**
@@ -35,6 +35,7 @@ NS_COCOS3D_BEGIN
 class CC3Bone;
 class CC3SkinSection;
 class CC3DeformedFaceArray;
+class CC3SoftwareSkinner;
 
 /**
  * CC3SkinMeshNode is a CC3MeshNode specialized to use vertex skinning to draw the contents
@@ -153,6 +154,21 @@ public:
 	 */
 	void						boneWasTransformed( CC3Bone* aBone );
 
+	/**
+	 * Returns the software skinner that deforms the vertices of this mesh on the CPU, lazily
+	 * creating it on first access.
+	 *
+	 * The software skinner provides the deformed vertex locations and normals of the whole mesh,
+	 * and the bounding box of the deformed mesh, without requiring the mesh to be drawn. It is
+	 * also used to populate the deformed vertex cache of the deformedFaces property.
+	 *
+	 * The software skinner reads vertex content from the mesh. If the mesh is buffered to GL,
+	 * invoke the retainVertexLocations, retainVertexNormals, retainVertexBoneWeights and
+	 * retainVertexBoneIndices methods before the vertex content is released.
+	 */
+	CC3SoftwareSkinner*			getSoftwareSkinner();
+	void						setSoftwareSkinner( CC3SoftwareSkinner* aSkinner );
+
 	bool						hasSkeleton();
 	bool						hasRigidSkeleton();
 	void						ensureRigidSkeleton();
@@ -199,6 +215,7 @@ protected:
 	CC3Matrix*					m_pSkeletalTransformMatrix;
 	CC3Matrix*					m_pSkeletalTransformMatrixInverted;
 	CC3DeformedFaceArray*		m_deformedFaces;
+	CC3SoftwareSkinner*			m_pSoftwareSkinner;
 };
 
 NS_COCOS3D_END
@@ -0,0 +1,345 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+/** Marks a vertex that is not referenced by any skin section. */
+#define kCC3SoftwareSkinnerNoSection	(-1)
+
+/** A range of vertices deformed by a single thread. */
+typedef struct
+{
+	CC3SoftwareSkinner*		skinner;
+	GLuint					vtxStart;
+	GLuint					vtxEnd;
+	CC3Vector*				locations;
+	CC3Vector*				normals;
+} CC3SoftwareSkinnerJob;
+
+static void runSoftwareSkinnerJob( void* arg )
+{
+	CC3SoftwareSkinnerJob* job = (CC3SoftwareSkinnerJob*)arg;
+	job->skinner->deformVertexRange( job->vtxStart, job->vtxEnd, job->locations, job->normals );
+}
+
+/**
+ * Accumulates the specified bone matrix, scaled by the specified weight, into the blended
+ * matrix. The 12 elements of a 4x3 matrix fit exactly into three 4-element vector registers.
+ */
+static inline void blendBoneMatrix( GLfloat* blended, const CC3Matrix4x3* boneMtx, GLfloat weight )
+{
+	const GLfloat* e = boneMtx->elements;
+	CC3Float4 w = f4Splat( weight );
+	f4Store( blended, f4MulAdd( f4Load( blended ), f4Load( e ), w ) );
+	f4Store( blended + 4, f4MulAdd( f4Load( blended + 4 ), f4Load( e + 4 ), w ) );
+	f4Store( blended + 8, f4MulAdd( f4Load( blended + 8 ), f4Load( e + 8 ), w ) );
+}
+
+CC3SoftwareSkinner::CC3SoftwareSkinner()
+{
+	m_pNode = NULL;
+}
+
+CC3SoftwareSkinner::~CC3SoftwareSkinner()
+{
+	m_pNode = NULL;			// weak reference
+}
+
+CC3SkinMeshNode* CC3SoftwareSkinner::getNode()
+{
+	return m_pNode;
+}
+
+GLuint CC3SoftwareSkinner::getVertexCount()
+{
+	CC3Mesh* mesh = m_pNode ? m_pNode->getMesh() : NULL;
+	return mesh ? mesh->getVertexCount() : 0;
+}
+
+bool CC3SoftwareSkinner::shouldDeformNormals()
+{
+	return m_shouldDeformNormals;
+}
+
+void CC3SoftwareSkinner::setShouldDeformNormals( bool shouldDeform )
+{
+	m_shouldDeformNormals = shouldDeform;
+	markDeformationDirty();
+}
+
+GLuint CC3SoftwareSkinner::getMaxThreads()
+{
+	return m_maxThreads;
+}
+
+void CC3SoftwareSkinner::setMaxThreads( GLuint maxThreads )
+{
+	m_maxThreads = MAX(maxThreads, 1);
+}
+
+GLuint CC3SoftwareSkinner::getMinParallelVertexCount()
+{
+	return m_minParallelVertexCount;
+}
+
+void CC3SoftwareSkinner::setMinParallelVertexCount( GLuint vertexCount )
+{
+	m_minParallelVertexCount = MAX(vertexCount, 1);
+}
+
+void CC3SoftwareSkinner::markDeformationDirty()
+{
+	m_deformationIsDirty = true;
+}
+
+void CC3SoftwareSkinner::markSkinSectionsDirty()
+{
+	m_vertexSectionsAreDirty = true;
+	m_deformationIsDirty = true;
+}
+
+CC3Vector* CC3SoftwareSkinner::getDeformedVertexLocations()
+{
+	GLuint vtxCount = getVertexCount();
+	if ( vtxCount == 0 )
+		return NULL;
+
+	bool wantsNormals = m_shouldDeformNormals && m_pNode->getMesh()->hasVertexNormals();
+	if ( m_deformationIsDirty || m_deformedLocations.size() != vtxCount ||
+		 (wantsNormals && m_deformedNormals.size() != vtxCount) )
+	{
+		m_deformedLocations.resize( vtxCount );
+		if ( wantsNormals )
+			m_deformedNormals.resize( vtxCount );
+		else
+			m_deformedNormals.clear();
+
+		deformVertices( &m_deformedLocations[0], wantsNormals ? &m_deformedNormals[0] : NULL );
+		m_deformationIsDirty = false;
+	}
+	return &m_deformedLocations[0];
+}
+
+CC3Vector* CC3SoftwareSkinner::getDeformedVertexNormals()
+{
+	getDeformedVertexLocations();
+	return m_deformedNormals.empty() ? NULL : &m_deformedNormals[0];
+}
+
+CC3Box CC3SoftwareSkinner::getDeformedBoundingBox()
+{
+	CC3Vector* locs = getDeformedVertexLocations();
+	if ( !locs )
+		return CC3Box::kCC3BoxNull;
+
+	CC3Vector vMin = locs[0];
+	CC3Vector vMax = locs[0];
+	GLuint vtxCount = getVertexCount();
+	for (GLuint vtxIdx = 1; vtxIdx < vtxCount; vtxIdx++)
+	{
+		vMin = vMin.minimize( locs[vtxIdx] );
+		vMax = vMax.maxmize( locs[vtxIdx] );
+	}
+	return CC3Box( vMin, vMax );
+}
+
+/**
+ * Builds the mapping from each vertex to the skin section that deforms it. Skin sections are
+ * assigned to contiguous ranges of vertex indices. If the mesh is indexed, a vertex is deformed
+ * by the first skin section that references it, which matches CC3DeformedFaceArray.
+ */
+void CC3SoftwareSkinner::buildVertexSections()
+{
+	CC3Mesh* mesh = m_pNode->getMesh();
+	GLuint vtxCount = mesh->getVertexCount();
+	m_vertexSections.assign( vtxCount, kCC3SoftwareSkinnerNoSection );
+
+	GLuint vtxIdxCount = mesh->getVertexIndexCount();
+	bool meshIsIndexed = (vtxIdxCount > 0);
+	if ( !meshIsIndexed )
+		vtxIdxCount = vtxCount;
+
+	CCArray* skinSections = m_pNode->getSkinSections();
+	GLuint ssCount = skinSections->count();
+	for (GLuint ssIdx = 0; ssIdx < ssCount; ssIdx++)
+	{
+		CC3SkinSection* ss = (CC3SkinSection*)skinSections->objectAtIndex( ssIdx );
+		GLuint vtxIdxStart = MIN((GLuint)MAX(ss->getVertexStart(), 0), vtxIdxCount);
+		GLuint vtxIdxEnd = MIN(vtxIdxStart + (GLuint)MAX(ss->getVertexCount(), 0), vtxIdxCount);
+		for (GLuint vtxIdxPos = vtxIdxStart; vtxIdxPos < vtxIdxEnd; vtxIdxPos++)
+		{
+			GLuint vtxIdx = meshIsIndexed ? mesh->getVertexIndexAt( vtxIdxPos ) : vtxIdxPos;
+			if ( vtxIdx < vtxCount && m_vertexSections[vtxIdx] == kCC3SoftwareSkinnerNoSection )
+				m_vertexSections[vtxIdx] = ssIdx;
+		}
+	}
+	m_vertexSectionsAreDirty = false;
+}
+
+/**
+ * Collects the current transform matrix of each bone of each skin section into a single
+ * contiguous palette. This must run on the calling thread, because retrieving the bone
+ * transform matrices lazily recalculates them.
+ */
+void CC3SoftwareSkinner::buildBonePalette()
+{
+	CCArray* skinSections = m_pNode->getSkinSections();
+	GLuint ssCount = skinSections->count();
+	m_sectionPaletteOffsets.resize( ssCount );
+	m_sectionBoneCounts.resize( ssCount );
+	m_bonePalette.clear();
+
+	for (GLuint ssIdx = 0; ssIdx < ssCount; ssIdx++)
+	{
+		CC3SkinSection* ss = (CC3SkinSection*)skinSections->objectAtIndex( ssIdx );
+		GLuint boneCount = ss->getBoneCount();
+		m_sectionPaletteOffsets[ssIdx] = (GLuint)m_bonePalette.size();
+		m_sectionBoneCounts[ssIdx] = boneCount;
+		for (GLuint boneIdx = 0; boneIdx < boneCount; boneIdx++)
+		{
+			CC3Matrix4x3 boneMtx;
+			ss->getTransformMatrixForBoneAt( boneIdx )->populateCC3Matrix4x3( &boneMtx );
+			m_bonePalette.push_back( boneMtx );
+		}
+	}
+}
+
+void CC3SoftwareSkinner::deformVertices( CC3Vector* locations, CC3Vector* normals )
+{
+	GLuint vtxCount = getVertexCount();
+	if ( vtxCount == 0 || (!locations && !normals) )
+		return;
+
+	if ( !m_pNode->getMesh()->hasVertexNormals() )
+		normals = NULL;
+
+	if ( m_vertexSectionsAreDirty || m_vertexSections.size() != vtxCount )
+		buildVertexSections();
+
+	buildBonePalette();
+
+	// Split the vertices into one range per thread
+	GLuint threadCount = MIN(m_maxThreads, MAX(vtxCount / m_minParallelVertexCount, 1));
+	threadCount = MAX(threadCount, 1);
+	if ( threadCount == 1 )
+	{
+		deformVertexRange( 0, vtxCount, locations, normals );
+		return;
+	}
+
+	GLuint rangeSize = (vtxCount + threadCount - 1) / threadCount;
+	std::vector<CC3SoftwareSkinnerJob> jobs( threadCount );
+	for (GLuint tIdx = 0; tIdx < threadCount; tIdx++)
+	{
+		CC3SoftwareSkinnerJob& job = jobs[tIdx];
+		job.skinner = this;
+		job.vtxStart = MIN(tIdx * rangeSize, vtxCount);
+		job.vtxEnd = MIN(job.vtxStart + rangeSize, vtxCount);
+		job.locations = locations;
+		job.normals = normals;
+	}
+
+	CC3WorkerPool::sharedWorkerPool()->runJobs( runSoftwareSkinnerJob, &jobs[0], threadCount, sizeof(CC3SoftwareSkinnerJob) );
+}
+
+void CC3SoftwareSkinner::deformVertexRange( GLuint vtxStart, GLuint vtxEnd, CC3Vector* locations, CC3Vector* normals )
+{
+	CC3Mesh* mesh = m_pNode->getMesh();
+	GLuint vuCnt = mesh->getVertexBoneCount();
+	CC3VertexBoneIndices* boneIndices = mesh->getVertexBoneIndices();
+	bool hasWeights = (mesh->getVertexBoneWeights() != NULL) && (boneIndices != NULL);
+	bool shortIndices = hasWeights && (boneIndices->getElementType() == GL_UNSIGNED_SHORT);
+
+	for (GLuint vtxIdx = vtxStart; vtxIdx < vtxEnd; vtxIdx++)
+	{
+		CC3Vector restLoc = mesh->getVertexLocationAt( vtxIdx );
+		CC3Vector restNorm = normals ? mesh->getVertexNormalAt( vtxIdx ) : CC3Vector::kCC3VectorZero;
+
+		GLint ssIdx = m_vertexSections[vtxIdx];
+		if ( ssIdx == kCC3SoftwareSkinnerNoSection || !hasWeights )
+		{
+			if ( locations ) locations[vtxIdx] = restLoc;
+			if ( normals ) normals[vtxIdx] = restNorm;
+			continue;
+		}
+
+		// Blend the bone matrices of this vertex by the vertex weights
+		const CC3Matrix4x3* sectionBones = &m_bonePalette[0] + m_sectionPaletteOffsets[ssIdx];
+		GLuint sectionBoneCount = m_sectionBoneCounts[ssIdx];
+		GLfloat* weights = mesh->getVertexBoneWeightsAt( vtxIdx );
+		GLvoid* indices = mesh->getVertexBoneIndicesAt( vtxIdx );
+		GLfloat blended[kCC3Matrix4x3ElementCount] = { 0.0f };
+		for (GLuint vuIdx = 0; vuIdx < vuCnt; vuIdx++)
+		{
+			GLfloat weight = weights[vuIdx];
+			if ( weight == 0.0f )
+				continue;
+			GLuint boneIdx = shortIndices ? ((GLushort*)indices)[vuIdx] : ((GLubyte*)indices)[vuIdx];
+			if ( boneIdx < sectionBoneCount )
+				blendBoneMatrix( blended, &sectionBones[boneIdx], weight );
+		}
+
+		// Transform the rest pose by the blended matrix, which is stored column-major
+		if ( locations )
+		{
+			CC3Vector defLoc;
+			defLoc.x = (blended[0] * restLoc.x) + (blended[3] * restLoc.y) + (blended[6] * restLoc.z) + blended[9];
+			defLoc.y = (blended[1] * restLoc.x) + (blended[4] * restLoc.y) + (blended[7] * restLoc.z) + blended[10];
+			defLoc.z = (blended[2] * restLoc.x) + (blended[5] * restLoc.y) + (blended[8] * restLoc.z) + blended[11];
+			locations[vtxIdx] = defLoc;
+		}
+		if ( normals )
+		{
+			CC3Vector defNorm;
+			defNorm.x = (blended[0] * restNorm.x) + (blended[3] * restNorm.y) + (blended[6] * restNorm.z);
+			defNorm.y = (blended[1] * restNorm.x) + (blended[4] * restNorm.y) + (blended[7] * restNorm.z);
+			defNorm.z = (blended[2] * restNorm.x) + (blended[5] * restNorm.y) + (blended[8] * restNorm.z);
+			normals[vtxIdx] = defNorm.normalize();
+		}
+	}
+}
+
+void CC3SoftwareSkinner::initForNode( CC3SkinMeshNode* aNode )
+{
+	m_pNode = aNode;							// weak reference
+	m_maxThreads = 4;
+	m_minParallelVertexCount = 4096;
+	m_shouldDeformNormals = true;
+	m_deformationIsDirty = true;
+	m_vertexSectionsAreDirty = true;
+}
+
+CC3SoftwareSkinner* CC3SoftwareSkinner::skinnerForNode( CC3SkinMeshNode* aNode )
+{
+	CC3SoftwareSkinner* pSkinner = new CC3SoftwareSkinner;
+	pSkinner->initForNode( aNode );
+	pSkinner->autorelease();
+
+	return pSkinner;
+}
+
+NS_COCOS3D_END
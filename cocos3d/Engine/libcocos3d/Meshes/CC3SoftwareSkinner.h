@@ -0,0 +1,184 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_SOFTWARE_SKINNER_H_
+#define _CC3_SOFTWARE_SKINNER_H_
+NS_COCOS3D_BEGIN
+
+class CC3SkinMeshNode;
+
+/**
+ * CC3SoftwareSkinner deforms all of the vertex locations and normals of a CC3SkinMeshNode
+ * on the CPU, in a single batched pass, using the current transforms of the bones that
+ * influence each skin section of the mesh.
+ *
+ * Normally, skinning is performed by the GPU while drawing, and the deformed vertices are
+ * never visible to the application. A software skinner makes the deformed mesh available
+ * to the application, for tasks such as calculating the bounding box of the deformed mesh,
+ * hit-testing against deformed faces, or running skinned content on a server that never
+ * draws the mesh at all.
+ *
+ * The deformation of each vertex blends the bone matrices by the vertex weights, and then
+ * transforms the rest-pose location and normal of the vertex by the blended matrix. Blending
+ * uses SSE2 or NEON instructions when enabled by the CC3_SIMD_SSE or CC3_SIMD_NEON build setting.
+ * Large meshes are split across the threads of the shared CC3WorkerPool, as determined by the
+ * maxThreads and minParallelVertexCount properties.
+ *
+ * The deformed vertices are recalculated lazily, the first time they are accessed after the
+ * skin mesh node or any of its bones have been transformed. The bone matrices are collected
+ * on the calling thread before the vertices are handed to the worker threads, so this class
+ * should be used from the thread that updates the scene.
+ *
+ * The skinner reads the vertex locations, normals, bone weights and bone indices from the
+ * mesh, and does not retain that vertex content itself. If the mesh is buffered to GL, invoke
+ * the retainVertexLocations, retainVertexNormals, retainVertexBoneWeights and
+ * retainVertexBoneIndices methods of the skin mesh node before the vertex content is released.
+ */
+class CC3SoftwareSkinner : public CCObject
+{
+public:
+	CC3SoftwareSkinner();
+	virtual ~CC3SoftwareSkinner();
+
+	/** The skin mesh node whose vertices are deformed by this instance. */
+	CC3SkinMeshNode*			getNode();
+
+	/** Returns the number of vertices in the mesh of the skin mesh node. */
+	GLuint						getVertexCount();
+
+	/**
+	 * Indicates whether the vertex normals should be deformed along with the vertex locations.
+	 *
+	 * Normals are only deformed if the mesh contains vertex normals.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldDeformNormals();
+	void						setShouldDeformNormals( bool shouldDeform );
+
+	/**
+	 * Specifies the maximum number of threads used to deform the vertices, including the
+	 * calling thread. Setting this property to one deforms all vertices on the calling thread.
+	 *
+	 * The initial value of this property is four.
+	 */
+	GLuint						getMaxThreads();
+	void						setMaxThreads( GLuint maxThreads );
+
+	/**
+	 * Specifies the minimum number of vertices that each deformation thread must be given before
+	 * the work is split across threads. Meshes with fewer vertices than this are deformed on the
+	 * calling thread, because the cost of handing work to other threads would exceed the savings.
+	 *
+	 * The initial value of this property is 4096.
+	 */
+	GLuint						getMinParallelVertexCount();
+	void						setMinParallelVertexCount( GLuint vertexCount );
+
+	/**
+	 * Returns the vertex locations of the mesh, deformed by the current transforms of the bones,
+	 * and expressed in the local coordinate system of the skin mesh node. The returned array
+	 * contains the number of elements indicated by the vertexCount property.
+	 *
+	 * The deformed locations are lazily recalculated if the skin mesh node or any of its bones
+	 * have been transformed since the last access. The returned array is managed by this
+	 * instance, and remains valid until the next recalculation.
+	 */
+	CC3Vector*					getDeformedVertexLocations();
+
+	/**
+	 * Returns the vertex normals of the mesh, deformed by the current transforms of the bones,
+	 * and expressed in the local coordinate system of the skin mesh node. The returned array
+	 * contains the number of elements indicated by the vertexCount property.
+	 *
+	 * Returns NULL if the mesh has no vertex normals, or if the shouldDeformNormals property
+	 * is set to NO.
+	 */
+	CC3Vector*					getDeformedVertexNormals();
+
+	/**
+	 * Returns the bounding box of the deformed vertex locations, in the local coordinate system
+	 * of the skin mesh node. Returns kCC3BoxNull if the mesh contains no vertices.
+	 */
+	CC3Box						getDeformedBoundingBox();
+
+	/**
+	 * Deforms the vertex locations and normals of the mesh, using the current bone transforms,
+	 * and writes the results into the specified arrays, which must each be large enough to hold
+	 * the number of vertices indicated by the vertexCount property.
+	 *
+	 * Either array may be NULL, in which case the corresponding content is not deformed. Vertices
+	 * that are not referenced by any skin section are copied from the rest pose.
+	 *
+	 * This method does not make use of, or update, the deformedVertexLocations and
+	 * deformedVertexNormals properties, and can be used to populate external buffers.
+	 */
+	void						deformVertices( CC3Vector* locations, CC3Vector* normals );
+
+	/**
+	 * Marks the deformed vertices as dirty, so that they will be recalculated on next access.
+	 *
+	 * This method is invoked automatically when the skin mesh node or any of its bones are
+	 * transformed. Usually, the application never needs to invoke this method directly.
+	 */
+	void						markDeformationDirty();
+
+	/**
+	 * Marks the mapping of vertices to skin sections as dirty, so that it will be rebuilt on the
+	 * next deformation. Invoke this method if the skin sections or vertex indices of the mesh change.
+	 */
+	void						markSkinSectionsDirty();
+
+	/** Initializes this instance to deform the vertices of the specified skin mesh node. */
+	void						initForNode( CC3SkinMeshNode* aNode );
+
+	/** Allocates and initializes an instance to deform the vertices of the specified skin mesh node. */
+	static CC3SoftwareSkinner*	skinnerForNode( CC3SkinMeshNode* aNode );
+
+	/** Deforms the vertices within the specified range. Invoked on each deformation thread. */
+	void						deformVertexRange( GLuint vtxStart, GLuint vtxEnd, CC3Vector* locations, CC3Vector* normals );
+
+protected:
+	void						buildVertexSections();
+	void						buildBonePalette();
+
+protected:
+	CC3SkinMeshNode*			m_pNode;
+	std::vector<CC3Matrix4x3>	m_bonePalette;
+	std::vector<GLuint>			m_sectionPaletteOffsets;
+	std::vector<GLuint>			m_sectionBoneCounts;
+	std::vector<GLint>			m_vertexSections;
+	std::vector<CC3Vector>		m_deformedLocations;
+	std::vector<CC3Vector>		m_deformedNormals;
+	GLuint						m_maxThreads;
+	GLuint						m_minParallelVertexCount;
+	bool						m_shouldDeformNormals : 1;
+	bool						m_deformationIsDirty : 1;
+	bool						m_vertexSectionsAreDirty : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
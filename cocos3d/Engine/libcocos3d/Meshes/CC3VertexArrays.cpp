@@ -156,6 +156,194 @@ bool CC3VertexArray::shouldNormalizeContent()
 	return m_shouldNormalizeContent;
 }
 
+GLuint CC3VertexArray::getInstanceDivisor()
+{
+	return m_instanceDivisor;
+}
+
+void CC3VertexArray::setInstanceDivisor( GLuint divisor )
+{
+	m_instanceDivisor = divisor;
+}
+
+CC3VertexQuantization CC3VertexArray::getQuantization()
+{
+	return m_quantization;
+}
+
+bool CC3VertexArray::isQuantized()
+{
+	return m_quantization != kCC3VertexQuantizationNone;
+}
+
+CC3VertexQuantization CC3VertexArray::getPreferredQuantization()
+{
+	return m_preferredQuantization;
+}
+
+void CC3VertexArray::setPreferredQuantization( CC3VertexQuantization quantization )
+{
+	m_preferredQuantization = quantization;
+}
+
+CC3VertexQuantization CC3VertexArray::defaultPreferredQuantization()
+{
+	return kCC3VertexQuantizationNone;
+}
+
+bool CC3VertexArray::canQuantizeContent()
+{
+	return m_preferredQuantization != kCC3VertexQuantizationNone && !isQuantized() &&
+		   m_elementType == GL_FLOAT && m_elementSize > 0 && m_elementSize <= 3 && m_vertices;
+}
+
+/** Returns the number of components in each element once quantized into the specified format, including padding. */
+static GLint quantizedComponentCount( CC3VertexQuantization quantization, GLint elementSize )
+{
+	switch ( quantization )
+	{
+		case kCC3VertexQuantizationUnsignedShort:
+			return (elementSize + 1) & ~1;		// Pad to four-byte boundary
+		case kCC3VertexQuantizationByte:
+			return 4;
+		default:
+			return elementSize;
+	}
+}
+
+GLuint CC3VertexArray::getQuantizedElementLength()
+{
+	if ( !canQuantizeContent() )
+		return getElementLength();
+
+	GLenum qType = (m_preferredQuantization == kCC3VertexQuantizationByte) ? GL_BYTE : GL_UNSIGNED_SHORT;
+	return (GLuint)CC3GLElementTypeSize(qType) * quantizedComponentCount( m_preferredQuantization, m_elementSize );
+}
+
+CC3Vector CC3VertexArray::getDequantizationScale()
+{
+	return m_dequantizationScale;
+}
+
+CC3Vector CC3VertexArray::getDequantizationOffset()
+{
+	return m_dequantizationOffset;
+}
+
+/**
+ * Quantizes the specified normalized value into the specified format. Unsigned values are
+ * normalized to the range 0 to 1, and signed values to the range -1 to +1.
+ */
+static GLint quantizeNormalizedValue( CC3VertexQuantization quantization, GLfloat value )
+{
+	if ( quantization == kCC3VertexQuantizationByte )
+		return (GLint)floorf( CLAMP(value, -1.0f, 1.0f) * 127.0f + 0.5f );
+	return (GLint)floorf( CLAMP(value, 0.0f, 1.0f) * 65535.0f + 0.5f );
+}
+
+void CC3VertexArray::packContentInto( GLvoid* dstVertices, GLuint dstStride )
+{
+	GLuint vtxCount = m_vertexCount;
+	GLuint elemLen = getElementLength();
+	if ( !canQuantizeContent() )
+	{
+		for ( GLuint v = 0; v < vtxCount; v++ )
+			memcpy( (GLubyte*)dstVertices + (v * dstStride), getAddressOfElement( v ), elemLen );
+		return;
+	}
+
+	// Establish the bounds of each component. Signed unit vectors need no scale or offset.
+	GLfloat compMin[3] = { 0.0f, 0.0f, 0.0f };
+	GLfloat compMax[3] = { 0.0f, 0.0f, 0.0f };
+	if ( m_preferredQuantization == kCC3VertexQuantizationUnsignedShort )
+	{
+		for ( GLint c = 0; c < m_elementSize; c++ )
+		{
+			compMin[c] = kCC3MaxGLfloat;
+			compMax[c] = -kCC3MaxGLfloat;
+		}
+		for ( GLuint v = 0; v < vtxCount; v++ )
+		{
+			const GLfloat* pComps = (const GLfloat*)getAddressOfElement( v );
+			for ( GLint c = 0; c < m_elementSize; c++ )
+			{
+				compMin[c] = MIN(compMin[c], pComps[c]);
+				compMax[c] = MAX(compMax[c], pComps[c]);
+			}
+		}
+	}
+
+	GLfloat scale[3] = { 1.0f, 1.0f, 1.0f };
+	GLfloat offset[3] = { 0.0f, 0.0f, 0.0f };
+	if ( m_preferredQuantization == kCC3VertexQuantizationUnsignedShort )
+	{
+		for ( GLint c = 0; c < m_elementSize; c++ )
+		{
+			GLfloat range = compMax[c] - compMin[c];
+			scale[c] = (range > 0.0f) ? range : 1.0f;
+			offset[c] = compMin[c];
+		}
+	}
+	m_dequantizationScale = cc3v( scale[0], scale[1], scale[2] );
+	m_dequantizationOffset = cc3v( offset[0], offset[1], offset[2] );
+
+	// Padding components decode to one for unsigned content, so homogeneous locations have w = 1
+	GLint qCompCount = quantizedComponentCount( m_preferredQuantization, m_elementSize );
+	for ( GLuint v = 0; v < vtxCount; v++ )
+	{
+		const GLfloat* pComps = (const GLfloat*)getAddressOfElement( v );
+		GLubyte* pDst = (GLubyte*)dstVertices + (v * dstStride);
+		for ( GLint c = 0; c < qCompCount; c++ )
+		{
+			GLfloat normVal = (c < m_elementSize) ? (pComps[c] - offset[c]) / scale[c] : 1.0f;
+			if ( m_preferredQuantization == kCC3VertexQuantizationByte )
+				((GLbyte*)pDst)[c] = (c < m_elementSize) ? (GLbyte)quantizeNormalizedValue( m_preferredQuantization, normVal ) : 0;
+			else
+				((GLushort*)pDst)[c] = (GLushort)quantizeNormalizedValue( m_preferredQuantization, normVal );
+		}
+	}
+}
+
+void CC3VertexArray::adoptQuantizedFormat()
+{
+	if ( !canQuantizeContent() )
+		return;
+
+	m_elementSize = quantizedComponentCount( m_preferredQuantization, m_elementSize );
+	m_elementType = (m_preferredQuantization == kCC3VertexQuantizationByte) ? GL_BYTE : GL_UNSIGNED_SHORT;
+	m_shouldNormalizeContent = true;
+	m_quantization = m_preferredQuantization;
+}
+
+void CC3VertexArray::getDequantizedElementAt( GLuint index, GLfloat* components )
+{
+	GLvoid* pElem = getAddressOfElement( index );
+	const GLfloat* scale = (const GLfloat*)&m_dequantizationScale;
+	const GLfloat* offset = (const GLfloat*)&m_dequantizationOffset;
+	for ( GLint c = 0; c < m_elementSize && c < 4; c++ )
+	{
+		GLfloat normVal = (m_quantization == kCC3VertexQuantizationByte)
+							? MAX(((GLbyte*)pElem)[c] / 127.0f, -1.0f)
+							: ((GLushort*)pElem)[c] / 65535.0f;
+		components[c] = (c < 3) ? (normVal * scale[c]) + offset[c] : normVal;
+	}
+}
+
+void CC3VertexArray::setQuantizedElement( const GLfloat* components, GLuint index )
+{
+	GLvoid* pElem = getAddressOfElement( index );
+	const GLfloat* scale = (const GLfloat*)&m_dequantizationScale;
+	const GLfloat* offset = (const GLfloat*)&m_dequantizationOffset;
+	for ( GLint c = 0; c < m_elementSize && c < 3; c++ )
+	{
+		GLint qVal = quantizeNormalizedValue( m_quantization, (components[c] - offset[c]) / scale[c] );
+		if ( m_quantization == kCC3VertexQuantizationByte )
+			((GLbyte*)pElem)[c] = (GLbyte)qVal;
+		else
+			((GLushort*)pElem)[c] = (GLushort)qVal;
+	}
+}
+
 bool CC3VertexArray::shouldReleaseRedundantContent()
 {
 	return m_shouldReleaseRedundantContent;
@@ -258,7 +446,13 @@ void CC3VertexArray::initWithTag( GLuint aTag, const std::string& aName )
 		m_shouldNormalizeContent = false;
 		m_shouldAllowVertexBuffering = true;
 		m_shouldReleaseRedundantContent = true;
+		m_isMappedContent = false;
 		m_semantic = defaultSemantic();
+		m_instanceDivisor = 0;
+		m_quantization = kCC3VertexQuantizationNone;
+		m_preferredQuantization = defaultPreferredQuantization();
+		m_dequantizationScale = CC3Vector::kCC3VectorUnitCube;
+		m_dequantizationOffset = CC3Vector::kCC3VectorZero;
 	}
 }
 
@@ -327,8 +521,13 @@ void CC3VertexArray::populateFrom( CC3VertexArray* another )
 	m_bufferUsage = another->getBufferUsage();
 	m_elementOffset = another->getElementOffset();
 	m_shouldNormalizeContent = another->shouldNormalizeContent();
+	m_instanceDivisor = another->getInstanceDivisor();
 	m_shouldAllowVertexBuffering = another->shouldAllowVertexBuffering();
 	m_shouldReleaseRedundantContent = another->shouldReleaseRedundantContent();
+	m_quantization = another->getQuantization();
+	m_preferredQuantization = another->getPreferredQuantization();
+	m_dequantizationScale = another->getDequantizationScale();
+	m_dequantizationOffset = another->getDequantizationOffset();
 
 	deleteGLBuffer();		// Data has yet to be buffered. Get rid of old buffer if necessary.
 
@@ -372,6 +571,18 @@ void CC3VertexArray::setAllocatedVertexCapacity( GLuint vtxCount )
 void CC3VertexArray::setVertexCapacityWithoutAllocation( GLuint capacity )
 {
     m_allocatedVertexCapacity = capacity;
+	m_isMappedContent = false;
+}
+
+void CC3VertexArray::setMappedVertexCapacity( GLuint capacity )
+{
+	m_allocatedVertexCapacity = capacity;
+	m_isMappedContent = (capacity > 0);
+}
+
+bool CC3VertexArray::isMappedContent()
+{
+	return m_isMappedContent;
 }
 
 bool CC3VertexArray::allocateVertexCapacity( GLuint vtxCount )
@@ -394,13 +605,21 @@ bool CC3VertexArray::allocateVertexCapacity( GLuint vtxCount )
 	{
 		// Returned pointer will be non-NULL on successful allocation and NULL on failed allocation.
 		// If we fail, log an error and return without changing anything.
-		newVertices = realloc(m_vertices, (vtxCount * getVertexStride()));
+		// Mapped content is not owned, so it is copied into new memory instead of being reallocated.
+		if (m_isMappedContent) 
+		{
+			newVertices = malloc(vtxCount * getVertexStride());
+			if ( newVertices )
+				memcpy(newVertices, m_vertices, (MIN(m_allocatedVertexCapacity, vtxCount) * getVertexStride()));
+		} else {
+			newVertices = realloc(m_vertices, (vtxCount * getVertexStride()));
+		}
 		if ( !newVertices ) 
 		{
 			CCLOGERROR("[vtx]CC3VertexArray could not allocate space for %d vertices");
 			return false;
 		}
-	} else {
+	} else if (!m_isMappedContent) {
 		free(m_vertices);
 	}
 	
@@ -411,6 +630,7 @@ bool CC3VertexArray::allocateVertexCapacity( GLuint vtxCount )
 	m_vertices = newVertices;
 	m_allocatedVertexCapacity = vtxCount;
 	m_vertexCount = vtxCount;
+	m_isMappedContent = false;
 	verticesWereChanged();
 	
 	return true;
@@ -525,7 +745,10 @@ void CC3VertexArray::bindContentToAttributeAt( GLint vaIdx, CC3NodeDrawingVisito
  */
 void CC3VertexArray::bindContent( GLvoid* pointer, GLint vaIdx, CC3NodeDrawingVisitor* visitor )
 {
-	visitor->getGL()->bindVertexContent( pointer, m_elementSize, m_elementType, m_vertexStride, m_shouldNormalizeContent, vaIdx );
+	CC3OpenGL* gl = visitor->getGL();
+	gl->bindVertexContent( pointer, m_elementSize, m_elementType, m_vertexStride, m_shouldNormalizeContent, vaIdx );
+	if ( m_instanceDivisor )
+		gl->setVertexAttributeDivisor( m_instanceDivisor, vaIdx );
 }
 
 GLvoid* CC3VertexArray::getAddressOfElement( GLuint index )
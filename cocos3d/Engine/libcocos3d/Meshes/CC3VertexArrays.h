@@ -35,6 +35,20 @@ NS_COCOS3D_BEGIN
 class CC3NodeDrawingVisitor;
 class CC3Texture;
 
+/**
+ * Packed formats into which the floating point content of a vertex array can be quantized,
+ * to reduce the memory and bus bandwidth consumed by that content.
+ *
+ * Quantized content is normalized by the GL engine as it is read, and is then decoded by the
+ * shader, by multiplying by the dequantizationScale and adding the dequantizationOffset of the
+ * vertex array.
+ */
+typedef enum {
+	kCC3VertexQuantizationNone = 0,			/**< Content is held in its original format. */
+	kCC3VertexQuantizationUnsignedShort,	/**< Normalized 16-bit unsigned integers spanning the bounds of each component. */
+	kCC3VertexQuantizationByte,				/**< Normalized 8-bit signed integers. Suitable for unit vectors such as normals and tangents. */
+} CC3VertexQuantization;
+
 /**
  * CC3VertexArrayContent contains the vertex content data on behalf of a CC3VertexArray.
  *
@@ -302,6 +316,99 @@ public:
 	bool						shouldNormalizeContent();
 	void						setShouldNormalizeContent( bool shouldNormalize );
 
+	/**
+	 * The number of instances that are drawn before the content of this vertex array advances
+	 * to the next element, when the mesh is drawn using instanced drawing.
+	 *
+	 * Vertex arrays that hold per-instance content, such as the transforms of the instances drawn
+	 * by a CC3InstancedMeshNode, set this property to one, so that each element is used for one
+	 * instance. This property has no effect if the platform does not support instanced drawing.
+	 *
+	 * The default value of this property is zero, indicating that the content advances once per vertex.
+	 */
+	GLuint						getInstanceDivisor();
+	void						setInstanceDivisor( GLuint divisor );
+
+	/**
+	 * The packed format of the vertex content, if it has been quantized by the quantizeVertexContent
+	 * method of the containing mesh, or kCC3VertexQuantizationNone if the content is held in its
+	 * original format.
+	 *
+	 * Quantized content is still read and written as floating point values through the accessor
+	 * methods of the vertex array subclasses. Values written to quantized content are clamped to
+	 * the bounds of the content at the time it was quantized.
+	 */
+	CC3VertexQuantization		getQuantization();
+
+	/** Returns whether the vertex content has been quantized. */
+	bool						isQuantized();
+
+	/**
+	 * The packed format into which the vertex content will be quantized when the quantizeVertexContent
+	 * method is invoked on the containing mesh. Set this property to kCC3VertexQuantizationNone to
+	 * leave the content of this vertex array in its original format.
+	 *
+	 * The initial value of this property is set from the defaultPreferredQuantization property.
+	 */
+	CC3VertexQuantization		getPreferredQuantization();
+	void						setPreferredQuantization( CC3VertexQuantization quantization );
+
+	/**
+	 * Returns the initial value of the preferredQuantization property.
+	 *
+	 * This implementation returns kCC3VertexQuantizationNone. Subclasses whose content can be
+	 * quantized without noticeable loss override.
+	 */
+	virtual CC3VertexQuantization	defaultPreferredQuantization();
+
+	/**
+	 * Returns whether the vertex content can be quantized into the preferredQuantization format.
+	 *
+	 * Only floating point content of up to three components, that has not already been quantized,
+	 * and that is in application memory, can be quantized.
+	 */
+	bool						canQuantizeContent();
+
+	/**
+	 * Returns the length of each element once the content has been quantized into the
+	 * preferredQuantization format, or the current elementLength if it cannot be quantized.
+	 *
+	 * Quantized elements are padded to a multiple of four bytes.
+	 */
+	GLuint						getQuantizedElementLength();
+
+	/**
+	 * The scale and offset used to decode quantized content, once it has been normalized by the
+	 * GL engine, as: value = (normalized * dequantizationScale) + dequantizationOffset.
+	 *
+	 * Shaders retrieve these values through the semantics for vertex location and texture coordinate
+	 * dequantization. For content that has not been quantized, these are unit scale and zero offset.
+	 */
+	CC3Vector					getDequantizationScale();
+	CC3Vector					getDequantizationOffset();
+
+	/**
+	 * Packs the content of each vertex into the preferredQuantization format, and writes it to the
+	 * specified memory, separating consecutive elements by the specified stride. If the content
+	 * cannot be quantized, it is copied to the specified memory as is.
+	 *
+	 * This method sets the dequantizationScale and dequantizationOffset properties, but does not
+	 * change the layout of the content of this array. Once the content has been relocated, the
+	 * adoptQuantizedFormat method must be invoked. Usually, the application will invoke the
+	 * quantizeVertexContent method of the mesh instead, which coordinates these steps.
+	 */
+	void						packContentInto( GLvoid* dstVertices, GLuint dstStride );
+
+	/**
+	 * Changes the elementType, elementSize and shouldNormalizeContent properties to those of the
+	 * preferredQuantization format, without reallocating the vertex content, and marks the content
+	 * as quantized. Does nothing if the content cannot be quantized.
+	 *
+	 * This method is invoked by the quantizeVertexContent method of the mesh, once the content
+	 * written by the packContentInto: method has been installed in this array.
+	 */
+	void						adoptQuantizedFormat();
+
 	/**
 	 * If the underlying content has been loaded into a GL engine vertex buffer object, this
 	 * property holds the ID of that GL buffer as provided by the GL engine when the
@@ -442,6 +549,16 @@ public:
     /* Just set vertex capacity, this is used for 3rd-party data import, you should call setAllocatedVertexCapacity usually*/
     void                        setVertexCapacityWithoutAllocation( GLuint capacity );
 
+	/**
+	 * Sets the vertex capacity of vertex content that is referenced in place within a mapped file,
+	 * and is therefore not owned by this instance. Mapped content may be written to, but it is never
+	 * freed, and it is copied into newly allocated memory if the capacity is later changed.
+	 */
+	void						setMappedVertexCapacity( GLuint capacity );
+
+	/** Returns whether the vertex content is referenced in place within a mapped file. */
+	bool						isMappedContent();
+
 	/**
 	 * Indicates whether this instance should allow the vertex content to be copied to a vertex
 	 * buffer object within the GL engine when the createGLBuffer method is invoked.
@@ -699,6 +816,18 @@ protected:
 	*/
 	virtual void				bindContent( GLvoid* pointer, GLint vaIdx, CC3NodeDrawingVisitor* visitor );
 
+	/**
+	 * Reads the components of the quantized element at the specified index into the specified
+	 * array, which must have space for four components, decoding them to floating point values.
+	 */
+	void						getDequantizedElementAt( GLuint index, GLfloat* components );
+
+	/**
+	 * Encodes the specified floating point components into the quantized element at the specified
+	 * index. Only the first elementSize components are read from the specified array.
+	 */
+	void						setQuantizedElement( const GLfloat* components, GLuint index );
+
 protected:
 	GLuint						m_elementOffset;
 	GLint						m_elementSize;
@@ -710,11 +839,17 @@ protected:
 	GLuint						m_bufferID;
 	GLenum						m_bufferUsage;
 	GLenum						m_semantic;
+	GLuint						m_instanceDivisor;
+	CC3Vector					m_dequantizationScale;
+	CC3Vector					m_dequantizationOffset;
+	CC3VertexQuantization		m_quantization;
+	CC3VertexQuantization		m_preferredQuantization;
 	GLuint						m_vertexStride : 8;
 	bool						m_shouldNormalizeContent : 1;
 	bool						m_shouldAllowVertexBuffering : 1;
 	bool						m_shouldReleaseRedundantContent : 1;
 	bool						m_wasVertexCapacityChanged : 1;		// Future use to track dirty vertex range
+	bool						m_isMappedContent : 1;
 };
 
 NS_COCOS3D_END
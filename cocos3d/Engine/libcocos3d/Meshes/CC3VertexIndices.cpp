@@ -95,7 +95,11 @@ void CC3VertexIndices::drawFrom( GLuint vtxIdx, GLuint vtxCount, CC3NodeDrawingV
 	firstVtx += getVertexStride() * vtxIdx;
 	firstVtx += m_elementOffset;
 	
-	visitor->getGL()->drawIndicies( firstVtx, vtxCount, m_elementType, m_drawingMode );
+	GLuint instanceCount = visitor->getInstanceCount();
+	if ( instanceCount > 1 )
+		visitor->getGL()->drawIndiciesInstanced( firstVtx, vtxCount, m_elementType, m_drawingMode, instanceCount );
+	else
+		visitor->getGL()->drawIndicies( firstVtx, vtxCount, m_elementType, m_drawingMode );
 }
 
 void CC3VertexIndices::copyVertices( GLuint vtxCount, GLuint srcIdx, GLuint dstIdx, GLint offset )
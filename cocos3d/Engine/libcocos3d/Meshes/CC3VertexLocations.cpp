@@ -93,6 +93,13 @@ CCObject* CC3VertexLocations::copyWithZone( CCZone* zone )
 
 CC3Vector CC3VertexLocations::getLocationAt( GLuint index )
 {
+	if ( isQuantized() )
+	{
+		GLfloat comps[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		getDequantizedElementAt( index, comps );
+		return cc3v( comps[0], comps[1], comps[2] );
+	}
+
 	CC3Vector loc = *(CC3Vector*)getAddressOfElement(index);
 	switch (m_elementSize) 
 	{
@@ -111,6 +118,13 @@ void CC3VertexLocations::setLocation( const CC3Vector& aLocation, GLuint index )
 	if ( index >= m_allocatedVertexCapacity )
 		return;
 
+	if ( isQuantized() )
+	{
+		setQuantizedElement( (const GLfloat*)&aLocation, index );
+		markBoundaryDirty();
+		return;
+	}
+
 	GLvoid* elemAddr = getAddressOfElement(index);
 	switch (m_elementSize) {
 		case 2:		// Just store X & Y
@@ -129,6 +143,9 @@ void CC3VertexLocations::setLocation( const CC3Vector& aLocation, GLuint index )
 
 CC3Vector4 CC3VertexLocations::getHomogeneousLocationAt( GLuint index )
 {
+	if ( isQuantized() )
+		return CC3Vector4().fromLocation( getLocationAt( index ) );
+
 	CC3Vector4 hLoc = *(CC3Vector4*)getAddressOfElement(index);
 	switch (m_elementSize) {
 		case 2:
@@ -144,6 +161,12 @@ CC3Vector4 CC3VertexLocations::getHomogeneousLocationAt( GLuint index )
 
 void CC3VertexLocations::setHomogeneousLocation( const CC3Vector4& aLocation, GLuint index )
 {
+	if ( isQuantized() )
+	{
+		setLocation( aLocation.cc3Vector(), index );
+		return;
+	}
+
 	GLvoid* elemAddr = getAddressOfElement(index);
 	switch (m_elementSize) {
 		case 2:		// Just store X & Y
@@ -293,7 +316,11 @@ void CC3VertexLocations::drawFrom( GLuint vtxIdx, GLuint vtxCount, CC3NodeDrawin
 {
 	super::drawFrom( vtxIdx, vtxCount, visitor );
 
-	visitor->getGL()->drawVerticiesAs( m_drawingMode, m_firstVertex + vtxIdx, vtxCount );
+	GLuint instanceCount = visitor->getInstanceCount();
+	if ( instanceCount > 1 )
+		visitor->getGL()->drawVerticiesInstancedAs( m_drawingMode, m_firstVertex + vtxIdx, vtxCount, instanceCount );
+	else
+		visitor->getGL()->drawVerticiesAs( m_drawingMode, m_firstVertex + vtxIdx, vtxCount );
 }
 
 std::string CC3VertexLocations::getNameSuffix()
@@ -318,4 +345,9 @@ GLenum CC3VertexLocations::defaultSemantic()
 	return kCC3SemanticVertexLocation; 
 }
 
+CC3VertexQuantization CC3VertexLocations::defaultPreferredQuantization()
+{
+	return kCC3VertexQuantizationUnsignedShort;
+}
+
 NS_COCOS3D_END
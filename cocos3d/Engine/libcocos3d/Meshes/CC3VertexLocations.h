@@ -273,6 +273,9 @@ public:
 	void						initWithTag( GLuint aTag, const std::string& aName );
 	GLenum						defaultSemantic();
 
+	/** Locations are quantized to normalized 16-bit unsigned integers spanning the bounding box of the mesh. */
+	CC3VertexQuantization		defaultPreferredQuantization();
+
 protected:
 	// Mark boundary dirty, but only if vertices are valid (to avoid marking dirty on dealloc)
 	void						verticesWereChanged();
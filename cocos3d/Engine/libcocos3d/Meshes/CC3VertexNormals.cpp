@@ -51,11 +51,24 @@ CC3VertexNormals* CC3VertexNormals::vertexArrayWithName( const std::string& aNam
 
 CC3Vector CC3VertexNormals::getNormalAt( GLuint index )
 {
+	if ( isQuantized() )
+	{
+		GLfloat comps[4];
+		getDequantizedElementAt( index, comps );
+		return cc3v( comps[0], comps[1], comps[2] );
+	}
+
 	return *(CC3Vector*)getAddressOfElement(index); 
 }
 
 void CC3VertexNormals::setNormal( const CC3Vector& aNormal, GLuint index )
 {
+	if ( isQuantized() )
+	{
+		setQuantizedElement( (const GLfloat*)&aNormal, index );
+		return;
+	}
+
 	*(CC3Vector*)getAddressOfElement(index) = aNormal;
 }
 
@@ -64,6 +77,12 @@ void CC3VertexNormals::flipNormals()
 	GLuint vtxCnt = getVertexCount();
 	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++) 
 	{
+		if ( isQuantized() )
+		{
+			setNormal( getNormalAt(vtxIdx).negate(), vtxIdx );
+			continue;
+		}
+
 		CC3Vector* pn = (CC3Vector*)getAddressOfElement(vtxIdx);
 		*pn = (*pn).negate();
 	}
@@ -79,4 +98,9 @@ GLenum CC3VertexNormals::defaultSemantic()
 	return kCC3SemanticVertexNormal; 
 }
 
+CC3VertexQuantization CC3VertexNormals::defaultPreferredQuantization()
+{
+	return kCC3VertexQuantizationByte;
+}
+
 NS_COCOS3D_END
@@ -66,6 +66,9 @@ public:
 
 	std::string					getNameSuffix();
 	GLenum						defaultSemantic();
+
+	/** Normals are quantized to normalized 8-bit signed integers. */
+	CC3VertexQuantization		defaultPreferredQuantization();
 };
 
 NS_COCOS3D_END
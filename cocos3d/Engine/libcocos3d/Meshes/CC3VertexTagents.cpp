@@ -42,11 +42,24 @@ CC3VertexTangents* CC3VertexTangents::vertexArray()
 
 CC3Vector CC3VertexTangents::getTangentAt( GLuint index )
 {
+	if ( isQuantized() )
+	{
+		GLfloat comps[4];
+		getDequantizedElementAt( index, comps );
+		return cc3v( comps[0], comps[1], comps[2] );
+	}
+
 	return *(CC3Vector*)getAddressOfElement(index); 
 }
 
 void CC3VertexTangents::setTangent( const CC3Vector& aTangent, GLuint index )
 {
+	if ( isQuantized() )
+	{
+		setQuantizedElement( (const GLfloat*)&aTangent, index );
+		return;
+	}
+
 	*(CC3Vector*)getAddressOfElement(index) = aTangent;
 }
 
@@ -60,4 +73,9 @@ GLenum CC3VertexTangents::defaultSemantic()
 	return kCC3SemanticVertexTangent; 
 }
 
+CC3VertexQuantization CC3VertexTangents::defaultPreferredQuantization()
+{
+	return kCC3VertexQuantizationByte;
+}
+
 NS_COCOS3D_END
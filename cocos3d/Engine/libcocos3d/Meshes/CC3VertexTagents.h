@@ -62,6 +62,9 @@ public:
 
 	std::string					getNameSuffix();
 	GLenum						defaultSemantic();
+
+	/** Tangents are quantized to normalized 8-bit signed integers. */
+	CC3VertexQuantization		defaultPreferredQuantization();
 };
 
 NS_COCOS3D_END
@@ -107,6 +107,16 @@ void CC3VertexTextureCoordinates::setExpectsVerticallyFlippedTextures( bool expe
 	m_expectsVerticallyFlippedTextures = expects;
 }
 
+CCSize CC3VertexTextureCoordinates::getMapSize()
+{
+	return m_mapSize;
+}
+
+void CC3VertexTextureCoordinates::setMapSize( const CCSize& mapSize )
+{
+	m_mapSize = mapSize;
+}
+
 static bool _defaultExpectsVerticallyFlippedTextures = false;
 
 bool CC3VertexTextureCoordinates::defaultExpectsVerticallyFlippedTextures()
@@ -121,14 +131,54 @@ void CC3VertexTextureCoordinates::setDefaultExpectsVerticallyFlippedTextures( bo
 
 ccTex2F CC3VertexTextureCoordinates::getTexCoord2FAt( GLuint index )
 {
+	if ( isQuantized() )
+	{
+		GLfloat comps[4];
+		getDequantizedElementAt( index, comps );
+		return tex2( comps[0], comps[1] );
+	}
+
 	return *(ccTex2F*)getAddressOfElement(index); 
 }
 
 void CC3VertexTextureCoordinates::setTexCoord2F( const ccTex2F& aTex2F, GLuint index )
 {
+	if ( isQuantized() )
+	{
+		GLfloat comps[2] = { aTex2F.u, aTex2F.v };
+		setQuantizedElement( comps, index );
+		return;
+	}
+
 	*(ccTex2F*)getAddressOfElement(index) = aTex2F;
 }
 
+/**
+ * Applies the linear transform (u * uScale + uOffset, v * vScale + vOffset) to all texture coordinates.
+ *
+ * Quantized content is not changed. Instead, the transform is folded into the dequantization
+ * scale and offset, so that it costs no precision and cannot overflow the quantized range.
+ */
+void CC3VertexTextureCoordinates::transformTexCoords( GLfloat uScale, GLfloat uOffset, GLfloat vScale, GLfloat vOffset )
+{
+	if ( isQuantized() )
+	{
+		m_dequantizationScale.x *= uScale;
+		m_dequantizationOffset.x = m_dequantizationOffset.x * uScale + uOffset;
+		m_dequantizationScale.y *= vScale;
+		m_dequantizationOffset.y = m_dequantizationOffset.y * vScale + vOffset;
+		return;
+	}
+
+	for (GLuint i = 0; i < m_vertexCount; i++) 
+	{
+		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
+		ptc->u = ptc->u * uScale + uOffset;
+		ptc->v = ptc->v * vScale + vOffset;
+	}
+	updateGLBuffer();
+}
+
 /**
  * Aligns the vertex texture coordinates with the area of the texture defined
  * by the newRect. The oldRect describes the area of the texture that is currently
@@ -154,26 +204,21 @@ void CC3VertexTextureCoordinates::alignWithTextureRectangle( const CCRect& newRe
 	
 	GLfloat hx = 1.0f - m_mapSize.height;	// Height translation due to texture inversion
 	
-	// For each texture coordinate, convert to the original coordinate, taking into consideration
-	// the mapSize and the old texture rectangle. Then, convert to the new coordinate, taking into
-	// consideration the mapSize and the new texture rectangle.
-	for (GLuint i = 0; i < m_vertexCount; i++) 
-	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		
-		GLfloat origU = ((ptc->u / mw) - ox) / ow;			// Revert to original value
-		ptc->u = (nx + (origU * nw)) * mw;					// Calc new value
-		
-		// Take into consideration whether the texture is flipped.
-		if (m_expectsVerticallyFlippedTextures) {
-			GLfloat origV = (1.0f - (ptc->v / mh) - oy) / oh;	// Revert to original value
-			ptc->v = (1.0f - (ny + (origV * nh))) * mh;			// Calc new value
-		} else {
-			GLfloat origV = (((ptc->v - hx) / mh) - oy) / oh;	// Revert to original value
-			ptc->v = (ny + (origV * nh)) * mh + hx;				// Calc new value
-		}
-	}
-	updateGLBuffer();
+	// Each texture coordinate is converted to the original coordinate, taking into consideration
+	// the mapSize and the old texture rectangle, then converted to the new coordinate, taking into
+	// consideration the mapSize and the new texture rectangle. Combined, these form a linear transform.
+	GLfloat uScale = nw / ow;
+	GLfloat uOffset = (nx - (ox * uScale)) * mw;
+	GLfloat vScale = nh / oh;
+	GLfloat vOffset;
+
+	// Take into consideration whether the texture is flipped.
+	if (m_expectsVerticallyFlippedTextures)
+		vOffset = mh - (ny * mh) - (vScale * mh * (1.0f - oy));
+	else
+		vOffset = (ny * mh) + hx - (vScale * (hx + (oy * mh)));
+
+	transformTexCoords( uScale, uOffset, vScale, vOffset );
 }
 
 void CC3VertexTextureCoordinates::alignWithTextureCoverage( const CCSize& texCoverage )
@@ -195,15 +240,9 @@ void CC3VertexTextureCoordinates::alignWithTextureCoverage( const CCSize& texCov
 	GLfloat currVertXln = 1.0f - m_mapSize.height;
 	GLfloat newVertXln = 1.0f - texCoverage.height;
 	
-	for (GLuint i = 0; i < m_vertexCount; i++) 
-	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		ptc->u *= mapRatio.width;
-		ptc->v = (ptc->v - currVertXln) * mapRatio.height + newVertXln;
-	}
-	m_mapSize = texCoverage;	// Remember what we've set the map size to
+	transformTexCoords( mapRatio.width, 0.0f, mapRatio.height, newVertXln - (currVertXln * mapRatio.height) );
 
-	updateGLBuffer();
+	m_mapSize = texCoverage;	// Remember what we've set the map size to
 }
 
 void CC3VertexTextureCoordinates::alignWithInvertedTextureCoverage( const CCSize& texCoverage )
@@ -215,18 +254,12 @@ void CC3VertexTextureCoordinates::alignWithInvertedTextureCoverage( const CCSize
 	
 	CCSize mapRatio = CCSizeMake(texCoverage.width / m_mapSize.width, texCoverage.height / m_mapSize.height);
 	
-	for (GLuint i = 0; i < m_vertexCount; i++) 
-	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement( i );
-		ptc->u *= mapRatio.width;
-		ptc->v = texCoverage.height - (ptc->v * mapRatio.height);
-	}
+	transformTexCoords( mapRatio.width, 0.0f, -mapRatio.height, texCoverage.height );
 
 	// Remember that we've flipped and what we've set the map size to
 	m_mapSize = texCoverage;
 	m_expectsVerticallyFlippedTextures = !m_expectsVerticallyFlippedTextures;
 	
-	updateGLBuffer();
 	CC3_TRACE("[vtx]CC3VertexTextureCoordinates aligned and flipped vertically");
 }
 
@@ -255,16 +288,11 @@ void CC3VertexTextureCoordinates::flipVertically()
 	GLfloat maxV = -kCC3MaxGLfloat;
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		minV = MIN(ptc->v, minV);
-		maxV = MAX(ptc->v, maxV);
+		GLfloat v = getTexCoord2FAt(i).v;
+		minV = MIN(v, minV);
+		maxV = MAX(v, maxV);
 	}
-	for (GLuint i = 0; i < m_vertexCount; i++) 
-	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		ptc->v = minV + maxV - ptc->v;
-	}
-	updateGLBuffer();
+	transformTexCoords( 1.0f, 0.0f, -1.0f, minV + maxV );
 }
 
 void CC3VertexTextureCoordinates::flipHorizontally()
@@ -273,17 +301,11 @@ void CC3VertexTextureCoordinates::flipHorizontally()
 	GLfloat maxU = -kCC3MaxGLfloat;
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		minU = MIN(ptc->u, minU);
-		maxU = MAX(ptc->u, maxU);
+		GLfloat u = getTexCoord2FAt(i).u;
+		minU = MIN(u, minU);
+		maxU = MAX(u, maxU);
 	}
-	for (GLuint i = 0; i < m_vertexCount; i++) 
-	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		ptc->u = minU + maxU - ptc->u;
-	}
-
-	updateGLBuffer();
+	transformTexCoords( -1.0f, minU + maxU, 1.0f, 0.0f );
 }
 
 void CC3VertexTextureCoordinates::repeatTexture( const ccTex2F& repeatFactor )
@@ -314,4 +336,9 @@ GLenum CC3VertexTextureCoordinates::defaultSemantic()
 	return kCC3SemanticVertexTexture; 
 }
 
+CC3VertexQuantization CC3VertexTextureCoordinates::defaultPreferredQuantization()
+{
+	return kCC3VertexQuantizationUnsignedShort;
+}
+
 NS_COCOS3D_END
@@ -151,6 +151,19 @@ public:
 	 */
 	static void					setDefaultExpectsVerticallyFlippedTextures( bool expectsFlipped );
 
+	/**
+	 * The texture coverage with which the texture coordinates were last aligned by the
+	 * alignWithTextureCoverage: or alignWithInvertedTextureCoverage: methods.
+	 *
+	 * Setting this property does not change the texture coordinates. It records the alignment of
+	 * vertex content that is already aligned, such as content restored from a scene cache file,
+	 * so that aligning it with the same texture again will leave it unchanged.
+	 *
+	 * The initial value of this property is (1, 1).
+	 */
+	CCSize						getMapSize();
+	void						setMapSize( const CCSize& mapSize );
+
 	/**
 	 * Aligns the texture coordinate array with the specfied texture map size,
 	 * which is typically extracted from a specific texture.
@@ -398,6 +411,12 @@ public:
 	void						initWithTag( GLuint aTag, const std::string& aName );
 	GLenum						defaultSemantic();
 
+	/** Texture coordinates are quantized to normalized 16-bit unsigned integers spanning the bounds of the coordinates. */
+	CC3VertexQuantization		defaultPreferredQuantization();
+
+
+protected:
+	void						transformTexCoords( GLfloat uScale, GLfloat uOffset, GLfloat vScale, GLfloat vOffset );
 
 protected:
 	CCSize						m_mapSize;
@@ -0,0 +1,529 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+/** Classification of a box against a plane, or against all planes of a frustum. */
+#define kCC3BoxOutside		1
+#define kCC3BoxStraddles	0
+#define kCC3BoxInside		(-1)
+
+/** The number of planes in a frustum, each of which is tracked by one bit of a plane mask. */
+#define kCC3FrustumPlaneCount	6
+#define kCC3AllPlanesMask		((1 << kCC3FrustumPlaneCount) - 1)
+
+/**
+ * Classifies the box against the plane, whose normal points out of the volume bounded by the
+ * plane. The box is outside if its corner nearest the plane, in the direction opposite to the
+ * normal, is in front of the plane, and inside if its corner furthest in the direction of the
+ * normal is behind the plane.
+ */
+static inline int classifyBoxAgainstPlane( const CC3Box& box, const CC3Plane& plane )
+{
+	CC3Vector nearCorner = cc3v(plane.a >= 0.0f ? box.minimum.x : box.maximum.x,
+								plane.b >= 0.0f ? box.minimum.y : box.maximum.y,
+								plane.c >= 0.0f ? box.minimum.z : box.maximum.z);
+	if ( plane.distance( nearCorner ) > 0.0f )
+		return kCC3BoxOutside;
+
+	CC3Vector farCorner = cc3v(plane.a >= 0.0f ? box.maximum.x : box.minimum.x,
+							   plane.b >= 0.0f ? box.maximum.y : box.minimum.y,
+							   plane.c >= 0.0f ? box.maximum.z : box.minimum.z);
+	return (plane.distance( farCorner ) > 0.0f) ? kCC3BoxStraddles : kCC3BoxInside;
+}
+
+/**
+ * Classifies the box against the frustum planes indicated by the bits of the plane mask.
+ * On return, the mask has been cleared of the planes that the box is entirely inside.
+ */
+static inline int classifyBoxAgainstPlanes( const CC3Box& box, const CC3Plane* planes, GLuint& planeMask )
+{
+	for (GLuint pIdx = 0; pIdx < kCC3FrustumPlaneCount; pIdx++)
+	{
+		GLuint planeBit = (1 << pIdx);
+		if ( !(planeMask & planeBit) )
+			continue;
+
+		int result = classifyBoxAgainstPlane( box, planes[pIdx] );
+		if ( result == kCC3BoxOutside )
+			return kCC3BoxOutside;
+		if ( result == kCC3BoxInside )
+			planeMask &= ~planeBit;
+	}
+	return planeMask ? kCC3BoxStraddles : kCC3BoxInside;
+}
+
+/**
+ * Atomically sets the specified flag. The flag is set from the threads of the parallel update
+ * mode of CC3NodeUpdatingVisitor, and is read once that update has joined.
+ */
+static inline void CC3AtomicSetFlag( volatile GLubyte* flag )
+{
+#ifdef _WIN32
+	InterlockedExchange8( (volatile char*)flag, 1 );
+#else
+	__sync_lock_test_and_set( flag, 1 );
+#endif
+}
+
+/** Orders leaves by the center of their boxes along a single axis. */
+struct CC3BoundingVolumeHierarchyLeafOrder
+{
+	int axis;
+	CC3BoundingVolumeHierarchyLeafOrder( int anAxis ) : axis(anAxis) {}
+
+	bool operator()( const CC3BoundingVolumeHierarchyLeaf& l1, const CC3BoundingVolumeHierarchyLeaf& l2 ) const
+	{
+		CC3Vector c1 = l1.box.getCenter();
+		CC3Vector c2 = l2.box.getCenter();
+		switch ( axis )
+		{
+			case 0: return c1.x < c2.x;
+			case 1: return c1.y < c2.y;
+			default: return c1.z < c2.z;
+		}
+	}
+};
+
+CC3BoundingVolumeHierarchy::CC3BoundingVolumeHierarchy()
+{
+	m_pRootNode = NULL;
+	m_maxLeavesPerBucket = 4;
+	m_isStructureDirty = true;
+	m_hasDirtyLeaves = 0;
+}
+
+CC3BoundingVolumeHierarchy::~CC3BoundingVolumeHierarchy()
+{
+	detachNodes();
+	m_pRootNode = NULL;			// weak reference
+}
+
+void CC3BoundingVolumeHierarchy::initWithRootNode( CC3Node* rootNode )
+{
+	m_pRootNode = rootNode;		// not retained
+	m_isStructureDirty = true;
+}
+
+CC3BoundingVolumeHierarchy* CC3BoundingVolumeHierarchy::hierarchyWithRootNode( CC3Node* rootNode )
+{
+	CC3BoundingVolumeHierarchy* pHierarchy = new CC3BoundingVolumeHierarchy;
+	pHierarchy->initWithRootNode( rootNode );
+	pHierarchy->autorelease();
+
+	return pHierarchy;
+}
+
+CC3Node* CC3BoundingVolumeHierarchy::getRootNode()
+{
+	return m_pRootNode;
+}
+
+GLuint CC3BoundingVolumeHierarchy::getLeafCount()
+{
+	return (GLuint)m_leaves.size();
+}
+
+CC3Node* CC3BoundingVolumeHierarchy::getNodeAt( GLuint leafIndex )
+{
+	return m_leaves[leafIndex].node;
+}
+
+CC3Box CC3BoundingVolumeHierarchy::getBoxAt( GLuint leafIndex )
+{
+	return m_leaves[leafIndex].box;
+}
+
+GLuint CC3BoundingVolumeHierarchy::getExcludedNodeCount()
+{
+	return (GLuint)m_excludedNodes.size();
+}
+
+CC3Node* CC3BoundingVolumeHierarchy::getExcludedNodeAt( GLuint index )
+{
+	return m_excludedNodes[index];
+}
+
+GLuint CC3BoundingVolumeHierarchy::getTreeNodeCount()
+{
+	return (GLuint)m_treeNodes.size();
+}
+
+GLuint CC3BoundingVolumeHierarchy::getMaxLeavesPerBucket()
+{
+	return m_maxLeavesPerBucket;
+}
+
+void CC3BoundingVolumeHierarchy::setMaxLeavesPerBucket( GLuint maxLeaves )
+{
+	m_maxLeavesPerBucket = MAX(maxLeaves, 1);
+	markStructureDirty();
+}
+
+void CC3BoundingVolumeHierarchy::markBoundsDirtyAt( GLint leafIndex )
+{
+	if ( leafIndex >= 0 && leafIndex < (GLint)m_dirtyFlags.size() )
+	{
+		m_dirtyFlags[leafIndex] = 1;
+		CC3AtomicSetFlag( &m_hasDirtyLeaves );
+	}
+}
+
+void CC3BoundingVolumeHierarchy::markStructureDirty()
+{
+	detachNodes();
+	m_isStructureDirty = true;
+}
+
+bool CC3BoundingVolumeHierarchy::isStructureDirty()
+{
+	return m_isStructureDirty;
+}
+
+/** Detaches all nodes from this hierarchy, so they no longer report dirty bounds to it. */
+void CC3BoundingVolumeHierarchy::detachNodes()
+{
+	for ( GLuint i = 0; i < m_leaves.size(); i++ )
+		m_leaves[i].node->setBoundingVolumeHierarchy( NULL, kCC3BoundingVolumeHierarchyNoIndex );
+
+	m_leaves.clear();
+	m_treeNodes.clear();
+	m_dirtyFlags.clear();
+	m_dirtyTreeNodes.clear();
+	m_excludedNodes.clear();
+	m_hasDirtyLeaves = 0;
+}
+
+/**
+ * Adds a leaf for each node with a bounding volume that can be enclosed by a box, and adds each
+ * node with a bounding volume that cannot, or with local content but no bounding volume, to the
+ * excluded nodes, so that every node that may be drawn is either a leaf or an excluded node.
+ */
+void CC3BoundingVolumeHierarchy::collectLeaves( CC3Node* aNode )
+{
+	CC3NodeBoundingVolume* bv = aNode->getBoundingVolume();
+	if ( bv )
+	{
+		CC3BoundingVolumeHierarchyLeaf leaf;
+		leaf.node = aNode;
+		leaf.box = bv->getGlobalBoundingBox();
+		leaf.treeNode = -1;
+		if ( !leaf.box.isNull() )
+			m_leaves.push_back( leaf );
+		else
+			m_excludedNodes.push_back( aNode );
+	}
+	else if ( aNode->hasLocalContent() )
+		m_excludedNodes.push_back( aNode );
+
+	CCObject* pObject;
+	CCARRAY_FOREACH( aNode->getChildren(), pObject )
+	{
+		CC3Node* child = (CC3Node*)pObject;
+		if ( child )
+			collectLeaves( child );
+	}
+}
+
+void CC3BoundingVolumeHierarchy::rebuild()
+{
+	detachNodes();
+	if ( m_pRootNode )
+		collectLeaves( m_pRootNode );
+
+	GLuint leafCount = (GLuint)m_leaves.size();
+	if ( leafCount > 0 )
+	{
+		m_treeNodes.reserve( 2 * (leafCount / m_maxLeavesPerBucket + 1) );
+		buildTreeNode( 0, leafCount, -1 );
+	}
+
+	for ( GLuint i = 0; i < leafCount; i++ )
+		m_leaves[i].node->setBoundingVolumeHierarchy( this, i );
+
+	m_dirtyFlags.assign( leafCount, 0 );
+	m_dirtyTreeNodes.assign( m_treeNodes.size(), 0 );
+	m_isStructureDirty = false;
+
+	CC3_TRACE( "CC3BoundingVolumeHierarchy built with %d leaves in %d tree nodes, excluding %d nodes",
+			   leafCount, (int)m_treeNodes.size(), (int)m_excludedNodes.size() );
+}
+
+/**
+ * Builds the tree node enclosing the specified range of leaves, and returns its index. Tree
+ * nodes are appended in depth-first order, so each parent precedes its children. Ranges larger
+ * than a bucket are split at the median of the leaf centers, along the longest axis of the
+ * box enclosing those centers.
+ */
+GLint CC3BoundingVolumeHierarchy::buildTreeNode( GLuint leafStart, GLuint leafCount, GLint parent )
+{
+	GLint nodeIdx = (GLint)m_treeNodes.size();
+	CC3BoundingVolumeHierarchyNode treeNode;
+	treeNode.parent = parent;
+	treeNode.left = -1;
+	treeNode.right = -1;
+	treeNode.leafStart = leafStart;
+	treeNode.leafCount = leafCount;
+	treeNode.box = CC3Box::kCC3BoxNull;
+
+	CC3Box centerBox = CC3Box::kCC3BoxNull;
+	GLuint leafEnd = leafStart + leafCount;
+	for (GLuint i = leafStart; i < leafEnd; i++)
+	{
+		treeNode.box = treeNode.box.boxUnion( m_leaves[i].box );
+		centerBox = centerBox.boxEngulfLocation( m_leaves[i].box.getCenter() );
+	}
+	m_treeNodes.push_back( treeNode );
+
+	if ( leafCount <= m_maxLeavesPerBucket )
+	{
+		for (GLuint i = leafStart; i < leafEnd; i++)
+			m_leaves[i].treeNode = nodeIdx;
+		return nodeIdx;
+	}
+
+	CC3Vector extent = centerBox.getSize();
+	int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+	GLuint halfCount = leafCount / 2;
+	std::nth_element( m_leaves.begin() + leafStart, m_leaves.begin() + leafStart + halfCount,
+					  m_leaves.begin() + leafEnd, CC3BoundingVolumeHierarchyLeafOrder( axis ) );
+
+	GLint left = buildTreeNode( leafStart, halfCount, nodeIdx );
+	GLint right = buildTreeNode( leafStart + halfCount, leafCount - halfCount, nodeIdx );
+	m_treeNodes[nodeIdx].left = left;
+	m_treeNodes[nodeIdx].right = right;
+	return nodeIdx;
+}
+
+/**
+ * Rebuilds the boxes of the dirty leaves, then refits the boxes of their ancestors in a single
+ * reverse pass over the tree nodes, which visits each child before its parent. Returns NO if
+ * the tree must be rebuilt instead, because too many leaves are dirty, or because a node can
+ * no longer be enclosed by a box.
+ */
+bool CC3BoundingVolumeHierarchy::refitDirtyLeaves()
+{
+	if ( !m_hasDirtyLeaves )
+		return true;
+
+	GLuint leafCount = (GLuint)m_leaves.size();
+	GLuint dirtyCount = 0;
+	for (GLuint i = 0; i < leafCount; i++)
+		dirtyCount += m_dirtyFlags[i];
+
+	if ( dirtyCount == 0 )
+		return true;
+	if ( dirtyCount > leafCount / 2 )
+		return false;
+
+	for (GLuint i = 0; i < leafCount; i++)
+	{
+		if ( !m_dirtyFlags[i] )
+			continue;
+
+		CC3BoundingVolumeHierarchyLeaf& leaf = m_leaves[i];
+		CC3NodeBoundingVolume* bv = leaf.node->getBoundingVolume();
+		CC3Box box = bv ? bv->getGlobalBoundingBox() : CC3Box::kCC3BoxNull;
+		if ( box.isNull() )
+			return false;
+
+		leaf.box = box;
+		m_dirtyTreeNodes[leaf.treeNode] = 1;
+		m_dirtyFlags[i] = 0;
+	}
+
+	for (GLint nodeIdx = (GLint)m_treeNodes.size() - 1; nodeIdx >= 0; nodeIdx--)
+	{
+		if ( !m_dirtyTreeNodes[nodeIdx] )
+			continue;
+
+		CC3BoundingVolumeHierarchyNode& treeNode = m_treeNodes[nodeIdx];
+		if ( treeNode.left >= 0 )
+		{
+			treeNode.box = m_treeNodes[treeNode.left].box.boxUnion( m_treeNodes[treeNode.right].box );
+		}
+		else
+		{
+			treeNode.box = CC3Box::kCC3BoxNull;
+			GLuint leafEnd = treeNode.leafStart + treeNode.leafCount;
+			for (GLuint i = treeNode.leafStart; i < leafEnd; i++)
+				treeNode.box = treeNode.box.boxUnion( m_leaves[i].box );
+		}
+
+		if ( treeNode.parent >= 0 )
+			m_dirtyTreeNodes[treeNode.parent] = 1;
+		m_dirtyTreeNodes[nodeIdx] = 0;
+	}
+	m_hasDirtyLeaves = 0;
+	return true;
+}
+
+void CC3BoundingVolumeHierarchy::updateIfNeeded()
+{
+	if ( m_isStructureDirty || !refitDirtyLeaves() )
+		rebuild();
+}
+
+void CC3BoundingVolumeHierarchy::markLeavesVisible( GLuint leafStart, GLuint leafCount, std::vector<GLuint>& visibleLeaves )
+{
+	GLuint leafEnd = leafStart + leafCount;
+	for (GLuint i = leafStart; i < leafEnd; i++)
+		visibleLeaves.push_back( i );
+}
+
+GLuint CC3BoundingVolumeHierarchy::cullToFrustum( CC3Frustum* aFrustum, std::vector<GLuint>& visibleLeaves )
+{
+	updateIfNeeded();
+
+	visibleLeaves.clear();
+	GLuint leafCount = (GLuint)m_leaves.size();
+	if ( leafCount == 0 )
+		return 0;
+
+	if ( !aFrustum )
+	{
+		markLeavesVisible( 0, leafCount, visibleLeaves );
+		return leafCount;
+	}
+
+	CC3Plane planes[kCC3FrustumPlaneCount];
+	memcpy( planes, aFrustum->getPlanes(), sizeof(planes) );
+
+	// Each stack entry is a tree node index, followed by the mask of planes it may straddle
+	m_queryStack.clear();
+	m_queryStack.push_back( 0 );
+	m_queryStack.push_back( kCC3AllPlanesMask );
+	while ( !m_queryStack.empty() )
+	{
+		GLuint planeMask = (GLuint)m_queryStack.back();
+		m_queryStack.pop_back();
+		GLint nodeIdx = m_queryStack.back();
+		m_queryStack.pop_back();
+
+		const CC3BoundingVolumeHierarchyNode& treeNode = m_treeNodes[nodeIdx];
+		int result = classifyBoxAgainstPlanes( treeNode.box, planes, planeMask );
+		if ( result == kCC3BoxOutside )
+			continue;
+
+		if ( result == kCC3BoxInside )
+		{
+			markLeavesVisible( treeNode.leafStart, treeNode.leafCount, visibleLeaves );
+			continue;
+		}
+
+		if ( treeNode.left >= 0 )
+		{
+			m_queryStack.push_back( treeNode.right );
+			m_queryStack.push_back( (GLint)planeMask );
+			m_queryStack.push_back( treeNode.left );
+			m_queryStack.push_back( (GLint)planeMask );
+			continue;
+		}
+
+		// A bucket straddling the frustum. Test each leaf box, and fall back to the
+		// bounding volume of the node for leaves that also straddle the frustum.
+		GLuint leafEnd = treeNode.leafStart + treeNode.leafCount;
+		for (GLuint i = treeNode.leafStart; i < leafEnd; i++)
+		{
+			GLuint leafMask = planeMask;
+			result = classifyBoxAgainstPlanes( m_leaves[i].box, planes, leafMask );
+			if ( result == kCC3BoxInside || (result == kCC3BoxStraddles && m_leaves[i].node->doesIntersectFrustum( aFrustum )) )
+				visibleLeaves.push_back( i );
+		}
+	}
+	return (GLuint)visibleLeaves.size();
+}
+
+/**
+ * Returns whether the ray pierces the box in front of its start location,
+ * and returns the distance at which the ray enters the box.
+ */
+static inline bool doesRayPierceBox( const CC3Ray& aRay, const CC3Vector& invDirection, const CC3Box& box, GLfloat& entryDist )
+{
+	GLfloat nearDist, farDist;
+	if ( !CC3DoesRayLineIntersectBox( aRay, invDirection, box, nearDist, farDist ) || farDist < 0.0f )
+		return false;
+
+	entryDist = MAX(nearDist, 0.0f);
+	return true;
+}
+
+/** Orders ray hits by increasing distance. */
+static bool isRayHitNearer( const CC3BoundingVolumeHierarchyRayHit& h1, const CC3BoundingVolumeHierarchyRayHit& h2 )
+{
+	return h1.distance < h2.distance;
+}
+
+GLuint CC3BoundingVolumeHierarchy::findLeavesIntersectedByRay( const CC3Ray& aRay, std::vector<CC3BoundingVolumeHierarchyRayHit>& hits )
+{
+	updateIfNeeded();
+
+	hits.clear();
+	if ( m_treeNodes.empty() )
+		return 0;
+
+	CC3Vector rd = aRay.direction;
+	CC3Vector invDir = cc3v(rd.x ? 1.0f / rd.x : 0.0f, rd.y ? 1.0f / rd.y : 0.0f, rd.z ? 1.0f / rd.z : 0.0f);
+
+	GLfloat entryDist;
+	m_queryStack.clear();
+	m_queryStack.push_back( 0 );
+	while ( !m_queryStack.empty() )
+	{
+		GLint nodeIdx = m_queryStack.back();
+		m_queryStack.pop_back();
+
+		const CC3BoundingVolumeHierarchyNode& treeNode = m_treeNodes[nodeIdx];
+		if ( !doesRayPierceBox( aRay, invDir, treeNode.box, entryDist ) )
+			continue;
+
+		if ( treeNode.left >= 0 )
+		{
+			m_queryStack.push_back( treeNode.right );
+			m_queryStack.push_back( treeNode.left );
+			continue;
+		}
+
+		GLuint leafEnd = treeNode.leafStart + treeNode.leafCount;
+		for (GLuint i = treeNode.leafStart; i < leafEnd; i++)
+		{
+			if ( doesRayPierceBox( aRay, invDir, m_leaves[i].box, entryDist ) )
+			{
+				CC3BoundingVolumeHierarchyRayHit hit;
+				hit.leafIndex = i;
+				hit.distance = entryDist;
+				hits.push_back( hit );
+			}
+		}
+	}
+
+	std::sort( hits.begin(), hits.end(), isRayHitNearer );
+	return (GLuint)hits.size();
+}
+
+NS_COCOS3D_END
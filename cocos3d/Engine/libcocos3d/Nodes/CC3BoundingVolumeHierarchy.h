@@ -0,0 +1,209 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_BOUNDING_VOLUME_HIERARCHY_H_
+#define _CC3_BOUNDING_VOLUME_HIERARCHY_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3Node;
+class CC3Frustum;
+
+/** Indicates that a node is not held as a leaf in a bounding volume hierarchy. */
+#define kCC3BoundingVolumeHierarchyNoIndex		(-1)
+
+/** A node in the tree of a CC3BoundingVolumeHierarchy. */
+typedef struct
+{
+	CC3Box				box;			/**< The global box enclosing all leaves below this tree node. */
+	GLint				parent;			/**< The index of the parent tree node, or -1 for the root. */
+	GLint				left;			/**< The index of the first child tree node, or -1 if this is a bucket of leaves. */
+	GLint				right;			/**< The index of the second child tree node, or -1 if this is a bucket of leaves. */
+	GLuint				leafStart;		/**< The index of the first leaf below this tree node. */
+	GLuint				leafCount;		/**< The number of leaves below this tree node. */
+} CC3BoundingVolumeHierarchyNode;
+
+/** A leaf of a CC3BoundingVolumeHierarchy, holding one node of the scene. */
+typedef struct
+{
+	CC3Node*			node;			/**< The scene node. Not retained. */
+	CC3Box				box;			/**< The global box enclosing the bounding volume of the scene node. */
+	GLint				treeNode;		/**< The index of the tree node bucket holding this leaf. */
+} CC3BoundingVolumeHierarchyLeaf;
+
+/** A leaf of a CC3BoundingVolumeHierarchy whose box is pierced by a ray. */
+typedef struct
+{
+	GLuint				leafIndex;		/**< The index of the leaf whose box is pierced by the ray. */
+	GLfloat				distance;		/**< The distance at which the ray enters the box, in multiples of the ray direction. */
+} CC3BoundingVolumeHierarchyRayHit;
+
+/**
+ * CC3BoundingVolumeHierarchy holds the nodes of a node assembly in a tree of axially-aligned
+ * global bounding boxes, so that the nodes that intersect the camera frustum, or that are
+ * pierced by a ray, can be found with a hierarchical query, whose cost grows with the number
+ * of nodes found, rather than with the total number of nodes.
+ *
+ * Each leaf of the hierarchy holds a node that has a bounding volume, and a global bounding box
+ * that encloses that bounding volume, as returned by the globalBoundingBox property of the
+ * bounding volume. Nodes whose bounding volume cannot be enclosed by a box, such as an infinite
+ * bounding volume, and nodes with local content but no bounding volume, are not held in the
+ * leaves of the hierarchy. They are listed in the excludedNodes of the hierarchy, so that they
+ * can be tested individually against the frustum and against rays.
+ *
+ * Each leaf has a dirty flag, which is set whenever the transform or bounding volume of its node
+ * is marked dirty. Before each query, the boxes of dirty leaves are rebuilt and the boxes of their
+ * ancestor tree nodes are refitted. If more than half of the leaves are dirty, or nodes have been
+ * added to or removed from the node assembly, the tree is rebuilt from scratch instead.
+ *
+ * Normally, the bounding volume hierarchy is managed by the CC3Scene, when the
+ * shouldUseBoundingVolumeHierarchy property of the scene is set to YES, and is queried by the
+ * CC3NodeDrawingVisitor when it begins drawing the scene, and by the CC3NodePuncturingVisitor
+ * when it is used to find the nodes in the scene that are punctured by a ray.
+ */
+class CC3BoundingVolumeHierarchy : public CCObject
+{
+public:
+	CC3BoundingVolumeHierarchy();
+	virtual ~CC3BoundingVolumeHierarchy();
+
+	/** The root node of the node assembly held in this hierarchy. The root node is not retained. */
+	CC3Node*					getRootNode();
+
+	/** The number of leaves, each holding a single scene node, in this hierarchy. */
+	GLuint						getLeafCount();
+
+	/** Returns the scene node held in the leaf at the specified index. */
+	CC3Node*					getNodeAt( GLuint leafIndex );
+
+	/** Returns the global bounding box of the leaf at the specified index. */
+	CC3Box						getBoxAt( GLuint leafIndex );
+
+	/**
+	 * The number of nodes that have a bounding volume that cannot be enclosed by a box, or that
+	 * have local content but no bounding volume, and which are therefore not held in the leaves
+	 * of this hierarchy.
+	 */
+	GLuint						getExcludedNodeCount();
+
+	/** Returns the excluded node at the specified index. */
+	CC3Node*					getExcludedNodeAt( GLuint index );
+
+	/** The number of tree nodes in this hierarchy, including the buckets of leaves. */
+	GLuint						getTreeNodeCount();
+
+	/**
+	 * Specifies the maximum number of leaves that are held in a single bucket at the bottom of
+	 * the tree. Smaller buckets produce a deeper tree, with tighter boxes, but more tree nodes.
+	 *
+	 * The initial value of this property is four.
+	 */
+	GLuint						getMaxLeavesPerBucket();
+	void						setMaxLeavesPerBucket( GLuint maxLeaves );
+
+	/**
+	 * Marks the bounding box of the leaf at the specified index as dirty. This method is invoked
+	 * automatically when the transform or bounding volume of the node held in the leaf is marked
+	 * dirty. It only sets a flag, and may be invoked from any thread.
+	 */
+	void						markBoundsDirtyAt( GLint leafIndex );
+
+	/**
+	 * Marks the structure of this hierarchy as dirty, and detaches all nodes from it. The hierarchy
+	 * is rebuilt from the root node before the next query. This method is invoked automatically
+	 * when nodes are added to, or removed from, the node assembly.
+	 */
+	void						markStructureDirty();
+
+	/** Returns whether the structure of this hierarchy will be rebuilt before the next query. */
+	bool						isStructureDirty();
+
+	/**
+	 * Rebuilds the tree if its structure is dirty, or otherwise refits the boxes of any dirty
+	 * leaves and their ancestors. This method is invoked automatically by the cullToFrustum
+	 * method, and must be invoked on the thread that updates the scene.
+	 */
+	void						updateIfNeeded();
+
+	/**
+	 * Determines which leaves intersect the specified frustum, and populates the specified array
+	 * with the indices of those leaves. The array is cleared before being populated, so that the
+	 * cost of the query grows with the number of leaves found, not with the size of the hierarchy.
+	 *
+	 * The tree is descended only into tree nodes whose boxes intersect the frustum. Leaves that lie
+	 * below a tree node whose box is entirely inside the frustum are accepted without further tests.
+	 * Leaves whose boxes straddle the boundary of the frustum are tested with the bounding volume of
+	 * their node, so the result matches testing each node individually.
+	 *
+	 * Returns the number of leaves that intersect the frustum.
+	 */
+	GLuint						cullToFrustum( CC3Frustum* aFrustum, std::vector<GLuint>& visibleLeaves );
+
+	/**
+	 * Populates the specified hits array with the leaves whose boxes are pierced by the specified
+	 * global ray, ordered by the distance at which the ray enters each box. Boxes that lie behind
+	 * the startLocation of the ray are not included, and a box that contains the startLocation is
+	 * entered at a distance of zero. The hits array is cleared before being populated.
+	 *
+	 * The tree is descended only into tree nodes whose boxes are pierced by the ray. Since the box
+	 * of a leaf encloses the bounding volume of its node, the returned leaves are candidates only,
+	 * and the bounding volume of each node must still be tested against the ray. Because each node
+	 * is punctured no nearer than the distance at which the ray enters its box, the search for the
+	 * closest node can stop at the first hit whose distance exceeds that of the closest puncture.
+	 *
+	 * Returns the number of leaves whose boxes are pierced by the ray.
+	 */
+	GLuint						findLeavesIntersectedByRay( const CC3Ray& aRay, std::vector<CC3BoundingVolumeHierarchyRayHit>& hits );
+
+	/** Initializes this instance to hold the nodes of the specified node assembly. */
+	void						initWithRootNode( CC3Node* rootNode );
+
+	/** Allocates and initializes an instance to hold the nodes of the specified node assembly. */
+	static CC3BoundingVolumeHierarchy* hierarchyWithRootNode( CC3Node* rootNode );
+
+protected:
+	void						detachNodes();
+	void						collectLeaves( CC3Node* aNode );
+	void						rebuild();
+	GLint						buildTreeNode( GLuint leafStart, GLuint leafCount, GLint parent );
+	bool						refitDirtyLeaves();
+	void						markLeavesVisible( GLuint leafStart, GLuint leafCount, std::vector<GLuint>& visibleLeaves );
+
+protected:
+	CC3Node*								m_pRootNode;
+	std::vector<CC3BoundingVolumeHierarchyLeaf>	m_leaves;
+	std::vector<CC3BoundingVolumeHierarchyNode>	m_treeNodes;
+	std::vector<GLubyte>					m_dirtyFlags;
+	std::vector<GLubyte>					m_dirtyTreeNodes;
+	std::vector<CC3Node*>					m_excludedNodes;
+	std::vector<GLint>						m_queryStack;
+	GLuint									m_maxLeavesPerBucket;
+	volatile GLubyte						m_hasDirtyLeaves;		// Set from update threads, so not a bitfield
+	bool									m_isStructureDirty : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
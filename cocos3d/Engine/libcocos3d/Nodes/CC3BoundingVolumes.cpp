@@ -506,6 +506,11 @@ CC3Vector CC3NodeBoundingVolume::getGlobalCenterOfGeometry()
 	return m_globalCenterOfGeometry;
 }
 
+CC3Box CC3NodeBoundingVolume::getGlobalBoundingBox()
+{
+	return CC3Box::kCC3BoxNull;
+}
+
 void CC3NodeBoundingVolume::setCenterOfGeometry( const CC3Vector& aLocation )
 {
 	m_centerOfGeometry = aLocation;
@@ -759,6 +764,12 @@ bool CC3NodeCenterOfGeometryBoundingVolume::doesIntersectLocation( const CC3Vect
 	return getGlobalCenterOfGeometry().equals( aLocation );
 }
 
+CC3Box CC3NodeCenterOfGeometryBoundingVolume::getGlobalBoundingBox()
+{
+	CC3Vector gcog = getGlobalCenterOfGeometry();
+	return CC3Box( gcog, gcog );
+}
+
 bool CC3NodeCenterOfGeometryBoundingVolume::doesIntersectRay( const CC3Ray& aRay )
 {
 	if (m_shouldIgnoreRayIntersection) 
@@ -948,6 +959,14 @@ bool CC3NodeSphericalBoundingVolume::doesIntersectLocation( const CC3Vector& aLo
 	return CC3IsLocationWithinSphere(aLocation, getGlobalSphere());
 }
 
+CC3Box CC3NodeSphericalBoundingVolume::getGlobalBoundingBox()
+{
+	CC3Vector gcog = getGlobalCenterOfGeometry();
+	GLfloat gRad = getGlobalRadius();
+	CC3Vector extent = CC3Vector( gRad, gRad, gRad );
+	return CC3Box( gcog.difference( extent ), gcog.add( extent ) );
+}
+
 bool CC3NodeSphericalBoundingVolume::doesIntersectRay( const CC3Ray& aRay )
 {
 	if (m_shouldIgnoreRayIntersection) 
@@ -1124,6 +1143,15 @@ GLuint CC3NodeBoxBoundingVolume::getVertexCount()
 	return 8; 
 }
 
+CC3Box CC3NodeBoxBoundingVolume::getGlobalBoundingBox()
+{
+	CC3Vector* vertices = getVertices();
+	CC3Box gbb = CC3Box::kCC3BoxNull;
+	for (GLuint i = 0; i < 8; i++)
+		gbb = gbb.boxEngulfLocation( vertices[i] );
+	return gbb;
+}
+
 void CC3NodeBoxBoundingVolume::populateFrom( CC3NodeBoxBoundingVolume* another )
 {
 	super::populateFrom( another );
@@ -1452,6 +1480,25 @@ bool CC3NodeTighteningBoundingVolumeSequence::doesIntersect( CC3BoundingVolume*
 	return intersects;
 }
 
+CC3Box CC3NodeTighteningBoundingVolumeSequence::getGlobalBoundingBox()
+{
+	CC3Box gbb = CC3Box::kCC3BoxNull;
+
+	CCObject* pObj;
+	CCARRAY_FOREACH( m_boundingVolumes, pObj )
+	{
+		CC3NodeBoundingVolume* pVolume = (CC3NodeBoundingVolume*)pObj;
+		if ( pVolume )
+		{
+			CC3Box bvBox = pVolume->getGlobalBoundingBox();
+			if ( !bvBox.isNull() )
+				gbb = bvBox;
+		}
+	}
+
+	return gbb;
+}
+
 bool CC3NodeTighteningBoundingVolumeSequence::doesIntersectLocation( const CC3Vector& aLocation )
 {
 	CCObject* pObj;
@@ -1674,6 +1721,17 @@ bool CC3NodeSphereThenBoxBoundingVolume::doesIntersect( CC3BoundingVolume* aBoun
 	return intersects;
 }
 
+CC3Box CC3NodeSphereThenBoxBoundingVolume::getGlobalBoundingBox()
+{
+	if (m_boxBoundingVolume)
+		return m_boxBoundingVolume->getGlobalBoundingBox();
+
+	if (m_sphericalBoundingVolume)
+		return m_sphericalBoundingVolume->getGlobalBoundingBox();
+
+	return CC3Box::kCC3BoxNull;
+}
+
 bool CC3NodeSphereThenBoxBoundingVolume::doesIntersectLocation( const CC3Vector& aLocation )
 {
 	return (m_sphericalBoundingVolume->doesIntersectLocation( aLocation ) &&
@@ -1805,6 +1863,11 @@ bool CC3NodeBoundingArea::doesIntersectBounds( const CCRect& bounds )
 	return true;
 }
 
+CC3Box CC3NodeBoundingArea::getGlobalBoundingBox()
+{
+	return CC3Box::kCC3BoxNull;
+}
+
 /** Intersects everything except nil. */
 bool CC3NodeInfiniteBoundingVolume::doesIntersect( CC3BoundingVolume* aBoundingVolume )
 {
@@ -1813,6 +1876,11 @@ bool CC3NodeInfiniteBoundingVolume::doesIntersect( CC3BoundingVolume* aBoundingV
 	return intersects;
 }
 
+CC3Box CC3NodeInfiniteBoundingVolume::getGlobalBoundingBox()
+{
+	return CC3Box::kCC3BoxNull;
+}
+
 bool CC3NodeInfiniteBoundingVolume::doesIntersectLocation( const CC3Vector& aLocation )
 { 
 	return true; 
@@ -1865,6 +1933,11 @@ bool CC3NodeNullBoundingVolume::doesIntersect( CC3BoundingVolume* aBoundingVolum
 	return false;
 }
 
+CC3Box CC3NodeNullBoundingVolume::getGlobalBoundingBox()
+{
+	return CC3Box::kCC3BoxNull;
+}
+
 bool CC3NodeNullBoundingVolume::doesIntersectLocation( const CC3Vector& aLocation )
 { 
 	return false; 
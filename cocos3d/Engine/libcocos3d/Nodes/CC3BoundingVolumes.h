@@ -529,6 +529,17 @@ public:
 	 */
 	virtual CC3Vector			getGlobalCenterOfGeometry();
 
+	/**
+	 * Returns an axially-aligned box, in the global coordinate system, that fully encloses this
+	 * bounding volume, or kCC3BoxNull if this bounding volume cannot be enclosed by a finite box.
+	 *
+	 * This box is used by CC3BoundingVolumeHierarchy to hold the node in its tree. A node whose
+	 * bounding volume returns kCC3BoxNull is tested individually against the camera frustum.
+	 *
+	 * This implementation returns kCC3BoxNull. Subclasses that can be enclosed by a box will override.
+	 */
+	virtual CC3Box				getGlobalBoundingBox();
+
 	/**
 	 * Returns the vertex locations of the CC3MeshNode holding this bounding volume.
 	 * If the node is not a CC3MeshNode, an assertion error is raised.
@@ -723,6 +734,9 @@ public:
 	 */
 	bool						doesIntersect( CC3BoundingVolume* aBoundingVolume );
 
+	/** Returns a global box of zero size, located at the global center of geometry. */
+	CC3Box						getGlobalBoundingBox();
+
 	/**
 	 * Returns whether the specified global location intersects (is inside) this bounding volume.
 	 * 
@@ -849,6 +863,9 @@ public:
 	 */
 	bool						doesIntersect( CC3BoundingVolume* aBoundingVolume );
 
+	/** Returns the axially-aligned global box enclosing the globalSphere. */
+	CC3Box						getGlobalBoundingBox();
+
 	/**
 	 * Returns whether the specified global location intersects (is inside) this bounding volume.
 	 * 
@@ -1003,6 +1020,9 @@ public:
 	CC3Box						getBoundingBox();
 	void						setBoundingBox( const CC3Box& box ); 
 
+	/** Returns the axially-aligned global box enclosing the eight transformed corners of this box. */
+	CC3Box						getGlobalBoundingBox();
+
 	/** 
 	 * Initializes this instance from the specified bounding box,
 	 * and sets the shouldBuildFromMesh property to NO.
@@ -1128,6 +1148,13 @@ public:
 	 */
 	bool						doesIntersect( CC3BoundingVolume* aBoundingVolume );
 
+	/**
+	 * Returns the global bounding box of the last contained bounding volume that can be enclosed
+	 * by a box. Since a node only intersects this sequence if it intersects every contained bounding
+	 * volume, the box of any single contained bounding volume conservatively encloses this sequence.
+	 */
+	CC3Box						getGlobalBoundingBox();
+
 	/**
 	 * Returns whether the specified global location intersects (is inside) this bounding volume.
 	 * 
@@ -1324,6 +1351,9 @@ public:
 	void						buildVolume();
 	void						transformVolume();
 	bool						doesIntersect( CC3BoundingVolume* aBoundingVolume );
+
+	/** Returns the global bounding box of the box bounding volume, or of the spherical bounding volume if there is no box. */
+	CC3Box						getGlobalBoundingBox();
 	bool						doesIntersectLocation( const CC3Vector& aLocation );
 	bool						doesIntersectRay( const CC3Ray& aRay );
 
@@ -1359,6 +1389,8 @@ public:
 	 * drawn as a 2D overlay, to determine whether or not it should be drawn.
 	 */
 	bool						doesIntersectBounds( const CCRect& bounds );
+	/** Returns kCC3BoxNull, since this bounding area is tested against 2D bounds, rather than 3D volumes. */
+	CC3Box						getGlobalBoundingBox();
 };
 
 
@@ -1383,6 +1415,9 @@ public:
 	 */
 	bool						doesIntersect( CC3BoundingVolume* aBoundingVolume );
 
+	/** Returns kCC3BoxNull, since this bounding volume cannot be enclosed by a finite box. */
+	CC3Box						getGlobalBoundingBox();
+
 	/**
 	 * Returns whether the specified global location intersects (is inside) this bounding volume.
 	 * 
@@ -1450,6 +1485,9 @@ public:
 	 */
 	bool						doesIntersect( CC3BoundingVolume* aBoundingVolume );
 
+	/** Returns kCC3BoxNull, since this bounding volume never intersects anything, and must always be tested directly. */
+	CC3Box						getGlobalBoundingBox();
+
 	/**
 	 * Returns whether the specified global location intersects (is inside) this bounding volume.
 	 * 
@@ -0,0 +1,480 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+CC3InstancedMeshNode::CC3InstancedMeshNode()
+{
+	for (GLuint i = 0; i < 3; i++)
+		m_pInstanceTransformRows[i] = NULL;
+	m_pInstanceColors = NULL;
+	m_pBatchMesh = NULL;
+	m_pBatchInstanceIndices = NULL;
+}
+
+CC3InstancedMeshNode::~CC3InstancedMeshNode()
+{
+	releaseBatchMesh();
+
+	// The instance stream buffer is owned by the first transform row array
+	for (GLuint i = 1; i < 3; i++)
+	{
+		if ( m_pInstanceTransformRows[i] )
+			m_pInstanceTransformRows[i]->setBufferID( 0 );
+	}
+	if ( m_pInstanceColors )
+		m_pInstanceColors->setBufferID( 0 );
+
+	for (GLuint i = 0; i < 3; i++)
+		CC_SAFE_RELEASE( m_pInstanceTransformRows[i] );
+	CC_SAFE_RELEASE( m_pInstanceColors );
+}
+
+CC3InstancedMeshNode* CC3InstancedMeshNode::nodeWithName( const std::string& aName )
+{
+	CC3InstancedMeshNode* pNode = new CC3InstancedMeshNode;
+	pNode->initWithName( aName );
+	pNode->autorelease();
+
+	return pNode;
+}
+
+GLuint CC3InstancedMeshNode::getInstanceCount()
+{
+	return (GLuint)m_instances.size();
+}
+
+GLuint CC3InstancedMeshNode::addInstance( const CC3Matrix4x3* transform )
+{
+	CC3MeshInstance inst;
+	inst.color = ccc4(255, 255, 255, 255);
+	m_instances.push_back( inst );
+	m_instanceScales.push_back( 1.0f );
+
+	GLuint index = (GLuint)m_instances.size() - 1;
+	setInstanceTransformAt( transform, index );
+	return index;
+}
+
+GLuint CC3InstancedMeshNode::addInstance( const CC3Vector& location, const CC3Vector& rotation, const CC3Vector& scale )
+{
+	CC3Matrix4x3 mtx;
+	CC3Matrix4x3PopulateFromTranslation( &mtx, location );
+	CC3Matrix4x3RotateYXZBy( &mtx, rotation );
+	CC3Matrix4x3ScaleBy( &mtx, scale );
+	return addInstance( &mtx );
+}
+
+void CC3InstancedMeshNode::setInstanceTransform( const CC3Matrix4x3* transform, GLuint index )
+{
+	CCAssert(index < m_instances.size(), "CC3InstancedMeshNode instance index is out of range");
+	setInstanceTransformAt( transform, index );
+}
+
+/**
+ * Stores the transform as rows, so the shader can apply it with three dot products, and caches
+ * the largest scale of the transform, for use in scaling the bounding sphere of the instance.
+ */
+void CC3InstancedMeshNode::setInstanceTransformAt( const CC3Matrix4x3* transform, GLuint index )
+{
+	CC3MeshInstance& inst = m_instances[index];
+	GLfloat maxScaleSq = 0.0f;
+	for (GLuint r = 0; r < 3; r++)
+		inst.transformRows[r] = CC3Vector4FromCC3Matrix4x3Row( transform, r + 1 );
+	for (GLuint c = 1; c <= 3; c++)
+		maxScaleSq = MAX(maxScaleSq, CC3VectorFromCC3Matrix4x3Col( transform, c ).lengthSquared());
+	m_instanceScales[index] = sqrtf(maxScaleSq);
+}
+
+CC3Vector CC3InstancedMeshNode::getInstanceLocationAt( GLuint index )
+{
+	CCAssert(index < m_instances.size(), "CC3InstancedMeshNode instance index is out of range");
+	const CC3MeshInstance& inst = m_instances[index];
+	return CC3Vector( inst.transformRows[0].w, inst.transformRows[1].w, inst.transformRows[2].w );
+}
+
+ccColor4F CC3InstancedMeshNode::getInstanceColorAt( GLuint index )
+{
+	CCAssert(index < m_instances.size(), "CC3InstancedMeshNode instance index is out of range");
+	return CCC4FFromCCC4B( m_instances[index].color );
+}
+
+void CC3InstancedMeshNode::setInstanceColor( const ccColor4F& color, GLuint index )
+{
+	CCAssert(index < m_instances.size(), "CC3InstancedMeshNode instance index is out of range");
+	m_instances[index].color = CCC4BFromCCC4F( color );
+}
+
+void CC3InstancedMeshNode::removeAllInstances()
+{
+	m_instances.clear();
+	m_instanceScales.clear();
+	m_visibleInstanceCount = 0;
+}
+
+GLuint CC3InstancedMeshNode::getVisibleInstanceCount()
+{
+	return m_visibleInstanceCount;
+}
+
+bool CC3InstancedMeshNode::shouldCullInstances()
+{
+	return m_shouldCullInstances;
+}
+
+void CC3InstancedMeshNode::setShouldCullInstances( bool shouldCull )
+{
+	m_shouldCullInstances = shouldCull;
+}
+
+GLuint CC3InstancedMeshNode::getInstancesPerBatch()
+{
+	return m_instancesPerBatch;
+}
+
+void CC3InstancedMeshNode::setInstancesPerBatch( GLuint count )
+{
+	if ( count == m_instancesPerBatch )
+		return;
+
+	m_instancesPerBatch = MAX(count, 1);
+	releaseBatchMesh();
+}
+
+GLuint CC3InstancedMeshNode::getBatchInstanceCount()
+{
+	return m_batchInstanceCount;
+}
+
+CC3MeshInstance* CC3InstancedMeshNode::getBatchInstances()
+{
+	return m_visibleInstances.empty() ? NULL : &m_visibleInstances[m_batchFirstInstance];
+}
+
+void CC3InstancedMeshNode::setMesh( CC3Mesh* aMesh )
+{
+	if ( aMesh == m_pMesh )
+		return;
+
+	super::setMesh( aMesh );
+	releaseBatchMesh();
+}
+
+CC3Mesh* CC3InstancedMeshNode::getDrawingMesh()
+{
+	return (m_isBatchingInstances && m_pBatchMesh) ? m_pBatchMesh : m_pMesh;
+}
+
+CC3VertexArray* CC3InstancedMeshNode::getVertexArrayForSemantic( GLenum semantic, GLuint semanticIndex )
+{
+	switch (semantic) 
+	{
+		case kCC3SemanticVertexInstanceTransform:
+			return (!m_isBatchingInstances && semanticIndex < 3) ? m_pInstanceTransformRows[semanticIndex] : NULL;
+		case kCC3SemanticVertexInstanceColor:
+			return m_isBatchingInstances ? NULL : m_pInstanceColors;
+		case kCC3SemanticVertexInstanceIndex:
+			return m_isBatchingInstances ? m_pBatchInstanceIndices : NULL;
+		default:
+			return super::getVertexArrayForSemantic( semantic, semanticIndex );
+	}
+}
+
+bool CC3InstancedMeshNode::isDrawingInstances()
+{
+	return true;
+}
+
+CC3NodeBoundingVolume* CC3InstancedMeshNode::defaultBoundingVolume()
+{
+	return NULL;
+}
+
+void CC3InstancedMeshNode::drawWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	if ( !m_pMesh || m_instances.empty() )
+		return;
+
+	m_isBatchingInstances = !visitor->getGL()->supportsInstancedDrawing();
+	if ( m_isBatchingInstances )
+		ensureBatchMesh();
+
+	cullInstancesWithVisitor( visitor );
+	if ( m_visibleInstanceCount == 0 )
+		return;
+
+	// Stream the visible instances before the vertex attributes are bound
+	if ( !m_isBatchingInstances )
+		m_pInstanceTransformRows[0]->updateGLBufferStartingAt( 0, m_visibleInstanceCount );
+
+	super::drawWithVisitor( visitor );
+}
+
+/**
+ * Copies each instance whose bounding sphere intersects the frustum of the camera of the visitor
+ * into the contiguous array of visible instances. The bounding sphere of each instance is the
+ * bounding sphere of the mesh, transformed by the instance transform and the transform of this node.
+ */
+void CC3InstancedMeshNode::cullInstancesWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	GLuint instCount = (GLuint)m_instances.size();
+	ensureInstanceStreamCapacity( instCount );
+
+	CC3Camera* pCam = visitor->getCamera();
+	CC3Frustum* pFrustum = (m_shouldCullInstances && pCam) ? pCam->getFrustum() : NULL;
+	if ( !pFrustum )
+	{
+		std::copy( m_instances.begin(), m_instances.end(), m_visibleInstances.begin() );
+		m_visibleInstanceCount = instCount;
+		return;
+	}
+
+	CC3Matrix* globalMtx = getGlobalTransformMatrix();
+	CC3Vector4 meshCenter( m_pMesh->getCenterOfGeometry(), 1.0f );
+	CC3Vector nodeScale = getGlobalScale();
+	GLfloat meshRadius = m_pMesh->getRadius() * MAX(MAX(fabsf(nodeScale.x), fabsf(nodeScale.y)), fabsf(nodeScale.z));
+
+	m_visibleInstanceCount = 0;
+	for (GLuint i = 0; i < instCount; i++)
+	{
+		const CC3MeshInstance& inst = m_instances[i];
+		CC3Vector localCenter( inst.transformRows[0].dot( meshCenter ),
+							   inst.transformRows[1].dot( meshCenter ),
+							   inst.transformRows[2].dot( meshCenter ) );
+		CC3Sphere globalSphere = CC3SphereMake( globalMtx->transformLocation( localCenter ), meshRadius * m_instanceScales[i] );
+		if ( pFrustum->doesIntersectSphere( globalSphere ) )
+			m_visibleInstances[m_visibleInstanceCount++] = inst;
+	}
+}
+
+/**
+ * Ensures the contiguous array of visible instances can hold the specified number of instances.
+ * When the array grows, the instance vertex arrays are pointed at the new memory, and the GL
+ * buffer that streams the instances is recreated at the new size, and shared by all of them.
+ */
+void CC3InstancedMeshNode::ensureInstanceStreamCapacity( GLuint capacity )
+{
+	if ( capacity <= m_visibleInstances.size() )
+		return;
+
+	m_visibleInstances.resize( MAX(capacity, (GLuint)m_visibleInstances.size() * 2) );
+	GLuint streamCapacity = (GLuint)m_visibleInstances.size();
+	GLvoid* streamContent = &m_visibleInstances[0];
+
+	for (GLuint i = 1; i < 3; i++)
+		m_pInstanceTransformRows[i]->setBufferID( 0 );
+	m_pInstanceColors->setBufferID( 0 );
+	m_pInstanceTransformRows[0]->deleteGLBuffer();
+
+	for (GLuint i = 0; i < 3; i++)
+	{
+		m_pInstanceTransformRows[i]->setVertices( streamContent );
+		m_pInstanceTransformRows[i]->setVertexCount( streamCapacity );
+	}
+	m_pInstanceColors->setVertices( streamContent );
+	m_pInstanceColors->setVertexCount( streamCapacity );
+
+	m_pInstanceTransformRows[0]->createGLBuffer();
+	GLuint streamBufferID = m_pInstanceTransformRows[0]->getBufferID();
+	for (GLuint i = 1; i < 3; i++)
+		m_pInstanceTransformRows[i]->setBufferID( streamBufferID );
+	m_pInstanceColors->setBufferID( streamBufferID );
+}
+
+/**
+ * Lazily builds the content used to draw instances in uniform batches. The mesh is replicated
+ * into a batch mesh, and each vertex of the batch mesh is tagged with the index of the replica
+ * it belongs to, so the shader can look up the content of that instance in the uniform arrays.
+ *
+ * Meshes that are drawn as strips, or that no longer hold their vertex content in memory,
+ * cannot be replicated, and are drawn one instance at a time instead.
+ */
+void CC3InstancedMeshNode::ensureBatchMesh()
+{
+	if ( m_pBatchInstanceIndices )
+		return;
+
+	GLuint vtxCount = m_pMesh->getVertexCount();
+	GLuint vtxIdxCount = m_pMesh->hasVertexIndices() ? m_pMesh->getVertexIndexCount() : 0;
+	GLenum drawMode = m_pMesh->getDrawingMode();
+	bool canReplicate = (drawMode == GL_TRIANGLES || drawMode == GL_LINES || drawMode == GL_POINTS)
+						&& vtxCount > 0 && m_pMesh->getVertexLocations()->getVertices()
+						&& (vtxIdxCount == 0 || m_pMesh->getVertexIndices()->getVertices());
+
+	m_batchCapacity = canReplicate ? MIN(m_instancesPerBatch, (kCC3MaxGLushort + 1) / vtxCount) : 1;
+	m_batchCapacity = MAX(m_batchCapacity, 1);
+
+	if ( m_batchCapacity > 1 )
+	{
+		m_pBatchMesh = CC3Mesh::meshWithName( CC3String::stringWithFormat( (char*)"%s-Batch", getName().c_str() ) );
+		m_pBatchMesh->retain();
+		m_pBatchMesh->setShouldInterleaveVertices( true );
+		m_pBatchMesh->setVertexContentTypes( m_pMesh->getVertexContentTypes() );
+		m_pBatchMesh->setAllocatedVertexCapacity( vtxCount * m_batchCapacity );
+		if ( vtxIdxCount )
+			m_pBatchMesh->setAllocatedVertexIndexCapacity( vtxIdxCount * m_batchCapacity );
+
+		for (GLuint i = 0; i < m_batchCapacity; i++)
+		{
+			m_pBatchMesh->copyVertices( vtxCount, 0, m_pMesh, i * vtxCount );
+			if ( vtxIdxCount )
+				m_pBatchMesh->copyVertexIndices( vtxIdxCount, 0, m_pMesh, i * vtxIdxCount, i * vtxCount );
+		}
+		m_pBatchMesh->setVertexCount( vtxCount * m_batchCapacity );
+		if ( vtxIdxCount )
+			m_pBatchMesh->setVertexIndexCount( vtxIdxCount * m_batchCapacity );
+		m_pBatchMesh->setDrawingMode( drawMode );
+		m_pBatchMesh->createGLBuffers();
+	}
+
+	GLuint idxVtxCount = vtxCount * m_batchCapacity;
+	m_pBatchInstanceIndices = CC3VertexArray::vertexArrayWithName( CC3String::stringWithFormat( (char*)"%s-InstanceIndices", getName().c_str() ) );
+	m_pBatchInstanceIndices->retain();
+	m_pBatchInstanceIndices->setSemantic( kCC3SemanticVertexInstanceIndex );
+	m_pBatchInstanceIndices->setElementType( GL_FLOAT );
+	m_pBatchInstanceIndices->setElementSize( 1 );
+	m_pBatchInstanceIndices->setAllocatedVertexCapacity( idxVtxCount );
+	m_pBatchInstanceIndices->setVertexCount( idxVtxCount );
+
+	GLfloat* instIndices = (GLfloat*)m_pBatchInstanceIndices->getVertices();
+	for (GLuint vIdx = 0; vIdx < idxVtxCount; vIdx++)
+		instIndices[vIdx] = (GLfloat)(vIdx / vtxCount);
+	m_pBatchInstanceIndices->createGLBuffer();
+}
+
+void CC3InstancedMeshNode::releaseBatchMesh()
+{
+	CC_SAFE_RELEASE_NULL( m_pBatchMesh );
+	CC_SAFE_RELEASE_NULL( m_pBatchInstanceIndices );
+	m_batchCapacity = 1;
+}
+
+void CC3InstancedMeshNode::drawMeshWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	if ( m_isBatchingInstances )
+	{
+		drawBatchesWithVisitor( visitor );
+		return;
+	}
+
+	visitor->setInstanceCount( m_visibleInstanceCount );
+	super::drawMeshWithVisitor( visitor );
+	visitor->setInstanceCount( 1 );
+
+	// Leave the vertex attributes ready for content that advances per vertex
+	visitor->getGL()->resetVertexAttributeDivisors();
+}
+
+/**
+ * Draws the visible instances in batches of up to batchCapacity instances. The content of the
+ * instances in each batch is populated into the draw-scope uniforms before each batch is drawn.
+ */
+void CC3InstancedMeshNode::drawBatchesWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	CC3Mesh* drawingMesh = getDrawingMesh();
+	GLuint vtxPerInstance = m_pMesh->hasVertexIndices() ? m_pMesh->getVertexIndexCount() : m_pMesh->getVertexCount();
+
+	for (GLuint firstInst = 0; firstInst < m_visibleInstanceCount; firstInst += m_batchCapacity)
+	{
+		m_batchFirstInstance = firstInst;
+		m_batchInstanceCount = MIN(m_batchCapacity, m_visibleInstanceCount - firstInst);
+		if ( m_pBatchMesh )
+			drawingMesh->drawFrom( 0, vtxPerInstance * m_batchInstanceCount, visitor );
+		else
+			drawingMesh->drawWithVisitor( visitor );
+	}
+
+	m_batchFirstInstance = 0;
+	m_batchInstanceCount = 0;
+}
+
+void CC3InstancedMeshNode::initWithTag( GLuint aTag, const std::string& aName )
+{
+	super::initWithTag( aTag, aName );
+	{
+		for (GLuint i = 0; i < 3; i++)
+		{
+			m_pInstanceTransformRows[i] = CC3VertexArray::vertexArrayWithName( CC3String::stringWithFormat( (char*)"%s-InstanceTransformRow%u", aName.c_str(), i ) );
+			m_pInstanceTransformRows[i]->retain();
+			m_pInstanceTransformRows[i]->setSemantic( kCC3SemanticVertexInstanceTransform );
+			m_pInstanceTransformRows[i]->setElementType( GL_FLOAT );
+			m_pInstanceTransformRows[i]->setElementSize( 4 );
+			m_pInstanceTransformRows[i]->setElementOffset( (GLuint)(i * sizeof(CC3Vector4)) );
+		}
+		m_pInstanceColors = CC3VertexArray::vertexArrayWithName( CC3String::stringWithFormat( (char*)"%s-InstanceColors", aName.c_str() ) );
+		m_pInstanceColors->retain();
+		m_pInstanceColors->setSemantic( kCC3SemanticVertexInstanceColor );
+		m_pInstanceColors->setElementType( GL_UNSIGNED_BYTE );
+		m_pInstanceColors->setElementSize( 4 );
+		m_pInstanceColors->setShouldNormalizeContent( true );
+		m_pInstanceColors->setElementOffset( (GLuint)offsetof(CC3MeshInstance, color) );
+
+		// A reduced mesh is not selected for each instance
+		m_shouldSelectLODLevel = false;
+
+		CC3VertexArray* streamArrays[4] = { m_pInstanceTransformRows[0], m_pInstanceTransformRows[1], m_pInstanceTransformRows[2], m_pInstanceColors };
+		for (GLuint i = 0; i < 4; i++)
+		{
+			streamArrays[i]->setVertexStride( sizeof(CC3MeshInstance) );
+			streamArrays[i]->setBufferUsage( GL_DYNAMIC_DRAW );
+			streamArrays[i]->setInstanceDivisor( 1 );
+		}
+
+		m_pBatchMesh = NULL;
+		m_pBatchInstanceIndices = NULL;
+		m_visibleInstanceCount = 0;
+		m_instancesPerBatch = kCC3DefaultInstancesPerBatch;
+		m_batchCapacity = 1;
+		m_batchFirstInstance = 0;
+		m_batchInstanceCount = 0;
+		m_shouldCullInstances = true;
+		m_isBatchingInstances = false;
+	}
+}
+
+void CC3InstancedMeshNode::populateFrom( CC3InstancedMeshNode* another )
+{
+	super::populateFrom( another );
+
+	m_instances = another->m_instances;
+	m_instanceScales = another->m_instanceScales;
+	m_instancesPerBatch = another->getInstancesPerBatch();
+	m_shouldCullInstances = another->shouldCullInstances();
+}
+
+CCObject* CC3InstancedMeshNode::copyWithZone( CCZone* )
+{
+	CC3InstancedMeshNode* pVal = new CC3InstancedMeshNode;
+	pVal->init();
+	pVal->populateFrom( this );
+	pVal->addCopiesOfChildrenFrom( this );
+
+	return pVal;
+}
+
+NS_COCOS3D_END
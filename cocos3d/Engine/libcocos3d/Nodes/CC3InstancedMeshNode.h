@@ -0,0 +1,199 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_INSTANCED_MESH_NODE_H_
+#define _CC3_INSTANCED_MESH_NODE_H_
+
+NS_COCOS3D_BEGIN
+
+/**
+ * The default number of instances drawn by each draw call when the platform does not support
+ * instanced drawing. This must not exceed the MAX_INSTANCES_PER_BATCH value declared by the
+ * CC3LibVertexPositionInstanced.vsh shader library.
+ */
+#define kCC3DefaultInstancesPerBatch		8
+
+/**
+ * The content of a single instance drawn by a CC3InstancedMeshNode. Instances are held
+ * contiguously in this form, and are streamed to the GL engine directly from this layout.
+ */
+typedef struct {
+	CC3Vector4		transformRows[3];	/**< The rows of the transform of the instance, relative to the node. */
+	ccColor4B		color;				/**< The color of the instance, which tints the material color. */
+} CC3MeshInstance;
+
+/**
+ * CC3InstancedMeshNode is a CC3MeshNode that draws many instances of its mesh and material,
+ * each with its own transform and color, in very few draw calls.
+ *
+ * This is useful for drawing large numbers of identical objects, such as trees, crowd members
+ * or debris, that would otherwise each require a separate CC3MeshNode, with its own uniform
+ * updates and its own draw call.
+ *
+ * The transform of each instance is relative to this node, so moving, rotating or scaling this
+ * node moves, rotates or scales all of the instances together. Each instance also has a color,
+ * which is multiplied with the color of the material when the instance is drawn.
+ *
+ * Before drawing, each instance is tested against the frustum of the camera that is drawing
+ * the scene, and only the visible instances are drawn. Because instances are culled individually,
+ * this node has no bounding volume of its own.
+ *
+ * When the platform supports instanced drawing, the visible instances are streamed to the GL
+ * engine as per-instance vertex attributes, and all visible instances are drawn in a single
+ * draw call. When instanced drawing is not available, the mesh is replicated a number of times
+ * into a larger batch mesh, and the visible instances are drawn in batches, with the content
+ * of each instance in the batch provided to the shader in uniform arrays.
+ *
+ * Instances are drawn using the CC3TexturableInstanced.vsh vertex shader, which is selected
+ * automatically. Skinned meshes and reduced level-of-detail meshes are not supported.
+ */
+class CC3InstancedMeshNode : public CC3MeshNode
+{
+	DECLARE_SUPER( CC3MeshNode );
+public:
+	CC3InstancedMeshNode();
+	virtual ~CC3InstancedMeshNode();
+
+	static CC3InstancedMeshNode*	nodeWithName( const std::string& aName );
+
+	/** Returns the number of instances drawn by this node. */
+	GLuint						getInstanceCount();
+
+	/**
+	 * Adds an instance with the specified transform, relative to this node, and returns the
+	 * index of the new instance. The new instance is colored white.
+	 */
+	GLuint						addInstance( const CC3Matrix4x3* transform );
+
+	/**
+	 * Adds an instance at the specified location, with the specified rotation and scale, all
+	 * relative to this node, and returns the index of the new instance. The rotation is specified
+	 * as Euler angles in degrees. The new instance is colored white.
+	 */
+	GLuint						addInstance( const CC3Vector& location, const CC3Vector& rotation, const CC3Vector& scale );
+
+	/** Sets the transform of the instance at the specified index, relative to this node. */
+	void						setInstanceTransform( const CC3Matrix4x3* transform, GLuint index );
+
+	/** Returns the location of the instance at the specified index, relative to this node. */
+	CC3Vector					getInstanceLocationAt( GLuint index );
+
+	/** Returns the color of the instance at the specified index. */
+	ccColor4F					getInstanceColorAt( GLuint index );
+
+	/** Sets the color of the instance at the specified index. */
+	void						setInstanceColor( const ccColor4F& color, GLuint index );
+
+	/** Removes all instances from this node. */
+	void						removeAllInstances();
+
+	/**
+	 * Returns the number of instances that were found to be visible the last time this node
+	 * was drawn.
+	 */
+	GLuint						getVisibleInstanceCount();
+
+	/**
+	 * Indicates whether each instance should be tested against the frustum of the camera before
+	 * being drawn. If this property is set to NO, all instances are drawn.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldCullInstances();
+	void						setShouldCullInstances( bool shouldCull );
+
+	/**
+	 * The maximum number of instances drawn by each draw call when the platform does not support
+	 * instanced drawing. This value must not exceed the length of the uniform arrays declared in
+	 * the shader. Fewer instances may be drawn per call if the mesh is large.
+	 *
+	 * The initial value of this property is kCC3DefaultInstancesPerBatch.
+	 */
+	GLuint						getInstancesPerBatch();
+	void						setInstancesPerBatch( GLuint count );
+
+	/**
+	 * Returns the number of instances in the batch currently being drawn, when the instances
+	 * are being drawn in uniform batches. Returns zero when the instances are being drawn with
+	 * instanced drawing, or when this node is not being drawn.
+	 */
+	GLuint						getBatchInstanceCount();
+
+	/** Returns a pointer to the first instance in the batch currently being drawn. */
+	CC3MeshInstance*			getBatchInstances();
+
+	/** Overridden to release the batch mesh derived from the previous mesh. */
+	void						setMesh( CC3Mesh* aMesh );
+
+	/** Returns the batch mesh while drawing instances in uniform batches, otherwise the mesh. */
+	CC3Mesh*					getDrawingMesh();
+
+	/** Overridden to add the vertex arrays holding the per-instance content. */
+	CC3VertexArray*				getVertexArrayForSemantic( GLenum semantic, GLuint semanticIndex );
+
+	/** Returns YES. */
+	bool						isDrawingInstances();
+
+	/** Returns NULL, since instances are culled individually. */
+	CC3NodeBoundingVolume*		defaultBoundingVolume();
+
+	/** Culls the instances and streams the visible instances to the GL engine before drawing. */
+	void						drawWithVisitor( CC3NodeDrawingVisitor* visitor );
+
+	/** Draws the visible instances, either in a single instanced draw call, or in uniform batches. */
+	void						drawMeshWithVisitor( CC3NodeDrawingVisitor* visitor );
+
+	void						initWithTag( GLuint aTag, const std::string& aName );
+	void						populateFrom( CC3InstancedMeshNode* another );
+	virtual CCObject*			copyWithZone( CCZone* zone );
+
+protected:
+	void						setInstanceTransformAt( const CC3Matrix4x3* transform, GLuint index );
+	void						cullInstancesWithVisitor( CC3NodeDrawingVisitor* visitor );
+	void						ensureInstanceStreamCapacity( GLuint capacity );
+	void						ensureBatchMesh();
+	void						releaseBatchMesh();
+	void						drawBatchesWithVisitor( CC3NodeDrawingVisitor* visitor );
+
+protected:
+	std::vector<CC3MeshInstance>	m_instances;
+	std::vector<GLfloat>		m_instanceScales;
+	std::vector<CC3MeshInstance>	m_visibleInstances;
+	GLuint						m_visibleInstanceCount;
+	CC3VertexArray*				m_pInstanceTransformRows[3];
+	CC3VertexArray*				m_pInstanceColors;
+	CC3Mesh*					m_pBatchMesh;
+	CC3VertexArray*				m_pBatchInstanceIndices;
+	GLuint						m_instancesPerBatch;
+	GLuint						m_batchCapacity;
+	GLuint						m_batchFirstInstance;
+	GLuint						m_batchInstanceCount;
+	bool						m_shouldCullInstances : 1;
+	bool						m_isBatchingInstances : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -36,12 +36,16 @@ CC3Light::CC3Light()
 	m_cameraShadowVolume = NULL;
 	m_shadowCastingVolume = NULL;
 	m_stencilledShadowPainter = NULL;
+	m_pShadowMap = NULL;
 	m_shadows = NULL;
 }
 
 CC3Light::~CC3Light()
 {
 	cleanupShadows(); // Includes releasing the shadows array, camera shadow volume & shadow painter
+	if ( m_pShadowMap )
+		m_pShadowMap->setLight( NULL );
+	CC_SAFE_RELEASE( m_pShadowMap );
 	returnLightIndex( m_lightIndex );
 }
 
@@ -221,6 +225,7 @@ void CC3Light::initWithTag( GLuint aTag, const std::string& aName, GLuint ltIndx
 		m_shadowCastingVolume = NULL;
 		m_cameraShadowVolume = NULL;
 		m_stencilledShadowPainter = NULL;
+		m_pShadowMap = NULL;
 		m_ambientColor = kCC3DefaultLightColorAmbient;
 		m_diffuseColor = kCC3DefaultLightColorDiffuse;
 		m_specularColor = kCC3DefaultLightColorSpecular;
@@ -572,17 +577,17 @@ void CC3Light::setShadowCastingVolume( CC3ShadowCastingVolume* scVolume )
 }
 
 /**
- * If there are shadows and the shadow casting volume has not been added, add it now,
- * and tell the camera to let the shadow casting volume know whenever the camera moves
- * so the shadow casting volume can determine which objects are casting shadows that
+ * If there are shadows or a shadow map, and the shadow casting volume has not been added,
+ * add it now, and tell the camera to let the shadow casting volume know whenever the camera
+ * moves so the shadow casting volume can determine which objects are casting shadows that
  * are visible within the camera frustum.
  *
- * If there are no more shadows, disconnect the shadow casting volume from the camera,
- * and remove the shadow casting volume.
+ * If there are no more shadows and no shadow map, disconnect the shadow casting volume
+ * from the camera, and remove the shadow casting volume.
  */
 void CC3Light::checkShadowCastingVolume()
 {
-	if ( hasShadows() ) {
+	if ( hasShadows() || m_pShadowMap ) {
 		if ( !m_shadowCastingVolume )
 			setShadowCastingVolume( CC3ShadowCastingVolume::boundingVolume() );
 	} else {
@@ -667,6 +672,35 @@ void CC3Light::setStencilledShadowPainter( CC3StencilledShadowPainterNode* sspNo
 	getScene()->updateRelativeLightIntensities();	//  Must be done after the ivar is set.
 }
 
+CC3ShadowMap* CC3Light::getShadowMap()
+{
+	return m_pShadowMap;
+}
+
+/**
+ * Attaches this light to the new shadow map. If this light is already in a scene with a camera,
+ * ensures the shadow casting volume exists to select the casters. Otherwise, the scene will add
+ * the shadow casting volume when it first renders the shadow map.
+ */
+void CC3Light::setShadowMap( CC3ShadowMap* shadowMap )
+{
+	if (shadowMap == m_pShadowMap) 
+		return;
+
+	if ( m_pShadowMap )
+		m_pShadowMap->setLight( NULL );
+	CC_SAFE_RELEASE( m_pShadowMap );
+
+	m_pShadowMap = shadowMap;
+	CC_SAFE_RETAIN( shadowMap );
+
+	if ( m_pShadowMap )
+		m_pShadowMap->setLight( this );
+
+	if ( getActiveCamera() )
+		checkShadowCastingVolume();
+}
+
 void CC3Light::updateRelativeIntensityFrom( const ccColor4F& totalLight )
 {
 	if (m_stencilledShadowPainter) 
@@ -35,6 +35,7 @@ class CC3ShadowProtocol;
 class CC3ShadowCastingVolume;
 class CC3CameraShadowVolume;
 class CC3StencilledShadowPainterNode;
+class CC3ShadowMap;
 
 /** Constant indicating that the light is not directional. */
 static const GLfloat kCC3SpotCutoffNone = 180.0f;
@@ -482,6 +483,20 @@ public:
 	CC3StencilledShadowPainterNode*		getStencilledShadowPainter();
 	void						setStencilledShadowPainter( CC3StencilledShadowPainterNode* node );
 
+	/**
+	 * The shadow map used to cast shadows from this light using depth textures, as an alternative
+	 * or complement to the shadow volumes added via the addShadow: method.
+	 *
+	 * When this property is set, the scene renders the depth of the shadow casters into the shadow
+	 * map once per frame, and the shadow map is made available to shaders through the shadow map
+	 * semantics, such as kCC3SemanticTextureShadowMapSampler. Setting this property also ensures
+	 * that the shadowCastingVolume exists, since it is used to select the shadow casters.
+	 *
+	 * The initial value of this property is nil.
+	 */
+	CC3ShadowMap*				getShadowMap();
+	void						setShadowMap( CC3ShadowMap* shadowMap );
+
 	/**
 	 * This property is used to adjust the shadow intensity as calculated when the 
 	 * updateRelativeIntensityFrom: method is invoked. This property increases flexibility
@@ -712,6 +727,7 @@ protected:
 	CC3ShadowCastingVolume*		m_shadowCastingVolume;
 	CC3CameraShadowVolume*		m_cameraShadowVolume;
 	CC3StencilledShadowPainterNode* m_stencilledShadowPainter;
+	CC3ShadowMap*				m_pShadowMap;
 	CCArray*					m_shadows;
 	ccColor4F					m_ambientColor;
 	ccColor4F					m_diffuseColor;
@@ -35,6 +35,8 @@ CC3MeshNode::CC3MeshNode()
 {	
 	m_pMaterial = NULL;
 	m_pMesh = NULL;
+	m_lodMeshes = NULL;
+	m_lodLevel = 0;
 	m_pShaderContext = NULL;
 	m_decalOffsetFactor = 0.f;
 	m_decalOffsetUnits = 0.f;
@@ -45,6 +47,7 @@ CC3MeshNode::~CC3MeshNode()
 {
 	CC_SAFE_RELEASE( m_pMaterial );
 	CC_SAFE_RELEASE( m_pMesh );
+	CC_SAFE_RELEASE( m_lodMeshes );
 	CC_SAFE_RELEASE( m_pShaderContext );
 }
 
@@ -77,6 +80,8 @@ void CC3MeshNode::setMesh( CC3Mesh * aMesh )
 	if ( m_pMesh )
 		m_pMesh->deriveNameFrom( this );
 
+	removeAllLODMeshes();		// Reduced meshes were derived from the previous mesh
+
 	alignMaterialAndMesh();
 	markBoundingVolumeDirty();
 }
@@ -95,6 +100,183 @@ CC3Mesh* CC3MeshNode::makeMesh()
 	return CC3Mesh::mesh(); 
 }
 
+GLuint CC3MeshNode::getLODLevelCount()
+{
+	return 1 + (m_lodMeshes ? m_lodMeshes->count() : 0);
+}
+
+CC3Mesh* CC3MeshNode::getLODMeshAt( GLuint lodLevel )
+{
+	if ( lodLevel == 0 )
+		return m_pMesh;
+
+	return (lodLevel < getLODLevelCount()) ? (CC3Mesh*)m_lodMeshes->objectAtIndex( lodLevel - 1 ) : NULL;
+}
+
+void CC3MeshNode::addLODMesh( CC3Mesh* lodMesh, GLfloat screenSize )
+{
+	if ( !lodMesh )
+		return;
+
+	if ( !m_lodMeshes )
+	{
+		m_lodMeshes = CCArray::create();		// retained
+		m_lodMeshes->retain();
+	}
+	m_lodMeshes->addObject( lodMesh );
+	m_lodScreenSizes.push_back( screenSize );
+}
+
+void CC3MeshNode::removeAllLODMeshes()
+{
+	if ( m_lodMeshes )
+		m_lodMeshes->removeAllObjects();
+	m_lodScreenSizes.clear();
+	m_lodLevel = 0;
+}
+
+GLfloat CC3MeshNode::getLODScreenSizeAt( GLuint lodLevel )
+{
+	return (lodLevel > 0 && lodLevel < getLODLevelCount()) ? m_lodScreenSizes[lodLevel - 1] : 0.0f;
+}
+
+void CC3MeshNode::setLODScreenSize( GLfloat screenSize, GLuint lodLevel )
+{
+	if ( lodLevel > 0 && lodLevel < getLODLevelCount() )
+		m_lodScreenSizes[lodLevel - 1] = screenSize;
+}
+
+void CC3MeshNode::generateLODMeshes( GLuint lodCount, GLfloat triangleRatio )
+{
+	removeAllLODMeshes();
+
+	if ( m_pMesh && lodCount > 0 )
+	{
+		CC3MeshSimplifier* simplifier = CC3MeshSimplifier::simplifier();
+		GLfloat levelRatio = 1.0f;
+		GLfloat screenSize = kCC3DefaultLODScreenSize;
+		GLfloat screenSizeRatio = sqrtf( CLAMP(triangleRatio, 0.0f, 1.0f) );
+		GLuint prevFaceCount = m_pMesh->getFaceCount();
+		for ( GLuint lodLevel = 1; lodLevel <= lodCount; lodLevel++ )
+		{
+			// Each level is simplified from the full mesh, to avoid compounding the error of each level
+			levelRatio *= triangleRatio;
+			CC3Mesh* lodMesh = simplifier->simplifyMesh( m_pMesh, levelRatio );
+			if ( !lodMesh || lodMesh->getFaceCount() >= prevFaceCount )
+				break;
+
+			lodMesh->setName( CC3String::stringWithFormat( (char*)"%s-LOD%u", m_pMesh->getName().c_str(), lodLevel ) );
+			addLODMesh( lodMesh, screenSize );
+			prevFaceCount = lodMesh->getFaceCount();
+			screenSize *= screenSizeRatio;
+		}
+
+		CC3_TRACE( "CC3MeshNode %s generated %u reduced meshes from %u triangles down to %u",
+			getName().c_str(), getLODLevelCount() - 1, m_pMesh->getFaceCount(), prevFaceCount );
+	}
+
+	super::generateLODMeshes( lodCount, triangleRatio );
+}
+
+GLuint CC3MeshNode::getLODLevel()
+{
+	return m_lodLevel;
+}
+
+void CC3MeshNode::setLODLevel( GLuint lodLevel )
+{
+	m_lodLevel = MIN(lodLevel, getLODLevelCount() - 1);
+}
+
+bool CC3MeshNode::shouldSelectLODLevel()
+{
+	return m_shouldSelectLODLevel;
+}
+
+void CC3MeshNode::setShouldSelectLODLevel( bool shouldSelect )
+{
+	m_shouldSelectLODLevel = shouldSelect;
+}
+
+GLfloat CC3MeshNode::getLODHysteresis()
+{
+	return m_lodHysteresis;
+}
+
+void CC3MeshNode::setLODHysteresis( GLfloat hysteresis )
+{
+	m_lodHysteresis = hysteresis;
+}
+
+/**
+ * The vertical scale of the projection matrix converts a distance from the camera into the height
+ * of the viewport, so dividing it by the distance to the node converts the radius of the node into
+ * a fraction of the half-height of the viewport, which is the same as the diameter of the node as a
+ * fraction of the full height. Distance is used instead of depth, so that the projected size does
+ * not change as the camera turns.
+ */
+GLfloat CC3MeshNode::getProjectedScreenSize( CC3Camera* camera )
+{
+	if ( !m_pMesh || !camera )
+		return 0.0f;
+
+	CC3Vector gScale = getGlobalScale();
+	GLfloat maxScale = MAX(MAX(fabsf(gScale.x), fabsf(gScale.y)), fabsf(gScale.z));
+	GLfloat radius = m_pMesh->getRadius() * maxScale;
+
+	CC3Matrix4x4 projMtx;
+	camera->getProjectionMatrix()->populateCC3Matrix4x4( &projMtx );
+	if ( camera->isUsingParallelProjection() )
+		return radius * projMtx.c2r2;
+
+	GLfloat distance = getGlobalCenterOfGeometry().distance( camera->getGlobalLocation() );
+	return radius * projMtx.c2r2 / MAX(distance, radius);
+}
+
+/**
+ * Moves to a coarser level once the projected size falls below the screen size of that level by the
+ * hysteresis fraction, and back to a finer level once it rises above that screen size by the same fraction.
+ */
+void CC3MeshNode::selectLODWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	GLuint levelCount = getLODLevelCount();
+	if ( levelCount < 2 || !m_shouldSelectLODLevel )
+		return;
+
+	CC3Camera* camera = visitor->getCamera();
+	if ( !camera || camera != visitor->getDefaultCamera() )
+		return;
+
+	GLfloat screenSize = getProjectedScreenSize( camera );
+	GLuint lodLevel = 0;
+	for ( GLuint level = 1; level < levelCount; level++ )
+	{
+		GLfloat hysteresis = (m_lodLevel >= level) ? m_lodHysteresis : -m_lodHysteresis;
+		if ( screenSize >= m_lodScreenSizes[level - 1] * (1.0f + hysteresis) )
+			break;
+
+		lodLevel = level;
+	}
+	m_lodLevel = lodLevel;
+}
+
+CC3Mesh* CC3MeshNode::getDrawingMesh()
+{
+	return m_lodLevel ? (CC3Mesh*)m_lodMeshes->objectAtIndex( m_lodLevel - 1 ) : m_pMesh;
+}
+
+GLuint CC3MeshNode::getDrawingFaceCount()
+{
+	CC3Mesh* drawingMesh = getDrawingMesh();
+	return drawingMesh ? drawingMesh->getFaceCount() : 0;
+}
+
+CC3VertexArray* CC3MeshNode::getVertexArrayForSemantic( GLenum semantic, GLuint semanticIndex )
+{
+	CC3Mesh* drawingMesh = getDrawingMesh();
+	return drawingMesh ? drawingMesh->getVertexArrayForSemantic( semantic, semanticIndex ) : NULL;
+}
+
 /** Lazily init the material */
 CC3Material* CC3MeshNode::getMaterial()
 {
@@ -434,6 +616,19 @@ CC3ShaderProgram* CC3MeshNode::getShaderProgram()
 	return sp;
 }
 
+CC3ShaderProgram* CC3MeshNode::getAssignedShaderProgram()
+{
+	return m_pShaderContext ? m_pShaderContext->getProgram() : NULL;
+}
+
+bool CC3MeshNode::canDrawQuantizedVertexContent()
+{
+	CC3ShaderProgram* sp = getAssignedShaderProgram();
+	if ( !sp )
+		sp = CC3ShaderProgram::getShaderMatcher()->getProgramForMeshNode( this );
+	return sp && sp->canDecodeQuantizedVertexContent();
+}
+
 void CC3MeshNode::setShaderProgram( CC3ShaderProgram* shaderProgram )
 {
 	getShaderContext()->setProgram( shaderProgram );
@@ -732,6 +927,9 @@ void CC3MeshNode::initWithTag( GLuint aTag, const std::string& aName )
 	m_shouldApplyOpacityAndColorToMeshContent = false;
 	m_shouldDrawInClipSpace = false;
 	m_hasRigidSkeleton = false;
+	m_lodHysteresis = kCC3DefaultLODHysteresis;
+	m_shouldSelectLODLevel = true;
+	m_shouldBatchStatically = false;
 }
 
 void CC3MeshNode::populateFrom( CC3MeshNode* another )
@@ -743,6 +941,14 @@ void CC3MeshNode::populateFrom( CC3MeshNode* another )
 	m_pMesh = another->getMesh();
 	CC_SAFE_RETAIN( m_pMesh );					// retained - Mesh shared between original and copy
 
+	// Reduced meshes are also shared between original and copy
+	removeAllLODMeshes();
+	GLuint lodCount = another->getLODLevelCount();
+	for ( GLuint lodLevel = 1; lodLevel < lodCount; lodLevel++ )
+		addLODMesh( another->getLODMeshAt( lodLevel ), another->getLODScreenSizeAt( lodLevel ) );
+	m_lodHysteresis = another->getLODHysteresis();
+	m_shouldSelectLODLevel = another->shouldSelectLODLevel();
+
 	CC_SAFE_RELEASE( m_pMaterial );
 	m_pMaterial = (CC3Material*)another->getMaterial()->copy();					// retained
 	
@@ -762,6 +968,7 @@ void CC3MeshNode::populateFrom( CC3MeshNode* another )
 	m_shouldSmoothLines = another->shouldSmoothLines();
 	m_lineSmoothingHint = another->getLineSmoothingHint();
 	m_shouldApplyOpacityAndColorToMeshContent = another->shouldApplyOpacityAndColorToMeshContent();
+	m_shouldBatchStatically = another->shouldBatchStatically();
 }
 
 CCObject* CC3MeshNode::copyWithZone( CCZone* zone )
@@ -777,8 +984,20 @@ CCObject* CC3MeshNode::copyWithZone( CCZone* zone )
 void CC3MeshNode::createGLBuffers()
 {
 	//LogTrace(@"%@ creating GL server buffers", self);
+	// Don't quantize content that the shader program would read without decoding
+	CCObject* pObj;
+	if ( m_pMesh && m_pMesh->shouldQuantizeVertexContent() && !canDrawQuantizedVertexContent() )
+	{
+		m_pMesh->setShouldQuantizeVertexContent( false );
+		CCARRAY_FOREACH( m_lodMeshes, pObj )
+			((CC3Mesh*)pObj)->setShouldQuantizeVertexContent( false );
+	}
+
 	if ( m_pMesh )
 		m_pMesh->createGLBuffers();
+
+	CCARRAY_FOREACH( m_lodMeshes, pObj )
+		((CC3Mesh*)pObj)->createGLBuffers();
 	
 	super::createGLBuffers();
 }
@@ -787,6 +1006,10 @@ void CC3MeshNode::deleteGLBuffers()
 {
 	if ( m_pMesh )
 		m_pMesh->deleteGLBuffers();
+
+	CCObject* pObj;
+	CCARRAY_FOREACH( m_lodMeshes, pObj )
+		((CC3Mesh*)pObj)->deleteGLBuffers();
 	
 	super::deleteGLBuffers();
 }
@@ -804,6 +1027,10 @@ void CC3MeshNode::releaseRedundantContent()
 	if ( m_pMesh )
 		m_pMesh->releaseRedundantContent();
 
+	CCObject* pObj;
+	CCARRAY_FOREACH( m_lodMeshes, pObj )
+		((CC3Mesh*)pObj)->releaseRedundantContent();
+
 	super::releaseRedundantContent();
 }
 
@@ -1114,8 +1341,9 @@ void CC3MeshNode::updateLightPosition()
 /** Template method to draw the mesh to the GL engine. */
 void CC3MeshNode::drawMeshWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
-	if ( m_pMesh )
-		m_pMesh->drawWithVisitor( visitor ); 
+	CC3Mesh* drawingMesh = getDrawingMesh();
+	if ( drawingMesh )
+		drawingMesh->drawWithVisitor( visitor ); 
 }
 
 CC3VertexContent CC3MeshNode::getVertexContentTypes() 
@@ -1603,6 +1831,11 @@ bool CC3MeshNode::isDrawingPointSprites()
 	return (getDrawingMode() == GL_POINTS) && (getTextureCount() > 0);
 }
 
+bool CC3MeshNode::isDrawingInstances()
+{
+	return false;
+}
+
 void CC3MeshNode::setShouldCacheFaces( bool cacheFaces )
 {
 	if ( m_pMesh )
@@ -1611,6 +1844,17 @@ void CC3MeshNode::setShouldCacheFaces( bool cacheFaces )
 	super::setShouldCacheFaces(cacheFaces);
 }
 
+bool CC3MeshNode::shouldBatchStatically()
+{
+	return m_shouldBatchStatically;
+}
+
+void CC3MeshNode::setShouldBatchStatically( bool shouldBatch )
+{
+	m_shouldBatchStatically = shouldBatch;
+	super::setShouldBatchStatically( shouldBatch );
+}
+
 void CC3MeshNode::populateAsTriangle( const CC3Face& face, ccTex2F* texCoords, GLuint divsPerSide )
 {
 	prepareParametricMesh()->populateAsTriangle( face, texCoords, divsPerSide );
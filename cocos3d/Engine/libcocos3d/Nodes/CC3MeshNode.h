@@ -32,6 +32,13 @@
 
 NS_COCOS3D_BEGIN
 class CC3Material;
+class CC3Camera;
+
+/** The projected screen size below which the first reduced level-of-detail mesh generated for a mesh node is used. */
+#define kCC3DefaultLODScreenSize		0.5f
+
+/** The default fraction of each LOD screen size that the projected size of a mesh node must pass before its level of detail changes. */
+#define kCC3DefaultLODHysteresis		0.1f
 
 /**
  * A CC3Node that draws a 3D mesh.
@@ -89,6 +96,7 @@ class CC3ShaderContext;
 class CC3ShaderProgram;
 class CC3Texture;
 class CC3Mesh;
+class CC3VertexArray;
 
 class CC3MeshNode : public CC3LocalContentNode
 {
@@ -132,6 +140,127 @@ public:
 	 */
 	virtual CC3Mesh*			makeMesh();
 
+	/**
+	 * Returns the number of levels of detail available to this node. Level zero is the mesh in the
+	 * mesh property, and each additional level is a reduced mesh, added using the addLODMesh or
+	 * generateLODMeshes methods. Returns one if this node has no reduced meshes.
+	 */
+	GLuint						getLODLevelCount();
+
+	/**
+	 * Returns the mesh used at the specified level of detail, or NULL if the level is not less than the
+	 * value returned by the getLODLevelCount method. Level zero returns the mesh in the mesh property.
+	 */
+	CC3Mesh*					getLODMeshAt( GLuint lodLevel );
+
+	/**
+	 * Adds the specified mesh as the next, coarser, level of detail of this node. The mesh is used
+	 * when the projected screen size of this node, as returned by the getProjectedScreenSize method,
+	 * falls below the specified screen size. Meshes must be added in order of decreasing screen size.
+	 *
+	 * The reduced mesh is usually created by simplifying the mesh in the mesh property, using the
+	 * CC3MeshSimplifier class, and shares the vertex arrays of that mesh.
+	 */
+	void						addLODMesh( CC3Mesh* lodMesh, GLfloat screenSize );
+
+	/** Removes all reduced level-of-detail meshes from this node, and returns it to level zero. */
+	void						removeAllLODMeshes();
+
+	/**
+	 * Returns the projected screen size below which the mesh at the specified level of detail is used.
+	 * Level zero, and levels not less than the value returned by the getLODLevelCount method, return zero.
+	 */
+	GLfloat						getLODScreenSizeAt( GLuint lodLevel );
+
+	/**
+	 * Sets the projected screen size below which the mesh at the specified level of detail is used.
+	 * The screen sizes of the levels must decrease with each level. Has no effect on level zero.
+	 */
+	void						setLODScreenSize( GLfloat screenSize, GLuint lodLevel );
+
+	/**
+	 * Replaces any existing reduced level-of-detail meshes of this node with the specified number of
+	 * meshes, each simplified from the mesh in the mesh property using a CC3MeshSimplifier, and each
+	 * containing the specified fraction of the triangles of the previous level. Fewer levels are
+	 * created if the mesh cannot be reduced further. Then invokes the superclass implementation to
+	 * generate reduced meshes for any descendant nodes.
+	 *
+	 * The first reduced mesh is used below a projected screen size of kCC3DefaultLODScreenSize, and the
+	 * screen size of each subsequent level is reduced by the square root of the triangle ratio, so that
+	 * the number of triangles drawn per unit of screen area remains roughly constant across levels.
+	 * The screen sizes can be changed afterwards using the setLODScreenSize method.
+	 */
+	virtual void				generateLODMeshes( GLuint lodCount, GLfloat triangleRatio );
+
+	/**
+	 * The level of detail at which this node is drawn. Level zero draws the mesh in the mesh property.
+	 *
+	 * If the shouldSelectLODLevel property is set to YES, this property is set automatically each time
+	 * this node is drawn by the active camera of the scene. Setting this property clamps the value to
+	 * the levels available.
+	 */
+	GLuint						getLODLevel();
+	void						setLODLevel( GLuint lodLevel );
+
+	/**
+	 * Indicates whether the lodLevel property should be selected automatically, from the projected
+	 * screen size of this node, each time this node is drawn by the active camera of the scene.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldSelectLODLevel();
+	void						setShouldSelectLODLevel( bool shouldSelect );
+
+	/**
+	 * The fraction of each LOD screen size by which the projected screen size of this node must pass
+	 * that screen size before the level of detail changes. This keeps a node that is hovering near a
+	 * screen size from switching back and forth between levels of detail on successive frames.
+	 *
+	 * The initial value of this property is kCC3DefaultLODHysteresis.
+	 */
+	GLfloat						getLODHysteresis();
+	void						setLODHysteresis( GLfloat hysteresis );
+
+	/**
+	 * Returns the size of this node when projected by the specified camera, as the fraction of the
+	 * height of the viewport that is covered by the diameter of the bounding sphere of the mesh.
+	 * Returns zero if this node has no mesh.
+	 */
+	GLfloat						getProjectedScreenSize( CC3Camera* camera );
+
+	/**
+	 * Selects the lodLevel property from the projected screen size of this node, as seen by the camera
+	 * of the specified visitor. Does nothing if this node has no reduced level-of-detail meshes, if the
+	 * shouldSelectLODLevel property is set to NO, or if the visitor is not drawing with the active camera
+	 * of the scene, such as when drawing from the viewpoint of a light or environment map.
+	 *
+	 * This method is invoked automatically by the visitor before this node is drawn.
+	 */
+	virtual void				selectLODWithVisitor( CC3NodeDrawingVisitor* visitor );
+
+	/**
+	 * Returns the mesh at the level of detail indicated by the lodLevel property. This is the mesh
+	 * that is bound and drawn when this node is drawn.
+	 */
+	virtual CC3Mesh*			getDrawingMesh();
+
+	/**
+	 * Returns the number of faces presented to the GL engine each time this node is drawn.
+	 *
+	 * This implementation returns the number of faces in the mesh returned by the drawingMesh property.
+	 * Subclasses that draw only part of that mesh will override.
+	 */
+	virtual GLuint				getDrawingFaceCount();
+
+	/**
+	 * Returns the vertex array that should be bound to a shader attribute with the specified semantic
+	 * and semantic index when this node is drawn, or NULL if no vertex array matches the semantic.
+	 *
+	 * This implementation retrieves the vertex array from the mesh returned by the drawingMesh property.
+	 * Subclasses that hold additional vertex content, such as per-instance content, may override.
+	 */
+	virtual CC3VertexArray*		getVertexArrayForSemantic( GLenum semantic, GLuint semanticIndex );
+
 	/**
 	 * Returns whether the underlying vertex content has been loaded into GL engine vertex
 	 * buffer objects. Vertex buffer objects are engaged via the createGLBuffers method.
@@ -330,6 +459,24 @@ public:
 	virtual void				setShaderProgram( CC3ShaderProgram* program );
 	virtual CC3ShaderProgram*	getShaderProgram();
 
+	/**
+	 * Returns the shader program that has already been assigned to this node, or NULL if no
+	 * program has been assigned yet.
+	 *
+	 * Unlike the shaderProgram property, this method does not create a shader context, and
+	 * does not select a shader program, and can be used where neither side effect is wanted.
+	 */
+	CC3ShaderProgram*			getAssignedShaderProgram();
+
+	/**
+	 * Returns whether the shader program used by this node can decode quantized vertex content.
+	 *
+	 * If a shader program has not yet been assigned, the program that would be selected for this
+	 * node is checked, without assigning it. Invoked from createGLBuffers, which does not quantize
+	 * the vertex content of the meshes of this node if this method returns NO.
+	 */
+	bool						canDrawQuantizedVertexContent();
+
 	/**
 	 * Selects an appropriate shader program for this mesh node, and returns that shader program.
 	 *
@@ -847,6 +994,12 @@ public:
 	 */
 	virtual bool				isDrawingPointSprites();
 
+	/**
+	 * Returns whether this node draws many instances of its mesh, each with its own transform
+	 * and color. This implementation returns NO. Subclasses that draw instances will return YES.
+	 */
+	virtual bool				isDrawingInstances();
+
 	/**
 	 * Returns whether any of the textures used by this material have an alpha channel, representing opacity.
 	 *
@@ -1618,6 +1771,16 @@ public:
 	virtual void				setShouldCacheFaces( bool cacheFaces );
 	virtual bool				shouldCacheFaces();
 
+	/**
+	 * Indicates whether this mesh node never moves, and may be merged with other static mesh
+	 * nodes into a combined static batch by a CC3StaticBatcher. See the notes for the
+	 * CC3StaticBatcher class for more information.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	virtual void				setShouldBatchStatically( bool shouldBatch );
+	virtual bool				shouldBatchStatically();
+
 	/**
 	 * Returns the number of faces in this mesh.
 	 *
@@ -2559,6 +2722,10 @@ public:
 
 protected:
 	CC3Mesh*					m_pMesh;
+	CCArray*					m_lodMeshes;
+	std::vector<GLfloat>		m_lodScreenSizes;
+	GLuint						m_lodLevel;
+	GLfloat						m_lodHysteresis;
 	CC3Material*				m_pMaterial;
 	CC3ShaderContext*			m_pShaderContext;
 	std::string					m_renderStreamGroupMarker;
@@ -2581,6 +2748,8 @@ protected:
 	bool						m_shouldCastShadowsWhenInvisible : 1;
 	bool						m_shouldApplyOpacityAndColorToMeshContent : 1;
 	bool						m_hasRigidSkeleton : 1;		// Used by skinned mesh node subclasses
+	bool						m_shouldSelectLODLevel : 1;
+	bool						m_shouldBatchStatically : 1;
 };
 
 NS_COCOS3D_END
@@ -41,8 +41,15 @@ CC3Node::CC3Node()
 	m_globalRotationMatrix = NULL;
 	m_pBoundingVolume = NULL;
 	m_pTransformListeners = NULL;
+	m_pTransformStore = NULL;
+	m_transformStoreIndex = kCC3NodeTransformStoreNoIndex;
+	m_pBoundingVolumeHierarchy = NULL;
+	m_boundingVolumeHierarchyIndex = kCC3BoundingVolumeHierarchyNoIndex;
+	m_pNodeIndex = NULL;
 	m_rotator = NULL;
 	m_pAnimationStates = NULL;
+	m_pPoseEngine = NULL;
+	m_pAnimationUpdatePolicy = NULL;
 
 	m_scale = cc3v( 1.f, 1.f, 1.f );
 	m_location = CC3Vector::kCC3VectorZero;
@@ -74,6 +81,7 @@ CC3Node::CC3Node()
 
 CC3Node::~CC3Node()
 {
+	CC_SAFE_RELEASE_NULL( m_pNodeIndex );
 	setTarget( NULL );
 	removeAllChildren();
 	notifyDestructionListeners();
@@ -87,6 +95,8 @@ CC3Node::~CC3Node()
 	CC_SAFE_RELEASE( m_rotator );
 	CC_SAFE_RELEASE( m_pBoundingVolume );
 	CC_SAFE_RELEASE( m_pAnimationStates );
+	CC_SAFE_RELEASE( m_pPoseEngine );
+	CC_SAFE_RELEASE( m_pAnimationUpdatePolicy );
 	CC_SAFE_RELEASE( m_pTransformListeners );
 }
 
@@ -740,6 +750,30 @@ void CC3Node::setShouldCacheFaces( bool shouldCache )
 	}
 }
 
+bool CC3Node::shouldBatchStatically()
+{
+	CCObject* child;
+	CCARRAY_FOREACH( m_pChildren, child )
+	{
+		CC3Node* pChild = (CC3Node*) child;
+		if ( pChild && pChild->shouldBatchStatically() )
+			return true;
+	}
+
+	return false;
+}
+
+void CC3Node::setShouldBatchStatically( bool shouldBatch )
+{
+	CCObject* child;
+	CCARRAY_FOREACH( m_pChildren, child )
+	{
+		CC3Node* pChild = (CC3Node*) child;
+		if ( pChild )
+			pChild->setShouldBatchStatically( shouldBatch );
+	}
+}
+
 bool CC3Node::shouldCastShadowsWhenInvisible()
 {
 	CCObject* child;
@@ -1856,6 +1890,17 @@ void CC3Node::deleteGLBuffers()
 	}
 }
 
+void CC3Node::generateLODMeshes( GLuint lodCount, GLfloat triangleRatio )
+{
+	CCObject* object;
+	CCARRAY_FOREACH( m_pChildren, object )
+	{
+		CC3Node* child = (CC3Node*)object;
+		if ( child )
+			child->generateLODMeshes( lodCount, triangleRatio );
+	}
+}
+
 void CC3Node::releaseRedundantContent()
 {
 	CCObject* object;
@@ -2297,6 +2342,8 @@ void CC3Node::setZOrder( GLint zOrder )
 void CC3Node::processUpdateBeforeTransform( CC3NodeUpdatingVisitor* visitor )
 {
 	checkCameraTarget();
+	if ( m_pAnimationUpdatePolicy )
+		m_pAnimationUpdatePolicy->updateWithVisitor( visitor );
 	updateFromAnimationState();
 	updateBeforeTransform( visitor );
 }
@@ -2384,7 +2431,8 @@ void CC3Node::removeAllTransformListeners()
 
 void CC3Node::notifyTransformListeners()
 { 
-	if ( m_pTransformListeners )
+	// Listeners may live in other subtrees, so notifications are deferred during parallel updates
+	if ( m_pTransformListeners && !CC3NodeUpdatingVisitor::deferTransformNotification( this ) )
 		m_pTransformListeners->notifyTransformListeners();
 }
 
@@ -2440,6 +2488,12 @@ void CC3Node::markTransformDirty()
 
 	m_globalTransformMatrix->setIsDirty(  true );
 
+	if ( m_pTransformStore )
+		m_pTransformStore->markTransformDirtyAt( m_transformStoreIndex );
+
+	if ( m_pBoundingVolumeHierarchy )
+		m_pBoundingVolumeHierarchy->markBoundsDirtyAt( m_boundingVolumeHierarchyIndex );
+
 	if ( m_globalTransformMatrixInverted )
 		m_globalTransformMatrixInverted->setIsDirty(  true );
 
@@ -2522,6 +2576,82 @@ void CC3Node::buildGlobalTransformMatrix()
 	m_globalTransformMatrix->setIsDirty( false );
 }
 
+void CC3Node::buildGlobalTransformMatrixFrom( const CC3Matrix4x3* parentTransform )
+{
+	// The transform may already have been built lazily
+	if ( !m_globalTransformMatrix->isDirty() )
+		return;
+
+	if ( parentTransform )
+		m_globalTransformMatrix->populateFromCC3Matrix4x3( (CC3Matrix4x3*)parentTransform );
+	else
+		m_globalTransformMatrix->populateFrom( m_pParent ? m_pParent->getGlobalTransformMatrix() : NULL );
+
+	if ( m_localTransformMatrix )
+		m_globalTransformMatrix->multiplyBy( getLocalTransformMatrix() );
+	else
+		applyLocalTransformsTo( m_globalTransformMatrix );
+
+	m_globalTransformMatrix->setIsDirty( false );
+}
+
+bool CC3Node::populateBatchedLocalTransform( CC3Matrix* matrix )
+{
+	if ( !m_globalTransformMatrix->isDirty() || shouldUpdateToTarget() || shouldRotateToTargetLocation() )
+		return false;
+
+	if ( m_localTransformMatrix )
+	{
+		matrix->populateFrom( getLocalTransformMatrix() );
+	}
+	else
+	{
+		matrix->populateIdentity();
+		applyLocalTransformsTo( matrix );
+	}
+	return true;
+}
+
+void CC3Node::markGlobalTransformMatrixBuilt()
+{
+	m_globalTransformMatrix->setIsDirty( false );
+}
+
+CC3NodeTransformStore* CC3Node::getTransformStore()
+{
+	return m_pTransformStore;
+}
+
+GLint CC3Node::getTransformStoreIndex()
+{
+	return m_transformStoreIndex;
+}
+
+void CC3Node::setTransformStore( CC3NodeTransformStore* store, GLint index )
+{
+	m_pTransformStore = store;			// weak reference
+	m_transformStoreIndex = index;
+
+	// While this node is held in a store, its global transform lives in the contiguous array of the store
+	((CC3AffineMatrix*)m_globalTransformMatrix)->setExternalContents( store ? store->getGlobalTransformAt( index ) : NULL );
+}
+
+CC3BoundingVolumeHierarchy* CC3Node::getBoundingVolumeHierarchy()
+{
+	return m_pBoundingVolumeHierarchy;
+}
+
+GLint CC3Node::getBoundingVolumeHierarchyIndex()
+{
+	return m_boundingVolumeHierarchyIndex;
+}
+
+void CC3Node::setBoundingVolumeHierarchy( CC3BoundingVolumeHierarchy* hierarchy, GLint index )
+{
+	m_pBoundingVolumeHierarchy = hierarchy;		// weak reference
+	m_boundingVolumeHierarchyIndex = index;
+}
+
 /**
  * Template method that applies the local location, rotation and scale properties to
  * the specified matrix. Subclasses may override to enhance or modify this behaviour.
@@ -2778,6 +2908,17 @@ void CC3Node::setBoundingVolume( CC3NodeBoundingVolume * aBoundingVolume )
 	CC_SAFE_RELEASE( m_pBoundingVolume );
 	m_pBoundingVolume = aBoundingVolume;
 	CC_SAFE_RETAIN( aBoundingVolume );
+
+	// The hierarchy holds only nodes with bounding volumes, so it must be rebuilt. If this node
+	// is not yet held in the hierarchy, the hierarchy may be found through the scene.
+	CC3BoundingVolumeHierarchy* bvh = m_pBoundingVolumeHierarchy;
+	if ( !bvh )
+	{
+		CC3Scene* scene = getScene();
+		bvh = scene ? scene->getBoundingVolumeHierarchy() : NULL;
+	}
+	if ( bvh )
+		bvh->markStructureDirty();
 	
 	if ( m_pBoundingVolume )
 	{
@@ -2857,6 +2998,9 @@ void CC3Node::markBoundingVolumeDirty()
 	{
 		if ( m_pBoundingVolume )
 			m_pBoundingVolume->markDirty();
+
+		if ( m_pBoundingVolumeHierarchy )
+			m_pBoundingVolumeHierarchy->markBoundsDirtyAt( m_boundingVolumeHierarchyIndex );
 	}
 }
 
@@ -3226,6 +3370,9 @@ bool CC3Node::isDescendantOf( CC3Node* aNode )
  */
 void CC3Node::didAddDescendant( CC3Node* aNode )
 {
+	if ( m_pNodeIndex )
+		m_pNodeIndex->addNode( aNode );
+
 	if ( m_pParent )
 		m_pParent->didAddDescendant( aNode );
 }
@@ -3239,6 +3386,9 @@ void CC3Node::didAddDescendant( CC3Node* aNode )
  */
 void CC3Node::didRemoveDescendant( CC3Node* aNode )
 {
+	if ( m_pNodeIndex )
+		m_pNodeIndex->removeNode( aNode );
+
 	if ( m_pParent )
 		m_pParent->didRemoveDescendant( aNode );
 }
@@ -3257,6 +3407,10 @@ void CC3Node::descendantDidModifySequencingCriteria( CC3Node* aNode )
 
 CC3Node* CC3Node::getNodeNamed( const char* aName )
 {
+	// Unnamed nodes are not indexed
+	if ( m_pNodeIndex && aName && aName[0] )
+		return m_pNodeIndex->getNodeNamed( aName );
+
 	// First see if it's me
 	if (m_sName.compare(aName) == 0 || (m_sName.empty() && !aName)) 
 		return this;
@@ -3278,6 +3432,9 @@ CC3Node* CC3Node::getNodeNamed( const char* aName )
 
 CC3Node* CC3Node::getNodeTagged( GLuint aTag )
 {
+	if ( m_pNodeIndex )
+		return m_pNodeIndex->getNodeTagged( aTag );
+
 	if ( m_nTag == aTag ) 
 		return this;
 
@@ -3296,6 +3453,58 @@ CC3Node* CC3Node::getNodeTagged( GLuint aTag )
 	return NULL;
 }
 
+bool CC3Node::shouldUseNodeIndex()
+{
+	return m_pNodeIndex != NULL;
+}
+
+void CC3Node::setShouldUseNodeIndex( bool shouldUse )
+{
+	if ( shouldUse == shouldUseNodeIndex() )
+		return;
+
+	CC_SAFE_RELEASE_NULL( m_pNodeIndex );
+
+	if ( shouldUse )
+	{
+		m_pNodeIndex = CC3NodeIndex::indexWithRootNode( this );
+		m_pNodeIndex->retain();
+	}
+}
+
+CC3NodeIndex* CC3Node::getNodeIndex()
+{
+	return m_pNodeIndex;
+}
+
+/** Removes this node from each node index above it, changes the name, then re-adds it. */
+void CC3Node::setName( const std::string& name )
+{
+	for (CC3Node* n = this; n; n = n->m_pParent)
+		if ( n->m_pNodeIndex )
+			n->m_pNodeIndex->nodeWillChangeIdentity( this );
+
+	super::setName( name );
+
+	for (CC3Node* n = this; n; n = n->m_pParent)
+		if ( n->m_pNodeIndex )
+			n->m_pNodeIndex->nodeDidChangeIdentity( this );
+}
+
+/** Removes this node from each node index above it, changes the tag, then re-adds it. */
+void CC3Node::setTag( GLuint tag )
+{
+	for (CC3Node* n = this; n; n = n->m_pParent)
+		if ( n->m_pNodeIndex )
+			n->m_pNodeIndex->nodeWillChangeIdentity( this );
+
+	super::setTag( tag );
+
+	for (CC3Node* n = this; n; n = n->m_pParent)
+		if ( n->m_pNodeIndex )
+			n->m_pNodeIndex->nodeDidChangeIdentity( this );
+}
+
 CCArray* CC3Node::flatten()
 {
 	CCArray* allNodes = CCArray::create();
@@ -3550,7 +3759,30 @@ CC3NodePuncturingVisitor* CC3Node::nodesIntersectedByGlobalRay( const CC3Ray& aR
 
 CC3Node* CC3Node::closestNodeIntersectedByGlobalRay( const CC3Ray& aRay )
 {
-	return nodesIntersectedByGlobalRay( aRay )->getClosestPuncturedNode();
+	CC3NodePuncturingVisitor* pnv = CC3NodePuncturingVisitor::visitorWithRay( aRay );
+	pnv->setShouldCollectClosestOnly( true );
+	pnv->visit( this );
+	return pnv->getClosestPuncturedNode();
+}
+
+void CC3Node::closestNodesIntersectedByGlobalRays( GLuint rayCount, const CC3Ray* rays,
+												   CC3Node** closestNodes, CC3Vector* globalLocations )
+{
+	if ( rayCount == 0 )
+		return;
+
+	CC3NodePuncturingVisitor* pnv = CC3NodePuncturingVisitor::visitorWithRay( rays[0] );
+	pnv->setShouldCollectClosestOnly( true );
+
+	for (GLuint rayIdx = 0; rayIdx < rayCount; rayIdx++)
+	{
+		pnv->setRay( rays[rayIdx] );
+		pnv->visit( this );
+
+		closestNodes[rayIdx] = pnv->getClosestPuncturedNode();
+		if ( globalLocations )
+			globalLocations[rayIdx] = pnv->getClosestGlobalPunctureLocation();
+	}
 }
 
 /** Suffix used to name the descriptor child node. */
@@ -4605,11 +4837,72 @@ void CC3Node::markAnimationDirty()
 	m_isAnimationDirty = true; 
 }
 
+bool CC3Node::isAnimationDirty()
+{
+	return m_isAnimationDirty;
+}
+
+void CC3Node::markAnimationClean()
+{
+	m_isAnimationDirty = false;
+}
+
+CC3PoseEngine* CC3Node::getPoseEngine()
+{
+	return m_pPoseEngine;
+}
+
+void CC3Node::setPoseEngine( CC3PoseEngine* poseEngine )
+{
+	if ( poseEngine == m_pPoseEngine )
+		return;
+
+	CC_SAFE_RELEASE( m_pPoseEngine );
+	m_pPoseEngine = poseEngine;
+	CC_SAFE_RETAIN( poseEngine );
+
+	markAnimationDirty();
+}
+
+bool CC3Node::isPosedByPoseEngine()
+{
+	for (CC3Node* pNode = this; pNode; pNode = pNode->getParent())
+	{
+		if ( pNode->getPoseEngine() )
+			return true;
+	}
+	return false;
+}
+
+CC3AnimationUpdatePolicy* CC3Node::getAnimationUpdatePolicy()
+{
+	return m_pAnimationUpdatePolicy;
+}
+
+void CC3Node::setAnimationUpdatePolicy( CC3AnimationUpdatePolicy* policy )
+{
+	if ( policy == m_pAnimationUpdatePolicy )
+		return;
+
+	CC_SAFE_RELEASE( m_pAnimationUpdatePolicy );
+	m_pAnimationUpdatePolicy = policy;
+	CC_SAFE_RETAIN( policy );
+}
+
 void CC3Node::establishAnimationFrameAt( float t, GLuint trackID )
 {
+	if ( m_pAnimationUpdatePolicy && m_pAnimationUpdatePolicy->deferAnimationFrameAt( t, trackID ) )
+		return;
+
+	// Under a pose engine, the frame is evaluated when the engine samples all of its bones
 	CC3NodeAnimationState* pAnimState = getAnimationStateOnTrack(trackID);
 	if ( pAnimState )
-		pAnimState->establishFrameAt( t );
+	{
+		if ( isPosedByPoseEngine() )
+			pAnimState->deferFrameAt( t );
+		else
+			pAnimState->establishFrameAt( t );
+	}
 
 	CCObject* pObj = NULL;
 	CCARRAY_FOREACH( m_pChildren, pObj )
@@ -4622,6 +4915,11 @@ void CC3Node::establishAnimationFrameAt( float t, GLuint trackID )
 /** Updates this node from a blending of any contained animation. */
 void CC3Node::updateFromAnimationState()
 {
+	// A pose engine updates this node and its animated descendants in one pass,
+	// and marks each of them as clean, so the blending below is skipped.
+	if ( m_pPoseEngine )
+		m_pPoseEngine->applyPose();
+
 	if ( !m_isAnimationDirty ) 
 		return;
 
@@ -51,6 +51,17 @@ typedef enum
 	kCC3NormalScalingAutomatic,		/**< Automatically determine optimal normal scaling method. */
 } CC3NormalScaling;
 
+/**
+ * Enumeration of the ways in which the animation of a node may be evaluated on each update,
+ * as determined by the CC3AnimationUpdatePolicy of the node.
+ */
+typedef enum
+{
+	kCC3AnimationUpdateFull = 0,		/**< Animation was evaluated at the full update rate. */
+	kCC3AnimationUpdateReduced,			/**< Animation was evaluated at a reduced update rate. */
+	kCC3AnimationUpdateSkipped,			/**< Evaluation of the animation was skipped. */
+} CC3AnimationUpdateLevel;
+
 class CC3GLMatrix;
 class CC3NodeDrawingVisitor;
 class CC3NodeBoundingVolume;
@@ -71,9 +82,14 @@ class CC3ShaderContext;
 class CC3ShaderProgram;
 class CC3SoftBodyNode;
 class CC3NodesResource;
+class CC3NodeTransformStore;
+class CC3BoundingVolumeHierarchy;
+class CC3NodeIndex;
 class CC3ShadowVolumeMeshNode;
 class CC3Action;
 class CC3Light;
+class CC3PoseEngine;
+class CC3AnimationUpdatePolicy;
 
 class CC3Node : public CC3Identifiable, 
 	public CCBlendProtocol, 
@@ -986,6 +1002,20 @@ public:
 	virtual void				setShouldCacheFaces( bool cache );
 	virtual bool				shouldCacheFaces();
 
+	/**
+	 * Indicates whether the mesh nodes among the descendants of this node never move, and may be
+	 * merged with other static mesh nodes into combined static batches by a CC3StaticBatcher,
+	 * either explicitly, or when the scene is opened. See the notes for the CC3StaticBatcher
+	 * class for more information.
+	 *
+	 * Setting this value sets the same property on all descendant nodes.
+	 *
+	 * Querying this property returns YES if any of the descendant mesh nodes have this property
+	 * set to YES. Initially, all mesh nodes have this property set to NO.
+	 */
+	virtual void				setShouldBatchStatically( bool shouldBatch );
+	virtual bool				shouldBatchStatically();
+
 	/**
 	 * Indicates whether this instance will disable the GL depth mask while drawing the
 	 * content of this node. When the depth mask is disabled, drawing activity will not
@@ -1697,6 +1727,17 @@ public:
 	 */
 	virtual void				createGLBuffers();
 
+	/**
+	 * Generates reduced level-of-detail meshes for all descendant mesh nodes. Default behaviour is to
+	 * invoke the same method on all child nodes. CC3MeshNode overrides to simplify its own mesh into
+	 * the specified number of reduced meshes, each containing the specified fraction of the triangles
+	 * of the previous level. See the notes for that method in CC3MeshNode for more info.
+	 *
+	 * This method must be invoked while the vertex content is still in memory, and so should be
+	 * invoked before the releaseRedundantContent method.
+	 */
+	virtual void				generateLODMeshes( GLuint lodCount, GLfloat triangleRatio );
+
 	/**
 	 * Deletes any OpenGL buffers that were created by any descendant nodes via a prior invocation
 	 * of createGLBuffers. If the descendant nodes also retained the vertex content locally, drawing
@@ -2394,6 +2435,61 @@ public:
 	virtual CC3Matrix*			getGlobalTransformMatrix();
 	virtual void				buildGlobalTransformMatrix();
 
+	/**
+	 * Builds the globalTransformMatrix of this node, if it is dirty, from the specified global
+	 * transform of the parent node. If the parent transform is NULL, the globalTransformMatrix
+	 * of the parent node is used.
+	 *
+	 * This method is invoked automatically by the CC3NodeTransformStore holding this node, during
+	 * its linear transform pass. Usually the application never needs to invoke this method directly.
+	 */
+	void						buildGlobalTransformMatrixFrom( const CC3Matrix4x3* parentTransform );
+
+	/**
+	 * If the globalTransformMatrix of this node is dirty, and can be built by applying the global
+	 * transform of the parent node to a local transform that does not depend on the global transform
+	 * of this node, populates the specified matrix with that local transform, and returns true.
+	 * Otherwise, returns false, and leaves the matrix unchanged. The local transform of a node that
+	 * rotates to face a target location depends on its own global location, so this method returns
+	 * false for such nodes.
+	 *
+	 * This method is invoked automatically by the CC3NodeTransformStore holding this node, to build
+	 * the global transforms of adjacent sibling nodes in a single batch. Once it has done so, the
+	 * store invokes markGlobalTransformMatrixBuilt on each node. Usually the application never needs
+	 * to invoke these methods directly.
+	 */
+	bool						populateBatchedLocalTransform( CC3Matrix* matrix );
+
+	/** Marks the globalTransformMatrix of this node as built, once it has been built in a batch by the transform store. */
+	void						markGlobalTransformMatrixBuilt();
+
+	/**
+	 * The transform store that holds the global transform of this node, and the index of this node
+	 * within that store, or NULL and kCC3NodeTransformStoreNoIndex if this node is not held in a
+	 * transform store.
+	 *
+	 * While this node is held in a transform store, the contents of the globalTransformMatrix of
+	 * this node are held in the contiguous transform array of that store.
+	 *
+	 * These properties are set automatically by the transform store. Usually the application
+	 * never needs to set them directly.
+	 */
+	CC3NodeTransformStore*		getTransformStore();
+	GLint						getTransformStoreIndex();
+	void						setTransformStore( CC3NodeTransformStore* store, GLint index );
+
+	/**
+	 * The bounding volume hierarchy that holds this node as a leaf, and the index of that leaf,
+	 * or NULL and kCC3BoundingVolumeHierarchyNoIndex if this node is not held in a bounding
+	 * volume hierarchy.
+	 *
+	 * These properties are set automatically by the bounding volume hierarchy. Usually the
+	 * application never needs to set them directly.
+	 */
+	CC3BoundingVolumeHierarchy*	getBoundingVolumeHierarchy();
+	GLint						getBoundingVolumeHierarchyIndex();
+	void						setBoundingVolumeHierarchy( CC3BoundingVolumeHierarchy* hierarchy, GLint index );
+
 	/**
 	 * Returns the matrix inversion of the globalTransformMatrix.
 	 *
@@ -2979,15 +3075,45 @@ public:
 	/**
 	 * Retrieves the first node found with the specified name, anywhere in the structural hierarchy
 	 * of descendants of this node (not just direct children). The hierarchy search is depth-first.
+	 *
+	 * If the shouldUseNodeIndex property of this node is YES, the node is retrieved from the
+	 * nodeIndex, with the same result as the depth-first search.
 	 */
 	virtual CC3Node*			getNodeNamed( const char* aName );
 
 	/**
 	 * Retrieves the first node found with the specified tag, anywhere in the structural hierarchy
 	 * of descendants of this node (not just direct children). The hierarchy search is depth-first.
+	 *
+	 * If the shouldUseNodeIndex property of this node is YES, the node is retrieved from the
+	 * nodeIndex, with the same result as the depth-first search.
 	 */
 	virtual CC3Node*			getNodeTagged( GLuint aTag );
 
+	/**
+	 * Indicates whether the names and tags of this node and all of its descendants are held in a
+	 * hashed index, so that the getNodeNamed: and getNodeTagged: methods of this node do not need
+	 * to search the structural hierarchy.
+	 *
+	 * The index is kept up to date as descendants are added and removed, and as their names and
+	 * tags are changed. Setting this property to YES can greatly reduce the cost of retrieving
+	 * nodes by name or tag from large node assemblies, such as a scene or a character rig. See
+	 * the notes for the CC3NodeIndex class for more information.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUseNodeIndex();
+	void						setShouldUseNodeIndex( bool shouldUse );
+
+	/** The index holding the names and tags of this node and its descendants, or NULL if not used. */
+	CC3NodeIndex*				getNodeIndex();
+
+	/** Overridden to update any node index holding this node. */
+	virtual void				setName( const std::string& name );
+
+	/** Overridden to update any node index holding this node. */
+	virtual void				setTag( GLuint tag );
+
 	/**
 	 * Returns whether this node is the same object as the specified node, or is a structural
 	 * descendant (child, grandchild, etc) of the specified node.
@@ -3449,13 +3575,31 @@ public:
 	 * instance of CC3NodePuncturingVisitor, cache it, and invoke the visit: method
 	 * repeatedly, with or without changing the ray between invocations.
 	 *
-	 * This implementation simply invokes the nodesIntersectedByGlobalRay:
-	 * method, and reads the value of the closestPuncturedNode from the
-	 * CC3NodePuncturingVisitor returned by that method. See the notes
+	 * This implementation creates an instance of CC3NodePuncturingVisitor on the specified ray,
+	 * with its shouldCollectClosestOnly property set to YES, invokes the visit: method on that
+	 * visitor, and reads the value of the closestPuncturedNode from the visitor. See the notes
 	 * of the nodesIntersectedByGlobalRay: method for more info.
 	 */
 	virtual CC3Node*			closestNodeIntersectedByGlobalRay( const CC3Ray& aRay );
 
+	/**
+	 * Finds the descendant node that is punctured closest to the startLocation of each of the
+	 * specified global rays, using a single CC3NodePuncturingVisitor for all of the rays. This
+	 * node is included in the tests.
+	 *
+	 * The rays array must contain rayCount rays. For each ray, the corresponding element of the
+	 * closestNodes array is set to the closest punctured node, or to NULL if the ray punctures
+	 * no nodes. If the globalLocations array is not NULL, the corresponding element is set to the
+	 * global location of the puncture on that node, or to kCC3VectorNull if there is no puncture.
+	 *
+	 * The same nodes are excluded as with the closestNodeIntersectedByGlobalRay: method. When this
+	 * node is a CC3Scene whose shouldUseBoundingVolumeHierarchy property is set to YES, each ray
+	 * is tested only against the nodes whose boxes in the hierarchy it pierces, making this method
+	 * suitable for casting many rays each frame, such as for line-of-sight tests, or projectile hits.
+	 */
+	virtual void				closestNodesIntersectedByGlobalRays( GLuint rayCount, const CC3Ray* rays,
+																	 CC3Node** closestNodes, CC3Vector* globalLocations );
+
 	/**
 	 * Indicates whether this node should display a descriptive label on this node.
 	 *
@@ -4449,6 +4593,55 @@ public:
 	 */
 	virtual void				markAnimationDirty();
 
+	/** Returns whether the animated properties of this node need to be updated on the next update cycle. */
+	virtual bool				isAnimationDirty();
+
+	/**
+	 * Marks the animation state of this node as clean, indicating that the animated properties
+	 * of this node have already been updated from the current animation state.
+	 *
+	 * This method is invoked automatically by a CC3PoseEngine after it has written the current
+	 * pose to this node. Normally, the application never needs to invoke this method.
+	 */
+	virtual void				markAnimationClean();
+
+	/**
+	 * The pose engine used to evaluate the animation of this node and its descendants.
+	 *
+	 * When this property is set, the animation of this node and all of its animated descendants
+	 * is blended by the pose engine in a single batched pass when this node is updated, instead
+	 * of each node blending its own animation tracks. See CC3PoseEngine for more information.
+	 *
+	 * The pose engine is not copied when this node is copied. The initial value of this property is NULL.
+	 */
+	virtual CC3PoseEngine*		getPoseEngine();
+	virtual void				setPoseEngine( CC3PoseEngine* poseEngine );
+
+	/**
+	 * Returns whether the animation of this node is evaluated by the pose engine of this node,
+	 * or of one of its ancestors.
+	 *
+	 * When this method returns YES, the establishAnimationFrameAt:onTrack: method only records
+	 * the animation time on this node, and the pose engine evaluates the animation of all of
+	 * its bones together, when the root node of the pose engine is updated.
+	 */
+	virtual bool				isPosedByPoseEngine();
+
+	/**
+	 * The policy that determines how often the animation of this node and its descendants is
+	 * evaluated, based on the projected screen size of the node and whether it is within the
+	 * frustum of the camera.
+	 *
+	 * When this property is set, animation frames established on this node, through the
+	 * establishAnimationFrameAt:onTrack: method, are held by the policy, and are only applied
+	 * to this node and its descendants when the policy decides that the animation should be
+	 * evaluated during the update of this node. See CC3AnimationUpdatePolicy for more information.
+	 *
+	 * The policy is not copied when this node is copied. The initial value of this property is NULL.
+	 */
+	virtual CC3AnimationUpdatePolicy*	getAnimationUpdatePolicy();
+	virtual void				setAnimationUpdatePolicy( CC3AnimationUpdatePolicy* policy );
+
 
 	/**
 	 * Updates the location, quaternion and scale properties on the animation state wrapper associated
@@ -5210,7 +5403,12 @@ protected:
 	CC3Rotator*					m_rotator;
 	CC3NodeBoundingVolume*		m_pBoundingVolume;
 	CC3NodeTransformListeners*	m_pTransformListeners;
+	CC3NodeTransformStore*		m_pTransformStore;
+	CC3BoundingVolumeHierarchy*	m_pBoundingVolumeHierarchy;
+	CC3NodeIndex*				m_pNodeIndex;
 	CCArray*					m_pAnimationStates;
+	CC3PoseEngine*				m_pPoseEngine;
+	CC3AnimationUpdatePolicy*	m_pAnimationUpdatePolicy;
 
 	CC3Vector					m_location;
 	CC3Vector					m_projectedLocation;
@@ -5218,6 +5416,8 @@ protected:
 	
 	GLfloat						m_fBoundingVolumePadding;
 	GLfloat						m_fCameraDistanceProduct;
+	GLint						m_transformStoreIndex;
+	GLint						m_boundingVolumeHierarchyIndex;
 
 	bool						m_touchEnabled : 1;
 	bool						m_shouldInheritTouchability : 1;
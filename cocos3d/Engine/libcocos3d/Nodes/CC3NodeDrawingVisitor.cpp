@@ -34,6 +34,9 @@ NS_COCOS3D_BEGIN
 CC3NodeDrawingVisitor::CC3NodeDrawingVisitor()
 {
 	m_drawingSequencer = NULL;				// weak reference
+	m_pBoundingVolumeHierarchy = NULL;		// weak reference
+	m_isDrawingVisibleNodes = false;
+	m_pDrawCommandQueue = NULL;
 	m_currentSkinSection = NULL;				// weak reference
 	m_pGL = NULL;								// weak reference
 	m_surfaceManager = NULL;
@@ -46,8 +49,10 @@ CC3NodeDrawingVisitor::CC3NodeDrawingVisitor()
 CC3NodeDrawingVisitor::~CC3NodeDrawingVisitor()
 {
 	m_drawingSequencer = NULL;				// weak reference
+	m_pBoundingVolumeHierarchy = NULL;		// weak reference
 	m_currentSkinSection = NULL;				// weak reference
 	m_pGL = NULL;								// weak reference
+	CC_SAFE_RELEASE(m_pDrawCommandQueue);
 	CC_SAFE_RELEASE(m_surfaceManager);
 	CC_SAFE_RELEASE(m_renderSurface);
 	CC_SAFE_RELEASE(m_boneMatricesGlobal);
@@ -82,6 +87,8 @@ GLuint CC3NodeDrawingVisitor::getCurrent2DTextureUnit()
 	switch (m_textureBindingMode) {
 		case kCC3TextureBindingModeLightProbe:
 			return m_currentLightProbeTextureUnit;
+		case kCC3TextureBindingModeShadowMap:
+			return m_currentShadowMapTextureUnit;
 		case kCC3TextureBindingModeModel:
 			return m_current2DTextureUnit;
 	}
@@ -95,6 +102,9 @@ void CC3NodeDrawingVisitor::increment2DTextureUnit()
 		case kCC3TextureBindingModeLightProbe:
 			m_currentLightProbeTextureUnit++;
 			break;
+		case kCC3TextureBindingModeShadowMap:
+			m_currentShadowMapTextureUnit++;
+			break;
 		case kCC3TextureBindingModeModel:
 			m_current2DTextureUnit++;
 			break;
@@ -106,6 +116,8 @@ GLuint CC3NodeDrawingVisitor::getCurrentCubeTextureUnit()
 	switch (m_textureBindingMode) {
 		case kCC3TextureBindingModeLightProbe:
 			return m_currentLightProbeTextureUnit;
+		case kCC3TextureBindingModeShadowMap:
+			return m_currentShadowMapTextureUnit;
 		case kCC3TextureBindingModeModel:
 			return m_currentCubeTextureUnit;
 	}
@@ -119,6 +131,9 @@ void CC3NodeDrawingVisitor::incrementCubeTextureUnit()
 		case kCC3TextureBindingModeLightProbe:
 			m_currentLightProbeTextureUnit++;
 			break;
+		case kCC3TextureBindingModeShadowMap:
+			m_currentShadowMapTextureUnit++;
+			break;
 		case kCC3TextureBindingModeModel:
 			m_currentCubeTextureUnit++;
 			break;
@@ -163,8 +178,23 @@ bool CC3NodeDrawingVisitor::shouldDrawNode( CC3Node* aNode )
 			&& doesNodeIntersectFrustum( aNode );
 }
 
+/**
+ * If the node is held in the bounding volume hierarchy that was queried when this visitor
+ * was opened, the result of that query is used. Otherwise, the node is tested directly.
+ * When only the visible nodes are being visited, any node in the hierarchy is visible.
+ */
 bool CC3NodeDrawingVisitor::doesNodeIntersectFrustum( CC3Node* aNode )
 {
+	if ( m_pBoundingVolumeHierarchy && aNode->getBoundingVolumeHierarchy() == m_pBoundingVolumeHierarchy )
+	{
+		if ( m_isDrawingVisibleNodes )
+			return true;
+
+		GLint leafIndex = aNode->getBoundingVolumeHierarchyIndex();
+		if ( leafIndex >= 0 && leafIndex < (GLint)m_bvhVisibility.size() )
+			return m_bvhVisibility[leafIndex] != 0;
+	}
+
 	CC3Camera* pCam = getCamera();
 	CC3Frustum* pFrustum = pCam ? pCam->getFrustum() : NULL;
 	return aNode->doesIntersectFrustum( pFrustum );
@@ -185,7 +215,14 @@ bool CC3NodeDrawingVisitor::processChildrenOf( CC3Node* aNode )
 	bool currSVC = m_shouldVisitChildren;
 	
 	m_shouldVisitChildren = false;	// Don't delve into node hierarchy if using sequencer
-	m_drawingSequencer->visitNodesWithNodeVisitor( this );
+	if ( m_pBoundingVolumeHierarchy && m_isDrawingVisibleNodes )
+	{
+		// Index, rather than iterate, in case the visitor modifies the list
+		for (GLuint i = 0; i < m_visibleNodes.size(); i++)
+			visit( m_visibleNodes[i] );
+	}
+	else
+		m_drawingSequencer->visitNodesWithNodeVisitor( this );
 	
 	// Restore current node and whether children should be visited
 	m_shouldVisitChildren = currSVC;
@@ -204,6 +241,8 @@ void CC3NodeDrawingVisitor::open()
 	activateRenderSurface();
 	openScene();
 	openCamera();
+	openBoundingVolumeHierarchy();
+	openDrawCommandQueue();
 }
 
 /** 
@@ -247,11 +286,60 @@ void CC3NodeDrawingVisitor::openCamera()
 
 }
 
+/**
+ * Every node that may be drawn is either a leaf of the hierarchy or excluded from it, so the
+ * visible leaves and the excluded nodes together hold all nodes that need to be visited.
+ */
+void CC3NodeDrawingVisitor::openBoundingVolumeHierarchy()
+{
+	m_pBoundingVolumeHierarchy = NULL;
+	m_isDrawingVisibleNodes = false;
+	if ( !m_drawingSequencer )
+		return;
+
+	CC3Scene* scene = getScene();
+	CC3BoundingVolumeHierarchy* bvh = scene->getBoundingVolumeHierarchy();
+	CC3Camera* pCam = getCamera();
+	if ( !(bvh && pCam) )
+		return;
+
+	GLuint visibleCount = bvh->cullToFrustum( pCam->getFrustum(), m_bvhVisibleLeaves );
+	m_pBoundingVolumeHierarchy = bvh;
+
+	GLuint exCount = bvh->getExcludedNodeCount();
+	m_visibleNodes.clear();
+	m_visibleNodes.reserve( visibleCount + exCount );
+	for (GLuint i = 0; i < visibleCount; i++)
+		m_visibleNodes.push_back( bvh->getNodeAt( m_bvhVisibleLeaves[i] ) );
+	for (GLuint i = 0; i < exCount; i++)
+		m_visibleNodes.push_back( bvh->getExcludedNodeAt( i ) );
+
+	m_isDrawingVisibleNodes = m_drawingSequencer->sequenceNodes( m_visibleNodes, scene->getDrawingSequenceVisitor() );
+	if ( m_isDrawingVisibleNodes )
+		return;
+
+	// The whole sequence will be visited, so mark the visible leaves for lookup
+	m_bvhVisibility.assign( bvh->getLeafCount(), 0 );
+	for (GLuint i = 0; i < visibleCount; i++)
+		m_bvhVisibility[m_bvhVisibleLeaves[i]] = 1;
+}
+
+void CC3NodeDrawingVisitor::openDrawCommandQueue()
+{
+	m_isRecordingDrawCommands = (m_pDrawCommandQueue != NULL);
+	if ( m_isRecordingDrawCommands )
+		m_pDrawCommandQueue->beginRecording();
+}
+
 /** Close the camera. */
 void CC3NodeDrawingVisitor::close()
 {
+	closeDrawCommandQueue();
 	closeCamera();
 	m_drawingSequencer = NULL;
+	m_pBoundingVolumeHierarchy = NULL;
+	m_isDrawingVisibleNodes = false;
+	m_visibleNodes.clear();
 	super::close();
 }
 
@@ -263,8 +351,97 @@ void CC3NodeDrawingVisitor::closeCamera()
 		pCam->closeWithVisitor( this );
 }
 
+void CC3NodeDrawingVisitor::closeDrawCommandQueue()
+{
+	if ( !m_isRecordingDrawCommands )
+		return;
+
+	m_isRecordingDrawCommands = false;
+	m_pDrawCommandQueue->commit();
+
+	CC3Node* currNode = m_pCurrentNode;
+	m_pDrawCommandQueue->executeWithVisitor( this );
+	m_pCurrentNode = currNode;
+}
+
+/**
+ * Draws a node that was recorded in the drawCommandQueue, restoring the matrices that were
+ * current when it was recorded, in the same way that transformAndDrawWithVisitor: does.
+ */
+void CC3NodeDrawingVisitor::drawRecordedNode( CC3Node* aNode, const CC3Matrix4x3* modelMatrix,
+											  const CC3Matrix4x3* modelViewMatrix,
+											  const CC3Matrix4x4* modelViewProjMatrix,
+											  bool isMaterialBound, bool isMeshBound )
+{
+	m_pCurrentNode = aNode;
+	m_currentSkinSection = NULL;
+	m_isCurrentMaterialBound = isMaterialBound;
+	m_isCurrentMeshBound = isMeshBound;
+
+	CC3OpenGL* gl = getGL();
+	gl->pushModelviewMatrixStack();
+
+	m_modelMatrix = *modelMatrix;
+	m_modelViewMatrix = *modelViewMatrix;
+	m_modelViewProjMatrix = *modelViewProjMatrix;
+	m_isMVMtxDirty = false;
+	m_isMVPMtxDirty = false;
+
+	// For fixed rendering pipeline, also load onto the matrix stack
+	gl->loadModelviewMatrix( getModelViewMatrix() );
+
+	draw( aNode );
+
+	gl->popModelviewMatrixStack();
+
+	m_isCurrentMaterialBound = false;
+	m_isCurrentMeshBound = false;
+	m_currentSkinSection = NULL;
+}
+
+CC3DrawCommandQueue* CC3NodeDrawingVisitor::getDrawCommandQueue()
+{
+	return m_pDrawCommandQueue;
+}
+
+void CC3NodeDrawingVisitor::setDrawCommandQueue( CC3DrawCommandQueue* queue )
+{
+	if ( queue == m_pDrawCommandQueue )
+		return;
+
+	CC_SAFE_RELEASE( m_pDrawCommandQueue );
+	CC_SAFE_RETAIN( queue );
+	m_pDrawCommandQueue = queue;
+}
+
+bool CC3NodeDrawingVisitor::isRecordingDrawCommands()
+{
+	return m_isRecordingDrawCommands;
+}
+
+bool CC3NodeDrawingVisitor::isCurrentMaterialBound()
+{
+	return m_isCurrentMaterialBound;
+}
+
+bool CC3NodeDrawingVisitor::isCurrentMeshBound()
+{
+	return m_isCurrentMeshBound;
+}
+
+/** If recording into the drawCommandQueue, records the node instead of drawing it. */
 void CC3NodeDrawingVisitor::draw( CC3Node* aNode )
 {
+	bool isMeshNode = aNode->isMeshNode();
+	if ( isMeshNode )
+		((CC3MeshNode*)aNode)->selectLODWithVisitor( this );
+
+	if ( m_isRecordingDrawCommands )
+	{
+		m_pDrawCommandQueue->recordNode( aNode, this );
+		return;
+	}
+
 	//LogTrace(@"Drawing %@", aNode);
 	CC3OpenGL* gl = getGL();
 	gl->pushGroupMarkerC( aNode->getRenderStreamGroupMarker().c_str() );
@@ -274,7 +451,15 @@ void CC3NodeDrawingVisitor::draw( CC3Node* aNode )
 	gl->popGroupMarker();
 	CC3PerformanceStatistics* pStatistics = getPerformanceStatistics();
 	if ( pStatistics )
+	{
 		pStatistics->incrementNodesDrawn();
+		if ( isMeshNode )
+		{
+			CC3MeshNode* meshNode = (CC3MeshNode*)aNode;
+			if ( meshNode->getDrawingMesh() )
+				pStatistics->addLODFacesPresented( meshNode->getLODLevel(), meshNode->getDrawingFaceCount() );
+		}
+	}
 }
 
 void CC3NodeDrawingVisitor::resetTextureUnits()
@@ -285,12 +470,14 @@ void CC3NodeDrawingVisitor::resetTextureUnits()
 	m_current2DTextureUnit = 0;
 	m_currentCubeTextureUnit = sp ? sp->getTextureCubeStart() : getTextureCount();
 	m_currentLightProbeTextureUnit = sp ? sp->getTextureLightProbeStart() : getTextureCount();
+	m_currentShadowMapTextureUnit = sp ? sp->getTextureShadowMapStart() : getTextureCount();
 	m_textureBindingMode = kCC3TextureBindingModeModel;
 }
 
 void CC3NodeDrawingVisitor::bindEnvironmentalTextures()
 {
 	bindLightProbeTextures();
+	bindShadowMapTextures();
 }
 
 /** Retrieve any light probe textures and bind them to the GL engine. */
@@ -308,6 +495,32 @@ void CC3NodeDrawingVisitor::bindLightProbeTextures()
 	m_textureBindingMode = kCC3TextureBindingModeModel;
 }
 
+/** 
+ * Retrieve the depth texture of the shadow map of each light and bind it to the GL engine.
+ * Lights without a current shadow map skip their texture unit, leaving it to be disabled.
+ */
+void CC3NodeDrawingVisitor::bindShadowMapTextures()
+{
+	CC3ShaderProgram* sp = getCurrentShaderProgram();
+	if ( !sp ) 
+		return;
+
+	m_textureBindingMode = kCC3TextureBindingModeShadowMap;
+	
+	GLuint tuCnt = sp->getTextureShadowMapCount();
+	for (GLuint tuIdx = 0; tuIdx < tuCnt; tuIdx++)
+	{
+		CC3Light* light = getLightAt( tuIdx );
+		CC3ShadowMap* shadowMap = light ? light->getShadowMap() : NULL;
+		if ( shadowMap && shadowMap->isReady() )
+			shadowMap->getDepthTexture()->drawWithVisitor( this );
+		else
+			increment2DTextureUnit();
+	}
+	
+	m_textureBindingMode = kCC3TextureBindingModeModel;
+}
+
 void CC3NodeDrawingVisitor::disableUnusedTextureUnits()
 {
 	// Determine the maximum number of textures of each type that could be used
@@ -332,6 +545,11 @@ void CC3NodeDrawingVisitor::disableUnusedTextureUnits()
 	for (GLuint tuIdx = m_currentLightProbeTextureUnit; tuIdx < tuMax; tuIdx++)
 		gl->disableTexturingAt( tuIdx );
 	
+	// Disable remaining shadow map textures
+	tuMax = (sp ? (sp->getTextureShadowMapStart() + sp->getTextureShadowMapCount()) : tuMax);
+	for (GLuint tuIdx = m_currentShadowMapTextureUnit; tuIdx < tuMax; tuIdx++)
+		gl->disableTexturingAt( tuIdx );
+	
 	// Ensure remaining system texture units are disabled
 	gl->disableTexturingFrom( tuMax );
 }
@@ -444,6 +662,16 @@ void CC3NodeDrawingVisitor::setCurrentSkinSection( CC3SkinSection* currentSkinSe
 	resetBoneMatrices();
 }
 
+GLuint CC3NodeDrawingVisitor::getInstanceCount()
+{
+	return m_instanceCount;
+}
+
+void CC3NodeDrawingVisitor::setInstanceCount( GLuint count )
+{
+	m_instanceCount = count;
+}
+
 CC3Vector CC3NodeDrawingVisitor::transformGlobalLocationToEyeSpace( const CC3Vector& globalLocation )
 {
 	return CC3Matrix4x3TransformLocation(getViewMatrix(), globalLocation);
@@ -642,8 +870,12 @@ void CC3NodeDrawingVisitor::init()
 	m_isMVPMtxDirty = true;
 	m_shouldDecorateNode = true;
 	m_isDrawingEnvironmentMap = false;
+	m_isRecordingDrawCommands = false;
+	m_isCurrentMaterialBound = false;
+	m_isCurrentMeshBound = false;
 	m_currentCubeTextureUnit = 0;
 	m_current2DTextureUnit = 0;
+	m_instanceCount = 1;
 }
 
 std::string CC3NodeDrawingVisitor::fullDescription()
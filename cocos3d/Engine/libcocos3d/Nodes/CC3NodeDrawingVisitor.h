@@ -39,11 +39,14 @@ class CC3NodeSequencer;
 class CC3SkinSection;
 class CC3RenderSurface;
 class CC3OpenGL;
+class CC3BoundingVolumeHierarchy;
+class CC3DrawCommandQueue;
 
 /** Enumeration of drawing visitor texture modes. */
 typedef enum {
 	kCC3TextureBindingModeModel,			/**< Binding model textures. */
 	kCC3TextureBindingModeLightProbe,		/**< Binding light probe textures. */
+	kCC3TextureBindingModeShadowMap,		/**< Binding shadow map textures. */
 } CC3TextureBindingMode;
 
 /**
@@ -132,7 +135,7 @@ public:
 	 */
 	void						resetTextureUnits();
 		
-	/** Binds environmental textures, such as light probes. */
+	/** Binds environmental textures, such as light probes and shadow maps. */
 	void						bindEnvironmentalTextures();
 
 	/** 
@@ -201,10 +204,63 @@ public:
 	 * back to the node's drawWithVisitor: method to perform the drawing. Finally, this
 	 * implementation updates the drawing performance statistics.
 	 *
+	 * Before a mesh node is drawn or recorded, its selectLODWithVisitor: method is invoked,
+	 * so that it selects the level of detail at which it will be drawn.
+	 *
+	 * If nodes are being recorded into the drawCommandQueue, the node is recorded instead,
+	 * and this method is invoked again for the node when the queue is executed.
+	 *
 	 * Subclass may override to enhance or modify this behaviour.
 	 */
 	virtual void				draw( CC3Node* aNode );
 
+	/**
+	 * The queue into which this visitor records the nodes it draws, or NULL if nodes are drawn
+	 * immediately as they are visited.
+	 *
+	 * If this property is set, the queue is cleared when this visitor is opened, the draw: method
+	 * records each node into the queue instead of drawing it, and the recorded commands are
+	 * committed and executed when this visitor is closed. See the notes for the
+	 * CC3DrawCommandQueue class for more information.
+	 *
+	 * The initial value of this property is NULL.
+	 */
+	CC3DrawCommandQueue*		getDrawCommandQueue();
+	void						setDrawCommandQueue( CC3DrawCommandQueue* queue );
+
+	/** Indicates whether the draw: method is currently recording nodes into the drawCommandQueue. */
+	bool						isRecordingDrawCommands();
+
+	/**
+	 * Indicates whether the material of the current node is already applied to the GL engine,
+	 * because the previous draw command executed from the drawCommandQueue used the same material
+	 * and shader program. In that case, the material skips its GL bindings, but still updates the
+	 * texture units and current color of this visitor for the current node.
+	 *
+	 * This property is only YES during the execution of a draw command.
+	 */
+	bool						isCurrentMaterialBound();
+
+	/**
+	 * Indicates whether the mesh of the current node is already bound to the vertex attributes
+	 * of the GL engine, because the previous draw command executed from the drawCommandQueue used
+	 * the same mesh and shader program. In that case, the mesh does not need to be bound again.
+	 *
+	 * This property is only YES during the execution of a draw command.
+	 */
+	bool						isCurrentMeshBound();
+
+	/**
+	 * Draws the specified node, recorded in the drawCommandQueue, using the specified recorded
+	 * matrices, and indicating whether its material and mesh are already bound to the GL engine.
+	 *
+	 * This method is invoked automatically by the drawCommandQueue during execution.
+	 */
+	void						drawRecordedNode( CC3Node* aNode, const CC3Matrix4x3* modelMatrix,
+												  const CC3Matrix4x3* modelViewMatrix,
+												  const CC3Matrix4x4* modelViewProjMatrix,
+												  bool isMaterialBound, bool isMeshBound );
+
 	/**
 	 * The surface manager that manages the surfaces to which this visitor can render.
 	 *
@@ -254,6 +310,18 @@ public:
 	 */
 	CC3SkinSection*				getCurrentSkinSection();
 
+	/**
+	 * The number of instances of the current mesh that are drawn by each draw call.
+	 *
+	 * When this value is greater than one, the mesh is drawn using instanced drawing, and any vertex
+	 * attributes holding per-instance content advance once per instance. The value of this property
+	 * is set by a CC3InstancedMeshNode while it draws its mesh, and is only valid during that drawing.
+	 *
+	 * The initial value of this property is one.
+	 */
+	GLuint						getInstanceCount();
+	void						setInstanceCount( GLuint count );
+
 	/**
 	 * The current color used during drawing if no materials or lighting are engaged.
 	 *
@@ -364,6 +432,23 @@ public:
 	/** Template method that opens the 3D camera. */
 	virtual void				openCamera();
 
+	/**
+	 * If this visitor is drawing an entire scene through a drawing sequencer, and the scene holds
+	 * a bounding volume hierarchy, queries that hierarchy for the nodes that intersect the camera
+	 * frustum, and asks the drawing sequencer to order those nodes, along with the nodes excluded
+	 * from the hierarchy, so that only they are visited when drawing, and the cost of culling grows
+	 * with the number of visible nodes. If the drawing sequencer cannot order a subset of its nodes,
+	 * the whole sequence is visited instead, and doesNodeIntersectFrustum: is answered for each
+	 * node in the hierarchy with a lookup.
+	 */
+	virtual void				openBoundingVolumeHierarchy();
+
+	/** If the drawCommandQueue property is set, starts recording the nodes drawn into it. */
+	virtual void				openDrawCommandQueue();
+
+	/** If nodes are being recorded into the drawCommandQueue, commits and executes the queue. */
+	virtual void				closeDrawCommandQueue();
+
 	/** Close the camera. This is the compliment of the openCamera method. */
 	virtual void				closeCamera();
 
@@ -373,6 +458,9 @@ public:
 	/** Retrieve any light probe textures and bind them to the GL engine. */
 	void						bindLightProbeTextures();
 
+	/** Retrieve the depth textures of any light shadow maps and bind them to the GL engine. */
+	void						bindShadowMapTextures();
+
 	void						setCamera( CC3Camera* camera );
 
 	/**
@@ -403,6 +491,12 @@ public:
 
 protected:
 	CC3NodeSequencer*			m_drawingSequencer;
+	CC3BoundingVolumeHierarchy*	m_pBoundingVolumeHierarchy;
+	std::vector<GLuint>			m_bvhVisibleLeaves;
+	std::vector<GLubyte>		m_bvhVisibility;
+	std::vector<CC3Node*>		m_visibleNodes;
+	bool						m_isDrawingVisibleNodes;
+	CC3DrawCommandQueue*		m_pDrawCommandQueue;
 	CC3SkinSection*				m_currentSkinSection;
 	CC3SceneDrawingSurfaceManager*	m_surfaceManager;
 	CC3RenderSurface*			m_renderSurface;
@@ -423,12 +517,17 @@ protected:
 	GLuint						m_current2DTextureUnit;
 	GLuint						m_currentCubeTextureUnit;
 	GLuint						m_currentLightProbeTextureUnit;
+	GLuint						m_currentShadowMapTextureUnit;
+	GLuint						m_instanceCount;
 	float						m_fDeltaTime;
 	bool						m_shouldDecorateNode : 1;
 	bool						m_isDrawingEnvironmentMap : 1;
 	bool						m_isVPMtxDirty : 1;
 	bool						m_isMVMtxDirty : 1;
 	bool						m_isMVPMtxDirty : 1;
+	bool						m_isRecordingDrawCommands : 1;
+	bool						m_isCurrentMaterialBound : 1;
+	bool						m_isCurrentMeshBound : 1;
 };
 
 NS_COCOS3D_END
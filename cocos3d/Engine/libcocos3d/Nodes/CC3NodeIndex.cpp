@@ -0,0 +1,274 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+#define kCC3NodeIndexInitialBucketCount		64
+
+CC3NodeIndex::CC3NodeIndex()
+{
+	m_pRootNode = NULL;
+	m_nameCount = 0;
+	m_tagCount = 0;
+}
+
+CC3NodeIndex::~CC3NodeIndex()
+{
+	m_pRootNode = NULL;				// weak reference
+}
+
+void CC3NodeIndex::initWithRootNode( CC3Node* rootNode )
+{
+	m_pRootNode = rootNode;		// not retained
+	m_nameBuckets.resize( kCC3NodeIndexInitialBucketCount );
+	m_tagBuckets.resize( kCC3NodeIndexInitialBucketCount );
+	addNode( rootNode );
+}
+
+CC3NodeIndex* CC3NodeIndex::indexWithRootNode( CC3Node* rootNode )
+{
+	CC3NodeIndex* pIndex = new CC3NodeIndex;
+	pIndex->initWithRootNode( rootNode );
+	pIndex->autorelease();
+
+	return pIndex;
+}
+
+CC3Node* CC3NodeIndex::getRootNode()
+{
+	return m_pRootNode;
+}
+
+GLuint CC3NodeIndex::getNodeCount()
+{
+	return m_tagCount;
+}
+
+/** FNV-1a hash. */
+GLuint CC3NodeIndex::hashName( const char* aName )
+{
+	GLuint hash = 2166136261u;
+	for (const char* c = aName; *c; c++)
+	{
+		hash ^= (GLubyte)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/** Returns the number of ancestors of the specified node. */
+static GLuint CC3NodeIndexDepthOf( CC3Node* aNode )
+{
+	GLuint depth = 0;
+	for (CC3Node* n = aNode->getParent(); n; n = n->getParent())
+		depth++;
+	return depth;
+}
+
+bool CC3NodeIndex::isNodeBeforeNodeInDepthFirstOrder( CC3Node* aNode, CC3Node* otherNode )
+{
+	if ( aNode == otherNode )
+		return false;
+
+	// Bring both nodes to the same depth
+	GLuint aDepth = CC3NodeIndexDepthOf( aNode );
+	GLuint otherDepth = CC3NodeIndexDepthOf( otherNode );
+	CC3Node* a = aNode;
+	CC3Node* b = otherNode;
+	for ( ; aDepth > otherDepth; aDepth--)
+		a = a->getParent();
+	for ( ; otherDepth > aDepth; otherDepth--)
+		b = b->getParent();
+
+	// If one node is an ancestor of the other, the ancestor is visited first
+	if ( a == b )
+		return a == aNode;
+
+	// Climb to the children of the closest common ancestor, and compare their positions
+	while ( a->getParent() != b->getParent() )
+	{
+		a = a->getParent();
+		b = b->getParent();
+	}
+	CC3Node* parent = a->getParent();
+	if ( !parent )
+		return false;		// Not in the same assembly
+
+	CCArray* siblings = parent->getChildren();
+	return siblings->indexOfObject( a ) < siblings->indexOfObject( b );
+}
+
+CC3Node* CC3NodeIndex::getNodeNamed( const char* aName )
+{
+	GLuint hash = hashName( aName );
+	std::vector<CC3NodeIndexNameEntry>& bucket = m_nameBuckets[hash & (m_nameBuckets.size() - 1)];
+
+	CC3Node* found = NULL;
+	GLuint entryCount = (GLuint)bucket.size();
+	for (GLuint i = 0; i < entryCount; i++)
+	{
+		CC3NodeIndexNameEntry& entry = bucket[i];
+		if ( entry.hash == hash && entry.name.compare( aName ) == 0 )
+		{
+			if ( !found || isNodeBeforeNodeInDepthFirstOrder( entry.node, found ) )
+				found = entry.node;
+		}
+	}
+	return found;
+}
+
+CC3Node* CC3NodeIndex::getNodeTagged( GLuint aTag )
+{
+	std::vector<CC3NodeIndexTagEntry>& bucket = m_tagBuckets[aTag & (m_tagBuckets.size() - 1)];
+
+	CC3Node* found = NULL;
+	GLuint entryCount = (GLuint)bucket.size();
+	for (GLuint i = 0; i < entryCount; i++)
+	{
+		CC3NodeIndexTagEntry& entry = bucket[i];
+		if ( entry.tag == aTag )
+		{
+			if ( !found || isNodeBeforeNodeInDepthFirstOrder( entry.node, found ) )
+				found = entry.node;
+		}
+	}
+	return found;
+}
+
+void CC3NodeIndex::addNode( CC3Node* aNode )
+{
+	addSingleNode( aNode );
+
+	CCObject* pObj;
+	CCARRAY_FOREACH( aNode->getChildren(), pObj )
+	{
+		addNode( (CC3Node*)pObj );
+	}
+}
+
+void CC3NodeIndex::removeNode( CC3Node* aNode )
+{
+	removeSingleNode( aNode );
+
+	CCObject* pObj;
+	CCARRAY_FOREACH( aNode->getChildren(), pObj )
+	{
+		removeNode( (CC3Node*)pObj );
+	}
+}
+
+void CC3NodeIndex::nodeWillChangeIdentity( CC3Node* aNode )
+{
+	removeSingleNode( aNode );
+}
+
+void CC3NodeIndex::nodeDidChangeIdentity( CC3Node* aNode )
+{
+	addSingleNode( aNode );
+}
+
+void CC3NodeIndex::addSingleNode( CC3Node* aNode )
+{
+	if ( m_tagCount >= m_tagBuckets.size() * 2 )
+		growTables();
+
+	std::string name = aNode->getName();
+	if ( !name.empty() )
+	{
+		CC3NodeIndexNameEntry entry;
+		entry.hash = hashName( name.c_str() );
+		entry.name = name;
+		entry.node = aNode;
+		m_nameBuckets[entry.hash & (m_nameBuckets.size() - 1)].push_back( entry );
+		m_nameCount++;
+	}
+
+	CC3NodeIndexTagEntry entry;
+	entry.tag = aNode->getTag();
+	entry.node = aNode;
+	m_tagBuckets[entry.tag & (m_tagBuckets.size() - 1)].push_back( entry );
+	m_tagCount++;
+}
+
+/** Removes the entries of the node, which are found using the name and tag the node had when it was indexed. */
+void CC3NodeIndex::removeSingleNode( CC3Node* aNode )
+{
+	std::string name = aNode->getName();
+	if ( !name.empty() )
+	{
+		std::vector<CC3NodeIndexNameEntry>& bucket = m_nameBuckets[hashName( name.c_str() ) & (m_nameBuckets.size() - 1)];
+		for (GLuint i = 0; i < bucket.size(); i++)
+		{
+			if ( bucket[i].node == aNode )
+			{
+				bucket[i] = bucket.back();
+				bucket.pop_back();
+				m_nameCount--;
+				break;
+			}
+		}
+	}
+
+	std::vector<CC3NodeIndexTagEntry>& bucket = m_tagBuckets[aNode->getTag() & (m_tagBuckets.size() - 1)];
+	for (GLuint i = 0; i < bucket.size(); i++)
+	{
+		if ( bucket[i].node == aNode )
+		{
+			bucket[i] = bucket.back();
+			bucket.pop_back();
+			m_tagCount--;
+			break;
+		}
+	}
+}
+
+/** Doubles the number of buckets in both tables, and redistributes the entries. */
+void CC3NodeIndex::growTables()
+{
+	GLuint bucketCount = (GLuint)m_tagBuckets.size() * 2;
+	GLuint mask = bucketCount - 1;
+
+	std::vector< std::vector<CC3NodeIndexNameEntry> > nameBuckets( bucketCount );
+	for (GLuint b = 0; b < m_nameBuckets.size(); b++)
+	{
+		std::vector<CC3NodeIndexNameEntry>& bucket = m_nameBuckets[b];
+		for (GLuint i = 0; i < bucket.size(); i++)
+			nameBuckets[bucket[i].hash & mask].push_back( bucket[i] );
+	}
+	m_nameBuckets.swap( nameBuckets );
+
+	std::vector< std::vector<CC3NodeIndexTagEntry> > tagBuckets( bucketCount );
+	for (GLuint b = 0; b < m_tagBuckets.size(); b++)
+	{
+		std::vector<CC3NodeIndexTagEntry>& bucket = m_tagBuckets[b];
+		for (GLuint i = 0; i < bucket.size(); i++)
+			tagBuckets[bucket[i].tag & mask].push_back( bucket[i] );
+	}
+	m_tagBuckets.swap( tagBuckets );
+}
+
+NS_COCOS3D_END
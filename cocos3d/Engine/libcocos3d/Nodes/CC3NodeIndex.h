@@ -0,0 +1,133 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_NODE_INDEX_H_
+#define _CC3_NODE_INDEX_H_
+
+NS_COCOS3D_BEGIN
+class CC3Node;
+
+/** An entry in the name table of a CC3NodeIndex. */
+typedef struct
+{
+	GLuint				hash;			/**< The hash of the name. */
+	std::string			name;			/**< The name of the node when it was indexed. */
+	CC3Node*			node;			/**< The node. Not retained. */
+} CC3NodeIndexNameEntry;
+
+/** An entry in the tag table of a CC3NodeIndex. */
+typedef struct
+{
+	GLuint				tag;			/**< The tag of the node when it was indexed. */
+	CC3Node*			node;			/**< The node. Not retained. */
+} CC3NodeIndexTagEntry;
+
+/**
+ * CC3NodeIndex holds hash tables of the names and tags of all nodes in a node assembly, so that
+ * the getNodeNamed: and getNodeTagged: methods of the root node of the assembly can find a node
+ * with an average cost that does not depend on the number of nodes in the assembly.
+ *
+ * The index is maintained incrementally. Nodes are added to, and removed from, the index as they
+ * are added to, or removed from, the node assembly, and are re-indexed when their name or tag
+ * is changed. Nodes without a name are only indexed by tag.
+ *
+ * When more than one node has the same name or tag, the lookup returns the node that would have
+ * been found first by a depth-first search of the node assembly, so that the results are the
+ * same as when no index is used.
+ *
+ * Normally, the index is managed by the root node of the assembly, when the shouldUseNodeIndex
+ * property of that node is set to YES. The application should not need to invoke the methods
+ * that maintain the index directly.
+ */
+class CC3NodeIndex : public CCObject
+{
+public:
+	CC3NodeIndex();
+	virtual ~CC3NodeIndex();
+
+	/** The root node of the node assembly held in this index. The root node is not retained. */
+	CC3Node*					getRootNode();
+
+	/** The number of nodes held in this index. */
+	GLuint						getNodeCount();
+
+	/**
+	 * Returns the node with the specified name, or NULL if no node in the assembly has that name.
+	 * The name must not be NULL or empty.
+	 */
+	CC3Node*					getNodeNamed( const char* aName );
+
+	/** Returns the node with the specified tag, or NULL if no node in the assembly has that tag. */
+	CC3Node*					getNodeTagged( GLuint aTag );
+
+	/** Adds the specified node, and all of its descendants, to this index. */
+	void						addNode( CC3Node* aNode );
+
+	/** Removes the specified node, and all of its descendants, from this index. */
+	void						removeNode( CC3Node* aNode );
+
+	/**
+	 * Removes the specified node, but not its descendants, from this index. This is invoked
+	 * automatically before the name or tag of the node is changed.
+	 */
+	void						nodeWillChangeIdentity( CC3Node* aNode );
+
+	/**
+	 * Adds the specified node, but not its descendants, to this index. This is invoked
+	 * automatically after the name or tag of the node is changed.
+	 */
+	void						nodeDidChangeIdentity( CC3Node* aNode );
+
+	/** Initializes this instance to index the specified root node and all its descendants. */
+	void						initWithRootNode( CC3Node* rootNode );
+
+	/** Allocates and initializes an autoreleased instance that indexes the specified root node and all its descendants. */
+	static CC3NodeIndex*		indexWithRootNode( CC3Node* rootNode );
+
+	/** Returns the hash of the specified name, as used by the name table. */
+	static GLuint				hashName( const char* aName );
+
+	/**
+	 * Returns whether the first of the specified nodes would be found before the second
+	 * by a depth-first search of the node assembly. Both nodes must be in the same assembly.
+	 */
+	static bool					isNodeBeforeNodeInDepthFirstOrder( CC3Node* aNode, CC3Node* otherNode );
+
+protected:
+	void						addSingleNode( CC3Node* aNode );
+	void						removeSingleNode( CC3Node* aNode );
+	void						growTables();
+
+protected:
+	CC3Node*					m_pRootNode;
+	std::vector< std::vector<CC3NodeIndexNameEntry> >	m_nameBuckets;
+	std::vector< std::vector<CC3NodeIndexTagEntry> >	m_tagBuckets;
+	GLuint						m_nameCount;
+	GLuint						m_tagCount;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -161,6 +161,16 @@ void CC3NodePuncturingVisitor::processBeforeChildren( CC3Node* aNode )
 	{
 		CC3NodePuncture* np = CC3NodePuncture::punctureOnNode( aNode, m_ray );
 		unsigned int nodeCount = m_nodePunctures->count();
+
+		// When collecting only the closest node, replace it if the new puncture is closer
+		if ( m_shouldCollectClosestOnly && nodeCount > 0 )
+		{
+			CC3NodePuncture* closestNP = getNodePunctureAt( 0 );
+			if ( np->getSQGlobalPunctureDistance() < closestNP->getSQGlobalPunctureDistance() )
+				m_nodePunctures->replaceObjectAtIndex( 0, np );
+			return;
+		}
+
 		for (unsigned int i = 0; i < nodeCount; i++) 
 		{
 			CC3NodePuncture* existNP = (CC3NodePuncture*)m_nodePunctures->objectAtIndex( i );
@@ -173,6 +183,107 @@ void CC3NodePuncturingVisitor::processBeforeChildren( CC3Node* aNode )
 	}
 }
 
+CC3BoundingVolumeHierarchy* CC3NodePuncturingVisitor::getBoundingVolumeHierarchyOf( CC3Node* aNode )
+{
+	if ( aNode != m_pStartingNode || !aNode->isScene() )
+		return NULL;
+
+	CC3BoundingVolumeHierarchy* bvh = ((CC3Scene*)aNode)->getBoundingVolumeHierarchy();
+	return (bvh && bvh->getRootNode() == aNode) ? bvh : NULL;
+}
+
+bool CC3NodePuncturingVisitor::processChildrenOf( CC3Node* aNode )
+{
+	CC3BoundingVolumeHierarchy* bvh = getBoundingVolumeHierarchyOf( aNode );
+	if ( !bvh )
+		return super::processChildrenOf( aNode );
+
+	CC3Node* currNode = m_pCurrentNode;
+	punctureNodesInHierarchy( bvh, aNode );
+	m_pCurrentNode = currNode;
+
+	return false;
+}
+
+/**
+ * Tests the nodes that the hierarchy could not enclose in boxes, followed by the nodes whose boxes
+ * are pierced by the ray, in order of the distance at which the ray enters each box. The root node
+ * has already been tested by processBeforeChildren:, and is skipped. When collecting only the
+ * closest node, testing stops at the first box that lies beyond the closest puncture found so far.
+ */
+void CC3NodePuncturingVisitor::punctureNodesInHierarchy( CC3BoundingVolumeHierarchy* bvh, CC3Node* rootNode )
+{
+	bvh->findLeavesIntersectedByRay( m_ray, m_rayHits );
+
+	GLuint exCount = bvh->getExcludedNodeCount();
+	for (GLuint i = 0; i < exCount; i++)
+	{
+		CC3Node* aNode = bvh->getExcludedNodeAt( i );
+		if ( aNode != rootNode )
+		{
+			m_pCurrentNode = aNode;
+			processBeforeChildren( aNode );
+		}
+	}
+
+	GLfloat sqDirLen = m_ray.direction.lengthSquared();
+	GLuint hitCount = (GLuint)m_rayHits.size();
+	for (GLuint i = 0; i < hitCount; i++)
+	{
+		const CC3BoundingVolumeHierarchyRayHit& hit = m_rayHits[i];
+		if ( m_shouldCollectClosestOnly && getNodeCount() > 0 &&
+			 (hit.distance * hit.distance * sqDirLen) > getNodePunctureAt( 0 )->getSQGlobalPunctureDistance() )
+			break;
+
+		CC3Node* aNode = bvh->getNodeAt( hit.leafIndex );
+		if ( aNode != rootNode )
+		{
+			m_pCurrentNode = aNode;
+			processBeforeChildren( aNode );
+		}
+	}
+}
+
+bool CC3NodePuncturingVisitor::shouldPunctureFromInside()
+{
+	return m_shouldPunctureFromInside;
+}
+
+void CC3NodePuncturingVisitor::setShouldPunctureFromInside( bool shouldPuncture )
+{
+	m_shouldPunctureFromInside = shouldPuncture;
+}
+
+bool CC3NodePuncturingVisitor::shouldPunctureInvisibleNodes()
+{
+	return m_shouldPunctureInvisibleNodes;
+}
+
+void CC3NodePuncturingVisitor::setShouldPunctureInvisibleNodes( bool shouldPuncture )
+{
+	m_shouldPunctureInvisibleNodes = shouldPuncture;
+}
+
+CC3Ray CC3NodePuncturingVisitor::getRay()
+{
+	return m_ray;
+}
+
+void CC3NodePuncturingVisitor::setRay( const CC3Ray& ray )
+{
+	m_ray = ray;
+}
+
+bool CC3NodePuncturingVisitor::shouldCollectClosestOnly()
+{
+	return m_shouldCollectClosestOnly;
+}
+
+void CC3NodePuncturingVisitor::setShouldCollectClosestOnly( bool shouldCollectClosest )
+{
+	m_shouldCollectClosestOnly = shouldCollectClosest;
+}
+
 void CC3NodePuncturingVisitor::init()
 { 
 	return initWithRay( CC3Ray(CC3Vector::kCC3VectorNull, CC3Vector::kCC3VectorNull) );
@@ -186,6 +297,7 @@ void CC3NodePuncturingVisitor::initWithRay( const CC3Ray& aRay )
 	m_nodePunctures->retain();
 	m_shouldPunctureFromInside = false;
 	m_shouldPunctureInvisibleNodes = false;
+	m_shouldCollectClosestOnly = false;
 }
 
 CC3NodePuncturingVisitor* CC3NodePuncturingVisitor::visitorWithRay( const CC3Ray& aRay )
@@ -33,6 +33,7 @@
 NS_COCOS3D_BEGIN
 
 class CC3Node;
+class CC3BoundingVolumeHierarchy;
 
 /** Helper class for CC3NodePuncturingVisitor that tracks a node and the location of its puncture. */
 class CC3NodePuncture : public CCObject
@@ -99,6 +100,12 @@ protected:
  *
  * To save instantiating a CC3NodePuncturingVisitor each time, you can reuse the visitor instance
  * over and over, through different invocations of the visit: method.
+ *
+ * If the visit: method is invoked on a CC3Scene whose shouldUseBoundingVolumeHierarchy property
+ * is set to YES, the visitor does not traverse the node hierarchy. Instead, it queries the bounding
+ * volume hierarchy of the scene for the nodes whose boxes are pierced by the ray, and tests only
+ * those nodes, in order of distance along the ray. The collected nodes are the same as would be
+ * collected by traversing the node hierarchy.
  */
 class CC3NodePuncturingVisitor : public CC3NodeVisitor 
 {
@@ -135,6 +142,20 @@ public:
 	bool						shouldPunctureInvisibleNodes();
 	void						setShouldPunctureInvisibleNodes( bool shouldPuncture );
 
+	/**
+	 * Indicates whether the visitor should collect only the node whose puncture is closest to
+	 * the startLocation of the ray, instead of all punctured nodes.
+	 *
+	 * When the visitor queries the bounding volume hierarchy of a scene, setting this property to
+	 * YES allows the visitor to stop testing nodes once the remaining nodes lie beyond the closest
+	 * puncture found so far. This is useful when only the closestPuncturedNode is of interest,
+	 * such as when testing line-of-sight, or the target hit by a projectile.
+	 *
+	 * The initial value of this property is NO, indicating that all punctured nodes are collected.
+	 */
+	bool						shouldCollectClosestOnly();
+	void						setShouldCollectClosestOnly( bool shouldCollectClosest );
+
 	/**
 	 * The ray that is to be traced, specified in the global coordinate system.
 	 *
@@ -265,13 +286,25 @@ public:
 	bool						doesPuncture( CC3Node* aNode );
 	void						processBeforeChildren( CC3Node* aNode );
 
+	/**
+	 * Overridden to query the bounding volume hierarchy, instead of visiting the child nodes,
+	 * when the specified node is the starting CC3Scene, and it holds a bounding volume hierarchy.
+	 */
+	bool						processChildrenOf( CC3Node* aNode );
+
 	void						init();
 
+protected:
+	CC3BoundingVolumeHierarchy*	getBoundingVolumeHierarchyOf( CC3Node* aNode );
+	void						punctureNodesInHierarchy( CC3BoundingVolumeHierarchy* bvh, CC3Node* rootNode );
+
 protected:
 	CCArray*					m_nodePunctures;
 	CC3Ray						m_ray;
+	std::vector<CC3BoundingVolumeHierarchyRayHit>	m_rayHits;
 	bool						m_shouldPunctureFromInside : 1;
 	bool						m_shouldPunctureInvisibleNodes : 1;
+	bool						m_shouldCollectClosestOnly : 1;
 };
 
 NS_COCOS3D_END
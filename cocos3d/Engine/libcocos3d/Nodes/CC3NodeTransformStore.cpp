@@ -0,0 +1,235 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+CC3NodeTransformStore::CC3NodeTransformStore()
+{
+	m_pRootNode = NULL;
+	m_pLocalMatrix = NULL;
+	m_isStructureDirty = true;
+}
+
+CC3NodeTransformStore::~CC3NodeTransformStore()
+{
+	detachNodes();
+	m_pRootNode = NULL;			// weak reference
+	CC_SAFE_RELEASE( m_pLocalMatrix );
+}
+
+void CC3NodeTransformStore::initWithRootNode( CC3Node* rootNode )
+{
+	m_pRootNode = rootNode;		// not retained
+	m_isStructureDirty = true;
+
+	m_pLocalMatrix = new CC3AffineMatrix;		// retained
+	m_pLocalMatrix->init();
+}
+
+CC3NodeTransformStore* CC3NodeTransformStore::storeWithRootNode( CC3Node* rootNode )
+{
+	CC3NodeTransformStore* pStore = new CC3NodeTransformStore;
+	pStore->initWithRootNode( rootNode );
+	pStore->autorelease();
+
+	return pStore;
+}
+
+CC3Node* CC3NodeTransformStore::getRootNode()
+{
+	return m_pRootNode;
+}
+
+GLuint CC3NodeTransformStore::getNodeCount()
+{
+	return (GLuint)m_nodes.size();
+}
+
+CC3Node* CC3NodeTransformStore::getNodeAt( GLuint index )
+{
+	return m_nodes[index];
+}
+
+GLint CC3NodeTransformStore::getParentIndexAt( GLuint index )
+{
+	return m_parentIndices[index];
+}
+
+CC3Matrix4x3* CC3NodeTransformStore::getGlobalTransforms()
+{
+	return m_globalTransforms.empty() ? NULL : &m_globalTransforms[0];
+}
+
+CC3Matrix4x3* CC3NodeTransformStore::getGlobalTransformAt( GLuint index )
+{
+	return &m_globalTransforms[index];
+}
+
+void CC3NodeTransformStore::markTransformDirtyAt( GLint index )
+{
+	if ( index >= 0 && index < (GLint)m_dirtyFlags.size() )
+		m_dirtyFlags[index] = 1;
+}
+
+void CC3NodeTransformStore::markStructureDirty()
+{
+	detachNodes();
+	m_isStructureDirty = true;
+}
+
+bool CC3NodeTransformStore::isStructureDirty()
+{
+	return m_isStructureDirty;
+}
+
+/**
+ * Detaches all nodes from this store, so they no longer report dirty transforms to it.
+ * Each node copies its global transform back out of the array before the array is cleared.
+ */
+void CC3NodeTransformStore::detachNodes()
+{
+	for ( GLuint i = 0; i < m_nodes.size(); i++ )
+		m_nodes[i]->setTransformStore( NULL, kCC3NodeTransformStoreNoIndex );
+
+	m_nodes.clear();
+	m_parentIndices.clear();
+	m_globalTransforms.clear();
+	m_localTransforms.clear();
+	m_dirtyFlags.clear();
+}
+
+/**
+ * Flattens the hierarchy below the root node, in breadth-first order, so parents precede their
+ * descendants, and the children of each parent are adjacent.
+ */
+void CC3NodeTransformStore::populateFromRootNode()
+{
+	detachNodes();
+	if ( m_pRootNode )
+	{
+		m_nodes.push_back( m_pRootNode );
+		m_parentIndices.push_back( kCC3NodeTransformStoreNoIndex );
+	}
+
+	// The array grows as each node appends its children, until the last node has been visited
+	for ( GLuint parentIdx = 0; parentIdx < m_nodes.size(); parentIdx++ )
+	{
+		CCObject* pObject;
+		CCARRAY_FOREACH( m_nodes[parentIdx]->getChildren(), pObject )
+		{
+			CC3Node* child = (CC3Node*)pObject;
+			if ( child )
+			{
+				m_nodes.push_back( child );
+				m_parentIndices.push_back( (GLint)parentIdx );
+			}
+		}
+	}
+
+	// Once the array is sized, it is not resized until the nodes are detached again, so each node
+	// can hold its global transform in the array. Attaching copies the current transform in.
+	GLuint nodeCount = (GLuint)m_nodes.size();
+	m_globalTransforms.resize( nodeCount );
+	m_localTransforms.resize( nodeCount );
+	for ( GLuint i = 0; i < nodeCount; i++ )
+		m_nodes[i]->setTransformStore( this, i );
+
+	m_dirtyFlags.assign( nodeCount, 1 );		// Everything is checked on the first pass
+	m_isStructureDirty = false;
+
+	CC3_TRACE( "[xfm]CC3NodeTransformStore populated with %d nodes", (int)m_nodes.size() );
+}
+
+/**
+ * Rebuilds the global transforms of the run of adjacent dirty siblings that starts at the specified
+ * index, and whose local transforms can be built independently of their global transforms, in one
+ * batch, and returns the number of nodes in the run. Returns zero if the node at the specified index
+ * cannot start such a run.
+ */
+GLuint CC3NodeTransformStore::updateSiblingTransformsFrom( GLuint index )
+{
+	GLint parentIdx = m_parentIndices[index];
+	if ( parentIdx < 0 )
+		return 0;
+
+	GLuint nodeCount = (GLuint)m_nodes.size();
+	GLuint runEnd = index;
+	while ( runEnd < nodeCount && m_dirtyFlags[runEnd] && m_parentIndices[runEnd] == parentIdx )
+	{
+		m_pLocalMatrix->setExternalContents( &m_localTransforms[runEnd] );
+		if ( !m_nodes[runEnd]->populateBatchedLocalTransform( m_pLocalMatrix ) )
+			break;
+		runEnd++;
+	}
+	m_pLocalMatrix->setExternalContents( NULL );
+
+	GLuint runCount = runEnd - index;
+	if ( runCount == 0 )
+		return 0;
+
+	CC3Matrix4x3MultiplyBatchLeft( &m_globalTransforms[index], &m_globalTransforms[parentIdx], &m_localTransforms[index], runCount );
+	for ( GLuint i = index; i < runEnd; i++ )
+	{
+		m_nodes[i]->markGlobalTransformMatrixBuilt();
+		m_dirtyFlags[i] = 0;
+	}
+	return runCount;
+}
+
+void CC3NodeTransformStore::updateTransforms()
+{
+	CC3_PROFILE_ZONE( "CC3NodeTransformStore::updateTransforms" );
+
+	if ( m_isStructureDirty )
+		populateFromRootNode();
+
+	GLuint nodeCount = (GLuint)m_nodes.size();
+	GLuint i = 0;
+	while ( i < nodeCount )
+	{
+		if ( !m_dirtyFlags[i] )
+		{
+			i++;
+			continue;
+		}
+
+		GLuint runCount = updateSiblingTransformsFrom( i );
+		if ( runCount )
+		{
+			i += runCount;
+			continue;
+		}
+
+		GLint parentIdx = m_parentIndices[i];
+		const CC3Matrix4x3* parentTransform = (parentIdx >= 0) ? &m_globalTransforms[parentIdx] : NULL;
+		m_nodes[i]->buildGlobalTransformMatrixFrom( parentTransform );
+		m_dirtyFlags[i] = 0;
+		i++;
+	}
+}
+
+NS_COCOS3D_END
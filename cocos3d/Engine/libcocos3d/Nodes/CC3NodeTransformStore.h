@@ -0,0 +1,137 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_NODE_TRANSFORM_STORE_H_
+#define _CC3_NODE_TRANSFORM_STORE_H_
+
+NS_COCOS3D_BEGIN
+
+/** Indicates that a node is not held in a transform store. */
+#define kCC3NodeTransformStoreNoIndex		(-1)
+
+/**
+ * CC3NodeTransformStore holds the global transforms of a hierarchy of nodes in a single contiguous
+ * array of CC3Matrix4x3 structures, ordered breadth-first, so that each parent precedes all of its
+ * descendants, and the children of each parent are adjacent to each other.
+ *
+ * Each node in the store has a dirty flag, which is set whenever the transform of the node is marked
+ * dirty. The updateTransforms method then rebuilds all dirty transforms in one linear pass over the
+ * array. Because a parent always precedes its children, the global transform of the parent has
+ * always been rebuilt, and can be read directly from the array, by the time its children are
+ * reached, without the recursive dirty checks and virtual calls up the parent chain that occur
+ * when each node builds its global transform lazily.
+ *
+ * Where adjacent dirty siblings each have a local transform that does not depend on their own global
+ * transform, their local transforms are gathered into a second contiguous array, and the global
+ * transform of their parent is applied to all of them at once, using CC3Matrix4x3MultiplyBatchLeft.
+ * Nodes that rotate to face a target location build their global transforms individually.
+ *
+ * The array is the storage of the globalTransformMatrix of each node held in the store, so the
+ * existing transform accessors of each node read directly from the array, and there is only one
+ * copy of each global transform. Nodes whose transforms are built lazily before the linear pass
+ * runs are built in place in the array, and are skipped by the pass.
+ *
+ * The structure of the store is rebuilt automatically from the root node on the next update,
+ * whenever nodes are added to, or removed from, the node hierarchy.
+ *
+ * Normally, the transform store is managed by the CC3Scene, when the shouldUseTransformStore
+ * property of the scene is set to YES. 
+ */
+class CC3NodeTransformStore : public CCObject
+{
+public:
+	CC3NodeTransformStore();
+	virtual ~CC3NodeTransformStore();
+
+	/** The root node of the hierarchy held in this store. The root node is not retained. */
+	CC3Node*					getRootNode();
+
+	/** The number of nodes held in this store. */
+	GLuint						getNodeCount();
+
+	/** Returns the node at the specified index in this store. */
+	CC3Node*					getNodeAt( GLuint index );
+
+	/** 
+	 * Returns the index of the parent of the node at the specified index, or
+	 * kCC3NodeTransformStoreNoIndex if that node is the root node.
+	 */
+	GLint						getParentIndexAt( GLuint index );
+
+	/**
+	 * Returns the contiguous array of global transforms, indexed in the same order as the nodes.
+	 * Each entry holds the contents of the globalTransformMatrix of the corresponding node, and
+	 * is current once the updateTransforms method has been invoked.
+	 */
+	CC3Matrix4x3*				getGlobalTransforms();
+
+	/** Returns the global transform of the node at the specified index. */
+	CC3Matrix4x3*				getGlobalTransformAt( GLuint index );
+
+	/** Marks the transform of the node at the specified index as requiring rebuilding. */
+	void						markTransformDirtyAt( GLint index );
+
+	/**
+	 * Marks that nodes have been added to, or removed from, the hierarchy, and detaches all nodes
+	 * from this store. The store will be repopulated from the root node on the next update.
+	 *
+	 * This method must be invoked while all nodes currently held in this store are still alive.
+	 */
+	void						markStructureDirty();
+
+	/** Returns whether the store needs to be repopulated from the root node before the next update. */
+	bool						isStructureDirty();
+
+	/**
+	 * Rebuilds all dirty global transforms in a single pass, in parent-before-child order, first
+	 * repopulating this store from the root node if the structure has changed.
+	 */
+	void						updateTransforms();
+
+	/** Initializes this instance to hold the specified root node and all of its descendants. */
+	void						initWithRootNode( CC3Node* rootNode );
+
+	/** Allocates and initializes an autoreleased instance to hold the specified root node and all of its descendants. */
+	static CC3NodeTransformStore* storeWithRootNode( CC3Node* rootNode );
+
+protected:
+	void						populateFromRootNode();
+	void						detachNodes();
+	GLuint						updateSiblingTransformsFrom( GLuint index );
+
+protected:
+	CC3Node*					m_pRootNode;
+	std::vector<CC3Node*>		m_nodes;
+	std::vector<GLint>			m_parentIndices;
+	std::vector<CC3Matrix4x3>	m_globalTransforms;
+	std::vector<CC3Matrix4x3>	m_localTransforms;
+	CC3AffineMatrix*			m_pLocalMatrix;
+	std::vector<GLubyte>		m_dirtyFlags;
+	bool						m_isStructureDirty;
+};
+
+NS_COCOS3D_END
+
+#endif
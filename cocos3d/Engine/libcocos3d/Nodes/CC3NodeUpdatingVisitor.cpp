@@ -31,12 +31,105 @@
 
 NS_COCOS3D_BEGIN
 
+/** Thread-specific key holding the worker visitor of the current update thread, if any. */
+static pthread_key_t	s_workerVisitorKey;
+static pthread_once_t	s_workerVisitorKeyOnce = PTHREAD_ONCE_INIT;
+
+static void createWorkerVisitorKey()
+{
+	pthread_key_create( &s_workerVisitorKey, NULL );
+}
+
+/** Returns the worker visitor updating a subtree on the current thread, or NULL if none. */
+static CC3NodeUpdatingVisitor* getCurrentWorkerVisitor()
+{
+	pthread_once( &s_workerVisitorKeyOnce, createWorkerVisitorKey );
+	return (CC3NodeUpdatingVisitor*)pthread_getspecific( s_workerVisitorKey );
+}
+
+static void setCurrentWorkerVisitor( CC3NodeUpdatingVisitor* worker )
+{
+	pthread_once( &s_workerVisitorKeyOnce, createWorkerVisitorKey );
+	pthread_setspecific( s_workerVisitorKey, worker );
+}
+
+/** A job run on the shared worker pool, which updates subtrees using a single worker visitor. */
+typedef struct
+{
+	CC3NodeUpdatingVisitor*		owner;
+	CC3NodeUpdatingVisitor*		worker;
+} CC3NodeUpdatingJob;
+
+CC3NodeUpdatingVisitor::CC3NodeUpdatingVisitor()
+{
+	m_fDeltaTime = 0.0f;
+	m_pParentVisitor = NULL;
+	m_nextSubtreeIndex = 0;
+	m_maxUpdateThreads = 4;
+	m_minParallelSubtreeCount = 8;
+	m_nodesUpdated = 0;
+	memset( m_animationUpdates, 0, sizeof(m_animationUpdates) );
+	m_shouldUpdateInParallel = false;
+
+	pthread_mutex_init( &m_parallelMutex, NULL );
+}
+
+CC3NodeUpdatingVisitor::~CC3NodeUpdatingVisitor()
+{
+	deleteWorkers();
+
+	pthread_mutex_destroy( &m_parallelMutex );
+}
+
+bool CC3NodeUpdatingVisitor::shouldUpdateInParallel()
+{
+	return m_shouldUpdateInParallel;
+}
+
+void CC3NodeUpdatingVisitor::setShouldUpdateInParallel( bool shouldUpdate )
+{
+	m_shouldUpdateInParallel = shouldUpdate;
+}
+
+unsigned int CC3NodeUpdatingVisitor::getMaxUpdateThreads()
+{
+	return m_maxUpdateThreads;
+}
+
+void CC3NodeUpdatingVisitor::setMaxUpdateThreads( unsigned int maxThreads )
+{
+	maxThreads = MAX(maxThreads, 1);
+	if ( maxThreads == m_maxUpdateThreads )
+		return;
+
+	deleteWorkers();		// Recreated lazily at the new size
+	m_maxUpdateThreads = maxThreads;
+}
+
+unsigned int CC3NodeUpdatingVisitor::getMinParallelSubtreeCount()
+{
+	return m_minParallelSubtreeCount;
+}
+
+void CC3NodeUpdatingVisitor::setMinParallelSubtreeCount( unsigned int minCount )
+{
+	m_minParallelSubtreeCount = minCount;
+}
+
 void CC3NodeUpdatingVisitor::processBeforeChildren( CC3Node* aNode )
 {
 	//LogTrace(@"Updating %@ after %.3f ms", aNode, _deltaTime * 1000.0f);
-	CC3PerformanceStatistics* pStatistics = getPerformanceStatistics();
-	if ( pStatistics )
-		pStatistics->incrementNodesUpdated();
+	// Worker visitors count locally, and the count is added to the statistics during the merge phase
+	if ( m_pParentVisitor )
+	{
+		m_nodesUpdated++;
+	}
+	else
+	{
+		CC3PerformanceStatistics* pStatistics = getPerformanceStatistics();
+		if ( pStatistics )
+			pStatistics->incrementNodesUpdated();
+	}
 
 	aNode->processUpdateBeforeTransform( this );
 
@@ -44,12 +137,207 @@ void CC3NodeUpdatingVisitor::processBeforeChildren( CC3Node* aNode )
 	super::processBeforeChildren( aNode );
 }
 
+// Worker visitors count locally, and the counts are added to the statistics during the merge phase
+void CC3NodeUpdatingVisitor::addAnimationUpdate( CC3AnimationUpdateLevel updateLevel )
+{
+	if ( m_pParentVisitor )
+	{
+		m_animationUpdates[updateLevel]++;
+		return;
+	}
+
+	CC3PerformanceStatistics* pStatistics = getPerformanceStatistics();
+	if ( pStatistics )
+		pStatistics->addAnimationUpdates( updateLevel == kCC3AnimationUpdateFull ? 1 : 0,
+										  updateLevel == kCC3AnimationUpdateReduced ? 1 : 0,
+										  updateLevel == kCC3AnimationUpdateSkipped ? 1 : 0 );
+}
+
 void CC3NodeUpdatingVisitor::processAfterChildren( CC3Node* aNode )
 {
 	aNode->processUpdateAfterTransform( this );
 	super::processAfterChildren( aNode );
 }
 
+bool CC3NodeUpdatingVisitor::processChildrenOf( CC3Node* aNode )
+{
+	if ( !shouldUpdateChildrenInParallel( aNode ) )
+		return super::processChildrenOf( aNode );
+
+	updateChildrenInParallel( aNode );
+	return false;
+}
+
+/** Only the children of the starting node are split, and only by the visitor that started the visit. */
+bool CC3NodeUpdatingVisitor::shouldUpdateChildrenInParallel( CC3Node* aNode )
+{
+	if ( !m_shouldUpdateInParallel || m_pParentVisitor || m_maxUpdateThreads < 2 || aNode != m_pStartingNode )
+		return false;
+
+	CCArray* children = aNode->getChildren();
+	return children && children->count() >= m_minParallelSubtreeCount;
+}
+
+void CC3NodeUpdatingVisitor::updateChildrenInParallel( CC3Node* aNode )
+{
+	CC3Node* currNode = m_pCurrentNode;		// Remember current node
+
+	m_parallelSubtrees.clear();
+	CCObject* pObject;
+	CCARRAY_FOREACH( aNode->getChildren(), pObject )
+	{
+		CC3Node* child = (CC3Node*)pObject;
+		if ( child )
+			m_parallelSubtrees.push_back( child );
+	}
+
+	// Build the global transform of the shared parent here, so the
+	// subtrees don't all race to build it lazily on different threads.
+	aNode->getGlobalTransformMatrix();
+
+	prepareWorkers();
+
+	// One job per worker visitor, each claiming subtrees until none are left.
+	// The calling thread takes part in running the jobs.
+	m_nextSubtreeIndex = 0;
+	GLuint jobCount = (GLuint)MIN(m_workerVisitors.size(), m_parallelSubtrees.size());
+	std::vector<CC3NodeUpdatingJob> jobs( jobCount );
+	for ( GLuint i = 0; i < jobCount; i++ )
+	{
+		jobs[i].owner = this;
+		jobs[i].worker = m_workerVisitors[i];
+	}
+	CC3WorkerPool::sharedWorkerPool()->runJobs( runUpdateJob, &jobs[0], jobCount, sizeof(CC3NodeUpdatingJob) );
+
+	// Single-threaded merge phase
+	for ( unsigned int i = 0; i < m_workerVisitors.size(); i++ )
+		mergeWorker( m_workerVisitors[i] );
+
+	m_parallelSubtrees.clear();
+	m_pCurrentNode = currNode;				// Restore current node
+}
+
+void CC3NodeUpdatingVisitor::prepareWorkers()
+{
+	while ( m_workerVisitors.size() < m_maxUpdateThreads )
+	{
+		CC3NodeUpdatingVisitor* worker = new CC3NodeUpdatingVisitor;
+		worker->init();
+		worker->m_pParentVisitor = this;
+		m_workerVisitors.push_back( worker );
+	}
+
+	CC3Camera* camera = getCamera();
+	for ( unsigned int i = 0; i < m_workerVisitors.size(); i++ )
+	{
+		CC3NodeUpdatingVisitor* worker = m_workerVisitors[i];
+		worker->m_pStartingNode = m_pStartingNode;
+		worker->m_fDeltaTime = m_fDeltaTime;
+		worker->m_shouldVisitChildren = m_shouldVisitChildren;
+		worker->setCamera( camera );
+	}
+}
+
+void CC3NodeUpdatingVisitor::updateSubtreesWithWorker( CC3NodeUpdatingVisitor* worker )
+{
+	setCurrentWorkerVisitor( worker );
+
+	GLuint subtreeCount = (GLuint)m_parallelSubtrees.size();
+	while ( true )
+	{
+		pthread_mutex_lock( &m_parallelMutex );
+		GLuint subtreeIdx = m_nextSubtreeIndex++;
+		pthread_mutex_unlock( &m_parallelMutex );
+
+		if ( subtreeIdx >= subtreeCount )
+			break;
+
+		CC3Node* subtree = m_parallelSubtrees[subtreeIdx];
+		worker->m_pCurrentNode = subtree;
+		worker->process( subtree );
+	}
+
+	worker->m_pCurrentNode = NULL;
+	setCurrentWorkerVisitor( NULL );
+}
+
+void CC3NodeUpdatingVisitor::runUpdateJob( void* job )
+{
+	CC3NodeUpdatingJob* updateJob = (CC3NodeUpdatingJob*)job;
+	updateJob->owner->updateSubtreesWithWorker( updateJob->worker );
+}
+
+void CC3NodeUpdatingVisitor::mergeWorker( CC3NodeUpdatingVisitor* worker )
+{
+	CC3PerformanceStatistics* pStatistics = getPerformanceStatistics();
+	if ( pStatistics )
+	{
+		pStatistics->addNodesUpdated( worker->m_nodesUpdated );
+		pStatistics->addAnimationUpdates( worker->m_animationUpdates[kCC3AnimationUpdateFull],
+										  worker->m_animationUpdates[kCC3AnimationUpdateReduced],
+										  worker->m_animationUpdates[kCC3AnimationUpdateSkipped] );
+	}
+	worker->m_nodesUpdated = 0;
+	memset( worker->m_animationUpdates, 0, sizeof(worker->m_animationUpdates) );
+
+	std::vector<CC3Node*>& xfmNodes = worker->m_deferredTransformNotifications;
+	for ( unsigned int i = 0; i < xfmNodes.size(); i++ )
+		xfmNodes[i]->notifyTransformListeners();
+	xfmNodes.clear();
+
+	std::vector<CC3Node*>& seqNodes = worker->m_deferredSequencingNotifications;
+	for ( unsigned int i = 0; i < seqNodes.size(); i++ )
+	{
+		CC3Scene* scene = seqNodes[i]->getScene();
+		if ( scene )
+			scene->descendantDidModifySequencingCriteria( seqNodes[i] );
+	}
+	seqNodes.clear();
+
+	std::vector<CC3Node*>& removals = worker->m_deferredRemovals;
+	for ( unsigned int i = 0; i < removals.size(); i++ )
+		requestRemovalOf( removals[i] );
+	removals.clear();
+
+	worker->m_pStartingNode = NULL;
+}
+
+void CC3NodeUpdatingVisitor::deleteWorkers()
+{
+	for ( unsigned int i = 0; i < m_workerVisitors.size(); i++ )
+		m_workerVisitors[i]->release();
+	m_workerVisitors.clear();
+}
+
+/** Worker visitors collect removal requests, so they can be processed by the parent visitor. */
+void CC3NodeUpdatingVisitor::requestRemovalOf( CC3Node* aNode )
+{
+	if ( m_pParentVisitor )
+		m_deferredRemovals.push_back( aNode );
+	else
+		super::requestRemovalOf( aNode );
+}
+
+bool CC3NodeUpdatingVisitor::deferTransformNotification( CC3Node* aNode )
+{
+	CC3NodeUpdatingVisitor* worker = getCurrentWorkerVisitor();
+	if ( !worker )
+		return false;
+
+	worker->m_deferredTransformNotifications.push_back( aNode );
+	return true;
+}
+
+bool CC3NodeUpdatingVisitor::deferSequencingNotification( CC3Node* aNode )
+{
+	CC3NodeUpdatingVisitor* worker = getCurrentWorkerVisitor();
+	if ( !worker )
+		return false;
+
+	worker->m_deferredSequencingNotifications.push_back( aNode );
+	return true;
+}
+
 std::string CC3NodeUpdatingVisitor::fullDescription()
 {
 	/*return [NSString stringWithFormat: @"%@, dt: %.3f ms",
@@ -29,6 +29,7 @@
  */
 #ifndef _CCL_CC3NODE_UPDATING_VISITOR_H_
 #define _CCL_CC3NODE_UPDATING_VISITOR_H_
+#include <pthread.h>
 
 NS_COCOS3D_BEGIN
 class CC3Node;
@@ -38,11 +39,24 @@ class CC3Node;
  * during updating and transforming operations.
  *
  * This visitor encapsulates the time since the previous update.
+ *
+ * By default, the visitor updates the nodes depth-first on the thread that invoked the visit: method.
+ * When the shouldUpdateInParallel property is set to YES, the child subtrees of the starting node
+ * are instead distributed across the threads of the shared CC3WorkerPool, each subtree being updated
+ * depth-first by a single thread. Threads claim subtrees from a shared queue as they become idle, so
+ * subtrees of differing complexity are balanced dynamically across the threads.
+ *
+ * While updating in parallel, transform listener notifications, changes to the drawing sequence,
+ * and requests to remove nodes are not performed immediately. They are deferred until all subtrees
+ * have been updated, and are then performed on the calling thread, in a single merge phase.
  */
 class CC3NodeUpdatingVisitor : public CC3NodeVisitor 
 {
 	DECLARE_SUPER( CC3NodeVisitor );
 public:
+	CC3NodeUpdatingVisitor();
+	virtual ~CC3NodeUpdatingVisitor();
+
 	static CC3NodeUpdatingVisitor* visitor();
 	/**
 	 * This property gives the interval, in seconds, since the previous update. This value can be
@@ -54,12 +68,104 @@ public:
 	float						getDeltaTime();
 	void						setDeltaTime( float dt );
 
+	/**
+	 * Indicates whether this visitor should update the child subtrees of the starting node in
+	 * parallel, across the threads of the shared CC3WorkerPool.
+	 *
+	 * Setting this property to YES is only safe if the update code of each node only modifies that
+	 * node and its descendants, and does not create autoreleased objects, or add or remove nodes
+	 * directly. Nodes should be removed during updates by using the requestRemovalOf: method of
+	 * this visitor, which is deferred until all subtrees have been updated.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUpdateInParallel();
+	void						setShouldUpdateInParallel( bool shouldUpdate );
+
+	/**
+	 * The maximum number of threads used to update the scene when the shouldUpdateInParallel
+	 * property is set to YES. This count includes the thread that invokes the visit: method,
+	 * which participates in updating subtrees. The other threads are taken from the shared
+	 * CC3WorkerPool, which also limits the number of threads available.
+	 *
+	 * The initial value of this property is four.
+	 */
+	unsigned int				getMaxUpdateThreads();
+	void						setMaxUpdateThreads( unsigned int maxThreads );
+
+	/**
+	 * The minimum number of child subtrees the starting node must contain for the visitor to update
+	 * them in parallel. Below this count, the overhead of distributing the subtrees across threads
+	 * outweighs the benefit, and the nodes are updated on the calling thread.
+	 *
+	 * The initial value of this property is eight.
+	 */
+	unsigned int				getMinParallelSubtreeCount();
+	void						setMinParallelSubtreeCount( unsigned int minCount );
+
 	virtual void				processBeforeChildren( CC3Node* aNode );
 	virtual void				processAfterChildren( CC3Node* aNode );
+	virtual bool				processChildrenOf( CC3Node* aNode );
+	virtual void				requestRemovalOf( CC3Node* aNode );
 	std::string					fullDescription();
 
+	/**
+	 * If the current thread is updating a subtree in parallel, records that the transform listeners
+	 * of the specified node are to be notified during the merge phase, and returns YES. Otherwise,
+	 * does nothing and returns NO, indicating that the listeners should be notified immediately.
+	 */
+	static bool					deferTransformNotification( CC3Node* aNode );
+
+	/**
+	 * If the current thread is updating a subtree in parallel, records that the specified node is
+	 * to be resequenced within the drawing sequence during the merge phase, and returns YES.
+	 * Otherwise, does nothing and returns NO, indicating that the node should be resequenced immediately.
+	 */
+	static bool					deferSequencingNotification( CC3Node* aNode );
+
+	/**
+	 * Records how the animation of a node was evaluated during this update, as decided by the
+	 * animation update policy of the node, in the performance statistics of this visitor.
+	 */
+	void						addAnimationUpdate( CC3AnimationUpdateLevel updateLevel );
+
+protected:
+	/** Returns whether the children of the specified node should be updated in parallel. */
+	bool						shouldUpdateChildrenInParallel( CC3Node* aNode );
+
+	/** Distributes the children of the specified node across the worker pool, and waits for them to complete. */
+	void						updateChildrenInParallel( CC3Node* aNode );
+
+	/** Ensures the worker visitors exist, and prepares them for this update. */
+	void						prepareWorkers();
+
+	/** Claims and updates subtrees, using the specified worker visitor, until none are left. */
+	void						updateSubtreesWithWorker( CC3NodeUpdatingVisitor* worker );
+
+	/** Performs the notifications and removals deferred by the specified worker, and collects its statistics. */
+	void						mergeWorker( CC3NodeUpdatingVisitor* worker );
+
+	/** Releases the worker visitors. */
+	void						deleteWorkers();
+
+	/** Worker pool job that updates subtrees with the worker visitor of a CC3NodeUpdatingJob. */
+	static void					runUpdateJob( void* job );
+
 protected:
 	float						m_fDeltaTime;
+	CC3NodeUpdatingVisitor*		m_pParentVisitor;
+	std::vector<CC3NodeUpdatingVisitor*>	m_workerVisitors;
+	std::vector<CC3Node*>		m_parallelSubtrees;
+	std::vector<CC3Node*>		m_deferredTransformNotifications;
+	std::vector<CC3Node*>		m_deferredSequencingNotifications;
+	std::vector<CC3Node*>		m_deferredRemovals;
+	pthread_mutex_t				m_parallelMutex;
+	unsigned int				m_nextSubtreeIndex;
+	unsigned int				m_maxUpdateThreads;
+	unsigned int				m_minParallelSubtreeCount;
+	GLuint						m_nodesUpdated;
+	GLuint						m_animationUpdates[kCC3AnimationUpdateSkipped + 1];
+	bool						m_shouldUpdateInParallel : 1;
 };
 
 NS_COCOS3D_END
@@ -112,6 +112,9 @@ bool CC3NodeVisitor::visit( CC3Node* aNode )
 	
 	if ( !aNode ) 
 		return rslt;					// Must have a node to work on
+
+	// Time the whole visitation, but not each recursive visit
+	CC3_PROFILE_ZONE( m_pStartingNode ? NULL : "CC3NodeVisitor::visit" );
 	
 	m_pCurrentNode = aNode;				// Make the node being processed available. Not retained.
 
@@ -306,7 +309,7 @@ CC3ShaderProgram* CC3NodeVisitor::getCurrentShaderProgram()
 
 CC3Mesh* CC3NodeVisitor::getCurrentMesh()
 {
-	return getCurrentMeshNode()->getMesh();
+	return getCurrentMeshNode()->getDrawingMesh();
 }
 
 GLuint CC3NodeVisitor::getLightCount()
@@ -157,7 +157,8 @@ public:
 	CC3MeshNode*				getCurrentMeshNode();
 
 	/**
-	 * Returns the mesh of the mesh node that is currently being visited.
+	 * Returns the mesh of the mesh node that is currently being visited, at the level
+	 * of detail selected for that mesh node, as returned by its getDrawingMesh method.
 	 *
 	 * It is up to the invoker to make sure that the current node actually is a CC3MeshNode.
 	 *
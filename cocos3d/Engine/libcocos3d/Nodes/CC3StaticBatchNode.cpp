@@ -0,0 +1,601 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+CC3StaticBatchNode::CC3StaticBatchNode()
+{
+	m_batchedNodes = NULL;
+}
+
+CC3StaticBatchNode::~CC3StaticBatchNode()
+{
+	CC_SAFE_RELEASE( m_batchedNodes );
+}
+
+CC3StaticBatchNode* CC3StaticBatchNode::nodeWithName( const std::string& aName )
+{
+	CC3StaticBatchNode* pNode = new CC3StaticBatchNode;
+	pNode->initWithName( aName );
+	pNode->autorelease();
+
+	return pNode;
+}
+
+void CC3StaticBatchNode::setBatchRange( CC3Mesh* sharedMesh, GLuint vertexIndexStart, GLuint vertexIndexCount, const CC3Box& batchBox )
+{
+	m_vertexIndexStart = vertexIndexStart;
+	m_vertexIndexCount = vertexIndexCount;
+	m_batchBox = batchBox;
+	setMesh( sharedMesh );
+
+	// The shared mesh holds other batches, so the bounding volume is built from this batch only
+	setBoundingVolume( CC3NodeSphereThenBoxBoundingVolume::boundingVolumeCircumscribingBox( batchBox ) );
+}
+
+GLuint CC3StaticBatchNode::getVertexIndexStart()
+{
+	return m_vertexIndexStart;
+}
+
+GLuint CC3StaticBatchNode::getVertexIndexCount()
+{
+	return m_vertexIndexCount;
+}
+
+CCArray* CC3StaticBatchNode::getBatchedNodes()
+{
+	return m_batchedNodes;
+}
+
+void CC3StaticBatchNode::addBatchedNode( CC3MeshNode* aNode )
+{
+	m_batchedNodes->addObject( aNode );
+}
+
+void CC3StaticBatchNode::populateDrawingStateFrom( CC3MeshNode* aNode )
+{
+	setMaterial( aNode->getMaterial() );
+	if ( aNode->getShaderProgram() )
+		setShaderProgram( aNode->getShaderProgram() );
+
+	setShouldUseSmoothShading( aNode->shouldUseSmoothShading() );
+	setShouldCullBackFaces( aNode->shouldCullBackFaces() );
+	setShouldCullFrontFaces( aNode->shouldCullFrontFaces() );
+	setShouldUseClockwiseFrontFaceWinding( aNode->shouldUseClockwiseFrontFaceWinding() );
+	setShouldDisableDepthMask( aNode->shouldDisableDepthMask() );
+	setShouldDisableDepthTest( aNode->shouldDisableDepthTest() );
+	setDepthFunction( aNode->getDepthFunction() );
+	setDecalOffsetFactor( aNode->getDecalOffsetFactor() );
+	setDecalOffsetUnits( aNode->getDecalOffsetUnits() );
+}
+
+void CC3StaticBatchNode::unbatch()
+{
+	CCObject* pObj;
+	CCARRAY_FOREACH( m_batchedNodes, pObj )
+	{
+		CC3Node* pNode = (CC3Node*)pObj;
+		pNode->setVisible( true );
+	}
+	m_batchedNodes->removeAllObjects();
+
+	remove();
+}
+
+void CC3StaticBatchNode::drawMeshWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	CC3Mesh* drawingMesh = getDrawingMesh();
+	if ( !drawingMesh )
+		return;
+
+	drawingMesh->drawFrom( m_vertexIndexStart, m_vertexIndexCount, visitor );
+
+	CC3PerformanceStatistics* pStatistics = visitor->getPerformanceStatistics();
+	if ( pStatistics && m_batchedNodes->count() )
+		pStatistics->addStaticBatchDrawn( m_batchedNodes->count() );
+}
+
+GLuint CC3StaticBatchNode::getDrawingFaceCount()
+{
+	return m_pMesh ? m_pMesh->getFaceCountFromVertexIndexCount( m_vertexIndexCount ) : 0;
+}
+
+CC3Box CC3StaticBatchNode::getLocalContentBoundingBox()
+{
+	return m_batchBox;
+}
+
+CC3Vector CC3StaticBatchNode::getLocalContentCenterOfGeometry()
+{
+	return m_batchBox.isNull() ? CC3Vector::kCC3VectorZero : m_batchBox.getCenter();
+}
+
+void CC3StaticBatchNode::generateLODMeshes( GLuint lodCount, GLfloat triangleRatio )
+{
+	CC3Node::generateLODMeshes( lodCount, triangleRatio );
+}
+
+void CC3StaticBatchNode::initWithTag( GLuint aTag, const std::string& aName )
+{
+	super::initWithTag( aTag, aName );
+	m_batchedNodes = CCArray::create();
+	m_batchedNodes->retain();
+	m_batchBox = CC3Box::kCC3BoxNull;
+	m_vertexIndexStart = 0;
+	m_vertexIndexCount = 0;
+}
+
+/** The batched nodes are not copied, since they remain hidden on behalf of the original batch. */
+void CC3StaticBatchNode::populateFrom( CC3StaticBatchNode* another )
+{
+	super::populateFrom( another );
+
+	m_batchBox = another->getLocalContentBoundingBox();
+	m_vertexIndexStart = another->getVertexIndexStart();
+	m_vertexIndexCount = another->getVertexIndexCount();
+}
+
+CCObject* CC3StaticBatchNode::copyWithZone( CCZone* )
+{
+	CC3StaticBatchNode* pVal = new CC3StaticBatchNode;
+	pVal->init();
+	pVal->populateFrom( this );
+	pVal->addCopiesOfChildrenFrom( this );
+
+	return pVal;
+}
+
+
+/** A mesh node that is a candidate for static batching, along with its drawing state and spatial cell. */
+typedef struct
+{
+	CC3MeshNode*		node;
+	CC3StaticBatchKey	key;
+	GLint				cell[3];
+	GLuint				order;
+} CC3StaticBatchCandidate;
+
+/** Orders two pointers, or two values, returning -1, 0 or 1. */
+template <typename T>
+static inline GLint CC3StaticBatchCompare( T a, T b )
+{
+	return (a < b) ? -1 : ((b < a) ? 1 : 0);
+}
+
+/** Compares the drawing state of two static batch keys, returning -1, 0 or 1. */
+static GLint CC3StaticBatchCompareKeys( const CC3StaticBatchKey& k1, const CC3StaticBatchKey& k2 )
+{
+	GLint rslt;
+	if ( (rslt = CC3StaticBatchCompare( (size_t)k1.material, (size_t)k2.material )) ) return rslt;
+	if ( (rslt = CC3StaticBatchCompare( (size_t)k1.shaderProgram, (size_t)k2.shaderProgram )) ) return rslt;
+	if ( (rslt = CC3StaticBatchCompare( (GLuint)k1.vertexContentTypes, (GLuint)k2.vertexContentTypes )) ) return rslt;
+	if ( (rslt = CC3StaticBatchCompare( k1.depthFunction, k2.depthFunction )) ) return rslt;
+	if ( (rslt = CC3StaticBatchCompare( k1.drawingFlags, k2.drawingFlags )) ) return rslt;
+	if ( (rslt = CC3StaticBatchCompare( k1.decalOffsetFactor, k2.decalOffsetFactor )) ) return rslt;
+	return CC3StaticBatchCompare( k1.decalOffsetUnits, k2.decalOffsetUnits );
+}
+
+/** Orders candidates by drawing state, then by spatial cell, then by the order in which they were found. */
+static bool CC3StaticBatchCandidateLess( const CC3StaticBatchCandidate& c1, const CC3StaticBatchCandidate& c2 )
+{
+	GLint rslt = CC3StaticBatchCompareKeys( c1.key, c2.key );
+	for (GLuint i = 0; !rslt && i < 3; i++)
+		rslt = CC3StaticBatchCompare( c1.cell[i], c2.cell[i] );
+	return rslt ? (rslt < 0) : (c1.order < c2.order);
+}
+
+static inline bool CC3StaticBatchIsSameCell( const CC3StaticBatchCandidate& c1, const CC3StaticBatchCandidate& c2 )
+{
+	return c1.cell[0] == c2.cell[0] && c1.cell[1] == c2.cell[1] && c1.cell[2] == c2.cell[2];
+}
+
+/** Returns whether the content of the specified vertex array, if it exists, is held in application memory. */
+static inline bool CC3StaticBatchHasContent( CC3VertexArray* vtxArray )
+{
+	return !vtxArray || vtxArray->getVertices();
+}
+
+/** Returns the number of vertex indices drawn by the specified mesh. */
+static inline GLuint CC3StaticBatchIndexCountOf( CC3Mesh* aMesh )
+{
+	return aMesh->hasVertexIndices() ? aMesh->getVertexIndexCount() : aMesh->getVertexCount();
+}
+
+typedef CC3Vector (CC3Mesh::*CC3StaticBatchVectorGetter)( GLuint index );
+typedef void (CC3Mesh::*CC3StaticBatchVectorSetter)( const CC3Vector& aVector, GLuint index );
+
+/**
+ * Gathers the count vertex directions of the specified mesh, starting at the specified vertex,
+ * into the packed scratch array, transforms them by the specified matrix in a single batch,
+ * and writes them back to the mesh, normalized.
+ */
+static void CC3StaticBatchTransformDirections( CC3Mesh* aMesh, GLuint vtxOffset, GLuint vtxCount, const CC3Matrix4x3* mtx,
+											   CC3StaticBatchVectorGetter getter, CC3StaticBatchVectorSetter setter,
+											   std::vector<CC3Vector>& scratch )
+{
+	for (GLuint i = 0; i < vtxCount; i++)
+		scratch[i] = (aMesh->*getter)( vtxOffset + i );
+
+	CC3Matrix4x3TransformDirections( mtx, &scratch[0], &scratch[0], vtxCount );
+
+	for (GLuint i = 0; i < vtxCount; i++)
+		(aMesh->*setter)( scratch[i].normalize(), vtxOffset + i );
+}
+
+CC3StaticBatcher::CC3StaticBatcher()
+{
+}
+
+CC3StaticBatcher* CC3StaticBatcher::batcher()
+{
+	CC3StaticBatcher* pBatcher = new CC3StaticBatcher;
+	pBatcher->init();
+	pBatcher->autorelease();
+
+	return pBatcher;
+}
+
+void CC3StaticBatcher::init()
+{
+	m_cellSize = 0.0f;
+	m_minimumBatchSize = kCC3DefaultStaticBatchMinimumSize;
+}
+
+GLfloat CC3StaticBatcher::getCellSize()
+{
+	return m_cellSize;
+}
+
+void CC3StaticBatcher::setCellSize( GLfloat cellSize )
+{
+	m_cellSize = MAX(cellSize, 0.0f);
+}
+
+GLuint CC3StaticBatcher::getMinimumBatchSize()
+{
+	return m_minimumBatchSize;
+}
+
+void CC3StaticBatcher::setMinimumBatchSize( GLuint minSize )
+{
+	m_minimumBatchSize = MAX(minSize, 1);
+}
+
+bool CC3StaticBatcher::isBatchable( CC3MeshNode* aNode )
+{
+	if ( !aNode->shouldBatchStatically() || !aNode->isVisible() || aNode->shouldDrawInClipSpace() )
+		return false;
+	if ( aNode->isDrawingInstances() || dynamic_cast<CC3StaticBatchNode*>( aNode ) || dynamic_cast<CC3SkinMeshNode*>( aNode ) )
+		return false;
+
+	CC3Mesh* aMesh = aNode->getMesh();
+	if ( !aMesh || aMesh->getDrawingMode() != GL_TRIANGLES )
+		return false;
+
+	GLuint vtxCount = aMesh->getVertexCount();
+	if ( vtxCount == 0 || vtxCount > (kCC3MaxGLushort + 1) )
+		return false;
+
+	if ( aMesh->hasVertexBoneIndices() || aMesh->hasVertexBoneWeights() || aMesh->getTextureCoordinatesArrayCount() > 1 )
+		return false;
+
+	// The content must still be held in application memory to be copied into the batch
+	return CC3StaticBatchHasContent( aMesh->getVertexLocations() )
+		&& CC3StaticBatchHasContent( aMesh->getVertexNormals() )
+		&& CC3StaticBatchHasContent( aMesh->getVertexTangents() )
+		&& CC3StaticBatchHasContent( aMesh->getVertexBitangents() )
+		&& CC3StaticBatchHasContent( aMesh->getVertexColors() )
+		&& CC3StaticBatchHasContent( aMesh->getVertexTextureCoordinates() )
+		&& CC3StaticBatchHasContent( aMesh->getVertexIndices() );
+}
+
+CC3StaticBatchKey CC3StaticBatcher::getKeyFor( CC3MeshNode* aNode )
+{
+	CC3StaticBatchKey key;
+	memset( &key, 0, sizeof(key) );
+	key.material = aNode->getMaterial();
+	key.shaderProgram = aNode->getShaderProgram();
+	key.vertexContentTypes = aNode->getMesh()->getVertexContentTypes();
+	key.depthFunction = aNode->getDepthFunction();
+	key.drawingFlags = (aNode->shouldCullBackFaces() ? 1 : 0)
+					 | (aNode->shouldCullFrontFaces() ? 2 : 0)
+					 | (aNode->shouldUseClockwiseFrontFaceWinding() ? 4 : 0)
+					 | (aNode->shouldUseSmoothShading() ? 8 : 0)
+					 | (aNode->shouldDisableDepthMask() ? 16 : 0)
+					 | (aNode->shouldDisableDepthTest() ? 32 : 0);
+	key.decalOffsetFactor = aNode->getDecalOffsetFactor();
+	key.decalOffsetUnits = aNode->getDecalOffsetUnits();
+	return key;
+}
+
+GLuint CC3StaticBatcher::batchNodesIn( CC3Node* rootNode )
+{
+	if ( !rootNode )
+		return 0;
+
+	// Batched vertices are held in the coordinate system of the root node
+	CC3Matrix4x3 rootInverse;
+	rootNode->getGlobalTransformMatrixInverted()->populateCC3Matrix4x3( &rootInverse );
+
+	std::vector<CC3StaticBatchCandidate> candidates;
+	std::vector<CC3Vector> centers;
+	CC3Box region = CC3Box::kCC3BoxNull;
+
+	CCObject* pObj;
+	CCArray* allNodes = rootNode->flatten();
+	CCARRAY_FOREACH( allNodes, pObj )
+	{
+		CC3MeshNode* pMeshNode = dynamic_cast<CC3MeshNode*>( pObj );
+		if ( !pMeshNode || !isBatchable( pMeshNode ) )
+			continue;
+
+		CC3StaticBatchCandidate candidate;
+		candidate.node = pMeshNode;
+		candidate.key = getKeyFor( pMeshNode );
+		candidate.order = (GLuint)candidates.size();
+		candidates.push_back( candidate );
+
+		CC3Vector center = CC3Matrix4x3TransformLocation( &rootInverse, pMeshNode->getGlobalCenterOfGeometry() );
+		centers.push_back( center );
+		region = region.boxEngulfLocation( center );
+	}
+
+	if ( candidates.size() < m_minimumBatchSize )
+		return 0;
+
+	GLfloat cellSize = m_cellSize;
+	if ( cellSize <= 0.0f )
+	{
+		CC3Vector regionSize = region.getSize();
+		cellSize = MAX(MAX(regionSize.x, regionSize.y), regionSize.z) / kCC3DefaultStaticBatchCellDivisions;
+	}
+
+	for (GLuint i = 0; i < candidates.size(); i++)
+	{
+		const CC3Vector& center = centers[i];
+		candidates[i].cell[0] = (cellSize > 0.0f) ? (GLint)floorf( center.x / cellSize ) : 0;
+		candidates[i].cell[1] = (cellSize > 0.0f) ? (GLint)floorf( center.y / cellSize ) : 0;
+		candidates[i].cell[2] = (cellSize > 0.0f) ? (GLint)floorf( center.z / cellSize ) : 0;
+	}
+	std::sort( candidates.begin(), candidates.end(), CC3StaticBatchCandidateLess );
+
+	// Gather the cells of each drawing state, and batch them together into shared meshes
+	GLuint batchedCount = 0;
+	std::vector< std::vector<CC3MeshNode*> > cells;
+	for (GLuint i = 0; i < candidates.size(); i++)
+	{
+		bool isNewKey = (i == 0) || CC3StaticBatchCompareKeys( candidates[i].key, candidates[i - 1].key ) != 0;
+		if ( isNewKey && !cells.empty() )
+		{
+			batchedCount += batchCells( cells, rootNode, &rootInverse );
+			cells.clear();
+		}
+		if ( isNewKey || !CC3StaticBatchIsSameCell( candidates[i], candidates[i - 1] ) )
+			cells.push_back( std::vector<CC3MeshNode*>() );
+		cells.back().push_back( candidates[i].node );
+	}
+	if ( !cells.empty() )
+		batchedCount += batchCells( cells, rootNode, &rootInverse );
+
+	return batchedCount;
+}
+
+/**
+ * Lays out the mesh nodes of the specified cells, which all share the same drawing state, into
+ * shared meshes that are each limited to the number of vertices that can be indexed. Each run of
+ * mesh nodes from a single cell that lands in a single shared mesh becomes one static batch.
+ * Cells holding fewer than minimumBatchSize mesh nodes are skipped. Returns the number of mesh
+ * nodes that were merged into batches.
+ */
+GLuint CC3StaticBatcher::batchCells( std::vector< std::vector<CC3MeshNode*> >& cells, CC3Node* rootNode, const CC3Matrix4x3* rootInverse )
+{
+	typedef std::vector<CC3MeshNode*> CC3MeshNodeRun;
+	std::vector< std::vector<CC3MeshNodeRun> > meshRuns;
+	GLuint meshVtxCount = 0;
+	for (GLuint cellIdx = 0; cellIdx < cells.size(); cellIdx++)
+	{
+		CC3MeshNodeRun& cell = cells[cellIdx];
+		if ( cell.size() < m_minimumBatchSize )
+			continue;
+
+		bool isNewRun = true;
+		for (GLuint i = 0; i < cell.size(); i++)
+		{
+			GLuint vtxCount = cell[i]->getMesh()->getVertexCount();
+			if ( meshRuns.empty() || (meshVtxCount + vtxCount) > (kCC3MaxGLushort + 1) )
+			{
+				meshRuns.push_back( std::vector<CC3MeshNodeRun>() );
+				meshVtxCount = 0;
+				isNewRun = true;
+			}
+			if ( isNewRun )
+			{
+				meshRuns.back().push_back( CC3MeshNodeRun() );
+				isNewRun = false;
+			}
+			meshRuns.back().back().push_back( cell[i] );
+			meshVtxCount += vtxCount;
+		}
+	}
+
+	GLuint batchedCount = 0;
+	for (GLuint meshIdx = 0; meshIdx < meshRuns.size(); meshIdx++)
+	{
+		std::vector<CC3MeshNodeRun>& runs = meshRuns[meshIdx];
+
+		GLuint vtxTotal = 0;
+		GLuint vtxIdxTotal = 0;
+		for (GLuint runIdx = 0; runIdx < runs.size(); runIdx++)
+		{
+			for (GLuint i = 0; i < runs[runIdx].size(); i++)
+			{
+				CC3Mesh* srcMesh = runs[runIdx][i]->getMesh();
+				vtxTotal += srcMesh->getVertexCount();
+				vtxIdxTotal += CC3StaticBatchIndexCountOf( srcMesh );
+			}
+		}
+
+		CC3MeshNode* pFirstNode = runs[0][0];
+		CC3Mesh* pSharedMesh = CC3Mesh::meshWithName( CC3String::stringWithFormat( (char*)"%s-StaticBatch-%u",
+																					 pFirstNode->getMaterial()->getName().c_str(), meshIdx ) );
+		pSharedMesh->setShouldInterleaveVertices( true );
+		pSharedMesh->setVertexContentTypes( pFirstNode->getMesh()->getVertexContentTypes() );
+		pSharedMesh->setAllocatedVertexCapacity( vtxTotal );
+		pSharedMesh->setAllocatedVertexIndexCapacity( vtxIdxTotal );
+
+		std::vector<GLuint> runStarts;
+		std::vector<CC3Box> runBoxes;
+		GLuint vtxOffset = 0;
+		GLuint vtxIdxOffset = 0;
+		for (GLuint runIdx = 0; runIdx < runs.size(); runIdx++)
+		{
+			CC3Box runBox = CC3Box::kCC3BoxNull;
+			runStarts.push_back( vtxIdxOffset );
+			for (GLuint i = 0; i < runs[runIdx].size(); i++)
+			{
+				CC3Mesh* srcMesh = runs[runIdx][i]->getMesh();
+				copyNodeIntoMesh( runs[runIdx][i], pSharedMesh, vtxOffset, vtxIdxOffset, rootInverse, runBox );
+				vtxOffset += srcMesh->getVertexCount();
+				vtxIdxOffset += CC3StaticBatchIndexCountOf( srcMesh );
+			}
+			runBoxes.push_back( runBox );
+		}
+		runStarts.push_back( vtxIdxOffset );
+
+		pSharedMesh->setVertexCount( vtxTotal );
+		pSharedMesh->setVertexIndexCount( vtxIdxTotal );
+		pSharedMesh->setDrawingMode( GL_TRIANGLES );
+		pSharedMesh->createGLBuffers();
+
+		for (GLuint runIdx = 0; runIdx < runs.size(); runIdx++)
+		{
+			CC3MeshNodeRun& run = runs[runIdx];
+			std::string batchName = CC3String::stringWithFormat( (char*)"%s-%u", pSharedMesh->getName().c_str(), runIdx );
+			CC3StaticBatchNode* pBatchNode = CC3StaticBatchNode::nodeWithName( batchName );
+			pBatchNode->setBatchRange( pSharedMesh, runStarts[runIdx], runStarts[runIdx + 1] - runStarts[runIdx], runBoxes[runIdx] );
+			pBatchNode->populateDrawingStateFrom( run[0] );
+			for (GLuint i = 0; i < run.size(); i++)
+			{
+				pBatchNode->addBatchedNode( run[i] );
+				run[i]->setVisible( false );
+			}
+			rootNode->addChild( pBatchNode );
+			batchedCount += (GLuint)run.size();
+		}
+	}
+
+	return batchedCount;
+}
+
+/**
+ * Copies the vertices and vertex indices of the mesh of the specified node into the shared mesh,
+ * at the specified offsets, transforming the vertices into the coordinate system of the root node,
+ * and engulfing the transformed vertex locations in the specified bounding box.
+ */
+void CC3StaticBatcher::copyNodeIntoMesh( CC3MeshNode* aNode, CC3Mesh* sharedMesh, GLuint vtxOffset, GLuint vtxIdxOffset,
+										 const CC3Matrix4x3* rootInverse, CC3Box& batchBox )
+{
+	CC3Mesh* srcMesh = aNode->getMesh();
+	GLuint vtxCount = srcMesh->getVertexCount();
+	GLuint vtxIdxCount = CC3StaticBatchIndexCountOf( srcMesh );
+	sharedMesh->copyVertices( vtxCount, 0, srcMesh, vtxOffset );
+	sharedMesh->copyVertexIndices( vtxIdxCount, 0, srcMesh, vtxIdxOffset, vtxOffset );
+
+	CC3Matrix4x3 globalMtx, xfmMtx;
+	aNode->getGlobalTransformMatrix()->populateCC3Matrix4x3( &globalMtx );
+	CC3Matrix4x3Multiply( &xfmMtx, rootInverse, &globalMtx );
+
+	// Normals are transformed by the inverse-transpose, to remain perpendicular under non-uniform scaling
+	CC3Matrix3x3 linMtx;
+	CC3Matrix3x3PopulateFrom4x3( &linMtx, &xfmMtx );
+	GLfloat det = CC3Vector( linMtx.c1r1, linMtx.c1r2, linMtx.c1r3 )
+					.dot( CC3Vector( linMtx.c2r1, linMtx.c2r2, linMtx.c2r3 )
+					.cross( CC3Vector( linMtx.c3r1, linMtx.c3r2, linMtx.c3r3 ) ) );
+	CC3Matrix3x3InvertAdjointTranspose( &linMtx );
+
+	// Each vertex attribute is gathered into a packed array, so it can be transformed in one batch
+	if ( vtxCount > 0 )
+	{
+		std::vector<CC3Vector> scratch( vtxCount );
+		for (GLuint i = 0; i < vtxCount; i++)
+			scratch[i] = sharedMesh->getVertexLocationAt( vtxOffset + i );
+
+		CC3Matrix4x3TransformLocations( &xfmMtx, &scratch[0], &scratch[0], vtxCount );
+
+		for (GLuint i = 0; i < vtxCount; i++)
+		{
+			sharedMesh->setVertexLocation( scratch[i], vtxOffset + i );
+			batchBox = batchBox.boxEngulfLocation( scratch[i] );
+		}
+
+		if ( sharedMesh->hasVertexNormals() )
+		{
+			CC3Matrix4x3 nrmMtx;
+			CC3Matrix4x3PopulateFrom3x3( &nrmMtx, &linMtx );
+			CC3StaticBatchTransformDirections( sharedMesh, vtxOffset, vtxCount, &nrmMtx,
+											   &CC3Mesh::getVertexNormalAt, &CC3Mesh::setVertexNormal, scratch );
+		}
+		if ( sharedMesh->hasVertexTangents() )
+			CC3StaticBatchTransformDirections( sharedMesh, vtxOffset, vtxCount, &xfmMtx,
+											   &CC3Mesh::getVertexTangentAt, &CC3Mesh::setVertexTangent, scratch );
+		if ( sharedMesh->hasVertexBitangents() )
+			CC3StaticBatchTransformDirections( sharedMesh, vtxOffset, vtxCount, &xfmMtx,
+											   &CC3Mesh::getVertexBitangentAt, &CC3Mesh::setVertexBitangent, scratch );
+	}
+
+	// A mirroring transform reverses the winding of the faces, which is restored by swapping two corners of each face
+	if ( det < 0.0f )
+	{
+		GLuint vtxIdxEnd = vtxIdxOffset + vtxIdxCount;
+		for (GLuint i = vtxIdxOffset; i + 2 < vtxIdxEnd; i += 3)
+		{
+			GLuint vtx1 = sharedMesh->getVertexIndexAt( i + 1 );
+			sharedMesh->setVertexIndex( sharedMesh->getVertexIndexAt( i + 2 ), i + 1 );
+			sharedMesh->setVertexIndex( vtx1, i + 2 );
+		}
+	}
+}
+
+void CC3StaticBatcher::unbatchNodesIn( CC3Node* rootNode )
+{
+	if ( !rootNode )
+		return;
+
+	// The flattened array retains each batch node while it is removed from its parent
+	CCObject* pObj;
+	CCArray* allNodes = rootNode->flatten();
+	CCARRAY_FOREACH( allNodes, pObj )
+	{
+		CC3StaticBatchNode* pBatchNode = dynamic_cast<CC3StaticBatchNode*>( pObj );
+		if ( pBatchNode )
+			pBatchNode->unbatch();
+	}
+}
+
+NS_COCOS3D_END
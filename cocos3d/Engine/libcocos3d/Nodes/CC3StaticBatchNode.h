@@ -0,0 +1,218 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_STATIC_BATCH_NODE_H_
+#define _CC3_STATIC_BATCH_NODE_H_
+
+NS_COCOS3D_BEGIN
+
+/** The default number of spatial cells into which a CC3StaticBatcher divides the longest side of the batched region. */
+#define kCC3DefaultStaticBatchCellDivisions		4
+
+/** The default minimum number of mesh nodes that a CC3StaticBatcher will merge into a single static batch. */
+#define kCC3DefaultStaticBatchMinimumSize		2
+
+/**
+ * CC3StaticBatchNode is a CC3MeshNode that draws the merged content of a number of static mesh
+ * nodes, which share the same material and drawing state, in a single draw call.
+ *
+ * The vertices of the batched mesh nodes are transformed into the coordinate system of the
+ * parent of this node, and copied into a mesh that may be shared by several static batch nodes.
+ * This node draws only its own range of the vertex indices of that shared mesh, and its bounding
+ * volume encloses only the vertices in that range, so that each static batch is culled against
+ * the camera frustum on its own.
+ *
+ * Static batch nodes are normally created by a CC3StaticBatcher, which hides the mesh nodes
+ * that it merges into each batch. Those mesh nodes are retained by the batch node, and are
+ * shown again if the batch is removed with the unbatch method.
+ *
+ * Each time this node is drawn, the number of batched mesh nodes it represents is added to the
+ * performanceStatistics of the drawing visitor, so that the number of drawing calls saved by
+ * static batching can be tracked.
+ */
+class CC3StaticBatchNode : public CC3MeshNode
+{
+	DECLARE_SUPER( CC3MeshNode );
+public:
+	CC3StaticBatchNode();
+	virtual ~CC3StaticBatchNode();
+
+	static CC3StaticBatchNode*	nodeWithName( const std::string& aName );
+
+	/**
+	 * Sets the shared mesh drawn by this node, the range of vertex indices of that mesh that this
+	 * node draws, and the bounding box of the vertices in that range. If the shared mesh does not
+	 * use vertex indices, the range is a range of vertices instead.
+	 */
+	void						setBatchRange( CC3Mesh* sharedMesh, GLuint vertexIndexStart, GLuint vertexIndexCount, const CC3Box& batchBox );
+
+	/** The first vertex index, in the shared mesh, of the range drawn by this node. */
+	GLuint						getVertexIndexStart();
+
+	/** The number of vertex indices, in the shared mesh, drawn by this node. */
+	GLuint						getVertexIndexCount();
+
+	/**
+	 * The mesh nodes merged into this batch. These nodes are retained, and are hidden while
+	 * this batch is in use.
+	 */
+	CCArray*					getBatchedNodes();
+
+	/** Adds the specified mesh node to the batchedNodes of this node. */
+	void						addBatchedNode( CC3MeshNode* aNode );
+
+	/**
+	 * Sets the material, shader program and drawing state of this node from the specified mesh
+	 * node, which is one of the mesh nodes merged into this batch.
+	 */
+	void						populateDrawingStateFrom( CC3MeshNode* aNode );
+
+	/** Shows each of the batchedNodes again, releases them, and removes this node from its parent. */
+	void						unbatch();
+
+	/** Draws the range of the shared mesh that belongs to this batch. */
+	void						drawMeshWithVisitor( CC3NodeDrawingVisitor* visitor );
+
+	/** Returns the number of faces in the range of the shared mesh that belongs to this batch. */
+	GLuint						getDrawingFaceCount();
+
+	/** Returns the bounding box of the vertices in the range of the shared mesh that belongs to this batch. */
+	CC3Box						getLocalContentBoundingBox();
+
+	/** Returns the center of the bounding box of the vertices in the range of the shared mesh that belongs to this batch. */
+	CC3Vector					getLocalContentCenterOfGeometry();
+
+	/** Overridden to do nothing, since a static batch has no reduced meshes. */
+	void						generateLODMeshes( GLuint lodCount, GLfloat triangleRatio );
+
+	void						initWithTag( GLuint aTag, const std::string& aName );
+	void						populateFrom( CC3StaticBatchNode* another );
+	virtual CCObject*			copyWithZone( CCZone* zone );
+
+protected:
+	CCArray*					m_batchedNodes;
+	CC3Box						m_batchBox;
+	GLuint						m_vertexIndexStart;
+	GLuint						m_vertexIndexCount;
+};
+
+/** The drawing state shared by all of the mesh nodes that are merged into a single static batch. */
+typedef struct
+{
+	CC3Material*		material;			/**< The material of the mesh nodes. */
+	CC3ShaderProgram*	shaderProgram;		/**< The shader program of the mesh nodes, or NULL if it has not yet been selected. */
+	CC3VertexContent	vertexContentTypes;	/**< The types of vertex content in the meshes. */
+	GLenum				depthFunction;		/**< The depth function of the mesh nodes. */
+	GLuint				drawingFlags;		/**< The face culling, shading and depth flags of the mesh nodes. */
+	GLfloat				decalOffsetFactor;	/**< The decal offset factor of the mesh nodes. */
+	GLfloat				decalOffsetUnits;	/**< The decal offset units of the mesh nodes. */
+} CC3StaticBatchKey;
+
+/**
+ * CC3StaticBatcher merges static mesh nodes that share the same material and drawing state into
+ * CC3StaticBatchNodes, each of which draws many mesh nodes in a single draw call.
+ *
+ * Only mesh nodes whose shouldBatchStatically property is set to YES are batched. In addition,
+ * a mesh node is only batched if it is visible, is drawn as triangles, and has a material and
+ * a mesh whose vertex content is still held in application memory. Skinned mesh nodes, mesh
+ * nodes that draw instances, and mesh nodes whose meshes use overlay texture coordinates or
+ * too many vertices to be indexed, are not batched. Level-of-detail meshes are not carried into
+ * the batch, which is always drawn using the full-detail mesh of each batched mesh node.
+ *
+ * The batched region is divided into cubic spatial cells, and mesh nodes are assigned to cells
+ * by the center of their global bounding box. Within each cell, mesh nodes that share the same
+ * material, shader program, vertex content and drawing state are merged into a static batch,
+ * as long as there are at least minimumBatchSize of them. The vertices of each mesh node are
+ * transformed into the coordinate system of the batching root node and copied, along with its
+ * vertex indices, into a shared mesh. All cells that use the same drawing state share the same
+ * mesh, until the number of vertices reaches the limit that can be addressed by vertex indices,
+ * and each static batch draws only its own range of the vertex indices in the shared mesh.
+ *
+ * The static batch nodes are added to the batching root node, and the mesh nodes merged into
+ * them are hidden. Because the batched vertices are fixed in place, a batched mesh node that is
+ * moved afterwards will not be seen to move. To move it, remove its batch with the unbatch method
+ * of the batch, or remove all batches with the unbatchNodesIn method, and batch the nodes again.
+ *
+ * Normally, the batcher is managed by the CC3Scene, which batches the static mesh nodes of the
+ * scene when it is opened, if the shouldBatchStaticMeshesOnOpen property of the scene is set to
+ * YES, or when its batchStaticMeshNodes method is invoked.
+ */
+class CC3StaticBatcher : public CCObject
+{
+public:
+	CC3StaticBatcher();
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3StaticBatcher*	batcher();
+
+	void						init();
+
+	/**
+	 * The length of the side of each cubic spatial cell. Mesh nodes in different cells are never
+	 * merged into the same static batch. If this value is zero, the cell size is derived from the
+	 * bounding box of the mesh nodes to be batched, by dividing its longest side by
+	 * kCC3DefaultStaticBatchCellDivisions.
+	 *
+	 * The initial value of this property is zero.
+	 */
+	GLfloat						getCellSize();
+	void						setCellSize( GLfloat cellSize );
+
+	/**
+	 * The minimum number of mesh nodes in a single cell, sharing the same drawing state, that
+	 * will be merged into a static batch. Mesh nodes in smaller groups are left unbatched.
+	 *
+	 * The initial value of this property is kCC3DefaultStaticBatchMinimumSize.
+	 */
+	GLuint						getMinimumBatchSize();
+	void						setMinimumBatchSize( GLuint minSize );
+
+	/**
+	 * Merges the static mesh nodes among the specified node and its descendants into static batches,
+	 * adds the static batch nodes to the specified node, and returns the number of mesh nodes that
+	 * were merged into batches.
+	 *
+	 * This method creates GL buffers for the shared meshes, and must be invoked on the rendering thread.
+	 */
+	GLuint						batchNodesIn( CC3Node* rootNode );
+
+	/** Removes all static batch nodes among the descendants of the specified node, and shows the nodes they batched. */
+	void						unbatchNodesIn( CC3Node* rootNode );
+
+protected:
+	bool						isBatchable( CC3MeshNode* aNode );
+	CC3StaticBatchKey			getKeyFor( CC3MeshNode* aNode );
+	GLuint						batchCells( std::vector< std::vector<CC3MeshNode*> >& cells, CC3Node* rootNode, const CC3Matrix4x3* rootInverse );
+	void						copyNodeIntoMesh( CC3MeshNode* aNode, CC3Mesh* sharedMesh, GLuint vtxOffset, GLuint vtxIdxOffset,
+												  const CC3Matrix4x3* rootInverse, CC3Box& batchBox );
+
+protected:
+	GLfloat						m_cellSize;
+	GLuint						m_minimumBatchSize;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -278,6 +278,30 @@ void CC3OpenGL::enable2DVertexAttributes()
 	//CC3AssertUnimplemented(@"enable2DVertexAttributes"); 
 }
 
+void CC3OpenGL::setVertexAttributeDivisor( GLuint divisor, GLint vaIdx )
+{
+	if ( vaIdx < 0 || !supportsInstancedDrawing() )
+		return;
+	CC3VertexAttr* vaPtr = &vertexAttributes[vaIdx];
+
+	if ( vaPtr->divisor == divisor )
+		return;
+
+	vaPtr->divisor = divisor;
+	setVertexAttributeDivisorAt( vaIdx );
+}
+
+void CC3OpenGL::setVertexAttributeDivisorAt( GLint )
+{
+
+}
+
+void CC3OpenGL::resetVertexAttributeDivisors()
+{
+	for (GLuint vaIdx = 0; vaIdx < value_MaxVertexAttribsUsed; vaIdx++)
+		setVertexAttributeDivisor( 0, vaIdx );
+}
+
 GLuint CC3OpenGL::generateBuffer()
 {
 	GLuint buffID;
@@ -398,6 +422,21 @@ void CC3OpenGL::drawIndicies( GLvoid* indicies, GLuint len, GLenum type, GLenum
 	CHECK_GL_ERROR_DEBUG();
 }
 
+bool CC3OpenGL::supportsInstancedDrawing()
+{
+	return value_SupportsInstancedDrawing;
+}
+
+void CC3OpenGL::drawVerticiesInstancedAs( GLenum, GLuint, GLuint, GLuint )
+{
+
+}
+
+void CC3OpenGL::drawIndiciesInstanced( GLvoid*, GLuint, GLenum, GLenum, GLuint )
+{
+
+}
+
 void CC3OpenGL::setClearColor( const ccColor4F& color )
 {
 	cc3_CheckGLValue(color, CCC4FAreEqual(color, value_GL_COLOR_CLEAR_VALUE),
@@ -1702,6 +1741,7 @@ void CC3OpenGL::initPlatformLimits()
 	value_GL_VERSION = getString( GL_VERSION );
 	value_GL_MAX_TEXTURE_SIZE = getInteger( GL_MAX_TEXTURE_SIZE );
 	value_GL_MAX_RENDERBUFFER_SIZE = getInteger( GL_MAX_RENDERBUFFER_SIZE );
+	value_SupportsInstancedDrawing = false;
 
 #if CC3_OGLES_2
 	value_GL_MAX_POINT_SIZE = kCC3MaxGLfloat;
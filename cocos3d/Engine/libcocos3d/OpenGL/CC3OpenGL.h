@@ -55,6 +55,7 @@ typedef struct {
 	GLint elementSize;			/**< The number of elements in each vertex. */
 	GLsizei vertexStride;		/**< The stride in bytes between vertices. */
 	GLvoid* vertices;			/**< A pointer to the vertex content. */
+	GLuint divisor;				/**< The number of instances drawn before the content advances (zero advances per vertex). */
 	bool shouldNormalize : 1;	/**< Indicates whether the vertex content should be normalized by the GL engine. */
 	bool isKnown : 1;			/**< Indicates whether the GL state value are known. */
 	bool isEnabled : 1;			/**< Indicates whether these attributes are enabled in the GL engine. */
@@ -232,6 +233,27 @@ public:
 	/** Enables the vertex attribute needed for drawing Cocos2D 2D artifacts, and disables all the rest. */
 	virtual void				enable2DVertexAttributes();
 
+	/**
+	 * Sets the number of instances that are drawn before the content of the vertex attribute at
+	 * the specified index advances to the next element, during instanced drawing. A divisor of
+	 * zero advances the content once per vertex, and a divisor of one advances it once per instance.
+	 *
+	 * The value will be set in the GL engine only if it has actually changed. This method has no
+	 * effect if the platform does not support instanced drawing.
+	 *
+	 * It is safe to submit a negative index. It will be ignored, and no changes will be made.
+	 */
+	virtual void				setVertexAttributeDivisor( GLuint divisor, GLint vaIdx );
+
+	virtual void				setVertexAttributeDivisorAt( GLint vaIdx );
+
+	/**
+	 * Sets the divisor of all vertex attributes back to zero, so that the content of each advances
+	 * once per vertex. This should be invoked once instanced drawing is complete, so that the vertex
+	 * attributes used for per-instance content can be used for ordinary vertex content again.
+	 */
+	virtual void				resetVertexAttributeDivisors();
+
 	/**
 	 * Generates and returns a GL buffer ID.
 	 *
@@ -288,6 +310,33 @@ public:
 	 */
 	virtual void				drawIndicies( GLvoid* indicies, GLuint len, GLenum type, GLenum drawMode );
 
+	/**
+	 * Returns whether this platform supports drawing many instances of the same vertex content
+	 * in a single draw call, using vertex attributes whose content advances once per instance.
+	 *
+	 * When this method returns NO, the drawVerticiesInstancedAs, drawIndiciesInstanced and
+	 * setVertexAttributeDivisor methods have no effect.
+	 */
+	virtual bool				supportsInstancedDrawing();
+
+	/**
+	 * Draws the specified number of instances of the vertices bound by the vertex pointers, using
+	 * the specified draw mode, starting at the specified index, and drawing the specified number
+	 * of verticies for each instance.
+	 *
+	 * This is a wrapper for the GL function glDrawArraysInstanced.
+	 */
+	virtual void				drawVerticiesInstancedAs( GLenum drawMode, GLuint start, GLuint len, GLuint instanceCount );
+
+	/**
+	 * Draws the specified number of instances of the vertices indexed by the specified indices,
+	 * to the specified number of indices, each of the specified GL type, and using the specified
+	 * draw mode.
+	 *
+	 * This is a wrapper for the GL function glDrawElementsInstanced.
+	 */
+	virtual void				drawIndiciesInstanced( GLvoid* indicies, GLuint len, GLenum type, GLenum drawMode, GLuint instanceCount );
+
 	/** Sets the color used to clear the color buffer. */
 	virtual void				setClearColor( const ccColor4F& color );
 
@@ -1372,6 +1421,8 @@ public:
 
 	GLfloat						value_GL_MAX_POINT_SIZE;
 
+	bool						value_SupportsInstancedDrawing;
+
 	bool						valueCap_GL_BLEND : 1;
 	bool						valueCap_GL_CULL_FACE : 1;
 	bool						valueCap_GL_DEPTH_TEST : 1;
@@ -72,11 +72,11 @@ void CC3OpenGLProgPipeline::bindVertexAttribute( CC3GLSLAttribute* attribute, CC
  */
 CC3VertexArray* CC3OpenGLProgPipeline::getVertexArrayForAttribute( CC3GLSLAttribute* attribute, CC3NodeDrawingVisitor* visitor )
 {
-	CC3Mesh* pMesh = visitor->getCurrentMesh();
-	if ( pMesh == NULL )
+	CC3MeshNode* pMeshNode = visitor->getCurrentMeshNode();
+	if ( pMeshNode == NULL )
 		return NULL;
 
-	return pMesh->getVertexArrayForSemantic( attribute->getSemantic(), attribute->getSemanticIndex() );
+	return pMeshNode->getVertexArrayForSemantic( attribute->getSemantic(), attribute->getSemanticIndex() );
 }
 
 void CC3OpenGLProgPipeline::setVertexAttributeEnablementAt( GLint vaIdx )
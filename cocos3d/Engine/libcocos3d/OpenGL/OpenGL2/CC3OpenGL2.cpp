@@ -158,6 +158,37 @@ void CC3OpenGL2::initPlatformLimits()
 	
 	value_GL_MAX_CUBE_MAP_TEXTURE_SIZE = getInteger( GL_MAX_CUBE_MAP_TEXTURE_SIZE );
 	//LogInfoIfPrimary(@"Maximum cube map texture size: %u", value_GL_MAX_CUBE_MAP_TEXTURE_SIZE);
+
+	// Instanced arrays are available through GLEW. Elsewhere, instances are drawn in uniform batches.
+#ifdef GLEW_ARB_instanced_arrays
+	value_SupportsInstancedDrawing = (GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced);
+#endif
+}
+
+void CC3OpenGL2::setVertexAttributeDivisorAt( GLint vaIdx )
+{
+#ifdef GLEW_ARB_instanced_arrays
+	glVertexAttribDivisorARB( vaIdx, vertexAttributes[vaIdx].divisor );
+	CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void CC3OpenGL2::drawVerticiesInstancedAs( GLenum drawMode, GLuint start, GLuint len, GLuint instanceCount )
+{
+#ifdef GLEW_ARB_instanced_arrays
+	glDrawArraysInstancedARB( drawMode, start, len, instanceCount );
+	CC_INCREMENT_GL_DRAWS(1);
+	CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void CC3OpenGL2::drawIndiciesInstanced( GLvoid* indicies, GLuint len, GLenum type, GLenum drawMode, GLuint instanceCount )
+{
+#ifdef GLEW_ARB_instanced_arrays
+	glDrawElementsInstancedARB( drawMode, len, type, indicies, instanceCount );
+	CC_INCREMENT_GL_DRAWS(1);
+	CHECK_GL_ERROR_DEBUG();
+#endif
 }
 
 #endif	// CC3_OGL && CC3_GLSL
@@ -59,6 +59,10 @@ public:
 	std::string				defaultShaderPreamble();
 	void					initPlatformLimits();
 
+	void					setVertexAttributeDivisorAt( GLint vaIdx );
+	void					drawVerticiesInstancedAs( GLenum drawMode, GLuint start, GLuint len, GLuint instanceCount );
+	void					drawIndiciesInstanced( GLvoid* indicies, GLuint len, GLenum type, GLenum drawMode, GLuint instanceCount );
+
 protected:
 	GLbitfield				value_GL_TEXTURE_CUBE_MAP;				// Track up to 32 texture units
 	GLbitfield				isKnownCap_GL_TEXTURE_CUBE_MAP;			// Track up to 32 texture units
@@ -33,6 +33,13 @@ NS_COCOS3D_BEGIN
 
 #if CC3_OGLES_2
 
+// Instanced arrays are declared by the iOS GL headers. Elsewhere, instances are drawn in uniform batches.
+#if defined(GL_EXT_instanced_arrays) && (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+#	define CC3_OGLES_INSTANCED_ARRAYS	1
+#else
+#	define CC3_OGLES_INSTANCED_ARRAYS	0
+#endif
+
 
 void CC3OpenGLES2::unbindTexturesExceptTarget( GLenum target, GLuint tuIdx )
 {
@@ -159,6 +166,36 @@ void CC3OpenGLES2::initPlatformLimits()
 	
 	value_GL_MAX_CUBE_MAP_TEXTURE_SIZE = getInteger( GL_MAX_CUBE_MAP_TEXTURE_SIZE );
 	//LogInfoIfPrimary(@"Maximum cube map texture size: %u", value_GL_MAX_CUBE_MAP_TEXTURE_SIZE);
+
+#if CC3_OGLES_INSTANCED_ARRAYS
+	value_SupportsInstancedDrawing = (getString( GL_EXTENSIONS ).find( "GL_EXT_instanced_arrays" ) != std::string::npos);
+#endif
+}
+
+void CC3OpenGLES2::setVertexAttributeDivisorAt( GLint vaIdx )
+{
+#if CC3_OGLES_INSTANCED_ARRAYS
+	glVertexAttribDivisorEXT( vaIdx, vertexAttributes[vaIdx].divisor );
+	CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void CC3OpenGLES2::drawVerticiesInstancedAs( GLenum drawMode, GLuint start, GLuint len, GLuint instanceCount )
+{
+#if CC3_OGLES_INSTANCED_ARRAYS
+	glDrawArraysInstancedEXT( drawMode, start, len, instanceCount );
+	CC_INCREMENT_GL_DRAWS(1);
+	CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void CC3OpenGLES2::drawIndiciesInstanced( GLvoid* indicies, GLuint len, GLenum type, GLenum drawMode, GLuint instanceCount )
+{
+#if CC3_OGLES_INSTANCED_ARRAYS
+	glDrawElementsInstancedEXT( drawMode, len, type, indicies, instanceCount );
+	CC_INCREMENT_GL_DRAWS(1);
+	CHECK_GL_ERROR_DEBUG();
+#endif
 }
 
 void CC3OpenGLES2::initShaderPrecisions()
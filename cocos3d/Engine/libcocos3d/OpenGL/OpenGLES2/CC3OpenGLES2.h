@@ -66,6 +66,10 @@ public:
 	GLfloat						getFragmentShaderVarPrecision( GLenum precisionType );
 	void						initPlatformLimits();
 
+	void						setVertexAttributeDivisorAt( GLint vaIdx );
+	void						drawVerticiesInstancedAs( GLenum drawMode, GLuint start, GLuint len, GLuint instanceCount );
+	void						drawIndiciesInstanced( GLvoid* indicies, GLuint len, GLenum type, GLenum drawMode, GLuint instanceCount );
+
 	void						initShaderPrecisions();
 	CC3Vector					getShaderPrecision( GLenum precisionType, GLenum shaderType );
 	void						logShader( GLenum shaderType, const char* qualifier, const CC3Vector& precision, const CC3IntVector& logPrecision );
@@ -189,6 +189,44 @@ bool CC3CommonVertexArrayParticleEmitter::ensureParticleCapacityFor( CC3Particle
 	return true;
 }
 
+/**
+ * Ensures space has been allocated in the mesh for the specified numbers of vertices and vertex
+ * indices, when writing particles from the particle store. The particle store capacity already
+ * expands in chunks, so the mesh is expanded to exactly the requested size.
+ */
+bool CC3CommonVertexArrayParticleEmitter::ensureStoredVertexCapacity( GLuint vtxCount, GLuint vtxIdxCount )
+{
+	CC3Mesh* vaMesh = getMesh();
+	if ( !vaMesh )
+		return false;
+
+	if ( vtxCount > vaMesh->getAllocatedVertexCapacity() )
+	{
+		GLuint meshVtxCount = vaMesh->getVertexCount();
+		vaMesh->setAllocatedVertexCapacity( vtxCount );
+		vaMesh->setVertexCount( meshVtxCount );							// Leave the vertex count unchanged
+		if ( vaMesh->getAllocatedVertexCapacity() != vtxCount ) 
+			return false;	// Expansion failed
+		m_wasVertexCapacityChanged = true;
+		CC3_TRACE( "[ptc]CC3CommonVertexArrayParticleEmitter changed stored particle capacity to %d vertices", vtxCount );
+	}
+
+	if ( vtxIdxCount > 0 && (!vaMesh->hasVertexIndices() || vtxIdxCount > vaMesh->getAllocatedVertexIndexCapacity()) )
+	{
+		GLuint meshVtxIdxCount = vaMesh->getVertexIndexCount();
+		vaMesh->setAllocatedVertexIndexCapacity( vtxIdxCount );
+		vaMesh->setVertexIndexCount( meshVtxIdxCount );					// Leave the vertex index count unchanged
+		vaMesh->getVertexIndices()->setBufferUsage( GL_DYNAMIC_DRAW );	// Make sure to use dynamic draw
+		vaMesh->retainVertexIndices();									// Make sure the indices stick around to be modified
+		if ( vaMesh->getAllocatedVertexIndexCapacity() != vtxIdxCount ) 
+			return false;	// Expansion failed
+		m_wasVertexCapacityChanged = true;
+		CC3_TRACE( "[ptc]CC3CommonVertexArrayParticleEmitter changed stored particle capacity to %d vertex indices", vtxIdxCount );
+	}
+
+	return true;
+}
+
 /**
  * Adds the specified range to the range of dirty vertices.
  * The result is to form a union of the specified range and the current range.
@@ -336,6 +374,9 @@ CC3CommonVertexArrayParticle* CC3CommonVertexArrayParticleEmitter::getCommonVert
 
 CC3Particle* CC3CommonVertexArrayParticleEmitter::getParticleWithVertexAt( GLuint vtxIndex )
 {
+	if ( m_particleStore )
+		return NULL;		// Stored particles are not individual objects
+
 	GLuint pCnt = getParticleCount();
 	for (GLuint pIdx = 0; pIdx < pCnt; pIdx++) 
 	{
@@ -348,6 +389,9 @@ CC3Particle* CC3CommonVertexArrayParticleEmitter::getParticleWithVertexAt( GLuin
 
 CC3Particle* CC3CommonVertexArrayParticleEmitter::getParticleWithVertexIndexAt( GLuint index )
 {
+	if ( m_particleStore )
+		return NULL;		// Stored particles are not individual objects
+
 	GLuint pCnt = getParticleCount();
 	for (GLuint pIdx = 0; pIdx < pCnt; pIdx++) 
 	{
@@ -61,6 +61,13 @@ public:
 	/** Ensures space has been allocated for the specified particle. */
 	bool						ensureParticleCapacityFor( CC3Particle* aParticle );
 
+	/**
+	 * Ensures space has been allocated in the mesh for the specified numbers of vertices and vertex
+	 * indices, when writing particles from the particle store. If the vertex index count is zero,
+	 * the vertex indices of the mesh are left untouched.
+	 */
+	bool						ensureStoredVertexCapacity( GLuint vtxCount, GLuint vtxIdxCount );
+
 	/** Clears the range of dirty vertices and vertex indices. */
 	void						clearDirtyVertexRanges();
 
@@ -34,6 +34,7 @@ NS_COCOS3D_BEGIN
 CC3MeshParticleEmitter::CC3MeshParticleEmitter()
 {
 	m_pParticleTemplateMesh = NULL;
+	m_storedParticleSlotsPopulated = 0;
 }
 
 CC3MeshParticleEmitter::~CC3MeshParticleEmitter()
@@ -55,6 +56,10 @@ void CC3MeshParticleEmitter::setParticleTemplateMesh( CC3Mesh* aMesh )
 	m_pParticleTemplateMesh = aMesh;
 	CC_SAFE_RETAIN( aMesh );
 
+	// Stored particles must be repopulated from the new template
+	m_storedParticleSlotsPopulated = 0;
+	m_storedTemplateLocations.clear();
+
 	// Add vertex content if not already set, and align the drawing mode
 	if ( getVertexContentTypes() == kCC3VertexContentNone )
 		setVertexContentTypes( aMesh->getVertexContentTypes() );
@@ -316,6 +321,9 @@ void CC3MeshParticleEmitter::markParticleTransformDirty()
  */
 bool CC3MeshParticleEmitter::shouldTransformParticles( CC3NodeUpdatingVisitor* visitor )
 {
+	if ( m_particleStore )
+		return false;		// Stored particles are written directly to the mesh
+
 	if ( !isParticleTransformDirty() ) 
 		return false;
 
@@ -343,6 +351,66 @@ void CC3MeshParticleEmitter::transformParticles()
 	m_isParticleTransformDirty = false;
 }
 
+void CC3MeshParticleEmitter::writeParticleStoreToMesh()
+{
+	CCAssert(m_pParticleTemplateMesh, "The particleTemplateMesh property of CC3MeshParticleEmitter must be set before particles can be emitted.");
+
+	GLuint tmplVtxCount = m_pParticleTemplateMesh->getVertexCount();
+	GLuint tmplVtxIdxCount = m_pParticleTemplateMesh->hasVertexIndices() ? m_pParticleTemplateMesh->getVertexIndexCount() : 0;
+	if ( !ensureStoredVertexCapacity( m_currentParticleCapacity * tmplVtxCount, m_currentParticleCapacity * tmplVtxIdxCount ) )
+		return;
+
+	CC3Mesh* vaMesh = getMesh();
+	GLuint pCnt = m_particleStore->getParticleCount();
+	GLuint prevVtxCount = getVertexCount();
+	GLuint prevVtxIdxCount = getVertexIndexCount();
+
+	// Copy the template content into any particle slots that have not been used before.
+	for (GLuint pIdx = m_storedParticleSlotsPopulated; pIdx < pCnt; pIdx++) 
+	{
+		vaMesh->copyVertices( tmplVtxCount, 0, m_pParticleTemplateMesh, pIdx * tmplVtxCount );
+		if ( tmplVtxIdxCount > 0 )
+			vaMesh->copyVertexIndices( tmplVtxIdxCount, 0, m_pParticleTemplateMesh, pIdx * tmplVtxIdxCount, pIdx * tmplVtxCount );
+	}
+	m_storedParticleSlotsPopulated = MAX(m_storedParticleSlotsPopulated, pCnt);
+
+	// Cache the template locations, so they can be read without per-vertex virtual lookups
+	if ( m_storedTemplateLocations.size() != tmplVtxCount )
+	{
+		m_storedTemplateLocations.resize( tmplVtxCount );
+		for (GLuint vIdx = 0; vIdx < tmplVtxCount; vIdx++) 
+			m_storedTemplateLocations[vIdx] = m_pParticleTemplateMesh->getVertexLocationAt( vIdx );
+	}
+
+	CC3Vector* locations = m_particleStore->getLocations();
+	ccColor4F* colors = m_particleStore->getColors();
+	GLfloat* sizes = m_particleStore->getSizes();
+	bool hasColors = vaMesh->hasVertexColors();
+
+	for (GLuint pIdx = 0; pIdx < pCnt; pIdx++) 
+	{
+		GLfloat scale = (sizes[pIdx] > 0.0f) ? sizes[pIdx] : 1.0f;
+		GLuint firstVtx = pIdx * tmplVtxCount;
+		for (GLuint vIdx = 0; vIdx < tmplVtxCount; vIdx++) 
+		{
+			vaMesh->setVertexLocation( (m_storedTemplateLocations[vIdx] * scale) + locations[pIdx], firstVtx + vIdx );
+			if ( hasColors )
+				vaMesh->setVertexColor4F( colors[pIdx], firstVtx + vIdx );
+		}
+	}
+
+	// Mark the vertices of particles that expired since the last update as dirty too.
+	GLuint vtxCount = pCnt * tmplVtxCount;
+	setVertexCount( vtxCount );
+	addDirtyVertexRange( CCRangeMake(0, MAX(vtxCount, prevVtxCount)) );
+	if ( tmplVtxIdxCount > 0 )
+	{
+		GLuint vtxIdxCount = pCnt * tmplVtxIdxCount;
+		setVertexIndexCount( vtxIdxCount );
+		addDirtyVertexIndexRange( CCRangeMake(0, MAX(vtxIdxCount, prevVtxIdxCount)) );
+	}
+}
+
 CC3MeshParticleEmitter* CC3MeshParticleEmitter::nodeWithName( const std::string& aName )
 {
 	CC3MeshParticleEmitter* pVal = new CC3MeshParticleEmitter;
@@ -308,12 +308,25 @@ public:
 	/** Overridden so that the transform is considered dirty if any of the particles need to be transformed. */
 	virtual bool				isTransformDirty();
 
+	/**
+	 * Writes the particles in the particle store to the vertex content of the mesh. Each stored
+	 * particle occupies a copy of the vertex content of the particleTemplateMesh, which is copied
+	 * into the mesh the first time the particle slot is used. On each update, the template vertex
+	 * locations are scaled by the size of the particle and offset by its location, and the
+	 * particle color is written to each vertex, if the mesh contains vertex colors.
+	 *
+	 * Particles with a size of zero in the particle store are drawn at the size of the template mesh.
+	 */
+	void						writeParticleStoreToMesh();
+
 	static CC3MeshParticleEmitter*	nodeWithName( const std::string& aName );
 
 protected:
 	CC3Mesh*					m_pParticleTemplateMesh;
 	bool						m_isParticleTransformDirty : 1;
 	bool						m_shouldTransformUnseenParticles : 1;
+	GLuint						m_storedParticleSlotsPopulated;
+	std::vector<CC3Vector>		m_storedTemplateLocations;
 };
 
 NS_COCOS3D_END
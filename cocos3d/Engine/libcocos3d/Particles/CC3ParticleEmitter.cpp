@@ -35,12 +35,14 @@ CC3ParticleEmitter::CC3ParticleEmitter()
 {
 	m_particles = NULL;
 	m_particleNavigator = NULL;
+	m_particleStore = NULL;
 }
 
 CC3ParticleEmitter::~CC3ParticleEmitter()
 {
 	CC_SAFE_RELEASE( m_particles ); 
 	CC_SAFE_RELEASE( m_particleNavigator );
+	CC_SAFE_RELEASE( m_particleStore );
 }
 
 CC3ParticleNavigator* CC3ParticleEmitter::getParticleNavigator()
@@ -64,6 +66,43 @@ void CC3ParticleEmitter::setParticleNavigator( CC3ParticleNavigator* aNavigator
 		m_particleNavigator->setEmitter( this );
 }
 
+CC3ParticleStore* CC3ParticleEmitter::getParticleStore()
+{
+	return m_particleStore;
+}
+
+void CC3ParticleEmitter::setParticleStore( CC3ParticleStore* aStore )
+{
+	if (aStore == m_particleStore) 
+		return;
+
+	// Particles cannot migrate between object and store representations
+	removeAllParticles();
+	m_particles->removeAllObjects();
+
+	CC_SAFE_RELEASE( m_particleStore );
+	m_particleStore = aStore;
+	CC_SAFE_RETAIN( aStore );
+}
+
+bool CC3ParticleEmitter::shouldUseParticleStore()
+{
+	return m_particleStore != NULL;
+}
+
+void CC3ParticleEmitter::setShouldUseParticleStore( bool shouldUse )
+{
+	if ( shouldUse == shouldUseParticleStore() )
+		return;
+
+	setParticleStore( shouldUse ? makeParticleStore() : NULL );
+}
+
+CC3ParticleStore* CC3ParticleEmitter::makeParticleStore()
+{
+	return CC3ParticleStore::store();
+}
+
 GLfloat CC3ParticleEmitter::getEmissionDuration()
 {
 	return m_emissionDuration;
@@ -192,6 +231,7 @@ void CC3ParticleEmitter::initWithTag( GLuint aTag, const std::string& aName )
 	m_particles = CCArray::create();		// retained
 	m_particles->retain();
 	m_particleNavigator = NULL;
+	m_particleStore = NULL;
 	m_maximumParticleCapacity = kCC3ParticlesNoMax;
 	m_particleCapacityExpansionIncrement = 100;
 	m_particleCount = 0;
@@ -222,6 +262,7 @@ void CC3ParticleEmitter::populateFrom( CC3ParticleEmitter* another )
 	m_shouldRemoveOnFinish = another->shouldRemoveOnFinish();
 	m_shouldUpdateParticlesBeforeTransform = another->shouldUpdateParticlesBeforeTransform();
 	m_shouldUpdateParticlesAfterTransform = another->shouldUpdateParticlesAfterTransform();
+	setShouldUseParticleStore( another->shouldUseParticleStore() );
 }
 
 CCObject* CC3ParticleEmitter::copyWithZone( CCZone* zone )
@@ -253,13 +294,30 @@ void CC3ParticleEmitter::processUpdateBeforeTransform( CC3NodeUpdatingVisitor* v
 	// If configured to update particles before the node is transformed, do so here.
 	// For each particle, invoke the updateBeforeTransform: method. 
 	// Particles can also be removed during the update process.
-	if (m_shouldUpdateParticlesBeforeTransform)
+	// Particles held in a particle store are all updated in a single batch instead.
+	if ( m_particleStore )
+		updateParticleStore( visitor );
+	else if (m_shouldUpdateParticlesBeforeTransform)
 		updateParticlesBeforeTransform( visitor );
 	
 	// If emitting and it's time to quit emitting, do so.
 	// Otherwise check if it's time to emit particles.
 	checkDuration( dt );
 	checkEmission( dt );
+
+	if ( m_particleStore )
+		writeParticleStoreToMesh();
+}
+
+void CC3ParticleEmitter::updateParticleStore( CC3NodeUpdatingVisitor* visitor )
+{
+	m_particleStore->update( visitor->getDeltaTime() );
+	m_particleCount = m_particleStore->getParticleCount();
+}
+
+void CC3ParticleEmitter::writeParticleStoreToMesh()
+{
+
 }
 
 /**
@@ -311,7 +369,10 @@ void CC3ParticleEmitter::checkEmission( GLfloat dt )
 	while ( !isFull() && (m_timeSinceEmission >= m_emissionInterval) ) 
 	{
 		m_timeSinceEmission -= m_emissionInterval;
-		emitParticle();
+		if ( m_particleStore )
+			emitStoredParticle();
+		else
+			emitParticle();
 	}
 }
 
@@ -327,6 +388,64 @@ GLuint CC3ParticleEmitter::emitParticles( GLuint count )
 	return emitCount;
 }
 
+GLuint CC3ParticleEmitter::emitStoredParticles( GLuint count )
+{
+	GLuint emitCount = 0;
+	for ( GLuint i = 0; i < count; i++ ) 
+	{
+		if ( emitStoredParticle() ) 
+			emitCount++;
+	}
+
+	return emitCount;
+}
+
+bool CC3ParticleEmitter::emitStoredParticle()
+{
+	if ( !m_particleStore || isFull() ) 
+		return false;		// Can't add particles if there's no space
+
+	if ( !ensureStoredParticleCapacity() )
+		return false;
+
+	GLuint pIdx = m_particleStore->addParticle();
+	initializeStoredParticle( pIdx );
+
+	if ( m_particleNavigator )
+		m_particleNavigator->initializeStoredParticle( m_particleStore, pIdx );
+
+	// Abort the emission if initialization expired the particle. It is still the last particle.
+	if ( m_particleStore->getTimeToLive()[pIdx] <= 0.0f )
+	{
+		m_particleStore->removeParticleAt( pIdx );
+		return false;
+	}
+
+	m_particleCount = m_particleStore->getParticleCount();
+	return true;
+}
+
+/** Ensures space has been allocated in the particle store for one more particle. */
+bool CC3ParticleEmitter::ensureStoredParticleCapacity()
+{
+	// If we are at current capacity, see if we can expand
+	if ( m_particleCount == m_currentParticleCapacity ) 
+	{
+		GLuint origCap = m_currentParticleCapacity;
+		m_currentParticleCapacity = MIN(m_currentParticleCapacity + m_particleCapacityExpansionIncrement,
+									   m_maximumParticleCapacity);
+		if ( m_currentParticleCapacity <= origCap )
+			return false;
+	}
+
+	return m_particleStore->ensureParticleCapacity( m_currentParticleCapacity );
+}
+
+void CC3ParticleEmitter::initializeStoredParticle( GLuint )
+{
+
+}
+
 CC3Particle* CC3ParticleEmitter::emitParticle()
 {
 	CC3Particle* particle = acquireParticle();
@@ -432,7 +551,7 @@ void CC3ParticleEmitter::processUpdateAfterTransform( CC3NodeUpdatingVisitor* vi
 	// If configured to update particles after the node is transformed, do so here.
 	// For each particle, invoke the updateBeforeTransform: method. 
 	// Particles can also be removed during the update process.
-	if ( m_shouldUpdateParticlesAfterTransform )
+	if ( m_shouldUpdateParticlesAfterTransform && !m_particleStore )
 		updateParticlesAfterTransform( visitor );
 	
 	// If emission has stopped and all the particles have been killed off and the
@@ -515,6 +634,9 @@ bool CC3ParticleEmitter::isFinished()
 
 CC3Particle* CC3ParticleEmitter::getParticleAt( GLuint aParticleIndex )
 {
+	if ( m_particleStore )
+		return NULL;		// Stored particles are not individual objects
+
 	return (CC3Particle*)m_particles->objectAtIndex( aParticleIndex );
 }
 
@@ -569,6 +691,13 @@ void CC3ParticleEmitter::removeParticle( CC3Particle* aParticle, GLuint anIndex
 
 void CC3ParticleEmitter::removeAllParticles()
 {
+	if ( m_particleStore )
+	{
+		m_particleStore->removeAllParticles();
+		m_particleCount = 0;
+		return;
+	}
+
 	GLuint pCnt = getParticleCount();
 	for (GLuint pIdx = 0; pIdx < pCnt; pIdx++) 
 	{
@@ -34,6 +34,7 @@ NS_COCOS3D_BEGIN
 
 class CC3Particle;
 class CC3ParticleNavigator;
+class CC3ParticleStore;
 /**
  * A CC3MeshNode that emits 3D particles.
  *
@@ -151,6 +152,12 @@ class CC3ParticleNavigator;
  * volume grew to during particle emission. This will give you an idea of how big to set the static
  * boundary properties of the boundingVolume of your emitter.
  *
+ * For emitters that manage very large numbers of simple particles, you can set the
+ * shouldUseParticleStore property to YES. Instead of individual CC3Particle objects, particles
+ * are then held in a CC3ParticleStore, in which each particle attribute occupies a contiguous
+ * array, and all particles are updated in a single batch on each update pass. In this mode,
+ * the emitter writes its vertex content directly from the particle store.
+ *
  * All memory used by the particles and the underlying vertex mesh is managed by this
  * emitter node, and is deallocated automatically when the emitter is released.
  */
@@ -351,6 +358,40 @@ public:
 	virtual bool				shouldUpdateParticlesAfterTransform();
 	virtual void				setShouldUpdateParticlesAfterTransform( bool shouldUpdate );
 
+	/**
+	 * The structure-of-arrays particle store that holds the particles of this emitter, or nil if
+	 * this emitter manages its particles as individual CC3Particle objects.
+	 *
+	 * While a particle store is attached, emitted particles are added to the store instead of being
+	 * instantiated as CC3Particle objects, the particles are updated in a single batch through the
+	 * update: method of the store, and the vertex content of the mesh is written directly from the
+	 * arrays of the store by the writeParticleStoreToMesh method. In this mode, the particles
+	 * collection remains empty, and the methods that retrieve individual CC3Particle objects
+	 * return nil.
+	 *
+	 * Setting this property removes any existing particles. The initial value of this property is nil.
+	 */
+	virtual CC3ParticleStore*	getParticleStore();
+	virtual void				setParticleStore( CC3ParticleStore* store );
+
+	/**
+	 * Indicates whether this emitter holds its particles in a particle store.
+	 *
+	 * Setting this property to YES attaches a new particle store, created by the makeParticleStore
+	 * method, if one is not already attached. Setting this property to NO detaches the particle store.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUseParticleStore();
+	void						setShouldUseParticleStore( bool shouldUse );
+
+	/**
+	 * Template method that creates the particle store used when the shouldUseParticleStore
+	 * property is set to YES. Subclasses may override to provide a CC3ParticleStore subclass
+	 * that defines custom batch update behaviour.
+	 */
+	virtual CC3ParticleStore*	makeParticleStore();
+
 	/** Begins, or resumes, the emission of particles by setting the isEmitting property to YES. */
 	virtual void				play();
 
@@ -472,6 +513,33 @@ public:
 	 */
 	virtual GLuint				emitParticles( GLuint count );
 
+	/**
+	 * When a particle store is in use, emits a single particle into the particle store.
+	 *
+	 * The particle is added to the store, and is initialized by invoking initializeStoredParticle:
+	 * on this emitter, and then initializeStoredParticle:at: on the particle navigator. If the
+	 * timeToLive of the particle is zero or less once initialized, the emission is aborted.
+	 *
+	 * Returns whether the particle was emitted. As with the emitParticle method, you do not need
+	 * to invoke this method directly if the emitter is set to emit particles automatically.
+	 */
+	virtual bool				emitStoredParticle();
+
+	/**
+	 * Emits the specified number of particles into the particle store, by invoking the
+	 * emitStoredParticle method repeatedly, and returns the number of particles emitted.
+	 */
+	virtual GLuint				emitStoredParticles( GLuint count );
+
+	/**
+	 * Template method that initializes the particle at the specified index in the particle store.
+	 * This method is invoked automatically from the emitStoredParticle method, prior to the
+	 * initialization of the particle by the particle navigator.
+	 *
+	 * This implementation does nothing. Subclasses may override.
+	 */
+	virtual void				initializeStoredParticle( GLuint index );
+
 	/**
 	 * Adds the specified particle to the emitter and emits it.
 	 *
@@ -686,6 +754,25 @@ public:
 	 */
 	virtual void				updateParticlesAfterTransform( CC3NodeUpdatingVisitor* visitor );
 
+	/**
+	 * Updates all particles in the particle store in a single batch, removes those that
+	 * have expired, and updates the particleCount property to match.
+	 */
+	virtual void				updateParticleStore( CC3NodeUpdatingVisitor* visitor );
+
+	/**
+	 * Template method that writes the content of the particle store to the vertex content
+	 * of the mesh of this emitter. This method is invoked on each update pass, after particles
+	 * have been updated and emitted, when a particle store is in use.
+	 *
+	 * This implementation does nothing. Subclasses that draw particles from a particle store
+	 * will override.
+	 */
+	virtual void				writeParticleStoreToMesh();
+
+	/** Ensures space has been allocated in the particle store for one more particle. */
+	virtual bool				ensureStoredParticleCapacity();
+
 	/** Template method that checks if its time to quit emitting. */
 	virtual void				checkDuration( GLfloat dt );
 
@@ -707,6 +794,7 @@ public:
 protected:
 	CCArray*					m_particles;
 	CC3ParticleNavigator*		m_particleNavigator;
+	CC3ParticleStore*			m_particleStore;
 	GLuint						m_currentParticleCapacity;
 	GLuint						m_maximumParticleCapacity;
 	GLuint						m_particleCapacityExpansionIncrement;
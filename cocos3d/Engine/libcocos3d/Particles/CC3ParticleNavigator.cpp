@@ -56,6 +56,11 @@ void CC3ParticleNavigator::initializeParticle( CC3Particle* aParticle )
 
 }
 
+void CC3ParticleNavigator::initializeStoredParticle( CC3ParticleStore*, GLuint )
+{
+
+}
+
 bool CC3ParticleNavigator::init()
 {
 	m_pEmitter = NULL;
@@ -34,6 +34,7 @@ NS_COCOS3D_BEGIN
 
 class CC3Particle;
 class CC3ParticleEmitter;
+class CC3ParticleStore;
 /**
  * A particle navigator is assigned to a single particle emitter, and is responsible for configuring
  * the life cycle and emission path of the particle on behalf of the emitter.
@@ -102,6 +103,22 @@ public:
 	 */
 	virtual void				initializeParticle( CC3Particle* aParticle );
 
+	/**
+	 * Template method that initializes the particle at the specified index in the specified
+	 * particle store. This is the counterpart of the initializeParticle: method, and is invoked
+	 * automatically from the emitter when it emits a particle into its particle store.
+	 *
+	 * Subclasses will override this method to configure the stored particle by writing directly
+	 * into the arrays of the particle store. Subclasses should always invoke the superclass
+	 * implementation to ensure the superclass initialization behaviour is performed.
+	 *
+	 * In this method, you can set the timeToLive of the particle to zero to cause the emission
+	 * of the particle to be aborted.
+	 *
+	 * This implementation does nothing.
+	 */
+	virtual void				initializeStoredParticle( CC3ParticleStore* store, GLuint index );
+
 	/**
 	 * Template method that populates this instance from the specified other instance.
 	 *
@@ -0,0 +1,280 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+CC3ParticleStore::CC3ParticleStore()
+{
+	m_locations = NULL;
+	m_velocities = NULL;
+	m_colors = NULL;
+	m_colorVelocities = NULL;
+	m_sizes = NULL;
+	m_sizeVelocities = NULL;
+	m_timeToLive = NULL;
+	m_lifeSpans = NULL;
+	m_particleCount = 0;
+	m_particleCapacity = 0;
+	m_capacityExpansionIncrement = 100;
+}
+
+CC3ParticleStore::~CC3ParticleStore()
+{
+	deallocateArrays();
+}
+
+bool CC3ParticleStore::init()
+{
+	return true;
+}
+
+CC3ParticleStore* CC3ParticleStore::store()
+{
+	CC3ParticleStore* pStore = new CC3ParticleStore;
+	pStore->init();
+	pStore->autorelease();
+
+	return pStore;
+}
+
+void CC3ParticleStore::deallocateArrays()
+{
+	CC_SAFE_DELETE_ARRAY( m_locations );
+	CC_SAFE_DELETE_ARRAY( m_velocities );
+	CC_SAFE_DELETE_ARRAY( m_colors );
+	CC_SAFE_DELETE_ARRAY( m_colorVelocities );
+	CC_SAFE_DELETE_ARRAY( m_sizes );
+	CC_SAFE_DELETE_ARRAY( m_sizeVelocities );
+	CC_SAFE_DELETE_ARRAY( m_timeToLive );
+	CC_SAFE_DELETE_ARRAY( m_lifeSpans );
+	m_locations = m_velocities = NULL;
+	m_colors = m_colorVelocities = NULL;
+	m_sizes = m_sizeVelocities = m_timeToLive = m_lifeSpans = NULL;
+	m_particleCount = 0;
+	m_particleCapacity = 0;
+}
+
+GLuint CC3ParticleStore::getParticleCount()
+{
+	return m_particleCount;
+}
+
+GLuint CC3ParticleStore::getParticleCapacity()
+{
+	return m_particleCapacity;
+}
+
+GLuint CC3ParticleStore::getCapacityExpansionIncrement()
+{
+	return m_capacityExpansionIncrement;
+}
+
+void CC3ParticleStore::setCapacityExpansionIncrement( GLuint increment )
+{
+	m_capacityExpansionIncrement = MAX(increment, 1);
+}
+
+/** Replaces the specified array with a larger one, copying the first elemCount elements across. */
+template <class T>
+static void CC3ExpandArray( T*& anArray, GLuint elemCount, GLuint capacity )
+{
+	T* newArray = new T[capacity];
+	for (GLuint i = 0; i < elemCount; i++)
+		newArray[i] = anArray[i];
+
+	CC_SAFE_DELETE_ARRAY( anArray );
+	anArray = newArray;
+}
+
+bool CC3ParticleStore::ensureParticleCapacity( GLuint capacity )
+{
+	if ( capacity <= m_particleCapacity )
+		return true;
+
+	CC3ExpandArray( m_locations, m_particleCount, capacity );
+	CC3ExpandArray( m_velocities, m_particleCount, capacity );
+	CC3ExpandArray( m_colors, m_particleCount, capacity );
+	CC3ExpandArray( m_colorVelocities, m_particleCount, capacity );
+	CC3ExpandArray( m_sizes, m_particleCount, capacity );
+	CC3ExpandArray( m_sizeVelocities, m_particleCount, capacity );
+	CC3ExpandArray( m_timeToLive, m_particleCount, capacity );
+	CC3ExpandArray( m_lifeSpans, m_particleCount, capacity );
+
+	m_particleCapacity = capacity;
+	return true;
+}
+
+GLuint CC3ParticleStore::addParticle()
+{
+	if ( m_particleCount == m_particleCapacity )
+		ensureParticleCapacity( m_particleCapacity + m_capacityExpansionIncrement );
+
+	CCAssert(m_particleCount < m_particleCapacity, "CC3ParticleStore could not expand to add a particle");
+
+	GLuint pIdx = m_particleCount++;
+	m_locations[pIdx] = CC3Vector::kCC3VectorZero;
+	m_velocities[pIdx] = CC3Vector::kCC3VectorZero;
+	m_colors[pIdx] = kCCC4FWhite;
+	m_colorVelocities[pIdx] = kCCC4FBlackTransparent;
+	m_sizes[pIdx] = 0.0f;
+	m_sizeVelocities[pIdx] = 0.0f;
+	m_timeToLive[pIdx] = kCC3ParticleInfiniteInterval;
+	m_lifeSpans[pIdx] = kCC3ParticleInfiniteInterval;
+
+	return pIdx;
+}
+
+void CC3ParticleStore::copyParticle( GLuint srcIndex, GLuint dstIndex )
+{
+	m_locations[dstIndex] = m_locations[srcIndex];
+	m_velocities[dstIndex] = m_velocities[srcIndex];
+	m_colors[dstIndex] = m_colors[srcIndex];
+	m_colorVelocities[dstIndex] = m_colorVelocities[srcIndex];
+	m_sizes[dstIndex] = m_sizes[srcIndex];
+	m_sizeVelocities[dstIndex] = m_sizeVelocities[srcIndex];
+	m_timeToLive[dstIndex] = m_timeToLive[srcIndex];
+	m_lifeSpans[dstIndex] = m_lifeSpans[srcIndex];
+}
+
+void CC3ParticleStore::removeParticleAt( GLuint index )
+{
+	if ( index >= m_particleCount )
+		return;
+
+	m_particleCount--;
+	if ( index < m_particleCount )
+		copyParticle( m_particleCount, index );
+}
+
+void CC3ParticleStore::removeAllParticles()
+{
+	m_particleCount = 0;
+}
+
+GLuint CC3ParticleStore::removeExpiredParticles()
+{
+	GLuint origCount = m_particleCount;
+	GLuint pIdx = 0;
+	while ( pIdx < m_particleCount )
+	{
+		// Don't increment the index after a removal, because the particle moved into the slot must be tested too
+		if ( m_timeToLive[pIdx] <= 0.0f )
+			removeParticleAt( pIdx );
+		else
+			pIdx++;
+	}
+	return origCount - m_particleCount;
+}
+
+void CC3ParticleStore::update( GLfloat dt )
+{
+	if ( m_particleCount == 0 )
+		return;
+
+	updateParticles( dt );
+	removeExpiredParticles();
+}
+
+void CC3ParticleStore::updateParticles( GLfloat dt )
+{
+	integrateParticles( dt );
+}
+
+/**
+ * Each attribute array is treated as a flat array of floats, so that each loop
+ * is a simple multiply-add over contiguous memory that the compiler can vectorize.
+ */
+void CC3ParticleStore::integrateParticles( GLfloat dt )
+{
+	GLuint pCnt = m_particleCount;
+
+	GLfloat* locs = (GLfloat*)m_locations;
+	const GLfloat* vels = (const GLfloat*)m_velocities;
+	GLuint locFloatCnt = pCnt * 3;
+	for ( GLuint i = 0; i < locFloatCnt; i++ )
+		locs[i] += vels[i] * dt;
+
+	GLfloat* colors = (GLfloat*)m_colors;
+	const GLfloat* colorVels = (const GLfloat*)m_colorVelocities;
+	GLuint colorFloatCnt = pCnt * 4;
+	for ( GLuint i = 0; i < colorFloatCnt; i++ )
+		colors[i] += colorVels[i] * dt;
+
+	for ( GLuint i = 0; i < pCnt; i++ )
+		m_sizes[i] += m_sizeVelocities[i] * dt;
+
+	for ( GLuint i = 0; i < pCnt; i++ )
+		m_timeToLive[i] -= dt;
+}
+
+CC3Vector* CC3ParticleStore::getLocations()
+{
+	return m_locations;
+}
+
+CC3Vector* CC3ParticleStore::getVelocities()
+{
+	return m_velocities;
+}
+
+ccColor4F* CC3ParticleStore::getColors()
+{
+	return m_colors;
+}
+
+ccColor4F* CC3ParticleStore::getColorVelocities()
+{
+	return m_colorVelocities;
+}
+
+GLfloat* CC3ParticleStore::getSizes()
+{
+	return m_sizes;
+}
+
+GLfloat* CC3ParticleStore::getSizeVelocities()
+{
+	return m_sizeVelocities;
+}
+
+GLfloat* CC3ParticleStore::getTimeToLive()
+{
+	return m_timeToLive;
+}
+
+GLfloat* CC3ParticleStore::getLifeSpans()
+{
+	return m_lifeSpans;
+}
+
+void CC3ParticleStore::setLifeSpan( GLfloat lifeSpan, GLuint index )
+{
+	m_lifeSpans[index] = lifeSpan;
+	m_timeToLive[index] = lifeSpan;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,180 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_PARTICLE_STORE_H_
+#define _CC3_PARTICLE_STORE_H_
+
+NS_COCOS3D_BEGIN
+
+/**
+ * CC3ParticleStore holds the state of a large number of simple particles in a
+ * structure-of-arrays layout, as an alternative to individually allocated CC3Particle objects.
+ *
+ * Each particle attribute (location, velocity, color, size, and remaining lifetime) is held in
+ * its own contiguous array, indexed by particle. The living particles always occupy the first
+ * particleCount entries of each array. When a particle expires, the last living particle is
+ * moved into its slot, so the arrays remain densely packed without any per-particle allocation.
+ * As a result, particle indices are not stable across updates.
+ *
+ * On each update, the updateParticles: template method is invoked once for the entire batch
+ * of particles, rather than once per particle. The default implementation integrates the
+ * velocities of each attribute over the elapsed time, and ages each particle. Because the
+ * attributes are held in flat float arrays, these loops are simple enough for the compiler to
+ * vectorize. Subclasses can override updateParticles: to define custom batch behaviour.
+ *
+ * A particle store is attached to a CC3ParticleEmitter through its particleStore property,
+ * and the emitter writes the vertex content of its mesh directly from these arrays.
+ */
+class CC3ParticleStore : public CCObject
+{
+public:
+	CC3ParticleStore();
+	virtual ~CC3ParticleStore();
+
+	/** The number of particles that are currently alive. */
+	GLuint						getParticleCount();
+
+	/** The number of particles for which memory has currently been allocated. */
+	GLuint						getParticleCapacity();
+
+	/**
+	 * Ensures that memory has been allocated for at least the specified number of particles,
+	 * and returns whether the allocation was successful. Existing particles are retained.
+	 */
+	bool						ensureParticleCapacity( GLuint capacity );
+
+	/**
+	 * Adds a new particle to the end of the living particles, and returns its index.
+	 *
+	 * The particle is initialized at the origin, with zero velocity, an opaque white color, a
+	 * size of zero (indicating the emitter default size should be used), and an infinite lifespan.
+	 * The capacity of this store is expanded if needed.
+	 */
+	GLuint						addParticle();
+
+	/**
+	 * Removes the particle at the specified index, by moving the last living particle into
+	 * its slot. The index of the particle that was previously last becomes the specified index.
+	 */
+	void						removeParticleAt( GLuint index );
+
+	/** Removes all particles. The allocated memory is retained for reuse. */
+	void						removeAllParticles();
+
+	/**
+	 * Removes all particles whose timeToLive has reached zero, compacting the living particles
+	 * into the front of each array. Returns the number of particles that were removed.
+	 */
+	GLuint						removeExpiredParticles();
+
+	/**
+	 * Updates all living particles by invoking the updateParticles: template method,
+	 * and then removes any particles that expired during the update.
+	 */
+	void						update( GLfloat dt );
+
+	/**
+	 * Template method that updates the entire batch of living particles, for the specified
+	 * elapsed time in seconds.
+	 *
+	 * This implementation invokes integrateParticles:. Subclasses may override to add custom
+	 * behaviour, such as gravity or drag, and should invoke this superclass implementation to
+	 * integrate motion and age the particles. A particle is expired by setting its timeToLive
+	 * to zero or less.
+	 */
+	virtual void				updateParticles( GLfloat dt );
+
+	/**
+	 * Moves each particle by its velocity, evolves its color and size by their velocities,
+	 * and reduces its timeToLive, all over the specified elapsed time in seconds.
+	 */
+	void						integrateParticles( GLfloat dt );
+
+	/** The location of each particle, in the local coordinates of the emitter. */
+	CC3Vector*					getLocations();
+
+	/** The velocity of each particle, in the local coordinates of the emitter. */
+	CC3Vector*					getVelocities();
+
+	/** The color of each particle. */
+	ccColor4F*					getColors();
+
+	/** The rate of change of the color of each particle, per second. */
+	ccColor4F*					getColorVelocities();
+
+	/** The size of each particle. A value of zero indicates the emitter default should be used. */
+	GLfloat*					getSizes();
+
+	/** The rate of change of the size of each particle, per second. */
+	GLfloat*					getSizeVelocities();
+
+	/**
+	 * The remaining time, in seconds, before each particle expires. The initial value
+	 * for each new particle is kCC3ParticleInfiniteInterval, indicating it will not expire.
+	 */
+	GLfloat*					getTimeToLive();
+
+	/** The total lifespan, in seconds, of each particle, as set when the particle was initialized. */
+	GLfloat*					getLifeSpans();
+
+	/**
+	 * Sets the lifespan of the particle at the specified index, and
+	 * sets its timeToLive to the same value.
+	 */
+	void						setLifeSpan( GLfloat lifeSpan, GLuint index );
+
+	/**
+	 * The number of particles by which the capacity is expanded when addParticle
+	 * is invoked while this store is full. The initial value is 100.
+	 */
+	GLuint						getCapacityExpansionIncrement();
+	void						setCapacityExpansionIncrement( GLuint increment );
+
+	virtual bool				init();
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3ParticleStore*	store();
+
+protected:
+	void						copyParticle( GLuint srcIndex, GLuint dstIndex );
+	void						deallocateArrays();
+
+protected:
+	CC3Vector*					m_locations;
+	CC3Vector*					m_velocities;
+	ccColor4F*					m_colors;
+	ccColor4F*					m_colorVelocities;
+	GLfloat*					m_sizes;
+	GLfloat*					m_sizeVelocities;
+	GLfloat*					m_timeToLive;
+	GLfloat*					m_lifeSpans;
+	GLuint						m_particleCount;
+	GLuint						m_particleCapacity;
+	GLuint						m_capacityExpansionIncrement;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -275,6 +275,58 @@ void CC3PointParticleEmitter::updateParticleNormals( CC3NodeUpdatingVisitor* vis
 	}
 }
 
+void CC3PointParticleEmitter::writeParticleStoreToMesh()
+{
+	GLuint pCnt = m_particleStore->getParticleCount();
+	GLuint prevVtxCount = getVertexCount();
+	bool hasIndices = m_pMesh && m_pMesh->hasVertexIndices();
+	if ( !ensureStoredVertexCapacity( m_currentParticleCapacity, hasIndices ? m_currentParticleCapacity : 0 ) )
+		return;
+
+	CC3Vector* locations = m_particleStore->getLocations();
+	ccColor4F* colors = m_particleStore->getColors();
+	GLfloat* sizes = m_particleStore->getSizes();
+	bool hasColors = m_pMesh->hasVertexColors();
+	bool hasSizes = m_pMesh->hasVertexPointSizes();
+
+	// Normals point from each particle towards the camera, in the local coordinates of the emitter.
+	// The camera location is registered during the first update of the particle normals.
+	bool hasNormals = hasIlluminatedNormals() && !m_globalCameraLocation.isNull();
+	CC3Vector camDir = CC3Vector::kCC3VectorZero;
+	if ( hasNormals )
+	{
+		camDir = m_globalCameraLocation.difference( getGlobalLocation() );
+		camDir = getGlobalTransformMatrixInverted()->transformDirection( camDir );
+	}
+
+	for (GLuint pIdx = 0; pIdx < pCnt; pIdx++) 
+	{
+		m_pMesh->setVertexLocation( locations[pIdx], pIdx );
+
+		if ( hasColors )
+			m_pMesh->setVertexColor4F( colors[pIdx], pIdx );
+
+		if ( hasSizes )
+			m_pMesh->setVertexPointSize( normalizeParticleSizeToDevice( (sizes[pIdx] > 0.0f) ? sizes[pIdx] : m_particleSize ), pIdx );
+
+		if ( hasNormals )
+			m_pMesh->setVertexNormal( camDir.difference( locations[pIdx] ).normalize(), pIdx );
+
+		if ( hasIndices )
+			m_pMesh->setVertexIndex( pIdx, pIdx );
+	}
+
+	// Mark the vertices of particles that expired since the last update as dirty too.
+	setVertexCount( pCnt );
+	addDirtyVertexRange( CCRangeMake(0, MAX(pCnt, prevVtxCount)) );
+	if ( hasIndices )
+	{
+		setVertexIndexCount( pCnt );
+		addDirtyVertexIndexRange( CCRangeMake(0, MAX(pCnt, prevVtxCount)) );
+	}
+	m_areParticleNormalsDirty = false;
+}
+
 /**
  * Determine the global vector that points from the emitter to the camera,
  * transform it to the local coordinates of the emitter and point the
@@ -341,6 +341,13 @@ public:
 	 */
 	void						updateParticleNormals( CC3NodeUpdatingVisitor* visitor );
 
+	/**
+	 * Writes the locations, colors, sizes and normals of the particles in the particle store
+	 * directly to the vertex content of the mesh, one point vertex per particle. Particles with
+	 * a size of zero in the particle store are drawn at the size of the particleSize property.
+	 */
+	void						writeParticleStoreToMesh();
+
 	/**
 	 * Remove the current particle from the active particles, but keep it cached for future use.
 	 * To do this, decrement the particle count and swap the current particle with the last living
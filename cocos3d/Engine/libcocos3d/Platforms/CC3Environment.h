@@ -92,6 +92,39 @@
 #endif
 
 
+/**
+ * Use SSE2 vector instructions for the core matrix functions on x86 processors.
+ * Define as 0 in the build settings to force the scalar implementations.
+ */
+#ifndef CC3_SIMD_SSE
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define CC3_SIMD_SSE		1
+#	else
+#		define CC3_SIMD_SSE		0
+#	endif
+#endif
+
+/**
+ * Use NEON vector instructions for the core matrix functions on ARM processors.
+ * Define as 0 in the build settings to force the scalar implementations.
+ */
+#ifndef CC3_SIMD_NEON
+#	if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#		define CC3_SIMD_NEON		1
+#	else
+#		define CC3_SIMD_NEON		0
+#	endif
+#endif
+
+/**
+ * Compile the CC3_PROFILE_ZONE timing zones into the library. The zones do no timing unless
+ * profiling is also enabled at runtime through the CC3FrameProfiler. Define as 0 in the
+ * build settings to remove the zones entirely.
+ */
+#ifndef CC3_PROFILING
+#	define CC3_PROFILING		1
+#endif
+
 /** Running an OpenGL version that supports GLSL (any but OpenGL ES 1.1). */
 #ifndef CC3_GLSL
 #	define CC3_GLSL			1
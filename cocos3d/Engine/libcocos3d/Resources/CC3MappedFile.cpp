@@ -0,0 +1,179 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+NS_COCOS3D_BEGIN
+
+CC3MappedFile::CC3MappedFile()
+{
+	m_pBytes = NULL;
+	m_length = 0;
+	m_isMemoryMapped = false;
+}
+
+CC3MappedFile::~CC3MappedFile()
+{
+	if ( !m_pBytes )
+		return;
+
+	if ( m_isMemoryMapped )
+	{
+#ifdef _WIN32
+		UnmapViewOfFile( m_pBytes );
+#else
+		munmap( m_pBytes, m_length );
+#endif
+	}
+	else
+	{
+		delete[] m_pBytes;
+	}
+}
+
+char* CC3MappedFile::getBytes()
+{
+	return m_pBytes;
+}
+
+size_t CC3MappedFile::getLength()
+{
+	return m_length;
+}
+
+bool CC3MappedFile::isMemoryMapped()
+{
+	return m_isMemoryMapped;
+}
+
+bool CC3MappedFile::containsPointer( const void* aPointer )
+{
+	return m_pBytes && aPointer >= (const void*)m_pBytes && aPointer < (const void*)(m_pBytes + m_length);
+}
+
+bool CC3MappedFile::initWithFilePath( const std::string& filePath )
+{
+	return mapFile( filePath ) || readFile( filePath );
+}
+
+/** Maps the file privately, with copy-on-write access. Empty files are not mapped. */
+bool CC3MappedFile::mapFile( const std::string& filePath )
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE )
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart == 0 )
+	{
+		CloseHandle( file );
+		return false;
+	}
+
+	// The view keeps the mapping open, so both handles can be closed once it exists
+	HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+	CloseHandle( file );
+	if ( !mapping )
+		return false;
+
+	void* bytes = MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+	CloseHandle( mapping );
+	if ( !bytes )
+		return false;
+
+	m_length = (size_t)fileSize.QuadPart;
+#else
+	int fd = open( filePath.c_str(), O_RDONLY );
+	if ( fd < 0 )
+		return false;
+
+	struct stat fileStat;
+	if ( fstat( fd, &fileStat ) != 0 || fileStat.st_size <= 0 )
+	{
+		close( fd );
+		return false;
+	}
+
+	// The mapping remains valid after the file is closed
+	void* bytes = mmap( NULL, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if ( bytes == MAP_FAILED )
+		return false;
+
+	m_length = (size_t)fileStat.st_size;
+#endif
+
+	m_pBytes = (char*)bytes;
+	m_isMemoryMapped = true;
+
+	CC3_TRACE("[rez]CC3MappedFile mapped %lu bytes from file '%s'", (unsigned long)m_length, filePath.c_str());
+	return true;
+}
+
+/** Reads the file through CCFileUtils, which also handles files in application packages. */
+bool CC3MappedFile::readFile( const std::string& filePath )
+{
+	unsigned long fileSize = 0;
+	unsigned char* bytes = CCFileUtils::sharedFileUtils()->getFileData( filePath.c_str(), "rb", &fileSize );
+	if ( !bytes )
+		return false;
+
+	if ( fileSize == 0 )
+	{
+		delete[] bytes;
+		return false;
+	}
+
+	m_pBytes = (char*)bytes;
+	m_length = (size_t)fileSize;
+	m_isMemoryMapped = false;
+
+	CC3_TRACE("[rez]CC3MappedFile read %lu bytes from file '%s'", (unsigned long)m_length, filePath.c_str());
+	return true;
+}
+
+CC3MappedFile* CC3MappedFile::fileWithFilePath( const std::string& filePath )
+{
+	CC3MappedFile* pFile = new CC3MappedFile;
+	if ( pFile->initWithFilePath( filePath ) )
+	{
+		pFile->autorelease();
+		return pFile;
+	}
+
+	CC_SAFE_DELETE( pFile );
+	return NULL;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,93 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_MAPPED_FILE_H_
+#define _CC3_MAPPED_FILE_H_
+
+NS_COCOS3D_BEGIN
+
+/**
+ * CC3MappedFile makes the content of a file available in memory by mapping the file into the
+ * address space of the application, instead of reading it into allocated memory.
+ *
+ * Pages of a mapped file are only read from storage when they are first accessed, and, until they
+ * are modified, they are backed by the file itself, so the operating system can discard them under
+ * memory pressure instead of holding them in application memory. This makes it practical to
+ * reference large blocks of file content, such as vertex data, in place for as long as needed.
+ *
+ * The mapping is private and writable. Modifying the content does not change the file. Instead,
+ * each modified page is copied on its first modification, and only that page then occupies
+ * application memory.
+ *
+ * If the file cannot be mapped, for example because it resides within a compressed application
+ * package, as is the case for Android assets, the content is read into allocated memory instead,
+ * and the isMemoryMapped property returns NO. The content is valid in either case until this
+ * instance is deallocated, so any object that references the content should retain this instance.
+ */
+class CC3MappedFile : public CCObject
+{
+public:
+	CC3MappedFile();
+	~CC3MappedFile();
+
+	/** Returns a pointer to the file content, or NULL if the file could not be loaded. */
+	char*						getBytes();
+
+	/** Returns the length of the file content, in bytes. */
+	size_t						getLength();
+
+	/** Returns whether the file content is mapped from the file, or was read into allocated memory. */
+	bool						isMemoryMapped();
+
+	/** Returns whether the specified pointer lies within the file content. */
+	bool						containsPointer( const void* aPointer );
+
+	/**
+	 * Initializes this instance by mapping the file at the specified absolute file path,
+	 * or, if the file cannot be mapped, by reading it into memory.
+	 *
+	 * Returns whether the file content is available.
+	 */
+	bool						initWithFilePath( const std::string& filePath );
+
+	/**
+	 * Allocates and initializes an autoreleased instance on the file at the specified absolute
+	 * file path. Returns NULL if the file content could not be mapped or read.
+	 */
+	static CC3MappedFile*		fileWithFilePath( const std::string& filePath );
+
+protected:
+	bool						mapFile( const std::string& filePath );
+	bool						readFile( const std::string& filePath );
+
+protected:
+	char*						m_pBytes;
+	size_t						m_length;
+	bool						m_isMemoryMapped : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -53,6 +53,8 @@ void CC3Resource::setDirectory( const std::string& directory )
 
 bool CC3Resource::loadFromFile( const std::string& filePath )
 {
+	CC3_PROFILE_ZONE( "CC3Resource::loadFromFile" );
+
 	if (m_wasLoaded) 
 	{
 		CC3_TRACE("[rez]CC3Resource[%s] has already been loaded.", filePath.c_str());
@@ -72,14 +74,7 @@ bool CC3Resource::loadFromFile( const std::string& filePath )
 	CC3_TRACE("[rez]--------------------------------------------------");
 	CC3_TRACE("[rez]Loading resource from file '%s'", absFilePath.c_str());
 	
-	if ( m_sName.c_str() ) 
-		setName( resourceNameFromFilePath( absFilePath ) );
-
-	if ( m_directory.empty() ) 
-	{
-		std::string sDir = CC3String::getDirectory( absFilePath );
-		setDirectory( sDir );
-	}
+	populateFromFilePath( absFilePath );
 
 	m_wasLoaded = processFile( absFilePath );	// Main subclass loading method
 	
@@ -98,6 +93,111 @@ bool CC3Resource::processFile( const std::string& anAbsoluteFilePath )
 	return false; 
 }
 
+void CC3Resource::populateFromFilePath( const std::string& absFilePath )
+{
+	if ( m_sName.c_str() ) 
+		setName( resourceNameFromFilePath( absFilePath ) );
+
+	if ( m_directory.empty() ) 
+	{
+		std::string sDir = CC3String::getDirectory( absFilePath );
+		setDirectory( sDir );
+	}
+}
+
+/** The state of a resource being loaded by loadFromFileInBackground, passed between the backgrounder tasks. */
+typedef struct
+{
+	CC3Resource*				resource;
+	std::string					filePath;
+	CC3ResourceLoadCallback		callback;
+	void*						userData;
+	bool						wasRead;
+} CC3ResourceLoadRequest;
+
+void CC3Resource::loadFromFileInBackground( const std::string& filePath, CC3ResourceLoadCallback callback, void* userData )
+{
+	if ( m_wasLoaded || m_isLoadingInBackground || filePath.empty() ) 
+	{
+		CC3_TRACE("[rez]CC3Resource[%s] has already been loaded, or cannot be loaded.", filePath.c_str());
+		if ( callback )
+			callback( this, m_wasLoaded, userData );
+		return;
+	}
+
+	CC3_TRACE("[rez]Loading resource from file '%s' in the background", filePath.c_str());
+
+	populateFromFilePath( filePath );
+	m_isLoadingInBackground = true;
+	retain();		// released once the callback has been invoked
+
+	CC3ResourceLoadRequest* request = new CC3ResourceLoadRequest;
+	request->resource = this;
+	request->filePath = filePath;
+	request->callback = callback;
+	request->userData = userData;
+	request->wasRead = false;
+
+	CC3Backgrounder::sharedBackgrounder()->runBlockWithCompletion( readFileInBackground, completeLoadInBackground, request );
+}
+
+void CC3Resource::readFileInBackground( void* loadRequest )
+{
+	CC3_PROFILE_ZONE( "CC3Resource::readFile" );
+
+	CC3ResourceLoadRequest* request = (CC3ResourceLoadRequest*)loadRequest;
+	request->wasRead = request->resource->readFile( request->filePath );
+}
+
+void CC3Resource::completeLoadInBackground( void* loadRequest )
+{
+	CC3_PROFILE_ZONE( "CC3Resource::buildFromReadFile" );
+
+	CC3ResourceLoadRequest* request = (CC3ResourceLoadRequest*)loadRequest;
+	CC3Resource* rez = request->resource;
+
+	rez->m_wasLoaded = request->wasRead && rez->buildFromReadFile( request->filePath );
+	rez->m_isLoadingInBackground = false;
+
+	if ( !rez->m_wasLoaded )
+	{
+		CC3_TRACE("[rez]Could not load resource file '%s'", request->filePath.c_str());
+	}
+
+	if ( request->callback )
+		request->callback( rez, rez->m_wasLoaded, request->userData );
+
+	rez->release();
+	delete request;
+}
+
+bool CC3Resource::isLoadingInBackground()
+{
+	return m_isLoadingInBackground;
+}
+
+bool CC3Resource::readFile( const std::string& )
+{
+	return true;
+}
+
+bool CC3Resource::buildFromReadFile( const std::string& anAbsoluteFilePath )
+{
+	return processFile( anAbsoluteFilePath );
+}
+
+CC3Texture* CC3Resource::loadTextureFromFile( const std::string& filePath )
+{
+	if ( !m_isLoadingInBackground )
+		return CC3Texture::textureFromFile( filePath.c_str() );
+
+	CCFileUtils* fileUtils = CCFileUtils::sharedFileUtils();
+	if ( !fileUtils->isFileExist( fileUtils->fullPathForFilename( filePath.c_str() ) ) )
+		return NULL;
+
+	return CC3Texture::textureFromFileAsync( filePath.c_str() );
+}
+
 bool CC3Resource::saveToFile( const std::string& filePath )
 {
 	CCAssert(false, "CC3Resource does not support saving the resource content back to a file.");
@@ -111,6 +211,7 @@ bool CC3Resource::init()
 		m_directory = "";
 		m_isBigEndian = false;
 		m_wasLoaded = false;
+		m_isLoadingInBackground = false;
 
 		return true;
 	}
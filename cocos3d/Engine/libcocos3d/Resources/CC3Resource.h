@@ -31,6 +31,16 @@
 #define _CC3_RESOURCE_H_
 
 NS_COCOS3D_BEGIN
+
+class CC3Resource;
+class CC3Texture;
+
+/**
+ * Callback invoked on the rendering thread once a resource that was loaded with the
+ * loadFromFileInBackground method has finished loading, indicating whether the load succeeded.
+ */
+typedef void (*CC3ResourceLoadCallback) ( CC3Resource* resource, bool wasLoaded, void* userData );
+
 /**
  * CC3Resource is an abstract wrapper class around content loaded from a file containing
  * 3D resource content. Concrete subclasses will load files of specific types.
@@ -146,6 +156,52 @@ public:
 	 */
 	virtual bool				processFile( const std::string& anAbsoluteFilePath );
 
+	/**
+	 * Loads the resources from the file at the specified file path without blocking the rendering
+	 * thread, and invokes the specified callback on the rendering thread once loading is complete.
+	 *
+	 * The file is read and parsed by the readFile: method, in a task submitted to the shared
+	 * CC3Backgrounder. During the CCScheduler update that follows, the buildFromReadFile: method
+	 * is invoked on the rendering thread to create any GL content, and the callback is invoked
+	 * with this resource, whether it was successfully loaded, and the specified userData.
+	 *
+	 * Any textures requested by this resource while it is built are loaded in the background by
+	 * the CC3TextureLoader, and show placeholder content until their own content has arrived.
+	 *
+	 * This instance is retained until the callback has been invoked. It is not added to the
+	 * resource cache. Use the addResource: method from the callback to do so.
+	 *
+	 * The PVR file parsers share a single read path, so resources should only be loaded in the
+	 * background while the maxConcurrentTasks property of the CC3Backgrounder is left at one.
+	 *
+	 * This method must be invoked from the rendering thread.
+	 */
+	void						loadFromFileInBackground( const std::string& filePath, CC3ResourceLoadCallback callback, void* userData );
+
+	/** Returns whether this resource is currently being loaded by the loadFromFileInBackground: method. */
+	bool						isLoadingInBackground();
+
+	/**
+	 * Template method that reads and parses the contents of the file at the specified absolute
+	 * file path, without creating any GL content, and returns whether the file was read.
+	 *
+	 * This method is invoked on a background thread by the loadFromFileInBackground: method,
+	 * and must not retain, release or autorelease any object visible to the rendering thread.
+	 *
+	 * This implementation does nothing, and returns YES, leaving all of the work to the
+	 * buildFromReadFile: method. Subclasses that can separate parsing from building should
+	 * override both methods.
+	 */
+	virtual bool				readFile( const std::string& anAbsoluteFilePath );
+
+	/**
+	 * Template method that builds the content read by the readFile: method, and returns whether
+	 * the resource was successfully loaded. Invoked on the rendering thread.
+	 *
+	 * This implementation invokes the processFile: method to load the file synchronously.
+	 */
+	virtual bool				buildFromReadFile( const std::string& anAbsoluteFilePath );
+
 	/**
 	 * Saves the content of this resource to the file at the specified file path and returns whether
 	 * the saving was successful.
@@ -329,11 +385,28 @@ protected:
 	GLuint						nextTag();
 	void						resetTagAllocation();
 	static void					ensureCache();
+
+	/** Sets the name and directory of this resource from the specified file path, if they have not been set. */
+	void						populateFromFilePath( const std::string& absFilePath );
+
+	/**
+	 * Returns the texture loaded from the specified file, for use by this resource.
+	 *
+	 * While this resource is loading in the background, the texture content is loaded by the
+	 * CC3TextureLoader, and NULL is returned if the file does not exist. Otherwise, the texture
+	 * is loaded immediately, using the textureFromFile: method of CC3Texture.
+	 */
+	CC3Texture*					loadTextureFromFile( const std::string& filePath );
+
+	/** Backgrounder tasks used by the loadFromFileInBackground: method. */
+	static void					readFileInBackground( void* loadRequest );
+	static void					completeLoadInBackground( void* loadRequest );
 	
 protected:
 	std::string					m_directory;
 	bool						m_wasLoaded : 1;
 	bool						m_isBigEndian : 1;
+	bool						m_isLoadingInBackground : 1;
 };
 
 NS_COCOS3D_END
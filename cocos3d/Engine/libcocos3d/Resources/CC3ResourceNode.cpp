@@ -68,7 +68,13 @@ void CC3ResourceNode::populateFromResource( CC3NodesResource* resource )
 bool CC3ResourceNode::loadFromFile( const std::string& aFilepath )
 {
 	std::string aAbosultePath = CCFileUtils::sharedFileUtils()->fullPathForFilename( aFilepath.c_str() );
-	CC3NodesResource* pRez = createResourceFromFile( aAbosultePath );
+	CC3NodesResource* pRez = CC3SceneCacheResource::resourceForSourceFile( aAbosultePath, CC3NodesResource::defaultExpectsVerticallyFlippedTextures() );
+	if ( !pRez )
+	{
+		pRez = createResourceFromFile( aAbosultePath );
+		CC3SceneCacheResource::cacheResource( pRez, aAbosultePath );
+	}
+
 	if ( pRez )
 	{
 		populateFromResource( pRez );
@@ -81,7 +87,13 @@ bool CC3ResourceNode::loadFromFile( const std::string& aFilepath )
 bool CC3ResourceNode::loadFromFile( const std::string& aFilepath, bool flipped )
 {
 	std::string aAbosultePath = CCFileUtils::sharedFileUtils()->fullPathForFilename( aFilepath.c_str() );
-	CC3NodesResource* pRez = createResourceFromFile( aAbosultePath, flipped );
+	CC3NodesResource* pRez = CC3SceneCacheResource::resourceForSourceFile( aAbosultePath, flipped );
+	if ( !pRez )
+	{
+		pRez = createResourceFromFile( aAbosultePath, flipped );
+		CC3SceneCacheResource::cacheResource( pRez, aAbosultePath );
+	}
+
 	if ( pRez )
 	 {
 		 populateFromResource( pRez );
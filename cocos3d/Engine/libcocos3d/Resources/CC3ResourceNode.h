@@ -105,6 +105,10 @@ public:
 	 *
 	 * If not already set, the name of this node will be set to that of the resource, which is
 	 * usually the name of the file loaded.
+	 *
+	 * If the cacheDirectory class-side property of CC3SceneCacheResource has been set, the nodes
+	 * are loaded from the scene cache file for the specified file, if it is valid for the current
+	 * content of the file. Otherwise, the file is loaded, and the scene cache file is rewritten.
 	 */
 	virtual bool				loadFromFile( const std::string& aFilepath );
 
@@ -122,6 +126,8 @@ public:
 	 *
 	 * If not already set, the name of this node will be set to that of the resource, which is
 	 * usually the name of the file loaded.
+	 *
+	 * Scene cache files are used as described for the loadFromFile: method.
 	 */
 	virtual bool				loadFromFile( const std::string& aFilepath, bool flipped );
 
@@ -0,0 +1,1166 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+NS_COCOS3D_BEGIN
+
+/** Identifies a scene cache file. Reads as "C3SC" in the file. */
+#define kCC3SceneCacheMagic				0x43533343
+
+/** Increment whenever the layout or content of any of the records below changes. */
+#define kCC3SceneCacheVersion			2
+
+/** Written in native byte order. Files written with a different byte order are ignored. */
+#define kCC3SceneCacheByteOrderMark		0x01020304
+
+/** Header flags. */
+#define kCC3SceneCacheExpectsFlipped	0x01
+
+/** Node record flags. */
+#define kCC3SceneCacheNodeVisible		0x01
+#define kCC3SceneCacheNodeCullBack		0x02
+#define kCC3SceneCacheNodeCullFront		0x04
+
+/** Vertex attribute record flags. */
+#define kCC3SceneCacheAttrNormalize		0x01
+#define kCC3SceneCacheAttrFlipped		0x02
+
+/** Material record flags. */
+#define kCC3SceneCacheMatLighting		0x01
+#define kCC3SceneCacheMatBlendOpaque	0x02
+
+/** Texture record flags. */
+#define kCC3SceneCacheTexRelative		0x01
+#define kCC3SceneCacheTexBumpMap		0x02
+
+/** The kinds of vertex attributes that can be cached. */
+typedef enum {
+	kCC3SceneCacheAttrLocation = 0,
+	kCC3SceneCacheAttrNormal,
+	kCC3SceneCacheAttrTangent,
+	kCC3SceneCacheAttrBitangent,
+	kCC3SceneCacheAttrColor,
+	kCC3SceneCacheAttrTexCoord,
+} CC3SceneCacheAttrKind;
+
+/**
+ * The records of a scene cache file. All offsets are in bytes from the start of the file,
+ * and a zero string offset indicates an empty string. Every field is four bytes wide,
+ * except the source hash, size and modification time, which are eight bytes wide and
+ * eight-byte aligned.
+ */
+typedef struct {
+	GLuint				magic;
+	GLuint				version;
+	unsigned long long	sourceHash;
+	unsigned long long	sourceSize;
+	unsigned long long	sourceModificationTime;
+	GLuint				byteOrder;
+	GLuint				fileSize;
+	GLuint				flags;
+	GLuint				nodeCount;
+	GLuint				nodeOffset;
+	GLuint				meshCount;
+	GLuint				meshOffset;
+	GLuint				attributeCount;
+	GLuint				attributeOffset;
+	GLuint				materialCount;
+	GLuint				materialOffset;
+	GLuint				textureCount;
+	GLuint				textureOffset;
+	GLuint				reserved;
+} CC3SceneCacheHeader;
+
+/** Nodes are stored in depth-first order, so each parent precedes its descendants. */
+typedef struct {
+	GLuint				nameOffset;
+	GLint				parentIndex;
+	GLint				meshIndex;
+	GLint				materialIndex;
+	GLfloat				location[3];
+	GLfloat				quaternion[4];
+	GLfloat				scale[3];
+	GLuint				flags;
+} CC3SceneCacheNode;
+
+typedef struct {
+	GLuint				nameOffset;
+	GLuint				vertexCount;
+	GLuint				vertexStride;
+	GLuint				vertexOffset;
+	GLuint				firstVertex;
+	GLuint				firstAttribute;
+	GLuint				attributeCount;
+	GLenum				drawingMode;
+	GLenum				indexType;
+	GLuint				indexCount;
+	GLuint				indexOffset;
+} CC3SceneCacheMesh;
+
+typedef struct {
+	GLuint				nameOffset;
+	GLuint				kind;
+	GLenum				semantic;
+	GLenum				elementType;
+	GLint				elementSize;
+	GLuint				elementOffset;
+	GLfloat				mapSize[2];
+	GLuint				flags;
+} CC3SceneCacheAttribute;
+
+typedef struct {
+	GLuint				nameOffset;
+	GLfloat				ambientColor[4];
+	GLfloat				diffuseColor[4];
+	GLfloat				specularColor[4];
+	GLfloat				emissionColor[4];
+	GLfloat				shininess;
+	GLfloat				reflectivity;
+	GLenum				blendFunc[4];
+	GLenum				alphaTestFunction;
+	GLfloat				alphaTestReference;
+	GLuint				firstTexture;
+	GLuint				textureCount;
+	GLuint				flags;
+} CC3SceneCacheMaterial;
+
+typedef struct {
+	GLuint				pathOffset;
+	GLuint				flags;
+} CC3SceneCacheTexture;
+
+static inline void CC3SceneCacheCopyColor( GLfloat* dst, const ccColor4F& color )
+{
+	dst[0] = color.r;  dst[1] = color.g;  dst[2] = color.b;  dst[3] = color.a;
+}
+
+static inline ccColor4F CC3SceneCacheColor( const GLfloat* src )
+{
+	return ccc4f( src[0], src[1], src[2], src[3] );
+}
+
+/** Returns the vertex array of the mesh used for the specified kind of attribute. */
+static CC3VertexArray* CC3SceneCacheVertexArray( CC3Mesh* mesh, GLuint kind )
+{
+	switch ( kind )
+	{
+		case kCC3SceneCacheAttrLocation:	return mesh->getVertexLocations();
+		case kCC3SceneCacheAttrNormal:		return mesh->getVertexNormals();
+		case kCC3SceneCacheAttrTangent:		return mesh->getVertexTangents();
+		case kCC3SceneCacheAttrBitangent:	return mesh->getVertexBitangents();
+		case kCC3SceneCacheAttrColor:		return mesh->getVertexColors();
+		default:							return NULL;
+	}
+}
+
+/** Returns the texture referenced by the specified material texture, or NULL if it cannot be cached. */
+static CC3Texture* CC3SceneCacheTextureContent( CC3Texture* texture, bool* isBumpMap )
+{
+	*isBumpMap = false;
+	if ( !texture )
+		return NULL;
+
+	CC3TextureUnit* texUnit = texture->getTextureUnit();
+	if ( texUnit )
+	{
+		// Only the plain bump-map configuration established by resource loaders can be reconstructed
+		if ( !dynamic_cast<CC3BumpMapTextureUnit*>( texUnit ) )
+			return NULL;
+
+		*isBumpMap = true;
+		texture = ((CC3TextureUnitTexture*)texture)->getTexture();
+	}
+
+	if ( !texture || texture->isTextureCube() || texture->getName().empty() )
+		return NULL;
+
+	return texture;
+}
+
+/** Accumulates the records and data of a scene cache file, and assembles the file content. */
+class CC3SceneCacheWriter
+{
+public:
+	CC3SceneCacheWriter( const std::string& directory ) : m_directory( directory )
+	{
+		m_strings.push_back( 0 );		// Offset zero is the empty string
+	}
+
+	void addNode( CC3Node* aNode, GLint parentIndex )
+	{
+		CC3SceneCacheNode rec;
+		memset( &rec, 0, sizeof(rec) );
+		rec.nameOffset = addString( aNode->getName() );
+		rec.parentIndex = parentIndex;
+		rec.meshIndex = -1;
+		rec.materialIndex = -1;
+
+		CC3Vector loc = aNode->getLocation();
+		CC3Quaternion quat = aNode->getQuaternion();
+		CC3Vector scale = aNode->getScale();
+		rec.location[0] = loc.x;  rec.location[1] = loc.y;  rec.location[2] = loc.z;
+		rec.quaternion[0] = quat.x;  rec.quaternion[1] = quat.y;  rec.quaternion[2] = quat.z;  rec.quaternion[3] = quat.w;
+		rec.scale[0] = scale.x;  rec.scale[1] = scale.y;  rec.scale[2] = scale.z;
+
+		if ( aNode->isVisible() )
+			rec.flags |= kCC3SceneCacheNodeVisible;
+
+		if ( aNode->isMeshNode() )
+		{
+			CC3MeshNode* meshNode = (CC3MeshNode*)aNode;
+			if ( meshNode->getMesh() )
+				rec.meshIndex = addMesh( meshNode->getMesh() );
+			if ( meshNode->getMaterial() )
+				rec.materialIndex = addMaterial( meshNode->getMaterial() );
+			if ( meshNode->shouldCullBackFaces() )
+				rec.flags |= kCC3SceneCacheNodeCullBack;
+			if ( meshNode->shouldCullFrontFaces() )
+				rec.flags |= kCC3SceneCacheNodeCullFront;
+		}
+
+		GLint nodeIndex = (GLint)m_nodes.size();
+		m_nodes.push_back( rec );
+
+		CCObject* pObj = NULL;
+		CCARRAY_FOREACH( aNode->getChildren(), pObj )
+		{
+			addNode( (CC3Node*)pObj, nodeIndex );
+		}
+	}
+
+	/** Assembles the file content, converting all string and data offsets to file offsets. */
+	void assemble( std::string& content, unsigned long long sourceHash, unsigned long long sourceSize,
+				   unsigned long long sourceModTime, bool expectsFlipped )
+	{
+		GLuint nodeOffset = alignedSize( sizeof(CC3SceneCacheHeader) );
+		GLuint meshOffset = nodeOffset + (GLuint)(m_nodes.size() * sizeof(CC3SceneCacheNode));
+		GLuint attributeOffset = meshOffset + (GLuint)(m_meshes.size() * sizeof(CC3SceneCacheMesh));
+		GLuint materialOffset = attributeOffset + (GLuint)(m_attributes.size() * sizeof(CC3SceneCacheAttribute));
+		GLuint textureOffset = materialOffset + (GLuint)(m_materials.size() * sizeof(CC3SceneCacheMaterial));
+		GLuint stringOffset = textureOffset + (GLuint)(m_textures.size() * sizeof(CC3SceneCacheTexture));
+		GLuint dataOffset = alignedSize( stringOffset + (GLuint)m_strings.size() );
+
+		for ( size_t i = 0; i < m_nodes.size(); i++ )
+			m_nodes[i].nameOffset = fileStringOffset( m_nodes[i].nameOffset, stringOffset );
+
+		for ( size_t i = 0; i < m_meshes.size(); i++ )
+		{
+			m_meshes[i].nameOffset = fileStringOffset( m_meshes[i].nameOffset, stringOffset );
+			m_meshes[i].vertexOffset += dataOffset;
+			if ( m_meshes[i].indexCount )
+				m_meshes[i].indexOffset += dataOffset;
+		}
+
+		for ( size_t i = 0; i < m_attributes.size(); i++ )
+			m_attributes[i].nameOffset = fileStringOffset( m_attributes[i].nameOffset, stringOffset );
+
+		for ( size_t i = 0; i < m_materials.size(); i++ )
+			m_materials[i].nameOffset = fileStringOffset( m_materials[i].nameOffset, stringOffset );
+
+		for ( size_t i = 0; i < m_textures.size(); i++ )
+			m_textures[i].pathOffset = fileStringOffset( m_textures[i].pathOffset, stringOffset );
+
+		CC3SceneCacheHeader header;
+		memset( &header, 0, sizeof(header) );
+		header.magic = kCC3SceneCacheMagic;
+		header.version = kCC3SceneCacheVersion;
+		header.sourceHash = sourceHash;
+		header.sourceSize = sourceSize;
+		header.sourceModificationTime = sourceModTime;
+		header.byteOrder = kCC3SceneCacheByteOrderMark;
+		header.fileSize = dataOffset + (GLuint)m_data.size();
+		header.flags = expectsFlipped ? kCC3SceneCacheExpectsFlipped : 0;
+		header.nodeCount = (GLuint)m_nodes.size();
+		header.nodeOffset = nodeOffset;
+		header.meshCount = (GLuint)m_meshes.size();
+		header.meshOffset = meshOffset;
+		header.attributeCount = (GLuint)m_attributes.size();
+		header.attributeOffset = attributeOffset;
+		header.materialCount = (GLuint)m_materials.size();
+		header.materialOffset = materialOffset;
+		header.textureCount = (GLuint)m_textures.size();
+		header.textureOffset = textureOffset;
+
+		content.reserve( header.fileSize );
+		content.append( (const char*)&header, sizeof(header) );
+		content.resize( nodeOffset, 0 );
+		appendRecords( content, m_nodes );
+		appendRecords( content, m_meshes );
+		appendRecords( content, m_attributes );
+		appendRecords( content, m_materials );
+		appendRecords( content, m_textures );
+		content.append( m_strings.begin(), m_strings.end() );
+		content.resize( dataOffset, 0 );
+		content.append( m_data.begin(), m_data.end() );
+	}
+
+protected:
+	GLint addMesh( CC3Mesh* mesh )
+	{
+		std::map<CC3Mesh*, GLint>::iterator it = m_meshIndices.find( mesh );
+		if ( it != m_meshIndices.end() )
+			return it->second;
+
+		CC3VertexLocations* locations = mesh->getVertexLocations();
+		GLuint vtxCount = locations->getVertexCount();
+
+		CC3SceneCacheMesh rec;
+		memset( &rec, 0, sizeof(rec) );
+		rec.nameOffset = addString( mesh->getName() );
+		rec.vertexCount = vtxCount;
+		rec.firstVertex = locations->getFirstVertex();
+		rec.firstAttribute = (GLuint)m_attributes.size();
+
+		// Collect the vertex arrays, and pack them, in order, into a single interleaved vertex
+		std::vector<CC3VertexArray*> vtxArrays;
+		for ( GLuint kind = kCC3SceneCacheAttrLocation; kind < kCC3SceneCacheAttrTexCoord; kind++ )
+		{
+			CC3VertexArray* vtxArray = CC3SceneCacheVertexArray( mesh, kind );
+			if ( vtxArray )
+				addAttribute( vtxArray, kind, rec.vertexStride, vtxArrays );
+		}
+
+		GLuint tcCount = mesh->getTextureCoordinatesArrayCount();
+		for ( GLuint i = 0; i < tcCount; i++ )
+			addAttribute( mesh->getTextureCoordinatesForTextureUnit( i ), kCC3SceneCacheAttrTexCoord, rec.vertexStride, vtxArrays );
+
+		rec.attributeCount = (GLuint)vtxArrays.size();
+
+		GLuint stride = rec.vertexStride;
+		rec.vertexOffset = reserveData( vtxCount * stride );
+		GLubyte* pVertex = &m_data[rec.vertexOffset];
+		for ( GLuint vIdx = 0; vIdx < vtxCount; vIdx++, pVertex += stride )
+		{
+			for ( size_t aIdx = 0; aIdx < vtxArrays.size(); aIdx++ )
+			{
+				CC3VertexArray* vtxArray = vtxArrays[aIdx];
+				memcpy( pVertex + m_attributes[rec.firstAttribute + aIdx].elementOffset,
+						vtxArray->getAddressOfElement( vIdx ), vtxArray->getElementLength() );
+			}
+		}
+
+		CC3VertexIndices* indices = mesh->getVertexIndices();
+		if ( indices && indices->getVertexCount() )
+		{
+			GLuint idxCount = indices->getVertexCount();
+			GLuint idxLen = indices->getElementLength();
+			rec.drawingMode = indices->getDrawingMode();
+			rec.indexType = indices->getElementType();
+			rec.indexCount = idxCount;
+			rec.indexOffset = reserveData( idxCount * idxLen );
+			GLubyte* pIndex = &m_data[rec.indexOffset];
+			for ( GLuint i = 0; i < idxCount; i++, pIndex += idxLen )
+				memcpy( pIndex, indices->getAddressOfElement( i ), idxLen );
+		}
+		else
+		{
+			rec.drawingMode = locations->getDrawingMode();
+		}
+
+		GLint meshIndex = (GLint)m_meshes.size();
+		m_meshes.push_back( rec );
+		m_meshIndices[mesh] = meshIndex;
+		return meshIndex;
+	}
+
+	void addAttribute( CC3VertexArray* vtxArray, GLuint kind, GLuint& stride, std::vector<CC3VertexArray*>& vtxArrays )
+	{
+		CC3SceneCacheAttribute rec;
+		memset( &rec, 0, sizeof(rec) );
+		rec.nameOffset = addString( vtxArray->getName() );
+		rec.kind = kind;
+		rec.semantic = vtxArray->getSemantic();
+		rec.elementType = vtxArray->getElementType();
+		rec.elementSize = vtxArray->getElementSize();
+		rec.elementOffset = stride;
+		rec.mapSize[0] = 1.0f;
+		rec.mapSize[1] = 1.0f;
+		if ( vtxArray->shouldNormalizeContent() )
+			rec.flags |= kCC3SceneCacheAttrNormalize;
+
+		if ( kind == kCC3SceneCacheAttrTexCoord )
+		{
+			CC3VertexTextureCoordinates* texCoords = (CC3VertexTextureCoordinates*)vtxArray;
+			CCSize mapSize = texCoords->getMapSize();
+			rec.mapSize[0] = mapSize.width;
+			rec.mapSize[1] = mapSize.height;
+			if ( texCoords->expectsVerticallyFlippedTextures() )
+				rec.flags |= kCC3SceneCacheAttrFlipped;
+		}
+
+		stride += alignedSize( vtxArray->getElementLength() );
+		m_attributes.push_back( rec );
+		vtxArrays.push_back( vtxArray );
+	}
+
+	GLint addMaterial( CC3Material* material )
+	{
+		std::map<CC3Material*, GLint>::iterator it = m_materialIndices.find( material );
+		if ( it != m_materialIndices.end() )
+			return it->second;
+
+		CC3SceneCacheMaterial rec;
+		memset( &rec, 0, sizeof(rec) );
+		rec.nameOffset = addString( material->getName() );
+		CC3SceneCacheCopyColor( rec.ambientColor, material->getAmbientColor() );
+		CC3SceneCacheCopyColor( rec.diffuseColor, material->getDiffuseColor() );
+		CC3SceneCacheCopyColor( rec.specularColor, material->getSpecularColor() );
+		CC3SceneCacheCopyColor( rec.emissionColor, material->getEmissionColor() );
+		rec.shininess = material->getShininess();
+		rec.reflectivity = material->getReflectivity();
+		rec.blendFunc[0] = material->getSourceBlendRGB();
+		rec.blendFunc[1] = material->getDestinationBlendRGB();
+		rec.blendFunc[2] = material->getSourceBlendAlpha();
+		rec.blendFunc[3] = material->getDestinationBlendAlpha();
+		rec.alphaTestFunction = material->getAlphaTestFunction();
+		rec.alphaTestReference = material->getAlphaTestReference();
+		if ( material->shouldUseLighting() )
+			rec.flags |= kCC3SceneCacheMatLighting;
+		if ( material->shouldBlendAtFullOpacity() )
+			rec.flags |= kCC3SceneCacheMatBlendOpaque;
+
+		rec.firstTexture = (GLuint)m_textures.size();
+		rec.textureCount = material->getTextureCount();
+		for ( GLuint i = 0; i < rec.textureCount; i++ )
+		{
+			bool isBumpMap;
+			CC3Texture* texture = CC3SceneCacheTextureContent( material->getTextureForTextureUnit( i ), &isBumpMap );
+
+			// Store paths within the resource directory relative to it, so the cache survives relocation
+			std::string texPath = texture->getName();
+			CC3SceneCacheTexture texRec;
+			texRec.flags = isBumpMap ? kCC3SceneCacheTexBumpMap : 0;
+			if ( !m_directory.empty() && texPath.compare( 0, m_directory.size(), m_directory ) == 0 )
+			{
+				texPath = texPath.substr( m_directory.size() );
+				texRec.flags |= kCC3SceneCacheTexRelative;
+			}
+			texRec.pathOffset = addString( texPath );
+			m_textures.push_back( texRec );
+		}
+
+		GLint matIndex = (GLint)m_materials.size();
+		m_materials.push_back( rec );
+		m_materialIndices[material] = matIndex;
+		return matIndex;
+	}
+
+	GLuint addString( const std::string& aString )
+	{
+		if ( aString.empty() )
+			return 0;
+
+		GLuint offset = (GLuint)m_strings.size();
+		m_strings.insert( m_strings.end(), aString.begin(), aString.end() );
+		m_strings.push_back( 0 );
+		return offset;
+	}
+
+	/** Reserves a block of data, aligned to four bytes, and returns its offset within the data. */
+	GLuint reserveData( GLuint length )
+	{
+		GLuint offset = (GLuint)m_data.size();
+		m_data.resize( offset + alignedSize( length ), 0 );
+		return offset;
+	}
+
+	template<typename T>
+	static void appendRecords( std::string& content, const std::vector<T>& records )
+	{
+		if ( !records.empty() )
+			content.append( (const char*)&records[0], records.size() * sizeof(T) );
+	}
+
+	static GLuint fileStringOffset( GLuint offset, GLuint stringOffset )
+	{
+		return offset ? (offset + stringOffset) : 0;
+	}
+
+	static GLuint alignedSize( GLuint size )
+	{
+		return (size + 3) & ~3;
+	}
+
+protected:
+	std::string								m_directory;
+	std::vector<CC3SceneCacheNode>			m_nodes;
+	std::vector<CC3SceneCacheMesh>			m_meshes;
+	std::vector<CC3SceneCacheAttribute>		m_attributes;
+	std::vector<CC3SceneCacheMaterial>		m_materials;
+	std::vector<CC3SceneCacheTexture>		m_textures;
+	std::vector<char>						m_strings;
+	std::vector<GLubyte>					m_data;
+	std::map<CC3Mesh*, GLint>				m_meshIndices;
+	std::map<CC3Material*, GLint>			m_materialIndices;
+};
+
+/** Validates the offsets of a scene cache file, and resolves them to pointers into its content. */
+class CC3SceneCacheReader
+{
+public:
+	CC3SceneCacheReader( const char* bytes, size_t length ) : m_bytes( bytes ), m_length( length ) {}
+
+	/** Returns a pointer to the table of count records at the offset, or NULL if it does not lie within the file. */
+	template<typename T>
+	const T* table( GLuint offset, GLuint count )
+	{
+		if ( count == 0 )
+			return NULL;
+		if ( (offset & 3) || !containsRange( offset, (unsigned long long)count * sizeof(T) ) )
+			return NULL;
+		return (const T*)(m_bytes + offset);
+	}
+
+	/** Returns whether the block of data lies within the file, and is aligned to four bytes. */
+	bool containsData( GLuint offset, unsigned long long length )
+	{
+		return !(offset & 3) && containsRange( offset, length );
+	}
+
+	/** Returns the string at the offset, or NULL if it is not terminated within the file. */
+	const char* string( GLuint offset )
+	{
+		if ( offset == 0 )
+			return "";
+		if ( offset >= m_length || !memchr( m_bytes + offset, 0, m_length - offset ) )
+			return NULL;
+		return m_bytes + offset;
+	}
+
+	const char* bytes( GLuint offset )
+	{
+		return m_bytes + offset;
+	}
+
+protected:
+	bool containsRange( GLuint offset, unsigned long long length )
+	{
+		return (unsigned long long)offset + length <= (unsigned long long)m_length;
+	}
+
+protected:
+	const char*		m_bytes;
+	size_t			m_length;
+};
+
+CC3SceneCacheResource::CC3SceneCacheResource()
+{
+	m_sourceHash = 0;
+	m_sourceSize = 0;
+	m_sourceModificationTime = 0;
+}
+
+CC3SceneCacheResource::~CC3SceneCacheResource()
+{
+
+}
+
+unsigned long long CC3SceneCacheResource::getSourceHash()
+{
+	return m_sourceHash;
+}
+
+void CC3SceneCacheResource::setSourceHash( unsigned long long sourceHash )
+{
+	m_sourceHash = sourceHash;
+}
+
+unsigned long long CC3SceneCacheResource::getSourceSize()
+{
+	return m_sourceSize;
+}
+
+void CC3SceneCacheResource::setSourceSize( unsigned long long sourceSize )
+{
+	m_sourceSize = sourceSize;
+}
+
+unsigned long long CC3SceneCacheResource::getSourceModificationTime()
+{
+	return m_sourceModificationTime;
+}
+
+void CC3SceneCacheResource::setSourceModificationTime( unsigned long long modTime )
+{
+	m_sourceModificationTime = modTime;
+}
+
+static bool canCacheMesh( CC3Mesh* mesh )
+{
+	CC3VertexLocations* locations = mesh->getVertexLocations();
+	if ( !locations || !locations->getVertices() || locations->getVertexCount() == 0 )
+		return false;
+
+	if ( mesh->hasVertexBoneWeights() || mesh->hasVertexBoneIndices() || mesh->hasVertexPointSizes() )
+		return false;
+
+	if ( locations->getStripCount() > 0 )
+		return false;
+
+	if ( mesh->isVertexContentQuantized() )
+		return false;
+
+	GLuint vtxCount = locations->getVertexCount();
+	for ( GLuint kind = kCC3SceneCacheAttrLocation; kind < kCC3SceneCacheAttrTexCoord; kind++ )
+	{
+		CC3VertexArray* vtxArray = CC3SceneCacheVertexArray( mesh, kind );
+		if ( vtxArray && (!vtxArray->getVertices() || vtxArray->getVertexCount() < vtxCount) )
+			return false;
+	}
+
+	GLuint tcCount = mesh->getTextureCoordinatesArrayCount();
+	for ( GLuint i = 0; i < tcCount; i++ )
+	{
+		CC3VertexTextureCoordinates* texCoords = mesh->getTextureCoordinatesForTextureUnit( i );
+		if ( !texCoords->getVertices() || texCoords->getVertexCount() < vtxCount )
+			return false;
+
+		// A texture rectangle cannot be restored without realigning the texture coordinates
+		if ( !texCoords->getTextureRectangle().equals( kCC3UnitTextureRectangle ) )
+			return false;
+	}
+
+	CC3VertexIndices* indices = mesh->getVertexIndices();
+	if ( indices && (!indices->getVertices() || indices->getStripCount() > 0) )
+		return false;
+
+	return true;
+}
+
+static bool canCacheMaterial( CC3Material* material )
+{
+	GLuint texCount = material->getTextureCount();
+	for ( GLuint i = 0; i < texCount; i++ )
+	{
+		bool isBumpMap;
+		if ( !CC3SceneCacheTextureContent( material->getTextureForTextureUnit( i ), &isBumpMap ) )
+			return false;
+	}
+
+	return true;
+}
+
+bool CC3SceneCacheResource::canCacheNode( CC3Node* aNode )
+{
+	if ( !aNode )
+		return false;
+
+	if ( aNode->isCamera() || aNode->isLight() || aNode->isLightProbe() || aNode->isBillboard() || aNode->isShadowVolume() )
+		return false;
+
+	if ( dynamic_cast<CC3Bone*>( aNode ) || dynamic_cast<CC3SoftBodyNode*>( aNode ) || aNode->containsAnimation() )
+		return false;
+
+	if ( aNode->isMeshNode() )
+	{
+		CC3MeshNode* meshNode = (CC3MeshNode*)aNode;
+		if ( dynamic_cast<CC3SkinMeshNode*>( meshNode ) || dynamic_cast<CC3ParticleEmitter*>( meshNode ) )
+			return false;
+
+		// Shader programs assigned explicitly, such as those from PFX effects, are not cached
+		if ( meshNode->getShaderContext()->getProgram() )
+			return false;
+
+		if ( meshNode->getMesh() && !canCacheMesh( meshNode->getMesh() ) )
+			return false;
+
+		if ( meshNode->getMaterial() && !canCacheMaterial( meshNode->getMaterial() ) )
+			return false;
+	}
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( aNode->getChildren(), pObj )
+	{
+		if ( !canCacheNode( (CC3Node*)pObj ) )
+			return false;
+	}
+
+	return true;
+}
+
+bool CC3SceneCacheResource::saveToFile( const std::string& filePath )
+{
+	CC3_PROFILE_ZONE( "CC3SceneCacheResource::saveToFile" );
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( m_nodes, pObj )
+	{
+		CC3Node* aNode = (CC3Node*)pObj;
+		if ( !canCacheNode( aNode ) )
+		{
+			CC3_TRACE("[rez]CC3SceneCacheResource cannot save %s to a scene cache file, because it contains content that cannot be cached", aNode->getName().c_str());
+			return false;
+		}
+	}
+
+	CC3SceneCacheWriter writer( getDirectory() );
+	CCARRAY_FOREACH( m_nodes, pObj )
+	{
+		writer.addNode( (CC3Node*)pObj, -1 );
+	}
+
+	std::string content;
+	writer.assemble( content, m_sourceHash, m_sourceSize, m_sourceModificationTime, expectsVerticallyFlippedTextures() );
+
+	FILE* file = fopen( filePath.c_str(), "wb" );
+	if ( !file )
+	{
+		CCLOGERROR( "CC3SceneCacheResource could not open file %s for writing", filePath.c_str() );
+		return false;
+	}
+
+	bool wasWritten = (fwrite( content.data(), 1, content.size(), file ) == content.size());
+	wasWritten = (fclose( file ) == 0) && wasWritten;
+
+	// Don't leave a partially written file behind
+	if ( !wasWritten )
+	{
+		CCLOGERROR( "CC3SceneCacheResource could not write file %s", filePath.c_str() );
+		::remove( filePath.c_str() );
+		return false;
+	}
+
+	CC3_TRACE("[rez]CC3SceneCacheResource saved %u bytes to scene cache file '%s'", (GLuint)content.size(), filePath.c_str());
+	return true;
+}
+
+/** Constructs a mesh, with interleaved vertex content copied from the file in a single block. */
+static CC3Mesh* buildMesh( const CC3SceneCacheMesh& rec, const CC3SceneCacheAttribute* attrs, CC3SceneCacheReader& reader )
+{
+	CC3Mesh* mesh = CC3Mesh::meshWithName( reader.string( rec.nameOffset ) );
+	mesh->setShouldInterleaveVertices( true );
+
+	// Locations own the vertex content, and are always the first attribute
+	CC3VertexLocations* locations = CC3VertexLocations::vertexArrayWithName( reader.string( attrs[0].nameOffset ) );
+	locations->setElementType( attrs[0].elementType );
+	locations->setElementSize( attrs[0].elementSize );
+	locations->setShouldNormalizeContent( (attrs[0].flags & kCC3SceneCacheAttrNormalize) != 0 );
+	locations->setVertexStride( rec.vertexStride );
+	locations->setSemantic( attrs[0].semantic );
+	locations->setAllocatedVertexCapacity( rec.vertexCount );
+	if ( !locations->getVertices() )
+		return NULL;
+
+	memcpy( locations->getVertices(), reader.bytes( rec.vertexOffset ), rec.vertexCount * rec.vertexStride );
+	locations->setFirstVertex( rec.firstVertex );
+	mesh->setVertexLocations( locations );
+
+	for ( GLuint i = 1; i < rec.attributeCount; i++ )
+	{
+		const CC3SceneCacheAttribute& attr = attrs[i];
+		std::string attrName = reader.string( attr.nameOffset );
+		CC3VertexArray* vtxArray = NULL;
+		switch ( attr.kind )
+		{
+			case kCC3SceneCacheAttrNormal:
+			{
+				CC3VertexNormals* normals = CC3VertexNormals::vertexArrayWithName( attrName );
+				mesh->setVertexNormals( normals );
+				vtxArray = normals;
+				break;
+			}
+			case kCC3SceneCacheAttrTangent:
+			{
+				CC3VertexTangents* tangents = CC3VertexTangents::vertexArray();
+				tangents->setName( attrName );
+				mesh->setVertexTangents( tangents );
+				vtxArray = tangents;
+				break;
+			}
+			case kCC3SceneCacheAttrBitangent:
+			{
+				CC3VertexTangents* bitangents = CC3VertexTangents::vertexArray();
+				bitangents->setName( attrName );
+				mesh->setVertexBitangents( bitangents );
+				vtxArray = bitangents;
+				break;
+			}
+			case kCC3SceneCacheAttrColor:
+			{
+				CC3VertexColors* colors = CC3VertexColors::vertexArrayWithName( attrName );
+				mesh->setVertexColors( colors );
+				vtxArray = colors;
+				break;
+			}
+			case kCC3SceneCacheAttrTexCoord:
+			{
+				CC3VertexTextureCoordinates* texCoords = CC3VertexTextureCoordinates::vertexArrayWithName( attrName );
+				texCoords->setMapSize( CCSizeMake( attr.mapSize[0], attr.mapSize[1] ) );
+				texCoords->setExpectsVerticallyFlippedTextures( (attr.flags & kCC3SceneCacheAttrFlipped) != 0 );
+				mesh->addTextureCoordinates( texCoords );
+				vtxArray = texCoords;
+				break;
+			}
+			default:
+				return NULL;
+		}
+
+		// Type and size must be set before interleaving, because they reset unallocated vertices
+		vtxArray->setElementType( attr.elementType );
+		vtxArray->setElementSize( attr.elementSize );
+		vtxArray->setShouldNormalizeContent( (attr.flags & kCC3SceneCacheAttrNormalize) != 0 );
+		vtxArray->setSemantic( attr.semantic );
+		vtxArray->interleaveWith( locations, attr.elementOffset );
+	}
+
+	if ( rec.indexCount )
+	{
+		CC3VertexIndices* indices = CC3VertexIndices::vertexArray();
+		indices->setElementType( rec.indexType );
+		indices->setElementSize( 1 );
+		indices->setAllocatedVertexCapacity( rec.indexCount );
+		if ( !indices->getVertices() )
+			return NULL;
+
+		memcpy( indices->getVertices(), reader.bytes( rec.indexOffset ), rec.indexCount * indices->getElementLength() );
+		indices->setDrawingMode( rec.drawingMode );
+		mesh->setVertexIndices( indices );
+	}
+	else
+	{
+		locations->setDrawingMode( rec.drawingMode );
+	}
+
+	return mesh;
+}
+
+/** Constructs a material, loading its textures through the texture cache. */
+static CC3Material* buildMaterial( const CC3SceneCacheMaterial& rec, const CC3SceneCacheTexture* texRecs,
+								   const std::string& directory, CC3SceneCacheReader& reader )
+{
+	CC3Material* material = CC3Material::materialWithName( reader.string( rec.nameOffset ) );
+	material->setAmbientColor( CC3SceneCacheColor( rec.ambientColor ) );
+	material->setDiffuseColor( CC3SceneCacheColor( rec.diffuseColor ) );
+	material->setSpecularColor( CC3SceneCacheColor( rec.specularColor ) );
+	material->setEmissionColor( CC3SceneCacheColor( rec.emissionColor ) );
+	material->setShininess( rec.shininess );
+	material->setReflectivity( rec.reflectivity );
+	material->setShouldUseLighting( (rec.flags & kCC3SceneCacheMatLighting) != 0 );
+	material->setAlphaTestFunction( rec.alphaTestFunction );
+	material->setAlphaTestReference( rec.alphaTestReference );
+
+	// Set blending last, because setting the full-opacity behaviour can change it
+	material->setShouldBlendAtFullOpacity( (rec.flags & kCC3SceneCacheMatBlendOpaque) != 0 );
+	ccBlendFunc blendRGB = { rec.blendFunc[0], rec.blendFunc[1] };
+	ccBlendFunc blendAlpha = { rec.blendFunc[2], rec.blendFunc[3] };
+	material->setBlendFuncRGB( blendRGB );
+	material->setBlendFuncAlpha( blendAlpha );
+
+	for ( GLuint i = 0; i < rec.textureCount; i++ )
+	{
+		const CC3SceneCacheTexture& texRec = texRecs[i];
+		std::string texPath = reader.string( texRec.pathOffset );
+		if ( texRec.flags & kCC3SceneCacheTexRelative )
+			texPath = directory + texPath;
+
+		CC3Texture* texture = CC3Texture::textureFromFile( texPath.c_str() );
+		if ( !texture )
+			continue;
+
+		if ( texRec.flags & kCC3SceneCacheTexBumpMap )
+		{
+			CC3TextureUnitTexture* bmTex = CC3TextureUnitTexture::textureWithTexture( texture );
+			bmTex->setTextureUnit( CC3BumpMapTextureUnit::textureUnit() );
+			texture = bmTex;
+		}
+		material->addTexture( texture );
+	}
+
+	return material;
+}
+
+bool CC3SceneCacheResource::processFile( const std::string& anAbsoluteFilePath )
+{
+	CC3MappedFile* file = CC3MappedFile::fileWithFilePath( anAbsoluteFilePath );
+	if ( !file )
+		return false;
+
+	CC3SceneCacheReader reader( file->getBytes(), file->getLength() );
+	const CC3SceneCacheHeader* header = reader.table<CC3SceneCacheHeader>( 0, 1 );
+	if ( !header || header->magic != kCC3SceneCacheMagic || header->version != kCC3SceneCacheVersion ||
+		 header->byteOrder != kCC3SceneCacheByteOrderMark || header->fileSize != file->getLength() )
+	{
+		CC3_TRACE("[rez]CC3SceneCacheResource '%s' is not a valid scene cache file for this version", anAbsoluteFilePath.c_str());
+		return false;
+	}
+
+	// A source modification time or hash set before loading identifies the source content the file must match
+	bool isSourceMatched = true;
+	if ( m_sourceModificationTime )
+		isSourceMatched = (header->sourceModificationTime == m_sourceModificationTime && header->sourceSize == m_sourceSize);
+	else if ( m_sourceHash )
+		isSourceMatched = (header->sourceHash == m_sourceHash);
+	if ( !isSourceMatched )
+	{
+		CC3_TRACE("[rez]CC3SceneCacheResource '%s' was created from different source content", anAbsoluteFilePath.c_str());
+		return false;
+	}
+
+	if ( ((header->flags & kCC3SceneCacheExpectsFlipped) != 0) != expectsVerticallyFlippedTextures() )
+		return false;
+
+	m_sourceHash = header->sourceHash;
+	m_sourceSize = header->sourceSize;
+	m_sourceModificationTime = header->sourceModificationTime;
+
+	const CC3SceneCacheNode* nodeRecs = reader.table<CC3SceneCacheNode>( header->nodeOffset, header->nodeCount );
+	const CC3SceneCacheMesh* meshRecs = reader.table<CC3SceneCacheMesh>( header->meshOffset, header->meshCount );
+	const CC3SceneCacheAttribute* attrRecs = reader.table<CC3SceneCacheAttribute>( header->attributeOffset, header->attributeCount );
+	const CC3SceneCacheMaterial* matRecs = reader.table<CC3SceneCacheMaterial>( header->materialOffset, header->materialCount );
+	const CC3SceneCacheTexture* texRecs = reader.table<CC3SceneCacheTexture>( header->textureOffset, header->textureCount );
+	if ( (header->nodeCount && !nodeRecs) || (header->meshCount && !meshRecs) || (header->attributeCount && !attrRecs) ||
+		 (header->materialCount && !matRecs) || (header->textureCount && !texRecs) )
+		return false;
+
+	// Validate every record before constructing anything
+	for ( GLuint i = 0; i < header->meshCount; i++ )
+	{
+		const CC3SceneCacheMesh& rec = meshRecs[i];
+		if ( !reader.string( rec.nameOffset ) || rec.attributeCount == 0 ||
+			 rec.firstAttribute > header->attributeCount || rec.attributeCount > header->attributeCount - rec.firstAttribute ||
+			 attrRecs[rec.firstAttribute].kind != kCC3SceneCacheAttrLocation ||
+			 !reader.containsData( rec.vertexOffset, (unsigned long long)rec.vertexCount * rec.vertexStride ) ||
+			 (rec.indexCount && !reader.containsData( rec.indexOffset, (unsigned long long)rec.indexCount * CC3GLElementTypeSize( rec.indexType ) )) )
+			return false;
+
+		for ( GLuint a = 0; a < rec.attributeCount; a++ )
+		{
+			const CC3SceneCacheAttribute& attr = attrRecs[rec.firstAttribute + a];
+			unsigned long long attrEnd = (unsigned long long)attr.elementOffset + CC3GLElementTypeSize( attr.elementType ) * (GLuint)attr.elementSize;
+			if ( !reader.string( attr.nameOffset ) || attr.elementSize <= 0 || attrEnd > rec.vertexStride )
+				return false;
+		}
+	}
+
+	for ( GLuint i = 0; i < header->materialCount; i++ )
+	{
+		const CC3SceneCacheMaterial& rec = matRecs[i];
+		if ( !reader.string( rec.nameOffset ) || rec.firstTexture > header->textureCount ||
+			 rec.textureCount > header->textureCount - rec.firstTexture )
+			return false;
+
+		for ( GLuint t = 0; t < rec.textureCount; t++ )
+		{
+			if ( !reader.string( texRecs[rec.firstTexture + t].pathOffset ) )
+				return false;
+		}
+	}
+
+	for ( GLuint i = 0; i < header->nodeCount; i++ )
+	{
+		const CC3SceneCacheNode& rec = nodeRecs[i];
+		if ( !reader.string( rec.nameOffset ) || rec.parentIndex >= (GLint)i ||
+			 rec.meshIndex >= (GLint)header->meshCount || rec.materialIndex >= (GLint)header->materialCount )
+			return false;
+	}
+
+	// Meshes and materials may be shared by several nodes
+	std::vector<CC3Mesh*> meshes( header->meshCount, (CC3Mesh*)NULL );
+	for ( GLuint i = 0; i < header->meshCount; i++ )
+	{
+		meshes[i] = buildMesh( meshRecs[i], &attrRecs[meshRecs[i].firstAttribute], reader );
+		if ( !meshes[i] )
+			return false;
+	}
+
+	std::vector<CC3Material*> materials( header->materialCount, (CC3Material*)NULL );
+	for ( GLuint i = 0; i < header->materialCount; i++ )
+		materials[i] = buildMaterial( matRecs[i], texRecs ? &texRecs[matRecs[i].firstTexture] : NULL, getDirectory(), reader );
+
+	std::vector<CC3Node*> nodes( header->nodeCount, (CC3Node*)NULL );
+	for ( GLuint i = 0; i < header->nodeCount; i++ )
+	{
+		const CC3SceneCacheNode& rec = nodeRecs[i];
+		std::string nodeName = reader.string( rec.nameOffset );
+		CC3Node* aNode;
+		if ( rec.meshIndex >= 0 || rec.materialIndex >= 0 )
+		{
+			CC3MeshNode* meshNode = CC3MeshNode::nodeWithName( nodeName );
+			if ( rec.meshIndex >= 0 )
+				meshNode->setMesh( meshes[rec.meshIndex] );
+			if ( rec.materialIndex >= 0 )
+				meshNode->setMaterial( materials[rec.materialIndex] );
+			meshNode->setShouldCullBackFaces( (rec.flags & kCC3SceneCacheNodeCullBack) != 0 );
+			meshNode->setShouldCullFrontFaces( (rec.flags & kCC3SceneCacheNodeCullFront) != 0 );
+			aNode = meshNode;
+		}
+		else
+		{
+			aNode = CC3Node::nodeWithName( nodeName );
+		}
+
+		aNode->setLocation( cc3v( rec.location[0], rec.location[1], rec.location[2] ) );
+		aNode->setQuaternion( CC3Quaternion( rec.quaternion[0], rec.quaternion[1], rec.quaternion[2], rec.quaternion[3] ) );
+		aNode->setScale( cc3v( rec.scale[0], rec.scale[1], rec.scale[2] ) );
+		aNode->setVisible( (rec.flags & kCC3SceneCacheNodeVisible) != 0 );
+
+		if ( rec.parentIndex >= 0 )
+			nodes[rec.parentIndex]->addChild( aNode );
+		else
+			addNode( aNode );
+
+		nodes[i] = aNode;
+	}
+
+	CC3_TRACE("[rez]CC3SceneCacheResource loaded %u nodes and %u meshes from scene cache file '%s'",
+			  header->nodeCount, header->meshCount, anAbsoluteFilePath.c_str());
+	return true;
+}
+
+/** 64-bit FNV-1a. */
+static unsigned long long CC3SceneCacheHashBytes( const char* bytes, size_t length )
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for ( size_t i = 0; i < length; i++ )
+	{
+		hash ^= (unsigned char)bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+unsigned long long CC3SceneCacheResource::hashOfFile( const std::string& filePath )
+{
+	CC3MappedFile* file = CC3MappedFile::fileWithFilePath( filePath );
+	if ( !file )
+		return 0;
+
+	return CC3SceneCacheHashBytes( file->getBytes(), file->getLength() );
+}
+
+bool CC3SceneCacheResource::getFileSizeAndModificationTime( const std::string& filePath, unsigned long long& size,
+															 unsigned long long& modTime )
+{
+	struct stat fileStat;
+	if ( stat( filePath.c_str(), &fileStat ) != 0 || fileStat.st_mtime <= 0 )
+		return false;
+
+	size = (unsigned long long)fileStat.st_size;
+	modTime = (unsigned long long)fileStat.st_mtime;
+	return true;
+}
+
+/**
+ * Identifies the current content of the source file in the specified resource, using its size
+ * and modification time when available, and otherwise a hash of its content. Returns whether
+ * the source content could be identified.
+ */
+static bool identifySourceFile( CC3SceneCacheResource* rez, const std::string& sourceFilePath )
+{
+	unsigned long long size, modTime;
+	if ( CC3SceneCacheResource::getFileSizeAndModificationTime( sourceFilePath, size, modTime ) )
+	{
+		rez->setSourceSize( size );
+		rez->setSourceModificationTime( modTime );
+		return true;
+	}
+
+	rez->setSourceHash( CC3SceneCacheResource::hashOfFile( sourceFilePath ) );
+	return rez->getSourceHash() != 0;
+}
+
+static std::string _cacheDirectory = "";
+
+std::string CC3SceneCacheResource::getCacheDirectory()
+{
+	return _cacheDirectory;
+}
+
+void CC3SceneCacheResource::setCacheDirectory( const std::string& directory )
+{
+	_cacheDirectory = directory;
+	if ( !_cacheDirectory.empty() && _cacheDirectory[_cacheDirectory.size() - 1] != '/' )
+		_cacheDirectory += '/';
+}
+
+std::string CC3SceneCacheResource::cacheFilePathForSourceFile( const std::string& sourceFilePath, bool flipped )
+{
+	if ( _cacheDirectory.empty() )
+		return "";
+
+	// Qualify the file name with a hash of the full path, so that like-named source files don't collide
+	GLuint pathHash = (GLuint)CC3SceneCacheHashBytes( sourceFilePath.data(), sourceFilePath.size() );
+	return _cacheDirectory + CC3String::stringWithFormat( (char*)"%s.%08x%s.cc3cache",
+		CC3String::getFileName( sourceFilePath ).c_str(), pathHash, flipped ? ".flipped" : "" );
+}
+
+CC3SceneCacheResource* CC3SceneCacheResource::resourceForSourceFile( const std::string& sourceFilePath, bool flipped )
+{
+	std::string cachePath = cacheFilePathForSourceFile( sourceFilePath, flipped );
+	if ( cachePath.empty() || !CCFileUtils::sharedFileUtils()->isFileExist( cachePath ) )
+		return NULL;
+
+	CC3SceneCacheResource* rez = resource();
+	if ( !identifySourceFile( rez, sourceFilePath ) )
+		return NULL;
+
+	rez->setExpectsVerticallyFlippedTextures( flipped );
+	rez->setDirectory( CC3String::getDirectory( sourceFilePath ) );
+	if ( !rez->loadFromFile( cachePath ) )
+		return NULL;
+
+	// Present the same name as a resource loaded from the source file
+	rez->setName( resourceNameFromFilePath( sourceFilePath ) );
+	return rez;
+}
+
+bool CC3SceneCacheResource::cacheResource( CC3NodesResource* aResource, const std::string& sourceFilePath )
+{
+	if ( !aResource )
+		return false;
+
+	std::string cachePath = cacheFilePathForSourceFile( sourceFilePath, aResource->expectsVerticallyFlippedTextures() );
+	if ( cachePath.empty() )
+		return false;
+
+	CC3SceneCacheResource* rez = resource();
+	rez->setExpectsVerticallyFlippedTextures( aResource->expectsVerticallyFlippedTextures() );
+	rez->setDirectory( CC3String::getDirectory( sourceFilePath ) );
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( aResource->getNodes(), pObj )
+	{
+		CC3Node* aNode = (CC3Node*)pObj;
+		if ( !canCacheNode( aNode ) )
+			return false;
+
+		rez->addNode( aNode );
+	}
+
+	return identifySourceFile( rez, sourceFilePath ) && rez->saveToFile( cachePath );
+}
+
+CC3SceneCacheResource* CC3SceneCacheResource::resource()
+{
+	CC3SceneCacheResource* pRez = new CC3SceneCacheResource;
+	pRez->init();
+	pRez->autorelease();
+	return pRez;
+}
+
+NS_COCOS3D_END
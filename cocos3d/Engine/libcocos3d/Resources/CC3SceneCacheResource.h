@@ -0,0 +1,166 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_SCENE_CACHE_RESOURCE_H_
+#define _CC3_SCENE_CACHE_RESOURCE_H_
+
+NS_COCOS3D_BEGIN
+
+/**
+ * CC3SceneCacheResource is a CC3NodesResource that saves a snapshot of the fully built node
+ * assembly of another resource to a compact binary scene cache file, and loads it back again,
+ * bypassing the parsing and building of the original source file.
+ *
+ * The scene cache file is versioned and relocatable. It contains a flat table of nodes, a table
+ * of meshes, whose vertex content is stored as a single pre-interleaved block per mesh, a table
+ * of materials and a table of texture file references. All references within the file are byte
+ * offsets from the start of the file. Loading reads or maps the file in a single operation,
+ * validates the offsets, and then constructs the nodes directly from the records in place.
+ *
+ * Each scene cache file records the size and modification time of the source file from which it
+ * was created, or, where the file system does not provide those, such as for files packaged within
+ * an Android APK, a hash of the content of the source file. The resourceForSourceFile: method
+ * compares these against the current source file, so that the source file is only read in full when
+ * its size and modification time are unavailable. It ignores any scene cache file that is stale,
+ * was written by a different version of this
+ * class, or is otherwise invalid. The resourceNodeFromFile: methods of CC3ResourceNode use this
+ * class automatically once the cacheDirectory class-side property has been set, falling back to
+ * loading the source file, and rewriting the scene cache file, whenever it cannot be used.
+ *
+ * Only static content can be saved to a scene cache file. The saveToFile: method declines to
+ * save, and returns NO, if the nodes contain cameras, lights, bones, skinned or particle mesh
+ * nodes, animation, custom shader programs (including those established by PFX effects), mesh
+ * strips, vertex content other than locations, normals, tangents, bitangents, colors and texture
+ * coordinates, or vertex content that has already been released from memory. Subclass-specific
+ * state of the source nodes is not saved, and nodes are reconstructed as instances of CC3Node
+ * and CC3MeshNode.
+ */
+class CC3SceneCacheResource : public CC3NodesResource
+{
+	DECLARE_SUPER( CC3NodesResource );
+public:
+	CC3SceneCacheResource();
+	~CC3SceneCacheResource();
+
+	/**
+	 * The hash of the content of the source file from which the nodes of this resource were
+	 * originally loaded.
+	 *
+	 * This value is written to the scene cache file by the saveToFile: method, and is set from
+	 * the scene cache file when it is loaded.
+	 */
+	unsigned long long			getSourceHash();
+	void						setSourceHash( unsigned long long sourceHash );
+
+	/**
+	 * The size, in bytes, and the modification time, in seconds since the epoch, of the source file
+	 * from which the nodes of this resource were originally loaded, or zero if they are not known.
+	 *
+	 * These values are written to the scene cache file by the saveToFile: method, and are set from
+	 * the scene cache file when it is loaded. If the modification time is set before the scene cache
+	 * file is loaded, the file is only loaded if it records the same size and modification time,
+	 * and the sourceHash property is then ignored.
+	 */
+	unsigned long long			getSourceSize();
+	void						setSourceSize( unsigned long long sourceSize );
+	unsigned long long			getSourceModificationTime();
+	void						setSourceModificationTime( unsigned long long modTime );
+
+	/**
+	 * Saves the nodes of this resource to a scene cache file at the specified file path,
+	 * and returns whether the file was written.
+	 *
+	 * Returns NO, without writing the file, if the nodes contain content that cannot be cached.
+	 * See the notes for this class for the content that is supported.
+	 */
+	virtual bool				saveToFile( const std::string& filePath );
+
+	/** Returns whether the specified node, and all of its descendants, can be saved to a scene cache file. */
+	static bool					canCacheNode( CC3Node* aNode );
+
+	/**
+	 * Returns a hash of the content of the file at the specified absolute file path,
+	 * or zero if the file could not be read.
+	 */
+	static unsigned long long	hashOfFile( const std::string& filePath );
+
+	/**
+	 * Retrieves the size and modification time of the file at the specified absolute file path from
+	 * the file system, without reading the file, and returns whether they are available.
+	 */
+	static bool					getFileSizeAndModificationTime( const std::string& filePath, unsigned long long& size,
+															   unsigned long long& modTime );
+
+	/**
+	 * The directory in which scene cache files are read and written. This must be a writable
+	 * directory, such as the one returned by the getWritablePath method of CCFileUtils.
+	 *
+	 * The initial value of this property is empty, indicating that scene cache files are not used.
+	 */
+	static std::string			getCacheDirectory();
+	static void					setCacheDirectory( const std::string& directory );
+
+	/**
+	 * Returns the path of the scene cache file for the source file at the specified path,
+	 * or an empty string if the cacheDirectory property has not been set.
+	 *
+	 * Separate scene cache files are used for each value of the flipped argument.
+	 */
+	static std::string			cacheFilePathForSourceFile( const std::string& sourceFilePath, bool flipped );
+
+	/**
+	 * Loads and returns an autoreleased instance from the scene cache file for the source file at
+	 * the specified absolute file path, or returns NULL if the cacheDirectory property has not been
+	 * set, or if the scene cache file does not exist, or is not valid for the current content of
+	 * the source file.
+	 *
+	 * The returned instance is not added to the resource cache, so each invocation constructs new nodes.
+	 */
+	static CC3SceneCacheResource* resourceForSourceFile( const std::string& sourceFilePath, bool flipped );
+
+	/**
+	 * Saves the nodes of the specified resource, which was loaded from the source file at the
+	 * specified absolute file path, to the scene cache file for that source file, and returns
+	 * whether the scene cache file was written.
+	 *
+	 * This method does nothing, and returns NO, if the cacheDirectory property has not been set,
+	 * or if the nodes of the specified resource cannot be cached.
+	 */
+	static bool					cacheResource( CC3NodesResource* aResource, const std::string& sourceFilePath );
+
+	static CC3SceneCacheResource* resource();
+
+protected:
+	virtual bool				processFile( const std::string& anAbsoluteFilePath );
+
+protected:
+	unsigned long long			m_sourceHash;
+	unsigned long long			m_sourceSize;
+	unsigned long long			m_sourceModificationTime;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <algorithm>
+
+NS_COCOS3D_BEGIN
+
+// Layout of the fields within the sort key of a command
+#define kCC3DrawCommandOrderedBit			(1ULL << 63)
+#define kCC3DrawCommandProgramShift			51
+#define kCC3DrawCommandProgramMask			0xFFFULL
+#define kCC3DrawCommandMaterialShift		37
+#define kCC3DrawCommandMaterialMask			0x3FFFULL
+#define kCC3DrawCommandMeshShift			23
+#define kCC3DrawCommandMeshMask				0x3FFFULL
+#define kCC3DrawCommandRecordIndexMask		0x7FFFFFULL
+
+CC3DrawCommandQueue::CC3DrawCommandQueue()
+{
+	m_shouldSortByRenderState = true;
+	m_hasPublishedCommands = false;
+	pthread_mutex_init( &m_commitMutex, NULL );
+}
+
+CC3DrawCommandQueue::~CC3DrawCommandQueue()
+{
+	releaseCommands( m_recordedCommands );
+	releaseCommands( m_pendingCommands );
+	releaseCommands( m_publishedCommands );
+	releaseCommands( m_committedCommands );
+	releaseCommands( m_retiredCommands );
+	releaseCommands( m_releasingCommands );
+	pthread_mutex_destroy( &m_commitMutex );
+}
+
+CC3DrawCommandQueue* CC3DrawCommandQueue::queue()
+{
+	CC3DrawCommandQueue* pQueue = new CC3DrawCommandQueue;
+	pQueue->init();
+	pQueue->autorelease();
+
+	return pQueue;
+}
+
+void CC3DrawCommandQueue::init()
+{
+	m_shouldSortByRenderState = true;
+}
+
+bool CC3DrawCommandQueue::shouldSortByRenderState()
+{
+	return m_shouldSortByRenderState;
+}
+
+void CC3DrawCommandQueue::setShouldSortByRenderState( bool shouldSort )
+{
+	m_shouldSortByRenderState = shouldSort;
+}
+
+void CC3DrawCommandQueue::beginRecording()
+{
+	if ( !m_recordedCommands.empty() )
+	{
+		pthread_mutex_lock( &m_commitMutex );
+		retireCommands( m_recordedCommands );
+		pthread_mutex_unlock( &m_commitMutex );
+	}
+	clearRecording();
+}
+
+/** Clears the recorded commands, whose references are now held by another buffer. */
+void CC3DrawCommandQueue::clearRecording()
+{
+	m_recordedCommands.clear();
+	m_recordedNodes.clear();
+	m_stateOrdinals.clear();
+}
+
+/** Moves the specified commands to the end of the retired commands. Must be invoked under the commit lock. */
+void CC3DrawCommandQueue::retireCommands( std::vector<CC3DrawCommand>& commands )
+{
+	m_retiredCommands.insert( m_retiredCommands.end(), commands.begin(), commands.end() );
+	commands.clear();
+}
+
+/** Releases the objects retained by the specified commands, and clears the commands. */
+void CC3DrawCommandQueue::releaseCommands( std::vector<CC3DrawCommand>& commands )
+{
+	for (std::vector<CC3DrawCommand>::iterator it = commands.begin(); it != commands.end(); ++it)
+	{
+		CC_SAFE_RELEASE( it->node );
+		CC_SAFE_RELEASE( it->mesh );
+		CC_SAFE_RELEASE( it->material );
+		CC_SAFE_RELEASE( it->shaderProgram );
+	}
+	commands.clear();
+}
+
+void CC3DrawCommandQueue::recordNode( CC3Node* aNode, CC3NodeDrawingVisitor* visitor )
+{
+	if ( !m_recordedNodes.insert( aNode ).second )
+		return;		// Already recorded this frame
+
+	CC3DrawCommand command;
+	command.node = aNode;
+	command.mesh = NULL;
+	command.material = NULL;
+	command.shaderProgram = NULL;
+	if ( aNode->isMeshNode() )
+	{
+		// Don't trigger shader selection here, since that may compile programs on the GL engine.
+		CC3MeshNode* meshNode = (CC3MeshNode*)aNode;
+		command.mesh = meshNode->getDrawingMesh();
+		command.material = meshNode->getMaterial();
+		command.shaderProgram = meshNode->getAssignedShaderProgram();
+	}
+	command.modelMatrix = *visitor->getModelMatrix();
+	command.modelViewMatrix = *visitor->getModelViewMatrix();
+	command.modelViewProjMatrix = *visitor->getModelViewProjMatrix();
+	command.sortKey = getSortKeyForCommand( command, (GLuint)m_recordedCommands.size() );
+
+	// Keep everything the command refers to alive until it has been executed
+	aNode->retain();
+	CC_SAFE_RETAIN( command.mesh );
+	CC_SAFE_RETAIN( command.material );
+	CC_SAFE_RETAIN( command.shaderProgram );
+
+	m_recordedCommands.push_back( command );
+}
+
+GLuint CC3DrawCommandQueue::getRecordedCommandCount()
+{
+	return (GLuint)m_recordedCommands.size();
+}
+
+GLuint CC3DrawCommandQueue::getOrdinalOf( CCObject* anObject )
+{
+	if ( !anObject )
+		return 0;
+
+	std::map<CCObject*, GLuint>::iterator it = m_stateOrdinals.find( anObject );
+	if ( it != m_stateOrdinals.end() )
+		return it->second;
+
+	GLuint ordinal = (GLuint)m_stateOrdinals.size() + 1;
+	m_stateOrdinals[anObject] = ordinal;
+	return ordinal;
+}
+
+/**
+ * Opaque mesh nodes are keyed by shader program, material and mesh. All other nodes are keyed
+ * to follow them in the order they were recorded. The record index makes each key unique,
+ * so that nodes with the same state retain their recorded order.
+ */
+CC3NodeSortKey CC3DrawCommandQueue::getSortKeyForCommand( const CC3DrawCommand& command, GLuint recordIndex )
+{
+	CC3NodeSortKey key = recordIndex & kCC3DrawCommandRecordIndexMask;
+	if ( !m_shouldSortByRenderState )
+		return key;
+
+	CC3Node* aNode = command.node;
+	bool isStateSortable = aNode->isMeshNode()
+							&& aNode->isOpaque()
+							&& !aNode->shouldDisableDepthTest()
+							&& aNode->getDecalOffsetFactor() == 0.0f
+							&& aNode->getDecalOffsetUnits() == 0.0f;
+	if ( !isStateSortable )
+		return key | kCC3DrawCommandOrderedBit;
+
+	key |= (getOrdinalOf( command.shaderProgram ) & kCC3DrawCommandProgramMask) << kCC3DrawCommandProgramShift;
+	key |= (getOrdinalOf( command.material ) & kCC3DrawCommandMaterialMask) << kCC3DrawCommandMaterialShift;
+	key |= (getOrdinalOf( command.mesh ) & kCC3DrawCommandMeshMask) << kCC3DrawCommandMeshShift;
+	return key;
+}
+
+/**
+ * Sorts a list of keys and indices, then gathers the commands in that order into the pending
+ * buffer, and publishes it under the lock. A previously published buffer that has not been
+ * executed is retired, so that it is released on the executing thread.
+ */
+void CC3DrawCommandQueue::commit()
+{
+	GLuint cmdCount = (GLuint)m_recordedCommands.size();
+	m_sortKeys.resize( cmdCount );
+	for (GLuint i = 0; i < cmdCount; i++)
+		m_sortKeys[i] = std::make_pair( m_recordedCommands[i].sortKey, i );
+
+	if ( m_shouldSortByRenderState )
+		std::sort( m_sortKeys.begin(), m_sortKeys.end() );
+
+	m_pendingCommands.resize( cmdCount );
+	for (GLuint i = 0; i < cmdCount; i++)
+		m_pendingCommands[i] = m_recordedCommands[m_sortKeys[i].second];
+
+	pthread_mutex_lock( &m_commitMutex );
+	retireCommands( m_publishedCommands );
+	m_publishedCommands.swap( m_pendingCommands );
+	m_hasPublishedCommands = true;
+	pthread_mutex_unlock( &m_commitMutex );
+
+	clearRecording();		// The references now belong to the published commands
+}
+
+GLuint CC3DrawCommandQueue::executeWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	CC3_PROFILE_ZONE( "CC3DrawCommandQueue::execute" );
+
+	// Take the newest published commands, and collect all replaced commands for release
+	pthread_mutex_lock( &m_commitMutex );
+	if ( m_hasPublishedCommands )
+	{
+		retireCommands( m_committedCommands );
+		m_committedCommands.swap( m_publishedCommands );
+		m_hasPublishedCommands = false;
+	}
+	m_releasingCommands.swap( m_retiredCommands );
+	pthread_mutex_unlock( &m_commitMutex );
+
+	releaseCommands( m_releasingCommands );
+
+	GLuint cmdCount = (GLuint)m_committedCommands.size();
+	GLuint materialsElided = 0;
+	GLuint meshesElided = 0;
+	bool canElide = visitor->shouldDecorateNode();
+	const CC3DrawCommand* prevCmd = NULL;
+	for (GLuint i = 0; i < cmdCount; i++)
+	{
+		const CC3DrawCommand* cmd = &m_committedCommands[i];
+
+		// Bindings can only be reused if the same shader program is still in use.
+		bool isSameProgram = canElide && prevCmd && cmd->shaderProgram
+							&& cmd->shaderProgram == prevCmd->shaderProgram;
+		bool isMaterialBound = isSameProgram && cmd->material && cmd->material == prevCmd->material;
+		bool isMeshBound = isSameProgram && cmd->mesh && cmd->mesh == prevCmd->mesh;
+		if (isMaterialBound)
+			materialsElided++;
+		if (isMeshBound)
+			meshesElided++;
+
+		visitor->drawRecordedNode( cmd->node, &cmd->modelMatrix, &cmd->modelViewMatrix, &cmd->modelViewProjMatrix,
+								   isMaterialBound, isMeshBound );
+		prevCmd = cmd;
+	}
+
+	CC3PerformanceStatistics* pStatistics = visitor->getPerformanceStatistics();
+	if ( pStatistics )
+	{
+		pStatistics->addDrawCommandsExecuted( cmdCount );
+		pStatistics->addMaterialBindingsElided( materialsElided );
+		pStatistics->addMeshBindingsElided( meshesElided );
+	}
+
+	return cmdCount;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,159 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_DRAW_COMMAND_QUEUE_H_
+#define _CC3_DRAW_COMMAND_QUEUE_H_
+
+NS_COCOS3D_BEGIN
+class CC3NodeDrawingVisitor;
+
+/** A single drawing operation recorded by a CC3DrawCommandQueue. */
+typedef struct
+{
+	CC3NodeSortKey		sortKey;				/**< The key on which the commands are sorted before execution. */
+	CC3Node*			node;					/**< The node to draw. Retained by the command. */
+	CC3Mesh*			mesh;					/**< The mesh drawn by the node, or NULL if the node is not a mesh node. Retained by the command. */
+	CC3Material*		material;				/**< The material of the node, or NULL if the node is not a mesh node. Retained by the command. */
+	CC3ShaderProgram*	shaderProgram;			/**< The shader program of the node, or NULL if it has not yet been selected. Retained by the command. */
+	CC3Matrix4x3		modelMatrix;			/**< The model-to-global transform matrix of the node when recorded. */
+	CC3Matrix4x3		modelViewMatrix;		/**< The model-view matrix of the node when recorded. */
+	CC3Matrix4x4		modelViewProjMatrix;	/**< The model-view-projection matrix of the node when recorded. */
+} CC3DrawCommand;
+
+/**
+ * CC3DrawCommandQueue holds a list of drawing commands, recorded by a CC3NodeDrawingVisitor
+ * as it visits the nodes of a scene, and executes them in a separate pass.
+ *
+ * Each command retains the node to draw, along with its mesh, material and shader program, and
+ * holds copies of the model, model-view and model-view-projection matrices that were current
+ * when it was recorded.
+ * When the commands are committed, duplicate commands for the same node are discarded, and,
+ * if the shouldSortByRenderState property is YES, opaque mesh nodes are sorted so that nodes
+ * that share a shader program, material and mesh are drawn consecutively. Translucent nodes,
+ * and nodes whose drawing depends on the content already drawn (nodes with a decal offset or
+ * without depth testing), are drawn after the sorted nodes, in the order they were recorded.
+ *
+ * During execution, when a command uses the same shader program and material as the previous
+ * command, the material is not bound to the GL engine again, and when it uses the same shader
+ * program and mesh, the vertex attributes and the mesh are not bound again. The number of commands
+ * executed, and the number of material and mesh bindings elided, are added to the
+ * performanceStatistics of the executing visitor.
+ *
+ * Recording, publishing and execution use separate buffers. The commit method sorts the recorded
+ * commands into a pending buffer, and then publishes that buffer under a lock. The executeWithVisitor:
+ * method takes the most recently published buffer under the same lock, and then executes it without
+ * holding the lock. Recording and committing a frame may therefore happen on a different thread
+ * than the GL thread that is executing the previous frame. Because the matrices are copied, the
+ * recorded nodes may be moved while their commands wait to be executed, and, because the executing
+ * visitor uses the recorded matrices, it need not use the same camera as the recording visitor.
+ * Other node state, such as material colors, is read when the commands are executed.
+ *
+ * Commands that are superseded before being executed, or that have been executed and replaced by
+ * a newer buffer, are released by the executeWithVisitor: method, so that resources whose last
+ * reference is held by a command are deallocated on the GL thread. Recording and committing must
+ * happen on a single thread, and execution on a single thread, which may be a different one.
+ *
+ * A drawing visitor whose drawCommandQueue property is set records into that queue while
+ * it visits the nodes, then commits and executes the queue when it is closed.
+ */
+class CC3DrawCommandQueue : public CCObject
+{
+public:
+	CC3DrawCommandQueue();
+	virtual ~CC3DrawCommandQueue();
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3DrawCommandQueue*	queue();
+
+	void						init();
+
+	/**
+	 * Indicates whether opaque mesh nodes should be sorted by shader program, material and mesh
+	 * when the recorded commands are committed. If this property is NO, all commands are executed
+	 * in the order they were recorded.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldSortByRenderState();
+	void						setShouldSortByRenderState( bool shouldSort );
+
+	/**
+	 * Discards any commands recorded since the last commit, in preparation for recording a new frame.
+	 * The discarded commands are released the next time the queue is executed.
+	 */
+	void						beginRecording();
+
+	/**
+	 * Records a command to draw the specified node, using the matrices currently held by the
+	 * specified visitor. If a command has already been recorded for the node since beginRecording
+	 * was invoked, the node is not recorded again.
+	 *
+	 * This method does not invoke the GL engine.
+	 */
+	void						recordNode( CC3Node* aNode, CC3NodeDrawingVisitor* visitor );
+
+	/** Returns the number of commands recorded since beginRecording was invoked. */
+	GLuint						getRecordedCommandCount();
+
+	/**
+	 * Sorts the recorded commands and publishes them for execution, replacing any commands
+	 * that were previously published but not yet executed. The recorded commands are cleared.
+	 */
+	void						commit();
+
+	/**
+	 * Draws the most recently published commands with the specified visitor, eliding redundant
+	 * material and mesh bindings, and returns the number of commands executed.
+	 *
+	 * The executed commands are kept, so they can be executed again if no new commands have
+	 * been published. Commands that have been replaced are released.
+	 */
+	GLuint						executeWithVisitor( CC3NodeDrawingVisitor* visitor );
+
+protected:
+	GLuint						getOrdinalOf( CCObject* anObject );
+	CC3NodeSortKey				getSortKeyForCommand( const CC3DrawCommand& command, GLuint recordIndex );
+	void						clearRecording();
+	void						retireCommands( std::vector<CC3DrawCommand>& commands );
+	void						releaseCommands( std::vector<CC3DrawCommand>& commands );
+
+protected:
+	std::vector<CC3DrawCommand>	m_recordedCommands;
+	std::vector<CC3DrawCommand>	m_pendingCommands;
+	std::vector<CC3DrawCommand>	m_publishedCommands;
+	std::vector<CC3DrawCommand>	m_committedCommands;
+	std::vector<CC3DrawCommand>	m_retiredCommands;
+	std::vector<CC3DrawCommand>	m_releasingCommands;
+	std::vector<std::pair<CC3NodeSortKey, GLuint> >	m_sortKeys;
+	std::set<CC3Node*>			m_recordedNodes;
+	std::map<CCObject*, GLuint>	m_stateOrdinals;
+	pthread_mutex_t				m_commitMutex;
+	bool						m_hasPublishedCommands : 1;
+	bool						m_shouldSortByRenderState : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -28,6 +28,7 @@
  * http://en.wikipedia.org/wiki/MIT_License
  */
 #include "cocos3d.h"
+#include <algorithm>
 
 NS_COCOS3D_BEGIN
 
@@ -271,6 +272,11 @@ void CC3NodeSequencer::visitNodesWithNodeVisitor( CC3NodeVisitor* nodeVisitor )
 
 }
 
+bool CC3NodeSequencer::sequenceNodes( std::vector<CC3Node*>&, CC3NodeSequencerVisitor* )
+{
+	return false;
+}
+
 void CC3NodeSequencer::setEvaluator( CC3NodeEvaluator* evaluator )
 {
 	CC_SAFE_RELEASE( m_pEvaluator );
@@ -382,6 +388,26 @@ void CC3BTreeNodeSequencer::visitNodesWithNodeVisitor( CC3NodeVisitor* aNodeVisi
 	}
 }
 
+/** Each contained sequencer picks its own nodes from a copy of the specified nodes. */
+bool CC3BTreeNodeSequencer::sequenceNodes( std::vector<CC3Node*>& nodes, CC3NodeSequencerVisitor* visitor )
+{
+	m_sequencedNodes.clear();
+	std::vector<CC3Node*> childNodes;
+
+	CCObject* pObj;
+	CCARRAY_FOREACH( m_sequencers, pObj )
+	{
+		CC3NodeSequencer* s = (CC3NodeSequencer*)pObj;
+		childNodes = nodes;
+		if ( !s->sequenceNodes( childNodes, visitor ) )
+			return false;
+		m_sequencedNodes.insert( m_sequencedNodes.end(), childNodes.begin(), childNodes.end() );
+	}
+
+	nodes.swap( m_sequencedNodes );
+	return true;
+}
+
 /** Concatenates the nodes from the contained sequencers into one array. */
 CCArray* CC3BTreeNodeSequencer::getNodes()
 {
@@ -423,24 +449,24 @@ void CC3BTreeNodeSequencer::setShouldUseOnlyForwardDistance( bool onlyForward )
 CC3BTreeNodeSequencer* CC3BTreeNodeSequencer::sequencerLocalContentOpaqueFirst()
 {
 	CC3BTreeNodeSequencer* bTree = sequencerWithEvaluator( CC3LocalContentNodeAcceptor::evaluator() );
-	bTree->addSequencer( CC3NodeArraySequencer::sequencerWithEvaluator( CC3OpaqueNodeAcceptor::evaluator() ) );
-	bTree->addSequencer( CC3NodeArrayZOrderSequencer::sequencerWithEvaluator( CC3TranslucentNodeAcceptor::evaluator() ) );
+	bTree->addSequencer( CC3NodeSortKeySequencer::sequencerWithEvaluator( CC3LocalContentNodeAcceptor::evaluator(),
+																		 kCC3NodeSortKeyTranslucentDepth ) );
 	return bTree;
 }
 
 CC3BTreeNodeSequencer* CC3BTreeNodeSequencer::sequencerLocalContentOpaqueFirstGroupTextures()
 {
 	CC3BTreeNodeSequencer* bTree = sequencerWithEvaluator( CC3LocalContentNodeAcceptor::evaluator() );
-	bTree->addSequencer( CC3MeshNodeArraySequencerGroupTextures::sequencerWithEvaluator( CC3OpaqueNodeAcceptor::evaluator() ) );
-	bTree->addSequencer( CC3NodeArrayZOrderSequencer::sequencerWithEvaluator( CC3TranslucentNodeAcceptor::evaluator() ) );
+	bTree->addSequencer( CC3NodeSortKeySequencer::sequencerWithEvaluator( CC3LocalContentNodeAcceptor::evaluator(),
+																		 kCC3NodeSortKeyTexture | kCC3NodeSortKeyTranslucentDepth ) );
 	return bTree;
 }
 
 CC3BTreeNodeSequencer* CC3BTreeNodeSequencer::sequencerLocalContentOpaqueFirstGroupMeshes()
 {
 	CC3BTreeNodeSequencer* bTree = sequencerWithEvaluator( CC3LocalContentNodeAcceptor::evaluator() );
-	bTree->addSequencer( CC3MeshNodeArraySequencerGroupMeshes::sequencerWithEvaluator( CC3OpaqueNodeAcceptor::evaluator() ) );
-	bTree->addSequencer( CC3NodeArrayZOrderSequencer::sequencerWithEvaluator( CC3TranslucentNodeAcceptor::evaluator() ) );
+	bTree->addSequencer( CC3NodeSortKeySequencer::sequencerWithEvaluator( CC3LocalContentNodeAcceptor::evaluator(),
+																		 kCC3NodeSortKeyMesh | kCC3NodeSortKeyTranslucentDepth ) );
 	return bTree;
 }
 
@@ -709,6 +735,357 @@ bool CC3MeshNodeArraySequencerGroupMeshes::shouldInsertMeshNode( CC3MeshNode* aN
 	return (mesh == leftMesh && mesh != rightMesh);
 }
 
+// Layout of the fields within the sort key
+#define kCC3NodeSortKeyTranslucentBit		(1ULL << 63)
+#define kCC3NodeSortKeyProgramShift			53
+#define kCC3NodeSortKeyProgramMask			0x3FFULL
+#define kCC3NodeSortKeyTextureShift			41
+#define kCC3NodeSortKeyTextureMask			0xFFFULL
+#define kCC3NodeSortKeyMeshShift			29
+#define kCC3NodeSortKeyMeshMask				0xFFFULL
+#define kCC3NodeSortKeyOpaqueDepthBits		29
+#define kCC3NodeSortKeyZOrderShift			47
+#define kCC3NodeSortKeyTranslucentDepthShift	15
+#define kCC3NodeSortKeyMaxOrdinal			kCC3NodeSortKeyTextureMask
+
+/** Returns an unsigned integer whose ordering matches the ordering of the specified float. */
+static inline GLuint CC3SortableBitsFromFloat( GLfloat value )
+{
+	union { GLfloat f; GLuint u; } bits;
+	bits.f = value;
+	return (bits.u & 0x80000000) ? ~bits.u : (bits.u | 0x80000000);
+}
+
+CC3NodeSortKeySequencer::CC3NodeSortKeySequencer()
+{
+	m_nextSerial = 0;
+	m_nextOrdinal = 1;
+	m_removedCount = 0;
+	m_sortKeyFields = kCC3NodeSortKeyTranslucentDepth;
+	m_isSequenceDirty = false;
+	m_shouldUseOnlyForwardDistance = false;
+}
+
+CC3NodeSortKeySequencer::~CC3NodeSortKeySequencer()
+{
+	for (std::vector<CC3NodeSortKeyEntry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+		it->node->release();
+}
+
+void CC3NodeSortKeySequencer::initWithEvaluator( CC3NodeEvaluator* anEvaluator )
+{
+	super::initWithEvaluator( anEvaluator );
+}
+
+CC3NodeSortKeySequencer* CC3NodeSortKeySequencer::sequencerWithEvaluator( CC3NodeEvaluator* anEvaluator )
+{
+	CC3NodeSortKeySequencer* pSequencer = new CC3NodeSortKeySequencer;
+	pSequencer->initWithEvaluator( anEvaluator );
+	pSequencer->autorelease();
+
+	return pSequencer;
+}
+
+CC3NodeSortKeySequencer* CC3NodeSortKeySequencer::sequencerWithEvaluator( CC3NodeEvaluator* anEvaluator, GLuint sortKeyFields )
+{
+	CC3NodeSortKeySequencer* pSequencer = sequencerWithEvaluator( anEvaluator );
+	pSequencer->setSortKeyFields( sortKeyFields );
+	return pSequencer;
+}
+
+void CC3NodeSortKeySequencer::populateFrom( CC3NodeSortKeySequencer* another )
+{
+	super::populateFrom( another );
+	m_sortKeyFields = another->getSortKeyFields();
+	m_shouldUseOnlyForwardDistance = another->shouldUseOnlyForwardDistance();
+}
+
+CCObject* CC3NodeSortKeySequencer::copyWithZone( CCZone* )
+{
+	CC3NodeSortKeySequencer* pVal = new CC3NodeSortKeySequencer;
+	pVal->initWithEvaluator( m_pEvaluator ? (CC3NodeEvaluator*)(m_pEvaluator->copy()->autorelease()) : NULL );
+	pVal->populateFrom( this );
+
+	return pVal;
+}
+
+GLuint CC3NodeSortKeySequencer::getSortKeyFields()
+{
+	return m_sortKeyFields;
+}
+
+void CC3NodeSortKeySequencer::setSortKeyFields( GLuint sortKeyFields )
+{
+	m_sortKeyFields = sortKeyFields;
+}
+
+bool CC3NodeSortKeySequencer::shouldUseOnlyForwardDistance()
+{
+	return m_shouldUseOnlyForwardDistance;
+}
+
+void CC3NodeSortKeySequencer::setShouldUseOnlyForwardDistance( bool shouldUse )
+{
+	m_shouldUseOnlyForwardDistance = shouldUse;
+}
+
+CCArray* CC3NodeSortKeySequencer::getNodes()
+{
+	sortEntries();
+
+	CCArray* nodes = CCArray::createWithCapacity( m_entries.size() );
+	for (std::vector<CC3NodeSortKeyEntry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+		nodes->addObject( it->node );
+
+	return nodes;
+}
+
+bool CC3NodeSortKeySequencer::add( CC3Node* aNode, CC3NodeSequencerVisitor* visitor )
+{
+	if ( !(m_pEvaluator && m_pEvaluator->evaluate( aNode )) )
+		return false;
+
+	CCAssert(m_nodeSerials.find( aNode ) == m_nodeSerials.end(), "CC3NodeSortKeySequencer already contains node aNode!");
+
+	CC3NodeSortKeyEntry entry;
+	entry.key = getSortKeyForNode( aNode, visitor );
+	entry.node = aNode;
+	entry.serial = ++m_nextSerial;
+	aNode->retain();
+
+	m_nodeSerials[aNode] = entry.serial;
+	m_entries.push_back( entry );
+	m_isSequenceDirty = true;
+	return true;
+}
+
+bool CC3NodeSortKeySequencer::remove( CC3Node* aNode, CC3NodeSequencerVisitor* )
+{
+	std::map<CC3Node*, GLuint>::iterator it = m_nodeSerials.find( aNode );
+	if ( it == m_nodeSerials.end() )
+		return false;
+
+	m_nodeSerials.erase( it );
+	m_removedCount++;
+	m_isSequenceDirty = true;
+	return true;
+}
+
+/**
+ * Collects the nodes that no longer pass the evaluator, and rebuilds the keys of the rest.
+ * The misplaced nodes are removed, and their entries discarded, by the caller.
+ */
+void CC3NodeSortKeySequencer::identifyMisplacedNodesWithVisitor( CC3NodeSequencerVisitor* visitor )
+{
+	if (!m_allowSequenceUpdates)
+		return;
+
+	// Restart the resource ordinals before they overflow their key fields.
+	// All keys are rebuilt below, so the grouping remains consistent.
+	if (m_nextOrdinal > kCC3NodeSortKeyMaxOrdinal)
+	{
+		m_resourceOrdinals.clear();
+		m_nextOrdinal = 1;
+	}
+
+	purgeRemovedEntries();
+	for (std::vector<CC3NodeSortKeyEntry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		if ( m_pEvaluator && m_pEvaluator->evaluate( it->node ) )
+			it->key = getSortKeyForNode( it->node, visitor );
+		else
+			visitor->addMisplacedNode( it->node );
+	}
+
+	m_isSequenceDirty = true;
+}
+
+void CC3NodeSortKeySequencer::visitNodesWithNodeVisitor( CC3NodeVisitor* aNodeVisitor )
+{
+	sortEntries();
+
+	// Index, rather than iterate, in case the visitor modifies the sequence
+	for (GLuint i = 0; i < m_entries.size(); i++)
+		aNodeVisitor->visit( m_entries[i].node );
+}
+
+/** Orders entries on their keys, and entries with equal keys in the order they were added. */
+static bool compareSortKeyEntries( const CC3NodeSortKeyEntry& e1, const CC3NodeSortKeyEntry& e2 )
+{
+	return (e1.key != e2.key) ? (e1.key < e2.key) : (e1.serial < e2.serial);
+}
+
+bool CC3NodeSortKeySequencer::sequenceNodes( std::vector<CC3Node*>& nodes, CC3NodeSequencerVisitor* visitor )
+{
+	if (!m_allowSequenceUpdates)
+		return false;
+
+	// The scratch entries are only used within sortEntries, so can be borrowed here
+	m_sortScratch.clear();
+	GLuint nodeCount = (GLuint)nodes.size();
+	for (GLuint i = 0; i < nodeCount; i++)
+	{
+		std::map<CC3Node*, GLuint>::iterator it = m_nodeSerials.find( nodes[i] );
+		if ( it == m_nodeSerials.end() )
+			continue;
+
+		CC3NodeSortKeyEntry entry;
+		entry.key = getSortKeyForNode( nodes[i], visitor );
+		entry.node = nodes[i];
+		entry.serial = it->second;
+		m_sortScratch.push_back( entry );
+	}
+	std::sort( m_sortScratch.begin(), m_sortScratch.end(), compareSortKeyEntries );
+
+	GLuint entryCount = (GLuint)m_sortScratch.size();
+	nodes.resize( entryCount );
+	for (GLuint i = 0; i < entryCount; i++)
+		nodes[i] = m_sortScratch[i].node;
+
+	return true;
+}
+
+GLuint CC3NodeSortKeySequencer::getOrdinalOf( CCObject* anObject )
+{
+	if ( !anObject )
+		return 0;
+
+	std::map<CCObject*, GLuint>::iterator it = m_resourceOrdinals.find( anObject );
+	if ( it != m_resourceOrdinals.end() )
+		return it->second;
+
+	GLuint ordinal = m_nextOrdinal++;
+	m_resourceOrdinals[anObject] = ordinal;
+	return ordinal;
+}
+
+/**
+ * Returns the relative distance from the camera to the node, measured as described
+ * for CC3NodeArrayZOrderSequencer, and caches it in the node's cameraDistanceProduct.
+ */
+GLfloat CC3NodeSortKeySequencer::getCameraDistanceProductOf( CC3Node* aNode, CC3Camera* camera )
+{
+	CC3Vector node2Cam = aNode->getGlobalCenterOfGeometry().difference( camera->getGlobalLocation() );
+	CC3Vector measureDir = m_shouldUseOnlyForwardDistance ? camera->getForwardDirection() : node2Cam;
+	GLfloat camDistProd = node2Cam.dot( measureDir );
+	aNode->setCameraDistanceProduct( camDistProd );
+	return camDistProd;
+}
+
+CC3NodeSortKey CC3NodeSortKeySequencer::getSortKeyForNode( CC3Node* aNode, CC3NodeSequencerVisitor* visitor )
+{
+	CC3Scene* scene = visitor ? visitor->getScene() : NULL;
+	CC3Camera* cam = scene ? scene->getActiveCamera() : NULL;
+	CC3NodeSortKey key = 0;
+
+	if ( !aNode->isOpaque() )
+	{
+		// Translucent nodes are drawn last, highest Z-order first, then furthest first.
+		GLint zOrder = MAX(MIN(aNode->getZOrder(), 32767), -32768);
+		key = kCC3NodeSortKeyTranslucentBit;
+		key |= (CC3NodeSortKey)(32767 - zOrder) << kCC3NodeSortKeyZOrderShift;
+		if ( cam && (m_sortKeyFields & kCC3NodeSortKeyTranslucentDepth) )
+		{
+			GLuint depthBits = ~CC3SortableBitsFromFloat( getCameraDistanceProductOf( aNode, cam ) );
+			key |= (CC3NodeSortKey)depthBits << kCC3NodeSortKeyTranslucentDepthShift;
+		}
+		return key;
+	}
+
+	// Opaque nodes are grouped by their rendering state, then drawn closest first.
+	if ( aNode->isMeshNode() )
+	{
+		CC3MeshNode* meshNode = (CC3MeshNode*)aNode;
+		if (m_sortKeyFields & kCC3NodeSortKeyShaderProgram)
+			key |= (getOrdinalOf( meshNode->getAssignedShaderProgram() ) & kCC3NodeSortKeyProgramMask) << kCC3NodeSortKeyProgramShift;
+		if (m_sortKeyFields & kCC3NodeSortKeyTexture)
+			key |= (getOrdinalOf( meshNode->getTexture() ) & kCC3NodeSortKeyTextureMask) << kCC3NodeSortKeyTextureShift;
+		if (m_sortKeyFields & kCC3NodeSortKeyMesh)
+			key |= (getOrdinalOf( meshNode->getMesh() ) & kCC3NodeSortKeyMeshMask) << kCC3NodeSortKeyMeshShift;
+	}
+	if ( cam && (m_sortKeyFields & kCC3NodeSortKeyOpaqueDepth) )
+	{
+		GLuint depthBits = CC3SortableBitsFromFloat( getCameraDistanceProductOf( aNode, cam ) );
+		key |= (CC3NodeSortKey)(depthBits >> (32 - kCC3NodeSortKeyOpaqueDepthBits));
+	}
+	return key;
+}
+
+/** Discards entries for nodes that were removed, or that were removed and re-added since the entry was created. */
+void CC3NodeSortKeySequencer::purgeRemovedEntries()
+{
+	if (m_removedCount == 0)
+		return;
+
+	GLuint liveCount = 0;
+	GLuint entryCount = m_entries.size();
+	for (GLuint i = 0; i < entryCount; i++)
+	{
+		CC3NodeSortKeyEntry& entry = m_entries[i];
+		std::map<CC3Node*, GLuint>::iterator it = m_nodeSerials.find( entry.node );
+		if ( it != m_nodeSerials.end() && it->second == entry.serial )
+			m_entries[liveCount++] = entry;
+		else
+			entry.node->release();
+	}
+	m_entries.resize( liveCount );
+	m_removedCount = 0;
+}
+
+/**
+ * Sorts the entries on their keys, using a stable least-significant-digit radix sort,
+ * one byte per pass. Passes in which all keys share the same byte value are skipped.
+ */
+void CC3NodeSortKeySequencer::sortEntries()
+{
+	if (!m_isSequenceDirty)
+		return;
+
+	purgeRemovedEntries();
+	m_isSequenceDirty = false;
+
+	GLuint entryCount = m_entries.size();
+	if (entryCount < 2)
+		return;
+
+	GLuint histograms[8][256];
+	memset( histograms, 0, sizeof(histograms) );
+	for (GLuint i = 0; i < entryCount; i++)
+	{
+		CC3NodeSortKey key = m_entries[i].key;
+		for (GLuint b = 0; b < 8; b++)
+			histograms[b][(key >> (b * 8)) & 0xFF]++;
+	}
+
+	m_sortScratch.resize( entryCount );
+	CC3NodeSortKeyEntry* src = &m_entries[0];
+	CC3NodeSortKeyEntry* dst = &m_sortScratch[0];
+	for (GLuint b = 0; b < 8; b++)
+	{
+		GLuint* counts = histograms[b];
+		GLuint shift = b * 8;
+		if (counts[(src[0].key >> shift) & 0xFF] == entryCount)
+			continue;
+
+		GLuint offset = 0;
+		for (GLuint d = 0; d < 256; d++)
+		{
+			GLuint c = counts[d];
+			counts[d] = offset;
+			offset += c;
+		}
+		for (GLuint i = 0; i < entryCount; i++)
+			dst[counts[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		CC3NodeSortKeyEntry* tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != &m_entries[0])
+		m_entries.swap( m_sortScratch );
+}
+
 CC3NodeSequencerVisitor::CC3NodeSequencerVisitor()
 {
 	m_misplacedNodes = NULL;
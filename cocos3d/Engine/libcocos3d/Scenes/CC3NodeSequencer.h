@@ -32,6 +32,7 @@
 
 NS_COCOS3D_BEGIN
 class CC3Scene;
+class CC3Camera;
 class CC3NodeSequencerVisitor;
 /**
  * A CC3NodeEvaluator performs some type of accept/reject evaluation on a CC3Node instance.
@@ -316,6 +317,21 @@ public:
 	 */
 	virtual void				visitNodesWithNodeVisitor( CC3NodeVisitor* aNodeVisitor );
 
+	/**
+	 * Replaces the contents of the specified array of nodes with those of its nodes that are
+	 * contained in this sequencer, in the order in which visitNodesWithNodeVisitor: would visit
+	 * them, and returns whether this sequencer was able to do so.
+	 *
+	 * This allows a drawing visitor that has already determined which nodes are visible, for
+	 * example from a CC3BoundingVolumeHierarchy, to draw only those nodes, in sequence, without
+	 * walking the entire sequence. The cost should grow with the number of nodes in the array.
+	 *
+	 * The default implementation returns NO and leaves the array unchanged, in which case the
+	 * caller should visit the whole sequence instead. Subclasses that can order an arbitrary
+	 * subset of their nodes will override.
+	 */
+	virtual bool				sequenceNodes( std::vector<CC3Node*>& nodes, CC3NodeSequencerVisitor* visitor );
+
 	/** Returns a string containing a more complete description of this object. */
 	std::string					fullDescription();
 
@@ -363,6 +379,8 @@ public:
 	 * 
 	 * The opaque nodes are sorted in the order they are added. The translucent nodes are
 	 * sorted by their distance from the camera, from furthest from the camera to closest.
+	 *
+	 * The nodes are sequenced by a single CC3NodeSortKeySequencer child.
 	 */
 	static CC3BTreeNodeSequencer* sequencerLocalContentOpaqueFirst();
 
@@ -374,6 +392,8 @@ public:
 	 * The opaque nodes are grouped by texture, so that all nodes with the same texture
 	 * appear together. The translucent nodes are sorted by their distance from the camera,
 	 * from furthest from the camera to closest.
+	 *
+	 * The nodes are sequenced by a single CC3NodeSortKeySequencer child.
 	 */
 	static CC3BTreeNodeSequencer* sequencerLocalContentOpaqueFirstGroupTextures();
 
@@ -385,6 +405,8 @@ public:
 	 * The opaque nodes are grouped by mesh, so that all nodes with the same mesh appear
 	 * together. The translucent nodes are sorted by their distance from the camera, from
 	 * furthest from the camera to closest.
+	 *
+	 * The nodes are sequenced by a single CC3NodeSortKeySequencer child.
 	 */
 	static CC3BTreeNodeSequencer* sequencerLocalContentOpaqueFirstGroupMeshes();
 	static CC3BTreeNodeSequencer* sequencerWithEvaluator( CC3NodeEvaluator* anEvaluator );
@@ -402,11 +424,18 @@ public:
 	virtual void				identifyMisplacedNodesWithVisitor( CC3NodeSequencerVisitor* visitor );
 	virtual void				visitNodesWithNodeVisitor( CC3NodeVisitor* aNodeVisitor );
 
+	/**
+	 * Concatenates the nodes sequenced by each of the contained sequencers, in turn.
+	 * Returns NO if any contained sequencer cannot sequence its nodes.
+	 */
+	virtual bool				sequenceNodes( std::vector<CC3Node*>& nodes, CC3NodeSequencerVisitor* visitor );
+
 	virtual bool				shouldUseOnlyForwardDistance();
 	virtual void				setShouldUseOnlyForwardDistance( bool onlyForward );
 
 protected:
 	CCArray*					m_sequencers;
+	std::vector<CC3Node*>		m_sequencedNodes;
 };
 
 
@@ -589,6 +618,152 @@ public:
 	virtual bool				shouldInsertMeshNode( CC3MeshNode* aNode, CC3MeshNode* leftNode, CC3MeshNode* rightNode, CC3NodeSequencerVisitor* visitor );
 };
 
+/** A 64-bit key used by CC3NodeSortKeySequencer to order the nodes it contains. */
+typedef unsigned long long CC3NodeSortKey;
+
+/**
+ * Bit flags identifying the criteria that a CC3NodeSortKeySequencer encodes into the
+ * sort key of each node. The flags may be combined using a bitwise OR.
+ */
+typedef enum {
+	kCC3NodeSortKeyNone					= 0,		/**< Opaque nodes are kept in the order they were added. */
+	kCC3NodeSortKeyShaderProgram		= 1 << 0,	/**< Group opaque mesh nodes by shader program. */
+	kCC3NodeSortKeyTexture				= 1 << 1,	/**< Group opaque mesh nodes by texture. */
+	kCC3NodeSortKeyMesh					= 1 << 2,	/**< Group opaque mesh nodes by mesh. */
+	kCC3NodeSortKeyOpaqueDepth			= 1 << 3,	/**< Order opaque nodes from closest to the camera to furthest. */
+	kCC3NodeSortKeyTranslucentDepth		= 1 << 4,	/**< Order translucent nodes from furthest from the camera to closest. */
+} CC3NodeSortKeyField;
+
+/** An entry in the node sequence of a CC3NodeSortKeySequencer. */
+typedef struct {
+	CC3NodeSortKey		key;			/**< The sort key of the node. */
+	CC3Node*			node;			/**< The node. Retained by the sequencer. */
+	GLuint				serial;			/**< Identifies the add operation that created this entry. */
+} CC3NodeSortKeyEntry;
+
+/**
+ * An CC3NodeSortKeySequencer is a type of CC3NodeSequencer that orders its nodes by
+ * a 64-bit sort key that is built for each node from the criteria identified by the
+ * sortKeyFields property.
+ *
+ * Opaque nodes are always sequenced before translucent nodes. Within the opaque nodes, the
+ * key groups nodes by shader program, then texture, then mesh, and finally by distance to
+ * the camera, from closest to furthest, to take advantage of early depth rejection. Each of
+ * these criteria can be enabled individually. Opaque nodes whose keys are equal retain the
+ * order in which they were added.
+ *
+ * Within the translucent nodes, the key orders nodes by their explicit Z-order, and then,
+ * if the kCC3NodeSortKeyTranslucentDepth field is enabled, by distance to the camera, from
+ * furthest to closest, using the same measurements as CC3NodeArrayZOrderSequencer.
+ *
+ * Adding and removing nodes does not search the sequence. Instead, new nodes are appended,
+ * removed nodes are discarded lazily, and the nodes are radix-sorted on their keys at most
+ * once per frame, when the sequence is next visited. When the allowSequenceUpdates property
+ * is YES, the keys of all nodes are rebuilt each time the identifyMisplacedNodesWithVisitor:
+ * method is invoked, which happens on each frame, either directly from updateSequenceWithVisitor:,
+ * or from a parent CC3BTreeNodeSequencer. Changes to camera distance, or to the materials of the
+ * nodes, are therefore picked up each frame without removing and re-adding the affected nodes.
+ *
+ * The contents of the node sequence are not copied when this sequencer is copied.
+ */
+class CC3NodeSortKeySequencer : public CC3NodeSequencer
+{
+	DECLARE_SUPER( CC3NodeSequencer );
+public:
+	CC3NodeSortKeySequencer();
+	virtual ~CC3NodeSortKeySequencer();
+
+	/**
+	 * A bitwise OR of CC3NodeSortKeyField flags identifying the criteria encoded into
+	 * the sort key of each node.
+	 *
+	 * The initial value of this property is kCC3NodeSortKeyTranslucentDepth.
+	 */
+	GLuint						getSortKeyFields();
+	void						setSortKeyFields( GLuint sortKeyFields );
+
+	virtual bool				shouldUseOnlyForwardDistance();
+	virtual void				setShouldUseOnlyForwardDistance( bool shouldUse );
+
+	virtual CCArray*			getNodes();
+
+	/** Initializes this instance with the specified evaluator. */
+	virtual void				initWithEvaluator( CC3NodeEvaluator* anEvaluator );
+
+	/** Allocates and initializes an autoreleased instance with the specified evaluator. */
+	static CC3NodeSortKeySequencer* sequencerWithEvaluator( CC3NodeEvaluator* anEvaluator );
+
+	/**
+	 * Allocates and initializes an autoreleased instance with the specified evaluator,
+	 * and that builds sort keys from the specified bitwise OR of CC3NodeSortKeyField flags.
+	 */
+	static CC3NodeSortKeySequencer* sequencerWithEvaluator( CC3NodeEvaluator* anEvaluator, GLuint sortKeyFields );
+
+	void						populateFrom( CC3NodeSortKeySequencer* another );
+	virtual CCObject*			copyWithZone( CCZone* zone );
+
+	/**
+	 * If the node is accepted by the evaluator, builds its sort key and appends it to the
+	 * sequence, which will be re-sorted before it is next visited. Returns whether the
+	 * node was added.
+	 */
+	virtual bool				add( CC3Node* aNode, CC3NodeSequencerVisitor* visitor );
+
+	/**
+	 * Removes the specified node, if it exists within this sequencer, and returns whether it
+	 * was removed. The node is released when the sequence is next compacted.
+	 */
+	virtual bool				remove( CC3Node* aNode, CC3NodeSequencerVisitor* visitor );
+
+	/**
+	 * If the allowSequenceUpdates property is YES, identifies nodes that no longer pass the
+	 * evaluator, and rebuilds the sort keys of all other nodes, so that the sequence is
+	 * re-sorted before it is next visited.
+	 *
+	 * The sort keys are rebuilt here, rather than in updateSequenceWithVisitor:, because a
+	 * parent CC3BTreeNodeSequencer invokes only this method on the sequencers it contains.
+	 */
+	virtual void				identifyMisplacedNodesWithVisitor( CC3NodeSequencerVisitor* visitor );
+	virtual void				visitNodesWithNodeVisitor( CC3NodeVisitor* aNodeVisitor );
+
+	/**
+	 * Builds the sort key of each of the specified nodes that is contained in this sequencer,
+	 * and replaces the contents of the array with those nodes, sorted on their keys. Nodes
+	 * whose keys are equal are kept in the order in which they were added to this sequencer.
+	 *
+	 * Returns NO, leaving the array unchanged, if the allowSequenceUpdates property is NO,
+	 * since the sequence then depends on keys that were built on earlier frames.
+	 */
+	virtual bool				sequenceNodes( std::vector<CC3Node*>& nodes, CC3NodeSequencerVisitor* visitor );
+
+	/**
+	 * Template method that returns the sort key for the specified node, using the camera
+	 * of the scene held by the specified visitor to measure distance.
+	 *
+	 * Subclasses may override to encode different criteria into the key. The nodes are
+	 * sequenced in ascending order of their keys.
+	 */
+	virtual CC3NodeSortKey		getSortKeyForNode( CC3Node* aNode, CC3NodeSequencerVisitor* visitor );
+
+protected:
+	GLuint						getOrdinalOf( CCObject* anObject );
+	GLfloat						getCameraDistanceProductOf( CC3Node* aNode, CC3Camera* camera );
+	void						purgeRemovedEntries();
+	void						sortEntries();
+
+protected:
+	std::vector<CC3NodeSortKeyEntry>	m_entries;
+	std::vector<CC3NodeSortKeyEntry>	m_sortScratch;
+	std::map<CC3Node*, GLuint>	m_nodeSerials;
+	std::map<CCObject*, GLuint>	m_resourceOrdinals;
+	GLuint						m_nextSerial;
+	GLuint						m_nextOrdinal;
+	GLuint						m_removedCount;
+	GLuint						m_sortKeyFields;
+	bool						m_isSequenceDirty : 1;
+	bool						m_shouldUseOnlyForwardDistance : 1;
+};
+
 /**
  * This visitor is used to visit CC3NodeSequencers to perform operations on nodes
  * within the sequencers.
@@ -41,7 +41,11 @@ CC3Scene::CC3Scene()
 	m_pViewDrawingVisitor = NULL;
 	m_pEnvMapDrawingVisitor = NULL;
 	m_pUpdateVisitor = NULL;
+	m_pTransformStore = NULL;
+	m_pBoundingVolumeHierarchy = NULL;
+	m_pStaticBatcher = NULL;
 	m_pShadowVisitor = NULL;
+	m_pShadowMapVisitor = NULL;
 	m_pTouchedNodePicker = NULL;
 	m_pPerformanceStatistics = NULL;
 	m_lights = NULL;
@@ -65,7 +69,11 @@ CC3Scene::~CC3Scene()
 	setViewDrawingVisitor( NULL );			// Use setter to release and make nil
 	setEnvMapDrawingVisitor( NULL );		// Use setter to release and make nil
 	setUpdateVisitor( NULL );				// Use setter to release and make nil
+	setShouldUseTransformStore( false );	// Detaches nodes before they are removed
+	setShouldUseBoundingVolumeHierarchy( false );	// Detaches nodes before they are removed
+	setStaticBatcher( NULL );				// Use setter to release and make nil
 	setShadowVisitor( NULL );				// Use setter to release and make nil
+	setShadowMapVisitor( NULL );			// Use setter to release and make nil
 	setTouchedNodePicker( NULL );			// Use setter to release and make nil
 	setPerformanceStatistics( NULL );		// Use setter to release and make nil
 	
@@ -274,6 +282,7 @@ void CC3Scene::initWithTag( GLuint aTag, const std::string& aName )
 	setShadowVisitor( NULL );
 	setUpdateVisitor( CC3NodeUpdatingVisitor::visitor() );
 	setTouchedNodePicker( CC3TouchedNodePicker::pickerOnScene( this ) );
+	setStaticBatcher( CC3StaticBatcher::batcher() );
 
 	CHECK_GL_ERROR_DEBUG();
 
@@ -289,6 +298,7 @@ void CC3Scene::initWithTag( GLuint aTag, const std::string& aName )
 	m_timeAtOpen = 0;
 	m_elapsedTimeSinceOpened = 0;
 	m_shouldDisplayPickingRender = false;
+	m_shouldBatchStaticMeshesOnOpen = false;
 	processInitializeScene();
 	//LogGLErrorState(@"after initializing %@", self);
 }
@@ -365,6 +375,8 @@ void CC3Scene::open()
 	// Establish 3D environment, run scene open behaviour, then tear 3D environment down.
 	CC3NodeDrawingVisitor* visitor = getViewDrawingVisitor();
 	open3DWithVisitor( visitor );
+	if ( m_shouldBatchStaticMeshesOnOpen )
+		batchStaticMeshNodes();
 	onOpen();
 	close3DWithVisitor( visitor );
 }
@@ -399,6 +411,100 @@ CC3NodeUpdatingVisitor* CC3Scene::getUpdateVisitor()
 	return m_pUpdateVisitor;
 }
 
+bool CC3Scene::shouldUseTransformStore()
+{
+	return m_pTransformStore != NULL;
+}
+
+void CC3Scene::setShouldUseTransformStore( bool shouldUse )
+{
+	if ( shouldUse == shouldUseTransformStore() )
+		return;
+
+	CC_SAFE_RELEASE( m_pTransformStore );		// Detaches all nodes from the store
+
+	if ( shouldUse )
+	{
+		m_pTransformStore = CC3NodeTransformStore::storeWithRootNode( this );
+		m_pTransformStore->retain();
+	}
+}
+
+CC3NodeTransformStore* CC3Scene::getTransformStore()
+{
+	return m_pTransformStore;
+}
+
+bool CC3Scene::shouldUseBoundingVolumeHierarchy()
+{
+	return m_pBoundingVolumeHierarchy != NULL;
+}
+
+void CC3Scene::setShouldUseBoundingVolumeHierarchy( bool shouldUse )
+{
+	if ( shouldUse == shouldUseBoundingVolumeHierarchy() )
+		return;
+
+	CC_SAFE_RELEASE( m_pBoundingVolumeHierarchy );		// Detaches all nodes from the hierarchy
+
+	if ( shouldUse )
+	{
+		m_pBoundingVolumeHierarchy = CC3BoundingVolumeHierarchy::hierarchyWithRootNode( this );
+		m_pBoundingVolumeHierarchy->retain();
+	}
+}
+
+CC3BoundingVolumeHierarchy* CC3Scene::getBoundingVolumeHierarchy()
+{
+	return m_pBoundingVolumeHierarchy;
+}
+
+bool CC3Scene::shouldUseDrawCommandQueue()
+{
+	return m_pViewDrawingVisitor && m_pViewDrawingVisitor->getDrawCommandQueue() != NULL;
+}
+
+void CC3Scene::setShouldUseDrawCommandQueue( bool shouldUse )
+{
+	if ( !m_pViewDrawingVisitor || shouldUse == shouldUseDrawCommandQueue() )
+		return;
+
+	m_pViewDrawingVisitor->setDrawCommandQueue( shouldUse ? CC3DrawCommandQueue::queue() : NULL );
+}
+
+CC3StaticBatcher* CC3Scene::getStaticBatcher()
+{
+	return m_pStaticBatcher;
+}
+
+void CC3Scene::setStaticBatcher( CC3StaticBatcher* batcher )
+{
+	CC_SAFE_RELEASE( m_pStaticBatcher );
+	CC_SAFE_RETAIN( batcher );
+	m_pStaticBatcher = batcher;
+}
+
+bool CC3Scene::shouldBatchStaticMeshesOnOpen()
+{
+	return m_shouldBatchStaticMeshesOnOpen;
+}
+
+void CC3Scene::setShouldBatchStaticMeshesOnOpen( bool shouldBatch )
+{
+	m_shouldBatchStaticMeshesOnOpen = shouldBatch;
+}
+
+GLuint CC3Scene::batchStaticMeshNodes()
+{
+	return m_pStaticBatcher ? m_pStaticBatcher->batchNodesIn( this ) : 0;
+}
+
+void CC3Scene::unbatchStaticMeshNodes()
+{
+	if ( m_pStaticBatcher )
+		m_pStaticBatcher->unbatchNodesIn( this );
+}
+
 void CC3Scene::setUpdateVisitor( CC3NodeUpdatingVisitor* visitor )
 {
 	CC_SAFE_RELEASE(m_pUpdateVisitor);
@@ -432,6 +538,11 @@ void CC3Scene::setMaxUpdateInterval( float interval )
  */
 void CC3Scene::updateScene( float dt )
 {
+	if ( CC3FrameProfiler::isProfiling() )
+		CC3FrameProfiler::sharedProfiler()->beginFrame();
+
+	CC3_PROFILE_ZONE( "CC3Scene::updateScene" );
+
 	updateTimes( dt );
 
 	if( !isRunning() )
@@ -450,6 +561,9 @@ void CC3Scene::updateScene( float dt )
 	
 	m_pUpdateVisitor->setDeltaTime( m_deltaFrameTime );
 	m_pUpdateVisitor->visit( this );
+
+	if ( m_pTransformStore )
+		m_pTransformStore->updateTransforms();
 	
 	updateCamera( m_deltaFrameTime );
 	updateBillboards( m_deltaFrameTime );
@@ -523,6 +637,8 @@ void CC3Scene::drawSceneWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
 	if ( !isVisible() ) 
 		return;
+
+	CC3_PROFILE_ZONE( "CC3Scene::drawScene" );
 	
 	// Check and clear any GL error that occurred before 3D code
 	// LogGLErrorState(@"before drawing %@", self);
@@ -531,6 +647,7 @@ void CC3Scene::drawSceneWithVisitor( CC3NodeDrawingVisitor* visitor )
 	collectFrameInterval();	// Collect the frame interval in the performance statistics.
 
 	open3DWithVisitor( visitor );
+	drawShadowMapsWithVisitor( visitor );
 	
 	m_pTouchedNodePicker->pickTouchedNodeWithVisitor( visitor );
 	if ( !m_shouldDisplayPickingRender ) 
@@ -555,6 +672,7 @@ void CC3Scene::drawSceneContentWithVisitor( CC3NodeDrawingVisitor* visitor )
 	// Shadows are drawn with a specialized visitor
 	if ( m_pShadowVisitor )
 	{
+		CC3_PROFILE_ZONE( "CC3Scene::drawShadows" );
 		m_pShadowVisitor->alignShotWith( visitor );
 		drawShadowsWithVisitor( m_pShadowVisitor );
 	}
@@ -725,6 +843,37 @@ bool CC3Scene::doesContainShadows()
 	return m_pShadowVisitor != NULL; 
 }
 
+/**
+ * Lights that are invisible, and do not cast shadows when invisible, leave their shadow maps
+ * stale, so that shaders will not sample them. A light that was given a shadow map before it
+ * was added to a scene with a camera is given its shadow casting volume here.
+ */
+void CC3Scene::drawShadowMapsWithVisitor( CC3NodeDrawingVisitor* visitor )
+{
+	CC3Camera* cam = visitor->getCamera();
+
+	CCObject* obj = NULL;
+	CCARRAY_FOREACH( m_lights, obj )
+	{
+		CC3Light* lgt = (CC3Light*)obj;
+		CC3ShadowMap* shadowMap = lgt->getShadowMap();
+		if ( !shadowMap )
+			continue;
+
+		if ( !cam || !(lgt->isVisible() || lgt->shouldCastShadowsWhenInvisible()) )
+		{
+			shadowMap->markStale();
+			continue;
+		}
+
+		if ( !lgt->getShadowCastingVolume() )
+			lgt->setShadowCastingVolume( CC3ShadowCastingVolume::boundingVolume() );
+
+		CC3_PROFILE_ZONE( "CC3Scene::drawShadowMaps" );
+		shadowMap->generateSnapshotOfScene( this, cam, getShadowMapVisitor() );
+	}
+}
+
 /** Template method to draw shadows cast by the lights. */
 void CC3Scene::drawShadowsWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
@@ -813,6 +962,20 @@ void CC3Scene::setShadowVisitor( CC3NodeDrawingVisitor* visitor )
 	m_pShadowVisitor = visitor;
 }
 
+CC3ShadowMapDrawingVisitor* CC3Scene::getShadowMapVisitor()
+{
+	if ( !m_pShadowMapVisitor )
+		setShadowMapVisitor( CC3ShadowMapDrawingVisitor::visitor() );
+	return m_pShadowMapVisitor;
+}
+
+void CC3Scene::setShadowMapVisitor( CC3ShadowMapDrawingVisitor* visitor )
+{
+	CC_SAFE_RELEASE(m_pShadowMapVisitor);
+	CC_SAFE_RETAIN(visitor);
+	m_pShadowMapVisitor = visitor;
+}
+
 void CC3Scene::setDrawingSequenceVisitor( CC3NodeSequencerVisitor* visitor )
 {
 	CC_SAFE_RELEASE(m_pDrawingSequenceVisitor);
@@ -859,6 +1022,7 @@ void CC3Scene::updateDrawSequence()
 {
 	if (m_pDrawingSequencer && m_pDrawingSequencer->allowSequenceUpdates())
 	{
+		CC3_PROFILE_ZONE( "CC3NodeSequencer::updateSequence" );
 		m_pDrawingSequencer->updateSequenceWithVisitor( m_pDrawingSequenceVisitor );
 		//LogTrace(@"%@ updated %@", self, [_drawingSequencer fullDescription]);
 	}
@@ -871,6 +1035,9 @@ void CC3Scene::updateDrawSequence()
  */
 void CC3Scene::descendantDidModifySequencingCriteria( CC3Node* aNode )
 {
+	if ( CC3NodeUpdatingVisitor::deferSequencingNotification( aNode ) )
+		return;		// Resequenced after a parallel update completes
+
 	if (m_pDrawingSequencer)
 		if (m_pDrawingSequencer->remove( aNode, m_pDrawingSequenceVisitor))
 			m_pDrawingSequencer->add( aNode, m_pDrawingSequenceVisitor );
@@ -890,6 +1057,15 @@ CC3Scene* CC3Scene::getScene()
 void CC3Scene::didAddDescendant( CC3Node* aNode )
 {
 	//LogTrace(@"Adding %@ as descendant to %@", aNode, self);
+
+	if ( m_pNodeIndex )
+		m_pNodeIndex->addNode( aNode );
+
+	if ( m_pTransformStore )
+		m_pTransformStore->markStructureDirty();
+
+	if ( m_pBoundingVolumeHierarchy )
+		m_pBoundingVolumeHierarchy->markStructureDirty();
 	
 	// Collect all the nodes being added, including all descendants,
 	// and see if they require special treatment
@@ -932,6 +1108,16 @@ void CC3Scene::didAddDescendant( CC3Node* aNode )
 void CC3Scene::didRemoveDescendant( CC3Node* aNode )
 {
 	//LogTrace(@"Removing %@ as descendant of %@", aNode, self);
+
+	if ( m_pNodeIndex )
+		m_pNodeIndex->removeNode( aNode );
+
+	// Detach while the removed nodes are still alive
+	if ( m_pTransformStore )
+		m_pTransformStore->markStructureDirty();
+
+	if ( m_pBoundingVolumeHierarchy )
+		m_pBoundingVolumeHierarchy->markStructureDirty();
 	
 	// Collect all the nodes being removed, including all descendants,
 	// and see if they require special treatment
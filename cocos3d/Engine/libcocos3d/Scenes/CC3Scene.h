@@ -43,6 +43,7 @@ static const ccColor4F kCC3DefaultLightColorAmbientScene = { 0.2f, 0.2f, 0.2f, 1
 class CC3Layer;
 class CC3TouchedNodePicker;
 class CC3NodeSequencerVisitor;
+class CC3ShadowMapDrawingVisitor;
 
 /**
  * CC3Scene is a CC3Node that manages a 3D scene.
@@ -533,6 +534,84 @@ public:
 	CC3NodeUpdatingVisitor*		getUpdateVisitor();
 	void						setUpdateVisitor( CC3NodeUpdatingVisitor* visitor );
 
+	/**
+	 * Indicates whether the global transforms of the nodes in this scene are held in a flat
+	 * transform store, and rebuilt in a single linear pass once all nodes have been updated.
+	 *
+	 * Setting this property to YES can reduce the cost of building the global transforms of large
+	 * scenes. See the notes for the CC3NodeTransformStore class for more information.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUseTransformStore();
+	void						setShouldUseTransformStore( bool shouldUse );
+
+	/** The transform store holding the global transforms of the nodes in this scene, or NULL if not used. */
+	CC3NodeTransformStore*		getTransformStore();
+
+	/**
+	 * Indicates whether the nodes of this scene are held in a bounding volume hierarchy, so that
+	 * the drawing visitor can find the nodes that intersect the camera frustum, and the puncturing
+	 * visitor can find the nodes that are punctured by a ray, with hierarchical queries, instead
+	 * of testing each node individually.
+	 *
+	 * Setting this property to YES can reduce the cost of frustum culling and ray casting in large
+	 * scenes. The frustum query is only performed when the scene is drawn through a drawingSequencer,
+	 * and the ray query is only performed when the puncturing visitor is started on this scene.
+	 * See the notes for the CC3BoundingVolumeHierarchy class for more information.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUseBoundingVolumeHierarchy();
+	void						setShouldUseBoundingVolumeHierarchy( bool shouldUse );
+
+	/** The bounding volume hierarchy holding the nodes of this scene, or NULL if not used. */
+	CC3BoundingVolumeHierarchy*	getBoundingVolumeHierarchy();
+
+	/**
+	 * Indicates whether the viewDrawingVisitor records the nodes of this scene into a
+	 * CC3DrawCommandQueue, which is sorted by render state and executed with redundant
+	 * material and mesh bindings elided, instead of drawing each node as it is visited.
+	 *
+	 * Setting this property sets or clears the drawCommandQueue property of the current
+	 * viewDrawingVisitor. See the notes for the CC3DrawCommandQueue class for more information.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldUseDrawCommandQueue();
+	void						setShouldUseDrawCommandQueue( bool shouldUse );
+
+	/**
+	 * The CC3StaticBatcher used by the batchStaticMeshNodes and unbatchStaticMeshNodes methods to
+	 * merge the static mesh nodes of this scene into static batches.
+	 *
+	 * The initial value of this property is an instance of CC3StaticBatcher with default settings.
+	 */
+	CC3StaticBatcher*			getStaticBatcher();
+	void						setStaticBatcher( CC3StaticBatcher* batcher );
+
+	/**
+	 * Indicates whether the batchStaticMeshNodes method should be invoked automatically when this
+	 * scene is opened, after the initial transforms of the nodes have been established, and before
+	 * the onOpen method is invoked.
+	 *
+	 * The initial value of this property is NO.
+	 */
+	bool						shouldBatchStaticMeshesOnOpen();
+	void						setShouldBatchStaticMeshesOnOpen( bool shouldBatch );
+
+	/**
+	 * Merges the mesh nodes of this scene whose shouldBatchStatically property is set to YES into
+	 * static batches, using the staticBatcher, and returns the number of mesh nodes that were
+	 * merged. See the notes for the CC3StaticBatcher class for more information.
+	 *
+	 * This method creates GL buffers, and must be invoked on the rendering thread.
+	 */
+	GLuint						batchStaticMeshNodes();
+
+	/** Removes all static batches from this scene, and shows the mesh nodes that they batched. */
+	void						unbatchStaticMeshNodes();
+
 	/**
 	 * The value of this property is used as the lower limit accepted by the updateScene: method.
 	 * Values sent to the updateScene: method that are smaller than this maximum will be clamped
@@ -647,9 +726,10 @@ public:
 	 * on each frame rendering cycle. This method is invoked asynchronously to the model updating
 	 * to keep the processing of OpenGL ES drawing separate from model updates.
 	 *
-	 * This implementation establishes the 3D rendering environment, handles node picking, invokes
-	 * the drawSceneContentWithVisitor: method to draw the contents of this scene, reverts to the
-	 * 2D rendering environment of the CC3Layer, and renders any 2D overlay billboards.
+	 * This implementation establishes the 3D rendering environment, renders the shadow maps of
+	 * any lights that have them, handles node picking, invokes the drawSceneContentWithVisitor:
+	 * method to draw the contents of this scene, reverts to the 2D rendering environment of the
+	 * CC3Layer, and renders any 2D overlay billboards.
 	 *
 	 * If the scene was touched by the user (finger or mouse), this method invokes the node picking
 	 * algorithm to determine the node that is under the touch point. This is performed prior to
@@ -750,6 +830,16 @@ public:
 	 */
 	virtual void				drawShadowsWithVisitor( CC3NodeDrawingVisitor* visitor );
 
+	/**
+	 * Template method that renders the shadow map of each light that has one, from the point of
+	 * view of the camera of the specified visitor, using the shadowMapVisitor.
+	 *
+	 * This method is invoked from the drawSceneWithVisitor: method, before the scene content is
+	 * drawn, so that the shadow maps are available to the shaders that draw the scene content.
+	 * Environment map renders reuse the shadow maps rendered for the main camera.
+	 */
+	virtual void				drawShadowMapsWithVisitor( CC3NodeDrawingVisitor* visitor );
+
 	/**
 	 * Template method that turns on lighting of the 3D scene.
 	 *
@@ -829,6 +919,16 @@ public:
 	CC3NodeDrawingVisitor*		getShadowVisitor();
 	void						setShadowVisitor( CC3NodeDrawingVisitor* visitor );
 
+	/**
+	 * The visitor that is used to render the depth of shadow casters into the shadow map of each
+	 * light whose shadowMap property is set.
+	 *
+	 * If not set directly, the first time it is accessed, a new CC3ShadowMapDrawingVisitor
+	 * will be created and set into this property.
+	 */
+	CC3ShadowMapDrawingVisitor*	getShadowMapVisitor();
+	void						setShadowMapVisitor( CC3ShadowMapDrawingVisitor* visitor );
+
 	/**
 	 * The sequencer visitor used to visit the drawing sequencer during operations
 	 * on the drawing sequencer, such as adding or removing individual nodes.
@@ -1129,9 +1229,13 @@ protected:
 	CC3TouchedNodePicker*		m_pTouchedNodePicker;
 	CC3PerformanceStatistics*	m_pPerformanceStatistics;
 	CC3NodeUpdatingVisitor*		m_pUpdateVisitor;
+	CC3NodeTransformStore*		m_pTransformStore;
+	CC3BoundingVolumeHierarchy*	m_pBoundingVolumeHierarchy;
+	CC3StaticBatcher*			m_pStaticBatcher;
 	CC3NodeDrawingVisitor*		m_pViewDrawingVisitor;
 	CC3NodeDrawingVisitor*		m_pEnvMapDrawingVisitor;
 	CC3NodeDrawingVisitor*		m_pShadowVisitor;
+	CC3ShadowMapDrawingVisitor*	m_pShadowMapVisitor;
 	CC3NodeSequencerVisitor*	m_pDrawingSequenceVisitor;
 	CC3MeshNode*				m_pBackdrop;
 	CC3Fog*						m_pFog;
@@ -1142,6 +1246,7 @@ protected:
 	float						m_maxUpdateInterval;
 	float						m_deltaFrameTime;
 	bool						m_shouldDisplayPickingRender : 1;
+	bool						m_shouldBatchStaticMeshesOnOpen : 1;
 };
 
 /** The max length of the queue that tracks touch events. */
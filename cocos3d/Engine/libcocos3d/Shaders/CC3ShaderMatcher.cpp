@@ -95,6 +95,9 @@ std::string CC3ShaderMatcherBase::vertexShaderFileForMeshNode( CC3MeshNode* aMes
 	
 	if (aMeshNode->isDrawingPointSprites()) 
 		return "CC3PointSprites.vsh";
+
+	if (aMeshNode->isDrawingInstances()) 
+		return "CC3TexturableInstanced.vsh";
 		
 	return "CC3Texturable.vsh";
 }
@@ -47,6 +47,9 @@ std::string stringFromCC3Semantic(CC3Semantic semantic)
 		case kCC3SemanticVertexBoneWeights: return "kCC3SemanticVertexBoneWeights";
 		case kCC3SemanticVertexBoneIndices: return "kCC3SemanticVertexBoneIndices";
 		case kCC3SemanticVertexTexture: return "kCC3SemanticVertexTexture";
+		case kCC3SemanticVertexInstanceTransform: return "kCC3SemanticVertexInstanceTransform";
+		case kCC3SemanticVertexInstanceColor: return "kCC3SemanticVertexInstanceColor";
+		case kCC3SemanticVertexInstanceIndex: return "kCC3SemanticVertexInstanceIndex";
 			
 		case kCC3SemanticHasVertexNormal: return "kCC3SemanticHasVertexNormal";
 		case kCC3SemanticShouldNormalizeVertexNormal: return "kCC3SemanticShouldNormalizeVertexNormal";
@@ -61,6 +64,10 @@ std::string stringFromCC3Semantic(CC3Semantic semantic)
 		case kCC3SemanticIsDrawingPoints: return "kCC3SemanticIsDrawingPoints";
 		case kCC3SemanticShouldDrawFrontFaces: return "kCC3SemanticShouldDrawFrontFaces";
 		case kCC3SemanticShouldDrawBackFaces: return "kCC3SemanticShouldDrawBackFaces";
+		case kCC3SemanticVertexLocationDequantizeScale: return "kCC3SemanticVertexLocationDequantizeScale";
+		case kCC3SemanticVertexLocationDequantizeOffset: return "kCC3SemanticVertexLocationDequantizeOffset";
+		case kCC3SemanticVertexTextureDequantizeScale: return "kCC3SemanticVertexTextureDequantizeScale";
+		case kCC3SemanticVertexTextureDequantizeOffset: return "kCC3SemanticVertexTextureDequantizeOffset";
 
 			// ENVIRONMENT MATRICES --------------
 		case kCC3SemanticModelLocalMatrix: return "kCC3SemanticModelLocalMatrix";
@@ -130,6 +137,14 @@ std::string stringFromCC3Semantic(CC3Semantic semantic)
 		case kCC3SemanticLightProbeLocationEyeSpace: return "kCC3SemanticLightProbeLocationEyeSpace";
 		case kCC3SemanticLightProbeLocationModelSpace: return "kCC3SemanticLightProbeLocationModelSpace";
 		case kCC3SemanticLightProbeColorDiffuse: return "kCC3SemanticLightProbeColorDiffuse";
+
+		case kCC3SemanticShadowMapIsEnabled: return "kCC3SemanticShadowMapIsEnabled";
+		case kCC3SemanticShadowMapIntensity: return "kCC3SemanticShadowMapIntensity";
+		case kCC3SemanticShadowMapDepthBias: return "kCC3SemanticShadowMapDepthBias";
+		case kCC3SemanticShadowMapCascadeCount: return "kCC3SemanticShadowMapCascadeCount";
+		case kCC3SemanticShadowMapSplitDistances: return "kCC3SemanticShadowMapSplitDistances";
+		case kCC3SemanticShadowMapTexelSize: return "kCC3SemanticShadowMapTexelSize";
+		case kCC3SemanticShadowMapMatrices: return "kCC3SemanticShadowMapMatrices";
 			
 		case kCC3SemanticFogIsEnabled: return "kCC3SemanticFogIsEnabled";
 		case kCC3SemanticFogColor: return "kCC3SemanticFogColor";
@@ -146,6 +161,7 @@ std::string stringFromCC3Semantic(CC3Semantic semantic)
 		case kCC3SemanticTextureCubeCount: return "kCC3SemanticTextureCubeCount";
 		case kCC3SemanticTextureCubeSampler: return "kCC3SemanticTextureCubeSampler";
 		case kCC3SemanticTextureLightProbeSampler: return "kCC3SemanticTextureLightProbeSampler";
+		case kCC3SemanticTextureShadowMapSampler: return "kCC3SemanticTextureShadowMapSampler";
 			
 		case kCC3SemanticTexUnitMode: return "kCC3SemanticTexUnitMode";
 		case kCC3SemanticTexUnitConstantColor: return "kCC3SemanticTexUnitConstantColor";
@@ -171,6 +187,11 @@ std::string stringFromCC3Semantic(CC3Semantic semantic)
 		case kCC3SemanticBoundingBoxMax: return "kCC3SemanticBoundingBoxMax";
 		case kCC3SemanticBoundingBoxSize: return "kCC3SemanticBoundingBoxSize";
 		case kCC3SemanticBoundingRadius: return "kCC3SemanticBoundingRadius";
+
+		// INSTANCES ------------
+		case kCC3SemanticInstanceBatchCount: return "kCC3SemanticInstanceBatchCount";
+		case kCC3SemanticInstanceTransforms: return "kCC3SemanticInstanceTransforms";
+		case kCC3SemanticInstanceColors: return "kCC3SemanticInstanceColors";
 			
 		// BONE SKINNING
 		case kCC3SemanticVertexBoneCount: return "kCC3SemanticVertexBoneCount";
@@ -305,6 +326,10 @@ CC3GLSLVariableScope CC3ShaderSemanticsBase::getVariableScopeForSemantic( GLenum
 
 		case kCC3SemanticBatchBoneCount:
 
+		case kCC3SemanticInstanceBatchCount:
+		case kCC3SemanticInstanceTransforms:
+		case kCC3SemanticInstanceColors:
+
 		case kCC3SemanticBoneMatricesGlobal:
 		case kCC3SemanticBoneMatricesInvTranGlobal:
 		case kCC3SemanticBoneMatricesEyeSpace:
@@ -359,6 +384,14 @@ CC3GLSLVariableScope CC3ShaderSemanticsBase::getVariableScopeForSemantic( GLenum
 		case kCC3SemanticLightSpotCutoffAngle:
 		case kCC3SemanticLightSpotCutoffAngleCosine:
 
+		case kCC3SemanticShadowMapIsEnabled:
+		case kCC3SemanticShadowMapIntensity:
+		case kCC3SemanticShadowMapDepthBias:
+		case kCC3SemanticShadowMapCascadeCount:
+		case kCC3SemanticShadowMapSplitDistances:
+		case kCC3SemanticShadowMapTexelSize:
+		case kCC3SemanticShadowMapMatrices:
+
 		case kCC3SemanticFogIsEnabled:
 		case kCC3SemanticFogColor:
 		case kCC3SemanticFogAttenuationMode:
@@ -398,13 +431,16 @@ bool CC3ShaderSemanticsBase::populateUniform( CC3GLSLUniform* uniform, CC3NodeDr
 	
 	CC3Material* mat;
 	CC3PointParticleEmitter* emitter;
+	CC3InstancedMeshNode* instancedNode;
+	CC3ShadowMap* shadowMap;
+	CC3VertexArray* vtxArray;
 	CC3Matrix4x4 m4x4;
 	CC3Matrix4x3 m4x3,  mRslt4x3, tfmMtx;
 	const CC3Matrix4x3 *pm4x3;
 	CC3Matrix3x3 m3x3;
 	CC3Viewport vp;
 	float sceneTime;
-	GLuint boneCnt = 0, tuCnt = 0, texCnt = 0;
+	GLuint boneCnt = 0, tuCnt = 0, texCnt = 0, instCnt = 0;
 	bool isInverted = false, isPtEmitter = false;
 	
 	CC3Mesh* currentMesh = visitor->getCurrentMesh();
@@ -460,6 +496,30 @@ bool CC3ShaderSemanticsBase::populateUniform( CC3GLSLUniform* uniform, CC3NodeDr
 		case kCC3SemanticShouldDrawBackFaces:
 			uniform->setBoolean( !visitor->getCurrentMeshNode()->shouldCullBackFaces() );
 			return true;
+		case kCC3SemanticVertexLocationDequantizeScale:
+			vtxArray = currentMesh ? currentMesh->getVertexLocations() : NULL;
+			uniform->setVector( vtxArray ? vtxArray->getDequantizationScale() : CC3Vector::kCC3VectorUnitCube );
+			return true;
+		case kCC3SemanticVertexLocationDequantizeOffset:
+			vtxArray = currentMesh ? currentMesh->getVertexLocations() : NULL;
+			uniform->setVector( vtxArray ? vtxArray->getDequantizationOffset() : CC3Vector::kCC3VectorZero );
+			return true;
+		case kCC3SemanticVertexTextureDequantizeScale:
+			for (GLint i = 0; i < uniformSize; i++) 
+			{
+				vtxArray = currentMesh ? currentMesh->getTextureCoordinatesForTextureUnit( semanticIndex + i ) : NULL;
+				CC3Vector scale = vtxArray ? vtxArray->getDequantizationScale() : CC3Vector::kCC3VectorUnitCube;
+				uniform->setPoint( ccp(scale.x, scale.y), i );
+			}
+			return true;
+		case kCC3SemanticVertexTextureDequantizeOffset:
+			for (GLint i = 0; i < uniformSize; i++) 
+			{
+				vtxArray = currentMesh ? currentMesh->getTextureCoordinatesForTextureUnit( semanticIndex + i ) : NULL;
+				CC3Vector offset = vtxArray ? vtxArray->getDequantizationOffset() : CC3Vector::kCC3VectorZero;
+				uniform->setPoint( ccp(offset.x, offset.y), i );
+			}
+			return true;
 
 		// ENVIRONMENT MATRICES --------------
 		case kCC3SemanticModelLocalMatrix:
@@ -1064,6 +1124,62 @@ bool CC3ShaderSemanticsBase::populateUniform( CC3GLSLUniform* uniform, CC3NodeDr
 				uniform->setColor4F( lpColor, i );
 			}
 			return true;
+
+		case kCC3SemanticShadowMapIsEnabled:
+			for (GLint i = 0; i < uniformSize; i++)
+			{
+				CC3Light* light = visitor->getLightAt( semanticIndex + i );
+				shadowMap = light ? light->getShadowMap() : NULL;
+				uniform->setBoolean( shadowMap && shadowMap->isReady(), i );
+			}
+			return true;
+		case kCC3SemanticShadowMapIntensity:
+			for (GLint i = 0; i < uniformSize; i++)
+			{
+				CC3Light* light = visitor->getLightAt( semanticIndex + i );
+				uniform->setFloat( light ? CLAMP(light->getShadowIntensityFactor(), 0.0f, 1.0f) : 0.0f, i );
+			}
+			return true;
+		case kCC3SemanticShadowMapDepthBias:
+			for (GLint i = 0; i < uniformSize; i++)
+			{
+				CC3Light* light = visitor->getLightAt( semanticIndex + i );
+				shadowMap = light ? light->getShadowMap() : NULL;
+				uniform->setFloat( shadowMap ? shadowMap->getDepthBias() : 0.0f, i );
+			}
+			return true;
+		case kCC3SemanticShadowMapCascadeCount:
+			{
+				CC3Light* light = visitor->getLightAt( semanticIndex );
+				shadowMap = light ? light->getShadowMap() : NULL;
+				uniform->setInteger( shadowMap ? shadowMap->getActiveCascadeCount() : 0 );
+			}
+			return true;
+		case kCC3SemanticShadowMapSplitDistances:
+			{
+				CC3Light* light = visitor->getLightAt( semanticIndex );
+				shadowMap = light ? light->getShadowMap() : NULL;
+				uniform->setVector4( shadowMap ? shadowMap->getSplitDistances() : CC3Vector4::kCC3Vector4Zero );
+			}
+			return true;
+		case kCC3SemanticShadowMapTexelSize:
+			{
+				CC3Light* light = visitor->getLightAt( semanticIndex );
+				shadowMap = light ? light->getShadowMap() : NULL;
+				uniform->setPoint( shadowMap ? shadowMap->getTexelSize() : CCPointZero );
+			}
+			return true;
+		case kCC3SemanticShadowMapMatrices:
+			{
+				// One matrix per cascade of the shadow map of a single light
+				CC3Light* light = visitor->getLightAt( semanticIndex );
+				shadowMap = light ? light->getShadowMap() : NULL;
+				if ( !shadowMap )
+					return true;
+				for (GLint i = 0; i < uniformSize; i++)
+					uniform->setMatrix4x4( shadowMap->getShadowMatrixAt( i ), i );
+			}
+			return true;
 			
 		case kCC3SemanticFogIsEnabled:
 			{
@@ -1172,6 +1288,15 @@ bool CC3ShaderSemanticsBase::populateUniform( CC3GLSLUniform* uniform, CC3NodeDr
 				uniform->setInteger( semanticIndex + i, i );
 			return true;
 			
+		case kCC3SemanticTextureShadowMapSampler:
+			// Shadow map samplers always come after the light probe samplers, and are consecutive,
+			// one per light, so we can simply use consecutive texture unit indices starting at the
+			// semanticIndex of the uniform, plus an offset to skip the model and light probe textures.
+			semanticIndex += visitor->getCurrentShaderProgram()->getTextureShadowMapStart();
+			for (GLint i = 0; i < uniformSize; i++) 
+				uniform->setInteger( semanticIndex + i, i );
+			return true;
+			
 		// The semantics below mimic OpenGL ES 1.1 configuration functionality for combining texture units.
 		// In most shaders, these will be left unused in favor of customized the texture combining in code.
 		case kCC3SemanticTexUnitMode:
@@ -1209,6 +1334,24 @@ bool CC3ShaderSemanticsBase::populateUniform( CC3GLSLUniform* uniform, CC3NodeDr
 			uniform->setFloat( visitor->getCurrentMeshNode()->animationTimeOnTrack(0) );
 			return true;
 
+		// INSTANCES ------------
+		case kCC3SemanticInstanceBatchCount:
+			instancedNode = dynamic_cast<CC3InstancedMeshNode*>(visitor->getCurrentMeshNode());
+			uniform->setInteger( instancedNode ? instancedNode->getBatchInstanceCount() : 0 );
+			return true;
+		case kCC3SemanticInstanceTransforms:
+			instancedNode = dynamic_cast<CC3InstancedMeshNode*>(visitor->getCurrentMeshNode());
+			instCnt = instancedNode ? instancedNode->getBatchInstanceCount() : 0;
+			for (GLint i = 0; i < uniformSize && (GLuint)(i / 3) < instCnt; i++)
+				uniform->setVector4( instancedNode->getBatchInstances()[i / 3].transformRows[i % 3], i );
+			return true;
+		case kCC3SemanticInstanceColors:
+			instancedNode = dynamic_cast<CC3InstancedMeshNode*>(visitor->getCurrentMeshNode());
+			instCnt = instancedNode ? instancedNode->getBatchInstanceCount() : 0;
+			for (GLint i = 0; i < uniformSize && (GLuint)i < instCnt; i++)
+				uniform->setColor4B( instancedNode->getBatchInstances()[i].color, i );
+			return true;
+
 		// PARTICLES ------------
 		case kCC3SemanticPointSize: {
 			emitter = dynamic_cast<CC3PointParticleEmitter*>(visitor->getCurrentNode());
@@ -1490,6 +1633,12 @@ void CC3ShaderSemanticsByVarName::populateWithDefaultVariableNameMappings()
 	GLuint maxTexUnits = CC3OpenGL::sharedGL()->getMaxNumberOfTextureUnits();
 	for (GLuint tuIdx = 0; tuIdx < maxTexUnits; tuIdx++)
 		mapVarName( CC3String::stringWithFormat( (char*)"a_cc3TexCoord%d", tuIdx ), kCC3SemanticVertexTexture, tuIdx );	/**< Vertex texture coordinate for a texture unit. */
+
+	mapVarName( "a_cc3InstanceTransformRow0", kCC3SemanticVertexInstanceTransform, 0 );	/**< First row of the transform of an instance. */
+	mapVarName( "a_cc3InstanceTransformRow1", kCC3SemanticVertexInstanceTransform, 1 );	/**< Second row of the transform of an instance. */
+	mapVarName( "a_cc3InstanceTransformRow2", kCC3SemanticVertexInstanceTransform, 2 );	/**< Third row of the transform of an instance. */
+	mapVarName( "a_cc3InstanceColor", kCC3SemanticVertexInstanceColor );				/**< Color of an instance. */
+	mapVarName( "a_cc3InstanceIndex", kCC3SemanticVertexInstanceIndex );				/**< Index of the instance within the current uniform batch. */
 	
 	// VERTEX STATE --------------
 	mapVarName( "u_cc3VertexHasNormal", kCC3SemanticHasVertexNormal );							/**< (bool) Whether a vertex normal is available. */
@@ -1504,6 +1653,10 @@ void CC3ShaderSemanticsByVarName::populateWithDefaultVariableNameMappings()
 	mapVarName( "u_cc3VertexShouldRescaleNormal", kCC3SemanticShouldRescaleVertexNormal );		/**< (bool) Whether vertex normals should be rescaled. */
 	mapVarName( "u_cc3VertexShouldDrawFrontFaces", kCC3SemanticShouldDrawFrontFaces );			/**< (bool) Whether the front side of each face is to be drawn. */
 	mapVarName( "u_cc3VertexShouldDrawBackFaces", kCC3SemanticShouldDrawBackFaces );			/**< (bool) Whether the back side of each face is to be drawn. */
+	mapVarName( "u_cc3VertexLocationScale", kCC3SemanticVertexLocationDequantizeScale );		/**< (vec3) Scale applied to normalized quantized vertex locations. */
+	mapVarName( "u_cc3VertexLocationOffset", kCC3SemanticVertexLocationDequantizeOffset );		/**< (vec3) Offset added to scaled quantized vertex locations. */
+	mapVarName( "u_cc3VertexTexCoordScale", kCC3SemanticVertexTextureDequantizeScale );		/**< (vec2[]) Scale applied to normalized quantized texture coordinates for each texture unit. */
+	mapVarName( "u_cc3VertexTexCoordOffset", kCC3SemanticVertexTextureDequantizeOffset );		/**< (vec2[]) Offset added to scaled quantized texture coordinates for each texture unit. */
 	
 	// ENVIRONMENT MATRICES --------------
 	mapVarName( "u_cc3MatrixModelLocal", kCC3SemanticModelLocalMatrix );						/**< (mat4) Current model-to-parent matrix. */
@@ -1602,6 +1755,14 @@ void CC3ShaderSemanticsByVarName::populateWithDefaultVariableNameMappings()
 	mapVarName( "u_cc3LightProbeLocationEyeSpace", kCC3SemanticLightProbeLocationEyeSpace );		/**< (vec3[]) Location of each light probe in eye space. */
 	mapVarName( "u_cc3LightProbeLocationModelSpace", kCC3SemanticLightProbeLocationModelSpace );	/**< (vec3[]) Location of each light probe in local coordinates of the model (not light probe). */
 	mapVarName( "u_cc3LightProbeColorDiffuse", kCC3SemanticLightProbeColorDiffuse );				/**< (vec4) Diffuse color of each light probe. */
+
+	mapVarName( "u_cc3ShadowMapIsEnabled", kCC3SemanticShadowMapIsEnabled );				/**< (bool[]) Whether each light has a shadow map that was rendered for the current frame. */
+	mapVarName( "u_cc3ShadowMapIntensity", kCC3SemanticShadowMapIntensity );				/**< (float[]) Fraction of the light of each light that is blocked within its shadows. */
+	mapVarName( "u_cc3ShadowMapDepthBias", kCC3SemanticShadowMapDepthBias );				/**< (float[]) Depth bias for the shadow map of each light. */
+	mapVarName( "u_cc3ShadowMapCascadeCount", kCC3SemanticShadowMapCascadeCount );		/**< (int) Number of cascades in the shadow map of the first light. */
+	mapVarName( "u_cc3ShadowMapSplitDistances", kCC3SemanticShadowMapSplitDistances );	/**< (vec4) Eye-space depth at which each cascade of the shadow map of the first light ends. */
+	mapVarName( "u_cc3ShadowMapTexelSize", kCC3SemanticShadowMapTexelSize );				/**< (vec2) Size of a texel of the shadow map of the first light. */
+	mapVarName( "u_cc3ShadowMapMatrices", kCC3SemanticShadowMapMatrices );				/**< (mat4[]) Eye-space to shadow map matrix of each cascade of the first light. */
 	
 	mapVarName( "u_cc3FogIsEnabled", kCC3SemanticFogIsEnabled );				/**< (bool) Whether scene fogging is enabled. */
 	mapVarName( "u_cc3FogColor", kCC3SemanticFogColor );						/**< (vec4) Fog color. */
@@ -1626,6 +1787,9 @@ void CC3ShaderSemanticsByVarName::populateWithDefaultVariableNameMappings()
 	mapVarName( "s_cc3LightProbeTexture", kCC3SemanticTextureLightProbeSampler );		/**< (samplerCube or sampler2D) Single light probe texture sampler. */
 	mapVarName( "s_cc3LightProbeTextures", kCC3SemanticTextureLightProbeSampler );		/**< (samplerCube[] or sampler2D[]) Array of light probe texture samplers. */
 
+	mapVarName( "s_cc3ShadowMapTexture", kCC3SemanticTextureShadowMapSampler );		/**< (sampler2D) Shadow map depth texture sampler of the first light. */
+	mapVarName( "s_cc3ShadowMapTextures", kCC3SemanticTextureShadowMapSampler );		/**< (sampler2D[]) Array of shadow map depth texture samplers, one per light. */
+
 	// The semantics below mimic OpenGL ES 1.1 configuration functionality for combining texture units.
 	// In most shaders, these will be left unused in favor of customized the texture combining in GLSL code.
 	mapVarName( "u_cc3TextureUnitColor", kCC3SemanticTexUnitConstantColor );						/**< (vec4[]) The constant color of each texture unit. */
@@ -1653,6 +1817,11 @@ void CC3ShaderSemanticsByVarName::populateWithDefaultVariableNameMappings()
 	mapVarName( "u_cc3ModelBoundingBoxSize", kCC3SemanticBoundingBoxSize );		/**< (float) The radius of the model's bounding sphere in the model's local coordinates. */
 	mapVarName( "u_cc3ModelAnimationFraction", kCC3SemanticAnimationFraction );	/**< (float) Fraction of the model's animation that has been viewed (range 0-1). */
 	
+	// INSTANCES ------------
+	mapVarName( "u_cc3InstanceBatchCount", kCC3SemanticInstanceBatchCount );		/**< (int) Number of instances in the current uniform batch (zero if using instance attributes). */
+	mapVarName( "u_cc3InstanceTransforms", kCC3SemanticInstanceTransforms );		/**< (vec4[]) Rows of the transforms of the instances in the current uniform batch. */
+	mapVarName( "u_cc3InstanceColors", kCC3SemanticInstanceColors );				/**< (vec4[]) Colors of the instances in the current uniform batch. */
+	
 	// PARTICLES ------------
 	mapVarName( "u_cc3IsDrawingPoints", kCC3SemanticIsDrawingPoints );						/**< (bool) Whether the vertices are being drawn as points. */
 	mapVarName( "u_cc3PointSize", kCC3SemanticPointSize );									/**< (float) Default size of points, if not specified per-vertex in a vertex attribute array. */
@@ -1699,6 +1868,12 @@ void CC3ShaderSemanticsByVarName::populateWithStructuredVariableNameMappings()
 	GLuint maxTexUnits = CC3OpenGL::sharedGL()->getMaxNumberOfTextureUnits();
 	for (GLuint tuIdx = 0; tuIdx < maxTexUnits; tuIdx++)
 		mapVarName( CC3String::stringWithFormat( (char*)"a_cc3TexCoord%u", tuIdx ), kCC3SemanticVertexTexture, tuIdx );	/**< Vertex texture coordinate for a texture unit. */
+
+	mapVarName( "a_cc3InstanceTransformRow0", kCC3SemanticVertexInstanceTransform, 0 );	/**< First row of the transform of an instance. */
+	mapVarName( "a_cc3InstanceTransformRow1", kCC3SemanticVertexInstanceTransform, 1 );	/**< Second row of the transform of an instance. */
+	mapVarName( "a_cc3InstanceTransformRow2", kCC3SemanticVertexInstanceTransform, 2 );	/**< Third row of the transform of an instance. */
+	mapVarName( "a_cc3InstanceColor", kCC3SemanticVertexInstanceColor );				/**< Color of an instance. */
+	mapVarName( "a_cc3InstanceIndex", kCC3SemanticVertexInstanceIndex );				/**< Index of the instance within the current uniform batch. */
 	
 	// VERTEX STATE --------------
 	mapVarName( "u_cc3Vertex.hasVertexNormal", kCC3SemanticHasVertexNormal );					/**< (bool) Whether a vertex normal is available. */
@@ -1712,6 +1887,10 @@ void CC3ShaderSemanticsByVarName::populateWithStructuredVariableNameMappings()
 	mapVarName( "u_cc3Vertex.isDrawingPoints", kCC3SemanticIsDrawingPoints );					/**< (bool) Whether the vertices are being drawn as points. */
 	mapVarName( "u_cc3Vertex.shouldNormalizeNormal", kCC3SemanticShouldNormalizeVertexNormal );	/**< (bool) Whether vertex normals should be normalized. */
 	mapVarName( "u_cc3Vertex.shouldRescaleNormal", kCC3SemanticShouldRescaleVertexNormal );	/**< (bool) Whether vertex normals should be rescaled. */
+	mapVarName( "u_cc3Vertex.locationScale", kCC3SemanticVertexLocationDequantizeScale );		/**< (vec3) Scale applied to normalized quantized vertex locations. */
+	mapVarName( "u_cc3Vertex.locationOffset", kCC3SemanticVertexLocationDequantizeOffset );	/**< (vec3) Offset added to scaled quantized vertex locations. */
+	mapVarName( "u_cc3Vertex.texCoordScale", kCC3SemanticVertexTextureDequantizeScale );		/**< (vec2[]) Scale applied to normalized quantized texture coordinates for each texture unit. */
+	mapVarName( "u_cc3Vertex.texCoordOffset", kCC3SemanticVertexTextureDequantizeOffset );	/**< (vec2[]) Offset added to scaled quantized texture coordinates for each texture unit. */
 	
 	// ENVIRONMENT MATRICES --------------
 	mapVarName( "u_cc3Matrices.modelLocal", kCC3SemanticModelLocalMatrix );					/**< (mat4) Current model-to-parent matrix. */
@@ -1784,6 +1963,14 @@ void CC3ShaderSemanticsByVarName::populateWithStructuredVariableNameMappings()
 	mapVarName( "u_cc3Lighting.spotExponent", kCC3SemanticLightSpotExponent );						/**< (float[]) Fade-off exponent of each spotlight. */
 	mapVarName( "u_cc3Lighting.spotCutoffAngle", kCC3SemanticLightSpotCutoffAngle );				/**< (float[]) Cutoff angle of each spotlight (degrees). */
 	mapVarName( "u_cc3Lighting.spotCutoffAngleCosine", kCC3SemanticLightSpotCutoffAngleCosine );	/**< (float[]) Cosine of cutoff angle of each spotlight. */
+
+	mapVarName( "u_cc3ShadowMap.isEnabled", kCC3SemanticShadowMapIsEnabled );				/**< (bool[]) Whether each light has a shadow map that was rendered for the current frame. */
+	mapVarName( "u_cc3ShadowMap.intensity", kCC3SemanticShadowMapIntensity );				/**< (float[]) Fraction of the light of each light that is blocked within its shadows. */
+	mapVarName( "u_cc3ShadowMap.depthBias", kCC3SemanticShadowMapDepthBias );				/**< (float[]) Depth bias for the shadow map of each light. */
+	mapVarName( "u_cc3ShadowMap.cascadeCount", kCC3SemanticShadowMapCascadeCount );		/**< (int) Number of cascades in the shadow map of the first light. */
+	mapVarName( "u_cc3ShadowMap.splitDistances", kCC3SemanticShadowMapSplitDistances );	/**< (vec4) Eye-space depth at which each cascade of the shadow map of the first light ends. */
+	mapVarName( "u_cc3ShadowMap.texelSize", kCC3SemanticShadowMapTexelSize );				/**< (vec2) Size of a texel of the shadow map of the first light. */
+	mapVarName( "u_cc3ShadowMap.matrices", kCC3SemanticShadowMapMatrices );				/**< (mat4[]) Eye-space to shadow map matrix of each cascade of the first light. */
 	
 	mapVarName( "u_cc3Fog.isEnabled", kCC3SemanticFogIsEnabled );				/**< (bool) Whether scene fogging is enabled. */
 	mapVarName( "u_cc3Fog.color", kCC3SemanticFogColor );						/**< (vec4) Fog color. */
@@ -1796,6 +1983,7 @@ void CC3ShaderSemanticsByVarName::populateWithStructuredVariableNameMappings()
 	mapVarName( "u_cc3TextureCount", kCC3SemanticTextureCount );	/**< (int) Number of active textures. */
 	mapVarName( "s_cc3Texture", kCC3SemanticTextureSampler );		/**< (sampler2D) Single texture sampler (texture unit 0). */
 	mapVarName( "s_cc3Textures", kCC3SemanticTextureSampler );		/**< (sampler2D[]) Array of texture samplers. */
+	mapVarName( "s_cc3ShadowMapTextures", kCC3SemanticTextureShadowMapSampler );	/**< (sampler2D[]) Array of shadow map depth texture samplers, one per light. */
 	
 	// The semantics below mimic OpenGL ES 1.1 configuration functionality for combining texture units.
 	// In most shaders, these will be left unused in favor of customized the texture combining in GLSL code.
@@ -1824,6 +2012,11 @@ void CC3ShaderSemanticsByVarName::populateWithStructuredVariableNameMappings()
 	mapVarName( "u_cc3Model.boundingBoxSize", kCC3SemanticBoundingBoxSize );		/**< (float) The radius of the model's bounding sphere in the model's local coordinates. */
 	mapVarName( "u_cc3Model.animationFraction", kCC3SemanticAnimationFraction );	/**< (float) Fraction of the model's animation that has been viewed (range 0-1). */
 	
+	// INSTANCES ------------
+	mapVarName( "u_cc3Instances.batchCount", kCC3SemanticInstanceBatchCount );	/**< (int) Number of instances in the current uniform batch (zero if using instance attributes). */
+	mapVarName( "u_cc3Instances.transforms", kCC3SemanticInstanceTransforms );	/**< (vec4[]) Rows of the transforms of the instances in the current uniform batch. */
+	mapVarName( "u_cc3Instances.colors", kCC3SemanticInstanceColors );			/**< (vec4[]) Colors of the instances in the current uniform batch. */
+	
 	// PARTICLES ------------
 	mapVarName( "u_cc3Points.isDrawingPoints", kCC3SemanticIsDrawingPoints );				/**< (bool) Whether the vertices are being drawn as points (alias for u_cc3IsDrawingPoints). */
 	mapVarName( "u_cc3Points.hasVertexPointSize", kCC3SemanticHasVertexPointSize );		/**< (bool) Whether the vertex point size is available (alias for u_cc3HasVertexPointSize). */
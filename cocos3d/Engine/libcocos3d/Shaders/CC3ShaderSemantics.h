@@ -70,6 +70,9 @@ typedef enum {
 	kCC3SemanticVertexBoneIndices,				/**< Vertex skinning bone indices. */
 	kCC3SemanticVertexPointSize,				/**< Vertex point size. */
 	kCC3SemanticVertexTexture,					/**< Vertex texture coordinate for one texture unit. */
+	kCC3SemanticVertexInstanceTransform,		/**< Row of the transform of an instance, relative to the instanced mesh node (semantic index 0-2). */
+	kCC3SemanticVertexInstanceColor,			/**< Color of an instance. */
+	kCC3SemanticVertexInstanceIndex,			/**< Index of the instance within the current batch, when instances are drawn in uniform batches. */
 	
 	kCC3SemanticHasVertexNormal,				/**< (bool) Whether a vertex normal is available. */
 	kCC3SemanticShouldNormalizeVertexNormal,	/**< (bool) Whether vertex normals should be normalized. */
@@ -84,6 +87,10 @@ typedef enum {
 	kCC3SemanticIsDrawingPoints,				/**< (bool) Whether the vertices are being drawn as points. */
 	kCC3SemanticShouldDrawFrontFaces,			/**< (bool) Whether the front side of each face is to be drawn. */
 	kCC3SemanticShouldDrawBackFaces,			/**< (bool) Whether the back side of each face is to be drawn. */
+	kCC3SemanticVertexLocationDequantizeScale,	/**< (vec3) Scale applied to normalized quantized vertex locations (unit scale if not quantized). */
+	kCC3SemanticVertexLocationDequantizeOffset,	/**< (vec3) Offset added to scaled quantized vertex locations (zero if not quantized). */
+	kCC3SemanticVertexTextureDequantizeScale,	/**< (vec2[]) Scale applied to normalized quantized texture coordinates for each texture unit. */
+	kCC3SemanticVertexTextureDequantizeOffset,	/**< (vec2[]) Offset added to scaled quantized texture coordinates for each texture unit. */
 	
 	// ENVIRONMENT MATRICES --------------
 	kCC3SemanticModelLocalMatrix,				/**< (mat4) Current model-to-parent matrix. */
@@ -185,6 +192,14 @@ typedef enum {
 	kCC3SemanticLightProbeLocationModelSpace,	/**< (vec3[]) Location of each light probe in local coordinates of the model (not light probe). */
 	kCC3SemanticLightProbeColorDiffuse,			/**< (vec4) Diffuse color of each light probe. */
 
+	kCC3SemanticShadowMapIsEnabled,				/**< (bool[]) Whether each light has a shadow map that was rendered for the current frame. */
+	kCC3SemanticShadowMapIntensity,				/**< (float[]) Fraction of the light of each light that is blocked within its shadows (0.0 - 1.0). */
+	kCC3SemanticShadowMapDepthBias,				/**< (float[]) Depth bias subtracted before comparing depths against the shadow map of each light. */
+	kCC3SemanticShadowMapCascadeCount,			/**< (int) Number of cascades in the shadow map of the light. */
+	kCC3SemanticShadowMapSplitDistances,		/**< (vec4) Eye-space depth at which each cascade of the shadow map of the light ends. */
+	kCC3SemanticShadowMapTexelSize,				/**< (vec2) Size of a texel of the shadow map of the light, in texture coordinates. */
+	kCC3SemanticShadowMapMatrices,				/**< (mat4[]) Matrices transforming eye space to the texture coordinates and depth of each cascade of the shadow map of the light. */
+
 	kCC3SemanticFogIsEnabled,					/**< (bool) Whether scene fogging is enabled. */
 	kCC3SemanticFogColor,						/**< (vec4) Fog color. */
 	kCC3SemanticFogAttenuationMode,				/**< (int) Fog attenuation mode (one of GL_LINEAR, GL_EXP or GL_EXP2). */
@@ -200,6 +215,7 @@ typedef enum {
 	kCC3SemanticTextureCubeCount,				/**< (int) Number of active cube-map textures on the current model. */
 	kCC3SemanticTextureCubeSampler,				/**< (samplerCube[]) Array of cube-map texture samplers. */
 	kCC3SemanticTextureLightProbeSampler,		/**< (samplerCube[]/sampler2D[]) Array of light probe texture samplers. */
+	kCC3SemanticTextureShadowMapSampler,		/**< (sampler2D[]) Array of shadow map depth texture samplers, one per light. */
 
 	// The semantics below mimic OpenGL ES 1.1 configuration functionality for combining texture units.
 	// In most shaders, these will be left unused in favor of customized the texture combining in code.
@@ -227,6 +243,11 @@ typedef enum {
 	kCC3SemanticBoundingBoxSize,				/**< (vec3) Dimensions of the model's bounding box in the model's local coordinates. */
 	kCC3SemanticBoundingRadius,					/**< (float) Radius of the model's bounding sphere in the model's local coordinates. */
 	kCC3SemanticAnimationFraction,				/**< (float) Fraction of the model's animation that has been viewed (range 0-1). */
+
+	// INSTANCES ------------
+	kCC3SemanticInstanceBatchCount,				/**< (int) Number of instances in the current uniform batch, or zero if instances are drawn using per-instance vertex attributes. */
+	kCC3SemanticInstanceTransforms,				/**< (vec4[]) Rows of the transforms of the instances in the current uniform batch (three rows per instance). */
+	kCC3SemanticInstanceColors,					/**< (vec4[]) Colors of the instances in the current uniform batch. */
 	
 	// PARTICLES ------------
 	kCC3SemanticPointSize,						/**< (float) Default size of points, if not specified per-vertex in a vertex attribute array. */
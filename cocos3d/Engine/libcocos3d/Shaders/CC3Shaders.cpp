@@ -777,6 +777,25 @@ CC3GLSLAttribute* CC3ShaderProgram::getAttributeForSemantic( GLenum semantic, GL
 	return NULL;
 }
 
+bool CC3ShaderProgram::canDecodeQuantizedVertexContent()
+{
+	if ( getAttributeForSemantic( kCC3SemanticVertexLocation )
+		&& !(getUniformForSemantic( kCC3SemanticVertexLocationDequantizeScale )
+			 && getUniformForSemantic( kCC3SemanticVertexLocationDequantizeOffset )) )
+		return false;
+
+	CCObject* pObj = NULL;
+	CCARRAY_FOREACH( m_attributes, pObj )
+	{
+		CC3GLSLAttribute* var = (CC3GLSLAttribute*)pObj;
+		if ( var->getSemantic() == kCC3SemanticVertexTexture )
+			return getUniformForSemantic( kCC3SemanticVertexTextureDequantizeScale )
+				&& getUniformForSemantic( kCC3SemanticVertexTextureDequantizeOffset );
+	}
+
+	return true;
+}
+
 void CC3ShaderProgram::markSceneScopeDirty()
 {
 	m_isSceneScopeDirty = true; 
@@ -883,6 +902,16 @@ GLuint CC3ShaderProgram::getTextureLightProbeCount()
 	return m_textureLightProbeCount;
 }
 
+GLuint CC3ShaderProgram::getTextureShadowMapStart()
+{
+	return getTextureLightProbeStart() + m_textureLightProbeCount; 
+}
+
+GLuint CC3ShaderProgram::getTextureShadowMapCount()
+{
+	return m_textureShadowMapCount;
+}
+
 void CC3ShaderProgram::link()
 {
 	CCAssert(m_pVertexShader && m_pFragmentShader, "CC3Shader requires both vertex and fragment shaders to be assigned before linking.");
@@ -940,6 +969,7 @@ void CC3ShaderProgram::clearUniforms()
 	m_texture2DCount = 0;
 	m_textureCubeCount = 0;
 	m_textureLightProbeCount = 0;
+	m_textureShadowMapCount = 0;
 }
 
 /** Let the delegate configure the uniform, and then update the texture counts. */
@@ -955,6 +985,8 @@ void CC3ShaderProgram::configureUniform( CC3GLSLUniform* var )
 		m_textureCubeCount += var->getSize();
 	if (var->getSemantic() == kCC3SemanticTextureLightProbeSampler) 
 		m_textureLightProbeCount += var->getSize();
+	if (var->getSemantic() == kCC3SemanticTextureShadowMapSampler) 
+		m_textureShadowMapCount += var->getSize();
 }
 
 /** Adds the specified uniform to the appropriate internal collection, based on variable scope. */
@@ -1028,11 +1060,18 @@ void CC3ShaderProgram::prewarm()
 
 void CC3ShaderProgram::bindWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
+	CC3_PROFILE_ZONE( "CC3ShaderProgram::bind" );
+
 	CC3OpenGL* gl = visitor->getGL();
 	gl->useShaderProgram( getProgramID() );
-	gl->clearUnboundVertexAttributes();
-	populateVertexAttributesWithVisitor( visitor );
-	gl->enableBoundVertexAttributes();
+
+	// Vertex attributes are still bound if the previous draw command used the same mesh
+	if ( !visitor->isCurrentMeshBound() )
+	{
+		gl->clearUnboundVertexAttributes();
+		populateVertexAttributesWithVisitor( visitor );
+		gl->enableBoundVertexAttributes();
+	}
 	populateNodeScopeUniformsWithVisitor( visitor );
 }
 
@@ -1114,6 +1153,7 @@ void CC3ShaderProgram::initWithTag( GLuint aTag, const std::string& aName )
 		m_texture2DCount = 0;
 		m_textureCubeCount = 0;
 		m_textureLightProbeCount = 0;
+		m_textureShadowMapCount = 0;
 		m_isSceneScopeDirty = true;	// start out dirty for auto-loaded programs
 		m_pSemanticDelegate = NULL;
 		m_shouldAllowDefaultVariableValues = defaultShouldAllowDefaultVariableValues();
@@ -579,6 +579,13 @@ public:
 
 	/** Returns the vertex attribute at the specified location, or nil if no attribute is defined at the specified location. */
 	CC3GLSLAttribute*			getAttributeAtLocation( GLint attrLocation );
+
+	/**
+	 * Returns whether this program can decode quantized vertex content. This is the case if, for the
+	 * vertex locations and texture coordinates read by this program, it also uses the corresponding
+	 * dequantization scale and offset uniforms. Quantized normals and tangents need no decoding.
+	 */
+	bool						canDecodeQuantizedVertexContent();
 		
 	/** 
 	 * Returns the texture unit index of the first 2D texture supported by this shader program.
@@ -610,6 +617,17 @@ public:
 	/** Returns the number of light probe textures supported by this shader program. */
 	GLuint						getTextureLightProbeCount();
 
+	/**
+	 * Returns the texture unit index of the first shadow map texture supported by this shader program.
+	 *
+	 * The shadow map textures are allocated consecutive texture units, one per light, beginning at
+	 * the returned texture unit, which immediately follows the light probe texture units.
+	 */
+	GLuint						getTextureShadowMapStart();
+
+	/** Returns the number of shadow map textures supported by this shader program. */
+	GLuint						getTextureShadowMapCount();
+
 	/**
 	 * Each uniform used by this shader program must have a valid value. This property can be used to 
 	 * indicate whether a uniform, whose value cannot be determined, will use its standard default value.
@@ -1215,6 +1233,7 @@ protected:
 	GLuint						m_texture2DCount;
 	GLuint						m_textureCubeCount;
 	GLuint						m_textureLightProbeCount;
+	GLuint						m_textureShadowMapCount;
 	bool						m_shouldAllowDefaultVariableValues : 1;
 	bool						m_isSceneScopeDirty : 1;
 };
@@ -0,0 +1,674 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+/** The widest half-angle, in degrees, covered by the perspective depth pass of a locational light. */
+#define kCC3ShadowMapMaxHalfAngle		60.0f
+
+/** Cascade bounding sphere radii are rounded up to this fraction, so that texel size changes in steps. */
+#define kCC3ShadowMapRadiusQuantum		(1.0f / 16.0f)
+
+CC3ShadowMap::CC3ShadowMap()
+{
+	m_pLight = NULL;
+	m_pFramebuffer = NULL;
+	m_cascadeSurfaces = NULL;
+}
+
+CC3ShadowMap::~CC3ShadowMap()
+{
+	CC_SAFE_RELEASE( m_pFramebuffer );
+	CC_SAFE_RELEASE( m_cascadeSurfaces );
+}
+
+CC3Light* CC3ShadowMap::getLight()
+{
+	return m_pLight;
+}
+
+void CC3ShadowMap::setLight( CC3Light* light )
+{
+	m_pLight = light;
+	m_isReady = false;
+}
+
+GLuint CC3ShadowMap::getSize()
+{
+	return m_size;
+}
+
+void CC3ShadowMap::setSize( GLuint size )
+{
+	m_size = MAX(size, 1);
+	m_isReady = false;
+}
+
+GLuint CC3ShadowMap::getCascadeCount()
+{
+	return m_cascadeCount;
+}
+
+void CC3ShadowMap::setCascadeCount( GLuint count )
+{
+	m_cascadeCount = CLAMP(count, 1, kCC3ShadowMapMaxCascades);
+	m_isReady = false;
+}
+
+GLuint CC3ShadowMap::getActiveCascadeCount()
+{
+	return (m_pLight && m_pLight->isDirectionalOnly()) ? m_cascadeCount : 1;
+}
+
+GLfloat CC3ShadowMap::getSplitLambda()
+{
+	return m_splitLambda;
+}
+
+void CC3ShadowMap::setSplitLambda( GLfloat lambda )
+{
+	m_splitLambda = CLAMP(lambda, 0.0f, 1.0f);
+}
+
+GLfloat CC3ShadowMap::getMaxShadowDistance()
+{
+	return m_maxShadowDistance;
+}
+
+void CC3ShadowMap::setMaxShadowDistance( GLfloat distance )
+{
+	m_maxShadowDistance = MAX(distance, 0.0f);
+}
+
+GLfloat CC3ShadowMap::getCasterDistance()
+{
+	return m_casterDistance;
+}
+
+void CC3ShadowMap::setCasterDistance( GLfloat distance )
+{
+	m_casterDistance = MAX(distance, 0.0f);
+}
+
+GLfloat CC3ShadowMap::getDepthBias()
+{
+	return m_depthBias;
+}
+
+void CC3ShadowMap::setDepthBias( GLfloat bias )
+{
+	m_depthBias = bias;
+}
+
+CC3GLFramebuffer* CC3ShadowMap::getFramebuffer()
+{
+	checkFramebuffer();
+	return m_pFramebuffer;
+}
+
+CC3Texture* CC3ShadowMap::getDepthTexture()
+{
+	return m_pFramebuffer ? m_pFramebuffer->getDepthTexture() : NULL;
+}
+
+bool CC3ShadowMap::isReady()
+{
+	return m_isReady;
+}
+
+void CC3ShadowMap::markStale()
+{
+	m_isReady = false;
+}
+
+const CC3Matrix4x4* CC3ShadowMap::getShadowMatrixAt( GLuint cascadeIndex )
+{
+	return &m_shadowMatrices[MIN(cascadeIndex, kCC3ShadowMapMaxCascades - 1)];
+}
+
+const CC3Matrix4x3* CC3ShadowMap::getLightViewMatrixAt( GLuint cascadeIndex )
+{
+	return &m_lightViewMatrices[MIN(cascadeIndex, kCC3ShadowMapMaxCascades - 1)];
+}
+
+const CC3Matrix4x4* CC3ShadowMap::getLightProjMatrixAt( GLuint cascadeIndex )
+{
+	return &m_lightProjMatrices[MIN(cascadeIndex, kCC3ShadowMapMaxCascades - 1)];
+}
+
+CC3Vector4 CC3ShadowMap::getSplitDistances()
+{
+	return CC3Vector4( m_splitDistances[0], m_splitDistances[1], m_splitDistances[2], m_splitDistances[3] );
+}
+
+CCPoint CC3ShadowMap::getTexelSize()
+{
+	return ccp( 1.0f / (GLfloat)(m_size * m_activeCascadeCount), 1.0f / (GLfloat)m_size );
+}
+
+CC3RenderSurface* CC3ShadowMap::getCascadeSurfaceAt( GLuint cascadeIndex )
+{
+	checkFramebuffer();
+	return (CC3RenderSurface*)m_cascadeSurfaces->objectAtIndex( MIN(cascadeIndex, m_cascadeSurfaces->count() - 1) );
+}
+
+/**
+ * Ensures that the depth framebuffer exists, that it is wide enough to hold the active cascades
+ * side by side, and that a surface section exists over the region of each active cascade.
+ */
+void CC3ShadowMap::checkFramebuffer()
+{
+	m_activeCascadeCount = getActiveCascadeCount();
+
+	if ( !m_pFramebuffer )
+	{
+		CC3Texture* depthTex = CC3Texture::textureWithPixelFormat( GL_DEPTH_COMPONENT, GL_UNSIGNED_INT );
+		depthTex->setMinifyingFunction( GL_NEAREST );
+		depthTex->setMagnifyingFunction( GL_NEAREST );
+		depthTex->setHorizontalWrappingFunction( GL_CLAMP_TO_EDGE );
+		depthTex->setVerticalWrappingFunction( GL_CLAMP_TO_EDGE );
+
+		m_pFramebuffer = CC3GLFramebuffer::surface();		// retained
+		m_pFramebuffer->retain();
+		m_pFramebuffer->setName( "Shadow map" );
+		m_pFramebuffer->setDepthTexture( depthTex );
+
+		m_cascadeSurfaces = CCArray::create();				// retained
+		m_cascadeSurfaces->retain();
+	}
+
+	CC3IntSize fbSize = CC3IntSizeMake( m_size * m_activeCascadeCount, m_size );
+	if ( !CC3IntSizesAreEqual(fbSize, m_pFramebuffer->getSize()) )
+	{
+		m_pFramebuffer->setSize( fbSize );
+		m_pFramebuffer->validate();
+	}
+
+	while ( m_cascadeSurfaces->count() < m_activeCascadeCount )
+		m_cascadeSurfaces->addObject( CC3SurfaceSection::surfaceOnSurface( m_pFramebuffer ) );
+
+	for (GLuint cIdx = 0; cIdx < m_activeCascadeCount; cIdx++)
+	{
+		CC3SurfaceSection* section = (CC3SurfaceSection*)m_cascadeSurfaces->objectAtIndex( cIdx );
+		section->setOrigin( CC3IntPointMake(cIdx * m_size, 0) );
+		section->setSize( CC3IntSizeMake(m_size, m_size) );
+	}
+}
+
+/** Returns the right and up directions of a light view looking in the specified forward direction. */
+static void CC3ShadowMapPopulateBasis( const CC3Vector& fwd, CC3Vector& right, CC3Vector& up )
+{
+	CC3Vector refUp = (fabsf(fwd.y) > 0.99f) ? CC3Vector::kCC3VectorUnitZPositive : CC3Vector::kCC3VectorUnitYPositive;
+	right = fwd.cross( refUp ).normalize();
+	up = right.cross( fwd );
+}
+
+/**
+ * Populates the specified eight corners with the corners of the slice of the camera frustum
+ * between the specified eye-space depths. Since the edges of the frustum run linearly in depth,
+ * each corner is interpolated along an edge between the near and far corners of the frustum.
+ */
+static void CC3ShadowMapPopulateSliceCorners( CC3Frustum* frustum, GLfloat sliceNear, GLfloat sliceFar, CC3Vector* corners )
+{
+	GLfloat fNear = frustum->getNear();
+	GLfloat fDepth = frustum->getFar() - fNear;
+	GLfloat tNear = (fDepth > 0.0f) ? ((sliceNear - fNear) / fDepth) : 0.0f;
+	GLfloat tFar = (fDepth > 0.0f) ? ((sliceFar - fNear) / fDepth) : 1.0f;
+
+	CC3Vector nearCorners[4] = { frustum->getNearTopLeft(), frustum->getNearTopRight(),
+								 frustum->getNearBottomLeft(), frustum->getNearBottomRight() };
+	CC3Vector farCorners[4] = { frustum->getFarTopLeft(), frustum->getFarTopRight(),
+								frustum->getFarBottomLeft(), frustum->getFarBottomRight() };
+
+	for (GLuint i = 0; i < 4; i++)
+	{
+		corners[i] = nearCorners[i].lerp( farCorners[i], tNear );
+		corners[i + 4] = nearCorners[i].lerp( farCorners[i], tFar );
+	}
+}
+
+/** Returns the radius of a sphere around the center of the specified eight corners that encloses them all. */
+static GLfloat CC3ShadowMapPopulateBoundingSphere( const CC3Vector* corners, CC3Vector& center )
+{
+	center = CC3Vector::kCC3VectorZero;
+	for (GLuint i = 0; i < 8; i++)
+		center += corners[i];
+	center /= 8.0f;
+
+	GLfloat radiusSq = 0.0f;
+	for (GLuint i = 0; i < 8; i++)
+		radiusSq = MAX(radiusSq, center.distanceSquared( corners[i] ));
+
+	return sqrtf( radiusSq );
+}
+
+/**
+ * Populates the light view matrix of the specified cascade, looking from the specified eye
+ * location along the specified forward direction, with the specified right and up directions.
+ * As with a camera, the light view looks down the negative Z-axis.
+ */
+void CC3ShadowMap::populateLightViewMatrix( GLuint cascadeIndex, const CC3Vector& eye,
+										    const CC3Vector& fwd, const CC3Vector& right, const CC3Vector& up )
+{
+	CC3Matrix4x3* mtx = &m_lightViewMatrices[cascadeIndex];
+	mtx->c1r1 = right.x;	mtx->c2r1 = right.y;	mtx->c3r1 = right.z;	mtx->c4r1 = -right.dot( eye );
+	mtx->c1r2 = up.x;		mtx->c2r2 = up.y;		mtx->c3r2 = up.z;		mtx->c4r2 = -up.dot( eye );
+	mtx->c1r3 = -fwd.x;		mtx->c2r3 = -fwd.y;		mtx->c3r3 = -fwd.z;		mtx->c4r3 = fwd.dot( eye );
+}
+
+/**
+ * Sets the far split distance of each cascade, blending a logarithmic split, which keeps the
+ * ratio of depth to distance constant across cascades, with a uniform split, according to the
+ * splitLambda property. Components for unused cascades are set to the far distance.
+ */
+void CC3ShadowMap::updateSplitDistances( GLfloat nearDist, GLfloat farDist )
+{
+	GLfloat safeNear = MAX(nearDist, 0.0001f);
+	for (GLuint cIdx = 0; cIdx < kCC3ShadowMapMaxCascades; cIdx++)
+	{
+		if ( cIdx + 1 < m_activeCascadeCount )
+		{
+			GLfloat p = (GLfloat)(cIdx + 1) / (GLfloat)m_activeCascadeCount;
+			GLfloat logSplit = safeNear * powf( farDist / safeNear, p );
+			GLfloat uniSplit = nearDist + (farDist - nearDist) * p;
+			m_splitDistances[cIdx] = m_splitLambda * logSplit + (1.0f - m_splitLambda) * uniSplit;
+		}
+		else
+		{
+			m_splitDistances[cIdx] = farDist;
+		}
+	}
+}
+
+/**
+ * Fits an orthographic depth pass around the bounding sphere of the slice of the camera frustum
+ * covered by the specified cascade. The light view basis depends only on the light direction, and
+ * the sphere center is snapped to whole texels in that basis, so that the shadow map texels stay
+ * fixed in the scene as the camera moves or turns. The depth range is extended towards the light
+ * by the caster distance, to include shadow casters that lie outside the slice.
+ */
+void CC3ShadowMap::updateDirectionalCascade( GLuint cascadeIndex, CC3Camera* camera, GLfloat sliceNear, GLfloat sliceFar )
+{
+	CC3Vector corners[8];
+	CC3ShadowMapPopulateSliceCorners( camera->getFrustum(), sliceNear, sliceFar, corners );
+
+	CC3Vector center;
+	GLfloat radius = CC3ShadowMapPopulateBoundingSphere( corners, center );
+	radius = MAX(ceilf( radius / kCC3ShadowMapRadiusQuantum ) * kCC3ShadowMapRadiusQuantum, kCC3ShadowMapRadiusQuantum);
+
+	// The light direction points from the light towards the scene
+	CC3Vector fwd = m_pLight->getGlobalLocation().negate().normalize();
+	CC3Vector right, up;
+	CC3ShadowMapPopulateBasis( fwd, right, up );
+
+	GLfloat texelSize = (2.0f * radius) / (GLfloat)m_size;
+	GLfloat cx = center.dot( right );
+	GLfloat cy = center.dot( up );
+	center += right * (floorf( cx / texelSize ) * texelSize - cx);
+	center += up * (floorf( cy / texelSize ) * texelSize - cy);
+
+	GLfloat casterDist = (m_casterDistance > 0.0f) ? m_casterDistance : camera->getFarClippingDistance();
+	CC3Vector eye = center - fwd * (radius + casterDist);
+
+	populateLightViewMatrix( cascadeIndex, eye, fwd, right, up );
+	CC3Matrix4x4PopulateOrthoFrustum( &m_lightProjMatrices[cascadeIndex], -radius, radius, radius, -radius,
+									  0.0f, casterDist + 2.0f * radius );
+}
+
+/**
+ * Fits a single perspective depth pass from the location of the light. A spotlight looks along its
+ * spot direction, covering its cutoff angle. Other locational lights look towards the center of the
+ * region of the scene covered by the camera, widening to cover that region, up to the limit set by
+ * kCC3ShadowMapMaxHalfAngle.
+ */
+void CC3ShadowMap::updateLocationalCascade( CC3Camera* camera, GLfloat nearDist, GLfloat farDist )
+{
+	CC3Vector corners[8];
+	CC3ShadowMapPopulateSliceCorners( camera->getFrustum(), nearDist, farDist, corners );
+
+	CC3Vector center;
+	GLfloat radius = CC3ShadowMapPopulateBoundingSphere( corners, center );
+
+	CC3Vector eye = m_pLight->getGlobalLocation();
+	CC3Vector toCenter = center - eye;
+	GLfloat dist = toCenter.length();
+
+	CC3Vector fwd;
+	GLfloat halfAngle;
+	GLfloat spotCutoff = m_pLight->getSpotCutoffAngle();
+	if ( spotCutoff < 90.0f )
+	{
+		fwd = m_pLight->getGlobalForwardDirection().normalize();
+		halfAngle = spotCutoff;
+	}
+	else
+	{
+		fwd = (dist > 0.0f) ? (toCenter / dist) : m_pLight->getGlobalForwardDirection().normalize();
+		halfAngle = (dist > radius) ? CC3RadToDeg(asinf( radius / dist )) : kCC3ShadowMapMaxHalfAngle;
+	}
+	halfAngle = MIN(halfAngle, kCC3ShadowMapMaxHalfAngle);
+
+	CC3Vector right, up;
+	CC3ShadowMapPopulateBasis( fwd, right, up );
+	populateLightViewMatrix( 0, eye, fwd, right, up );
+
+	GLfloat farClip = MAX(dist + radius, 0.001f);
+	GLfloat nearClip = farClip * 0.001f;
+	GLfloat extent = nearClip * tanf( CC3DegToRad(halfAngle) );
+	CC3Matrix4x4PopulatePerspectiveFrustum( &m_lightProjMatrices[0], -extent, extent, extent, -extent, nearClip, farClip );
+
+	for (GLuint cIdx = 0; cIdx < kCC3ShadowMapMaxCascades; cIdx++)
+		m_splitDistances[cIdx] = farDist;
+}
+
+/**
+ * Combines the camera-to-global transform, the light view and projection of the specified cascade,
+ * and the scale and offset that map the clip space of the cascade onto its region of the depth
+ * texture, into the shadow matrix of the cascade.
+ */
+void CC3ShadowMap::updateShadowMatrix( GLuint cascadeIndex, const CC3Matrix4x4* camToGlobal )
+{
+	CC3Matrix4x4 lightView, lightViewProj, camToLightClip, texMtx;
+
+	CC3Matrix4x4PopulateFrom4x3( &lightView, &m_lightViewMatrices[cascadeIndex] );
+	CC3Matrix4x4Multiply( &lightViewProj, &m_lightProjMatrices[cascadeIndex], &lightView );
+	CC3Matrix4x4Multiply( &camToLightClip, &lightViewProj, camToGlobal );
+
+	GLfloat tileScale = 1.0f / (GLfloat)m_activeCascadeCount;
+	CC3Matrix4x4PopulateIdentity( &texMtx );
+	texMtx.c1r1 = 0.5f * tileScale;
+	texMtx.c4r1 = (0.5f + (GLfloat)cascadeIndex) * tileScale;
+	texMtx.c2r2 = 0.5f;
+	texMtx.c4r2 = 0.5f;
+	texMtx.c3r3 = 0.5f;
+	texMtx.c4r3 = 0.5f;
+
+	CC3Matrix4x4Multiply( &m_shadowMatrices[cascadeIndex], &texMtx, &camToLightClip );
+}
+
+void CC3ShadowMap::generateSnapshotOfScene( CC3Scene* scene, CC3Camera* camera, CC3ShadowMapDrawingVisitor* visitor )
+{
+	m_isReady = false;
+	if ( !m_pLight || !camera || !scene )
+		return;
+
+	GLfloat nearDist = camera->getNearClippingDistance();
+	GLfloat farDist = camera->getFarClippingDistance();
+	if ( m_maxShadowDistance > 0.0f )
+		farDist = MIN(farDist, m_maxShadowDistance);
+	if ( farDist <= nearDist )
+		return;
+
+	checkFramebuffer();
+
+	// Fit the cascades to the current view of the camera
+	if ( m_pLight->isDirectionalOnly() )
+	{
+		updateSplitDistances( nearDist, farDist );
+		GLfloat sliceNear = nearDist;
+		for (GLuint cIdx = 0; cIdx < m_activeCascadeCount; cIdx++)
+		{
+			updateDirectionalCascade( cIdx, camera, sliceNear, m_splitDistances[cIdx] );
+			sliceNear = m_splitDistances[cIdx];
+		}
+	}
+	else
+	{
+		updateLocationalCascade( camera, nearDist, farDist );
+	}
+
+	CC3Matrix4x3 camToGlobal4x3;
+	CC3Matrix4x4 camToGlobal;
+	camera->getGlobalTransformMatrix()->populateCC3Matrix4x3( &camToGlobal4x3 );
+	CC3Matrix4x4PopulateFrom4x3( &camToGlobal, &camToGlobal4x3 );
+	for (GLuint cIdx = 0; cIdx < m_activeCascadeCount; cIdx++)
+		updateShadowMatrix( cIdx, &camToGlobal );
+
+	// Render the depth of the shadow casters into each cascade
+	m_pFramebuffer->clearDepthContent();
+	for (GLuint cIdx = 0; cIdx < m_activeCascadeCount; cIdx++)
+	{
+		visitor->setShadowMapCascade( this, cIdx );
+		visitor->visit( scene );
+	}
+	visitor->getGL()->enableScissorTest( false );
+
+	m_isReady = true;
+}
+
+bool CC3ShadowMap::init()
+{
+	m_pLight = NULL;
+	m_size = kCC3ShadowMapDefaultSize;
+	m_cascadeCount = 3;
+	m_activeCascadeCount = 1;
+	m_splitLambda = 0.75f;
+	m_maxShadowDistance = 0.0f;
+	m_casterDistance = 0.0f;
+	m_depthBias = 0.002f;
+	m_isReady = false;
+
+	for (GLuint cIdx = 0; cIdx < kCC3ShadowMapMaxCascades; cIdx++)
+	{
+		CC3Matrix4x3PopulateIdentity( &m_lightViewMatrices[cIdx] );
+		CC3Matrix4x4PopulateIdentity( &m_lightProjMatrices[cIdx] );
+		CC3Matrix4x4PopulateIdentity( &m_shadowMatrices[cIdx] );
+		m_splitDistances[cIdx] = 0.0f;
+	}
+
+	return true;
+}
+
+CC3ShadowMap* CC3ShadowMap::shadowMap()
+{
+	CC3ShadowMap* pShadowMap = new CC3ShadowMap;
+	pShadowMap->init();
+	pShadowMap->autorelease();
+
+	return pShadowMap;
+}
+
+CC3ShadowMap* CC3ShadowMap::shadowMapWithSize( GLuint size, GLuint cascadeCount )
+{
+	CC3ShadowMap* pShadowMap = new CC3ShadowMap;
+	pShadowMap->init();
+	pShadowMap->setSize( size );
+	pShadowMap->setCascadeCount( cascadeCount );
+	pShadowMap->autorelease();
+
+	return pShadowMap;
+}
+
+CC3Plane* CC3ShadowMapCascadeVolume::getPlanes()
+{
+	return m_planes;
+}
+
+GLuint CC3ShadowMapCascadeVolume::getPlaneCount()
+{
+	return 6;
+}
+
+/** Extracts the planes from the rows of the matrix, in the same way as CC3Frustum. */
+void CC3ShadowMapCascadeVolume::populateFromViewProjectionMatrix( const CC3Matrix4x4* viewProjMtx )
+{
+	const CC3Matrix4x4& m = *viewProjMtx;
+	m_planes[0] = CC3Plane::negate(CC3Plane::normalize(CC3Plane((m.c1r4 + m.c1r2), (m.c2r4 + m.c2r2),
+															   (m.c3r4 + m.c3r2), (m.c4r4 + m.c4r2))));
+	m_planes[1] = CC3Plane::negate(CC3Plane::normalize(CC3Plane((m.c1r4 - m.c1r2), (m.c2r4 - m.c2r2),
+															   (m.c3r4 - m.c3r2), (m.c4r4 - m.c4r2))));
+	m_planes[2] = CC3Plane::negate(CC3Plane::normalize(CC3Plane((m.c1r4 + m.c1r1), (m.c2r4 + m.c2r1),
+															   (m.c3r4 + m.c3r1), (m.c4r4 + m.c4r1))));
+	m_planes[3] = CC3Plane::negate(CC3Plane::normalize(CC3Plane((m.c1r4 - m.c1r1), (m.c2r4 - m.c2r1),
+															   (m.c3r4 - m.c3r1), (m.c4r4 - m.c4r1))));
+	m_planes[4] = CC3Plane::negate(CC3Plane::normalize(CC3Plane((m.c1r4 + m.c1r3), (m.c2r4 + m.c2r3),
+															   (m.c3r4 + m.c3r3), (m.c4r4 + m.c4r3))));
+	m_planes[5] = CC3Plane::negate(CC3Plane::normalize(CC3Plane((m.c1r4 - m.c1r3), (m.c2r4 - m.c2r3),
+															   (m.c3r4 - m.c3r3), (m.c4r4 - m.c4r3))));
+	m_isDirty = false;
+}
+
+CC3ShadowMapCascadeVolume* CC3ShadowMapCascadeVolume::cascadeVolume()
+{
+	CC3ShadowMapCascadeVolume* pVolume = new CC3ShadowMapCascadeVolume;
+	pVolume->init();
+	pVolume->autorelease();
+
+	return pVolume;
+}
+
+CC3ShadowMapDrawingVisitor::CC3ShadowMapDrawingVisitor()
+{
+	m_pShadowMap = NULL;
+	m_pLightViewMatrix = NULL;
+	m_pLightProjMatrix = NULL;
+	m_pCascadeVolume = NULL;
+	m_cascadeIndex = 0;
+}
+
+CC3ShadowMapDrawingVisitor::~CC3ShadowMapDrawingVisitor()
+{
+	CC_SAFE_RELEASE( m_pLightViewMatrix );
+	CC_SAFE_RELEASE( m_pLightProjMatrix );
+	CC_SAFE_RELEASE( m_pCascadeVolume );
+}
+
+CC3ShadowMap* CC3ShadowMapDrawingVisitor::getShadowMap()
+{
+	return m_pShadowMap;
+}
+
+GLuint CC3ShadowMapDrawingVisitor::getCascadeIndex()
+{
+	return m_cascadeIndex;
+}
+
+void CC3ShadowMapDrawingVisitor::setShadowMapCascade( CC3ShadowMap* shadowMap, GLuint cascadeIndex )
+{
+	m_pShadowMap = shadowMap;
+	m_cascadeIndex = cascadeIndex;
+	setRenderSurface( shadowMap->getCascadeSurfaceAt( cascadeIndex ) );
+
+	CC3Matrix4x4 lightView, lightViewProj;
+	CC3Matrix4x4PopulateFrom4x3( &lightView, shadowMap->getLightViewMatrixAt( cascadeIndex ) );
+	CC3Matrix4x4Multiply( &lightViewProj, shadowMap->getLightProjMatrixAt( cascadeIndex ), &lightView );
+	m_pCascadeVolume->populateFromViewProjectionMatrix( &lightViewProj );
+}
+
+void CC3ShadowMapDrawingVisitor::init()
+{
+	super::init();
+	m_shouldDecorateNode = false;		// Draw depth only, with the pure-color program
+
+	m_pLightViewMatrix = CC3AffineMatrix::matrix();		// retained
+	m_pLightViewMatrix->retain();
+	m_pLightProjMatrix = CC3ProjectionMatrix::matrix();	// retained
+	m_pLightProjMatrix->retain();
+	m_pCascadeVolume = CC3ShadowMapCascadeVolume::cascadeVolume();	// retained
+	m_pCascadeVolume->retain();
+}
+
+/**
+ * Draws only nodes with local content that cast shadows, and that lie within both the shadow
+ * casting volume of the light and the volume covered by the current cascade. Nodes that are
+ * invisible, but that cast shadows when invisible, are drawn.
+ */
+bool CC3ShadowMapDrawingVisitor::shouldDrawNode( CC3Node* aNode )
+{
+	if ( !(aNode->hasLocalContent() && aNode->shouldCastShadows()) )
+		return false;
+
+	if ( aNode->isShadowVolume() || aNode->shouldDrawInClipSpace() )
+		return false;
+
+	if ( !(aNode->isVisible() || aNode->shouldCastShadowsWhenInvisible()) )
+		return false;
+
+	if ( aNode->getBoundingVolume() && !aNode->doesIntersectBoundingVolume( m_pCascadeVolume ) )
+		return false;
+
+	CC3Light* light = m_pShadowMap ? m_pShadowMap->getLight() : NULL;
+	CC3BoundingVolume* scVolume = light ? light->getShadowCastingVolume() : NULL;
+	return !scVolume || aNode->doesIntersectBoundingVolume( scVolume );
+}
+
+/** Turns off writing to the color buffer, since only depth is drawn into the shadow map. */
+void CC3ShadowMapDrawingVisitor::open()
+{
+	super::open();
+	getGL()->setColorMask( ccc4(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE) );
+}
+
+void CC3ShadowMapDrawingVisitor::close()
+{
+	getGL()->setColorMask( ccc4(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
+	super::close();
+}
+
+/** Overridden to load the light view and projection of the current cascade, instead of those of a camera. */
+void CC3ShadowMapDrawingVisitor::openCamera()
+{
+	CC3OpenGL* gl = getGL();
+
+	gl->pushProjectionMatrixStack();
+	m_pLightProjMatrix->populateFromCC3Matrix4x4( (CC3Matrix4x4*)m_pShadowMap->getLightProjMatrixAt( m_cascadeIndex ) );
+	populateProjMatrixFrom( m_pLightProjMatrix );
+
+	gl->pushModelviewMatrixStack();
+	m_pLightViewMatrix->populateFromCC3Matrix4x3( (CC3Matrix4x3*)m_pShadowMap->getLightViewMatrixAt( m_cascadeIndex ) );
+	populateViewMatrixFrom( m_pLightViewMatrix );
+}
+
+void CC3ShadowMapDrawingVisitor::closeCamera()
+{
+	CC3OpenGL* gl = getGL();
+	gl->popModelviewMatrixStack();
+	gl->popProjectionMatrixStack();
+}
+
+/** The bounding volume hierarchy is culled to the camera frustum, which does not apply to light views. */
+void CC3ShadowMapDrawingVisitor::openBoundingVolumeHierarchy()
+{
+	m_pBoundingVolumeHierarchy = NULL;
+	m_isDrawingVisibleNodes = false;
+}
+
+/** The cascade surfaces are sections of the shadow map, and must not resize the viewport of the camera. */
+void CC3ShadowMapDrawingVisitor::alignCameraViewport()
+{
+}
+
+CC3ShadowMapDrawingVisitor* CC3ShadowMapDrawingVisitor::visitor()
+{
+	CC3ShadowMapDrawingVisitor* pVal = new CC3ShadowMapDrawingVisitor;
+	pVal->init();
+	pVal->autorelease();
+
+	return pVal;
+}
+
+NS_COCOS3D_END
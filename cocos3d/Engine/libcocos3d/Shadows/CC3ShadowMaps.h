@@ -0,0 +1,318 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_SHADOW_MAPS_H_
+#define _CC3_SHADOW_MAPS_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3Light;
+class CC3Camera;
+class CC3Scene;
+class CC3GLFramebuffer;
+class CC3ShadowMapDrawingVisitor;
+
+/** The maximum number of cascades into which the depth range of a CC3ShadowMap can be split. */
+#define kCC3ShadowMapMaxCascades		4
+
+/** The default width and height, in pixels, of each cascade of a CC3ShadowMap. */
+#define kCC3ShadowMapDefaultSize		1024
+
+/**
+ * CC3ShadowMap renders the depth of the shadow casters in a scene, as seen from a light, into a
+ * depth texture, which shaders then sample to determine whether each fragment is lit by that light.
+ *
+ * Shadow maps are an alternative to the stencilled shadow volumes of CC3ShadowVolumeMeshNode.
+ * Instead of building a shadow volume for each shadow caster, and drawing each volume twice into
+ * the stencil buffer, the scene is drawn once per cascade into the depth texture, and shadows
+ * are resolved per fragment within the shaders of the models that receive them. The two
+ * techniques can be used together, even on the same light.
+ *
+ * A shadow map is attached to a light by setting the shadowMap property of the light. Thereafter,
+ * the scene regenerates the shadow map once per frame, before drawing its content, from the
+ * point of view of the active camera. Only nodes whose shouldCastShadows property returns YES,
+ * and that intersect the shadowCastingVolume of the light, are drawn into the shadow map. Set the
+ * shouldCastShadows property to NO on enclosing nodes, such as a skybox, that should not cast shadows.
+ *
+ * For a directional light, the depth range of the camera, up to the maxShadowDistance, is split
+ * into cascadeCount slices. Each slice is covered by its own orthographic depth pass, so that
+ * nearby slices receive more shadow map texels per unit of scene than distant ones. The split
+ * distances blend logarithmic and uniform splitting, as controlled by the splitLambda property.
+ * Each slice is fit by a bounding sphere, and the sphere center is snapped to whole texels, so
+ * that shadow edges do not shimmer as the camera moves or turns.
+ *
+ * A locational light always uses a single perspective depth pass from the light. A spotlight
+ * looks along its spot direction. A point light looks towards the region of the scene covered by
+ * the camera, and its depth pass covers a field of view of at most 120 degrees, so shadows cast
+ * by a point light that sits within that region will be clipped to that field of view.
+ *
+ * All cascades are rendered side by side into a single depth texture, of width (size * number
+ * of cascades) and height size. Shaders retrieve, for each cascade, a matrix that transforms an
+ * eye-space location into the texture coordinates and depth of that cascade within the texture,
+ * along with the eye-space depths at which each cascade ends. The CC3LibShadowMap.fsh shader
+ * library contains GLSL functions that select the cascade and compare depths, with a small
+ * percentage-closer filter to soften the shadow edges.
+ *
+ * Shadow maps require depth texture support from the platform, which is standard on OpenGL,
+ * and available on OpenGL ES 2.0 through the OES_depth_texture extension.
+ *
+ * Shadow maps hold a weak reference to their light.
+ */
+class CC3ShadowMap : public CCObject
+{
+public:
+	CC3ShadowMap();
+	virtual ~CC3ShadowMap();
+
+	/** The light that casts the shadows held in this shadow map. */
+	CC3Light*					getLight();
+	void						setLight( CC3Light* light );
+
+	/**
+	 * The width and height, in pixels, of the depth texture region used by each cascade.
+	 *
+	 * The initial value of this property is kCC3ShadowMapDefaultSize.
+	 */
+	GLuint						getSize();
+	void						setSize( GLuint size );
+
+	/**
+	 * The number of slices into which the depth range of the camera is split, when this shadow map
+	 * is cast by a directional light. Locational lights always use a single cascade. The value is
+	 * clamped to between one and kCC3ShadowMapMaxCascades.
+	 *
+	 * The initial value of this property is 3.
+	 */
+	GLuint						getCascadeCount();
+	void						setCascadeCount( GLuint count );
+
+	/**
+	 * Returns the number of cascades actually in use, which is the value of the cascadeCount
+	 * property for a directional light, and one for a locational light.
+	 */
+	GLuint						getActiveCascadeCount();
+
+	/**
+	 * Blends between uniform splitting (zero) and logarithmic splitting (one) of the depth range
+	 * of the camera into cascades. Logarithmic splits give the most even texel density across the
+	 * cascades, but make the nearest cascade very shallow.
+	 *
+	 * The initial value of this property is 0.75.
+	 */
+	GLfloat						getSplitLambda();
+	void						setSplitLambda( GLfloat lambda );
+
+	/**
+	 * The distance from the camera beyond which shadows are not drawn. Limiting this distance
+	 * concentrates the resolution of the shadow map on the shadows near the camera.
+	 *
+	 * If this value is zero, or larger than the far clipping distance of the camera, shadows
+	 * extend to the far clipping distance of the camera. The initial value of this property is zero.
+	 */
+	GLfloat						getMaxShadowDistance();
+	void						setMaxShadowDistance( GLfloat distance );
+
+	/**
+	 * The distance, beyond the region covered by each cascade, from which shadow casters in the
+	 * direction of a directional light are included in the depth pass. Casters further away from
+	 * the region than this distance do not cast shadows into it.
+	 *
+	 * If this value is zero, the far clipping distance of the camera is used.
+	 * The initial value of this property is zero.
+	 */
+	GLfloat						getCasterDistance();
+	void						setCasterDistance( GLfloat distance );
+
+	/**
+	 * The bias subtracted from the depth of each fragment, in normalized shadow map depth units,
+	 * before comparing it with the depth held in the shadow map, to avoid surfaces shadowing
+	 * themselves. This bias is applied by the shaders, and made available through the
+	 * kCC3SemanticShadowMapDepthBias semantic.
+	 *
+	 * The initial value of this property is 0.002.
+	 */
+	GLfloat						getDepthBias();
+	void						setDepthBias( GLfloat bias );
+
+	/** The framebuffer into which the depth of the shadow casters is rendered. */
+	CC3GLFramebuffer*			getFramebuffer();
+
+	/** The depth texture holding all cascades of this shadow map, side by side. */
+	CC3Texture*					getDepthTexture();
+
+	/**
+	 * Returns whether this shadow map holds content that was generated during the current frame,
+	 * and can therefore be sampled by shaders.
+	 */
+	bool						isReady();
+
+	/**
+	 * Returns the matrix that transforms a location in the eye space of the camera, into the texture
+	 * coordinates (x & y) and depth (z) of the cascade at the specified index, within the depth texture.
+	 */
+	const CC3Matrix4x4*			getShadowMatrixAt( GLuint cascadeIndex );
+
+	/**
+	 * Returns the eye-space depths at which each cascade ends, with one component per cascade.
+	 * Components for unused cascades are set to the maximum shadow distance.
+	 */
+	CC3Vector4					getSplitDistances();
+
+	/** Returns the size of a single texel of the depth texture, in texture coordinates. */
+	CCPoint						getTexelSize();
+
+	/** Returns the light view matrix of the cascade at the specified index, from the most recent generation. */
+	const CC3Matrix4x3*			getLightViewMatrixAt( GLuint cascadeIndex );
+
+	/** Returns the light projection matrix of the cascade at the specified index, from the most recent generation. */
+	const CC3Matrix4x4*			getLightProjMatrixAt( GLuint cascadeIndex );
+
+	/** Returns the render surface covering the region of the depth texture used by the cascade at the specified index. */
+	CC3RenderSurface*			getCascadeSurfaceAt( GLuint cascadeIndex );
+
+	/**
+	 * Fits the cascades to the view of the specified camera, and renders the depth of the shadow
+	 * casters in the specified scene into each cascade, using the specified visitor.
+	 *
+	 * This method is invoked automatically by the scene once per frame.
+	 */
+	void						generateSnapshotOfScene( CC3Scene* scene, CC3Camera* camera, CC3ShadowMapDrawingVisitor* visitor );
+
+	/** Marks this shadow map as not holding content for the current frame. */
+	void						markStale();
+
+	/** Initializes this instance with default properties. */
+	virtual bool				init();
+
+	/** Allocates and initializes an autoreleased instance with default properties. */
+	static CC3ShadowMap*		shadowMap();
+
+	/** Allocates and initializes an autoreleased instance with the specified cascade size and count. */
+	static CC3ShadowMap*		shadowMapWithSize( GLuint size, GLuint cascadeCount );
+
+protected:
+	void						checkFramebuffer();
+	void						updateSplitDistances( GLfloat nearDist, GLfloat farDist );
+	void						updateDirectionalCascade( GLuint cascadeIndex, CC3Camera* camera, GLfloat sliceNear, GLfloat sliceFar );
+	void						updateLocationalCascade( CC3Camera* camera, GLfloat nearDist, GLfloat farDist );
+	void						updateShadowMatrix( GLuint cascadeIndex, const CC3Matrix4x4* camToGlobal );
+	void						populateLightViewMatrix( GLuint cascadeIndex, const CC3Vector& eye,
+														 const CC3Vector& fwd, const CC3Vector& right, const CC3Vector& up );
+
+protected:
+	CC3Light*					m_pLight;				// weak reference
+	CC3GLFramebuffer*			m_pFramebuffer;
+	CCArray*					m_cascadeSurfaces;
+	CC3Matrix4x3				m_lightViewMatrices[kCC3ShadowMapMaxCascades];
+	CC3Matrix4x4				m_lightProjMatrices[kCC3ShadowMapMaxCascades];
+	CC3Matrix4x4				m_shadowMatrices[kCC3ShadowMapMaxCascades];
+	GLfloat						m_splitDistances[kCC3ShadowMapMaxCascades];
+	GLuint						m_size;
+	GLuint						m_cascadeCount;
+	GLuint						m_activeCascadeCount;
+	GLfloat						m_splitLambda;
+	GLfloat						m_maxShadowDistance;
+	GLfloat						m_casterDistance;
+	GLfloat						m_depthBias;
+	bool						m_isReady : 1;
+};
+
+/**
+ * CC3ShadowMapCascadeVolume is a bounding volume holding the six planes, in global coordinates,
+ * of the volume covered by the light view and projection of a single cascade of a CC3ShadowMap.
+ * It is used by CC3ShadowMapDrawingVisitor to skip shadow casters that lie outside the cascade.
+ */
+class CC3ShadowMapCascadeVolume : public CC3BoundingVolume
+{
+	DECLARE_SUPER( CC3BoundingVolume );
+public:
+	CC3Plane*					getPlanes();
+	GLuint						getPlaneCount();
+
+	/** Builds the planes of this volume from the specified combined view and projection matrix. */
+	void						populateFromViewProjectionMatrix( const CC3Matrix4x4* viewProjMtx );
+
+	/** Allocates and initializes an autoreleased instance. */
+	static CC3ShadowMapCascadeVolume*	cascadeVolume();
+
+protected:
+	CC3Plane					m_planes[6];
+};
+
+/**
+ * CC3ShadowMapDrawingVisitor is a CC3NodeDrawingVisitor that renders the depth of the shadow
+ * casters in a scene into a single cascade of a CC3ShadowMap.
+ *
+ * Instead of the view and projection of a camera, this visitor uses the light view and projection
+ * matrices of the cascade, and draws into the region of the depth texture used by the cascade.
+ * Nodes are drawn with the pure-color shader program, with writing to the color buffer disabled.
+ *
+ * Only nodes whose shouldCastShadows property returns YES, and that intersect both the shadowCastingVolume
+ * of the light and the volume covered by the cascade, are drawn. Shadow volumes, and nodes that are
+ * drawn in clip space, are not drawn.
+ */
+class CC3ShadowMapDrawingVisitor : public CC3NodeDrawingVisitor
+{
+	DECLARE_SUPER( CC3NodeDrawingVisitor );
+public:
+	CC3ShadowMapDrawingVisitor();
+	virtual ~CC3ShadowMapDrawingVisitor();
+
+	/** The shadow map into which depth is currently being drawn. */
+	CC3ShadowMap*				getShadowMap();
+
+	/** The index of the cascade of the shadowMap into which depth is currently being drawn. */
+	GLuint						getCascadeIndex();
+
+	/**
+	 * Sets the shadow map and cascade into which depth will be drawn, and the render surface of that
+	 * cascade, and builds the volume covered by the cascade, against which shadow casters are culled.
+	 */
+	void						setShadowMapCascade( CC3ShadowMap* shadowMap, GLuint cascadeIndex );
+
+	void						init();
+	bool						shouldDrawNode( CC3Node* aNode );
+	void						open();
+	void						close();
+
+	static CC3ShadowMapDrawingVisitor* visitor();
+
+protected:
+	void						openCamera();
+	void						closeCamera();
+	void						openBoundingVolumeHierarchy();
+	void						alignCameraViewport();
+
+protected:
+	CC3ShadowMap*				m_pShadowMap;			// weak reference
+	CC3AffineMatrix*			m_pLightViewMatrix;
+	CC3ProjectionMatrix*		m_pLightProjMatrix;
+	CC3ShadowMapCascadeVolume*	m_pCascadeVolume;
+	GLuint						m_cascadeIndex;
+};
+
+NS_COCOS3D_END
+
+#endif
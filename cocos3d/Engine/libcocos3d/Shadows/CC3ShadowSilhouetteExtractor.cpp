@@ -0,0 +1,388 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+/** The ranges of faces and edges processed by a single thread, during one phase of extraction. */
+typedef struct
+{
+	CC3ShadowSilhouetteExtractor*	extractor;
+	bool						isClassifying;
+	GLuint						faceStart;
+	GLuint						faceEnd;
+	GLuint						edgeStart;
+	GLuint						edgeEnd;
+	std::vector<CC3Vector4>*	vertices;
+} CC3ShadowSilhouetteJob;
+
+static void runShadowSilhouetteJob( void* arg )
+{
+	CC3ShadowSilhouetteJob* job = (CC3ShadowSilhouetteJob*)arg;
+	if ( job->isClassifying )
+		job->extractor->classifyFaceRange( job->faceStart, job->faceEnd );
+	else
+		job->extractor->extractRange( job->faceStart, job->faceEnd, job->edgeStart, job->edgeEnd, *job->vertices );
+}
+
+/** Runs the specified jobs on the shared worker pool, with the calling thread taking part. */
+static void runShadowSilhouetteJobs( std::vector<CC3ShadowSilhouetteJob>& jobs )
+{
+	CC3WorkerPool::sharedWorkerPool()->runJobs( runShadowSilhouetteJob, &jobs[0], (GLuint)jobs.size(), sizeof(CC3ShadowSilhouetteJob) );
+}
+
+/**
+ * Classifies four faces as lit or dark. A face is lit if the homogeneous light position is in
+ * front of the plane of the face, which is the same test as the isInFront method of CC3Plane.
+ */
+static inline void classifyFaces( const GLfloat* a, const GLfloat* b, const GLfloat* c, const GLfloat* d,
+								  const CC3Vector4& light, GLubyte* isLit )
+{
+	CC3Float4 dist = f4Mul( f4Load( a ), f4Splat( light.x ) );
+	dist = f4MulAdd( dist, f4Load( b ), f4Splat( light.y ) );
+	dist = f4MulAdd( dist, f4Load( c ), f4Splat( light.z ) );
+	dist = f4MulAdd( dist, f4Load( d ), f4Splat( light.w ) );
+	unsigned int litMask = f4PositiveMask( dist );
+	for (int i = 0; i < 4; i++)
+		isLit[i] = (GLubyte)((litMask >> i) & 1);
+}
+
+/**
+ * Extends a terminator edge vertex away from a locational light, by the distance between
+ * the light and the vertex, multiplied by the specified expansion limit factor.
+ */
+static inline CC3Vector4 expandFromLight( const CC3Vector4& edgeLoc, const CC3Vector4& lightLoc, GLfloat expansionLimitFactor )
+{
+	CC3Vector4 extDir = edgeLoc.difference( lightLoc );
+	return edgeLoc.add( extDir.scaleUniform( expansionLimitFactor ) );
+}
+
+/** Appends a single triangle from the edge to the point at infinity opposite a directional light. */
+static inline void addDirectionalSide( const CC3Vector4& edgeStartLoc, const CC3Vector4& edgeEndLoc,
+									   const CC3Vector4& lightPosition, std::vector<CC3Vector4>& vertices )
+{
+	vertices.push_back( edgeStartLoc );
+	vertices.push_back( lightPosition.homogeneousNegate() );
+	vertices.push_back( edgeEndLoc );
+}
+
+CC3ShadowSilhouetteExtractor::CC3ShadowSilhouetteExtractor()
+{
+	m_pShadowCaster = NULL;
+	m_pCasterMesh = NULL;
+}
+
+CC3ShadowSilhouetteExtractor::~CC3ShadowSilhouetteExtractor()
+{
+
+}
+
+CC3MeshNode* CC3ShadowSilhouetteExtractor::getShadowCaster()
+{
+	return m_pShadowCaster;
+}
+
+GLuint CC3ShadowSilhouetteExtractor::getEdgeCount()
+{
+	return (GLuint)m_edges.size();
+}
+
+GLuint CC3ShadowSilhouetteExtractor::getMaxThreads()
+{
+	return m_maxThreads;
+}
+
+void CC3ShadowSilhouetteExtractor::setMaxThreads( GLuint maxThreads )
+{
+	m_maxThreads = MAX(maxThreads, 1);
+}
+
+GLuint CC3ShadowSilhouetteExtractor::getMinParallelFaceCount()
+{
+	return m_minParallelFaceCount;
+}
+
+void CC3ShadowSilhouetteExtractor::setMinParallelFaceCount( GLuint faceCount )
+{
+	m_minParallelFaceCount = MAX(faceCount, 1);
+}
+
+void CC3ShadowSilhouetteExtractor::markFacesDirty()
+{
+	m_facesAreDirty = true;
+}
+
+/** Records each edge once, against the lower-indexed of the two faces that share it. */
+void CC3ShadowSilhouetteExtractor::buildEdges()
+{
+	m_edges.clear();
+	m_edges.reserve( m_faceCount * 3 / 2 + 1 );
+	for (GLuint faceIdx = 0; faceIdx < m_faceCount; faceIdx++)
+	{
+		CC3FaceNeighbours neighbours = m_pShadowCaster->getFaceNeighboursAt( faceIdx );
+		for (GLuint edgeIdx = 0; edgeIdx < 3; edgeIdx++)
+		{
+			GLuint neighbourFaceIdx = neighbours.edges[edgeIdx];
+			if ( neighbourFaceIdx == kCC3FaceNoNeighbour || neighbourFaceIdx > faceIdx )
+			{
+				CC3ShadowCasterEdge edge;
+				edge.face = faceIdx;
+				edge.neighbour = neighbourFaceIdx;
+				edge.edgeIndex = edgeIdx;
+				m_edges.push_back( edge );
+			}
+		}
+	}
+	CC3_TRACE( "CC3ShadowSilhouetteExtractor built %u edges from %u faces", (GLuint)m_edges.size(), m_faceCount );
+}
+
+/** Copies the (deformed) face vertices and planes from the shadow caster, padding the planes to a multiple of four. */
+void CC3ShadowSilhouetteExtractor::gatherFaces()
+{
+	GLuint paddedCount = (m_faceCount + 3) & ~3U;
+	m_faceVertices.resize( m_faceCount * 3 );
+	m_planeA.assign( paddedCount, 0.0f );
+	m_planeB.assign( paddedCount, 0.0f );
+	m_planeC.assign( paddedCount, 0.0f );
+	m_planeD.assign( paddedCount, 0.0f );
+	m_isFaceLit.assign( paddedCount, 0 );
+
+	for (GLuint faceIdx = 0; faceIdx < m_faceCount; faceIdx++)
+	{
+		CC3Face face = m_pShadowCaster->getDeformedFaceAt( faceIdx );
+		m_faceVertices[(faceIdx * 3) + 0] = face.vertices[0];
+		m_faceVertices[(faceIdx * 3) + 1] = face.vertices[1];
+		m_faceVertices[(faceIdx * 3) + 2] = face.vertices[2];
+
+		CC3Plane plane = m_pShadowCaster->getDeformedFacePlaneAt( faceIdx );
+		m_planeA[faceIdx] = plane.a;
+		m_planeB[faceIdx] = plane.b;
+		m_planeC[faceIdx] = plane.c;
+		m_planeD[faceIdx] = plane.d;
+	}
+}
+
+void CC3ShadowSilhouetteExtractor::classifyFaceRange( GLuint faceStart, GLuint faceEnd )
+{
+	for (GLuint faceIdx = faceStart; faceIdx < faceEnd; faceIdx += 4)
+		classifyFaces( &m_planeA[faceIdx], &m_planeB[faceIdx], &m_planeC[faceIdx], &m_planeD[faceIdx],
+					   m_spec.lightPosition, &m_isFaceLit[faceIdx] );
+}
+
+/**
+ * Emits the same vertices, in the same winding, as the addShadowVolumeCapFor, addTerminatorLineFrom
+ * and addShadowVolumeSideFrom methods of CC3ShadowVolumeMeshNode, but only visits each edge once.
+ */
+void CC3ShadowSilhouetteExtractor::extractRange( GLuint faceStart, GLuint faceEnd, GLuint edgeStart, GLuint edgeEnd,
+												 std::vector<CC3Vector4>& vertices )
+{
+	const CC3ShadowSilhouetteSpec& spec = m_spec;
+	const CC3Vector4& lightPos = spec.lightPosition;
+	bool isDirectionalLight = lightPos.isDirectional();
+
+	vertices.clear();
+
+	// Near cap faces. A face is part of the cap if it is dark and front faces are being
+	// shadowed (typical), or it is lit and back faces are (also) being shadowed.
+	if ( spec.shouldAddNearCaps )
+	{
+		for (GLuint faceIdx = faceStart; faceIdx < faceEnd; faceIdx++)
+		{
+			bool isFaceLit = (m_isFaceLit[faceIdx] != 0);
+			if ( !(isFaceLit ? spec.shouldShadowBackFaces : spec.shouldShadowFrontFaces) )
+				continue;
+
+			const CC3Vector* faceVertices = &m_faceVertices[faceIdx * 3];
+			CC3Vector4 v0 = CC3Vector4().fromLocation( faceVertices[0] ).add( spec.vertexOffset );
+			CC3Vector4 v1 = CC3Vector4().fromLocation( faceVertices[1] ).add( spec.vertexOffset );
+			CC3Vector4 v2 = CC3Vector4().fromLocation( faceVertices[2] ).add( spec.vertexOffset );
+			vertices.push_back( v0 );
+			vertices.push_back( isFaceLit ? v1 : v2 );
+			vertices.push_back( isFaceLit ? v2 : v1 );
+		}
+	}
+
+	// Silhouette edges
+	for (GLuint edgeIdx = edgeStart; edgeIdx < edgeEnd; edgeIdx++)
+	{
+		const CC3ShadowCasterEdge& edge = m_edges[edgeIdx];
+		bool isFaceLit = (m_isFaceLit[edge.face] != 0);
+		bool isTerminatorEdge = (edge.neighbour == kCC3FaceNoNeighbour)
+									? (isFaceLit ? spec.shouldShadowFrontFaces : spec.shouldShadowBackFaces)
+									: (isFaceLit != (m_isFaceLit[edge.neighbour] != 0));
+		if ( !isTerminatorEdge )
+			continue;
+
+		// Wind the extruded sides the same way as the dark face of the pair
+		const CC3Vector* faceVertices = &m_faceVertices[edge.face * 3];
+		CC3Vector4 edgeLoc0 = CC3Vector4().fromLocation( faceVertices[edge.edgeIndex] ).add( spec.vertexOffset );
+		CC3Vector4 edgeLoc1 = CC3Vector4().fromLocation( faceVertices[(edge.edgeIndex < 2) ? (edge.edgeIndex + 1) : 0] ).add( spec.vertexOffset );
+		const CC3Vector4& edgeStartLoc = isFaceLit ? edgeLoc0 : edgeLoc1;
+		const CC3Vector4& edgeEndLoc = isFaceLit ? edgeLoc1 : edgeLoc0;
+
+		if ( spec.shouldDrawTerminator )
+		{
+			vertices.push_back( edgeStartLoc );
+			vertices.push_back( edgeEndLoc );
+		}
+		else if ( isDirectionalLight )
+		{
+			addDirectionalSide( edgeStartLoc, edgeEndLoc, lightPos, vertices );
+		}
+		else
+		{
+			CC3Vector4 farStartLoc = spec.shouldCapFarEnd
+										? expandFromLight( edgeStartLoc, lightPos, spec.expansionLimitFactor )
+										: edgeStartLoc.difference( lightPos );
+			CC3Vector4 farEndLoc = spec.shouldCapFarEnd
+										? expandFromLight( edgeEndLoc, lightPos, spec.expansionLimitFactor )
+										: edgeEndLoc.difference( lightPos );
+			vertices.push_back( edgeStartLoc );
+			vertices.push_back( farStartLoc );
+			vertices.push_back( farEndLoc );
+			vertices.push_back( edgeStartLoc );
+			vertices.push_back( farEndLoc );
+			vertices.push_back( edgeEndLoc );
+			if ( spec.shouldCapFarEnd )
+				addDirectionalSide( farStartLoc, farEndLoc, lightPos, vertices );
+		}
+	}
+}
+
+bool CC3ShadowSilhouetteExtractor::populateShadowMesh( CC3Mesh* shadowMesh, const CC3ShadowSilhouetteSpec& spec )
+{
+	CC3_PROFILE_ZONE( "CC3ShadowSilhouetteExtractor::populateShadowMesh" );
+
+	CC3Mesh* casterMesh = m_pShadowCaster->getMesh();
+	GLuint faceCount = m_pShadowCaster->getFaceCount();
+	if ( casterMesh != m_pCasterMesh || faceCount != m_faceCount )
+	{
+		m_pCasterMesh = casterMesh;
+		m_faceCount = faceCount;
+		buildEdges();
+		m_facesAreDirty = true;
+	}
+
+	if ( m_facesAreDirty || m_pShadowCaster->hasSkeleton() )
+	{
+		gatherFaces();
+		m_facesAreDirty = false;
+	}
+
+	m_spec = spec;
+
+	// Split the faces into ranges aligned to the four-face classification kernel,
+	// and the edges into the same number of ranges, leaving the first to the calling thread.
+	GLuint paddedFaceCount = (GLuint)m_isFaceLit.size();
+	GLuint edgeCount = getEdgeCount();
+	GLuint threadCount = MIN(m_maxThreads, MAX(m_faceCount / m_minParallelFaceCount, 1));
+	GLuint faceRangeSize = (((paddedFaceCount + threadCount - 1) / threadCount) + 3) & ~3U;
+	GLuint edgeRangeSize = (edgeCount + threadCount - 1) / threadCount;
+
+	if ( m_threadVertices.size() < threadCount )
+		m_threadVertices.resize( threadCount );
+
+	std::vector<CC3ShadowSilhouetteJob> jobs( threadCount );
+	for (GLuint tIdx = 0; tIdx < threadCount; tIdx++)
+	{
+		CC3ShadowSilhouetteJob& job = jobs[tIdx];
+		job.extractor = this;
+		job.isClassifying = true;
+		job.faceStart = MIN(tIdx * faceRangeSize, paddedFaceCount);
+		job.faceEnd = MIN(job.faceStart + faceRangeSize, paddedFaceCount);
+		job.edgeStart = MIN(tIdx * edgeRangeSize, edgeCount);
+		job.edgeEnd = MIN(job.edgeStart + edgeRangeSize, edgeCount);
+		job.vertices = &m_threadVertices[tIdx];
+	}
+
+	// All faces must be classified before any edge can be tested against both of its faces
+	runShadowSilhouetteJobs( jobs );
+
+	for (GLuint tIdx = 0; tIdx < threadCount; tIdx++)
+	{
+		CC3ShadowSilhouetteJob& job = jobs[tIdx];
+		job.isClassifying = false;
+		job.faceStart = MIN(job.faceStart, m_faceCount);
+		job.faceEnd = MIN(job.faceEnd, m_faceCount);
+	}
+	runShadowSilhouetteJobs( jobs );
+
+	// Copy the vertices of all threads into the shadow mesh, after ensuring its capacity once
+	GLuint vertexCount = 0;
+	for (GLuint tIdx = 0; tIdx < threadCount; tIdx++)
+		vertexCount += (GLuint)m_threadVertices[tIdx].size();
+
+	bool wasMeshExpanded = shadowMesh->ensureVertexCapacity( vertexCount );
+
+	CC3VertexLocations* vertexLocations = shadowMesh->getVertexLocations();
+	bool canCopyDirectly = (vertexLocations->getElementSize() == 4 &&
+							vertexLocations->getElementType() == GL_FLOAT &&
+							vertexLocations->getVertexStride() == sizeof(CC3Vector4) &&
+							vertexLocations->getVertices() != NULL);
+	GLuint vtxIdx = 0;
+	for (GLuint tIdx = 0; tIdx < threadCount; tIdx++)
+	{
+		std::vector<CC3Vector4>& threadVertices = m_threadVertices[tIdx];
+		GLuint threadVertexCount = (GLuint)threadVertices.size();
+		if ( threadVertexCount == 0 )
+			continue;
+
+		if ( canCopyDirectly )
+		{
+			memcpy( vertexLocations->getAddressOfElement( vtxIdx ), &threadVertices[0], threadVertexCount * sizeof(CC3Vector4) );
+			vtxIdx += threadVertexCount;
+		}
+		else
+		{
+			for (GLuint tvIdx = 0; tvIdx < threadVertexCount; tvIdx++)
+				shadowMesh->setVertexHomogeneousLocation( threadVertices[tvIdx], vtxIdx++ );
+		}
+	}
+
+	shadowMesh->setVertexCount( vertexCount );
+	return wasMeshExpanded;
+}
+
+void CC3ShadowSilhouetteExtractor::initForShadowCaster( CC3MeshNode* aNode )
+{
+	m_pShadowCaster = aNode;					// weak reference
+	m_pCasterMesh = NULL;
+	m_faceCount = 0;
+	m_maxThreads = 4;
+	m_minParallelFaceCount = 4096;
+	m_facesAreDirty = true;
+}
+
+CC3ShadowSilhouetteExtractor* CC3ShadowSilhouetteExtractor::extractorForShadowCaster( CC3MeshNode* aNode )
+{
+	CC3ShadowSilhouetteExtractor* pExtractor = new CC3ShadowSilhouetteExtractor;
+	pExtractor->initForShadowCaster( aNode );
+	pExtractor->autorelease();
+
+	return pExtractor;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,166 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_SHADOW_SILHOUETTE_EXTRACTOR_H_
+#define _CC3_SHADOW_SILHOUETTE_EXTRACTOR_H_
+
+NS_COCOS3D_BEGIN
+
+class CC3MeshNode;
+
+/**
+ * An edge of the mesh of a shadow caster. Each edge is recorded once, against the face with the
+ * lower index of the two faces that share it. The neighbour is the other face sharing the edge,
+ * or kCC3FaceNoNeighbour if the edge lies on the boundary of an open mesh.
+ */
+typedef struct
+{
+	GLuint						face;			/**< The lower-indexed face containing the edge. */
+	GLuint						neighbour;		/**< The other face containing the edge. */
+	GLuint						edgeIndex;		/**< The index of the edge within the face. */
+} CC3ShadowCasterEdge;
+
+/** The configuration of a shadow volume, as extracted by a CC3ShadowSilhouetteExtractor. */
+typedef struct
+{
+	CC3Vector4					lightPosition;			/**< Homogeneous light position, in the local coordinates of the shadow caster. */
+	CC3Vector4					vertexOffset;			/**< Directional offset added to each shadow caster vertex. */
+	GLfloat						expansionLimitFactor;	/**< See the shadowExpansionLimitFactor property of CC3ShadowVolumeMeshNode. */
+	bool						shouldDrawTerminator;	/**< Emit terminator lines instead of shadow volume sides. */
+	bool						shouldAddNearCaps;		/**< Emit the faces of the cap at the near end. */
+	bool						shouldCapFarEnd;		/**< Limit the expansion of shadows from locational lights. */
+	bool						shouldShadowFrontFaces;	/**< See the shouldShadowFrontFaces property of CC3ShadowVolumeMeshNode. */
+	bool						shouldShadowBackFaces;	/**< See the shouldShadowBackFaces property of CC3ShadowVolumeMeshNode. */
+} CC3ShadowSilhouetteSpec;
+
+/**
+ * CC3ShadowSilhouetteExtractor builds the vertices of a shadow volume from the silhouette of the
+ * mesh of a shadow caster, as seen from a light.
+ *
+ * The edges of the mesh, and the faces on either side of each edge, are collected once into a
+ * flat edge list, so that each rebuild visits each edge exactly once, instead of visiting each
+ * face and each of its three neighbours. The face planes are held as a structure of arrays, and
+ * each face is classified as lit or dark, four faces at a time, using SSE or NEON instructions
+ * when enabled by the CC3_SIMD_SSE or CC3_SIMD_NEON build setting. Only the edges on the
+ * silhouette, and the near-cap faces when needed, then contribute vertices to the shadow volume.
+ *
+ * Large meshes are split across the threads of the shared CC3WorkerPool, as determined by the
+ * maxThreads and minParallelFaceCount properties. Each job classifies a range of faces, and
+ * then extracts the silhouette from a range of edges into its own vertex buffer. These buffers
+ * are retained between rebuilds, so that they do not need to be reallocated on each rebuild.
+ * The vertices of all jobs are then copied into the shadow volume mesh, after ensuring its
+ * capacity once.
+ *
+ * The face vertices and planes of a rigid shadow caster are gathered once and reused until the
+ * mesh of the caster changes, or the markFacesDirty method is invoked. The faces of a shadow
+ * caster with a skeleton are gathered from the deformed faces on each rebuild.
+ *
+ * The extractor holds a weak reference to the shadow caster.
+ */
+class CC3ShadowSilhouetteExtractor : public CCObject
+{
+public:
+	CC3ShadowSilhouetteExtractor();
+	virtual ~CC3ShadowSilhouetteExtractor();
+
+	/** The mesh node whose silhouette is extracted by this instance. */
+	CC3MeshNode*				getShadowCaster();
+
+	/** Returns the number of edges in the edge list of the mesh of the shadow caster. */
+	GLuint						getEdgeCount();
+
+	/**
+	 * Specifies the maximum number of threads used to extract the silhouette, including the calling
+	 * thread. Setting this property to one extracts the silhouette entirely on the calling thread.
+	 *
+	 * The initial value of this property is four.
+	 */
+	GLuint						getMaxThreads();
+	void						setMaxThreads( GLuint maxThreads );
+
+	/**
+	 * Specifies the minimum number of faces that each extraction thread must be given before the
+	 * work is split across threads. Meshes with fewer faces than this are processed on the calling
+	 * thread, because the cost of handing work to other threads would exceed the savings.
+	 *
+	 * The initial value of this property is 4096.
+	 */
+	GLuint						getMinParallelFaceCount();
+	void						setMinParallelFaceCount( GLuint faceCount );
+
+	/**
+	 * Marks the gathered face vertices and planes as dirty, so that they are gathered again from the
+	 * shadow caster on the next rebuild. Invoke this method if the vertex locations of the mesh of a
+	 * rigid shadow caster are changed. Changes to the mesh itself, or its face count, are detected
+	 * automatically, and faces of a shadow caster with a skeleton are always gathered again.
+	 */
+	void						markFacesDirty();
+
+	/**
+	 * Populates the specified shadow volume mesh with the vertices of the shadow volume described by
+	 * the specified configuration, and sets the vertex count of the mesh. Returns whether the vertex
+	 * capacity of the mesh had to be expanded to hold the vertices.
+	 */
+	bool						populateShadowMesh( CC3Mesh* shadowMesh, const CC3ShadowSilhouetteSpec& spec );
+
+	/** Classifies the faces within the specified range as lit or dark. Invoked on each extraction thread. */
+	void						classifyFaceRange( GLuint faceStart, GLuint faceEnd );
+
+	/**
+	 * Appends the near-cap faces within the specified face range, and the shadow volume sides of
+	 * the silhouette edges within the specified edge range, to the specified vertex buffer.
+	 * Invoked on each extraction thread.
+	 */
+	void						extractRange( GLuint faceStart, GLuint faceEnd, GLuint edgeStart, GLuint edgeEnd,
+											  std::vector<CC3Vector4>& vertices );
+
+	/** Initializes this instance to extract the silhouette of the specified shadow caster. */
+	void						initForShadowCaster( CC3MeshNode* aNode );
+
+	/** Allocates and initializes an autoreleased instance to extract the silhouette of the specified shadow caster. */
+	static CC3ShadowSilhouetteExtractor*	extractorForShadowCaster( CC3MeshNode* aNode );
+
+protected:
+	void						buildEdges();
+	void						gatherFaces();
+
+protected:
+	CC3MeshNode*				m_pShadowCaster;
+	CC3Mesh*					m_pCasterMesh;			// Weak reference, used only to detect changes
+	GLuint						m_faceCount;
+	std::vector<CC3ShadowCasterEdge>	m_edges;
+	std::vector<CC3Vector>		m_faceVertices;			// Three per face
+	std::vector<GLfloat>		m_planeA, m_planeB, m_planeC, m_planeD;
+	std::vector<GLubyte>		m_isFaceLit;
+	std::vector< std::vector<CC3Vector4> >	m_threadVertices;
+	CC3ShadowSilhouetteSpec		m_spec;
+	GLuint						m_maxThreads;
+	GLuint						m_minParallelFaceCount;
+	bool						m_facesAreDirty : 1;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -34,10 +34,12 @@ NS_COCOS3D_BEGIN
 CC3ShadowVolumeMeshNode::CC3ShadowVolumeMeshNode()
 {
 	m_pLight = NULL;
+	m_pSilhouetteExtractor = NULL;
 }
 
 CC3ShadowVolumeMeshNode::~CC3ShadowVolumeMeshNode()
 {
+	CC_SAFE_RELEASE( m_pSilhouetteExtractor );
 	if ( m_pLight )
 	{
 		m_pLight->removeShadow( this );
@@ -178,6 +180,35 @@ void CC3ShadowVolumeMeshNode::setShouldAddShadowVolumeEndCapsOnlyWhenNeeded( boo
 	super::setShouldAddShadowVolumeEndCapsOnlyWhenNeeded( onlyWhenNeeded );
 }
 
+bool CC3ShadowVolumeMeshNode::shouldUseSilhouetteExtractor()
+{
+	return m_shouldUseSilhouetteExtractor;
+}
+
+void CC3ShadowVolumeMeshNode::setShouldUseSilhouetteExtractor( bool shouldUse )
+{
+	m_shouldUseSilhouetteExtractor = shouldUse;
+}
+
+CC3ShadowSilhouetteExtractor* CC3ShadowVolumeMeshNode::getSilhouetteExtractor()
+{
+	CC3MeshNode* scNode = getShadowCaster();
+	if ( !m_pSilhouetteExtractor || m_pSilhouetteExtractor->getShadowCaster() != scNode )
+		setSilhouetteExtractor( scNode ? CC3ShadowSilhouetteExtractor::extractorForShadowCaster( scNode ) : NULL );
+
+	return m_pSilhouetteExtractor;
+}
+
+void CC3ShadowVolumeMeshNode::setSilhouetteExtractor( CC3ShadowSilhouetteExtractor* extractor )
+{
+	if ( extractor == m_pSilhouetteExtractor )
+		return;
+
+	CC_SAFE_RELEASE( m_pSilhouetteExtractor );
+	m_pSilhouetteExtractor = extractor;
+	CC_SAFE_RETAIN( extractor );
+}
+
 bool CC3ShadowVolumeMeshNode::hasShadowVolumesForLight( CC3Light* aLight )
 {
 	return true; 
@@ -192,12 +223,14 @@ void CC3ShadowVolumeMeshNode::initWithTag( GLuint aTag, const std::string& aName
 {
 	super::initWithTag( aTag, aName );
 	m_pLight = NULL;
+	m_pSilhouetteExtractor = NULL;
 	m_isShadowDirty = true;
 	m_shouldDrawTerminator = false;
 	m_shouldShadowFrontFaces = true;
 	m_shouldShadowBackFaces = false;
 	m_shouldAddEndCapsOnlyWhenNeeded = false;
 	m_useDepthFailAlgorithm = false;
+	m_shouldUseSilhouetteExtractor = true;
 	setShouldUseLighting( false );
 	setShouldDisableDepthMask( true );
 	m_shadowLagFactor = 1;
@@ -229,6 +262,7 @@ void CC3ShadowVolumeMeshNode::populateFrom( CC3ShadowVolumeMeshNode* another )
 	m_shouldDrawTerminator = another->shouldDrawTerminator();
 	m_shouldAddEndCapsOnlyWhenNeeded = another->shouldAddShadowVolumeEndCapsOnlyWhenNeeded();
 	m_useDepthFailAlgorithm = another->useDepthFailAlgorithm();
+	m_shouldUseSilhouetteExtractor = another->shouldUseSilhouetteExtractor();
 	m_shadowLagFactor = another->getShadowLagFactor();
 	m_shadowLagCount = another->getShadowLagCount();
 	m_shadowVolumeVertexOffsetFactor = another->getShadowVolumeVertexOffsetFactor();
@@ -340,6 +374,58 @@ CC3Vector4 CC3ShadowVolumeMeshNode::getShadowVolumeVertexOffsetForLightAt( const
  * coordinates system of the shadow caster.
  */
 void CC3ShadowVolumeMeshNode::populateShadowMesh()
+{
+	CC3_PROFILE_ZONE( "CC3ShadowVolumeMeshNode::populateShadowMesh" );
+
+	bool wasMeshExpanded = m_shouldUseSilhouetteExtractor
+								? populateShadowMeshFromSilhouette()
+								: populateShadowMeshByFace();
+
+	// If the mesh is using GL VBO's, update them. If the mesh was expanded,
+	// recreate the VBO's, otherwise update them.
+	if ( m_pMesh->isUsingGLBuffers() ) 
+	{
+		if ( wasMeshExpanded )
+		{
+			m_pMesh->deleteGLBuffers();
+			m_pMesh->createGLBuffers();
+		} 
+		else 
+		{
+			m_pMesh->updateVertexLocationsGLBuffer();
+		}
+	}
+	// LogTrace(@"Finshed populating %@", self);
+}
+
+/**
+ * Builds the shadow volume from the edge list of the silhouette extractor. The configuration
+ * of the shadow volume is collected here, so that the extractor does not need to query this
+ * node from its worker threads.
+ */
+bool CC3ShadowVolumeMeshNode::populateShadowMeshFromSilhouette()
+{
+	CC3MeshNode* scNode = getShadowCaster();
+	bool doesRequireCapping = m_useDepthFailAlgorithm || !m_shouldAddEndCapsOnlyWhenNeeded;
+
+	CC3ShadowSilhouetteSpec spec;
+	CC3Vector4 lightPosition = m_pLight->getGlobalHomogeneousPosition();
+	spec.lightPosition = scNode->getGlobalTransformMatrixInverted()->transformHomogeneousVector( lightPosition );
+	spec.vertexOffset = (m_shadowVolumeVertexOffsetFactor != 0.0f)
+							? getShadowVolumeVertexOffsetForLightAt( spec.lightPosition )
+							: CC3Vector4::kCC3Vector4Zero;
+	spec.expansionLimitFactor = m_shadowExpansionLimitFactor;
+	spec.shouldDrawTerminator = shouldDrawTerminator() && isVisible();
+	spec.shouldAddNearCaps = doesRequireCapping && !m_shouldDrawTerminator;
+	spec.shouldCapFarEnd = doesRequireCapping;
+	spec.shouldShadowFrontFaces = m_shouldShadowFrontFaces;
+	spec.shouldShadowBackFaces = m_shouldShadowBackFaces;
+
+	return getSilhouetteExtractor()->populateShadowMesh( m_pMesh, spec );
+}
+
+/** Builds the shadow volume by visiting each face of the shadow caster, and each of its neighbours. */
+bool CC3ShadowVolumeMeshNode::populateShadowMeshByFace()
 {
 	CC3MeshNode* scNode = getShadowCaster();
 	GLuint faceCnt = scNode->getFaceCount();
@@ -457,22 +543,8 @@ void CC3ShadowVolumeMeshNode::populateShadowMesh()
 	// Update the vertex count of the shadow volume mesh, based on how many sides we've added.
 	m_pMesh->setVertexCount( shdwVtxIdx );
 	//LogTrace(@"%@ setting vertex count to %u", self, shdwVtxIdx);
-	
-	// If the mesh is using GL VBO's, update them. If the mesh was expanded,
-	// recreate the VBO's, otherwise update them.
-	if ( m_pMesh->isUsingGLBuffers() ) 
-	{
-		if ( wasMeshExpanded )
-		{
-			m_pMesh->deleteGLBuffers();
-			m_pMesh->createGLBuffers();
-		} 
-		else 
-		{
-			m_pMesh->updateVertexLocationsGLBuffer();
-		}
-	}
-	// LogTrace(@"Finshed populating %@", self);
+
+	return wasMeshExpanded;
 }
 
 /**
@@ -147,6 +147,30 @@ public:
 	void						setShadowExpansionLimitFactor( GLfloat factor );
 	bool						shouldAddShadowVolumeEndCapsOnlyWhenNeeded();
 	void						setShouldAddShadowVolumeEndCapsOnlyWhenNeeded( bool onlyWhenNeeded );
+
+	/**
+	 * Indicates whether the shadow volume mesh should be populated using the silhouette extractor
+	 * held in the silhouetteExtractor property, which caches the edge adjacency of the shadow
+	 * caster and classifies faces in parallel batches.
+	 *
+	 * Setting this property to NO populates the shadow volume mesh by visiting each face of the
+	 * shadow caster and its neighbours, one at a time. Both approaches produce the same shadow
+	 * volume, and this property can be used to compare the cost of each.
+	 *
+	 * The initial value of this property is YES.
+	 */
+	bool						shouldUseSilhouetteExtractor();
+	void						setShouldUseSilhouetteExtractor( bool shouldUse );
+
+	/**
+	 * The silhouette extractor used to populate the shadow volume mesh when the
+	 * shouldUseSilhouetteExtractor property is set to YES.
+	 *
+	 * If not set directly, an extractor for the shadow caster is created lazily on first access,
+	 * and replaced if this shadow volume is moved to a different shadow caster.
+	 */
+	CC3ShadowSilhouetteExtractor*	getSilhouetteExtractor();
+	void						setSilhouetteExtractor( CC3ShadowSilhouetteExtractor* extractor );
 	bool						hasShadowVolumesForLight( CC3Light* aLight );
 	bool						hasShadowVolumes();
 	void						initWithTag( GLuint aTag, const std::string& aName );
@@ -197,6 +221,10 @@ public:
 	 * coordinates system of the shadow caster.
 	 */
 	void						populateShadowMesh();
+	/** Populates the shadow volume mesh by visiting each face of the shadow caster and its neighbours. */
+	bool						populateShadowMeshByFace();
+	/** Populates the shadow volume mesh from the silhouette edges found by the silhouette extractor. */
+	bool						populateShadowMeshFromSilhouette();
 
 	/**
 	 * Adds a face to the cap at the near end of the shadow volume.
@@ -328,6 +356,7 @@ public:
 
 protected:
 	CC3Light*					m_pLight;
+	CC3ShadowSilhouetteExtractor*	m_pSilhouetteExtractor;
 	GLushort					m_shadowLagFactor;
 	GLushort					m_shadowLagCount;
 	GLfloat						m_shadowVolumeVertexOffsetFactor;
@@ -338,6 +367,7 @@ protected:
 	bool						m_shouldShadowBackFaces : 1;
 	bool						m_useDepthFailAlgorithm : 1;
 	bool						m_shouldAddEndCapsOnlyWhenNeeded : 1;
+	bool						m_shouldUseSilhouetteExtractor : 1;
 };
 
 /**
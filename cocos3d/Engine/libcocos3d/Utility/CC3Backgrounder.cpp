@@ -36,12 +36,24 @@ NS_COCOS3D_BEGIN
 
 CC3Backgrounder::CC3Backgrounder()
 {
+	m_maxConcurrentTasks = 1;
+	m_taskSequence = 0;
+	m_queuePriority = kCC3BackgrounderPriorityDefault;
+	m_isTerminating = false;
+	m_shouldRunTasksOnRequestingThread = false;
 
+	pthread_mutex_init( &m_taskMutex, NULL );
+	pthread_cond_init( &m_taskCondition, NULL );
+	pthread_mutex_init( &m_completionMutex, NULL );
 }
 
 CC3Backgrounder::~CC3Backgrounder()
 {
-	// deleteTaskQueue();
+	deleteTaskQueue();
+
+	pthread_mutex_destroy( &m_completionMutex );
+	pthread_cond_destroy( &m_taskCondition );
+	pthread_mutex_destroy( &m_taskMutex );
 }
 
 long CC3Backgrounder::getQueuePriority()
@@ -57,55 +69,278 @@ void CC3Backgrounder::setQueuePriority( long queuePriority )
 	updateTaskQueuePriority();
 }
 
+unsigned int CC3Backgrounder::getMaxConcurrentTasks()
+{
+	return m_maxConcurrentTasks;
+}
+
+void CC3Backgrounder::setMaxConcurrentTasks( unsigned int maxTasks )
+{
+	pthread_mutex_lock( &m_taskMutex );
+	m_maxConcurrentTasks = MAX(maxTasks, 1);
+	pthread_mutex_unlock( &m_taskMutex );
+}
+
+unsigned int CC3Backgrounder::getPendingTaskCount()
+{
+	pthread_mutex_lock( &m_taskMutex );
+	unsigned int taskCount = (unsigned int)m_pendingTasks.size();
+	pthread_mutex_unlock( &m_taskMutex );
+	return taskCount;
+}
+
+bool CC3Backgrounder::shouldRunTasksOnRequestingThread()
+{
+	return m_shouldRunTasksOnRequestingThread;
+}
+
+void CC3Backgrounder::setShouldRunTasksOnRequestingThread( bool shouldRun )
+{
+	m_shouldRunTasksOnRequestingThread = shouldRun;
+}
+
 /** Set the initial queue priority. */
 void CC3Backgrounder::initQueuePriority()
 {
-	// setQueuePriority( DISPATCH_QUEUE_PRIORITY_BACKGROUND );
+	setQueuePriority( kCC3BackgrounderPriorityBackground );
 }
 
-/** Initialize the serial task queue. */
+/** 
+ * Initialize the task queue. Worker threads are started lazily, as tasks are submitted,
+ * and completion blocks are run on the main thread from the CCScheduler.
+ */
 void CC3Backgrounder::initTaskQueue()
 {
-	// _taskQueue = dispatch_queue_create(kCC3BackgrounderDefaultTaskQueueName, NULL);
+	CCDirector::sharedDirector()->getScheduler()->scheduleSelector( schedule_selector(CC3Backgrounder::processCompletedTasks), this, 0, false );
 }
 
-/** Delete the serial task queue. */
+/** Stops the worker threads once they have finished their current task, and deletes the task queue. */
 void CC3Backgrounder::deleteTaskQueue()
 {
-	// dispatch_release(_taskQueue);
-	//_taskQueue = NULL;
+	pthread_mutex_lock( &m_taskMutex );
+	m_isTerminating = true;
+	m_pendingTasks.clear();
+	pthread_cond_broadcast( &m_taskCondition );
+	pthread_mutex_unlock( &m_taskMutex );
+
+	for ( unsigned int i = 0; i < m_workerThreads.size(); i++ )
+		pthread_join( m_workerThreads[i], NULL );
+	m_workerThreads.clear();
+
+	CCDirector::sharedDirector()->getScheduler()->unscheduleSelector( schedule_selector(CC3Backgrounder::processCompletedTasks), this );
 }
 
-/** Update the underlying target queue of the serial task queue to match the queue priority. */
+/** 
+ * Each task captures the queue priority at the time it is submitted, so changing the
+ * priority does not reorder tasks that are already waiting. Wake the workers so that
+ * they re-evaluate the queue.
+ */
 void CC3Backgrounder::updateTaskQueuePriority()
 {
-	// dispatch_set_target_queue(_taskQueue, dispatch_get_global_queue(_queuePriority, 0));
+	pthread_mutex_lock( &m_taskMutex );
+	pthread_cond_broadcast( &m_taskCondition );
+	pthread_mutex_unlock( &m_taskMutex );
 }
 
-void CC3Backgrounder::runBlock( bgBlock block )
+void CC3Backgrounder::runBlock( bgBlock block, void* userData )
 {
 	if (m_shouldRunTasksOnRequestingThread) 
 	{
-		runBlockNow( block );
+		runBlockNow( block, userData );
 	} else {
-		// dispatch_async(_taskQueue, ^{ [self runBlockNow: block]; });
+		queueTask( block, NULL, userData, 0.0f );
 	}
 }
 
-void CC3Backgrounder::runBlock( bgBlock block, float seconds )
+void CC3Backgrounder::runBlock( bgBlock block, void* userData, float seconds )
 {
 	if (m_shouldRunTasksOnRequestingThread) {
-		// [NSThread.currentThread runBlock: block after: seconds];
+		CC3BackgrounderTask task;
+		task.block = block;
+		task.completion = NULL;
+		task.userData = userData;
+		task.priority = m_queuePriority;
+		task.fireTime = CC3Platform::getCurrentMilliseconds() + (unsigned long)(MAX(seconds, 0.0f) * 1000.0f);
+		task.sequence = 0;
+
+		pthread_mutex_lock( &m_completionMutex );
+		m_mainThreadTasks.push_back( task );
+		pthread_mutex_unlock( &m_completionMutex );
 	} else {
-		// dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (seconds * NSEC_PER_SEC)),
-		//			   _taskQueue,
-		//			   ^{ [self runBlockNow: block]; });
+		queueTask( block, NULL, userData, seconds );
 	}
 }
 
-void CC3Backgrounder::runBlockNow( bgBlock block )
+void CC3Backgrounder::runBlockWithCompletion( bgBlock block, bgBlock completion, void* userData )
 {
-	block();
+	if (m_shouldRunTasksOnRequestingThread) 
+	{
+		runBlockNow( block, userData );
+		if ( completion )
+			completion( userData );
+	} else {
+		queueTask( block, completion, userData, 0.0f );
+	}
+}
+
+void CC3Backgrounder::queueTask( bgBlock block, bgBlock completion, void* userData, float seconds )
+{
+	if ( !block )
+		return;
+
+	CC3BackgrounderTask task;
+	task.block = block;
+	task.completion = completion;
+	task.userData = userData;
+	task.priority = m_queuePriority;
+	task.fireTime = CC3Platform::getCurrentMilliseconds() + (unsigned long)(MAX(seconds, 0.0f) * 1000.0f);
+
+	pthread_mutex_lock( &m_taskMutex );
+	task.sequence = m_taskSequence++;
+	m_pendingTasks.push_back( task );
+	ensureWorkerThreads();
+	pthread_cond_signal( &m_taskCondition );
+	pthread_mutex_unlock( &m_taskMutex );
+}
+
+/** Starts another worker thread if the pool has not yet reached maxConcurrentTasks. Must be invoked under lock. */
+void CC3Backgrounder::ensureWorkerThreads()
+{
+	if ( m_workerThreads.size() >= m_maxConcurrentTasks )
+		return;
+
+	pthread_t worker;
+	if ( pthread_create( &worker, NULL, runWorkerThread, this ) == 0 )
+	{
+		m_workerThreads.push_back( worker );
+	}
+	else
+	{
+		CC3_ERROR( "CC3Backgrounder could not start a worker thread for %s", kCC3BackgrounderDefaultTaskQueueName );
+	}
+}
+
+/**
+ * Waits until a task is ready to run, and removes it from the queue. Of the tasks whose start
+ * time has arrived, the task with the highest priority is chosen, in submission order within
+ * the same priority. Returns false if the queue is being deleted. Must be invoked under lock.
+ */
+bool CC3Backgrounder::dequeueTask( CC3BackgrounderTask& task )
+{
+	while ( !m_isTerminating )
+	{
+		unsigned long now = CC3Platform::getCurrentMilliseconds();
+		int bestIdx = -1;
+		long nextWait = -1;
+		unsigned int taskCount = (unsigned int)m_pendingTasks.size();
+		for ( unsigned int i = 0; i < taskCount; i++ )
+		{
+			CC3BackgrounderTask& candidate = m_pendingTasks[i];
+			long remaining = (long)(candidate.fireTime - now);
+			if ( remaining > 0 )
+			{
+				if ( nextWait < 0 || remaining < nextWait )
+					nextWait = remaining;
+				continue;
+			}
+
+			if ( bestIdx < 0 ) 
+			{
+				bestIdx = i;
+				continue;
+			}
+
+			CC3BackgrounderTask& best = m_pendingTasks[bestIdx];
+			if ( candidate.priority > best.priority || 
+				(candidate.priority == best.priority && (int)(candidate.sequence - best.sequence) < 0) )
+				bestIdx = i;
+		}
+
+		if ( bestIdx >= 0 )
+		{
+			task = m_pendingTasks[bestIdx];
+			m_pendingTasks.erase( m_pendingTasks.begin() + bestIdx );
+			return true;
+		}
+
+		if ( nextWait < 0 )
+		{
+			pthread_cond_wait( &m_taskCondition, &m_taskMutex );
+		}
+		else
+		{
+			struct timespec deadline;
+			CC3Platform::getAbsoluteTimeAfter( (unsigned long)nextWait, &deadline );
+			pthread_cond_timedwait( &m_taskCondition, &m_taskMutex, &deadline );
+		}
+	}
+	return false;
+}
+
+/** The worker thread loop. Runs tasks until the queue is deleted. */
+void CC3Backgrounder::runTasks()
+{
+	CC3BackgrounderTask task;
+	pthread_mutex_lock( &m_taskMutex );
+	while ( dequeueTask( task ) )
+	{
+		pthread_mutex_unlock( &m_taskMutex );
+		runTaskNow( task );
+		pthread_mutex_lock( &m_taskMutex );
+	}
+	pthread_mutex_unlock( &m_taskMutex );
+}
+
+void* CC3Backgrounder::runWorkerThread( void* backgrounder )
+{
+	((CC3Backgrounder*)backgrounder)->runTasks();
+	return NULL;
+}
+
+void CC3Backgrounder::runBlockNow( bgBlock block, void* userData )
+{
+	block( userData );
+}
+
+void CC3Backgrounder::runTaskNow( const CC3BackgrounderTask& task )
+{
+	runBlockNow( task.block, task.userData );
+
+	if ( task.completion )
+	{
+		pthread_mutex_lock( &m_completionMutex );
+		m_completedTasks.push_back( task );
+		pthread_mutex_unlock( &m_completionMutex );
+	}
+}
+
+void CC3Backgrounder::processCompletedTasks( float dt )
+{
+	CC_UNUSED_PARAM(dt);
+	std::vector<CC3BackgrounderTask> completedTasks;
+	std::vector<CC3BackgrounderTask> dueTasks;
+	unsigned long now = CC3Platform::getCurrentMilliseconds();
+
+	// Collect under lock, but run outside of it, so that blocks may submit further tasks.
+	pthread_mutex_lock( &m_completionMutex );
+	completedTasks.swap( m_completedTasks );
+	for ( unsigned int i = 0; i < m_mainThreadTasks.size(); )
+	{
+		if ( (long)(m_mainThreadTasks[i].fireTime - now) <= 0 )
+		{
+			dueTasks.push_back( m_mainThreadTasks[i] );
+			m_mainThreadTasks.erase( m_mainThreadTasks.begin() + i );
+		}
+		else
+			i++;
+	}
+	pthread_mutex_unlock( &m_completionMutex );
+
+	for ( unsigned int i = 0; i < dueTasks.size(); i++ )
+		runBlockNow( dueTasks[i].block, dueTasks[i].userData );
+
+	for ( unsigned int i = 0; i < completedTasks.size(); i++ )
+		runBlockNow( completedTasks[i].completion, completedTasks[i].userData );
 }
 
 void CC3Backgrounder::init()
@@ -124,7 +359,10 @@ static CC3Backgrounder* _singleton;
 CC3Backgrounder* CC3Backgrounder::sharedBackgrounder()
 {
 	if (!_singleton) 
+	{
 		_singleton = new CC3Backgrounder;		// retained
+		_singleton->init();
+	}
 
 	return _singleton;
 }
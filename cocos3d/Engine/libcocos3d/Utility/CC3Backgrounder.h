@@ -29,20 +29,54 @@
  */
 #ifndef _CC3_BACKGROUNDER_H_
 #define _CC3_BACKGROUNDER_H_
+#include <pthread.h>
 
 NS_COCOS3D_BEGIN
 
-typedef void (*bgBlock) ( );
+/** 
+ * A unit of work run by a CC3Backgrounder. The userData pointer that was submitted with the
+ * block is passed back to it, and to its completion block, so that the block can locate the
+ * object it is working on without resorting to global state.
+ */
+typedef void (*bgBlock) ( void* userData );
+
+/** 
+ * Task queue priorities, used with the queuePriority property of CC3Backgrounder.
+ * These have the same relative values as the GCD DISPATCH_QUEUE_PRIORITY_* constants.
+ */
+#define kCC3BackgrounderPriorityHigh			2
+#define kCC3BackgrounderPriorityDefault			0
+#define kCC3BackgrounderPriorityLow				(-2)
+#define kCC3BackgrounderPriorityBackground		(-32768)
+
+/** A single unit of work queued on a CC3Backgrounder. */
+typedef struct 
+{
+	bgBlock				block;					/**< The block to run on the background thread. */
+	bgBlock				completion;				/**< Optional block to run on the main thread once block has run. */
+	void*				userData;				/**< The context passed to both the block and the completion block. */
+	long				priority;				/**< The queue priority at the time the task was submitted. */
+	unsigned long		fireTime;				/**< The time, in milliseconds, at which the task may start. */
+	unsigned int		sequence;				/**< Submission order, used to keep equal-priority tasks FIFO. */
+} CC3BackgrounderTask;
+
 /**
- * CC3Backgrounder performs activity on a background thread by submitting tasks to 
- * a Grand Central Dispatch (GCD) queue. In order to ensure that the GL engine is
- * presented activity in an defined order, CC3Backgrounder is a singleton.
+ * CC3Backgrounder performs activity on a background thread by submitting tasks to a task
+ * queue that is serviced by a pool of worker threads. In order to ensure that the GL engine
+ * is presented activity in an defined order, CC3Backgrounder is a singleton, and by default
+ * the queue is serviced by a single worker thread, so tasks are run serially.
+ *
+ * Tasks that are ready to run are dequeued in order of the queue priority that was in effect
+ * when they were submitted, and in submission order within the same priority.
  *
  * This core behaviour can be nulified by setting the shouldRunOnRequestingThread property
  * to YES, which forces tasks submitted to this backgrounder to be run on the same thread
  * from which the tasks are queued. This behaviour can be useful when loading OpenGL objects
  * that need to be subsequently deleted. It is important that OpenGL objects are deleted
  * from the same thread on which they are loaded.
+ *
+ * The sharedBackgrounder singleton must first be accessed from the main thread, so that it
+ * can register with the CCScheduler to run completion blocks on the main thread.
  */
 class CC3Backgrounder : public CCObject 
 {
@@ -53,32 +87,49 @@ public:
 	void				init();
 
 	/**
-	 * Specifies the priority of the GCD global dispatch queue to which background tasks are dispatched.
+	 * Specifies the priority of the task queue to which background tasks are dispatched.
 	 *
 	 * Setting this property will affect any subsequent tasks submitted to the runBlock: method.
+	 * Tasks submitted with a higher priority are dequeued ahead of waiting tasks of a lower priority.
 	 *
-	 * The value of this property must be one of the following GCD constants:
-	 *	- DISPATCH_QUEUE_PRIORITY_HIGH
-	 *	- DISPATCH_QUEUE_PRIORITY_DEFAULT
-	 *	- DISPATCH_QUEUE_PRIORITY_LOW
-	 *	- DISPATCH_QUEUE_PRIORITY_BACKGROUND (available starting with iOS 5)
+	 * The value of this property should be one of the following constants:
+	 *	- kCC3BackgrounderPriorityHigh
+	 *	- kCC3BackgrounderPriorityDefault
+	 *	- kCC3BackgrounderPriorityLow
+	 *	- kCC3BackgrounderPriorityBackground
 	 *
-	 * The initial value of this property is DISPATCH_QUEUE_PRIORITY_BACKGROUND when running
-	 * under iOS 5 or above, or DISPATCH_QUEUE_PRIORITY_LOW otherwise.
+	 * The initial value of this property is kCC3BackgrounderPriorityBackground.
 	 */
 	long				getQueuePriority();
 	void				setQueuePriority( long priority );
 
+	/**
+	 * Specifies the maximum number of worker threads that may run tasks concurrently.
+	 *
+	 * The initial value of this property is one, indicating that tasks are run serially,
+	 * in the order in which they were dequeued. Setting this property to a larger value
+	 * allows independent tasks, such as loading unrelated resource files, to run in parallel.
+	 * Worker threads are started lazily, as tasks are submitted.
+	 */
+	unsigned int		getMaxConcurrentTasks();
+	void				setMaxConcurrentTasks( unsigned int maxTasks );
+
+	/** Returns the number of tasks that have been submitted and have not yet started running. */
+	unsigned int		getPendingTaskCount();
+
 	/** 
 	 * If the value of the shouldRunOnRequestingThread property is NO (the default), the specified
-	 * block of code is dispatched to the global GCD queue identified by the value of the queuePriority
-	 * property, and the current thread continues without waiting for the dispatched code to complete.
+	 * block of code is dispatched to the task queue at the priority identified by the value of the
+	 * queuePriority property, and the current thread continues without waiting for the dispatched
+	 * code to complete.
 	 *
 	 * If the value of the shouldRunOnRequestingThread property is YES, the specified block of code
 	 * is run immediately on the current thread, and further thread activity waits until the specified
 	 * block has completed.
+	 *
+	 * The specified userData is passed to the block when it is run.
 	 */
-	void				runBlock( bgBlock block );
+	void				runBlock( bgBlock block, void* userData );
 
 	/**
 	 * Waits the specified number of seconds, then executes the specified block of code 
@@ -86,11 +137,23 @@ public:
 	 * the shouldRunOnRequestingThread property.
  
 	 * If the value of the shouldRunOnRequestingThread property is NO (the default), the specified
-	 * block of code is dispatched to the global GCD queue identified by the value of the queuePriority
-	 * property. If the value of the shouldRunOnRequestingThread property is YES, the specified block
-	 * of code is run on the current thread.
+	 * block of code is dispatched to the task queue at the priority identified by the value of the
+	 * queuePriority property. If the value of the shouldRunOnRequestingThread property is YES, the
+	 * specified block of code is run on the main thread, once the delay has elapsed.
+	 *
+	 * The specified userData is passed to the block when it is run.
+	 */
+	void				runBlock( bgBlock block, void* userData, float seconds );
+
+	/**
+	 * Behaves like runBlock:, and once the specified block has run, the specified completion
+	 * block is run on the main thread, during the next CCScheduler update. This allows content
+	 * that was loaded in the background to be added to the scene from the rendering thread.
+	 *
+	 * The specified userData is passed to both the block and the completion block, and is
+	 * typically used to carry the loaded content from one to the other.
 	 */
-	void				runBlock( bgBlock block, float seconds );
+	void				runBlockWithCompletion( bgBlock block, bgBlock completion, void* userData );
 
 	/**
 	 * Indicates that tasks should be run on the same thread as the invocator of the task requests.
@@ -102,6 +165,13 @@ public:
 	bool				shouldRunTasksOnRequestingThread();
 	void				setShouldRunTasksOnRequestingThread( bool shouldRun );
 
+	/** 
+	 * Invoked by the CCScheduler on the main thread to run the completion blocks of tasks
+	 * that have finished on a worker thread, and any delayed tasks that are to run on the
+	 * requesting thread.
+	 */
+	void				processCompletedTasks( float dt );
+
 	/** Returns the singleton backgrounder instance. */
 	static CC3Backgrounder* sharedBackgrounder();
 
@@ -111,12 +181,29 @@ protected:
 	void				initTaskQueue();
 	void				deleteTaskQueue();
 
-	void				runBlockNow( bgBlock block ); 
+	void				queueTask( bgBlock block, bgBlock completion, void* userData, float seconds );
+	void				ensureWorkerThreads();
+	bool				dequeueTask( CC3BackgrounderTask& task );
+	void				runTasks();
+
+	void				runBlockNow( bgBlock block, void* userData ); 
+	void				runTaskNow( const CC3BackgrounderTask& task );
+
+	static void*		runWorkerThread( void* backgrounder );
 
 protected:
-	//dispatch_queue_t	_taskQueue;
-	long				m_queuePriority;
-	bool				m_shouldRunTasksOnRequestingThread : 1;
+	std::vector<CC3BackgrounderTask>	m_pendingTasks;
+	std::vector<CC3BackgrounderTask>	m_mainThreadTasks;
+	std::vector<CC3BackgrounderTask>	m_completedTasks;
+	std::vector<pthread_t>				m_workerThreads;
+	pthread_mutex_t						m_taskMutex;
+	pthread_cond_t						m_taskCondition;
+	pthread_mutex_t						m_completionMutex;
+	unsigned int						m_maxConcurrentTasks;
+	unsigned int						m_taskSequence;
+	long								m_queuePriority;
+	bool								m_isTerminating : 1;
+	bool								m_shouldRunTasksOnRequestingThread : 1;
 };
 
 
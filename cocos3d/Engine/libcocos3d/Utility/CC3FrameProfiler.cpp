@@ -0,0 +1,286 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+NS_COCOS3D_BEGIN
+
+#define kCC3FrameProfilerDefaultCapacity	65536
+
+/** Atomically increments the specified value, and returns the incremented value. */
+static inline GLuint CC3AtomicIncrement( volatile GLuint* value )
+{
+#ifdef _WIN32
+	return (GLuint)InterlockedIncrement( (volatile LONG*)value );
+#else
+	return __sync_add_and_fetch( value, 1 );
+#endif
+}
+
+/** Ensures that all memory reads and writes before this call complete before any after it. */
+static inline void CC3MemoryBarrier()
+{
+#ifdef _WIN32
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+static volatile bool _isProfiling = false;
+
+CC3FrameProfiler::CC3FrameProfiler()
+{
+	m_events = NULL;
+	m_capacityMask = 0;
+	m_writeCount = 0;
+	m_frameNumber = 0;
+}
+
+CC3FrameProfiler::~CC3FrameProfiler()
+{
+	delete[] m_events;
+}
+
+void CC3FrameProfiler::init()
+{
+	allocateEvents( kCC3FrameProfilerDefaultCapacity );
+}
+
+bool CC3FrameProfiler::isProfiling()
+{
+	return _isProfiling;
+}
+
+void CC3FrameProfiler::setIsProfiling( bool isProfiling )
+{
+	// Create the singleton before any zones can be recorded, possibly on other threads
+	if ( isProfiling )
+		sharedProfiler();
+
+	_isProfiling = isProfiling;
+}
+
+GLuint CC3FrameProfiler::getCapacity()
+{
+	return m_capacityMask + 1;
+}
+
+void CC3FrameProfiler::setCapacity( GLuint capacity )
+{
+	allocateEvents( capacity );
+}
+
+/** Allocates the ring buffer, rounding the capacity up to a power of two. */
+void CC3FrameProfiler::allocateEvents( GLuint capacity )
+{
+	GLuint cap = 1;
+	while ( cap < capacity && cap < 0x80000000 )
+		cap <<= 1;
+
+	delete[] m_events;
+	m_events = new CC3FrameProfilerEvent[cap];
+	memset( (void*)m_events, 0, sizeof(CC3FrameProfilerEvent) * cap );
+	m_capacityMask = cap - 1;
+	m_writeCount = 0;
+}
+
+void CC3FrameProfiler::beginFrame()
+{
+	CC3AtomicIncrement( &m_frameNumber );
+}
+
+GLuint CC3FrameProfiler::getFrameNumber()
+{
+	return m_frameNumber;
+}
+
+GLuint CC3FrameProfiler::getEventCount()
+{
+	return MIN(m_writeCount, m_capacityMask + 1);
+}
+
+/**
+ * Claims the next slot with an atomic increment, and writes the zone into it. The sequence
+ * of the slot is cleared while the zone is written, so that readers can detect a partial write.
+ */
+void CC3FrameProfiler::recordZone( const char* name, unsigned long long startTime, unsigned long long endTime )
+{
+	GLuint writeIdx = CC3AtomicIncrement( &m_writeCount ) - 1;
+	CC3FrameProfilerEvent& evt = m_events[writeIdx & m_capacityMask];
+
+	evt.sequence = 0;
+	CC3MemoryBarrier();
+
+	evt.name = name;
+	evt.startTime = startTime;
+	evt.duration = (endTime > startTime) ? (endTime - startTime) : 0;
+	evt.threadID = CC3Platform::getCurrentThreadID();
+	evt.frame = m_frameNumber;
+
+	CC3MemoryBarrier();
+	evt.sequence = writeIdx + 1;
+}
+
+void CC3FrameProfiler::reset()
+{
+	memset( (void*)m_events, 0, sizeof(CC3FrameProfilerEvent) * (m_capacityMask + 1) );
+	m_writeCount = 0;
+	m_frameNumber = 0;
+}
+
+/**
+ * Copies each slot, and keeps the copy only if the sequence of the slot matched the expected
+ * write index both before and after the copy, meaning no writer touched the slot meanwhile.
+ */
+void CC3FrameProfiler::copyEvents( std::vector<CC3FrameProfilerEvent>& events, GLuint firstFrame, GLuint lastFrame )
+{
+	GLuint endIdx = m_writeCount;
+	GLuint evtCount = MIN(endIdx, m_capacityMask + 1);
+	events.reserve( events.size() + evtCount );
+
+	for (GLuint writeIdx = endIdx - evtCount; writeIdx != endIdx; writeIdx++)
+	{
+		CC3FrameProfilerEvent& slot = m_events[writeIdx & m_capacityMask];
+		if ( slot.sequence != writeIdx + 1 )
+			continue;
+
+		CC3MemoryBarrier();
+		CC3FrameProfilerEvent evt;
+		evt.name = slot.name;
+		evt.startTime = slot.startTime;
+		evt.duration = slot.duration;
+		evt.threadID = slot.threadID;
+		evt.frame = slot.frame;
+		CC3MemoryBarrier();
+
+		if ( slot.sequence != writeIdx + 1 )
+			continue;
+
+		if ( evt.frame < firstFrame || evt.frame > lastFrame )
+			continue;
+
+		evt.sequence = writeIdx + 1;
+		events.push_back( evt );
+	}
+}
+
+/** Appends the specified string to the JSON string, escaping quotes, backslashes and control characters. */
+static void CC3AppendJSONString( std::string& json, const char* str )
+{
+	json += '"';
+	for (const char* c = str; *c; c++)
+	{
+		if ( *c == '"' || *c == '\\' )
+		{
+			json += '\\';
+			json += *c;
+		}
+		else if ( (unsigned char)*c < 0x20 )
+			json += ' ';
+		else
+			json += *c;
+	}
+	json += '"';
+}
+
+std::string CC3FrameProfiler::getChromeTrace()
+{
+	return getChromeTraceForFrames( 0, 0xFFFFFFFF );
+}
+
+/**
+ * Each zone is exported as a complete ("X") event. Chrome trace timestamps are in microseconds,
+ * so the nanosecond times are written with three decimal places.
+ */
+std::string CC3FrameProfiler::getChromeTraceForFrames( GLuint firstFrame, GLuint lastFrame )
+{
+	std::vector<CC3FrameProfilerEvent> events;
+	copyEvents( events, firstFrame, lastFrame );
+
+	unsigned long long baseTime = 0;
+	if ( !events.empty() )
+	{
+		baseTime = events[0].startTime;
+		for (GLuint i = 1; i < events.size(); i++)
+			baseTime = MIN(baseTime, events[i].startTime);
+	}
+
+	std::string json;
+	json.reserve( 128 + events.size() * 128 );
+	json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	char buff[256];
+	for (GLuint i = 0; i < events.size(); i++)
+	{
+		const CC3FrameProfilerEvent& evt = events[i];
+		unsigned long long ts = evt.startTime - baseTime;
+
+		if ( i > 0 )
+			json += ',';
+		json += "\n{\"name\":";
+		CC3AppendJSONString( json, evt.name );
+		sprintf( buff, ",\"cat\":\"cocos3d\",\"ph\":\"X\",\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":1,\"tid\":%lu,\"args\":{\"frame\":%u}}",
+				ts / 1000, (GLuint)(ts % 1000), evt.duration / 1000, (GLuint)(evt.duration % 1000),
+				evt.threadID, evt.frame );
+		json += buff;
+	}
+
+	json += "\n]}\n";
+	return json;
+}
+
+bool CC3FrameProfiler::writeChromeTraceToFile( const std::string& filePath )
+{
+	FILE* file = fopen( filePath.c_str(), "wb" );
+	if ( !file )
+	{
+		CCLOGERROR( "CC3FrameProfiler could not open file %s for writing", filePath.c_str() );
+		return false;
+	}
+
+	std::string json = getChromeTrace();
+	bool wasWritten = (fwrite( json.data(), 1, json.size(), file ) == json.size());
+	fclose( file );
+	return wasWritten;
+}
+
+static CC3FrameProfiler* _sharedProfiler = NULL;
+
+CC3FrameProfiler* CC3FrameProfiler::sharedProfiler()
+{
+	if ( !_sharedProfiler )
+	{
+		_sharedProfiler = new CC3FrameProfiler;		// retained
+		_sharedProfiler->init();
+	}
+
+	return _sharedProfiler;
+}
+
+NS_COCOS3D_END
@@ -0,0 +1,182 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_FRAME_PROFILER_H_
+#define _CC3_FRAME_PROFILER_H_
+
+NS_COCOS3D_BEGIN
+
+/** A single timed zone, as held in the ring buffer of the CC3FrameProfiler. */
+typedef struct {
+	const char*			name;			/**< The name of the zone. Must be a static string. */
+	unsigned long long	startTime;		/**< The start of the zone, in nanoseconds. */
+	unsigned long long	duration;		/**< The duration of the zone, in nanoseconds. */
+	unsigned long		threadID;		/**< The thread on which the zone ran. */
+	GLuint				frame;			/**< The frame number during which the zone ended. */
+	volatile GLuint		sequence;		/**< Zero while being written, otherwise the write index plus one. */
+} CC3FrameProfilerEvent;
+
+/**
+ * CC3FrameProfiler collects scoped, nested timing zones from any thread, and exports them in the
+ * Chrome trace event JSON format, which can be viewed in the chrome://tracing page of the Chrome
+ * browser, or in a viewer such as Perfetto.
+ *
+ * Zones are declared with the CC3_PROFILE_ZONE macro, which times the enclosing C++ scope:
+ *
+ *   void MyScene::updateBeforeTransform( CC3NodeUpdatingVisitor* visitor )
+ *   {
+ *       CC3_PROFILE_ZONE( "MyScene::updateBeforeTransform" );
+ *       ...
+ *   }
+ *
+ * Zones nest naturally, and the trace viewer displays nested zones on the same thread as a
+ * hierarchy. The library itself declares zones around scene updating and drawing, node visitors,
+ * drawing sequencer updates, shader program binding, texture loading, and resource loading.
+ *
+ * Profiling is off by default, and a zone costs only a single check when it is off. Turn it on
+ * with setIsProfiling. To remove the zones from the library entirely, define CC3_PROFILING as 0
+ * in the build settings.
+ *
+ * Zones are written to a fixed-size ring buffer without locks. Each writer claims a slot with an
+ * atomic increment, so writers never block each other, and the oldest zones are overwritten once
+ * the buffer is full. Export can run while zones are being written, and skips any slot that is
+ * being written or overwritten while it is copied.
+ *
+ * Each zone is tagged with the current frame number, which is advanced by the beginFrame method.
+ * CC3Scene invokes beginFrame at the start of each update when profiling is on, so that the
+ * zones of individual frames can be exported using the getChromeTraceForFrames method.
+ */
+class CC3FrameProfiler : public CCObject 
+{
+public:
+	CC3FrameProfiler();
+	~CC3FrameProfiler();
+
+	/** Returns whether profiling is currently on. Zones are only recorded while this is YES. */
+	static bool					isProfiling();
+
+	/** Turns profiling on or off. The initial value is NO. */
+	static void					setIsProfiling( bool isProfiling );
+
+	/** 
+	 * The number of zones that the ring buffer can hold. Once full, the oldest zones are overwritten.
+	 * This value is always a power of two. The initial value is 65536.
+	 *
+	 * Setting this property discards all recorded zones. This property should only be set while
+	 * profiling is off, and no zones are being recorded on other threads.
+	 */
+	GLuint						getCapacity();
+	void						setCapacity( GLuint capacity );
+
+	/** Advances the frame number. Zones that end after this call are tagged with the new frame number. */
+	void						beginFrame();
+
+	/** Returns the current frame number. */
+	GLuint						getFrameNumber();
+
+	/** Returns the number of zones currently held in the ring buffer. */
+	GLuint						getEventCount();
+
+	/**
+	 * Records a zone with the specified static name, start time and end time, in the nanoseconds
+	 * returned by CC3Platform::getCurrentNanoseconds. This method is thread-safe and lock-free.
+	 *
+	 * This is invoked automatically by CC3_PROFILE_ZONE, but may also be used directly to record
+	 * a zone whose start and end do not fall within a single C++ scope.
+	 */
+	void						recordZone( const char* name, unsigned long long startTime, unsigned long long endTime );
+
+	/** Discards all recorded zones, and resets the frame number to zero. */
+	void						reset();
+
+	/** 
+	 * Copies the zones in the ring buffer that were tagged with a frame number in the specified
+	 * range, inclusive, into the specified vector, in the order they were recorded.
+	 */
+	void						copyEvents( std::vector<CC3FrameProfilerEvent>& events, GLuint firstFrame, GLuint lastFrame );
+
+	/** Returns all zones held in the ring buffer, in the Chrome trace event JSON format. */
+	std::string					getChromeTrace();
+
+	/** 
+	 * Returns the zones held in the ring buffer that were tagged with a frame number in the
+	 * specified range, inclusive, in the Chrome trace event JSON format.
+	 */
+	std::string					getChromeTraceForFrames( GLuint firstFrame, GLuint lastFrame );
+
+	/** Writes all zones held in the ring buffer to the specified file, in Chrome trace event JSON format. */
+	bool						writeChromeTraceToFile( const std::string& filePath );
+
+	/** Returns the singleton profiler instance. */
+	static CC3FrameProfiler*	sharedProfiler();
+
+protected:
+	void						init();
+	void						allocateEvents( GLuint capacity );
+
+protected:
+	CC3FrameProfilerEvent*		m_events;
+	GLuint						m_capacityMask;
+	volatile GLuint				m_writeCount;
+	volatile GLuint				m_frameNumber;
+};
+
+/**
+ * Times the C++ scope in which it is declared, and records it with the CC3FrameProfiler on exit.
+ * Declare instances using the CC3_PROFILE_ZONE macro. The name must be a static string.
+ * A NULL name records nothing, which allows a zone to be declared conditionally.
+ */
+class CC3ProfileZone
+{
+public:
+	CC3ProfileZone( const char* name )
+	{
+		m_name = (name && CC3FrameProfiler::isProfiling()) ? name : NULL;
+		m_startTime = m_name ? CC3Platform::getCurrentNanoseconds() : 0;
+	}
+
+	~CC3ProfileZone()
+	{
+		if ( m_name )
+			CC3FrameProfiler::sharedProfiler()->recordZone( m_name, m_startTime, CC3Platform::getCurrentNanoseconds() );
+	}
+
+protected:
+	const char*					m_name;
+	unsigned long long			m_startTime;
+};
+
+#if CC3_PROFILING
+#	define CC3_PROFILE_ZONE_CONCAT_(a, b)	a##b
+#	define CC3_PROFILE_ZONE_CONCAT(a, b)	CC3_PROFILE_ZONE_CONCAT_(a, b)
+	/** Times the enclosing scope as a zone with the specified static name. */
+#	define CC3_PROFILE_ZONE(name)			CC3ProfileZone CC3_PROFILE_ZONE_CONCAT(_cc3ProfileZone, __LINE__)( name )
+#else
+#	define CC3_PROFILE_ZONE(name)
+#endif
+
+NS_COCOS3D_END
+
+#endif
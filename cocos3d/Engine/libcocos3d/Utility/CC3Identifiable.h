@@ -45,7 +45,7 @@ public:
 	 * automatically by using an initializer that does not explicitly set the tag.
 	 */
 	GLuint						getTag();
-	void						setTag( GLuint tag );
+	virtual void				setTag( GLuint tag );
 
 	/**
 	 * An arbitrary name for this object. It is not necessary to give all identifiable objects
@@ -99,6 +99,41 @@ void CC3PerformanceStatistics::addSingleCallFacesPresented( GLuint faceCount )
 	m_facesPresented += faceCount;
 }
 
+void CC3PerformanceStatistics::addDrawCommandsExecuted( GLuint commandCount )
+{
+	m_drawCommandsExecuted += commandCount; 
+}
+
+void CC3PerformanceStatistics::addMaterialBindingsElided( GLuint elidedCount )
+{
+	m_materialBindingsElided += elidedCount; 
+}
+
+void CC3PerformanceStatistics::addMeshBindingsElided( GLuint elidedCount )
+{
+	m_meshBindingsElided += elidedCount; 
+}
+
+void CC3PerformanceStatistics::addLODFacesPresented( GLuint lodLevel, GLuint faceCount )
+{
+	lodLevel = MIN(lodLevel, kCC3MaxLODLevels - 1);
+	m_lodNodesDrawn[lodLevel]++;
+	m_lodFacesPresented[lodLevel] += faceCount;
+}
+
+void CC3PerformanceStatistics::addStaticBatchDrawn( GLuint memberCount )
+{
+	m_staticBatchesDrawn++;
+	m_staticBatchMembersDrawn += memberCount;
+}
+
+void CC3PerformanceStatistics::addAnimationUpdates( GLuint fullCount, GLuint reducedCount, GLuint skippedCount )
+{
+	m_fullAnimationUpdates += fullCount;
+	m_reducedAnimationUpdates += reducedCount;
+	m_skippedAnimationUpdates += skippedCount;
+}
+
 GLfloat CC3PerformanceStatistics::getUpdateRate()
 {
 	return m_accumulatedUpdateTime ? ((GLfloat)m_updatesHandled / m_accumulatedUpdateTime) : 0.0f;
@@ -134,11 +169,21 @@ GLfloat CC3PerformanceStatistics::getAverageDrawingCallsMadePerFrame()
 	return m_framesHandled ? ((GLfloat)m_drawingCallsMade / (GLfloat)m_framesHandled) : 0.0f;
 }
 
+GLfloat CC3PerformanceStatistics::getAverageDrawCommandsExecutedPerFrame()
+{
+	return m_framesHandled ? ((GLfloat)m_drawCommandsExecuted / (GLfloat)m_framesHandled) : 0.0f;
+}
+
 GLfloat CC3PerformanceStatistics::getAverageFacesPresentedPerFrame()
 {
 	return m_framesHandled ? ((GLfloat)m_facesPresented / (GLfloat)m_framesHandled) : 0.0f;
 }
 
+GLfloat CC3PerformanceStatistics::getAverageLODFacesPresentedPerFrame( GLuint lodLevel )
+{
+	return m_framesHandled ? ((GLfloat)getLODFacesPresented( lodLevel ) / (GLfloat)m_framesHandled) : 0.0f;
+}
+
 void CC3PerformanceStatistics::init()
 {
 	reset();
@@ -166,6 +211,16 @@ void CC3PerformanceStatistics::reset()
 	m_nodesDrawn = 0;
 	m_drawingCallsMade = 0;
 	m_facesPresented = 0;
+	m_drawCommandsExecuted = 0;
+	m_materialBindingsElided = 0;
+	m_meshBindingsElided = 0;
+	memset(m_lodNodesDrawn, 0, kCC3MaxLODLevels * sizeof(m_lodNodesDrawn[0]));
+	memset(m_lodFacesPresented, 0, kCC3MaxLODLevels * sizeof(m_lodFacesPresented[0]));
+	m_staticBatchesDrawn = 0;
+	m_staticBatchMembersDrawn = 0;
+	m_fullAnimationUpdates = 0;
+	m_reducedAnimationUpdates = 0;
+	m_skippedAnimationUpdates = 0;
 }
 
 void CC3PerformanceStatistics::populateFrom( CC3PerformanceStatistics* another )
@@ -181,6 +236,19 @@ void CC3PerformanceStatistics::populateFrom( CC3PerformanceStatistics* another )
 	m_nodesDrawn = another->getNodesDrawn();
 	m_drawingCallsMade = another->getDrawingCallsMade();
 	m_facesPresented = another->getFacesPresented();
+	m_drawCommandsExecuted = another->getDrawCommandsExecuted();
+	m_materialBindingsElided = another->getMaterialBindingsElided();
+	m_meshBindingsElided = another->getMeshBindingsElided();
+	for (GLuint i = 0; i < kCC3MaxLODLevels; i++)
+	{
+		m_lodNodesDrawn[i] = another->getLODNodesDrawn( i );
+		m_lodFacesPresented[i] = another->getLODFacesPresented( i );
+	}
+	m_staticBatchesDrawn = another->getStaticBatchesDrawn();
+	m_staticBatchMembersDrawn = another->getStaticBatchMembersDrawn();
+	m_fullAnimationUpdates = another->getFullAnimationUpdates();
+	m_reducedAnimationUpdates = another->getReducedAnimationUpdates();
+	m_skippedAnimationUpdates = another->getSkippedAnimationUpdates();
 }
 
 CCObject* CC3PerformanceStatistics::copyWithZone( CCZone* zone )
@@ -198,6 +266,61 @@ std::string CC3PerformanceStatistics::fullDescription()
 			getAverageDrawingCallsMadePerFrame(), getAverageFacesPresentedPerFrame() );
 }
 
+GLuint CC3PerformanceStatistics::getLODNodesDrawn( GLuint lodLevel )
+{
+	return m_lodNodesDrawn[MIN(lodLevel, kCC3MaxLODLevels - 1)];
+}
+
+GLuint CC3PerformanceStatistics::getLODFacesPresented( GLuint lodLevel )
+{
+	return m_lodFacesPresented[MIN(lodLevel, kCC3MaxLODLevels - 1)];
+}
+
+GLuint CC3PerformanceStatistics::getStaticBatchesDrawn()
+{
+	return m_staticBatchesDrawn;
+}
+
+GLuint CC3PerformanceStatistics::getStaticBatchMembersDrawn()
+{
+	return m_staticBatchMembersDrawn;
+}
+
+GLuint CC3PerformanceStatistics::getDrawingCallsSavedByStaticBatching()
+{
+	return m_staticBatchMembersDrawn - m_staticBatchesDrawn;
+}
+
+GLuint CC3PerformanceStatistics::getFullAnimationUpdates()
+{
+	return m_fullAnimationUpdates;
+}
+
+GLuint CC3PerformanceStatistics::getReducedAnimationUpdates()
+{
+	return m_reducedAnimationUpdates;
+}
+
+GLuint CC3PerformanceStatistics::getSkippedAnimationUpdates()
+{
+	return m_skippedAnimationUpdates;
+}
+
+GLuint CC3PerformanceStatistics::getMeshBindingsElided()
+{
+	return m_meshBindingsElided;
+}
+
+GLuint CC3PerformanceStatistics::getMaterialBindingsElided()
+{
+	return m_materialBindingsElided;
+}
+
+GLuint CC3PerformanceStatistics::getDrawCommandsExecuted()
+{
+	return m_drawCommandsExecuted;
+}
+
 GLuint CC3PerformanceStatistics::getFacesPresented()
 {
 	return m_facesPresented;
@@ -31,6 +31,10 @@
 #define _CCL_PERFORMANCE_STATISTICS_H_
 
 NS_COCOS3D_BEGIN
+
+/** The number of level-of-detail levels for which statistics are collected separately. */
+#define kCC3MaxLODLevels 8
+
 /**
  * Collects statistics about the updating and drawing performance of the 3D scene.
  *
@@ -149,6 +153,107 @@ public:
 	 */
 	void						addSingleCallFacesPresented( GLuint faceCount );
 
+	/**
+	 * The total number of draw commands executed from a CC3DrawCommandQueue since the
+	 * reset method was last invoked.
+	 */
+	GLuint						getDrawCommandsExecuted();
+
+	/** Adds the specified number of commands to the drawCommandsExecuted property.  */
+	void						addDrawCommandsExecuted( GLuint commandCount );
+
+	/**
+	 * The total number of times a draw command was executed without applying its material,
+	 * because the previous command used the same material and shader program, since the
+	 * reset method was last invoked.
+	 */
+	GLuint						getMaterialBindingsElided();
+
+	/** Adds the specified number of elided bindings to the materialBindingsElided property.  */
+	void						addMaterialBindingsElided( GLuint elidedCount );
+
+	/**
+	 * The total number of times a draw command was executed without binding its mesh and
+	 * vertex attributes, because the previous command used the same mesh and shader program,
+	 * since the reset method was last invoked.
+	 */
+	GLuint						getMeshBindingsElided();
+
+	/** Adds the specified number of elided bindings to the meshBindingsElided property.  */
+	void						addMeshBindingsElided( GLuint elidedCount );
+
+	/**
+	 * The total number of mesh nodes drawn using the mesh at the specified level of detail since the
+	 * reset method was last invoked. Level zero is the full-detail mesh of each mesh node, including
+	 * mesh nodes that have no level-of-detail meshes. Levels at or beyond kCC3MaxLODLevels are all
+	 * counted in the last level.
+	 */
+	GLuint						getLODNodesDrawn( GLuint lodLevel );
+
+	/**
+	 * The total number of faces presented to the GL engine by mesh nodes drawn using the mesh at
+	 * the specified level of detail since the reset method was last invoked. Levels at or beyond
+	 * kCC3MaxLODLevels are all counted in the last level.
+	 */
+	GLuint						getLODFacesPresented( GLuint lodLevel );
+
+	/**
+	 * Increments the number of mesh nodes drawn at the specified level of detail by one, and adds
+	 * the specified number of faces to the faces presented at that level of detail.
+	 */
+	void						addLODFacesPresented( GLuint lodLevel, GLuint faceCount );
+
+	/**
+	 * The total number of CC3StaticBatchNodes drawn since the reset method was last invoked.
+	 * Each static batch is drawn with a single drawing call.
+	 */
+	GLuint						getStaticBatchesDrawn();
+
+	/**
+	 * The total number of mesh nodes drawn as members of the CC3StaticBatchNodes that were drawn
+	 * since the reset method was last invoked.
+	 */
+	GLuint						getStaticBatchMembersDrawn();
+
+	/**
+	 * The total number of drawing calls saved by static batching since the reset method was last
+	 * invoked, calculated by subtracting the staticBatchesDrawn property from the
+	 * staticBatchMembersDrawn property.
+	 */
+	GLuint						getDrawingCallsSavedByStaticBatching();
+
+	/**
+	 * Increments the staticBatchesDrawn property by one, and adds the specified number of
+	 * member nodes to the staticBatchMembersDrawn property.
+	 */
+	void						addStaticBatchDrawn( GLuint memberCount );
+
+	/**
+	 * The total number of times the animation of a node with an animation update policy was
+	 * evaluated at the full update rate, since the reset method was last invoked.
+	 */
+	GLuint						getFullAnimationUpdates();
+
+	/**
+	 * The total number of times the animation of a node with an animation update policy was
+	 * evaluated at a reduced update rate, because the node was small on screen, or outside the
+	 * camera frustum, since the reset method was last invoked.
+	 */
+	GLuint						getReducedAnimationUpdates();
+
+	/**
+	 * The total number of times the evaluation of the animation of a node with an animation update
+	 * policy was skipped, because the node was small on screen, or outside the camera frustum,
+	 * since the reset method was last invoked.
+	 */
+	GLuint						getSkippedAnimationUpdates();
+
+	/**
+	 * Adds the specified numbers of full, reduced and skipped animation evaluations to the
+	 * fullAnimationUpdates, reducedAnimationUpdates and skippedAnimationUpdates properties.
+	 */
+	void						addAnimationUpdates( GLuint fullCount, GLuint reducedCount, GLuint skippedCount );
+
 	/**
 	 * The average update rate, calculated by dividing the
 	 * updatesHandled property by the accumulatedUpdateTime property.
@@ -199,6 +304,12 @@ public:
 	 */
 	GLfloat						getAverageDrawingCallsMadePerFrame();
 
+	/**
+	 * The average draw commands executed per drawing frame, calculated by dividing the
+	 * drawCommandsExecuted property by the framesHandled property.
+	 */
+	GLfloat						getAverageDrawCommandsExecutedPerFrame();
+
 	/**
 	 * The average number of triangle faces presented to the GL engine per drawing frame,
 	 * calculated by dividing the facesPresented property by the framesHandled property.
@@ -210,6 +321,13 @@ public:
 	 */
 	GLfloat						getAverageFacesPresentedPerFrame();
 
+	/**
+	 * The average number of faces presented to the GL engine per drawing frame by mesh nodes drawn
+	 * at the specified level of detail, calculated by dividing the value returned by the
+	 * getLODFacesPresented method by the framesHandled property.
+	 */
+	GLfloat						getAverageLODFacesPresentedPerFrame( GLuint lodLevel );
+
 	/** Allocates and initializes an autoreleased instance. */
 	static CC3PerformanceStatistics* statistics();
 
@@ -242,6 +360,16 @@ protected:
 	GLuint						m_nodesDrawn;
 	GLuint						m_drawingCallsMade;
 	GLuint						m_facesPresented;
+	GLuint						m_drawCommandsExecuted;
+	GLuint						m_materialBindingsElided;
+	GLuint						m_meshBindingsElided;
+	GLuint						m_lodNodesDrawn[kCC3MaxLODLevels];
+	GLuint						m_lodFacesPresented[kCC3MaxLODLevels];
+	GLuint						m_staticBatchesDrawn;
+	GLuint						m_staticBatchMembersDrawn;
+	GLuint						m_fullAnimationUpdates;
+	GLuint						m_reducedAnimationUpdates;
+	GLuint						m_skippedAnimationUpdates;
 };
 
 // Number of buckets in each of the histograms
@@ -0,0 +1,249 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_SIMD_H_
+#define _CC3_SIMD_H_
+
+#if CC3_SIMD_SSE
+#include <xmmintrin.h>
+#elif CC3_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+NS_COCOS3D_BEGIN
+
+/**
+ * CC3Float4 is a minimal four-wide float abstraction over SSE, NEON or plain C, selected by
+ * the CC3_SIMD_SSE and CC3_SIMD_NEON build settings, so that each vector kernel is written
+ * once and runs on all platforms.
+ *
+ * Loads and stores are unaligned. The f4Recip and f4RecipSqrt functions are exact on SSE and
+ * plain C, and are estimates refined by two Newton-Raphson steps on NEON.
+ */
+#if CC3_SIMD_SSE
+
+typedef __m128 CC3Float4;
+
+static inline CC3Float4 f4Load( const GLfloat* p ) { return _mm_loadu_ps( p ); }
+static inline void f4Store( GLfloat* p, CC3Float4 a ) { _mm_storeu_ps( p, a ); }
+static inline CC3Float4 f4Splat( GLfloat s ) { return _mm_set1_ps( s ); }
+static inline CC3Float4 f4Set( GLfloat x, GLfloat y, GLfloat z, GLfloat w ) { return _mm_set_ps( w, z, y, x ); }
+static inline CC3Float4 f4Zero() { return _mm_setzero_ps(); }
+static inline CC3Float4 f4Add( CC3Float4 a, CC3Float4 b ) { return _mm_add_ps( a, b ); }
+static inline CC3Float4 f4Sub( CC3Float4 a, CC3Float4 b ) { return _mm_sub_ps( a, b ); }
+static inline CC3Float4 f4Mul( CC3Float4 a, CC3Float4 b ) { return _mm_mul_ps( a, b ); }
+static inline CC3Float4 f4MulAdd( CC3Float4 acc, CC3Float4 a, CC3Float4 b ) { return _mm_add_ps( acc, _mm_mul_ps( a, b ) ); }
+static inline CC3Float4 f4Negate( CC3Float4 a ) { return _mm_sub_ps( _mm_setzero_ps(), a ); }
+static inline CC3Float4 f4Max( CC3Float4 a, CC3Float4 b ) { return _mm_max_ps( a, b ); }
+static inline CC3Float4 f4Recip( CC3Float4 a ) { return _mm_div_ps( _mm_set1_ps( 1.0f ), a ); }
+static inline CC3Float4 f4RecipSqrt( CC3Float4 a ) { return _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( a ) ); }
+
+/** Returns a, negated in each lane in which d is negative. */
+static inline CC3Float4 f4NegateWhereNegative( CC3Float4 a, CC3Float4 d )
+{
+	__m128 signMask = _mm_and_ps( _mm_cmplt_ps( d, _mm_setzero_ps() ), _mm_set1_ps( -0.0f ) );
+	return _mm_xor_ps( a, signMask );
+}
+
+/** Returns a four-bit mask, with bit i set if lane i of a is greater than zero. */
+static inline unsigned int f4PositiveMask( CC3Float4 a ) { return (unsigned int)_mm_movemask_ps( _mm_cmpgt_ps( a, _mm_setzero_ps() ) ); }
+
+/** Transposes the 4x4 matrix whose rows (or columns) are held in the four arguments. */
+static inline void f4Transpose( CC3Float4& a, CC3Float4& b, CC3Float4& c, CC3Float4& d ) { _MM_TRANSPOSE4_PS( a, b, c, d ); }
+
+/** Loads four packed three-component vectors from p, returning their X, Y and Z components in x, y and z. */
+static inline void f4LoadVector3x4( const GLfloat* p, CC3Float4& x, CC3Float4& y, CC3Float4& z )
+{
+	__m128 a = _mm_loadu_ps( p );			// x0 y0 z0 x1
+	__m128 b = _mm_loadu_ps( p + 4 );		// y1 z1 x2 y2
+	__m128 c = _mm_loadu_ps( p + 8 );		// z2 x3 y3 z3
+	x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE(1, 0, 3, 2) ), _MM_SHUFFLE(3, 0, 3, 0) );
+	y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE(0, 0, 1, 1) ), _mm_shuffle_ps( b, c, _MM_SHUFFLE(2, 2, 3, 3) ), _MM_SHUFFLE(2, 0, 2, 0) );
+	z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE(1, 1, 2, 2) ), _mm_shuffle_ps( c, c, _MM_SHUFFLE(3, 3, 0, 0) ), _MM_SHUFFLE(2, 0, 2, 0) );
+}
+
+/** Stores the X, Y and Z components in x, y and z to p, as four packed three-component vectors. */
+static inline void f4StoreVector3x4( GLfloat* p, CC3Float4 x, CC3Float4 y, CC3Float4 z )
+{
+	__m128 xy01 = _mm_unpacklo_ps( x, y );
+	__m128 xy23 = _mm_unpackhi_ps( x, y );
+	_mm_storeu_ps( p, _mm_shuffle_ps( xy01, _mm_shuffle_ps( z, x, _MM_SHUFFLE(1, 1, 0, 0) ), _MM_SHUFFLE(2, 0, 1, 0) ) );
+	_mm_storeu_ps( p + 4, _mm_shuffle_ps( _mm_shuffle_ps( y, z, _MM_SHUFFLE(1, 1, 1, 1) ), xy23, _MM_SHUFFLE(1, 0, 2, 0) ) );
+	_mm_storeu_ps( p + 8, _mm_shuffle_ps( _mm_shuffle_ps( z, x, _MM_SHUFFLE(3, 3, 2, 2) ), _mm_shuffle_ps( y, z, _MM_SHUFFLE(3, 3, 3, 3) ), _MM_SHUFFLE(2, 0, 2, 0) ) );
+}
+
+#elif CC3_SIMD_NEON
+
+typedef float32x4_t CC3Float4;
+
+static inline CC3Float4 f4Load( const GLfloat* p ) { return vld1q_f32( p ); }
+static inline void f4Store( GLfloat* p, CC3Float4 a ) { vst1q_f32( p, a ); }
+static inline CC3Float4 f4Splat( GLfloat s ) { return vdupq_n_f32( s ); }
+static inline CC3Float4 f4Set( GLfloat x, GLfloat y, GLfloat z, GLfloat w ) { GLfloat v[4] = { x, y, z, w }; return vld1q_f32( v ); }
+static inline CC3Float4 f4Zero() { return vdupq_n_f32( 0.0f ); }
+static inline CC3Float4 f4Add( CC3Float4 a, CC3Float4 b ) { return vaddq_f32( a, b ); }
+static inline CC3Float4 f4Sub( CC3Float4 a, CC3Float4 b ) { return vsubq_f32( a, b ); }
+static inline CC3Float4 f4Mul( CC3Float4 a, CC3Float4 b ) { return vmulq_f32( a, b ); }
+static inline CC3Float4 f4MulAdd( CC3Float4 acc, CC3Float4 a, CC3Float4 b ) { return vmlaq_f32( acc, a, b ); }
+static inline CC3Float4 f4Negate( CC3Float4 a ) { return vnegq_f32( a ); }
+static inline CC3Float4 f4Max( CC3Float4 a, CC3Float4 b ) { return vmaxq_f32( a, b ); }
+
+/** Reciprocal estimate, refined by two Newton-Raphson steps. */
+static inline CC3Float4 f4Recip( CC3Float4 a )
+{
+	float32x4_t e = vrecpeq_f32( a );
+	e = vmulq_f32( e, vrecpsq_f32( a, e ) );
+	return vmulq_f32( e, vrecpsq_f32( a, e ) );
+}
+
+/** Reciprocal square root estimate, refined by two Newton-Raphson steps. */
+static inline CC3Float4 f4RecipSqrt( CC3Float4 a )
+{
+	float32x4_t e = vrsqrteq_f32( a );
+	e = vmulq_f32( e, vrsqrtsq_f32( vmulq_f32( a, e ), e ) );
+	return vmulq_f32( e, vrsqrtsq_f32( vmulq_f32( a, e ), e ) );
+}
+
+/** Returns a, negated in each lane in which d is negative. */
+static inline CC3Float4 f4NegateWhereNegative( CC3Float4 a, CC3Float4 d )
+{
+	return vbslq_f32( vcltq_f32( d, vdupq_n_f32( 0.0f ) ), vnegq_f32( a ), a );
+}
+
+/** Returns a four-bit mask, with bit i set if lane i of a is greater than zero. */
+static inline unsigned int f4PositiveMask( CC3Float4 a )
+{
+	uint32_t flags[4];
+	vst1q_u32( flags, vandq_u32( vcgtq_f32( a, vdupq_n_f32( 0.0f ) ), vdupq_n_u32( 1 ) ) );
+	return flags[0] | (flags[1] << 1) | (flags[2] << 2) | (flags[3] << 3);
+}
+
+/** Transposes the 4x4 matrix whose rows (or columns) are held in the four arguments. */
+static inline void f4Transpose( CC3Float4& a, CC3Float4& b, CC3Float4& c, CC3Float4& d )
+{
+	float32x4x2_t ab = vtrnq_f32( a, b );
+	float32x4x2_t cd = vtrnq_f32( c, d );
+	a = vcombine_f32( vget_low_f32( ab.val[0] ), vget_low_f32( cd.val[0] ) );
+	b = vcombine_f32( vget_low_f32( ab.val[1] ), vget_low_f32( cd.val[1] ) );
+	c = vcombine_f32( vget_high_f32( ab.val[0] ), vget_high_f32( cd.val[0] ) );
+	d = vcombine_f32( vget_high_f32( ab.val[1] ), vget_high_f32( cd.val[1] ) );
+}
+
+/** Loads four packed three-component vectors from p, returning their X, Y and Z components in x, y and z. */
+static inline void f4LoadVector3x4( const GLfloat* p, CC3Float4& x, CC3Float4& y, CC3Float4& z )
+{
+	float32x4x3_t v = vld3q_f32( p );
+	x = v.val[0];
+	y = v.val[1];
+	z = v.val[2];
+}
+
+/** Stores the X, Y and Z components in x, y and z to p, as four packed three-component vectors. */
+static inline void f4StoreVector3x4( GLfloat* p, CC3Float4 x, CC3Float4 y, CC3Float4 z )
+{
+	float32x4x3_t v;
+	v.val[0] = x;
+	v.val[1] = y;
+	v.val[2] = z;
+	vst3q_f32( p, v );
+}
+
+#else
+
+typedef struct { GLfloat v[4]; } CC3Float4;
+
+static inline CC3Float4 f4Load( const GLfloat* p ) { CC3Float4 r; for (int i = 0; i < 4; i++) r.v[i] = p[i]; return r; }
+static inline void f4Store( GLfloat* p, CC3Float4 a ) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline CC3Float4 f4Splat( GLfloat s ) { CC3Float4 r; for (int i = 0; i < 4; i++) r.v[i] = s; return r; }
+static inline CC3Float4 f4Set( GLfloat x, GLfloat y, GLfloat z, GLfloat w ) { CC3Float4 r = { { x, y, z, w } }; return r; }
+static inline CC3Float4 f4Zero() { return f4Splat( 0.0f ); }
+static inline CC3Float4 f4Add( CC3Float4 a, CC3Float4 b ) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+static inline CC3Float4 f4Sub( CC3Float4 a, CC3Float4 b ) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+static inline CC3Float4 f4Mul( CC3Float4 a, CC3Float4 b ) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+static inline CC3Float4 f4MulAdd( CC3Float4 acc, CC3Float4 a, CC3Float4 b ) { for (int i = 0; i < 4; i++) acc.v[i] += a.v[i] * b.v[i]; return acc; }
+static inline CC3Float4 f4Negate( CC3Float4 a ) { for (int i = 0; i < 4; i++) a.v[i] = -a.v[i]; return a; }
+static inline CC3Float4 f4Max( CC3Float4 a, CC3Float4 b ) { for (int i = 0; i < 4; i++) a.v[i] = MAX( a.v[i], b.v[i] ); return a; }
+static inline CC3Float4 f4Recip( CC3Float4 a ) { for (int i = 0; i < 4; i++) a.v[i] = 1.0f / a.v[i]; return a; }
+static inline CC3Float4 f4RecipSqrt( CC3Float4 a ) { for (int i = 0; i < 4; i++) a.v[i] = 1.0f / sqrtf( a.v[i] ); return a; }
+
+/** Returns a, negated in each lane in which d is negative. */
+static inline CC3Float4 f4NegateWhereNegative( CC3Float4 a, CC3Float4 d )
+{
+	for (int i = 0; i < 4; i++)
+		if ( d.v[i] < 0.0f )
+			a.v[i] = -a.v[i];
+	return a;
+}
+
+/** Returns a four-bit mask, with bit i set if lane i of a is greater than zero. */
+static inline unsigned int f4PositiveMask( CC3Float4 a )
+{
+	unsigned int mask = 0;
+	for (int i = 0; i < 4; i++)
+		if ( a.v[i] > 0.0f )
+			mask |= (1u << i);
+	return mask;
+}
+
+/** Transposes the 4x4 matrix whose rows (or columns) are held in the four arguments. */
+static inline void f4Transpose( CC3Float4& a, CC3Float4& b, CC3Float4& c, CC3Float4& d )
+{
+	CC3Float4* m[4] = { &a, &b, &c, &d };
+	for (int i = 0; i < 4; i++)
+		for (int j = i + 1; j < 4; j++)
+		{
+			GLfloat tmp = m[i]->v[j];
+			m[i]->v[j] = m[j]->v[i];
+			m[j]->v[i] = tmp;
+		}
+}
+
+/** Loads four packed three-component vectors from p, returning their X, Y and Z components in x, y and z. */
+static inline void f4LoadVector3x4( const GLfloat* p, CC3Float4& x, CC3Float4& y, CC3Float4& z )
+{
+	for (int i = 0; i < 4; i++)
+	{
+		x.v[i] = p[i * 3];
+		y.v[i] = p[i * 3 + 1];
+		z.v[i] = p[i * 3 + 2];
+	}
+}
+
+/** Stores the X, Y and Z components in x, y and z to p, as four packed three-component vectors. */
+static inline void f4StoreVector3x4( GLfloat* p, CC3Float4 x, CC3Float4 y, CC3Float4 z )
+{
+	for (int i = 0; i < 4; i++)
+	{
+		p[i * 3] = x.v[i];
+		p[i * 3 + 1] = y.v[i];
+		p[i * 3 + 2] = z.v[i];
+	}
+}
+
+#endif
+
+NS_COCOS3D_END
+
+#endif
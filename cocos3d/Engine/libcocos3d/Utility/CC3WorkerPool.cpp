@@ -0,0 +1,185 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+static void* runWorkerPoolThread( void* arg )
+{
+	((CC3WorkerPool*)arg)->serviceJobs();
+	return NULL;
+}
+
+CC3WorkerPool::CC3WorkerPool()
+{
+	m_jobFunction = NULL;
+	m_jobs = NULL;
+	m_jobSize = 0;
+	m_jobCount = 0;
+	m_nextJob = 0;
+	m_jobsRemaining = 0;
+	m_isStopping = false;
+}
+
+CC3WorkerPool::~CC3WorkerPool()
+{
+	pthread_mutex_lock( &m_jobMutex );
+	m_isStopping = true;
+	pthread_cond_broadcast( &m_jobsAvailable );
+	pthread_mutex_unlock( &m_jobMutex );
+
+	for ( GLuint i = 0; i < m_threads.size(); i++ )
+		pthread_join( m_threads[i], NULL );
+
+	pthread_cond_destroy( &m_jobsCompleted );
+	pthread_cond_destroy( &m_jobsAvailable );
+	pthread_mutex_destroy( &m_jobMutex );
+	pthread_mutex_destroy( &m_batchMutex );
+}
+
+void CC3WorkerPool::init()
+{
+	pthread_mutex_init( &m_batchMutex, NULL );
+	pthread_mutex_init( &m_jobMutex, NULL );
+	pthread_cond_init( &m_jobsAvailable, NULL );
+	pthread_cond_init( &m_jobsCompleted, NULL );
+}
+
+GLuint CC3WorkerPool::getThreadCount()
+{
+	pthread_mutex_lock( &m_jobMutex );
+	GLuint threadCount = (GLuint)m_threads.size();
+	pthread_mutex_unlock( &m_jobMutex );
+	return threadCount;
+}
+
+/** Starts worker threads until there are at least the specified number. Must be invoked under the job lock. */
+void CC3WorkerPool::ensureThreads( GLuint threadCount )
+{
+	threadCount = MIN(threadCount, kCC3WorkerPoolMaxThreads);
+	while ( m_threads.size() < threadCount )
+	{
+		pthread_t thread;
+		if ( pthread_create( &thread, NULL, runWorkerPoolThread, this ) != 0 )
+		{
+			// The calling thread picks up any jobs that the missing threads would have run
+			CC3_ERROR( "CC3WorkerPool could not start a worker thread. Continuing with %d threads.", (int)m_threads.size() );
+			return;
+		}
+		m_threads.push_back( thread );
+	}
+}
+
+/**
+ * Claims and runs the next job of the current batch, if one remains, and returns whether a job
+ * was run. Must be invoked under the job lock, which is released while the job runs.
+ */
+bool CC3WorkerPool::runNextJob()
+{
+	if ( !m_jobFunction || m_nextJob >= m_jobCount )
+		return false;
+
+	void* job = m_jobs + (m_nextJob++ * m_jobSize);
+	CC3WorkerPoolJobFunction jobFunction = m_jobFunction;
+
+	pthread_mutex_unlock( &m_jobMutex );
+	jobFunction( job );
+	pthread_mutex_lock( &m_jobMutex );
+
+	if ( --m_jobsRemaining == 0 )
+		pthread_cond_signal( &m_jobsCompleted );
+
+	return true;
+}
+
+void CC3WorkerPool::serviceJobs()
+{
+	pthread_mutex_lock( &m_jobMutex );
+	while ( !m_isStopping )
+	{
+		if ( !runNextJob() )
+			pthread_cond_wait( &m_jobsAvailable, &m_jobMutex );
+	}
+	pthread_mutex_unlock( &m_jobMutex );
+}
+
+void CC3WorkerPool::runJobsOnCurrentThread( CC3WorkerPoolJobFunction jobFunction, void* jobs, GLuint jobCount, size_t jobSize )
+{
+	for ( GLuint jIdx = 0; jIdx < jobCount; jIdx++ )
+		jobFunction( (char*)jobs + (jIdx * jobSize) );
+}
+
+void CC3WorkerPool::runJobs( CC3WorkerPoolJobFunction jobFunction, void* jobs, GLuint jobCount, size_t jobSize )
+{
+	if ( jobCount == 0 )
+		return;
+
+	// A single job, or a batch submitted while another batch is running, runs right here
+	if ( jobCount == 1 || pthread_mutex_trylock( &m_batchMutex ) != 0 )
+	{
+		runJobsOnCurrentThread( jobFunction, jobs, jobCount, jobSize );
+		return;
+	}
+
+	pthread_mutex_lock( &m_jobMutex );
+	ensureThreads( jobCount - 1 );
+	m_jobFunction = jobFunction;
+	m_jobs = (char*)jobs;
+	m_jobSize = jobSize;
+	m_jobCount = jobCount;
+	m_nextJob = 0;
+	m_jobsRemaining = jobCount;
+	pthread_cond_broadcast( &m_jobsAvailable );
+
+	// Take part in the batch, then wait for the jobs still running on the worker threads
+	while ( runNextJob() ) {}
+	while ( m_jobsRemaining > 0 )
+		pthread_cond_wait( &m_jobsCompleted, &m_jobMutex );
+
+	m_jobFunction = NULL;
+	m_jobs = NULL;
+	pthread_mutex_unlock( &m_jobMutex );
+
+	pthread_mutex_unlock( &m_batchMutex );
+}
+
+static CC3WorkerPool* _singleton;
+static pthread_once_t _singletonOnce = PTHREAD_ONCE_INIT;
+
+static void createSharedWorkerPool()
+{
+	_singleton = new CC3WorkerPool;		// retained
+	_singleton->init();
+}
+
+// The first access may come from any thread, including the update threads of a parallel update
+CC3WorkerPool* CC3WorkerPool::sharedWorkerPool()
+{
+	pthread_once( &_singletonOnce, createSharedWorkerPool );
+	return _singleton;
+}
+
+NS_COCOS3D_END
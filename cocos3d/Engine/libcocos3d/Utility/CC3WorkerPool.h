@@ -0,0 +1,104 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_WORKER_POOL_H_
+#define _CC3_WORKER_POOL_H_
+#include <pthread.h>
+
+NS_COCOS3D_BEGIN
+
+/** The maximum number of worker threads in the shared worker pool, not including the calling thread. */
+#define kCC3WorkerPoolMaxThreads		7
+
+/** A function that performs a single job, given a pointer to the job description. */
+typedef void (*CC3WorkerPoolJobFunction) ( void* job );
+
+/**
+ * CC3WorkerPool runs batches of short, CPU-bound jobs, such as deforming ranges of vertices,
+ * on a set of persistent worker threads, with the calling thread taking part. Use this class
+ * for work that must be finished before the caller continues. For work that may complete
+ * later, use CC3Backgrounder instead.
+ *
+ * Worker threads are started lazily, as batches with more jobs arrive, up to a maximum of
+ * kCC3WorkerPoolMaxThreads, and then wait for the next batch, rather than being started and
+ * joined for each batch.
+ *
+ * The pool runs one batch at a time. If runJobs is invoked while another batch is running,
+ * such as from within a job, or from a thread of the parallel update mode of
+ * CC3NodeUpdatingVisitor, the jobs of the new batch are run on the calling thread instead.
+ * This avoids any possibility of deadlock between nested or concurrent batches.
+ *
+ * CC3WorkerPool is a singleton, accessed through the sharedWorkerPool method.
+ */
+class CC3WorkerPool : public CCObject
+{
+public:
+	CC3WorkerPool();
+	~CC3WorkerPool();
+
+	/** Returns the number of worker threads that have been started, not including the calling thread. */
+	GLuint						getThreadCount();
+
+	/**
+	 * Runs the specified function once for each of the specified number of jobs, and returns once
+	 * all jobs have completed. The jobs are held in a contiguous array starting at jobs, with each
+	 * job occupying jobSize bytes, and the function is passed a pointer to each job in turn.
+	 *
+	 * Jobs are distributed across the worker threads and the calling thread, in no particular order.
+	 */
+	void						runJobs( CC3WorkerPoolJobFunction jobFunction, void* jobs, GLuint jobCount, size_t jobSize );
+
+	/** Initializes this instance. */
+	void						init();
+
+	/** Returns the singleton instance. */
+	static CC3WorkerPool*		sharedWorkerPool();
+
+	/** Waits for a batch of jobs, and runs jobs from it until the pool is deleted. Invoked on each worker thread. */
+	void						serviceJobs();
+
+protected:
+	void						ensureThreads( GLuint threadCount );
+	void						runJobsOnCurrentThread( CC3WorkerPoolJobFunction jobFunction, void* jobs, GLuint jobCount, size_t jobSize );
+	bool						runNextJob();
+
+protected:
+	std::vector<pthread_t>		m_threads;
+	pthread_mutex_t				m_batchMutex;
+	pthread_mutex_t				m_jobMutex;
+	pthread_cond_t				m_jobsAvailable;
+	pthread_cond_t				m_jobsCompleted;
+	CC3WorkerPoolJobFunction	m_jobFunction;
+	char*						m_jobs;
+	size_t						m_jobSize;
+	GLuint						m_jobCount;
+	GLuint						m_nextJob;
+	GLuint						m_jobsRemaining;
+	bool						m_isStopping;
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -86,6 +86,11 @@ void CC3RandomMortalParticleNavigator::initializeParticle( CC3Particle* aParticl
 	aParticle->setLifeSpan( CC3RandomFloatBetween(m_minParticleLifeSpan, m_maxParticleLifeSpan) );
 }
 
+void CC3RandomMortalParticleNavigator::initializeStoredParticle( CC3ParticleStore* store, GLuint index )
+{
+	store->setLifeSpan( CC3RandomFloatBetween(m_minParticleLifeSpan, m_maxParticleLifeSpan), index );
+}
+
 /** Converts the angular components of the specified dispersion into tangents. */
 static inline CCSize CC3ShapeFromDispersionAngle( const CCSize& anAngle ) 
 {
@@ -311,6 +316,19 @@ void CC3HoseParticleNavigator::initializeParticle( CC3Particle* aParticle )
 	// nozzle's local coordinate system to the emitter's local coordinate system.
 	aParticle->setLocation( getNozzleMatrix()->transformLocation( CC3Vector::kCC3VectorZero ) );
 	
+	aParticle->setVelocity( randomEmissionVelocity() );
+}
+
+void CC3HoseParticleNavigator::initializeStoredParticle( CC3ParticleStore* store, GLuint index )
+{
+	super::initializeStoredParticle( store, index );
+
+	store->getLocations()[index] = getNozzleMatrix()->transformLocation( CC3Vector::kCC3VectorZero );
+	store->getVelocities()[index] = randomEmissionVelocity();
+}
+
+CC3Vector CC3HoseParticleNavigator::randomEmissionVelocity()
+{
 	// Speed of particle is randomized.
 	GLfloat emissionSpeed = CC3RandomFloatBetween(m_minParticleSpeed, m_maxParticleSpeed);
 
@@ -329,7 +347,7 @@ void CC3HoseParticleNavigator::initializeParticle( CC3Particle* aParticle )
 	// nozzle's local coordinates. The particle velocity is then the nozzle emission velocity
 	// transformed by the nozzleMatrix to convert it to the emitter's local coordinates.
 	CC3Vector emissionVelocity = emissionDir * emissionSpeed;
-	aParticle->setVelocity( getNozzleMatrix()->transformDirection(emissionVelocity) );
+	return getNozzleMatrix()->transformDirection(emissionVelocity);
 }
 
 NS_COCOS3D_END
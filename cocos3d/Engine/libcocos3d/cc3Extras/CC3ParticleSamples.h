@@ -76,6 +76,9 @@ public:
 	virtual bool				init();
 	virtual void				initializeParticle( CC3Particle* aParticle );
 
+	/** Sets the lifeSpan of the stored particle to a random value between the minimum and maximum. */
+	virtual void				initializeStoredParticle( CC3ParticleStore* store, GLuint index );
+
 protected:
 	GLfloat						m_minParticleLifeSpan;
 	GLfloat						m_maxParticleLifeSpan;
@@ -293,7 +296,13 @@ public:
 	 */
 	virtual void				initializeParticle( CC3Particle* aParticle );
 
+	/** Writes the emission location and velocity of the stored particle into the particle store. */
+	virtual void				initializeStoredParticle( CC3ParticleStore* store, GLuint index );
+
 protected:
+	/** Returns a randomized emission velocity in the local coordinate system of the emitter. */
+	CC3Vector					randomEmissionVelocity();
+
 	CC3Node*					m_pNozzle;
 	CC3Matrix*					m_nozzleMatrix;
 	CCSize						m_nozzleShape;
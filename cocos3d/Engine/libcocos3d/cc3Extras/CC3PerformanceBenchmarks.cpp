@@ -0,0 +1,728 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+#include <math.h>
+
+NS_COCOS3D_BEGIN
+
+/** Returns the number of milliseconds elapsed since the specified start time, from CC3Platform::getCurrentNanoseconds. */
+static double millisecondsSince( unsigned long long startNanos )
+{
+	return (double)(CC3Platform::getCurrentNanoseconds() - startNanos) / 1000000.0;
+}
+
+/**
+ * Drives the resource loading benchmark from the CCScheduler, recording the interval between
+ * successive frames while resources are loaded synchronously, and then in the background.
+ */
+class CC3ResourceLoadingBenchmark : public CCObject
+{
+public:
+	CC3ResourceLoadingBenchmark()
+	{
+		m_loadCount = 0;
+		m_syncLoadsIssued = 0;
+		m_backgroundLoadsCompleted = 0;
+		m_lastFrameNanos = 0;
+		m_isLoadingInBackground = false;
+	}
+
+	void start( const std::string& podFilePath, GLuint loadCount )
+	{
+		m_filePath = CCFileUtils::sharedFileUtils()->fullPathForFilename( podFilePath.c_str() );
+		m_loadCount = MAX(loadCount, 1);
+		m_lastFrameNanos = CC3Platform::getCurrentNanoseconds();
+		retain();		// released once the benchmark has completed
+		CCDirector::sharedDirector()->getScheduler()->scheduleSelector( schedule_selector(CC3ResourceLoadingBenchmark::update), this, 0, false );
+	}
+
+	void update( float dt )
+	{
+		CC_UNUSED_PARAM(dt);
+
+		unsigned long long now = CC3Platform::getCurrentNanoseconds();
+		double frameTime = (double)(now - m_lastFrameNanos) / 1000000.0;
+		m_lastFrameNanos = now;
+
+		if ( !m_isLoadingInBackground )
+		{
+			// Skip the first interval, which includes the time before the benchmark started
+			if ( m_syncLoadsIssued > 0 )
+				m_syncFrameTimes.push_back( frameTime );
+
+			if ( m_syncLoadsIssued < m_loadCount )
+			{
+				CC3PODResource* rez = new CC3PODResource;
+				rez->init();
+				rez->loadFromFile( m_filePath );
+				rez->release();
+				m_syncLoadsIssued++;
+				return;
+			}
+
+			m_isLoadingInBackground = true;
+			for ( GLuint i = 0; i < m_loadCount; i++ )
+			{
+				CC3PODResource* rez = new CC3PODResource;
+				rez->init();
+				rez->loadFromFileInBackground( m_filePath, backgroundLoadCompleted, this );
+				rez->release();		// retained by the load until the callback has been invoked
+			}
+			return;
+		}
+
+		m_backgroundFrameTimes.push_back( frameTime );
+
+		if ( m_backgroundLoadsCompleted < m_loadCount )
+			return;
+
+		CCLog( "CC3PerformanceBenchmarks loaded %s %u times", m_filePath.c_str(), m_loadCount );
+		CC3PerformanceBenchmarks::logFrameTimes( "Loading on the rendering thread", m_syncFrameTimes );
+		CC3PerformanceBenchmarks::logFrameTimes( "Loading in the background", m_backgroundFrameTimes );
+
+		CCDirector::sharedDirector()->getScheduler()->unscheduleSelector( schedule_selector(CC3ResourceLoadingBenchmark::update), this );
+		release();
+	}
+
+	static void backgroundLoadCompleted( CC3Resource* resource, bool wasLoaded, void* benchmark )
+	{
+		if ( !wasLoaded )
+			CCLog( "CC3PerformanceBenchmarks could not load %s", resource->getName().c_str() );
+		((CC3ResourceLoadingBenchmark*)benchmark)->m_backgroundLoadsCompleted++;
+	}
+
+protected:
+	std::string					m_filePath;
+	std::vector<double>			m_syncFrameTimes;
+	std::vector<double>			m_backgroundFrameTimes;
+	GLuint						m_loadCount;
+	GLuint						m_syncLoadsIssued;
+	GLuint						m_backgroundLoadsCompleted;
+	unsigned long long			m_lastFrameNanos;
+	bool						m_isLoadingInBackground;
+};
+
+void CC3PerformanceBenchmarks::runResourceLoadingBenchmark( const std::string& podFilePath, GLuint loadCount )
+{
+	CC3ResourceLoadingBenchmark* benchmark = new CC3ResourceLoadingBenchmark;
+	benchmark->start( podFilePath, loadCount );
+	benchmark->release();
+}
+
+/**
+ * Loads the specified POD file the specified number of times, holding all of the resources until the last
+ * has loaded, and logs the average load time and the increase in the peak resident memory of the process.
+ */
+static void timePODLoads( const std::string& filePath, GLuint loadCount, bool shouldMap )
+{
+	const char* label = shouldMap ? "mapped" : "copied";
+	CCArray* resources = CCArray::createWithCapacity( loadCount );
+	unsigned long startPeakKB = CC3Platform::getPeakResidentKilobytes();
+
+	unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+	for ( GLuint i = 0; i < loadCount; i++ )
+	{
+		CC3PODResource* rez = new CC3PODResource;
+		rez->init();
+		rez->setShouldMapFileContent( shouldMap );
+		if ( !rez->loadFromFile( filePath ) )
+			CCLog( "CC3PerformanceBenchmarks could not load %s", filePath.c_str() );
+		resources->addObject( rez );
+		rez->release();
+	}
+	double loadTime = millisecondsSince( startTime ) / loadCount;
+
+	unsigned long peakIncreaseKB = CC3Platform::getPeakResidentKilobytes() - startPeakKB;
+	CCLog( "POD loading, %s, %u loads: %.2f ms per load, peak resident memory increased by %lu KB (%lu KB per load)",
+		   label, loadCount, loadTime, peakIncreaseKB, peakIncreaseKB / loadCount );
+
+	resources->removeAllObjects();
+}
+
+void CC3PerformanceBenchmarks::runPODLoadingBenchmark( const std::string& podFilePath, GLuint loadCount )
+{
+	std::string filePath = CCFileUtils::sharedFileUtils()->fullPathForFilename( podFilePath.c_str() );
+	loadCount = MAX(loadCount, 1);
+
+	// The peak is a high-water mark, so the path expected to use less memory is measured first
+	timePODLoads( filePath, loadCount, true );
+	timePODLoads( filePath, loadCount, false );
+}
+
+/** Builds a root node holding the specified number of independent subtrees, each a node with seven children. */
+static CC3Node* makeSceneUpdateBenchmarkRoot( GLuint subtreeCount )
+{
+	CC3Node* root = CC3Node::nodeWithName( "BenchmarkRoot" );
+	for ( GLuint sIdx = 0; sIdx < subtreeCount; sIdx++ )
+	{
+		CC3Node* subtree = CC3Node::node();
+		subtree->setLocation( cc3v( (GLfloat)(sIdx % 128), 0.0f, (GLfloat)(sIdx / 128) ) );
+		for ( GLuint cIdx = 0; cIdx < 7; cIdx++ )
+		{
+			CC3Node* child = CC3Node::node();
+			child->setLocation( cc3v( 0.0f, (GLfloat)cIdx, 0.0f ) );
+			subtree->addChild( child );
+		}
+		root->addChild( subtree );
+	}
+	return root;
+}
+
+/** Returns the average time, in milliseconds, to update the specified root after rotating each of its subtrees. */
+static double timeSceneUpdates( CC3Node* root, CC3NodeUpdatingVisitor* visitor, GLuint updateCount )
+{
+	CCArray* subtrees = root->getChildren();
+	double totalTime = 0.0;
+	for ( GLuint uIdx = 0; uIdx < updateCount; uIdx++ )
+	{
+		// Move every subtree, so each update rebuilds every global transform
+		CCObject* pObject;
+		CCARRAY_FOREACH( subtrees, pObject )
+			((CC3Node*)pObject)->setRotation( cc3v( 0.0f, (GLfloat)uIdx, 0.0f ) );
+
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		visitor->visit( root );
+		totalTime += millisecondsSince( startTime );
+	}
+	return totalTime / updateCount;
+}
+
+void CC3PerformanceBenchmarks::runSceneUpdateBenchmark()
+{
+	const GLuint updateCount = 20;
+	const GLuint threadCounts[] = { 2, 4, 8 };
+
+	for ( GLuint subtreeCount = 1024; subtreeCount <= 16384; subtreeCount *= 2 )
+	{
+		CC3Node* root = makeSceneUpdateBenchmarkRoot( subtreeCount );
+		CC3NodeUpdatingVisitor* visitor = CC3NodeUpdatingVisitor::visitor();
+		visitor->setDeltaTime( 1.0f / 60.0f );
+
+		visitor->setShouldUpdateInParallel( false );
+		timeSceneUpdates( root, visitor, 1 );		// Warm up
+		double serialTime = timeSceneUpdates( root, visitor, updateCount );
+		CCLog( "Scene update, %u nodes: serial %.3f ms", subtreeCount * 8, serialTime );
+
+		visitor->setShouldUpdateInParallel( true );
+		for ( GLuint tIdx = 0; tIdx < sizeof(threadCounts) / sizeof(threadCounts[0]); tIdx++ )
+		{
+			visitor->setMaxUpdateThreads( threadCounts[tIdx] );
+			timeSceneUpdates( root, visitor, 1 );	// Warm up the worker visitors and pool threads
+			double parallelTime = timeSceneUpdates( root, visitor, updateCount );
+			CCLog( "Scene update, %u nodes: %u threads %.3f ms (%.2fx)",
+				   subtreeCount * 8, threadCounts[tIdx], parallelTime, serialTime / MAX(parallelTime, 0.001) );
+		}
+	}
+}
+
+/** Returns the largest absolute difference between the specified arrays of floats. */
+static GLfloat maxDifferenceOf( const GLfloat* a, const GLfloat* b, GLuint count )
+{
+	GLfloat maxDiff = 0.0f;
+	for ( GLuint i = 0; i < count; i++ )
+		maxDiff = MAX(maxDiff, fabsf( a[i] - b[i] ));
+	return maxDiff;
+}
+
+/** Logs the scalar and vector times of one matrix benchmark, along with the difference between their results. */
+static void logMatrixTimes( const char* label, double scalarTime, double vectorTime, GLfloat maxDiff )
+{
+	CCLog( "%s: scalar %.3f ms, vector %.3f ms (%.2fx), max difference %g",
+		   label, scalarTime, vectorTime, scalarTime / MAX(vectorTime, 0.001), maxDiff );
+}
+
+void CC3PerformanceBenchmarks::runMatrixBenchmark()
+{
+	const GLuint elemCount = 100000;
+	const GLuint passCount = 10;
+
+	std::vector<CC3Matrix4x3> mRs( elemCount ), scalarMtxs( elemCount ), vectorMtxs( elemCount );
+	std::vector<CC3Vector> locs( elemCount ), scalarLocs( elemCount ), vectorLocs( elemCount );
+	for ( GLuint i = 0; i < elemCount; i++ )
+	{
+		CC3Matrix4x3PopulateFromRotationYXZ( &mRs[i], cc3v( (GLfloat)(i % 360), (GLfloat)(i % 90), 0.0f ) );
+		mRs[i].c4r1 = (GLfloat)(i % 100);
+		locs[i] = cc3v( (GLfloat)(i % 10), (GLfloat)(i % 7), (GLfloat)(i % 13) );
+	}
+
+	CC3Matrix4x3 mL;
+	CC3Matrix4x3PopulateFromRotationYXZ( &mL, cc3v( 30.0f, 45.0f, 60.0f ) );
+	mL.c4r1 = 1.0f;  mL.c4r2 = 2.0f;  mL.c4r3 = 3.0f;
+
+	// Batch multiplication by a common parent transform
+	double scalarTime = 0.0, vectorTime = 0.0;
+	for ( GLuint pIdx = 0; pIdx < passCount; pIdx++ )
+	{
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint i = 0; i < elemCount; i++ )
+			CC3Matrix4x3MultiplyScalar( &scalarMtxs[i], &mL, &mRs[i] );
+		scalarTime += millisecondsSince( startTime );
+
+		startTime = CC3Platform::getCurrentNanoseconds();
+		CC3Matrix4x3MultiplyBatchLeft( &vectorMtxs[0], &mL, &mRs[0], elemCount );
+		vectorTime += millisecondsSince( startTime );
+	}
+	logMatrixTimes( "CC3Matrix4x3MultiplyBatchLeft, 100k matrices", scalarTime / passCount, vectorTime / passCount,
+				    maxDifferenceOf( scalarMtxs[0].elements, vectorMtxs[0].elements, elemCount * kCC3Matrix4x3ElementCount ) );
+
+	// Batch transformation of vertex locations
+	scalarTime = vectorTime = 0.0;
+	for ( GLuint pIdx = 0; pIdx < passCount; pIdx++ )
+	{
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint i = 0; i < elemCount; i++ )
+			scalarLocs[i] = CC3Matrix4x3TransformLocation( &mL, locs[i] );
+		scalarTime += millisecondsSince( startTime );
+
+		startTime = CC3Platform::getCurrentNanoseconds();
+		CC3Matrix4x3TransformLocations( &mL, &locs[0], &vectorLocs[0], elemCount );
+		vectorTime += millisecondsSince( startTime );
+	}
+	logMatrixTimes( "CC3Matrix4x3TransformLocations, 100k locations", scalarTime / passCount, vectorTime / passCount,
+				    maxDifferenceOf( &scalarLocs[0].x, &vectorLocs[0].x, elemCount * 3 ) );
+
+	// Individual 4x4 multiplication, as used for the view-projection and model-view-projection matrices
+	std::vector<CC3Matrix4x4> m4Rs( elemCount ), scalarMtx4s( elemCount ), vectorMtx4s( elemCount );
+	for ( GLuint i = 0; i < elemCount; i++ )
+		CC3Matrix4x4PopulateFrom4x3( &m4Rs[i], &mRs[i] );
+
+	CC3Matrix4x4 m4L;
+	CC3Matrix4x4PopulateFrom4x3( &m4L, &mL );
+	m4L.c1r4 = 0.5f;		// Exercise the projection row
+
+	scalarTime = vectorTime = 0.0;
+	for ( GLuint pIdx = 0; pIdx < passCount; pIdx++ )
+	{
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint i = 0; i < elemCount; i++ )
+			CC3Matrix4x4MultiplyScalar( &scalarMtx4s[i], &m4L, &m4Rs[i] );
+		scalarTime += millisecondsSince( startTime );
+
+		startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint i = 0; i < elemCount; i++ )
+			CC3Matrix4x4Multiply( &vectorMtx4s[i], &m4L, &m4Rs[i] );
+		vectorTime += millisecondsSince( startTime );
+	}
+	logMatrixTimes( "CC3Matrix4x4Multiply, 100k matrices", scalarTime / passCount, vectorTime / passCount,
+				    maxDifferenceOf( scalarMtx4s[0].elements, vectorMtx4s[0].elements, elemCount * kCC3Matrix4x4ElementCount ) );
+}
+
+/**
+ * Builds a skinned mesh node with the specified number of vertices, under a soft-body node holding
+ * the specified number of bones. Each skin section is driven by its own chain of 25 bones, and covers
+ * an equal run of vertices, each of which is influenced by four bones of that section.
+ */
+static CC3SkinMeshNode* makeSkinningBenchmarkNode( GLuint boneCount, GLuint vertexCount )
+{
+	const GLuint bonesPerSection = 25;
+	const GLuint influenceCount = 4;
+	const GLfloat influenceWeights[influenceCount] = { 0.4f, 0.3f, 0.2f, 0.1f };
+
+	CC3SoftBodyNode* softBody = CC3SoftBodyNode::nodeWithName( "BenchmarkSoftBody" );
+
+	CC3SkinMeshNode* skinNode = new CC3SkinMeshNode;
+	skinNode->initWithName( "BenchmarkSkin" );
+	skinNode->autorelease();
+	softBody->addChild( skinNode );
+
+	CC3Mesh* mesh = CC3Mesh::mesh();
+	mesh->setVertexContentTypes( (CC3VertexContent)(kCC3VertexContentLocation | kCC3VertexContentNormal |
+													kCC3VertexContentBoneWeights | kCC3VertexContentBoneIndices) );
+	mesh->getVertexBoneWeights()->setElementSize( influenceCount );
+	mesh->getVertexBoneIndices()->setElementSize( influenceCount );
+	mesh->updateVertexStride();
+	mesh->setAllocatedVertexCapacity( vertexCount );
+	skinNode->setMesh( mesh );
+
+	for ( GLuint vIdx = 0; vIdx < vertexCount; vIdx++ )
+	{
+		mesh->setVertexLocation( cc3v( (GLfloat)(vIdx % 100) * 0.01f, (GLfloat)(vIdx % 25), (GLfloat)(vIdx % 7) * 0.01f ), vIdx );
+		mesh->setVertexNormal( cc3v( 0.0f, 0.0f, 1.0f ), vIdx );
+		for ( GLuint iIdx = 0; iIdx < influenceCount; iIdx++ )
+		{
+			mesh->setVertexWeight( influenceWeights[iIdx], iIdx, vIdx );
+			mesh->setVertexBoneIndex( (vIdx + iIdx) % bonesPerSection, iIdx, vIdx );
+		}
+	}
+
+	GLuint sectionCount = (boneCount + bonesPerSection - 1) / bonesPerSection;
+	GLuint vtxPerSection = (vertexCount + sectionCount - 1) / sectionCount;
+	for ( GLuint ssIdx = 0; ssIdx < sectionCount; ssIdx++ )
+	{
+		CC3SkinSection* section = CC3SkinSection::skinSectionForNode( skinNode );
+		GLuint vtxStart = MIN(ssIdx * vtxPerSection, vertexCount);
+		section->setVertexStart( vtxStart );
+		section->setVertexCount( MIN(vtxPerSection, vertexCount - vtxStart) );
+
+		CC3Node* parent = softBody;
+		for ( GLuint bIdx = 0; bIdx < bonesPerSection; bIdx++ )
+		{
+			CC3Bone* bone = CC3Bone::create();
+			bone->setLocation( (bIdx == 0) ? cc3v( (GLfloat)ssIdx, 0.0f, 0.0f ) : cc3v( 0.0f, 1.0f, 0.0f ) );
+			parent->addChild( bone );
+			section->addBone( bone );
+			parent = bone;
+		}
+		skinNode->getSkinSections()->addObject( section );
+	}
+
+	// Bind the rest pose, and then bend every bone, so each vertex is actually deformed
+	softBody->bindRestPose();
+	CCObject* pObject;
+	CCARRAY_FOREACH( softBody->flatten(), pObject )
+	{
+		CC3Bone* bone = dynamic_cast<CC3Bone*>( pObject );
+		if ( bone )
+			bone->setRotation( cc3v( 0.0f, 0.0f, 2.0f ) );
+	}
+	return skinNode;
+}
+
+void CC3PerformanceBenchmarks::runSkinningBenchmark()
+{
+	const GLuint passCount = 10;
+	const GLuint threadCounts[] = { 1, 2, 4, 8 };
+
+	CC3SkinMeshNode* skinNode = makeSkinningBenchmarkNode( 1000, 100000 );
+	CC3SoftwareSkinner* skinner = skinNode->getSoftwareSkinner();
+	GLuint vtxCount = skinner->getVertexCount();
+	std::vector<CC3Vector> locations( vtxCount );
+
+	// Per-vertex deformation through each skin section, which is the path the skinner replaces
+	CCArray* sections = skinNode->getSkinSections();
+	double perVertexTime = 0.0;
+	for ( GLuint pIdx = 0; pIdx <= passCount; pIdx++ )
+	{
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		CCObject* pObject;
+		CCARRAY_FOREACH( sections, pObject )
+		{
+			CC3SkinSection* section = (CC3SkinSection*)pObject;
+			GLuint vtxEnd = section->getVertexStart() + section->getVertexCount();
+			for ( GLuint vIdx = section->getVertexStart(); vIdx < vtxEnd; vIdx++ )
+				locations[vIdx] = section->getDeformedVertexLocationAt( vIdx );
+		}
+		if ( pIdx > 0 )			// The first pass warms up the bone transforms
+			perVertexTime += millisecondsSince( startTime );
+	}
+	perVertexTime /= passCount;
+	CCLog( "Skinning, 1k bones, %u vertices: per-vertex skin sections %.3f ms", vtxCount, perVertexTime );
+
+	for ( GLuint tIdx = 0; tIdx < sizeof(threadCounts) / sizeof(threadCounts[0]); tIdx++ )
+	{
+		skinner->setMaxThreads( threadCounts[tIdx] );
+		skinner->deformVertices( &locations[0], NULL );		// Warm up the worker pool threads
+
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint pIdx = 0; pIdx < passCount; pIdx++ )
+			skinner->deformVertices( &locations[0], NULL );
+		double skinnerTime = millisecondsSince( startTime ) / passCount;
+
+		CCLog( "Skinning, 1k bones, %u vertices: software skinner, %u threads %.3f ms (%.2fx)",
+			   vtxCount, threadCounts[tIdx], skinnerTime, perVertexTime / MAX(skinnerTime, 0.001) );
+	}
+}
+
+/** Builds a root node holding a grid of the specified number of static mesh nodes, all sharing one box mesh. */
+static CC3Node* makeCullingBenchmarkRoot( GLuint propCount )
+{
+	const GLuint propsPerRow = 250;
+	const GLfloat propSpacing = 4.0f;
+
+	CC3Node* root = CC3Node::nodeWithName( "BenchmarkRoot" );
+	CC3Mesh* mesh = NULL;
+	for ( GLuint pIdx = 0; pIdx < propCount; pIdx++ )
+	{
+		CC3MeshNode* prop = CC3MeshNode::nodeWithName( "BenchmarkProp" );
+		if ( mesh )
+			prop->setMesh( mesh );
+		else
+		{
+			prop->populateAsSolidBox( CC3Box( -0.5f, 0.0f, -0.5f, 0.5f, 2.0f, 0.5f ) );
+			mesh = prop->getMesh();
+		}
+		prop->setLocation( cc3v( (GLfloat)(pIdx % propsPerRow) * propSpacing, 0.0f, (GLfloat)(pIdx / propsPerRow) * propSpacing ) );
+		root->addChild( prop );
+	}
+	root->createBoundingVolumes();
+	return root;
+}
+
+void CC3PerformanceBenchmarks::runCullingBenchmark()
+{
+	const GLuint propCount = 50000;
+	const GLuint frameCount = 36;
+
+	CC3Node* root = makeCullingBenchmarkRoot( propCount );
+	CC3BoundingVolumeHierarchy* bvh = CC3BoundingVolumeHierarchy::hierarchyWithRootNode( root );
+
+	CC3NodeSequencer* sequencer = CC3BTreeNodeSequencer::sequencerLocalContentOpaqueFirstGroupMeshes();
+	CCObject* pObject;
+	CCARRAY_FOREACH( root->getChildren(), pObject )
+		sequencer->add( (CC3Node*)pObject, NULL );
+
+	std::vector<CC3Node*> seqNodes;
+	CCARRAY_FOREACH( sequencer->getNodes(), pObject )
+		seqNodes.push_back( (CC3Node*)pObject );
+
+	// Stand in the middle of the grid, so each view sees a small fraction of the props
+	CC3Camera* camera = CC3Camera::nodeWithName( "BenchmarkCamera" );
+	camera->setViewport( CC3ViewportMake( 0, 0, 1024, 768 ) );
+	camera->setFarClippingDistance( 200.0f );
+	camera->setLocation( cc3v( 500.0f, 10.0f, 400.0f ) );
+
+	std::vector<GLuint> visibleLeaves;
+	std::vector<GLubyte> visibility;
+	std::vector<CC3Node*> visibleNodes;
+	bvh->cullToFrustum( camera->getFrustum(), visibleLeaves );		// Warm up, and build the hierarchy
+
+	double perNodeTime = 0.0, lookupTime = 0.0, visibleListTime = 0.0;
+	GLuint totalVisible = 0;
+	for ( GLuint fIdx = 0; fIdx < frameCount; fIdx++ )
+	{
+		camera->setRotation( cc3v( -10.0f, (GLfloat)fIdx * (360.0f / frameCount), 0.0f ) );
+		CC3Frustum* frustum = camera->getFrustum();
+		GLuint drawCount = 0;
+
+		// Each node in the drawing sequence tested against the frustum
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint i = 0; i < seqNodes.size(); i++ )
+			drawCount += seqNodes[i]->doesIntersectFrustum( frustum ) ? 1 : 0;
+		perNodeTime += millisecondsSince( startTime );
+
+		// The hierarchy culled, and each node in the drawing sequence looked up
+		startTime = CC3Platform::getCurrentNanoseconds();
+		bvh->cullToFrustum( frustum, visibleLeaves );
+		visibility.assign( bvh->getLeafCount(), 0 );
+		for ( GLuint i = 0; i < visibleLeaves.size(); i++ )
+			visibility[visibleLeaves[i]] = 1;
+		for ( GLuint i = 0; i < seqNodes.size(); i++ )
+			drawCount += visibility[seqNodes[i]->getBoundingVolumeHierarchyIndex()];
+		lookupTime += millisecondsSince( startTime );
+
+		// The hierarchy culled, and only the visible nodes sequenced
+		startTime = CC3Platform::getCurrentNanoseconds();
+		GLuint visibleCount = bvh->cullToFrustum( frustum, visibleLeaves );
+		visibleNodes.clear();
+		for ( GLuint i = 0; i < visibleCount; i++ )
+			visibleNodes.push_back( bvh->getNodeAt( visibleLeaves[i] ) );
+		sequencer->sequenceNodes( visibleNodes, NULL );
+		visibleListTime += millisecondsSince( startTime );
+
+		totalVisible += (GLuint)visibleNodes.size();
+		if ( drawCount != 2 * visibleNodes.size() )
+			CCLog( "Culling, frame %u: the paths disagree on the visible nodes", fIdx );
+	}
+
+	perNodeTime /= frameCount;
+	lookupTime /= frameCount;
+	visibleListTime /= frameCount;
+	CCLog( "Culling, %u props, %u visible on average: per-node frustum test %.3f ms", propCount, totalVisible / frameCount, perNodeTime );
+	CCLog( "Culling, %u props: hierarchy with per-node lookup %.3f ms (%.2fx)", propCount, lookupTime, perNodeTime / MAX(lookupTime, 0.001) );
+	CCLog( "Culling, %u props: hierarchy with visible nodes only %.3f ms (%.2fx)", propCount, visibleListTime, perNodeTime / MAX(visibleListTime, 0.001) );
+}
+
+/** Builds an animation for the specified bone, animating location, rotation and scale over the specified number of frames. */
+static CC3ArrayNodeAnimation* makeAnimationBenchmarkAnimation( GLuint boneIndex, GLuint frameCount )
+{
+	CC3ArrayNodeAnimation* animation = new CC3ArrayNodeAnimation;
+	animation->initWithFrameCount( frameCount );
+	animation->autorelease();
+
+	CC3Vector* locations = animation->allocateLocations();
+	CC3Quaternion* quaternions = animation->allocateQuaternions();
+	CC3Vector* scales = animation->allocateScales();
+	GLfloat boneOffset = (GLfloat)boneIndex * 0.1f;
+	for ( GLuint fIdx = 0; fIdx < frameCount; fIdx++ )
+	{
+		GLfloat phase = (GLfloat)fIdx / (GLfloat)(frameCount - 1) * (GLfloat)kCC3TwoPi;
+		locations[fIdx] = cc3v( sinf( phase + boneOffset ), 0.5f * cosf( 2.0f * phase ), 0.01f * (GLfloat)boneIndex );
+		quaternions[fIdx] = CC3Quaternion().fromAxisAngle( CC3Vector4().fromCC3Vector( cc3v( 0.0f, 1.0f, 0.2f ), 90.0f * sinf( phase + boneOffset ) ) );
+		scales[fIdx] = cc3v( 1.0f + 0.1f * sinf( phase ), 1.0f, 1.0f );
+	}
+	return animation;
+}
+
+/** Evaluates each animation state at each of the specified number of playback frames, and returns the average time per frame. */
+static double timeAnimationPlayback( CCArray* animStates, GLuint playbackFrameCount )
+{
+	unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+	for ( GLuint pfIdx = 0; pfIdx < playbackFrameCount; pfIdx++ )
+	{
+		float t = (float)pfIdx / (float)(playbackFrameCount - 1);
+		CCObject* pObject;
+		CCARRAY_FOREACH( animStates, pObject )
+			((CC3NodeAnimationState*)pObject)->establishFrameAt( t );
+	}
+	return millisecondsSince( startTime ) / playbackFrameCount;
+}
+
+void CC3PerformanceBenchmarks::runAnimationBenchmark()
+{
+	const GLuint boneCount = 500;
+	const GLuint frameCount = 240;
+	const GLuint playbackFrameCount = 600;
+
+	CC3AnimationClip* clip = CC3AnimationClip::clip();
+	CCArray* arrayStates = CCArray::createWithCapacity( boneCount );
+	CCArray* compressedStates = CCArray::createWithCapacity( boneCount );
+	for ( GLuint bIdx = 0; bIdx < boneCount; bIdx++ )
+	{
+		CC3Node* bone = CC3Node::nodeWithName( "BenchmarkBone" );
+		CC3ArrayNodeAnimation* animation = makeAnimationBenchmarkAnimation( bIdx, frameCount );
+		arrayStates->addObject( CC3NodeAnimationState::animationStateWithAnimation( animation, 0, bone ) );
+		compressedStates->addObject( CC3NodeAnimationState::animationStateWithAnimation( clip->compressAnimation( animation ), 0, bone ) );
+	}
+
+	// Play each path through once to warm up the caches
+	timeAnimationPlayback( arrayStates, playbackFrameCount );
+	timeAnimationPlayback( compressedStates, playbackFrameCount );
+
+	double arrayTime = timeAnimationPlayback( arrayStates, playbackFrameCount );
+	double compressedTime = timeAnimationPlayback( compressedStates, playbackFrameCount );
+
+	// Compare the two at a time between frames, so that interpolation is included
+	GLfloat maxLocationDiff = 0.0f, maxRotationDiff = 0.0f;
+	for ( GLuint bIdx = 0; bIdx < boneCount; bIdx++ )
+	{
+		CC3NodeAnimationState* arrayState = (CC3NodeAnimationState*)arrayStates->objectAtIndex( bIdx );
+		CC3NodeAnimationState* compressedState = (CC3NodeAnimationState*)compressedStates->objectAtIndex( bIdx );
+		arrayState->establishFrameAt( 0.3333f );
+		compressedState->establishFrameAt( 0.3333f );
+		maxLocationDiff = MAX(maxLocationDiff, arrayState->getLocation().distance( compressedState->getLocation() ));
+		GLfloat quatDot = fabsf( arrayState->getQuaternion().dot( compressedState->getQuaternion() ) );
+		maxRotationDiff = MAX(maxRotationDiff, 2.0f * acosf( MIN(quatDot, 1.0f) ));
+	}
+
+	CCLog( "Animation, %u bones, %u frames: array animation %.3f ms per frame, %u bytes",
+		   boneCount, frameCount, arrayTime, clip->getUncompressedByteCount() );
+	CCLog( "Animation, %u bones, %u frames: compressed animation %.3f ms per frame (%.2fx), %u bytes (%.1f%%)",
+		   boneCount, frameCount, compressedTime, arrayTime / MAX(compressedTime, 0.001), clip->getByteCount(),
+		   100.0f * (GLfloat)clip->getByteCount() / (GLfloat)MAX(clip->getUncompressedByteCount(), 1) );
+	CCLog( "Animation, %u bones: max difference %g in location, %g radians in rotation", boneCount, maxLocationDiff, maxRotationDiff );
+}
+
+/** Builds a sphere of the specified tessellation under the specified root, and a shadow volume for it from the specified light. */
+static CC3ShadowVolumeMeshNode* makeShadowVolumeBenchmarkCaster( CC3Node* root, CC3Light* light, const CC3Tessellation& divsPerAxis )
+{
+	CC3MeshNode* caster = CC3MeshNode::nodeWithName( "BenchmarkCaster" );
+	caster->populateAsSphereWithRadius( 1.0f, divsPerAxis );
+	root->addChild( caster );
+
+	// Prepare the caster as addShadowVolumesForLight does, without requiring a scene and an active camera
+	caster->retainVertexLocations();
+	caster->retainVertexIndices();
+	caster->setShouldCacheFaces( true );
+	caster->prewarmForShadowVolumes();
+
+	CC3ShadowVolumeMeshNode* shadowVolume = CC3ShadowVolumeMeshNode::nodeWithName( "BenchmarkShadowVolume" );
+	shadowVolume->setShadowVolumeVertexOffsetFactor( 0.0f );		// The offset depends on the active camera
+	shadowVolume->setLight( light );
+	caster->addChild( shadowVolume );
+	return shadowVolume;
+}
+
+/**
+ * Rebuilds the specified shadow volume as the specified light circles its caster, once to warm up
+ * and once timed, and returns the average time per rebuild. The light ends where it started, so
+ * each path leaves the shadow volume built from the same light position.
+ */
+static double timeShadowVolumeRebuilds( CC3ShadowVolumeMeshNode* shadowVolume, CC3Light* light, GLuint rebuildCount )
+{
+	double rebuildTime = 0.0;
+	for ( GLuint pIdx = 0; pIdx < 2; pIdx++ )
+	{
+		unsigned long long startTime = CC3Platform::getCurrentNanoseconds();
+		for ( GLuint rIdx = 0; rIdx <= rebuildCount; rIdx++ )
+		{
+			GLfloat angle = (GLfloat)rIdx / (GLfloat)rebuildCount * (GLfloat)kCC3TwoPi;
+			light->setLocation( cc3v( 10.0f * cosf( angle ), 5.0f, 10.0f * sinf( angle ) ) );
+			shadowVolume->populateShadowMesh();
+		}
+		rebuildTime = millisecondsSince( startTime ) / (rebuildCount + 1);
+	}
+	return rebuildTime;
+}
+
+void CC3PerformanceBenchmarks::runShadowVolumeBenchmark()
+{
+	const GLuint rebuildCount = 20;
+	const CC3Tessellation casterDivs[] = { CC3TessellationMake( 128, 64 ), CC3TessellationMake( 256, 128 ), CC3TessellationMake( 512, 256 ) };
+
+	CC3Node* root = CC3Node::nodeWithName( "BenchmarkRoot" );
+	CC3Light* light = CC3Light::nodeWithName( "BenchmarkLight" );
+	root->addChild( light );
+
+	for ( GLuint cIdx = 0; cIdx < sizeof(casterDivs) / sizeof(casterDivs[0]); cIdx++ )
+	{
+		CC3ShadowVolumeMeshNode* shadowVolume = makeShadowVolumeBenchmarkCaster( root, light, casterDivs[cIdx] );
+		GLuint faceCount = shadowVolume->getShadowCaster()->getFaceCount();
+
+		// Each face visited along with each of its neighbours
+		shadowVolume->setShouldUseSilhouetteExtractor( false );
+		double byFaceTime = timeShadowVolumeRebuilds( shadowVolume, light, rebuildCount );
+		GLuint byFaceVertexCount = shadowVolume->getMesh()->getVertexCount();
+		CCLog( "Shadow volume, %u faces: by face %.3f ms, %u vertices", faceCount, byFaceTime, byFaceVertexCount );
+
+		// The edge list of the silhouette extractor, on one thread and then four
+		shadowVolume->setShouldUseSilhouetteExtractor( true );
+		CC3ShadowSilhouetteExtractor* extractor = shadowVolume->getSilhouetteExtractor();
+		for ( GLuint threadCount = 1; threadCount <= 4; threadCount *= 4 )
+		{
+			extractor->setMaxThreads( threadCount );
+			double extractorTime = timeShadowVolumeRebuilds( shadowVolume, light, rebuildCount );
+			CCLog( "Shadow volume, %u faces: silhouette extractor, %u threads %.3f ms (%.2fx), %u vertices",
+				   faceCount, threadCount, extractorTime, byFaceTime / MAX(extractorTime, 0.001),
+				   shadowVolume->getMesh()->getVertexCount() );
+		}
+
+		root->removeChild( shadowVolume->getShadowCaster() );
+	}
+}
+
+void CC3PerformanceBenchmarks::logFrameTimes( const char* label, const std::vector<double>& frameTimes )
+{
+	if ( frameTimes.empty() )
+		return;
+
+	double sum = 0.0, maxTime = 0.0;
+	for ( unsigned int i = 0; i < frameTimes.size(); i++ )
+	{
+		sum += frameTimes[i];
+		maxTime = MAX(maxTime, frameTimes[i]);
+	}
+	double mean = sum / frameTimes.size();
+
+	double sumSq = 0.0;
+	for ( unsigned int i = 0; i < frameTimes.size(); i++ )
+		sumSq += (frameTimes[i] - mean) * (frameTimes[i] - mean);
+	double variance = sumSq / frameTimes.size();
+
+	CCLog( "%s: %u frames, mean %.2f ms, std dev %.2f ms (variance %.2f), max %.2f ms",
+		   label, (unsigned int)frameTimes.size(), mean, sqrt(variance), variance, maxTime );
+}
+
+NS_COCOS3D_END
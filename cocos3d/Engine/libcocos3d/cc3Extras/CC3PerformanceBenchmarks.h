@@ -0,0 +1,145 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_PERFORMANCE_BENCHMARKS_H_
+#define _CC3_PERFORMANCE_BENCHMARKS_H_
+
+NS_COCOS3D_BEGIN
+
+/**
+ * CC3PerformanceBenchmarks is a collection of benchmarks that measure the effect of the
+ * performance features of the engine, by comparing each against the straightforward path
+ * it replaces, on the device and content of interest.
+ *
+ * Each benchmark logs its results through CCLog, so that they are available in release builds.
+ * Benchmarks that must observe the frame loop run across several frames, and log their results
+ * once complete. All other benchmarks run to completion before returning.
+ *
+ * This class should be considered for testing and experimental use only, and there is no
+ * need to include it in any finished application.
+ */
+class CC3PerformanceBenchmarks
+{
+public:
+	/**
+	 * Measures the variance in frame time while the POD file at the specified path is loaded
+	 * the specified number of times, first synchronously on the rendering thread, one load per
+	 * frame, and then all at once through the loadFromFileInBackground: method of CC3Resource.
+	 *
+	 * The mean, standard deviation and maximum frame time of each phase are logged once the
+	 * last background load has completed. A typical run uses 50 loads of a mid-sized file.
+	 *
+	 * This method must be invoked from the rendering thread while the CCDirector is running.
+	 */
+	static void					runResourceLoadingBenchmark( const std::string& podFilePath, GLuint loadCount );
+
+	/**
+	 * Compares loading the POD file at the specified path with the shouldMapFileContent property of
+	 * CC3PODResource set to YES, and then set to NO. In each phase, the file is loaded the specified
+	 * number of times, and all of the loaded resources are held until the phase ends, so that the
+	 * memory held by the meshes accumulates. A typical run uses 10 loads of a file of 50MB or more.
+	 *
+	 * The average load time of each phase is logged, along with the increase in the peak resident
+	 * memory of the process during that phase. Because the peak is a high-water mark for the whole
+	 * process, the mapped phase runs first, and this benchmark should be run early, before other
+	 * content has raised the peak. The peak is not available on Windows, and is logged as zero.
+	 *
+	 * This method must be invoked from the rendering thread, since building the resources may
+	 * load textures into the GL engine.
+	 */
+	static void					runPODLoadingBenchmark( const std::string& podFilePath, GLuint loadCount );
+
+	/**
+	 * Measures how the time to update a scene scales with its size, and with the number of threads
+	 * used by the parallel update mode of CC3NodeUpdatingVisitor.
+	 *
+	 * For each scene size, from 1k to 16k independent subtrees of eight moving nodes each, the scene
+	 * is updated serially, and then in parallel with two, four and eight threads, and the average
+	 * update time of each mode is logged, along with its speed-up over the serial update.
+	 */
+	static void					runSceneUpdateBenchmark();
+
+	/**
+	 * Compares the scalar and vector paths of the batch matrix functions. For each of
+	 * CC3Matrix4x3MultiplyBatchLeft, CC3Matrix4x3TransformLocations and CC3Matrix4x4Multiply,
+	 * the average time to process 100k matrices or locations is logged for both the scalar
+	 * implementation and the SSE2 or NEON implementation selected by the build, along with
+	 * the largest difference between their results.
+	 */
+	static void					runMatrixBenchmark();
+
+	/**
+	 * Measures the time to deform the vertex locations of a character with 1k bones and 100k vertices,
+	 * split into skin sections of 25 bones each, with four bone influences per vertex.
+	 *
+	 * The per-vertex deformation available through each CC3SkinSection is timed first, followed by
+	 * the batched deformation of CC3SoftwareSkinner, using one, two, four and eight threads. The
+	 * average time of each is logged, along with its speed-up over the per-vertex deformation.
+	 */
+	static void					runSkinningBenchmark();
+
+	/**
+	 * Measures the time to find and sequence the nodes to draw in a scene of 50k static props,
+	 * laid out on a grid, as a camera with a 200 unit far clipping distance turns on the spot.
+	 *
+	 * Three paths are timed on each frame: testing every node in the drawing sequence against the
+	 * frustum, culling a CC3BoundingVolumeHierarchy and then looking up each node in the drawing
+	 * sequence, and culling the hierarchy and sequencing only the visible nodes, as done by
+	 * CC3NodeDrawingVisitor. The average time of each is logged, along with the average number
+	 * of visible nodes. No GL drawing is performed, so only the culling work is measured.
+	 */
+	static void					runCullingBenchmark();
+
+	/**
+	 * Measures the time to evaluate one frame of animation for a skeleton of 500 bones, each
+	 * animating location, rotation and scale over 240 frames, as the animation plays from start
+	 * to finish over 600 frames.
+	 *
+	 * The same content is evaluated from CC3ArrayNodeAnimation instances, and from the
+	 * CC3CompressedNodeAnimation instances of a CC3AnimationClip compressed from them. The average
+	 * time per frame of each is logged, along with the memory used by each, and the largest
+	 * difference in location and rotation between the two.
+	 */
+	static void					runAnimationBenchmark();
+
+	/**
+	 * Measures the time to rebuild the shadow volume of high-poly shadow casters, as a point
+	 * light circles them, using spheres of about 16k, 65k and 262k faces.
+	 *
+	 * For each caster, the shadow volume is rebuilt by visiting each face and its neighbours, as
+	 * done before CC3ShadowSilhouetteExtractor was introduced, and then from the edge list of the
+	 * extractor, using one thread and then four threads. The average time per rebuild of each is
+	 * logged, along with its speed-up, and the number of shadow volume vertices each produced.
+	 * No GL drawing is performed, so only the rebuild is measured.
+	 */
+	static void					runShadowVolumeBenchmark();
+
+	/** Logs the mean, standard deviation and maximum of the specified frame times, in milliseconds. */
+	static void					logFrameTimes( const char* label, const std::vector<double>& frameTimes );
+};
+
+NS_COCOS3D_END
+
+#endif
@@ -35,6 +35,7 @@ CC3PFXResource::CC3PFXResource()
 {
 	_effectsByName = NULL;
 	_texturesByName = NULL;
+	_pfxParser = NULL;
 }
 
 CC3PFXResource::~CC3PFXResource()
@@ -47,6 +48,7 @@ CC3PFXResource::~CC3PFXResource()
 
 	CC_SAFE_RELEASE( _effectsByName );
 	CC_SAFE_RELEASE( _texturesByName );
+	CC_SAFE_DELETE( _pfxParser );
 }
 
 CC3PFXEffect* CC3PFXResource::getEffectNamed( const std::string& effectName )
@@ -128,6 +130,12 @@ CC3PFXResource* CC3PFXResource::resourceFromFile( const std::string& filePath )
 
 /** Load the file, and if successful build this resource from the contents. */
 bool CC3PFXResource::processFile( const std::string& anAbsoluteFilePath )
+{
+	return readFile( anAbsoluteFilePath ) && buildFromReadFile( anAbsoluteFilePath );
+}
+
+/** Parses the PFX file, and any shader files it references. May be invoked on a background thread. */
+bool CC3PFXResource::readFile( const std::string& anAbsoluteFilePath )
 {
 	// Split the path into directory and file names and set the PVR read path to the directory and
 	// pass the unqualified file name to the parser. This allows the parser to locate any additional
@@ -138,18 +146,30 @@ bool CC3PFXResource::processFile( const std::string& anAbsoluteFilePath )
 	CPVRTResourceFile::SetReadPath( dirName.c_str() );
 
 	CPVRTString	error;
-	CPVRTPFXParser* pfxParser = new CPVRTPFXParser();
-	bool wasLoaded = (pfxParser->ParseFromFile(fileName.c_str(), &error) == PVR_SUCCESS);
-	if (wasLoaded)
-		buildFromPFXParser( pfxParser );
-	else
+	CC_SAFE_DELETE( _pfxParser );
+	_pfxParser = new CPVRTPFXParser();
+	bool wasLoaded = (_pfxParser->ParseFromFile(fileName.c_str(), &error) == PVR_SUCCESS);
+	if ( !wasLoaded )
+	{
 		CC3_ERROR( "Could not load %s because %s", fileName.c_str(), error.c_str() );
-
-	delete pfxParser;
+		CC_SAFE_DELETE( _pfxParser );
+	}
 
 	return wasLoaded;
 }
 
+/** Builds this resource from the contents parsed by readFile, and releases the parser. */
+bool CC3PFXResource::buildFromReadFile( const std::string& )
+{
+	if ( !_pfxParser )
+		return false;
+
+	buildFromPFXParser( _pfxParser );
+	CC_SAFE_DELETE( _pfxParser );
+
+	return true;
+}
+
 /** Build this instance from the contents of the resource. */
 void  CC3PFXResource::buildFromPFXParser( CPVRTPFXParser* pfxParser )
 {
@@ -172,9 +192,9 @@ void CC3PFXResource::buildTexturesFromPFXParser( CPVRTPFXParser* pfxParser )
 		// Load texture and set texture parameters
 		std::string texName = pfxTex->Name.c_str();
 		std::string texFile = pfxTex->FileName.c_str();
-		CC3Texture* tex = CC3Texture::textureFromFile( texFile.c_str() );
+		CC3Texture* tex = loadTextureFromFile( texFile );
 		if ( tex == NULL )
-			tex = CC3Texture::textureFromFile( (m_directory + texFile).c_str() );
+			tex = loadTextureFromFile( m_directory + texFile );
 
 		tex->setHorizontalWrappingFunction( GLTextureWrapFromETextureWrap(pfxTex->nWrapS) );
 		tex->setVerticalWrappingFunction( GLTextureWrapFromETextureWrap(pfxTex->nWrapT) );
@@ -100,6 +100,10 @@ public:
 
 	/** Load the file, and if successful build this resource from the contents. */
 	bool						processFile( const std::string& anAbsoluteFilePath );
+	/** Parses the file, without building any content. May be invoked on a background thread. */
+	bool						readFile( const std::string& anAbsoluteFilePath );
+	/** Builds this instance from the contents parsed by the readFile: method. */
+	bool						buildFromReadFile( const std::string& anAbsoluteFilePath );
 	/** Build this instance from the contents of the resource. */
 	void						buildFromPFXParser( CPVRTPFXParser* pfxParser );
 	/** Extracts the texture definitions and loads them from files. */
@@ -124,6 +128,7 @@ public:
 protected:
 	CCDictionary*				_texturesByName;
 	CCDictionary*				_effectsByName;
+	CPVRTPFXParser*				_pfxParser;
 	// Class _semanticDelegateClass;
 };
 
@@ -31,12 +31,52 @@
 
 NS_COCOS3D_BEGIN
 
+CC3PODMesh::CC3PODMesh()
+{
+	_mappedFile = NULL;
+}
+
+CC3PODMesh::~CC3PODMesh()
+{
+	CC_SAFE_RELEASE( _mappedFile );
+}
+
+/** Returns whether any of the vertex or index data of the specified SPODMesh lies within the file mapped by the resource. */
+static bool SPODMeshReferencesMappedContent( SPODMesh* psm, CC3PODResource* aPODRez )
+{
+	if ( !aPODRez->getMappedFile() )
+		return false;
+
+	if ( aPODRez->isMappedContent( psm->pInterleaved ) || aPODRez->isMappedContent( psm->sFaces.pData ) )
+		return true;
+
+	CPODData* vtxData[] = { &psm->sVertex, &psm->sNormals, &psm->sTangents, &psm->sBinormals,
+							&psm->sVtxColours, &psm->sBoneIdx, &psm->sBoneWeight };
+	for (GLuint i = 0; i < sizeof(vtxData) / sizeof(vtxData[0]); i++)
+		if ( aPODRez->isMappedContent( vtxData[i]->pData ) )
+			return true;
+
+	for (GLuint i = 0; i < psm->nNumUVW; i++)
+		if ( aPODRez->isMappedContent( psm->psUVW[i].pData ) )
+			return true;
+
+	return false;
+}
+
 void CC3PODMesh::initAtIndex( GLint aPODIndex, CC3PODResource* aPODRez )
 {
     init();
     setPodIndex( aPODIndex );
     
 	SPODMesh* psm = (SPODMesh*)aPODRez->getMeshPODStructAtIndex( aPODIndex );
+
+	// Vertex arrays reference mapped content in place, so keep the mapped file alive
+	if ( SPODMeshReferencesMappedContent( psm, aPODRez ) )
+	{
+		CC_SAFE_RELEASE( _mappedFile );
+		_mappedFile = aPODRez->getMappedFile();
+		_mappedFile->retain();
+	}
 	//LogRez(@"Creating %@ at index %i from: %@", [self class], aPODIndex, NSStringFromSPODMesh(psm));
 
 	setVertexLocations( CC3PODVertexFactory::createVertexLocations( aPODRez, aPODIndex ) );
@@ -101,6 +141,11 @@ void CC3PODMesh::populateFrom( CC3PODMesh* another )
 	super::populateFrom(another);
 	
 	_podIndex = another->getPodIndex();
+
+	// The copied vertex arrays may reference the same mapped content
+	CC_SAFE_RETAIN( another->_mappedFile );
+	CC_SAFE_RELEASE( _mappedFile );
+	_mappedFile = another->_mappedFile;
 }
 
 CCObject* CC3PODMesh::copyWithZone( CCZone* zone )
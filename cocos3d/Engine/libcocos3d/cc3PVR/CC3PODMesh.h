@@ -38,6 +38,9 @@ class CC3PODMesh : public CC3Mesh
 {
 	DECLARE_SUPER( CC3Mesh );
 public:
+	CC3PODMesh();
+	~CC3PODMesh();
+
 	virtual void				initAtIndex( GLint aPODIndex, CC3PODResource* aPODRez );
 	static CC3PODMesh*			meshAtIndex( GLint aPODIndex, CC3PODResource* aPODRez );
 
@@ -52,6 +55,7 @@ public:
 
 protected:
 	GLint						_podIndex;
+	CC3MappedFile*				_mappedFile;
 };
 
 NS_COCOS3D_END
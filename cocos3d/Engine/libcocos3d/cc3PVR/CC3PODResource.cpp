@@ -44,10 +44,13 @@ enum PodResourceNodeType
 CC3PODResource::CC3PODResource()
 {
 	_allNodes = NULL;
+	_nodeNameMapCount = 0;
 	_meshes = NULL;
 	_materials = NULL;
 	_textures = NULL;
 	_pvrtModel = NULL;
+	_mappedFile = NULL;
+	_meshOptimizer = NULL;
 }
 
 CC3PODResource::~CC3PODResource()
@@ -69,6 +72,8 @@ CC3PODResource::~CC3PODResource()
 	CC_SAFE_RELEASE(_textures);
 
 	deleteCPVRTModelPOD();
+	CC_SAFE_RELEASE( _mappedFile );	// After the model, which may reference it
+	CC_SAFE_RELEASE( _meshOptimizer );
 }
 
 CPVRTModelPOD* CC3PODResource::getPvrtModelImpl()
@@ -104,6 +109,8 @@ bool CC3PODResource::init()
 		_textures->retain();
 		_textureParameters = CC3Texture::defaultTextureParameters();
 		_shouldAutoBuild = true;
+		_shouldMapFileContent = true;
+		_shouldQuantizeVertexContent = false;
 
 		return true;
 	}
@@ -112,6 +119,12 @@ bool CC3PODResource::init()
 }
 
 bool CC3PODResource::processFile( const std::string& anAbsoluteFilePath )
+{
+	return readFile( anAbsoluteFilePath ) && buildFromReadFile( anAbsoluteFilePath );
+}
+
+/** Parses the POD file, without building any content. May be invoked on a background thread. */
+bool CC3PODResource::readFile( const std::string& anAbsoluteFilePath )
 {
 	// Split the path into directory and file names and set the PVR read path to the directory and
 	// pass the unqualified file name to the parser. This allows the parser to locate any additional
@@ -121,12 +134,39 @@ bool CC3PODResource::processFile( const std::string& anAbsoluteFilePath )
 	CPVRTResourceFile::SetReadPath( dirName.c_str() );
 	
 	createCPVRTModelPOD();
-	bool wasLoaded = (getPvrtModelImpl()->ReadFromFile(fileName.c_str()) == PVR_SUCCESS);
+
+	// The mapped file is not autoreleased, because this may be running on a background thread
+	bool wasLoaded;
+	CC3MappedFile* mappedFile = NULL;
+	if ( _shouldMapFileContent )
+	{
+		mappedFile = new CC3MappedFile;
+		if ( !mappedFile->initWithFilePath( anAbsoluteFilePath ) )
+			CC_SAFE_DELETE( mappedFile );
+	}
+
+	if ( mappedFile )
+	{
+		// Hold before reading, because the model references the content in place
+		CC_SAFE_RELEASE( _mappedFile );
+		_mappedFile = mappedFile;
+		wasLoaded = (getPvrtModelImpl()->ReadFromMemoryInPlace( _mappedFile->getBytes(), _mappedFile->getLength() ) == PVR_SUCCESS);
+	}
+	else
+	{
+		wasLoaded = (getPvrtModelImpl()->ReadFromFile(fileName.c_str()) == PVR_SUCCESS);
+	}
 	
-	if (wasLoaded && _shouldAutoBuild) 
+	return wasLoaded;
+}
+
+/** Builds the content parsed by readFile, if the shouldAutoBuild property is set. */
+bool CC3PODResource::buildFromReadFile( const std::string& )
+{
+	if ( _shouldAutoBuild ) 
 		build();
 	
-	return wasLoaded;
+	return true;
 }
 
 void CC3PODResource::build()
@@ -139,6 +179,64 @@ void CC3PODResource::build()
 	buildNodes();
 	buildSoftBodyNode();
 	deleteCPVRTModelPOD();
+
+	// Each mesh retains the mapped file if it references it
+	CC_SAFE_RELEASE_NULL( _mappedFile );
+}
+
+bool CC3PODResource::shouldAutoBuild()
+{
+	return _shouldAutoBuild;
+}
+
+void CC3PODResource::setShouldAutoBuild( bool autoBuild )
+{
+	_shouldAutoBuild = autoBuild;
+}
+
+bool CC3PODResource::shouldMapFileContent()
+{
+	return _shouldMapFileContent;
+}
+
+void CC3PODResource::setShouldMapFileContent( bool shouldMap )
+{
+	_shouldMapFileContent = shouldMap;
+}
+
+CC3MeshOptimizer* CC3PODResource::getMeshOptimizer()
+{
+	return _meshOptimizer;
+}
+
+void CC3PODResource::setMeshOptimizer( CC3MeshOptimizer* optimizer )
+{
+	if ( optimizer == _meshOptimizer )
+		return;
+
+	CC_SAFE_RELEASE( _meshOptimizer );
+	_meshOptimizer = optimizer;
+	CC_SAFE_RETAIN( optimizer );
+}
+
+bool CC3PODResource::shouldQuantizeVertexContent()
+{
+	return _shouldQuantizeVertexContent;
+}
+
+void CC3PODResource::setShouldQuantizeVertexContent( bool shouldQuantize )
+{
+	_shouldQuantizeVertexContent = shouldQuantize;
+}
+
+CC3MappedFile* CC3PODResource::getMappedFile()
+{
+	return _mappedFile;
+}
+
+bool CC3PODResource::isMappedContent( const void* aPointer )
+{
+	return _mappedFile && _mappedFile->containsPointer( aPointer );
 }
 
 bool CC3PODResource::saveToFile( const std::string& filePath )
@@ -276,19 +374,33 @@ CC3Node* CC3PODResource::getNodeAtIndex( GLuint nodeIndex )
 
 CC3Node* CC3PODResource::getNodeNamed( const std::string& aName )
 {
+	if ( !_allNodes )
+		return NULL;
+
 	std::string lcName = aName;
 	CC3String::makeLowercase( lcName );
-	GLuint nCnt = getNodeCount();
+
+	// Rebuild the map only if nodes have been added since it was built
+	if ( _nodeNameMapCount != _allNodes->count() )
+		buildNodeNameMap();
+
+	std::map<std::string, GLuint>::iterator iter = _nodeIndicesByName.find( lcName );
+	return (iter != _nodeIndicesByName.end()) ? getNodeAtIndex( iter->second ) : NULL;
+}
+
+/** Maps the lowercase name of each node to its index. The first node with a particular name wins. */
+void CC3PODResource::buildNodeNameMap()
+{
+	_nodeIndicesByName.clear();
+
+	GLuint nCnt = _allNodes->count();
 	for (GLuint i = 0; i < nCnt; i++) 
 	{
-		CC3Node* aNode = getNodeAtIndex(i);
-
-		std::string nodeName = aNode->getName();
+		std::string nodeName = getNodeAtIndex(i)->getName();
 		CC3String::makeLowercase( nodeName );
-		if ( nodeName == lcName ) 
-			return aNode;
+		_nodeIndicesByName.insert( std::make_pair( nodeName, i ) );
 	}
-	return NULL;
+	_nodeNameMapCount = nCnt;
 }
 
 void CC3PODResource::buildNodes()
@@ -529,7 +641,21 @@ void CC3PODResource::buildMeshes()
 {
 	GLuint mCount = getMeshCount();
 	for (GLuint i = 0; i < mCount; i++) 
-		_meshes->addObject( buildMeshAtIndex(i) );
+	{
+		CC3Mesh* mesh = buildMeshAtIndex(i);
+		if ( _meshOptimizer )
+			_meshOptimizer->optimizeMesh( mesh );
+		if ( _shouldQuantizeVertexContent )
+			mesh->setShouldQuantizeVertexContent( true );
+		_meshes->addObject( mesh );
+	}
+
+	if ( _meshOptimizer )
+	{
+		CC3_TRACE( "CC3PODResource optimized %u meshes with %u triangles: ACMR %.3f before and %.3f after, %u vertices before and %u after",
+			_meshOptimizer->getMeshCount(), _meshOptimizer->getTriangleCount(), _meshOptimizer->getACMRBefore(),
+			_meshOptimizer->getACMRAfter(), _meshOptimizer->getVertexCountBefore(), _meshOptimizer->getVertexCountAfter() );
+	}
 }
 
 CC3Mesh* CC3PODResource::getMeshAtIndex( GLuint meshIndex )
@@ -700,7 +826,7 @@ CC3Texture* CC3PODResource::buildTextureAtIndex( GLuint textureIndex )
 		texFile = "Cocos3D.png";
 
 	std::string texPath = getDirectory() + texFile;
-	CC3Texture* tex = CC3Texture::textureFromFile(texPath.c_str());
+	CC3Texture* tex = loadTextureFromFile( texPath );
 	if ( tex )
 		tex->setTextureParameters( _textureParameters );
 
@@ -770,4 +896,53 @@ CC3PODResource* CC3PODResource::resourceFromFile( const std::string& filePath )
 	return rez;
 }
 
+/** The callback and context of a resourceFromFileInBackground: request, forwarded once the resource has been cached. */
+typedef struct
+{
+	CC3ResourceLoadCallback		callback;
+	void*						userData;
+} CC3PODResourceCacheRequest;
+
+/** Adds a resource loaded by resourceFromFileInBackground: to the cache, unless another load got there first. */
+static void cachePODResourceLoadedInBackground( CC3Resource* resource, bool wasLoaded, void* cacheRequest )
+{
+	CC3PODResourceCacheRequest* request = (CC3PODResourceCacheRequest*)cacheRequest;
+
+	CC3Resource* cachedRez = CC3Resource::getResourceNamed( resource->getName() );
+	if ( cachedRez )
+	{
+		resource = cachedRez;
+		wasLoaded = cachedRez->wasLoaded();
+	}
+	else if ( wasLoaded )
+	{
+		CC3Resource::addResource( resource );
+	}
+
+	if ( request->callback )
+		request->callback( resource, wasLoaded, request->userData );
+
+	delete request;
+}
+
+void CC3PODResource::resourceFromFileInBackground( const std::string& filePath, CC3ResourceLoadCallback callback, void* userData )
+{
+	CC3PODResource* rez = (CC3PODResource*)getResourceNamed( resourceNameFromFilePath(filePath) );
+	if (rez) 
+	{
+		if ( callback )
+			callback( rez, rez->wasLoaded(), userData );
+		return;
+	}
+
+	CC3PODResourceCacheRequest* request = new CC3PODResourceCacheRequest;
+	request->callback = callback;
+	request->userData = userData;
+
+	rez = new CC3PODResource;
+	rez->init();
+	rez->loadFromFileInBackground( filePath, cachePODResourceLoadedInBackground, request );
+	rez->release();		// retained by the load until the callback has been invoked
+}
+
 NS_COCOS3D_END
@@ -187,6 +187,65 @@ public:
 	bool						shouldAutoBuild();
 	void						setShouldAutoBuild( bool autoBuild );
 
+	/**
+	 * Indicates whether the POD file should be mapped into memory when it is loaded, with the
+	 * mesh vertex and index data referenced in place within the mapped file, instead of reading
+	 * the file into memory and copying that data out of it into separately allocated arrays.
+	 *
+	 * Mapping the file avoids holding a complete copy of the file in memory while it is parsed,
+	 * and avoids copying the vertex and index data. Pages of vertex data are only read from the
+	 * file when first accessed, which is typically when the mesh is copied to a GL buffer, and
+	 * they can be discarded by the operating system until then. Each mesh retains the mapped file
+	 * for as long as it might reference its content. See the CC3MappedFile class for more info.
+	 *
+	 * Vertex data that is not aligned on a four-byte boundary within the file, or that must be
+	 * byte-swapped for the platform, is copied as usual. If the file cannot be mapped, it is
+	 * read into memory instead, and vertex data is still referenced in place within that memory.
+	 *
+	 * Because mapped vertex data is not allocated by the vertex arrays, it is not carried over if
+	 * the vertex capacity of a mesh is subsequently changed. If you need to resize the vertex
+	 * content of a mesh loaded from this resource, set this property to NO.
+	 *
+	 * The initial value of this property is YES. This property must be set before the loadFromFile:
+	 * method is invoked.
+	 */
+	bool						shouldMapFileContent();
+	void						setShouldMapFileContent( bool shouldMap );
+
+	/** Returns the file content mapped by this resource, or NULL if the file was not mapped, or the content has been built. */
+	CC3MappedFile*				getMappedFile();
+
+	/** Returns whether the specified pointer references content within the file mapped by this resource. */
+	bool						isMappedContent( const void* aPointer );
+
+	/**
+	 * The mesh optimizer used to optimize each mesh as it is built from the POD file, or NULL
+	 * if meshes should be used as they appear in the file.
+	 *
+	 * When set, each mesh is passed to the optimizeMesh: method of the optimizer once it has been
+	 * built, and before it is attached to a mesh node. The optimizer accumulates the ACMR before
+	 * and after optimization across all meshes, which can be retrieved from it once loading is
+	 * complete. See the CC3MeshOptimizer class for more info.
+	 *
+	 * The initial value of this property is NULL. This property must be set before the
+	 * loadFromFile: method is invoked.
+	 */
+	CC3MeshOptimizer*			getMeshOptimizer();
+	void						setMeshOptimizer( CC3MeshOptimizer* optimizer );
+
+	/**
+	 * Indicates whether the vertex content of each mesh built from the POD file should be packed
+	 * into quantized vertex formats when its GL buffers are created.
+	 *
+	 * When set to YES, the shouldQuantizeVertexContent property of each mesh is set to YES as it
+	 * is built. See the quantizeVertexContent method of CC3Mesh for more info.
+	 *
+	 * The initial value of this property is NO. This property must be set before the loadFromFile:
+	 * method is invoked.
+	 */
+	bool						shouldQuantizeVertexContent();
+	void						setShouldQuantizeVertexContent( bool shouldQuantize );
+
 	/**
 	 * Template method that extracts and builds all components. This is automatically invoked from
 	 * the loadFromFile: method if the POD file was successfully loaded, and the shouldAutoBuild
@@ -253,7 +312,13 @@ public:
 	/** Returns the node at the specified index in the allNodes array. */
 	CC3Node*					getNodeAtIndex( GLuint nodeIndex );
 
-	/** Returns the node with the specified name from the allNodes array. */
+	/**
+	 * Returns the node with the specified name from the allNodes array. The comparison is case-insensitive.
+	 *
+	 * Lookups are made through a map of lowercase node names that is built on first use, and is
+	 * rebuilt only when nodes have been added since the map was built. Nodes are matched by the
+	 * names they had when the map was built, so renaming a node does not change its lookup name.
+	 */
 	CC3Node*					getNodeNamed( const std::string& aName );
 	 
 	/**
@@ -548,16 +613,35 @@ public:
 	void						createCPVRTModelPOD();
 	virtual bool				init();
 	bool						processFile( const std::string& anAbsoluteFilePath );
+	bool						readFile( const std::string& anAbsoluteFilePath );
+	bool						buildFromReadFile( const std::string& anAbsoluteFilePath );
 	std::string					fullDescription();
 	static CC3PODResource*		resourceFromFile( const std::string& filePath );
+
+	/**
+	 * Loads the POD resource from the specified file in the background, as described for the
+	 * loadFromFileInBackground: method, and invokes the specified callback on the rendering
+	 * thread with the loaded resource.
+	 *
+	 * If a resource with the name derived from the file path is already cached, the callback is
+	 * invoked with it immediately. Otherwise, once loaded, the resource is added to the cache
+	 * before the callback is invoked. The callback should retain the resource if it is needed
+	 * beyond the callback, because the resource cache does not hold it strongly.
+	 *
+	 * This method must be invoked from the rendering thread.
+	 */
+	static void					resourceFromFileInBackground( const std::string& filePath, CC3ResourceLoadCallback callback, void* userData );
     
 private:
     int                         getNodeType( GLuint podIndex );
     void                        linkToPODNodes( CC3Node* pNode, int parentIndex, int targetIndex, CCArray* nodeArray );
+	void						buildNodeNameMap();
 
 protected:
 	PODClassPtr					_pvrtModel;
 	CCArray*					_allNodes;
+	std::map<std::string, GLuint>	_nodeIndicesByName;
+	GLuint						_nodeNameMapCount;
 	CCArray*					_meshes;
 	CCArray*					_materials;
 	CCArray*					_textures;
@@ -566,7 +650,11 @@ protected:
 	ccColor4F					_backgroundColor;
 	GLuint						_animationFrameCount;
 	GLfloat						_animationFrameRate;
+	CC3MappedFile*				_mappedFile;
+	CC3MeshOptimizer*			_meshOptimizer;
 	bool						_shouldAutoBuild : 1;
+	bool						_shouldMapFileContent : 1;
+	bool						_shouldQuantizeVertexContent : 1;
 };
 
 
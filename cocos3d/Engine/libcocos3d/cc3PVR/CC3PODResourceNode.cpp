@@ -60,8 +60,13 @@ void CC3PODResourceNode::populateFromResource( CC3NodesResource* resource )
 {
 	super::populateFromResource(resource);
 	
-	_animationFrameCount = ((CC3PODResource*)resource)->getAnimationFrameCount();
-	_animationFrameRate = ((CC3PODResource*)resource)->getAnimationFrameRate();
+	// Content restored from a scene cache file is static, and carries no animation frames
+	CC3PODResource* podRez = dynamic_cast<CC3PODResource*>( resource );
+	if ( !podRez )
+		return;
+
+	_animationFrameCount = podRez->getAnimationFrameCount();
+	_animationFrameRate = podRez->getAnimationFrameRate();
 }
 
 void CC3PODResourceNode::populateFrom( CC3PODResourceNode* another )
@@ -62,7 +62,10 @@ CC3VertexLocations*	CC3PODVertexFactory::createVertexLocations( CC3PODResource*
 				pValue->setElementOffset( 0 );
 			}
 
-			pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+			if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+				pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+			else
+				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 
 			pValue->setDrawingMode( GLDrawingModeForSPODMesh(psm) );
 
@@ -104,7 +107,10 @@ CC3VertexIndices* CC3PODVertexFactory::createVertexIndices( CC3PODResource* aPOD
             pValue->setElementOffset( 0 );  // Indices are not interleaved.
 
             pValue->setVertexCount( pValue->getVertexIndexCountFromFaceCount( psm->nNumFaces ) );
-			pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+			if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+				pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+			else
+				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 
 			pValue->setDrawingMode( GLDrawingModeForSPODMesh(psm) );
 
@@ -149,7 +155,10 @@ CC3VertexNormals* CC3PODVertexFactory::createVertexNormals( CC3PODResource* aPOD
 			else 
 			{	// not interleaved
 				pValue->setVertices( pcd->pData );
-				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+				if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+					pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+				else
+					pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 				pcd->pData = NULL;					// Clear data reference from CPODData so it won't try to free it.
 				pValue->setElementOffset( 0 );
 			}
@@ -189,7 +198,10 @@ CC3VertexTangents* CC3PODVertexFactory::createVertexTangents( CC3PODResource* aP
 			else 
 			{	// not interleaved
 				pValue->setVertices( pcd->pData );
-				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+				if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+					pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+				else
+					pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 				pcd->pData = NULL;					// Clear data reference from CPODData so it won't try to free it.
 				pValue->setElementOffset( 0 );
 			}
@@ -229,7 +241,10 @@ CC3VertexColors* CC3PODVertexFactory::createVertexColors( CC3PODResource* aPODRe
 			else 
 			{	// not interleaved
 				pValue->setVertices( pcd->pData );
-				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+				if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+					pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+				else
+					pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 				pcd->pData = NULL;					// Clear data reference from CPODData so it won't try to free it.
 				pValue->setElementOffset( 0 );
 			}
@@ -272,7 +287,10 @@ CC3VertexBoneWeights* CC3PODVertexFactory::createVertexBoneWeights( CC3PODResour
 			else 
 			{	// not interleaved
 				pValue->setVertices( pcd->pData );
-				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+				if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+					pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+				else
+					pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 				pcd->pData = NULL;					// Clear data reference from CPODData so it won't try to free it.
 				pValue->setElementOffset( 0 );
 			}
@@ -312,7 +330,10 @@ CC3VertexBoneIndices* CC3PODVertexFactory::createVertexBoneIndices( CC3PODResour
 			else 
 			{	// not interleaved
 				pValue->setVertices( pcd->pData );
-				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+				if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+					pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+				else
+					pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 				pcd->pData = NULL;					// Clear data reference from CPODData so it won't try to free it.
 				pValue->setElementOffset( 0 );
 			}
@@ -352,7 +373,10 @@ CC3VertexTextureCoordinates* CC3PODVertexFactory::createVertexTextureCoordinates
 			else 
 			{	// not interleaved
 				pValue->setVertices( pcd->pData );
-				pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
+				if ( aPODRez->isMappedContent( pValue->getVertices() ) )
+					pValue->setMappedVertexCapacity( pValue->getVertexCount() );		// Mapped content is referenced in place and never freed.
+				else
+					pValue->setVertexCapacityWithoutAllocation( pValue->getVertexCount() );	// CC3VertexArray instance will free data when needed.
 				pcd->pData = NULL;					// Clear data reference from CPODData so it won't try to free it.
 				pValue->setElementOffset( 0 );
 			}
@@ -310,6 +310,54 @@ public:
 
 	bool ReadMarker(unsigned int &nName, unsigned int &nLen);
 
+	/*!***************************************************************************
+	@Function			ReadInPlace
+	@Input				dwNumberOfBytesToRead	Number of bytes to read
+	@Input				nAlignment				Required alignment of the bytes
+	@Return				A pointer to the bytes within the source, or NULL if the
+						source cannot be referenced in place.
+	@Description		Skips the specified number of bytes, and returns a pointer
+						to them within the source, if the source allows it.
+						(patched for Cocos3D)
+	*****************************************************************************/
+	virtual const void* ReadInPlace(const unsigned int /*dwNumberOfBytesToRead*/, const unsigned int /*nAlignment*/) { return 0; }
+
+	template <typename T>
+	bool ReadInPlaceOrAlloc(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead, const unsigned int nAlignment)	// patched for Cocos3D
+	{
+		const void* pInPlace = ReadInPlace(dwNumberOfBytesToRead, nAlignment);
+		if(pInPlace)
+		{
+			lpBuffer = (T*) pInPlace;
+			return true;
+		}
+		return ReadAfterAlloc(lpBuffer, dwNumberOfBytesToRead);
+	}
+
+	template <typename T>
+	bool ReadInPlaceOrAlloc16(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead)	// patched for Cocos3D
+	{
+		const void* pInPlace = ReadInPlace(dwNumberOfBytesToRead, 2);
+		if(pInPlace)
+		{
+			lpBuffer = (T*) pInPlace;
+			return true;
+		}
+		return ReadAfterAlloc16(lpBuffer, dwNumberOfBytesToRead);
+	}
+
+	template <typename T>
+	bool ReadInPlaceOrAlloc32(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead)	// patched for Cocos3D
+	{
+		const void* pInPlace = ReadInPlace(dwNumberOfBytesToRead, 4);
+		if(pInPlace)
+		{
+			lpBuffer = (T*) pInPlace;
+			return true;
+		}
+		return ReadAfterAlloc32(lpBuffer, dwNumberOfBytesToRead);
+	}
+
 	template <typename T>
 	bool ReadAfterAlloc(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead)
 	{
@@ -382,7 +430,7 @@ public:
 	@Function			CSourceStream
 	@Description		Constructor
 	*****************************************************************************/
-	CSourceStream() : m_pFile(0), m_BytesReadCount(0) {}
+	CSourceStream() : m_pFile(0), m_BytesReadCount(0), m_bInPlace(false) {}
 
 	/*!***************************************************************************
 	@Function			~CSourceStream
@@ -395,6 +443,12 @@ public:
 
 	virtual bool Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead);
 	virtual bool Skip(const unsigned int nBytes);
+	virtual const void* ReadInPlace(const unsigned int dwNumberOfBytesToRead, const unsigned int nAlignment);	// patched for Cocos3D
+
+	void SetInPlace(const bool bInPlace) { m_bInPlace = bInPlace; }				// patched for Cocos3D
+
+protected:
+	bool m_bInPlace;																// patched for Cocos3D
 };
 
 /*!***************************************************************************
@@ -488,6 +542,28 @@ bool CSourceStream::Skip(const unsigned int nBytes)
 	return true;
 }
 
+/*!***************************************************************************
+@Function			ReadInPlace
+@Input				dwNumberOfBytesToRead	Number of bytes to read
+@Input				nAlignment				Required alignment of the bytes
+@Return				A pointer to the bytes within the source data, or NULL.
+@Description		If in-place reading is enabled, and the data needs no byte
+					swapping, and is aligned as required for access to its
+					elements, skips the bytes and returns a pointer to them.
+					(patched for Cocos3D)
+*****************************************************************************/
+const void* CSourceStream::ReadInPlace(const unsigned int dwNumberOfBytesToRead, const unsigned int nAlignment)
+{
+	if (!m_bInPlace || !dwNumberOfBytesToRead || !PVRTIsLittleEndian()) return 0;
+	if (m_BytesReadCount + dwNumberOfBytesToRead > m_pFile->Size()) return 0;
+
+	const char* pData = &((const char*) m_pFile->DataPtr())[m_BytesReadCount];
+	if ((size_t) pData % nAlignment) return 0;
+
+	m_BytesReadCount += dwNumberOfBytesToRead;
+	return pData;
+}
+
 #if defined(_WIN32)
 /*!***************************************************************************
  Class: CSourceResource
@@ -1172,18 +1248,18 @@ static bool ReadCPODData(
 			{
 				switch(PVRTModelPODDataTypeSize(s.eType))
 				{
-					case 1: if(!src.ReadAfterAlloc(s.pData, nLen)) return false; break;
+					case 1: if(!src.ReadInPlaceOrAlloc(s.pData, nLen, 1)) return false; break;		// patched for Cocos3D
 					case 2:
 						{ // reading 16bit data but have 8bit pointer
 							PVRTuint16 *p16Pointer=NULL;
-							if(!src.ReadAfterAlloc16(p16Pointer, nLen)) return false;
+							if(!src.ReadInPlaceOrAlloc16(p16Pointer, nLen)) return false;		// patched for Cocos3D
 							s.pData = (unsigned char*)p16Pointer;
 							break;
 						}
 					case 4:
 						{ // reading 32bit data but have 8bit pointer
 							PVRTuint32 *p32Pointer=NULL;
-							if(!src.ReadAfterAlloc32(p32Pointer, nLen)) return false;
+							if(!src.ReadInPlaceOrAlloc32(p32Pointer, nLen)) return false;		// patched for Cocos3D
 							s.pData = (unsigned char*)p32Pointer;
 							break;
 						}
@@ -1476,7 +1552,7 @@ static bool ReadMesh(
 		case ePODFileMeshNumUVW:			if(!src.Read32(s.nNumUVW)) return false;	if(!SafeAlloc(s.psUVW, s.nNumUVW)) return false;	break;
 		case ePODFileMeshStripLength:		if(!src.ReadAfterAlloc32(s.pnStripLength, nLen)) return false;								break;
 		case ePODFileMeshNumStrips:			if(!src.Read32(s.nNumStrips)) return false;													break;
-		case ePODFileMeshInterleaved:		if(!src.ReadAfterAlloc(s.pInterleaved, nLen)) return false;									break;
+		case ePODFileMeshInterleaved:		if(!src.ReadInPlaceOrAlloc(s.pInterleaved, nLen, 4)) return false;								break;	// patched for Cocos3D
 		case ePODFileMeshBoneBatches:		if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatches, nLen)) return false;						break;
 		case ePODFileMeshBoneBatchBoneCnts:	if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatchBoneCnt, nLen)) return false;					break;
 		case ePODFileMeshBoneBatchOffsets:	if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatchOffset, nLen)) return false;					break;
@@ -1914,6 +1990,45 @@ EPVRTError CPVRTModelPOD::ReadFromMemory(
 	return ReadFromSourceStream(this, src, pszExpOpt, count, pszHistory, historyCount);
 }
 
+/*!***************************************************************************
+ @Function			ReadFromMemoryInPlace
+ @Input				pData			Data to load
+ @Input				i32Size			Size of data
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the supplied pod data, referencing the mesh vertex and
+					index data in place where possible. (patched for Cocos3D)
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromMemoryInPlace(
+	const char		* pData,
+	const size_t	i32Size)
+{
+	CSourceStream src;
+
+	if(!src.Init(pData, i32Size))
+		return PVR_FAIL;
+
+	src.SetInPlace(true);
+	EPVRTError err = ReadFromSourceStream(this, src, NULL, 0, NULL, 0);
+
+	// Reading clears the model, so record the referenced data afterwards,
+	// even on failure, so that Destroy will not try to free any of it.
+	m_pInPlaceData = pData;
+	m_nInPlaceSize = i32Size;
+
+	return err;
+}
+
+/*!***************************************************************************
+ @Function			IsInPlaceData
+ @Input				pData			Pointer to test
+ @Return			true if the pointer lies within the in-place data
+ @Description		(patched for Cocos3D)
+*****************************************************************************/
+bool CPVRTModelPOD::IsInPlaceData(const void * const pData) const
+{
+	return m_pInPlaceData && pData >= (const void*) m_pInPlaceData && pData < (const void*) (m_pInPlaceData + m_nInPlaceSize);
+}
+
 /*!***************************************************************************
  @Function			ReadFromMemory
  @Input				scene			Scene data from the header file
@@ -2136,7 +2251,7 @@ bool CPVRTModelPOD::IsLoaded()
  @Function			Constructor
  @Description		Initializes the pointer to scene data to NULL
 *****************************************************************************/
-CPVRTModelPOD::CPVRTModelPOD() : m_pImpl(NULL)
+CPVRTModelPOD::CPVRTModelPOD() : m_pImpl(NULL), m_pInPlaceData(NULL), m_nInPlaceSize(0)	// patched for Cocos3D
 {}
 
 /*!***************************************************************************
@@ -2180,30 +2295,35 @@ void CPVRTModelPOD::Destroy()
 			}
 			FREE(pMaterial);
 
+			// Mesh data read by ReadFromMemoryInPlace may not have been allocated (patched for Cocos3D)
+#define FREE_MESH_DATA(X)	{ if(IsInPlaceData(X)) { (X) = 0; } else { FREE(X); } }
+
 			for(i = 0; i < nNumMesh; ++i) {
-				FREE(pMesh[i].sFaces.pData);
+				FREE_MESH_DATA(pMesh[i].sFaces.pData);
 				FREE(pMesh[i].pnStripLength);
 				if(pMesh[i].pInterleaved)
 				{
-					FREE(pMesh[i].pInterleaved);
+					FREE_MESH_DATA(pMesh[i].pInterleaved);
 				}
 				else
 				{
-					FREE(pMesh[i].sVertex.pData);
-					FREE(pMesh[i].sNormals.pData);
-					FREE(pMesh[i].sTangents.pData);
-					FREE(pMesh[i].sBinormals.pData);
+					FREE_MESH_DATA(pMesh[i].sVertex.pData);
+					FREE_MESH_DATA(pMesh[i].sNormals.pData);
+					FREE_MESH_DATA(pMesh[i].sTangents.pData);
+					FREE_MESH_DATA(pMesh[i].sBinormals.pData);
 					for(unsigned int j = 0; j < pMesh[i].nNumUVW; ++j)
-						FREE(pMesh[i].psUVW[j].pData);
-					FREE(pMesh[i].sVtxColours.pData);
-					FREE(pMesh[i].sBoneIdx.pData);
-					FREE(pMesh[i].sBoneWeight.pData);
+						FREE_MESH_DATA(pMesh[i].psUVW[j].pData);
+					FREE_MESH_DATA(pMesh[i].sVtxColours.pData);
+					FREE_MESH_DATA(pMesh[i].sBoneIdx.pData);
+					FREE_MESH_DATA(pMesh[i].sBoneWeight.pData);
 				}
 				FREE(pMesh[i].psUVW);
 				pMesh[i].sBoneBatches.Release();
 			}
 			FREE(pMesh);
 
+#undef FREE_MESH_DATA
+
 			for(i = 0; i < nNumNode; ++i) {
 				FREE(pNode[i].pszName);
 				FREE(pNode[i].pfAnimPosition);
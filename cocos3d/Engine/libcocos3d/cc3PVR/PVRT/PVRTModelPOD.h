@@ -370,6 +370,32 @@ public:
 	EPVRTError ReadFromMemory(
 		const SPODScene &scene);
 
+	/*!***************************************************************************
+	 @fn       		ReadFromMemoryInPlace
+	 @param[in]		pData			Data to load
+	 @param[in]		i32Size			Size of data
+	 @return		PVR_SUCCESS if successful, PVR_FAIL if not
+	 @brief     	Loads the supplied pod data, referencing the mesh vertex and
+					index data in place within the supplied data, instead of
+					copying it, wherever the platform byte order and the data
+					alignment allow. The supplied data must remain valid until
+					this model is destroyed, and for as long as any mesh data
+					that references it is in use. Use IsInPlaceData to
+					determine whether mesh data references the supplied data.
+					(patched for Cocos3D)
+	*****************************************************************************/
+	EPVRTError ReadFromMemoryInPlace(
+		const char		* pData,
+		const size_t	i32Size);
+
+	/*!***************************************************************************
+	 @fn       		IsInPlaceData
+	 @param[in]		pData			Pointer to test
+	 @return		true if the pointer lies within the data supplied to
+					ReadFromMemoryInPlace. (patched for Cocos3D)
+	*****************************************************************************/
+	bool IsInPlaceData(const void * const pData) const;
+
 	/*!***************************************************************************
 	 @fn       		CopyFromMemory
 	 @param[in]			scene			Scene data from the header file
@@ -674,6 +700,8 @@ public:
 
 private:
 	SPVRTPODImpl	*m_pImpl;	/*!< Internal implementation data */
+	const char		*m_pInPlaceData;	/*!< Data referenced in place by ReadFromMemoryInPlace (patched for Cocos3D) */
+	size_t			m_nInPlaceSize;		/*!< Size of the data referenced in place (patched for Cocos3D) */
 };
 
 /****************************************************************************
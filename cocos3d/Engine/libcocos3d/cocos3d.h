@@ -60,21 +60,29 @@
 #include "Utility/CC3Backgrounder.h"
 #include "Utility/CC3Cache.h"
 #include "Utility/CC3DataArray.h"
+#include "Utility/CC3FrameProfiler.h"
 #include "Utility/CC3Identifiable.h"
 #include "Utility/CC3Logging.h"
 #include "Utility/CC3PerformanceStatistics.h"
 #include "Utility/CC3Rotator.h"
+#include "Utility/CC3SIMD.h"
+#include "Utility/CC3WorkerPool.h"
 
 /// Nodes
 #include "Nodes/CC3MeshCommon.h"
 #include "Nodes/CC3NodeListeners.h"
 #include "Nodes/CC3Node.h"
+#include "Nodes/CC3NodeIndex.h"
+#include "Nodes/CC3NodeTransformStore.h"
 #include "Nodes/CC3BoundingVolumes.h"
+#include "Nodes/CC3BoundingVolumeHierarchy.h"
 #include "Nodes/CC3Camera.h"
 #include "Nodes/CC3EnvironmentNodes.h"
 #include "Nodes/CC3Light.h"
 #include "Nodes/CC3LocalContentNode.h"
 #include "Nodes/CC3MeshNode.h"
+#include "Nodes/CC3InstancedMeshNode.h"
+#include "Nodes/CC3StaticBatchNode.h"
 #include "Nodes/CC3BitmapLabelNode.h"
 #include "Nodes/CC3NodeVisitor.h"
 #include "Nodes/CC3NodeDrawingVisitor.h"
@@ -98,12 +106,16 @@
 #include "Meshes/CC3VertexIndices.h"
 
 #include "Meshes/CC3Mesh.h"
+#include "Meshes/CC3MeshFaceHierarchy.h"
+#include "Meshes/CC3MeshOptimizer.h"
+#include "Meshes/CC3MeshSimplifier.h"
 #include "Meshes/CC3SoftBodyNode.h"
 #include "Meshes/CC3Bone.h"
 #include "Meshes/CC3SkinMeshNode.h"
 #include "Meshes/CC3DeformedFaceArray.h"
 #include "Meshes/CC3SkinSection.h"
 #include "Meshes/CC3SkinnedBone.h"
+#include "Meshes/CC3SoftwareSkinner.h"
 
 /// Animation
 #include "Animations/CC3Actions.h"
@@ -112,14 +124,19 @@
 #include "Animations/CC3NodeAnimation.h"
 #include "Animations/CC3ArrayNodeAnimation.h"
 #include "Animations/CC3FrozenNodeAnimation.h"
+#include "Animations/CC3CompressedNodeAnimation.h"
+#include "Animations/CC3PoseEngine.h"
+#include "Animations/CC3AnimationUpdatePolicy.h"
 #include "Animations/CC3NodeAnimationSegment.h"
 #include "Animations/CC3ActionManager.h"
 
 /// resources
 #include "Resources/CC3DataStreams.h"
+#include "Resources/CC3MappedFile.h"
 #include "Resources/CC3Resource.h"
 #include "Resources/CC3ResourceNode.h"
 #include "Resources/CC3NodesResource.h"
+#include "Resources/CC3SceneCacheResource.h"
 
 /// shaders
 #include "Shaders/CC3GLSLVariable.h"
@@ -132,6 +149,7 @@
 #include "Materials/CC3Material.h"
 #include "Materials/CC3STBImage.h"
 #include "Materials/CC3Texture.h"
+#include "Materials/CC3TextureLoader.h"
 #include "Materials/CC3TextureUnit.h"
 
 /// cc3PVR
@@ -176,6 +194,7 @@
 #include "Particles/CC3MeshParticle.h"
 #include "Particles/CC3PointParticle.h"
 #include "Particles/CC3ParticleNavigator.h"
+#include "Particles/CC3ParticleStore.h"
 #include "Particles/CC3ParticleEmitter.h"
 #include "Particles/CC3CVAParticleEmitter.h"
 #include "Particles/CC3MeshParticleEmitter.h"
@@ -186,14 +205,18 @@
 #include "cc3Extras/CC3PointParticleSamples.h"
 #include "cc3Extras/CC3MeshParticleSamples.h"
 #include "cc3Extras/CC3ModelSampleFactory.h"
+#include "cc3Extras/CC3PerformanceBenchmarks.h"
 
 /// scenes
 #include "Scenes/CC3Layer.h"
 #include "Scenes/CC3NodeSequencer.h"
+#include "Scenes/CC3DrawCommandQueue.h"
 #include "Scenes/CC3RenderSurfaces.h"
 #include "Scenes/CC3Scene.h"
 
 /// shadows
+#include "Shadows/CC3ShadowSilhouetteExtractor.h"
 #include "Shadows/CC3ShadowVolumes.h"
+#include "Shadows/CC3ShadowMaps.h"
 
 #endif